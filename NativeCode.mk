@@ -69,17 +69,60 @@ core_static_libraries := $(LOCAL_STATIC_LIBRARIES)
 core_cflags := -Wall -Wextra -Werror
 core_cppflags += -std=gnu++11
 
+# Build with LIBCORE_NATIVE_COUNTERS=true to count calls to, bytes moved by, and time spent in
+# every native registered with NATIVE_METHOD; see luni/src/main/native/NativeCounters.h and
+# libcore.io.NativeCounters. This only applies to libjavacore, not the test library.
+core_counters_cppflags :=
+ifeq ($(LIBCORE_NATIVE_COUNTERS),true)
+    core_counters_cppflags := -DLIBCORE_NATIVE_COUNTERS \
+        -include $(core_local_path)/luni/src/main/native/NativeCounters.h
+endif
+
+# Build with LIBCORE_LAZY_REGISTRATION=true to register the ICU-backed natives, and map ICU's
+# data file, when each of their classes is first initialized rather than when libjavacore is
+# loaded; see luni/src/main/native/Register.cpp and libcore.util.NativeRegistration.
+core_registration_cppflags :=
+ifeq ($(LIBCORE_LAZY_REGISTRATION),true)
+    core_registration_cppflags := -DLIBCORE_LAZY_REGISTRATION
+endif
+
 core_test_files := \
   luni/src/test/native/dalvik_system_JniTest.cpp \
+  luni/src/test/native/libcore_util_ScratchArenaTest.cpp \
   luni/src/test/native/test_openssl_engine.cpp \
 
+# Native microbenchmarks for libjavacore's kernels, which print their results as JSON. Benchmarks
+# of static kernels include the .cpp file that defines them, so those files aren't listed here.
+core_benchmark_files := \
+  luni/src/benchmark/native/Base64Benchmark.cpp \
+  luni/src/benchmark/native/BigIntBenchmark.cpp \
+  luni/src/benchmark/native/CanonicalizePathBenchmark.cpp \
+  luni/src/benchmark/native/CharsetBenchmark.cpp \
+  luni/src/benchmark/native/ChecksumBenchmark.cpp \
+  luni/src/benchmark/native/ExpatParserBenchmark.cpp \
+  luni/src/benchmark/native/JSONTokenerBenchmark.cpp \
+  luni/src/benchmark/native/Lz4Benchmark.cpp \
+  luni/src/benchmark/native/MemoryBenchmark.cpp \
+  luni/src/benchmark/native/NativeBenchmark.cpp \
+  luni/src/benchmark/native/RealToStringBenchmark.cpp \
+  luni/src/benchmark/native/StringToRealBenchmark.cpp \
+  luni/src/main/native/Base64Utilities.cpp \
+  luni/src/main/native/CharsetUtilities.cpp \
+  luni/src/main/native/JniException.cpp \
+  luni/src/main/native/Lz4Frame.cpp \
+  luni/src/main/native/PowersOfFive.cpp \
+  luni/src/main/native/ZipChecksums.cpp \
+  luni/src/main/native/canonicalize_path.cpp \
+  luni/src/main/native/cbigint.cpp \
+  luni/src/main/native/readlink.cpp \
+
 #
 # Build for the target (device).
 #
 
 include $(CLEAR_VARS)
 LOCAL_CFLAGS += $(core_cflags)
-LOCAL_CPPFLAGS += $(core_cppflags)
+LOCAL_CPPFLAGS += $(core_cppflags) $(core_counters_cppflags) $(core_registration_cppflags)
 LOCAL_SRC_FILES += $(core_src_files)
 LOCAL_C_INCLUDES += $(core_c_includes)
 LOCAL_SHARED_LIBRARIES += $(core_shared_libraries) libcrypto libdl libexpat libicuuc libicui18n libnativehelper libz libutils
@@ -98,7 +141,7 @@ LOCAL_CFLAGS += $(core_cflags)
 LOCAL_CPPFLAGS += $(core_cppflags)
 LOCAL_SRC_FILES += $(core_test_files)
 LOCAL_C_INCLUDES += libcore/include external/openssl/include
-LOCAL_SHARED_LIBRARIES += libcrypto
+LOCAL_SHARED_LIBRARIES += libcrypto libnativehelper
 LOCAL_MODULE_TAGS := optional
 LOCAL_MODULE := libjavacoretests
 LOCAL_ADDITIONAL_DEPENDENCIES := $(LOCAL_PATH)/NativeCode.mk
@@ -117,7 +160,7 @@ LOCAL_CLANG := true
 LOCAL_SRC_FILES += $(core_src_files)
 LOCAL_CFLAGS += $(core_cflags)
 LOCAL_C_INCLUDES += $(core_c_includes)
-LOCAL_CPPFLAGS += $(core_cppflags)
+LOCAL_CPPFLAGS += $(core_cppflags) $(core_counters_cppflags) $(core_registration_cppflags)
 LOCAL_LDLIBS += -ldl -lpthread
 ifeq ($(HOST_OS),linux)
 LOCAL_LDLIBS += -lrt
@@ -141,6 +184,25 @@ ifeq ($(LIBCORE_SKIP_TESTS),)
     LOCAL_MODULE_TAGS := optional
     LOCAL_MODULE := libjavacoretests
     LOCAL_ADDITIONAL_DEPENDENCIES := $(LOCAL_PATH)/NativeCode.mk
-    LOCAL_SHARED_LIBRARIES := libcrypto-host
+    LOCAL_SHARED_LIBRARIES := libcrypto-host libnativehelper
     include $(BUILD_HOST_SHARED_LIBRARY)
 endif # LIBCORE_SKIP_TESTS
+
+ifeq ($(LIBCORE_SKIP_TESTS),)
+    include $(CLEAR_VARS)
+    LOCAL_CLANG := true
+    LOCAL_SRC_FILES += $(core_benchmark_files)
+    LOCAL_CFLAGS += $(core_cflags)
+    LOCAL_C_INCLUDES += $(core_c_includes) libcore/luni/src/main/native
+    LOCAL_CPPFLAGS += $(core_cppflags)
+    LOCAL_LDLIBS += -ldl -lpthread
+    ifeq ($(HOST_OS),linux)
+    LOCAL_LDLIBS += -lrt
+    endif
+    LOCAL_MODULE_TAGS := optional
+    LOCAL_MODULE := libjavacore-benchmarks
+    LOCAL_ADDITIONAL_DEPENDENCIES := $(LOCAL_PATH)/NativeCode.mk
+    LOCAL_SHARED_LIBRARIES += $(core_shared_libraries) libexpat-host libicuuc-host libz-host
+    LOCAL_STATIC_LIBRARIES += $(core_static_libraries) libutils
+    include $(BUILD_HOST_EXECUTABLE)
+endif # LIBCORE_SKIP_TESTS
@@ -20,7 +20,9 @@ import com.google.caliper.Param;
 import com.google.caliper.Runner;
 import com.google.caliper.SimpleBenchmark;
 
+import java.nio.ByteBuffer;
 import java.util.Arrays;
+import libcore.io.Memory;
 
 public class ArrayCopyBenchmark extends SimpleBenchmark {
     public void timeManualArrayCopy(int reps) {
@@ -54,4 +56,37 @@ public class ArrayCopyBenchmark extends SimpleBenchmark {
             char[] dst = Arrays.copyOfRange(src, 0, 8192);
         }
     }
+
+    // One copy per tier of Memory.memmove: inline, memmove, non-temporal, and parallel.
+
+    public void time_directByteBuffer_16(int reps) {
+        copyDirect(reps, 16);
+    }
+
+    public void time_directByteBuffer_64K(int reps) {
+        copyDirect(reps, 64 * 1024);
+    }
+
+    public void time_directByteBuffer_64M(int reps) {
+        copyDirect(reps, 64 * 1024 * 1024);
+    }
+
+    public void time_directByteBuffer_64M_parallel(int reps) {
+        Memory.setMaxCopyThreads(Runtime.getRuntime().availableProcessors());
+        try {
+            copyDirect(reps, 64 * 1024 * 1024);
+        } finally {
+            Memory.setMaxCopyThreads(1);
+        }
+    }
+
+    private static void copyDirect(int reps, int byteCount) {
+        ByteBuffer src = ByteBuffer.allocateDirect(byteCount);
+        ByteBuffer dst = ByteBuffer.allocateDirect(byteCount);
+        for (int rep = 0; rep < reps; ++rep) {
+            src.clear();
+            dst.clear();
+            dst.put(src);
+        }
+    }
 }
@@ -18,6 +18,7 @@ package benchmarks;
 
 import com.google.caliper.Param;
 import com.google.caliper.SimpleBenchmark;
+import java.nio.ByteBuffer;
 
 public class SystemArrayCopyBenchmark extends SimpleBenchmark {
   @Param({"2", "4", "8", "16", "32", "64", "128", "256", "512", "1024",
@@ -97,4 +98,28 @@ public class SystemArrayCopyBenchmark extends SimpleBenchmark {
       System.arraycopy(src, 0, dst, 0, len);
     }
   }
+
+  // ByteBuffer.put(ByteBuffer) goes through Memory.memmove, whose small copies are done inline.
+
+  public void timeDirectByteBufferCopy(int reps) {
+    final int len = arrayLength;
+    ByteBuffer src = ByteBuffer.allocateDirect(len);
+    ByteBuffer dst = ByteBuffer.allocateDirect(len);
+    for (int rep = 0; rep < reps; ++rep) {
+      src.clear();
+      dst.clear();
+      dst.put(src);
+    }
+  }
+
+  public void timeHeapToDirectByteBufferCopy(int reps) {
+    final int len = arrayLength;
+    ByteBuffer src = ByteBuffer.allocate(len);
+    ByteBuffer dst = ByteBuffer.allocateDirect(len);
+    for (int rep = 0; rep < reps; ++rep) {
+      src.clear();
+      dst.clear();
+      dst.put(src);
+    }
+  }
 }
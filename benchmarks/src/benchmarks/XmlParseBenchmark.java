@@ -33,7 +33,9 @@ import javax.xml.parsers.SAXParserFactory;
 import org.w3c.dom.Document;
 import org.w3c.dom.Node;
 import org.xml.sax.Attributes;
+import org.xml.sax.InputSource;
 import org.xml.sax.SAXException;
+import org.xml.sax.XMLReader;
 import org.xml.sax.helpers.DefaultHandler;
 import org.xmlpull.v1.XmlPullParser;
 
@@ -52,6 +54,7 @@ public class XmlParseBenchmark extends SimpleBenchmark {
     private DocumentBuilder documentBuilder;
     private Constructor<? extends XmlPullParser> kxmlConstructor;
     private Constructor<? extends XmlPullParser> expatConstructor;
+    private Constructor<? extends XMLReader> expatReaderConstructor;
 
     @SuppressWarnings("unchecked")
     @Override protected void setUp() throws Exception {
@@ -68,6 +71,8 @@ public class XmlParseBenchmark extends SimpleBenchmark {
         kxmlConstructor = (Constructor) Class.forName("org.kxml2.io.KXmlParser").getConstructor();
         expatConstructor = (Constructor) Class.forName("org.apache.harmony.xml.ExpatPullParser")
                 .getConstructor();
+        expatReaderConstructor = (Constructor) Class.forName("org.apache.harmony.xml.ExpatReader")
+                .getConstructor();
     }
 
     private byte[] getXmlBytes() throws IOException {
@@ -93,6 +98,28 @@ public class XmlParseBenchmark extends SimpleBenchmark {
         return elementCount;
     }
 
+    public int timeExpatReader(int reps) throws Exception {
+        return testExpatReader(false, reps);
+    }
+
+    public int timeExpatReaderBatched(int reps) throws Exception {
+        return testExpatReader(true, reps);
+    }
+
+    private int testExpatReader(boolean batched, int reps) throws Exception {
+        int elementCount = 0;
+        for (int i = 0; i < reps; i++) {
+            inputStream.reset();
+            XMLReader reader = expatReaderConstructor.newInstance();
+            reader.setFeature("http://android.com/sax/features/batched-events", batched);
+            ElementCounterSaxHandler elementCounterSaxHandler = new ElementCounterSaxHandler();
+            reader.setContentHandler(elementCounterSaxHandler);
+            reader.parse(new InputSource(inputStream));
+            elementCount += elementCounterSaxHandler.elementCount;
+        }
+        return elementCount;
+    }
+
     private static class ElementCounterSaxHandler extends DefaultHandler {
         int elementCount = 0;
         @Override public void startElement(String uri, String localName,
@@ -0,0 +1,94 @@
+/*
+ * Copyright (C) 2014 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+package benchmarks.regression;
+
+import com.google.caliper.Param;
+import com.google.caliper.SimpleBenchmark;
+import java.nio.ByteBuffer;
+import java.nio.charset.StandardCharsets;
+import java.util.Random;
+import libcore.io.Base64;
+
+public class Base64Benchmark extends SimpleBenchmark {
+    @Param({ "3", "48", "768", "12288", "196608" })
+    private int length;
+
+    private byte[] data;
+    private byte[] encoded;
+    private byte[] wrapped;
+    private ByteBuffer directData;
+    private ByteBuffer directEncoded;
+    private ByteBuffer directOut;
+
+    @Override protected void setUp() throws Exception {
+        data = new byte[length];
+        new Random(0).nextBytes(data);
+        encoded = Base64.encode(data).getBytes(StandardCharsets.US_ASCII);
+        // MIME-style, with a CRLF after every 76 chars.
+        StringBuilder sb = new StringBuilder();
+        String s = new String(encoded, StandardCharsets.US_ASCII);
+        for (int i = 0; i < s.length(); i += 76) {
+            sb.append(s, i, Math.min(i + 76, s.length())).append("\r\n");
+        }
+        wrapped = sb.toString().getBytes(StandardCharsets.US_ASCII);
+        directData = ByteBuffer.allocateDirect(data.length);
+        directData.put(data).flip();
+        directEncoded = ByteBuffer.allocateDirect(encoded.length);
+        directEncoded.put(encoded).flip();
+        directOut = ByteBuffer.allocateDirect(encoded.length);
+    }
+
+    public void time_encode(int reps) {
+        for (int i = 0; i < reps; ++i) {
+            Base64.encode(data);
+        }
+    }
+
+    public void time_decode(int reps) {
+        for (int i = 0; i < reps; ++i) {
+            Base64.decode(encoded);
+        }
+    }
+
+    public void time_decodeStrict(int reps) {
+        for (int i = 0; i < reps; ++i) {
+            Base64.decodeStrict(encoded, 0, encoded.length);
+        }
+    }
+
+    public void time_decodeWrapped(int reps) {
+        for (int i = 0; i < reps; ++i) {
+            Base64.decode(wrapped);
+        }
+    }
+
+    public void time_encodeDirect(int reps) {
+        for (int i = 0; i < reps; ++i) {
+            directData.rewind();
+            directOut.clear();
+            Base64.encode(directData, directOut);
+        }
+    }
+
+    public void time_decodeDirect(int reps) {
+        for (int i = 0; i < reps; ++i) {
+            directEncoded.rewind();
+            directOut.clear();
+            Base64.decode(directEncoded, directOut, true);
+        }
+    }
+}
@@ -48,4 +48,42 @@ public class BigIntegerBenchmark extends SimpleBenchmark {
             x.multiply(y);
         }
     }
+
+    // Values from valueOf have only a Java representation, so arithmetic on
+    // them takes the fast path. Values parsed from strings start life as
+    // BIGNUMs, so the same arithmetic on them goes through OpenSSL.
+
+    private static final long LEDGER_VALUE = 123456789012345L;
+
+    public void timeSmallAddition(int reps) throws Exception {
+        BigInteger x = BigInteger.valueOf(LEDGER_VALUE);
+        BigInteger y = BigInteger.valueOf(-987654321L);
+        for (int i = 0; i < reps; ++i) {
+            x.add(y);
+        }
+    }
+
+    public void timeSmallAdditionNative(int reps) throws Exception {
+        BigInteger x = new BigInteger(Long.toString(LEDGER_VALUE));
+        BigInteger y = new BigInteger("-987654321");
+        for (int i = 0; i < reps; ++i) {
+            x.add(y);
+        }
+    }
+
+    public void timeSmallMultiplication(int reps) throws Exception {
+        BigInteger x = BigInteger.valueOf(LEDGER_VALUE);
+        BigInteger y = BigInteger.valueOf(Long.MAX_VALUE);
+        for (int i = 0; i < reps; ++i) {
+            x.multiply(y);
+        }
+    }
+
+    public void timeSmallMultiplicationNative(int reps) throws Exception {
+        BigInteger x = new BigInteger(Long.toString(LEDGER_VALUE));
+        BigInteger y = new BigInteger(Long.toString(Long.MAX_VALUE));
+        for (int i = 0; i < reps; ++i) {
+            x.multiply(y);
+        }
+    }
 }
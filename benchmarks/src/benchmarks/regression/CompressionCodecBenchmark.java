@@ -0,0 +1,132 @@
+/*
+ * Copyright (C) 2014 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+package benchmarks.regression;
+package benchmarks.regression;
+
+import com.google.caliper.Param;
+import com.google.caliper.SimpleBenchmark;
+import java.nio.ByteBuffer;
+import java.util.Random;
+import java.util.zip.Deflater;
+import java.util.zip.Inflater;
+import java.util.zip.Lz4Compressor;
+import java.util.zip.Lz4Decompressor;
+
+/**
+ * Compares LZ4 frames with deflate at BEST_SPEED on the kind of small-to-medium payload an RPC
+ * or cache entry carries, with one long-lived codec per direction as a server would keep them.
+ */
+public class CompressionCodecBenchmark extends SimpleBenchmark {
+    @Param({ "1024", "16384", "262144" })
+    private int length;
+
+    private byte[] data;
+    private byte[] out;
+    private byte[] lz4Compressed;
+    private byte[] deflated;
+    private ByteBuffer directData;
+    private ByteBuffer directOut;
+
+    private final Lz4Compressor lz4Compressor = new Lz4Compressor();
+    private final Lz4Decompressor lz4Decompressor = new Lz4Decompressor();
+    private final Deflater deflater = new Deflater(Deflater.BEST_SPEED);
+    private final Inflater inflater = new Inflater();
+
+    @Override protected void setUp() throws Exception {
+        // JSON-ish records: repetitive keys with varying values.
+        String[] words = { "{\"id\": ", "\"name\": \"", "\", \"tags\": [", "\"cache\", ",
+                "\"rpc\"], ", "\"score\": ", "}, ", "\"user-", "\"region\": \"eu\", " };
+        Random random = new Random(0);
+        StringBuilder sb = new StringBuilder();
+        while (sb.length() < length) {
+            sb.append(words[random.nextInt(words.length)]).append(random.nextInt(100000));
+        }
+        data = sb.substring(0, length).getBytes("UTF-8");
+        out = new byte[length * 2 + 64];
+        lz4Compressed = copyOf(out, lz4Compress());
+        deflated = copyOf(out, deflate());
+        directData = ByteBuffer.allocateDirect(length);
+        directData.put(data).flip();
+        directOut = ByteBuffer.allocateDirect(out.length);
+    }
+
+    @Override protected void tearDown() throws Exception {
+        lz4Compressor.end();
+        lz4Decompressor.end();
+        deflater.end();
+        inflater.end();
+    }
+
+    private static byte[] copyOf(byte[] bytes, int length) {
+        byte[] result = new byte[length];
+        System.arraycopy(bytes, 0, result, 0, length);
+        return result;
+    }
+
+    private int lz4Compress() {
+        lz4Compressor.reset();
+        lz4Compressor.setInput(data);
+        lz4Compressor.finish();
+        return lz4Compressor.compress(out);
+    }
+
+    private int deflate() {
+        deflater.reset();
+        deflater.setInput(data);
+        deflater.finish();
+        return deflater.deflate(out);
+    }
+
+    public void time_lz4Compress(int reps) {
+        for (int i = 0; i < reps; ++i) {
+            lz4Compress();
+        }
+    }
+
+    public void time_lz4CompressDirect(int reps) {
+        for (int i = 0; i < reps; ++i) {
+            directData.rewind();
+            directOut.clear();
+            lz4Compressor.reset();
+            lz4Compressor.setInput(directData);
+            lz4Compressor.finish();
+            lz4Compressor.compress(directOut);
+        }
+    }
+
+    public void time_lz4Decompress(int reps) throws Exception {
+        for (int i = 0; i < reps; ++i) {
+            lz4Decompressor.reset();
+            lz4Decompressor.setInput(lz4Compressed);
+            lz4Decompressor.decompress(out);
+        }
+    }
+
+    public void time_deflate(int reps) {
+        for (int i = 0; i < reps; ++i) {
+            deflate();
+        }
+    }
+
+    public void time_inflate(int reps) throws Exception {
+        for (int i = 0; i < reps; ++i) {
+            inflater.reset();
+            inflater.setInput(deflated);
+            inflater.inflate(out);
+        }
+    }
+}
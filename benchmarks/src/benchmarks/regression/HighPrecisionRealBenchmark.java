@@ -0,0 +1,67 @@
+/*
+ * Copyright (C) 2014 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+package benchmarks.regression;
+
+import com.google.caliper.Param;
+import com.google.caliper.SimpleBenchmark;
+
+/**
+ * Conversions that miss the fast paths and fall back to the high-precision arithmetic in
+ * cbigint: long significands, halfway cases, and extreme exponents.
+ */
+public class HighPrecisionRealBenchmark extends SimpleBenchmark {
+    @Param({
+        // Neighbours that the old combined M+/M- digit generator got wrong.
+        "1.234123412431233E107",
+        "1.2341234124312331E107",
+        "1.2341234124312332E107",
+        // Exactly halfway between two doubles, and just above it in the 20th digit.
+        "9007199254740993",
+        "9007199254740993.0000000001",
+        // Halfway between Double.MIN_VALUE and zero, and the largest subnormal.
+        "2.4703282292062328E-324",
+        "2.2250738585072011E-308",
+        // Just below the overflow threshold.
+        "1.7976931348623158E308",
+        // Many more digits than a double can hold.
+        "3.14159265358979323846264338327950288419716939937510582097494459230781640628620899",
+    }) String string;
+
+    private double value;
+
+    @Override protected void setUp() throws Exception {
+        value = Double.parseDouble(string);
+    }
+
+    public void timeDouble_parseDouble(int reps) {
+        for (int rep = 0; rep < reps; ++rep) {
+            Double.parseDouble(string);
+        }
+    }
+
+    public void timeFloat_parseFloat(int reps) {
+        for (int rep = 0; rep < reps; ++rep) {
+            Float.parseFloat(string);
+        }
+    }
+
+    public void timeDouble_toString(int reps) {
+        for (int rep = 0; rep < reps; ++rep) {
+            Double.toString(value);
+        }
+    }
+}
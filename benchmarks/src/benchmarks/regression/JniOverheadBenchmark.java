@@ -0,0 +1,264 @@
+/*
+ * Copyright (C) 2014 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+package benchmarks.regression;
+
+import com.google.caliper.Param;
+import com.google.caliper.SimpleBenchmark;
+import java.io.FileInputStream;
+import java.io.IOException;
+import java.lang.reflect.Method;
+import java.nio.charset.StandardCharsets;
+import java.util.ArrayList;
+import java.util.Arrays;
+import java.util.Collections;
+import java.util.Comparator;
+import java.util.HashMap;
+import java.util.List;
+import java.util.Locale;
+import java.util.Map;
+import libcore.io.Streams;
+import org.apache.harmony.dalvik.NativeTestTarget;
+import org.json.JSONArray;
+import org.json.JSONObject;
+
+/**
+ * Measures the per-call cost of the JNI patterns the libcore natives use to
+ * reach arrays, strings and objects. The patterns whose cost doesn't depend
+ * on the size of their argument (NewObject and exception throwing) are in
+ * {@link NativeMethodBenchmark}.
+ *
+ * <p>Besides running under Caliper, {@link #main} runs the cases of both
+ * classes and prints their timings as JSON in the same shape as the native
+ * benchmarks' output. Given a baseline produced by an earlier run, it reports
+ * each case that has become slower than the tolerance allows and exits with
+ * status 1, so a JNI regression can be caught before it ships.
+ */
+public class JniOverheadBenchmark extends SimpleBenchmark {
+    private static final String[] SIZES = { "0", "16", "256", "4096", "65536" };
+    private static final long MAX_REPS = 1000000000L;
+
+    @Param({ "0", "16", "256", "4096", "65536" })
+    private int size;
+
+    private byte[] bytes;
+    private int[] ints;
+    private String string;
+    private Object[] objects;
+
+    @Override protected void setUp() throws Exception {
+        bytes = new byte[size];
+        ints = new int[size];
+        char[] chars = new char[size];
+        Arrays.fill(chars, 'a');
+        string = new String(chars);
+        objects = new Object[size];
+        Arrays.fill(objects, string);
+    }
+
+    public void time_pinByteArrayRO(int reps) {
+        for (int i = 0; i < reps; ++i) {
+            NativeTestTarget.pinByteArrayRO(bytes);
+        }
+    }
+
+    public void time_pinByteArrayRW(int reps) {
+        for (int i = 0; i < reps; ++i) {
+            NativeTestTarget.pinByteArrayRW(bytes);
+        }
+    }
+
+    public void time_pinByteArrayCritical(int reps) {
+        for (int i = 0; i < reps; ++i) {
+            NativeTestTarget.pinByteArrayCritical(bytes);
+        }
+    }
+
+    public void time_pinIntArrayRO(int reps) {
+        for (int i = 0; i < reps; ++i) {
+            NativeTestTarget.pinIntArrayRO(ints);
+        }
+    }
+
+    public void time_copyByteArrayRegion(int reps) {
+        for (int i = 0; i < reps; ++i) {
+            NativeTestTarget.copyByteArrayRegion(bytes);
+        }
+    }
+
+    public void time_getStringChars(int reps) {
+        for (int i = 0; i < reps; ++i) {
+            NativeTestTarget.getStringChars(string);
+        }
+    }
+
+    public void time_getStringUtfChars(int reps) {
+        for (int i = 0; i < reps; ++i) {
+            NativeTestTarget.getStringUtfChars(string);
+        }
+    }
+
+    public void time_copyStringRegion(int reps) {
+        for (int i = 0; i < reps; ++i) {
+            NativeTestTarget.copyStringRegion(string);
+        }
+    }
+
+    public void time_localRefFrame(int reps) {
+        for (int i = 0; i < reps; ++i) {
+            NativeTestTarget.localRefFrame(objects);
+        }
+    }
+
+    public void time_scopedLocalRefs(int reps) {
+        for (int i = 0; i < reps; ++i) {
+            NativeTestTarget.scopedLocalRefs(objects);
+        }
+    }
+
+    /**
+     * Usage: {@code JniOverheadBenchmark [--min-time-ms=N] [--baseline=FILE]
+     * [--tolerance=PERCENT]}. The tolerance defaults to 20%.
+     */
+    public static void main(String[] args) throws Exception {
+        long minTimeNs = 500 * 1000000L;
+        String baselineFile = null;
+        double tolerance = 0.20;
+        for (String arg : args) {
+            if (arg.startsWith("--min-time-ms=")) {
+                minTimeNs = Long.parseLong(arg.substring("--min-time-ms=".length())) * 1000000L;
+            } else if (arg.startsWith("--baseline=")) {
+                baselineFile = arg.substring("--baseline=".length());
+            } else if (arg.startsWith("--tolerance=")) {
+                tolerance = Double.parseDouble(arg.substring("--tolerance=".length())) / 100;
+            } else {
+                System.err.println("usage: JniOverheadBenchmark [--min-time-ms=N]"
+                        + " [--baseline=FILE] [--tolerance=PERCENT]");
+                System.exit(2);
+            }
+        }
+
+        Map<String, Double> results = new HashMap<String, Double>();
+        List<String> names = new ArrayList<String>();
+        StringBuilder json = new StringBuilder("{\n  \"benchmarks\": [");
+        NativeMethodBenchmark fixed = new NativeMethodBenchmark();
+        for (Method method : timeMethods(NativeMethodBenchmark.class)) {
+            String name = "NativeMethodBenchmark." + caseName(method);
+            report(json, names, results, name, run(fixed, method, minTimeNs));
+        }
+        for (String size : SIZES) {
+            JniOverheadBenchmark sized = new JniOverheadBenchmark();
+            sized.size = Integer.parseInt(size);
+            sized.setUp();
+            for (Method method : timeMethods(JniOverheadBenchmark.class)) {
+                String name = "JniOverheadBenchmark." + caseName(method) + "/size=" + size;
+                report(json, names, results, name, run(sized, method, minTimeNs));
+            }
+        }
+        json.append("\n  ]\n}");
+        System.out.println(json);
+
+        if (baselineFile != null && !compare(baselineFile, names, results, tolerance)) {
+            System.exit(1);
+        }
+    }
+
+    private static List<Method> timeMethods(Class<?> c) {
+        List<Method> result = new ArrayList<Method>();
+        for (Method method : c.getMethods()) {
+            if (method.getName().startsWith("time_")) {
+                result.add(method);
+            }
+        }
+        Collections.sort(result, new Comparator<Method>() {
+            @Override public int compare(Method lhs, Method rhs) {
+                return lhs.getName().compareTo(rhs.getName());
+            }
+        });
+        return result;
+    }
+
+    /** Returns the method name without Caliper's "time_" prefix. */
+    private static String caseName(Method method) {
+        return method.getName().substring("time_".length());
+    }
+
+    /**
+     * Runs {@code method} with more and more reps until a run takes at least
+     * {@code minTimeNs}, and returns {reps, elapsed nanoseconds} for that run.
+     */
+    private static long[] run(Object benchmark, Method method, long minTimeNs) throws Exception {
+        long reps = 1;
+        while (true) {
+            long start = System.nanoTime();
+            method.invoke(benchmark, (int) reps);
+            long elapsedNs = System.nanoTime() - start;
+            if (elapsedNs >= minTimeNs || reps >= MAX_REPS) {
+                return new long[] { reps, elapsedNs };
+            }
+            // Aim 20% past the target, growing by at least 2x and at most 100x per attempt.
+            double scale = (elapsedNs == 0) ? 100.0 : 1.2 * minTimeNs / elapsedNs;
+            scale = Math.max(2.0, Math.min(100.0, scale));
+            reps = Math.min(MAX_REPS, (long) (reps * scale));
+        }
+    }
+
+    private static void report(StringBuilder json, List<String> names, Map<String, Double> results,
+            String name, long[] repsAndElapsedNs) {
+        double nsPerCall = (double) repsAndElapsedNs[1] / repsAndElapsedNs[0];
+        json.append(names.isEmpty() ? "" : ",");
+        // Always use '.' as the decimal separator, so the output is valid JSON in every locale.
+        json.append(String.format(Locale.US,
+                "\n    {\"name\": \"%s\", \"iterations\": %d, \"ns_per_iteration\": %.3f}",
+                name, repsAndElapsedNs[0], nsPerCall));
+        names.add(name);
+        results.put(name, nsPerCall);
+    }
+
+    /**
+     * Reports each case that is more than {@code tolerance} slower than in
+     * {@code baselineFile}. Returns true if there were none.
+     */
+    private static boolean compare(String baselineFile, List<String> names,
+            Map<String, Double> results, double tolerance) throws Exception {
+        Map<String, Double> baseline = new HashMap<String, Double>();
+        JSONArray benchmarks = new JSONObject(readFile(baselineFile)).getJSONArray("benchmarks");
+        for (int i = 0; i < benchmarks.length(); ++i) {
+            JSONObject benchmark = benchmarks.getJSONObject(i);
+            baseline.put(benchmark.getString("name"), benchmark.getDouble("ns_per_iteration"));
+        }
+
+        boolean passed = true;
+        for (String name : names) {
+            Double expected = baseline.get(name);
+            if (expected == null) {
+                System.err.println("no baseline for " + name);
+                continue;
+            }
+            double actual = results.get(name);
+            if (actual > expected * (1 + tolerance)) {
+                System.err.println(String.format("REGRESSION %s: %.3f ns, baseline %.3f ns (+%.1f%%)",
+                        name, actual, expected, (actual / expected - 1) * 100));
+                passed = false;
+            }
+        }
+        return passed;
+    }
+
+    private static String readFile(String path) throws IOException {
+        return new String(Streams.readFully(new FileInputStream(path)), StandardCharsets.UTF_8);
+    }
+}
@@ -76,4 +76,28 @@ public class NativeMethodBenchmark extends SimpleBenchmark {
         }
     }
 
+    public void time_newResultObject(int reps) throws Exception {
+        for (int i = 0; i < reps; ++i) {
+            NativeTestTarget.newResultObject(i, i);
+        }
+    }
+
+    public void time_throwException(int reps) throws Exception {
+        for (int i = 0; i < reps; ++i) {
+            try {
+                NativeTestTarget.throwException();
+            } catch (IllegalStateException expected) {
+            }
+        }
+    }
+
+    public void time_throwExceptionFmt(int reps) throws Exception {
+        for (int i = 0; i < reps; ++i) {
+            try {
+                NativeTestTarget.throwExceptionFmt(i);
+            } catch (IllegalStateException expected) {
+            }
+        }
+    }
+
 }
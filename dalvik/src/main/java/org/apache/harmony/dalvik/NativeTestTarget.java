@@ -59,4 +59,65 @@ public final class NativeTestTarget {
      * This is used to benchmark dalvik's inline natives.
      */
     public static native void emptyInternalStaticMethod();
+
+    /**
+     * The small object returned by {@link #newResultObject}, standing in for the
+     * result structs (such as {@code StructStat}) that natives construct.
+     */
+    public static final class Result {
+        public final long a;
+        public final int b;
+
+        public Result(long a, int b) {
+            this.a = a;
+            this.b = b;
+        }
+    }
+
+    /*
+     * The methods below each exercise one JNI pattern used by the libcore
+     * natives, so that the per-call cost of the pattern itself can be
+     * measured. Those that take an array or string return its first element
+     * (or 0 if it is empty), and those that take an Object[] return the
+     * number of non-null elements.
+     */
+
+    /** Pins {@code array} with ScopedByteArrayRO. */
+    public static native int pinByteArrayRO(byte[] array);
+
+    /** Pins {@code array} with ScopedByteArrayRW, incrementing its first element. */
+    public static native void pinByteArrayRW(byte[] array);
+
+    /** Pins {@code array} with GetPrimitiveArrayCritical. */
+    public static native int pinByteArrayCritical(byte[] array);
+
+    /** Pins {@code array} with ScopedIntArrayRO. */
+    public static native int pinIntArrayRO(int[] array);
+
+    /** Copies {@code array} to a native buffer with GetByteArrayRegion. */
+    public static native int copyByteArrayRegion(byte[] array);
+
+    /** Accesses {@code string} with ScopedStringChars. */
+    public static native int getStringChars(String string);
+
+    /** Accesses {@code string} with ScopedUtfChars. */
+    public static native int getStringUtfChars(String string);
+
+    /** Copies {@code string} to a native buffer with GetStringRegion. */
+    public static native int copyStringRegion(String string);
+
+    /** Reads every element of {@code array}, each within its own PushLocalFrame/PopLocalFrame. */
+    public static native int localRefFrame(Object[] array);
+
+    /** Reads every element of {@code array}, deleting each local reference with ScopedLocalRef. */
+    public static native int scopedLocalRefs(Object[] array);
+
+    /** Returns a new {@code Result} constructed with NewObject. */
+    public static native Result newResultObject(long a, int b);
+
+    /** Throws an IllegalStateException with jniThrowException. */
+    public static native void throwException();
+
+    /** Throws an IllegalStateException with jniThrowExceptionFmt, formatting {@code value}. */
+    public static native void throwExceptionFmt(int value);
 }
@@ -18,6 +18,14 @@
 
 #include "JNIHelp.h"
 #include "JniConstants.h"
+#include "ScopedLocalRef.h"
+#include "ScopedPrimitiveArray.h"
+#include "ScopedStringChars.h"
+#include "ScopedUtfChars.h"
+#include "UniquePtr.h"
+
+static jclass gResultClass;
+static jmethodID gResultConstructor;
 
 static void NativeTestTarget_emptyJniMethod0(JNIEnv*, jobject) { }
 static void NativeTestTarget_emptyJniMethod6(JNIEnv*, jclass, int, int, int, int, int, int) { }
@@ -28,7 +36,119 @@ static void NativeTestTarget_emptyJniStaticMethod6L(JNIEnv*, jclass, jobject, ja
 static void NativeTestTarget_emptyJniStaticSynchronizedMethod0(JNIEnv*, jclass) { }
 static void NativeTestTarget_emptyJniSynchronizedMethod0(JNIEnv*, jclass) { }
 
+// The methods below each exercise exactly one of the JNI patterns the libcore natives rely on,
+// doing as little real work as possible so that benchmarks measure the pattern's own cost.
+// Each touches the data it obtained so the access can't be optimized away.
+
+static jint NativeTestTarget_copyByteArrayRegion(JNIEnv* env, jclass, jbyteArray array) {
+    jsize length = env->GetArrayLength(array);
+    UniquePtr<jbyte[]> buffer(new jbyte[length + 1]);
+    buffer[0] = 0;
+    env->GetByteArrayRegion(array, 0, length, buffer.get());
+    return buffer[0];
+}
+
+static jint NativeTestTarget_copyStringRegion(JNIEnv* env, jclass, jstring string) {
+    jsize length = env->GetStringLength(string);
+    UniquePtr<jchar[]> buffer(new jchar[length + 1]);
+    buffer[0] = 0;
+    env->GetStringRegion(string, 0, length, buffer.get());
+    return buffer[0];
+}
+
+static jint NativeTestTarget_getStringChars(JNIEnv* env, jclass, jstring string) {
+    ScopedStringChars chars(env, string);
+    if (chars.get() == NULL || chars.size() == 0) {
+        return 0;
+    }
+    return chars[0];
+}
+
+static jint NativeTestTarget_getStringUtfChars(JNIEnv* env, jclass, jstring string) {
+    ScopedUtfChars utf(env, string);
+    if (utf.c_str() == NULL) {
+        return 0;
+    }
+    return utf[0];
+}
+
+static jint NativeTestTarget_localRefFrame(JNIEnv* env, jclass, jobjectArray array) {
+    jsize length = env->GetArrayLength(array);
+    jint nonNullCount = 0;
+    for (jsize i = 0; i < length; ++i) {
+        if (env->PushLocalFrame(1) != JNI_OK) {
+            return -1;
+        }
+        if (env->GetObjectArrayElement(array, i) != NULL) {
+            ++nonNullCount;
+        }
+        env->PopLocalFrame(NULL);
+    }
+    return nonNullCount;
+}
+
+static jobject NativeTestTarget_newResultObject(JNIEnv* env, jclass, jlong a, jint b) {
+    return env->NewObject(gResultClass, gResultConstructor, a, b);
+}
+
+static jint NativeTestTarget_pinByteArrayCritical(JNIEnv* env, jclass, jbyteArray array) {
+    jsize length = env->GetArrayLength(array);
+    jbyte* bytes = reinterpret_cast<jbyte*>(env->GetPrimitiveArrayCritical(array, NULL));
+    if (bytes == NULL) {
+        return 0;
+    }
+    jint result = (length > 0) ? bytes[0] : 0;
+    env->ReleasePrimitiveArrayCritical(array, bytes, JNI_ABORT);
+    return result;
+}
+
+static jint NativeTestTarget_pinByteArrayRO(JNIEnv* env, jclass, jbyteArray array) {
+    ScopedByteArrayRO bytes(env, array);
+    if (bytes.get() == NULL || bytes.size() == 0) {
+        return 0;
+    }
+    return bytes[0];
+}
+
+static void NativeTestTarget_pinByteArrayRW(JNIEnv* env, jclass, jbyteArray array) {
+    ScopedByteArrayRW bytes(env, array);
+    if (bytes.get() == NULL || bytes.size() == 0) {
+        return;
+    }
+    bytes[0] = static_cast<jbyte>(bytes[0] + 1);
+}
+
+static jint NativeTestTarget_pinIntArrayRO(JNIEnv* env, jclass, jintArray array) {
+    ScopedIntArrayRO ints(env, array);
+    if (ints.get() == NULL || ints.size() == 0) {
+        return 0;
+    }
+    return ints[0];
+}
+
+static jint NativeTestTarget_scopedLocalRefs(JNIEnv* env, jclass, jobjectArray array) {
+    jsize length = env->GetArrayLength(array);
+    jint nonNullCount = 0;
+    for (jsize i = 0; i < length; ++i) {
+        ScopedLocalRef<jobject> element(env, env->GetObjectArrayElement(array, i));
+        if (element.get() != NULL) {
+            ++nonNullCount;
+        }
+    }
+    return nonNullCount;
+}
+
+static void NativeTestTarget_throwException(JNIEnv* env, jclass) {
+    jniThrowException(env, "java/lang/IllegalStateException", "NativeTestTarget");
+}
+
+static void NativeTestTarget_throwExceptionFmt(JNIEnv* env, jclass, jint value) {
+    jniThrowExceptionFmt(env, "java/lang/IllegalStateException", "NativeTestTarget %d", value);
+}
+
 static JNINativeMethod gMethods[] = {
+    NATIVE_METHOD(NativeTestTarget, copyByteArrayRegion, "([B)I"),
+    NATIVE_METHOD(NativeTestTarget, copyStringRegion, "(Ljava/lang/String;)I"),
     NATIVE_METHOD(NativeTestTarget, emptyJniMethod0, "()V"),
     NATIVE_METHOD(NativeTestTarget, emptyJniMethod6, "(IIIIII)V"),
     NATIVE_METHOD(NativeTestTarget, emptyJniMethod6L, "(Ljava/lang/String;[Ljava/lang/String;[[ILjava/lang/Object;[Ljava/lang/Object;[[[[Ljava/lang/Object;)V"),
@@ -37,7 +157,22 @@ static JNINativeMethod gMethods[] = {
     NATIVE_METHOD(NativeTestTarget, emptyJniStaticMethod6L, "(Ljava/lang/String;[Ljava/lang/String;[[ILjava/lang/Object;[Ljava/lang/Object;[[[[Ljava/lang/Object;)V"),
     NATIVE_METHOD(NativeTestTarget, emptyJniStaticSynchronizedMethod0, "()V"),
     NATIVE_METHOD(NativeTestTarget, emptyJniSynchronizedMethod0, "()V"),
+    NATIVE_METHOD(NativeTestTarget, getStringChars, "(Ljava/lang/String;)I"),
+    NATIVE_METHOD(NativeTestTarget, getStringUtfChars, "(Ljava/lang/String;)I"),
+    NATIVE_METHOD(NativeTestTarget, localRefFrame, "([Ljava/lang/Object;)I"),
+    NATIVE_METHOD(NativeTestTarget, newResultObject, "(JI)Lorg/apache/harmony/dalvik/NativeTestTarget$Result;"),
+    NATIVE_METHOD(NativeTestTarget, pinByteArrayCritical, "([B)I"),
+    NATIVE_METHOD(NativeTestTarget, pinByteArrayRO, "([B)I"),
+    NATIVE_METHOD(NativeTestTarget, pinByteArrayRW, "([B)V"),
+    NATIVE_METHOD(NativeTestTarget, pinIntArrayRO, "([I)I"),
+    NATIVE_METHOD(NativeTestTarget, scopedLocalRefs, "([Ljava/lang/Object;)I"),
+    NATIVE_METHOD(NativeTestTarget, throwException, "()V"),
+    NATIVE_METHOD(NativeTestTarget, throwExceptionFmt, "(I)V"),
 };
 int register_org_apache_harmony_dalvik_NativeTestTarget(JNIEnv* env) {
+    ScopedLocalRef<jclass> resultClass(env,
+            env->FindClass("org/apache/harmony/dalvik/NativeTestTarget$Result"));
+    gResultClass = reinterpret_cast<jclass>(env->NewGlobalRef(resultClass.get()));
+    gResultConstructor = env->GetMethodID(gResultClass, "<init>", "(JI)V");
     return jniRegisterNativeMethods(env, "org/apache/harmony/dalvik/NativeTestTarget", gMethods, NELEM(gMethods));
 }
@@ -110,6 +110,36 @@ public class ObjectStreamClassTest extends TestCase {
         }
     }
 
+    static class SuidClass implements Serializable {
+        int a;
+        private long b;
+
+        public SuidClass(int a) {
+            this.a = a;
+        }
+
+        public SuidClass() {
+        }
+
+        public void m(long b) {
+            this.b = b;
+        }
+
+        public void m(int a) {
+            this.a = a;
+        }
+    }
+
+    // With no serialVersionUID declared, the SUID comes from a hash of the
+    // class's members sorted by name and signature. The expected value is the
+    // one the serialization specification's algorithm gives for SuidClass.
+    public void test_getSerialVersionUID_computed() {
+        for (int i = 0; i < 2; i++) {
+            ObjectStreamClass osc = ObjectStreamClass.lookup(SuidClass.class);
+            assertEquals(-5677845865463562519L, osc.getSerialVersionUID());
+        }
+    }
+
     /**
      * java.io.ObjectStreamClass#lookup(java.lang.Class)
      */
@@ -0,0 +1,116 @@
+/*
+ * Copyright (C) 2014 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ADAPTIVE_MUTEX_H_included
+#define ADAPTIVE_MUTEX_H_included
+
+#include "LockCounters.h"
+
+#include <pthread.h>
+#include <stddef.h>
+
+/**
+ * A mutex for critical sections that are only a few instructions long, where blocking in the
+ * kernel costs far more than waiting for the holder to finish. A contended lock spins for a
+ * while before blocking. How long it spins adapts to how long spinning has recently taken to
+ * succeed, up to MAX_SPIN_COUNT attempts. This is glibc's PTHREAD_MUTEX_ADAPTIVE_NP policy,
+ * which neither bionic nor Darwin offers.
+ */
+class AdaptiveMutex {
+public:
+    static const int MAX_SPIN_COUNT = 100;
+
+    // There's deliberately no destructor, as with a PTHREAD_MUTEX_INITIALIZER mutex, so a
+    // static AdaptiveMutex stays usable by threads still running while the process exits.
+    AdaptiveMutex() : mSpinEstimate(0) {
+        pthread_mutex_init(&mMutex, NULL);
+    }
+
+    void lock(LockCounters* counters = NULL) {
+        if (pthread_mutex_trylock(&mMutex) == 0) {
+            countLockAcquisition(counters, false, false);
+            return;
+        }
+        // The estimate is only a heuristic, so racy updates to it don't matter.
+        int estimate = __atomic_load_n(&mSpinEstimate, __ATOMIC_RELAXED);
+        int maxSpins = 2 * estimate + 10;
+        if (maxSpins > MAX_SPIN_COUNT) {
+            maxSpins = MAX_SPIN_COUNT;
+        }
+        int spins = 0;
+        bool parked = false;
+        while (pthread_mutex_trylock(&mMutex) != 0) {
+            if (++spins >= maxSpins) {
+                pthread_mutex_lock(&mMutex);
+                parked = true;
+                break;
+            }
+            cpuRelax();
+        }
+        __atomic_store_n(&mSpinEstimate, estimate + (spins - estimate) / 8, __ATOMIC_RELAXED);
+        countLockAcquisition(counters, true, parked);
+    }
+
+    bool tryLock() {
+        return pthread_mutex_trylock(&mMutex) == 0;
+    }
+
+    void unlock() {
+        pthread_mutex_unlock(&mMutex);
+    }
+
+private:
+    static void cpuRelax() {
+#if defined(__i386__) || defined(__x86_64__)
+        __asm__ __volatile__("pause" ::: "memory");
+#elif defined(__aarch64__) || (defined(__arm__) && __ARM_ARCH >= 7)
+        __asm__ __volatile__("yield" ::: "memory");
+#else
+        __asm__ __volatile__("" ::: "memory");
+#endif
+    }
+
+    pthread_mutex_t mMutex;
+    int mSpinEstimate;
+
+    // Disallow copy and assignment.
+    AdaptiveMutex(const AdaptiveMutex&);
+    void operator=(const AdaptiveMutex&);
+};
+
+/**
+ * Locks and unlocks an AdaptiveMutex as it goes in and out of scope.
+ */
+class ScopedAdaptiveMutexLock {
+public:
+    explicit ScopedAdaptiveMutexLock(AdaptiveMutex* mutex, LockCounters* counters = NULL)
+            : mMutexPtr(mutex) {
+        mMutexPtr->lock(counters);
+    }
+
+    ~ScopedAdaptiveMutexLock() {
+        mMutexPtr->unlock();
+    }
+
+private:
+    AdaptiveMutex* mMutexPtr;
+
+    // Disallow copy and assignment.
+    ScopedAdaptiveMutexLock(const ScopedAdaptiveMutexLock&);
+    void operator=(const ScopedAdaptiveMutexLock&);
+};
+
+#endif  // ADAPTIVE_MUTEX_H_included
@@ -17,14 +17,16 @@
 #ifndef LOCAL_ARRAY_H_included
 #define LOCAL_ARRAY_H_included
 
+#include "ScratchArena.h"
+
 #include <cstddef>
 #include <new>
 
 /**
  * A fixed-size array with a size hint. That number of bytes will be allocated
  * on the stack, and used if possible, but if more bytes are requested at
- * construction time, a buffer will be allocated on the heap (and deallocated
- * by the destructor).
+ * construction time, a buffer will be taken from the thread's ScratchArena
+ * (or, failing that, the heap) and given back by the destructor.
  *
  * The API is intended to be a compatible subset of C++0x's std::array.
  */
@@ -34,22 +36,31 @@ public:
     /**
      * Allocates a new fixed-size array of the given size. If this size is
      * less than or equal to the template parameter STACK_BYTE_COUNT, an
-     * internal on-stack buffer will be used. Otherwise a heap buffer will
+     * internal on-stack buffer will be used. Otherwise a scratch buffer will
      * be allocated.
      */
-    LocalArray(size_t desiredByteCount) : mSize(desiredByteCount) {
+    LocalArray(size_t desiredByteCount) : mPtr(&mOnStackBuffer[0]), mSize(desiredByteCount),
+            mArena(NULL) {
         if (desiredByteCount > STACK_BYTE_COUNT) {
-            mPtr = new char[mSize];
-        } else {
-            mPtr = &mOnStackBuffer[0];
+            mArena = ScratchArena::current();
+            if (mArena != NULL) {
+                mMark = mArena->mark();
+                mPtr = reinterpret_cast<char*>(mArena->allocate(mSize, 1));
+            }
+            if (mPtr == NULL || mArena == NULL) {
+                mArena = NULL;
+                mPtr = new char[mSize];
+            }
         }
     }
 
     /**
-     * Frees the heap-allocated buffer, if there was one.
+     * Frees the scratch buffer, if there was one.
      */
     ~LocalArray() {
-        if (mPtr != &mOnStackBuffer[0]) {
+        if (mArena != NULL) {
+            mArena->release(mMark);
+        } else if (mPtr != &mOnStackBuffer[0]) {
             delete[] mPtr;
         }
     }
@@ -66,6 +77,8 @@ private:
     char mOnStackBuffer[STACK_BYTE_COUNT];
     char* mPtr;
     size_t mSize;
+    ScratchArena* mArena;
+    ScratchArena::Mark mMark;
 
     // Disallow copy and assignment.
     LocalArray(const LocalArray&);
@@ -0,0 +1,53 @@
+/*
+ * Copyright (C) 2014 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef LOCK_COUNTERS_H_included
+#define LOCK_COUNTERS_H_included
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * Optional contention counters for the locks in AdaptiveMutex.h and ScopedPthreadRwLock.h.
+ * Pass one to a lock operation to have it counted. The counters are relaxed atomics shared by
+ * every thread that uses them, so they cost a contended cache line of their own: they're for
+ * diagnosing a lock, not for leaving on in production.
+ */
+struct LockCounters {
+    // Every acquisition.
+    uint64_t acquisitions;
+    // Acquisitions where the lock wasn't free on the first attempt.
+    uint64_t contended;
+    // Contended acquisitions that gave up spinning (or never spun) and blocked.
+    uint64_t parked;
+};
+
+#define LOCK_COUNTERS_INITIALIZER { 0, 0, 0 }
+
+inline void countLockAcquisition(LockCounters* counters, bool contended, bool parked) {
+    if (counters == NULL) {
+        return;
+    }
+    __atomic_fetch_add(&counters->acquisitions, 1, __ATOMIC_RELAXED);
+    if (contended) {
+        __atomic_fetch_add(&counters->contended, 1, __ATOMIC_RELAXED);
+    }
+    if (parked) {
+        __atomic_fetch_add(&counters->parked, 1, __ATOMIC_RELAXED);
+    }
+}
+
+#endif  // LOCK_COUNTERS_H_included
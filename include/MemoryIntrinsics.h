@@ -0,0 +1,38 @@
+/*
+ * Copyright (C) 2014 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef MEMORY_INTRINSICS_H_included
+#define MEMORY_INTRINSICS_H_included
+
+/*
+ * The libcore.io.Memory natives that do nothing but a single load or store. None of them touch
+ * their JNIEnv, block, or throw, so libcore registers them as fast natives, and a VM may
+ * replace calls to them with an inline access of the given width. The address is a jlong and
+ * need not be aligned. Values are in native byte order; the Java wrappers do any swapping.
+ *
+ * V(methodName, signature, accessType, isStore)
+ */
+#define LIBCORE_IO_MEMORY_INTRINSICS(V) \
+    V(peekByte, "(J)B", jbyte, false) \
+    V(peekShortNative, "(J)S", jshort, false) \
+    V(peekIntNative, "(J)I", jint, false) \
+    V(peekLongNative, "(J)J", jlong, false) \
+    V(pokeByte, "(JB)V", jbyte, true) \
+    V(pokeShortNative, "(JS)V", jshort, true) \
+    V(pokeIntNative, "(JI)V", jint, true) \
+    V(pokeLongNative, "(JJ)V", jlong, true)
+
+#endif  // MEMORY_INTRINSICS_H_included
@@ -0,0 +1,85 @@
+/*
+ * Copyright (C) 2014 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef SCOPED_PTHREAD_RW_LOCK_H_included
+#define SCOPED_PTHREAD_RW_LOCK_H_included
+
+#include "LockCounters.h"
+
+#include <pthread.h>
+#include <stddef.h>
+
+/**
+ * Read-locks and unlocks a pthread_rwlock_t as it goes in and out of scope. Any number of
+ * readers can hold the lock at once, which suits read-mostly tables such as caches.
+ */
+class ScopedPthreadReadLock {
+public:
+    explicit ScopedPthreadReadLock(pthread_rwlock_t* lock, LockCounters* counters = NULL)
+            : mLockPtr(lock) {
+        if (counters == NULL) {
+            pthread_rwlock_rdlock(mLockPtr);
+        } else if (pthread_rwlock_tryrdlock(mLockPtr) == 0) {
+            countLockAcquisition(counters, false, false);
+        } else {
+            pthread_rwlock_rdlock(mLockPtr);
+            countLockAcquisition(counters, true, true);
+        }
+    }
+
+    ~ScopedPthreadReadLock() {
+        pthread_rwlock_unlock(mLockPtr);
+    }
+
+private:
+    pthread_rwlock_t* mLockPtr;
+
+    // Disallow copy and assignment.
+    ScopedPthreadReadLock(const ScopedPthreadReadLock&);
+    void operator=(const ScopedPthreadReadLock&);
+};
+
+/**
+ * Write-locks and unlocks a pthread_rwlock_t as it goes in and out of scope. A writer excludes
+ * both readers and other writers.
+ */
+class ScopedPthreadWriteLock {
+public:
+    explicit ScopedPthreadWriteLock(pthread_rwlock_t* lock, LockCounters* counters = NULL)
+            : mLockPtr(lock) {
+        if (counters == NULL) {
+            pthread_rwlock_wrlock(mLockPtr);
+        } else if (pthread_rwlock_trywrlock(mLockPtr) == 0) {
+            countLockAcquisition(counters, false, false);
+        } else {
+            pthread_rwlock_wrlock(mLockPtr);
+            countLockAcquisition(counters, true, true);
+        }
+    }
+
+    ~ScopedPthreadWriteLock() {
+        pthread_rwlock_unlock(mLockPtr);
+    }
+
+private:
+    pthread_rwlock_t* mLockPtr;
+
+    // Disallow copy and assignment.
+    ScopedPthreadWriteLock(const ScopedPthreadWriteLock&);
+    void operator=(const ScopedPthreadWriteLock&);
+};
+
+#endif  // SCOPED_PTHREAD_RW_LOCK_H_included
@@ -0,0 +1,279 @@
+/*
+ * Copyright (C) 2014 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef SCRATCH_ARENA_H_included
+#define SCRATCH_ARENA_H_included
+
+#include "JNIHelp.h"
+
+#include <pthread.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <new>
+
+/**
+ * A per-thread bump allocator for the short-lived buffers natives need while marshalling
+ * arguments: argv arrays, iovecs, path copies and the like. Memory is handed out in LIFO
+ * scopes (see ScopedScratchArena), and blocks are kept for reuse when a scope ends, so once a
+ * thread has warmed up, marshalling of the usual sizes never touches the heap.
+ *
+ * Each thread starts with a single INITIAL_BYTE_COUNT block. Requests that don't fit chain a
+ * larger block, which is kept as long as it isn't bigger than MAX_RETAINED_BYTE_COUNT. A
+ * thread's arena is freed when the thread exits.
+ */
+class ScratchArena {
+public:
+    static const size_t INITIAL_BYTE_COUNT = 16 * 1024;
+    static const size_t MAX_RETAINED_BYTE_COUNT = 256 * 1024;
+    static const size_t DEFAULT_ALIGNMENT = 16;
+
+    struct Block {
+        Block* next;
+        size_t capacity;
+        size_t used;
+
+        char* data() {
+            return reinterpret_cast<char*>(this) + HEADER_BYTE_COUNT;
+        }
+    };
+
+    struct Mark {
+        Block* block;
+        size_t used;
+    };
+
+    /**
+     * Returns the calling thread's arena, creating it on first use, or NULL if it couldn't
+     * be allocated.
+     */
+    static ScratchArena* current() {
+        ScratchArena*& arena = threadArena();
+        if (arena == NULL) {
+            arena = create();
+        }
+        return arena;
+    }
+
+    /**
+     * Returns 'byteCount' bytes aligned to 'alignment' (a power of two), or NULL if a new
+     * block was needed and couldn't be allocated.
+     */
+    void* allocate(size_t byteCount, size_t alignment = DEFAULT_ALIGNMENT) {
+        void* result = allocateFrom(mCurrent, byteCount, alignment);
+        if (result != NULL) {
+            return result;
+        }
+        if (byteCount > SIZE_MAX - alignment) {
+            return NULL;
+        }
+        // Move on to the next block, replacing it (and anything after it) if it's too small.
+        size_t needed = byteCount + alignment;
+        Block* next = mCurrent->next;
+        if (next != NULL && next->capacity < needed) {
+            freeBlocks(next);
+            next = mCurrent->next = NULL;
+        }
+        if (next == NULL) {
+            size_t capacity = 2 * mCurrent->capacity;
+            if (capacity < needed) {
+                capacity = needed;
+            }
+            next = newBlock(capacity);
+            if (next == NULL) {
+                return NULL;
+            }
+            mCurrent->next = next;
+        }
+        next->used = 0;
+        mCurrent = next;
+        return allocateFrom(mCurrent, byteCount, alignment);
+    }
+
+    Mark mark() const {
+        Mark result = { mCurrent, mCurrent->used };
+        return result;
+    }
+
+    /**
+     * Frees everything allocated since 'mark' was taken. Scopes must be released in the
+     * reverse of the order they were marked.
+     */
+    void release(const Mark& mark) {
+        mCurrent = mark.block;
+        mCurrent->used = mark.used;
+        if (mCurrent == &mFirst && mark.used == 0) {
+            // Nothing is live, so this is the time to give back an unusually large block.
+            Block* next = mFirst.next;
+            if (next != NULL && next->capacity > MAX_RETAINED_BYTE_COUNT) {
+                freeBlocks(next);
+                mFirst.next = NULL;
+            }
+        }
+    }
+
+private:
+    static const size_t HEADER_BYTE_COUNT = (sizeof(Block) + 15) & ~static_cast<size_t>(15);
+
+    static void* allocateFrom(Block* block, size_t byteCount, size_t alignment) {
+        uintptr_t begin = reinterpret_cast<uintptr_t>(block->data());
+        uintptr_t p = (begin + block->used + alignment - 1) & ~(alignment - 1);
+        if (byteCount > block->capacity || p - begin > block->capacity - byteCount) {
+            return NULL;
+        }
+        block->used = p - begin + byteCount;
+        return reinterpret_cast<void*>(p);
+    }
+
+    static Block* newBlock(size_t capacity) {
+        if (capacity > SIZE_MAX - HEADER_BYTE_COUNT) {
+            return NULL;
+        }
+        Block* block = reinterpret_cast<Block*>(malloc(HEADER_BYTE_COUNT + capacity));
+        if (block != NULL) {
+            block->next = NULL;
+            block->capacity = capacity;
+            block->used = 0;
+        }
+        return block;
+    }
+
+    static void freeBlocks(Block* block) {
+        while (block != NULL) {
+            Block* next = block->next;
+            free(block);
+            block = next;
+        }
+    }
+
+    static ScratchArena*& threadArena() {
+        static __thread ScratchArena* tArena = NULL;
+        return tArena;
+    }
+
+    static pthread_key_t& key() {
+        static pthread_key_t key;
+        return key;
+    }
+
+    static void createKey() {
+        pthread_key_create(&key(), destroy);
+    }
+
+    // Runs on the exiting thread. Other thread-specific destructors may still run after this
+    // one and use the arena, so forget it: current() then creates a fresh one, which
+    // pthread_setspecific hands back to a later round of destructor calls.
+    static void destroy(void* arena) {
+        threadArena() = NULL;
+        freeBlocks(reinterpret_cast<ScratchArena*>(arena)->mFirst.next);
+        free(arena);
+    }
+
+    // The arena and its first block are a single allocation, with the first block's data
+    // running on past the end of the arena itself.
+    static ScratchArena* create() {
+        static pthread_once_t keyOnce = PTHREAD_ONCE_INIT;
+        pthread_once(&keyOnce, createKey);
+        void* storage = malloc(sizeof(ScratchArena) + HEADER_BYTE_COUNT + INITIAL_BYTE_COUNT);
+        if (storage == NULL) {
+            return NULL;
+        }
+        ScratchArena* arena = new (storage) ScratchArena;
+        pthread_setspecific(key(), arena);
+        return arena;
+    }
+
+    ScratchArena() : mCurrent(&mFirst) {
+        mFirst.next = NULL;
+        mFirst.capacity = INITIAL_BYTE_COUNT;
+        mFirst.used = 0;
+    }
+
+    Block* mCurrent;
+    // mFirst must be last, since its data follows it.
+    Block mFirst;
+
+    // Disallow copy and assignment.
+    ScratchArena(const ScratchArena&);
+    void operator=(const ScratchArena&);
+};
+
+/**
+ * Allocates from the calling thread's ScratchArena, and frees everything allocated through
+ * it as it goes out of scope. Only the innermost live scope on a thread may allocate.
+ */
+class ScopedScratchArena {
+public:
+    ScopedScratchArena() : mArena(ScratchArena::current()) {
+        if (mArena != NULL) {
+            mMark = mArena->mark();
+        }
+    }
+
+    ~ScopedScratchArena() {
+        if (mArena != NULL) {
+            mArena->release(mMark);
+        }
+    }
+
+    /**
+     * Returns 'byteCount' bytes of uninitialized memory, or NULL if none could be found.
+     */
+    void* allocate(size_t byteCount, size_t alignment = ScratchArena::DEFAULT_ALIGNMENT) {
+        return (mArena != NULL) ? mArena->allocate(byteCount, alignment) : NULL;
+    }
+
+    /**
+     * Returns uninitialized storage for 'count' Ts, or NULL if none could be found.
+     */
+    template <typename T>
+    T* allocateArray(size_t count) {
+        if (count > SIZE_MAX / sizeof(T)) {
+            return NULL;
+        }
+        return reinterpret_cast<T*>(allocate(count * sizeof(T), __alignof__(T)));
+    }
+
+    /**
+     * Returns a NUL-terminated modified UTF-8 copy of 's'. Returns NULL with a
+     * NullPointerException pending if 's' is null, or with an OutOfMemoryError pending if
+     * there's no room for the copy.
+     */
+    char* utfChars(JNIEnv* env, jstring s) {
+        if (s == NULL) {
+            jniThrowNullPointerException(env, NULL);
+            return NULL;
+        }
+        jsize byteCount = env->GetStringUTFLength(s);
+        char* result = reinterpret_cast<char*>(allocate(byteCount + 1, 1));
+        if (result == NULL) {
+            jniThrowException(env, "java/lang/OutOfMemoryError", NULL);
+            return NULL;
+        }
+        env->GetStringUTFRegion(s, 0, env->GetStringLength(s), result);
+        result[byteCount] = '\0';
+        return result;
+    }
+
+private:
+    ScratchArena* mArena;
+    ScratchArena::Mark mMark;
+
+    // Disallow copy and assignment.
+    ScopedScratchArena(const ScopedScratchArena&);
+    void operator=(const ScopedScratchArena&);
+};
+
+#endif  // SCRATCH_ARENA_H_included
@@ -70,6 +70,27 @@ public class JSONTokener {
      */
     private int pos;
 
+    /**
+     * Inputs at least this long get a structural index. For shorter ones, the
+     * native call and the index cost more than they save.
+     */
+    private static final int MIN_INDEXED_LENGTH = 512;
+
+    /* The bitmaps in each block of the index. See scan. */
+    private static final int STRING_SPECIALS = 0;
+    private static final int LITERAL_ENDS = 1;
+    private static final int NON_WHITESPACE = 2;
+    private static final int WORDS_PER_BLOCK = 3;
+
+    /**
+     * The structural index of the input, or null if the input is short. For
+     * each block of 64 characters, this holds a bitmap of the quotes and
+     * backslashes, a bitmap of the characters that end a literal, and a bitmap
+     * of the characters that aren't whitespace. These let the parsing loops
+     * skip straight to the next character that matters.
+     */
+    private final long[] index;
+
     /**
      * @param in JSON encoded string. Null is not permitted and will yield a
      *     tokener that throws {@code NullPointerExceptions} when methods are
@@ -81,6 +102,38 @@ public class JSONTokener {
             in = in.substring(1);
         }
         this.in = in;
+        if (in != null && in.length() >= MIN_INDEXED_LENGTH) {
+            this.index = new long[(int) ((in.length() + 63L) / 64) * WORDS_PER_BLOCK];
+            scan(in, index);
+        } else {
+            this.index = null;
+        }
+    }
+
+    /**
+     * Fills {@code index} with the bitmaps described there, classifying many
+     * characters at a time with SIMD instructions where the CPU has them.
+     */
+    private static native void scan(String in, long[] index);
+
+    /**
+     * Returns the position of the first character at or after {@code from}
+     * that's set in the bitmap {@code kind} of the index, or the input's length
+     * if there's no such character. Without an index, returns {@code from}.
+     */
+    private int nextIndexed(int kind, int from) {
+        if (index == null || from >= in.length()) {
+            return from;
+        }
+        int block = from >>> 6;
+        long word = index[block * WORDS_PER_BLOCK + kind] & (-1L << from);
+        while (word == 0) {
+            if (++block == index.length / WORDS_PER_BLOCK) {
+                return in.length();
+            }
+            word = index[block * WORDS_PER_BLOCK + kind];
+        }
+        return (block << 6) + Long.numberOfTrailingZeros(word);
     }
 
     /**
@@ -113,7 +166,7 @@ public class JSONTokener {
     }
 
     private int nextCleanInternal() throws JSONException {
-        while (pos < in.length()) {
+        while ((pos = nextIndexed(NON_WHITESPACE, pos)) < in.length()) {
             int c = in.charAt(pos++);
             switch (c) {
                 case '\t':
@@ -202,7 +255,7 @@ public class JSONTokener {
         /* the index of the first character not yet appended to the builder. */
         int start = pos;
 
-        while (pos < in.length()) {
+        while ((pos = nextIndexed(STRING_SPECIALS, pos)) < in.length()) {
             int c = in.charAt(pos++);
             if (c == quote) {
                 if (builder == null) {
@@ -279,7 +332,14 @@ public class JSONTokener {
      * preference.
      */
     private Object readLiteral() throws JSONException {
-        String literal = nextToInternal("{}[]/\\:,=;# \t\f");
+        String literal;
+        if (index != null) {
+            int start = pos;
+            pos = nextIndexed(LITERAL_ENDS, pos);
+            literal = in.substring(start, pos);
+        } else {
+            literal = nextToInternal("{}[]/\\:,=;# \t\f");
+        }
 
         if (literal.length() == 0) {
             throw syntaxError("Expected literal value");
@@ -291,11 +351,16 @@ public class JSONTokener {
             return Boolean.FALSE;
         }
 
-        /* try to parse as an integral type... */
-        if (literal.indexOf('.') == -1) {
+        /*
+         * try to parse as an integral type... Numbers in exponential form
+         * (5e-10) never are, so skip them rather than pay for the exception.
+         */
+        boolean hex = literal.startsWith("0x") || literal.startsWith("0X");
+        if (literal.indexOf('.') == -1
+                && (hex || (literal.indexOf('e') == -1 && literal.indexOf('E') == -1))) {
             int base = 10;
             String number = literal;
-            if (number.startsWith("0x") || number.startsWith("0X")) {
+            if (hex) {
                 number = number.substring(2);
                 base = 16;
             } else if (number.startsWith("0") && number.length() > 1) {
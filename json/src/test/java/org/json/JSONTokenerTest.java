@@ -586,6 +586,73 @@ public class JSONTokenerTest extends TestCase {
         assertEquals(1, array.length());
     }
 
+    /**
+     * Long documents are parsed using a structural index; make sure that finds
+     * the same tokens, wherever they fall relative to the index's blocks.
+     */
+    public void testLongDocument() throws JSONException {
+        JSONArray expected = new JSONArray();
+        StringBuilder json = new StringBuilder("[");
+        for (int i = 0; i < 200; i++) {
+            if (i > 0) {
+                json.append(i % 3 == 0 ? ";" : ",");
+            }
+            // vary the whitespace so that tokens land at every offset in a block
+            for (int j = 0; j < i % 67; j++) {
+                json.append(j % 2 == 0 ? ' ' : '\n');
+            }
+            switch (i % 6) {
+                case 0:
+                    json.append("\"a\\\"b\\u0041 ' c").append(i).append('"');
+                    expected.put("a\"bA ' c" + i);
+                    break;
+                case 1:
+                    json.append("'x \" \\' y'");
+                    expected.put("x \" ' y");
+                    break;
+                case 2:
+                    json.append(i).append("e3");
+                    expected.put(i * 1000.0);
+                    break;
+                case 3:
+                    json.append("/* a comment, with \"quotes\" */ ").append(-i);
+                    expected.put(-i);
+                    break;
+                case 4:
+                    json.append("{\"k\"=>true # comment\n}");
+                    expected.put(new JSONObject().put("k", true));
+                    break;
+                case 5:
+                    json.append("unquoted\u00e9\u4e2d");
+                    expected.put("unquoted\u00e9\u4e2d");
+                    break;
+            }
+        }
+        json.append("\t]");
+        assertTrue(json.length() > 2048);
+        JSONArray actual = (JSONArray) new JSONTokener(json.toString()).nextValue();
+        assertEquals(expected.toString(), actual.toString());
+    }
+
+    public void testLongDocumentUnterminatedString() {
+        StringBuilder json = new StringBuilder("[\"");
+        for (int i = 0; i < 1000; i++) {
+            json.append('a');
+        }
+        try {
+            new JSONTokener(json.toString()).nextValue();
+            fail();
+        } catch (JSONException expected) {
+        }
+    }
+
+    public void testExponentialLiteral() throws JSONException {
+        assertEquals(5e-10, new JSONTokener("5e-10").nextValue());
+        assertEquals(1.0E3, new JSONTokener("1E3").nextValue());
+        assertEquals(30, new JSONTokener("0x1e").nextValue());
+        assertEquals("Hello", new JSONTokener("Hello").nextValue());
+    }
+
     public void testDehexchar() {
         assertEquals( 0, JSONTokener.dehexchar('0'));
         assertEquals( 1, JSONTokener.dehexchar('1'));
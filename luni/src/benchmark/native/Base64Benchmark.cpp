@@ -0,0 +1,75 @@
+/*
+ * Copyright (C) 2014 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "Base64Utilities.h"
+#include "NativeBenchmark.h"
+
+#include <vector>
+
+static const size_t BYTE_COUNT = 3 * 4096;
+
+static std::vector<jbyte> encodedBytes() {
+    std::vector<uint8_t> random(benchmarkBytes(BYTE_COUNT));
+    std::vector<jbyte> result(base64EncodedLength(random.size()));
+    base64Encode(reinterpret_cast<const jbyte*>(&random[0]), random.size(), &result[0]);
+    return result;
+}
+
+BENCHMARK(Base64_encode) {
+    std::vector<uint8_t> random(benchmarkBytes(BYTE_COUNT));
+    std::vector<jbyte> bytes(random.begin(), random.end());
+    std::vector<jbyte> dst(base64EncodedLength(bytes.size()));
+    while (state.keepRunning()) {
+        doNotOptimize(base64Encode(&bytes[0], bytes.size(), &dst[0]));
+    }
+    state.setBytesPerIteration(bytes.size());
+}
+
+BENCHMARK(Base64_decodeStrict) {
+    std::vector<jbyte> chars(encodedBytes());
+    std::vector<jbyte> dst(BYTE_COUNT);
+    while (state.keepRunning()) {
+        doNotOptimize(base64Decode(&chars[0], chars.size(), &dst[0], dst.size(), true));
+    }
+    state.setBytesPerIteration(chars.size());
+}
+
+BENCHMARK(Base64_decodeLenient) {
+    std::vector<jbyte> chars(encodedBytes());
+    std::vector<jbyte> dst(BYTE_COUNT);
+    while (state.keepRunning()) {
+        doNotOptimize(base64Decode(&chars[0], chars.size(), &dst[0], dst.size(), false));
+    }
+    state.setBytesPerIteration(chars.size());
+}
+
+// MIME-style input, with a CRLF after every 76 chars, which keeps knocking the lenient decoder
+// off its vector path.
+BENCHMARK(Base64_decodeLenientWrapped) {
+    std::vector<jbyte> encoded(encodedBytes());
+    std::vector<jbyte> chars;
+    for (size_t i = 0; i < encoded.size(); i += 76) {
+        size_t end = (i + 76 < encoded.size()) ? i + 76 : encoded.size();
+        chars.insert(chars.end(), encoded.begin() + i, encoded.begin() + end);
+        chars.push_back('\r');
+        chars.push_back('\n');
+    }
+    std::vector<jbyte> dst(chars.size() / 4 * 3);
+    while (state.keepRunning()) {
+        doNotOptimize(base64Decode(&chars[0], chars.size(), &dst[0], dst.size(), false));
+    }
+    state.setBytesPerIteration(chars.size());
+}
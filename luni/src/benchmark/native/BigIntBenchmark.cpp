@@ -0,0 +1,66 @@
+/*
+ * Copyright (C) 2014 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "NativeBenchmark.h"
+#include "cbigint.h"
+
+#include <string.h>
+
+BENCHMARK(cbigint_multiplyHighPrecision_8x8) {
+    BenchmarkRandom random;
+    uint64_t a[8];
+    uint64_t b[8];
+    for (size_t i = 0; i < 8; ++i) {
+        a[i] = random.next();
+        b[i] = random.next();
+    }
+    uint64_t product[16];
+    while (state.keepRunning()) {
+        multiplyHighPrecision(a, 8, b, 8, product, 16);
+        doNotOptimize(product[0]);
+    }
+}
+
+// Scales a 17-digit significand by 10^300, as StringToReal does for large exponents.
+BENCHMARK(cbigint_timesTenToTheEHighPrecision_300) {
+    uint64_t value[32];
+    while (state.keepRunning()) {
+        memset(value, 0, sizeof(value));
+        value[0] = UINT64_C(12345678901234567);
+        doNotOptimize(timesTenToTheEHighPrecision(value, 1, 300));
+    }
+}
+
+// Accumulates 300 decimal digits one at a time, as StringToReal does for long inputs.
+BENCHMARK(cbigint_simpleAppendDecimalDigitHighPrecision_300) {
+    BenchmarkRandom random;
+    uint64_t digits[300];
+    for (size_t i = 0; i < 300; ++i) {
+        digits[i] = random.next(10);
+    }
+    uint64_t value[32];
+    while (state.keepRunning()) {
+        memset(value, 0, sizeof(value));
+        int32_t length = 1;
+        for (size_t i = 0; i < 300; ++i) {
+            uint64_t overflow = simpleAppendDecimalDigitHighPrecision(value, length, digits[i]);
+            if (overflow != 0) {
+                value[length++] = overflow;
+            }
+        }
+        doNotOptimize(value[0]);
+    }
+}
@@ -0,0 +1,101 @@
+/*
+ * Copyright (C) 2014 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "NativeBenchmark.h"
+
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <string>
+
+extern bool canonicalize_path(const char* path, std::string& resolved);
+extern void set_canonicalize_path_cache_enabled(bool enabled);
+
+/*
+ * A scratch directory containing dir/a/b/c/d/file.txt, and a symbolic link "link" to dir/a/b,
+ * removed again when the benchmark finishes.
+ */
+class ScratchTree {
+public:
+    ScratchTree() {
+        char templ[] = "/tmp/canonicalize_path_benchmark.XXXXXX";
+        if (mkdtemp(templ) == NULL) {
+            perror("mkdtemp");
+            abort();
+        }
+        mRoot = templ;
+        std::string dir(mRoot);
+        static const char* const COMPONENTS[] = { "/dir", "/a", "/b", "/c", "/d" };
+        for (size_t i = 0; i < 5; ++i) {
+            dir += COMPONENTS[i];
+            mkdir(dir.c_str(), 0700);
+        }
+        close(open((dir + "/file.txt").c_str(), O_CREAT | O_WRONLY, 0600));
+        if (symlink("dir/a/b", (mRoot + "/link").c_str()) == -1) {
+            perror("symlink");
+            abort();
+        }
+    }
+
+    ~ScratchTree() {
+        unlink((mRoot + "/link").c_str());
+        unlink((mRoot + "/dir/a/b/c/d/file.txt").c_str());
+        rmdir((mRoot + "/dir/a/b/c/d").c_str());
+        rmdir((mRoot + "/dir/a/b/c").c_str());
+        rmdir((mRoot + "/dir/a/b").c_str());
+        rmdir((mRoot + "/dir/a").c_str());
+        rmdir((mRoot + "/dir").c_str());
+        rmdir(mRoot.c_str());
+    }
+
+    std::string path(const char* relativePath) const {
+        return mRoot + "/" + relativePath;
+    }
+
+private:
+    std::string mRoot;
+};
+
+static void benchmarkCanonicalize(BenchmarkState& state, const char* relativePath, bool cached) {
+    ScratchTree tree;
+    std::string path(tree.path(relativePath));
+    set_canonicalize_path_cache_enabled(cached);
+    std::string resolved;
+    while (state.keepRunning()) {
+        canonicalize_path(path.c_str(), resolved);
+        doNotOptimize(resolved);
+    }
+    set_canonicalize_path_cache_enabled(false);
+}
+
+BENCHMARK(canonicalize_path_plain) {
+    benchmarkCanonicalize(state, "dir/a/b/c/d/file.txt", false);
+}
+
+BENCHMARK(canonicalize_path_symlink) {
+    benchmarkCanonicalize(state, "link/c/../c/d/file.txt", false);
+}
+
+BENCHMARK(canonicalize_path_plain_cached) {
+    benchmarkCanonicalize(state, "dir/a/b/c/d/file.txt", true);
+}
+
+BENCHMARK(canonicalize_path_symlink_cached) {
+    benchmarkCanonicalize(state, "link/c/../c/d/file.txt", true);
+}
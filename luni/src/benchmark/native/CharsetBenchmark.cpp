@@ -0,0 +1,119 @@
+/*
+ * Copyright (C) 2014 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "CharsetUtilities.h"
+#include "NativeBenchmark.h"
+
+#include <vector>
+
+static const size_t CHAR_COUNT = 4096;
+
+// Printable US-ASCII, as in most markup and protocol text.
+static std::vector<jchar> asciiChars() {
+    BenchmarkRandom random;
+    std::vector<jchar> result(CHAR_COUNT);
+    for (size_t i = 0; i < result.size(); ++i) {
+        result[i] = ' ' + random.next(95);
+    }
+    return result;
+}
+
+// Mostly ASCII, with one char in 16 from Latin-1, Greek, or CJK.
+static std::vector<jchar> mixedChars() {
+    static const jchar NON_ASCII[] = { 0x00e9, 0x00fc, 0x03b1, 0x03c9, 0x4e2d, 0x6587 };
+    BenchmarkRandom random;
+    std::vector<jchar> result(asciiChars());
+    for (size_t i = 0; i < result.size(); i += 16) {
+        result[i + random.next(16)] = NON_ASCII[random.next(6)];
+    }
+    return result;
+}
+
+BENCHMARK(Charsets_asciiBytesToChars) {
+    std::vector<jchar> chars(asciiChars());
+    std::vector<jbyte> bytes(chars.begin(), chars.end());
+    std::vector<jchar> dst(bytes.size());
+    while (state.keepRunning()) {
+        asciiBytesToChars(&bytes[0], &dst[0], bytes.size());
+        doNotOptimize(dst[0]);
+    }
+    state.setBytesPerIteration(bytes.size());
+}
+
+BENCHMARK(Charsets_isoLatin1BytesToChars) {
+    std::vector<uint8_t> random(benchmarkBytes(CHAR_COUNT));
+    std::vector<jbyte> bytes(random.begin(), random.end());
+    std::vector<jchar> dst(bytes.size());
+    while (state.keepRunning()) {
+        isoLatin1BytesToChars(&bytes[0], &dst[0], bytes.size());
+        doNotOptimize(dst[0]);
+    }
+    state.setBytesPerIteration(bytes.size());
+}
+
+BENCHMARK(Charsets_charsToBytes) {
+    std::vector<jchar> chars(mixedChars());
+    std::vector<jbyte> dst(chars.size());
+    while (state.keepRunning()) {
+        charsToBytes(&chars[0], &dst[0], chars.size(), 0xff);
+        doNotOptimize(dst[0]);
+    }
+    state.setBytesPerIteration(chars.size() * sizeof(jchar));
+}
+
+BENCHMARK(Charsets_asciiCharsToBytesPrefix) {
+    std::vector<jchar> chars(asciiChars());
+    std::vector<jbyte> dst(chars.size());
+    while (state.keepRunning()) {
+        doNotOptimize(asciiCharsToBytesPrefix(&chars[0], &dst[0], chars.size()));
+    }
+    state.setBytesPerIteration(chars.size() * sizeof(jchar));
+}
+
+BENCHMARK(Charsets_charsToUtf16BytesPrefix) {
+    std::vector<jchar> chars(mixedChars());
+    std::vector<jbyte> dst(2 * chars.size());
+    while (state.keepRunning()) {
+        doNotOptimize(charsToUtf16BytesPrefix(&chars[0], &dst[0], chars.size(), true));
+    }
+    state.setBytesPerIteration(chars.size() * sizeof(jchar));
+}
+
+BENCHMARK(Charsets_charsToUtf8Bytes_ascii) {
+    std::vector<jchar> chars(asciiChars());
+    std::vector<jbyte> dst(utf8Length(&chars[0], chars.size()));
+    while (state.keepRunning()) {
+        doNotOptimize(charsToUtf8Bytes(&chars[0], chars.size(), &dst[0]));
+    }
+    state.setBytesPerIteration(chars.size() * sizeof(jchar));
+}
+
+BENCHMARK(Charsets_charsToUtf8Bytes_mixed) {
+    std::vector<jchar> chars(mixedChars());
+    std::vector<jbyte> dst(utf8Length(&chars[0], chars.size()));
+    while (state.keepRunning()) {
+        doNotOptimize(charsToUtf8Bytes(&chars[0], chars.size(), &dst[0]));
+    }
+    state.setBytesPerIteration(chars.size() * sizeof(jchar));
+}
+
+BENCHMARK(Charsets_utf8Length_mixed) {
+    std::vector<jchar> chars(mixedChars());
+    while (state.keepRunning()) {
+        doNotOptimize(utf8Length(&chars[0], chars.size()));
+    }
+    state.setBytesPerIteration(chars.size() * sizeof(jchar));
+}
@@ -0,0 +1,54 @@
+/*
+ * Copyright (C) 2014 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "NativeBenchmark.h"
+#include "ZipChecksums.h"
+
+#include <vector>
+
+static const size_t BYTE_COUNT = 64 * 1024;
+
+BENCHMARK(ZipChecksums_fastCrc32) {
+    std::vector<uint8_t> bytes(benchmarkBytes(BYTE_COUNT));
+    while (state.keepRunning()) {
+        doNotOptimize(fastCrc32(0, &bytes[0], bytes.size()));
+    }
+    state.setBytesPerIteration(bytes.size());
+}
+
+BENCHMARK(ZipChecksums_crc32_zlib) {
+    std::vector<uint8_t> bytes(benchmarkBytes(BYTE_COUNT));
+    while (state.keepRunning()) {
+        doNotOptimize(crc32(0, &bytes[0], bytes.size()));
+    }
+    state.setBytesPerIteration(bytes.size());
+}
+
+BENCHMARK(ZipChecksums_fastAdler32) {
+    std::vector<uint8_t> bytes(benchmarkBytes(BYTE_COUNT));
+    while (state.keepRunning()) {
+        doNotOptimize(fastAdler32(1, &bytes[0], bytes.size()));
+    }
+    state.setBytesPerIteration(bytes.size());
+}
+
+BENCHMARK(ZipChecksums_adler32_zlib) {
+    std::vector<uint8_t> bytes(benchmarkBytes(BYTE_COUNT));
+    while (state.keepRunning()) {
+        doNotOptimize(adler32(1, &bytes[0], bytes.size()));
+    }
+    state.setBytesPerIteration(bytes.size());
+}
@@ -0,0 +1,85 @@
+/*
+ * Copyright (C) 2014 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// InternedStringTable is private to the parser, so we include its file rather than linking it.
+#include "org_apache_harmony_xml_ExpatParser.cpp"
+
+#include "NativeBenchmark.h"
+
+#include <stdio.h>
+
+#include <string>
+#include <vector>
+
+static const size_t NAME_COUNT = 256;
+static const size_t LOOKUP_COUNT = 1024;
+
+// Element and attribute names of the lengths typical of real documents.
+static std::vector<std::string> xmlNames() {
+    static const char* const PREFIXES[] = { "item", "xmlns:android", "android:layout_width", "id" };
+    std::vector<std::string> result;
+    for (size_t i = 0; i < NAME_COUNT; ++i) {
+        char name[64];
+        snprintf(name, sizeof(name), "%s%zu", PREFIXES[i % 4], i);
+        result.push_back(name);
+    }
+    return result;
+}
+
+// Lookups in document order: a reproducible shuffle of the names, with repeats.
+static std::vector<size_t> lookupOrder() {
+    BenchmarkRandom random;
+    std::vector<size_t> result(LOOKUP_COUNT);
+    for (size_t i = 0; i < result.size(); ++i) {
+        result[i] = random.next(NAME_COUNT);
+    }
+    return result;
+}
+
+BENCHMARK(ExpatParser_InternedStringTable_hash) {
+    std::vector<std::string> names(xmlNames());
+    std::vector<size_t> order(lookupOrder());
+    while (state.keepRunning()) {
+        for (size_t i = 0; i < order.size(); ++i) {
+            const std::string& name = names[order[i]];
+            doNotOptimize(InternedStringTable::hash(name.data(), name.size()));
+        }
+    }
+}
+
+BENCHMARK(ExpatParser_InternedStringTable_find) {
+    std::vector<std::string> names(xmlNames());
+    std::vector<size_t> order(lookupOrder());
+    // The table never dereferences its jstrings, so any distinct non-NULL values will do.
+    InternedStringTable table;
+    for (size_t i = 0; i < names.size(); ++i) {
+        const std::string& name = names[i];
+        const char* bytes = table.copyBytes(name.data(), name.size());
+        table.add(bytes, name.size(), InternedStringTable::hash(name.data(), name.size()),
+                  reinterpret_cast<jstring>(i + 1));
+    }
+    std::vector<uint32_t> hashes(order.size());
+    for (size_t i = 0; i < order.size(); ++i) {
+        const std::string& name = names[order[i]];
+        hashes[i] = InternedStringTable::hash(name.data(), name.size());
+    }
+    while (state.keepRunning()) {
+        for (size_t i = 0; i < order.size(); ++i) {
+            const std::string& name = names[order[i]];
+            doNotOptimize(table.find(name.data(), name.size(), hashes[i]));
+        }
+    }
+}
@@ -0,0 +1,50 @@
+/*
+ * Copyright (C) 2014 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// The scanner is static, so we include the file that defines it rather than linking it.
+#include "org_json_JSONTokener.cpp"
+
+#include "NativeBenchmark.h"
+
+#include <string>
+#include <vector>
+
+// A pretty-printed array of small objects, typical of a REST response.
+static std::vector<jchar> jsonChars() {
+    BenchmarkRandom random;
+    std::string json("[\n");
+    while (json.size() < 64 * 1024) {
+        json += "  {\n    \"id\": ";
+        json += std::to_string(random.next(1000000));
+        json += ",\n    \"name\": \"item ";
+        json += std::to_string(random.next(1000));
+        json += "\",\n    \"price\": ";
+        json += std::to_string(random.next(10000));
+        json += ".99,\n    \"tags\": [\"a\", \"b\\\"c\"]\n  },\n";
+    }
+    json += "  null\n]\n";
+    return std::vector<jchar>(json.begin(), json.end());
+}
+
+BENCHMARK(JSONTokener_scan) {
+    std::vector<jchar> chars(jsonChars());
+    std::vector<uint64_t> words((chars.size() + 63) / 64 * WORDS_PER_BLOCK);
+    while (state.keepRunning()) {
+        scanJson(&chars[0], chars.size(), &words[0]);
+        doNotOptimize(words[0]);
+    }
+    state.setBytesPerIteration(chars.size() * sizeof(jchar));
+}
@@ -0,0 +1,100 @@
+/*
+ * Copyright (C) 2014 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "Lz4Frame.h"
+#include "NativeBenchmark.h"
+
+#include <string.h>
+#include <vector>
+#include <zlib.h>
+
+static const size_t BYTE_COUNT = 256 * 1024;
+
+// Something like an RPC payload: JSON records with repetitive keys but varying values.
+static std::vector<uint8_t> payloadBytes() {
+    static const char* WORDS[] = {
+        "{\"id\": ", "\"name\": \"", "\", \"tags\": [", "\"cache\", ", "\"rpc\"], ",
+        "\"score\": ", "}, ", "\"user-", "\"region\": \"eu\", ",
+    };
+    BenchmarkRandom random;
+    std::vector<uint8_t> result;
+    while (result.size() < BYTE_COUNT) {
+        const char* word = WORDS[random.next(sizeof(WORDS) / sizeof(WORDS[0]))];
+        result.insert(result.end(), word, word + strlen(word));
+        for (uint32_t digits = random.next(6); digits > 0; --digits) {
+            result.push_back('0' + random.next(10));
+        }
+    }
+    result.resize(BYTE_COUNT);
+    return result;
+}
+
+static std::vector<uint8_t> lz4Frame(const std::vector<uint8_t>& bytes) {
+    Lz4FrameEncoder encoder;
+    encoder.init();
+    std::vector<uint8_t> result(lz4CompressBound(bytes.size()) + 64);
+    encoder.borrowInput(&bytes[0], bytes.size());
+    result.resize(encoder.encode(&result[0], result.size(), false, true));
+    return result;
+}
+
+BENCHMARK(Lz4Frame_encode) {
+    std::vector<uint8_t> bytes(payloadBytes());
+    std::vector<uint8_t> dst(lz4CompressBound(bytes.size()) + 64);
+    Lz4FrameEncoder encoder;
+    encoder.init();
+    while (state.keepRunning()) {
+        encoder.reset();
+        encoder.borrowInput(&bytes[0], bytes.size());
+        doNotOptimize(encoder.encode(&dst[0], dst.size(), false, true));
+    }
+    state.setBytesPerIteration(bytes.size());
+}
+
+BENCHMARK(Lz4Frame_decode) {
+    std::vector<uint8_t> bytes(payloadBytes());
+    std::vector<uint8_t> frame(lz4Frame(bytes));
+    Lz4FrameDecoder decoder;
+    while (state.keepRunning()) {
+        decoder.reset();
+        decoder.borrowInput(&frame[0], frame.size());
+        doNotOptimize(decoder.decode(&bytes[0], bytes.size()));
+    }
+    state.setBytesPerIteration(bytes.size());
+}
+
+// Deflate at BEST_SPEED, for comparison.
+BENCHMARK(Lz4Frame_deflate_zlib) {
+    std::vector<uint8_t> bytes(payloadBytes());
+    std::vector<uint8_t> dst(compressBound(bytes.size()));
+    while (state.keepRunning()) {
+        uLongf length = dst.size();
+        doNotOptimize(compress2(&dst[0], &length, &bytes[0], bytes.size(), Z_BEST_SPEED));
+    }
+    state.setBytesPerIteration(bytes.size());
+}
+
+BENCHMARK(Lz4Frame_inflate_zlib) {
+    std::vector<uint8_t> bytes(payloadBytes());
+    std::vector<uint8_t> deflated(compressBound(bytes.size()));
+    uLongf deflatedLength = deflated.size();
+    compress2(&deflated[0], &deflatedLength, &bytes[0], bytes.size(), Z_BEST_SPEED);
+    while (state.keepRunning()) {
+        uLongf length = bytes.size();
+        doNotOptimize(uncompress(&bytes[0], &length, &deflated[0], deflatedLength));
+    }
+    state.setBytesPerIteration(bytes.size());
+}
@@ -0,0 +1,136 @@
+/*
+ * Copyright (C) 2014 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// The swap kernels are static, so we include the file that defines them rather than linking it.
+#include "libcore_io_Memory.cpp"
+
+#include "NativeBenchmark.h"
+
+#include <vector>
+
+static const size_t BYTE_COUNT = 16 * 1024;
+
+// Uses the SIMD block swap if this CPU has it, as register_libcore_io_Memory does.
+static void useBestSwapBlocks() {
+#if defined(SIMD_SWAP_SSSE3)
+    __builtin_cpu_init();
+    gHaveSsse3 = __builtin_cpu_supports("ssse3");
+#endif
+}
+
+static void useScalarSwap() {
+#if defined(SIMD_SWAP_SSSE3)
+    gHaveSsse3 = false;
+#endif
+}
+
+template <typename T, void (*swap)(T*, const T*, size_t)>
+static void benchmarkSwap(BenchmarkState& state, size_t misalignment) {
+    std::vector<uint8_t> src(benchmarkBytes(BYTE_COUNT + misalignment));
+    std::vector<uint8_t> dst(src.size());
+    const T* srcValues = reinterpret_cast<const T*>(&src[misalignment]);
+    T* dstValues = reinterpret_cast<T*>(&dst[misalignment]);
+    while (state.keepRunning()) {
+        swap(dstValues, srcValues, BYTE_COUNT / sizeof(T));
+        doNotOptimize(dst[0]);
+    }
+    state.setBytesPerIteration(BYTE_COUNT);
+}
+
+BENCHMARK(Memory_swapShorts) {
+    useBestSwapBlocks();
+    benchmarkSwap<jshort, swapShorts>(state, 0);
+}
+
+BENCHMARK(Memory_swapInts) {
+    useBestSwapBlocks();
+    benchmarkSwap<jint, swapInts>(state, 0);
+}
+
+BENCHMARK(Memory_swapInts_unaligned) {
+    useBestSwapBlocks();
+    benchmarkSwap<jint, swapInts>(state, 1);
+}
+
+BENCHMARK(Memory_swapInts_scalar) {
+    useScalarSwap();
+    benchmarkSwap<jint, swapInts>(state, 0);
+}
+
+BENCHMARK(Memory_swapLongs) {
+    useBestSwapBlocks();
+    benchmarkSwap<jlong, swapLongs>(state, 0);
+}
+
+BENCHMARK(Memory_swapLongs_unaligned) {
+    useBestSwapBlocks();
+    benchmarkSwap<jlong, swapLongs>(state, 1);
+}
+
+BENCHMARK(Memory_swapLongs_scalar) {
+    useScalarSwap();
+    benchmarkSwap<jlong, swapLongs>(state, 0);
+}
+
+// Copies between two buffers 'byteCount' bytes apart in one allocation, so that huge copies are
+// between distinct pages but small ones share a cache line or two.
+static void benchmarkCopy(BenchmarkState& state, size_t byteCount, bool allowThreads) {
+    std::vector<jbyte> buffer(2 * byteCount);
+    jbyte* src = &buffer[0];
+    jbyte* dst = &buffer[byteCount];
+    while (state.keepRunning()) {
+        tieredMemmove(dst, src, byteCount, allowThreads);
+        doNotOptimize(dst[0]);
+    }
+    state.setBytesPerIteration(byteCount);
+}
+
+static void benchmarkPlainMemmove(BenchmarkState& state, size_t byteCount) {
+    std::vector<jbyte> buffer(2 * byteCount);
+    jbyte* src = &buffer[0];
+    jbyte* dst = &buffer[byteCount];
+    while (state.keepRunning()) {
+        memmove(dst, src, byteCount);
+        doNotOptimize(dst[0]);
+    }
+    state.setBytesPerIteration(byteCount);
+}
+
+BENCHMARK(Memory_copy_inline_16) {
+    benchmarkCopy(state, 16, false);
+}
+
+BENCHMARK(Memory_copy_memmove_16) {
+    benchmarkPlainMemmove(state, 16);
+}
+
+BENCHMARK(Memory_copy_64K) {
+    benchmarkCopy(state, 64 * 1024, false);
+}
+
+BENCHMARK(Memory_copy_nonTemporal_64M) {
+    benchmarkCopy(state, 64 * 1024 * 1024, false);
+}
+
+BENCHMARK(Memory_copy_memmove_64M) {
+    benchmarkPlainMemmove(state, 64 * 1024 * 1024);
+}
+
+BENCHMARK(Memory_copy_parallel_64M) {
+    gMaxCopyThreads = 4;
+    benchmarkCopy(state, 64 * 1024 * 1024, true);
+    gMaxCopyThreads = 1;
+}
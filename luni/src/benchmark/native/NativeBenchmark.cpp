@@ -0,0 +1,133 @@
+/*
+ * Copyright (C) 2014 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "NativeBenchmark.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include <algorithm>
+#include <string>
+
+struct Benchmark {
+    const char* name;
+    BenchmarkFunction function;
+
+    bool operator<(const Benchmark& rhs) const {
+        return strcmp(name, rhs.name) < 0;
+    }
+};
+
+static std::vector<Benchmark>& benchmarks() {
+    // A function-local static, so registrations from other files' static initializers are safe.
+    static std::vector<Benchmark> benchmarks;
+    return benchmarks;
+}
+
+BenchmarkRegistration::BenchmarkRegistration(const char* name, BenchmarkFunction function) {
+    Benchmark benchmark = { name, function };
+    benchmarks().push_back(benchmark);
+}
+
+uint64_t BenchmarkState::benchmarkNanoTime() {
+    timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec * UINT64_C(1000000000) + now.tv_nsec;
+}
+
+std::vector<uint8_t> benchmarkBytes(size_t length) {
+    BenchmarkRandom random;
+    std::vector<uint8_t> result(length);
+    for (size_t i = 0; i < length; ++i) {
+        result[i] = static_cast<uint8_t>(random.next() >> 56);
+    }
+    return result;
+}
+
+static const uint64_t MAX_ITERATIONS = UINT64_C(1000000000);
+
+// Runs 'benchmark' with more and more iterations until a run takes at least 'minTimeNs'.
+static BenchmarkState run(const Benchmark& benchmark, uint64_t minTimeNs) {
+    uint64_t iterations = 1;
+    while (true) {
+        BenchmarkState state(iterations);
+        benchmark.function(state);
+        if (state.elapsedNs() >= minTimeNs || iterations >= MAX_ITERATIONS) {
+            return state;
+        }
+        // Aim 20% past the target, growing by at least 2x and at most 100x per attempt.
+        double scale = (state.elapsedNs() == 0) ? 100.0
+                : 1.2 * minTimeNs / state.elapsedNs();
+        scale = (scale < 2.0) ? 2.0 : (scale > 100.0) ? 100.0 : scale;
+        iterations = static_cast<uint64_t>(iterations * scale);
+        if (iterations > MAX_ITERATIONS) {
+            iterations = MAX_ITERATIONS;
+        }
+    }
+}
+
+static void usage() {
+    fprintf(stderr, "usage: libjavacore-benchmarks [--min-time-ms=N] [NAME-SUBSTRING...]\n");
+    exit(1);
+}
+
+int main(int argc, char* argv[]) {
+    uint64_t minTimeNs = UINT64_C(500000000);
+    std::vector<std::string> filters;
+    for (int i = 1; i < argc; ++i) {
+        if (strncmp(argv[i], "--min-time-ms=", 14) == 0) {
+            char* end;
+            unsigned long long ms = strtoull(argv[i] + 14, &end, 10);
+            if (*end != '\0' || end == argv[i] + 14) {
+                usage();
+            }
+            minTimeNs = ms * 1000000;
+        } else if (argv[i][0] == '-') {
+            usage();
+        } else {
+            filters.push_back(argv[i]);
+        }
+    }
+
+    std::sort(benchmarks().begin(), benchmarks().end());
+    printf("{\n  \"benchmarks\": [");
+    bool first = true;
+    for (size_t i = 0; i < benchmarks().size(); ++i) {
+        const Benchmark& benchmark = benchmarks()[i];
+        bool selected = filters.empty();
+        for (size_t j = 0; j < filters.size() && !selected; ++j) {
+            selected = (strstr(benchmark.name, filters[j].c_str()) != NULL);
+        }
+        if (!selected) {
+            continue;
+        }
+        BenchmarkState state(run(benchmark, minTimeNs));
+        double nsPerIteration = static_cast<double>(state.elapsedNs()) / state.iterations();
+        printf("%s\n    {\"name\": \"%s\", \"iterations\": %llu, \"ns_per_iteration\": %.3f",
+               first ? "" : ",", benchmark.name,
+               static_cast<unsigned long long>(state.iterations()), nsPerIteration);
+        if (state.bytesPerIteration() != 0) {
+            printf(", \"bytes_per_second\": %.0f", state.bytesPerIteration() * 1e9 / nsPerIteration);
+        }
+        printf("}");
+        fflush(stdout);
+        first = false;
+    }
+    printf("\n  ]\n}\n");
+    return 0;
+}
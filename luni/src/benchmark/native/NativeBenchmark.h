@@ -0,0 +1,123 @@
+/*
+ * Copyright (C) 2014 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef NATIVE_BENCHMARK_H_included
+#define NATIVE_BENCHMARK_H_included
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <vector>
+
+/*
+ * A minimal harness for timing libjavacore's native kernels without the JNI and VM overhead
+ * the Caliper benchmarks include. Each benchmark is a function that does its setup and then
+ * loops while BenchmarkState::keepRunning() returns true; only the loop is timed. The harness
+ * grows the iteration count until a run lasts long enough, and prints the results as JSON.
+ *
+ *     BENCHMARK(Foo_bar) {
+ *         std::vector<char> input = benchmarkBytes(4096);
+ *         while (state.keepRunning()) {
+ *             doNotOptimize(bar(&input[0], input.size()));
+ *         }
+ *         state.setBytesPerIteration(input.size());
+ *     }
+ */
+
+class BenchmarkState {
+public:
+    explicit BenchmarkState(uint64_t iterations)
+            : mIterations(iterations), mCompleted(0), mStartNs(0), mElapsedNs(0),
+              mBytesPerIteration(0) {
+    }
+
+    bool keepRunning() {
+        if (mCompleted == 0 && mStartNs == 0) {
+            mStartNs = benchmarkNanoTime();
+        }
+        if (mCompleted < mIterations) {
+            ++mCompleted;
+            return true;
+        }
+        mElapsedNs = benchmarkNanoTime() - mStartNs;
+        return false;
+    }
+
+    // Records how many bytes of input each iteration processes, for a throughput figure.
+    void setBytesPerIteration(uint64_t bytes) {
+        mBytesPerIteration = bytes;
+    }
+
+    uint64_t iterations() const { return mIterations; }
+    uint64_t elapsedNs() const { return mElapsedNs; }
+    uint64_t bytesPerIteration() const { return mBytesPerIteration; }
+
+    static uint64_t benchmarkNanoTime();
+
+private:
+    uint64_t mIterations;
+    uint64_t mCompleted;
+    uint64_t mStartNs;
+    uint64_t mElapsedNs;
+    uint64_t mBytesPerIteration;
+};
+
+typedef void (*BenchmarkFunction)(BenchmarkState& state);
+
+struct BenchmarkRegistration {
+    BenchmarkRegistration(const char* name, BenchmarkFunction function);
+};
+
+#define BENCHMARK(name) \
+    static void name(BenchmarkState& state); \
+    static BenchmarkRegistration name ## _registration(#name, name); \
+    static void name(BenchmarkState& state)
+
+// Stops the compiler from discarding a computation whose result is otherwise unused.
+template <typename T>
+inline void doNotOptimize(const T& value) {
+    __asm__ __volatile__("" : : "g"(&value) : "memory");
+}
+
+/*
+ * A xorshift64* generator with a fixed seed, so that every run of every benchmark sees the same
+ * inputs.
+ */
+class BenchmarkRandom {
+public:
+    BenchmarkRandom() : mState(UINT64_C(0x9e3779b97f4a7c15)) {
+    }
+
+    uint64_t next() {
+        mState ^= mState >> 12;
+        mState ^= mState << 25;
+        mState ^= mState >> 27;
+        return mState * UINT64_C(2685821657736338717);
+    }
+
+    // Returns a value in [0, bound).
+    uint32_t next(uint32_t bound) {
+        return static_cast<uint32_t>((next() >> 32) % bound);
+    }
+
+private:
+    uint64_t mState;
+};
+
+// Returns 'length' reproducible pseudo-random bytes.
+std::vector<uint8_t> benchmarkBytes(size_t length);
+
+#endif  // NATIVE_BENCHMARK_H_included
@@ -0,0 +1,68 @@
+/*
+ * Copyright (C) 2014 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// formatDouble is static, so we include the file that defines it rather than linking it.
+#include "java_lang_RealToString.cpp"
+
+#include "NativeBenchmark.h"
+
+#include <string.h>
+
+#include <vector>
+
+static const size_t DOUBLE_COUNT = 1024;
+
+// Doubles with uniformly random bits, and so mostly 16 or 17 significant digits.
+static std::vector<jdouble> randomDoubles() {
+    BenchmarkRandom random;
+    std::vector<jdouble> result;
+    while (result.size() < DOUBLE_COUNT) {
+        uint64_t bits = random.next();
+        jdouble d;
+        memcpy(&d, &bits, sizeof(d));
+        if (d == d && d - d == 0) {  // Skip NaNs and infinities.
+            result.push_back(d);
+        }
+    }
+    return result;
+}
+
+// Amounts with two decimal places, the kind of value most programs actually print.
+static std::vector<jdouble> shortDoubles() {
+    BenchmarkRandom random;
+    std::vector<jdouble> result(DOUBLE_COUNT);
+    for (size_t i = 0; i < result.size(); ++i) {
+        result[i] = random.next(10000000) / 100.0;
+    }
+    return result;
+}
+
+static void benchmarkFormatDouble(BenchmarkState& state, const std::vector<jdouble>& values) {
+    char dst[MAX_DOUBLE_CHARS];
+    while (state.keepRunning()) {
+        for (size_t i = 0; i < values.size(); ++i) {
+            doNotOptimize(formatDouble(values[i], dst));
+        }
+    }
+}
+
+BENCHMARK(RealToString_formatDouble_random) {
+    benchmarkFormatDouble(state, randomDoubles());
+}
+
+BENCHMARK(RealToString_formatDouble_short) {
+    benchmarkFormatDouble(state, shortDoubles());
+}
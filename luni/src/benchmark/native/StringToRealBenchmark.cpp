@@ -0,0 +1,72 @@
+/*
+ * Copyright (C) 2014 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// parseDecimalToken is static, so we include the file that defines it rather than linking it.
+#include "java_lang_StringToReal.cpp"
+
+#include "NativeBenchmark.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#include <string>
+#include <vector>
+
+static const size_t TOKEN_COUNT = 1024;
+
+// Formats doubles with uniformly random bits using 'format', skipping NaNs and infinities.
+static std::vector<std::string> tokens(const char* format) {
+    BenchmarkRandom random;
+    std::vector<std::string> result;
+    while (result.size() < TOKEN_COUNT) {
+        uint64_t bits = random.next();
+        jdouble d;
+        memcpy(&d, &bits, sizeof(d));
+        if (d == d && d - d == 0) {
+            char buf[32];
+            snprintf(buf, sizeof(buf), format, d);
+            result.push_back(buf);
+        }
+    }
+    return result;
+}
+
+static void benchmarkParse(BenchmarkState& state, const std::vector<std::string>& values) {
+    size_t byteCount = 0;
+    for (size_t i = 0; i < values.size(); ++i) {
+        byteCount += values[i].size();
+    }
+    while (state.keepRunning()) {
+        for (size_t i = 0; i < values.size(); ++i) {
+            const char* p = values[i].c_str();
+            jdouble result;
+            // The env is only used to report running out of memory.
+            parseDecimalToken<char>(NULL, p, p + values[i].size(), &result);
+            doNotOptimize(result);
+        }
+    }
+    state.setBytesPerIteration(byteCount);
+}
+
+// Round-trip precision, which needs the slow path for some inputs.
+BENCHMARK(StringToReal_parseDecimalToken_17digits) {
+    benchmarkParse(state, tokens("%.17g"));
+}
+
+// Few enough digits for the fast paths.
+BENCHMARK(StringToReal_parseDecimalToken_6digits) {
+    benchmarkParse(state, tokens("%.6g"));
+}
@@ -52,6 +52,17 @@ public final class ErrnoException extends Exception {
     this.errno = errno;
   }
 
+  /**
+   * Constructs a stackless instance that can't be given a cause or suppressed exceptions, so
+   * that libcore can throw the same instance repeatedly for errors like EAGAIN that callers
+   * expect and only check the errno of.
+   */
+  private ErrnoException(String functionName, int errno, boolean unused) {
+    super(null, null, false, false);
+    this.functionName = functionName;
+    this.errno = errno;
+  }
+
   /**
    * Converts the stashed function name and errno value to a human-readable string.
    * We do this here rather than in the constructor so that callers only pay for
@@ -21,6 +21,12 @@ package android.system;
  * @hide
  */
 public final class OsConstants {
+    // The values of every constant below, in declaration order, fetched from native code in a
+    // single call. Each constant takes the next value as the class is initialized, which also
+    // stops javac from inlining them.
+    private static final int[] VALUES = values();
+    private static int nextValue;
+
     private OsConstants() {
     }
 
@@ -94,468 +100,493 @@ public final class OsConstants {
      */
     public static boolean WIFSIGNALED(int status) { return (WTERMSIG(status + 1) >= 2); }
 
-    public static final int AF_INET = placeholder();
-    public static final int AF_INET6 = placeholder();
-    public static final int AF_UNIX = placeholder();
-    public static final int AF_UNSPEC = placeholder();
-    public static final int AI_ADDRCONFIG = placeholder();
-    public static final int AI_ALL = placeholder();
-    public static final int AI_CANONNAME = placeholder();
-    public static final int AI_NUMERICHOST = placeholder();
-    public static final int AI_NUMERICSERV = placeholder();
-    public static final int AI_PASSIVE = placeholder();
-    public static final int AI_V4MAPPED = placeholder();
-    public static final int CAP_AUDIT_CONTROL = placeholder();
-    public static final int CAP_AUDIT_WRITE = placeholder();
-    public static final int CAP_BLOCK_SUSPEND = placeholder();
-    public static final int CAP_CHOWN = placeholder();
-    public static final int CAP_DAC_OVERRIDE = placeholder();
-    public static final int CAP_DAC_READ_SEARCH = placeholder();
-    public static final int CAP_FOWNER = placeholder();
-    public static final int CAP_FSETID = placeholder();
-    public static final int CAP_IPC_LOCK = placeholder();
-    public static final int CAP_IPC_OWNER = placeholder();
-    public static final int CAP_KILL = placeholder();
-    public static final int CAP_LAST_CAP = placeholder();
-    public static final int CAP_LEASE = placeholder();
-    public static final int CAP_LINUX_IMMUTABLE = placeholder();
-    public static final int CAP_MAC_ADMIN = placeholder();
-    public static final int CAP_MAC_OVERRIDE = placeholder();
-    public static final int CAP_MKNOD = placeholder();
-    public static final int CAP_NET_ADMIN = placeholder();
-    public static final int CAP_NET_BIND_SERVICE = placeholder();
-    public static final int CAP_NET_BROADCAST = placeholder();
-    public static final int CAP_NET_RAW = placeholder();
-    public static final int CAP_SETFCAP = placeholder();
-    public static final int CAP_SETGID = placeholder();
-    public static final int CAP_SETPCAP = placeholder();
-    public static final int CAP_SETUID = placeholder();
-    public static final int CAP_SYS_ADMIN = placeholder();
-    public static final int CAP_SYS_BOOT = placeholder();
-    public static final int CAP_SYS_CHROOT = placeholder();
-    public static final int CAP_SYSLOG = placeholder();
-    public static final int CAP_SYS_MODULE = placeholder();
-    public static final int CAP_SYS_NICE = placeholder();
-    public static final int CAP_SYS_PACCT = placeholder();
-    public static final int CAP_SYS_PTRACE = placeholder();
-    public static final int CAP_SYS_RAWIO = placeholder();
-    public static final int CAP_SYS_RESOURCE = placeholder();
-    public static final int CAP_SYS_TIME = placeholder();
-    public static final int CAP_SYS_TTY_CONFIG = placeholder();
-    public static final int CAP_WAKE_ALARM = placeholder();
-    public static final int E2BIG = placeholder();
-    public static final int EACCES = placeholder();
-    public static final int EADDRINUSE = placeholder();
-    public static final int EADDRNOTAVAIL = placeholder();
-    public static final int EAFNOSUPPORT = placeholder();
-    public static final int EAGAIN = placeholder();
-    public static final int EAI_AGAIN = placeholder();
-    public static final int EAI_BADFLAGS = placeholder();
-    public static final int EAI_FAIL = placeholder();
-    public static final int EAI_FAMILY = placeholder();
-    public static final int EAI_MEMORY = placeholder();
-    public static final int EAI_NODATA = placeholder();
-    public static final int EAI_NONAME = placeholder();
-    public static final int EAI_OVERFLOW = placeholder();
-    public static final int EAI_SERVICE = placeholder();
-    public static final int EAI_SOCKTYPE = placeholder();
-    public static final int EAI_SYSTEM = placeholder();
-    public static final int EALREADY = placeholder();
-    public static final int EBADF = placeholder();
-    public static final int EBADMSG = placeholder();
-    public static final int EBUSY = placeholder();
-    public static final int ECANCELED = placeholder();
-    public static final int ECHILD = placeholder();
-    public static final int ECONNABORTED = placeholder();
-    public static final int ECONNREFUSED = placeholder();
-    public static final int ECONNRESET = placeholder();
-    public static final int EDEADLK = placeholder();
-    public static final int EDESTADDRREQ = placeholder();
-    public static final int EDOM = placeholder();
-    public static final int EDQUOT = placeholder();
-    public static final int EEXIST = placeholder();
-    public static final int EFAULT = placeholder();
-    public static final int EFBIG = placeholder();
-    public static final int EHOSTUNREACH = placeholder();
-    public static final int EIDRM = placeholder();
-    public static final int EILSEQ = placeholder();
-    public static final int EINPROGRESS = placeholder();
-    public static final int EINTR = placeholder();
-    public static final int EINVAL = placeholder();
-    public static final int EIO = placeholder();
-    public static final int EISCONN = placeholder();
-    public static final int EISDIR = placeholder();
-    public static final int ELOOP = placeholder();
-    public static final int EMFILE = placeholder();
-    public static final int EMLINK = placeholder();
-    public static final int EMSGSIZE = placeholder();
-    public static final int EMULTIHOP = placeholder();
-    public static final int ENAMETOOLONG = placeholder();
-    public static final int ENETDOWN = placeholder();
-    public static final int ENETRESET = placeholder();
-    public static final int ENETUNREACH = placeholder();
-    public static final int ENFILE = placeholder();
-    public static final int ENOBUFS = placeholder();
-    public static final int ENODATA = placeholder();
-    public static final int ENODEV = placeholder();
-    public static final int ENOENT = placeholder();
-    public static final int ENOEXEC = placeholder();
-    public static final int ENOLCK = placeholder();
-    public static final int ENOLINK = placeholder();
-    public static final int ENOMEM = placeholder();
-    public static final int ENOMSG = placeholder();
-    public static final int ENOPROTOOPT = placeholder();
-    public static final int ENOSPC = placeholder();
-    public static final int ENOSR = placeholder();
-    public static final int ENOSTR = placeholder();
-    public static final int ENOSYS = placeholder();
-    public static final int ENOTCONN = placeholder();
-    public static final int ENOTDIR = placeholder();
-    public static final int ENOTEMPTY = placeholder();
-    public static final int ENOTSOCK = placeholder();
-    public static final int ENOTSUP = placeholder();
-    public static final int ENOTTY = placeholder();
-    public static final int ENXIO = placeholder();
-    public static final int EOPNOTSUPP = placeholder();
-    public static final int EOVERFLOW = placeholder();
-    public static final int EPERM = placeholder();
-    public static final int EPIPE = placeholder();
-    public static final int EPROTO = placeholder();
-    public static final int EPROTONOSUPPORT = placeholder();
-    public static final int EPROTOTYPE = placeholder();
-    public static final int ERANGE = placeholder();
-    public static final int EROFS = placeholder();
-    public static final int ESPIPE = placeholder();
-    public static final int ESRCH = placeholder();
-    public static final int ESTALE = placeholder();
-    public static final int ETIME = placeholder();
-    public static final int ETIMEDOUT = placeholder();
-    public static final int ETXTBSY = placeholder();
+    public static final int AF_INET = next();
+    public static final int AF_INET6 = next();
+    public static final int AF_UNIX = next();
+    public static final int AF_UNSPEC = next();
+    public static final int AI_ADDRCONFIG = next();
+    public static final int AI_ALL = next();
+    public static final int AI_CANONNAME = next();
+    public static final int AI_NUMERICHOST = next();
+    public static final int AI_NUMERICSERV = next();
+    public static final int AI_PASSIVE = next();
+    public static final int AI_V4MAPPED = next();
+    public static final int CAP_AUDIT_CONTROL = next();
+    public static final int CAP_AUDIT_WRITE = next();
+    public static final int CAP_BLOCK_SUSPEND = next();
+    public static final int CAP_CHOWN = next();
+    public static final int CAP_DAC_OVERRIDE = next();
+    public static final int CAP_DAC_READ_SEARCH = next();
+    public static final int CAP_FOWNER = next();
+    public static final int CAP_FSETID = next();
+    public static final int CAP_IPC_LOCK = next();
+    public static final int CAP_IPC_OWNER = next();
+    public static final int CAP_KILL = next();
+    public static final int CAP_LAST_CAP = next();
+    public static final int CAP_LEASE = next();
+    public static final int CAP_LINUX_IMMUTABLE = next();
+    public static final int CAP_MAC_ADMIN = next();
+    public static final int CAP_MAC_OVERRIDE = next();
+    public static final int CAP_MKNOD = next();
+    public static final int CAP_NET_ADMIN = next();
+    public static final int CAP_NET_BIND_SERVICE = next();
+    public static final int CAP_NET_BROADCAST = next();
+    public static final int CAP_NET_RAW = next();
+    public static final int CAP_SETFCAP = next();
+    public static final int CAP_SETGID = next();
+    public static final int CAP_SETPCAP = next();
+    public static final int CAP_SETUID = next();
+    public static final int CAP_SYS_ADMIN = next();
+    public static final int CAP_SYS_BOOT = next();
+    public static final int CAP_SYS_CHROOT = next();
+    public static final int CAP_SYSLOG = next();
+    public static final int CAP_SYS_MODULE = next();
+    public static final int CAP_SYS_NICE = next();
+    public static final int CAP_SYS_PACCT = next();
+    public static final int CAP_SYS_PTRACE = next();
+    public static final int CAP_SYS_RAWIO = next();
+    public static final int CAP_SYS_RESOURCE = next();
+    public static final int CAP_SYS_TIME = next();
+    public static final int CAP_SYS_TTY_CONFIG = next();
+    public static final int CAP_WAKE_ALARM = next();
+    public static final int E2BIG = next();
+    public static final int EACCES = next();
+    public static final int EADDRINUSE = next();
+    public static final int EADDRNOTAVAIL = next();
+    public static final int EAFNOSUPPORT = next();
+    public static final int EAGAIN = next();
+    public static final int EAI_AGAIN = next();
+    public static final int EAI_BADFLAGS = next();
+    public static final int EAI_FAIL = next();
+    public static final int EAI_FAMILY = next();
+    public static final int EAI_MEMORY = next();
+    public static final int EAI_NODATA = next();
+    public static final int EAI_NONAME = next();
+    public static final int EAI_OVERFLOW = next();
+    public static final int EAI_SERVICE = next();
+    public static final int EAI_SOCKTYPE = next();
+    public static final int EAI_SYSTEM = next();
+    public static final int EALREADY = next();
+    public static final int EBADF = next();
+    public static final int EBADMSG = next();
+    public static final int EBUSY = next();
+    public static final int ECANCELED = next();
+    public static final int ECHILD = next();
+    public static final int ECONNABORTED = next();
+    public static final int ECONNREFUSED = next();
+    public static final int ECONNRESET = next();
+    public static final int EDEADLK = next();
+    public static final int EDESTADDRREQ = next();
+    public static final int EDOM = next();
+    public static final int EDQUOT = next();
+    public static final int EEXIST = next();
+    public static final int EFAULT = next();
+    public static final int EFBIG = next();
+    public static final int EHOSTUNREACH = next();
+    public static final int EIDRM = next();
+    public static final int EILSEQ = next();
+    public static final int EINPROGRESS = next();
+    public static final int EINTR = next();
+    public static final int EINVAL = next();
+    public static final int EIO = next();
+    public static final int EISCONN = next();
+    public static final int EISDIR = next();
+    public static final int ELOOP = next();
+    public static final int EMFILE = next();
+    public static final int EMLINK = next();
+    public static final int EMSGSIZE = next();
+    public static final int EMULTIHOP = next();
+    public static final int ENAMETOOLONG = next();
+    public static final int ENETDOWN = next();
+    public static final int ENETRESET = next();
+    public static final int ENETUNREACH = next();
+    public static final int ENFILE = next();
+    public static final int ENOBUFS = next();
+    public static final int ENODATA = next();
+    public static final int ENODEV = next();
+    public static final int ENOENT = next();
+    public static final int ENOEXEC = next();
+    public static final int ENOLCK = next();
+    public static final int ENOLINK = next();
+    public static final int ENOMEM = next();
+    public static final int ENOMSG = next();
+    public static final int ENOPROTOOPT = next();
+    public static final int ENOSPC = next();
+    public static final int ENOSR = next();
+    public static final int ENOSTR = next();
+    public static final int ENOSYS = next();
+    public static final int ENOTCONN = next();
+    public static final int ENOTDIR = next();
+    public static final int ENOTEMPTY = next();
+    public static final int ENOTSOCK = next();
+    public static final int ENOTSUP = next();
+    public static final int ENOTTY = next();
+    public static final int ENXIO = next();
+    public static final int EOPNOTSUPP = next();
+    public static final int EOVERFLOW = next();
+    public static final int EPERM = next();
+    public static final int EPIPE = next();
+    public static final int EPROTO = next();
+    public static final int EPROTONOSUPPORT = next();
+    public static final int EPROTOTYPE = next();
+    public static final int ERANGE = next();
+    public static final int EROFS = next();
+    public static final int ESPIPE = next();
+    public static final int ESRCH = next();
+    public static final int ESTALE = next();
+    public static final int ETIME = next();
+    public static final int ETIMEDOUT = next();
+    public static final int ETXTBSY = next();
     // On Linux, EWOULDBLOCK == EAGAIN. Use EAGAIN instead, to reduce confusion.
-    public static final int EXDEV = placeholder();
-    public static final int EXIT_FAILURE = placeholder();
-    public static final int EXIT_SUCCESS = placeholder();
-    public static final int FD_CLOEXEC = placeholder();
-    public static final int FIONREAD = placeholder();
-    public static final int F_DUPFD = placeholder();
-    public static final int F_GETFD = placeholder();
-    public static final int F_GETFL = placeholder();
-    public static final int F_GETLK = placeholder();
-    public static final int F_GETLK64 = placeholder();
-    public static final int F_GETOWN = placeholder();
-    public static final int F_OK = placeholder();
-    public static final int F_RDLCK = placeholder();
-    public static final int F_SETFD = placeholder();
-    public static final int F_SETFL = placeholder();
-    public static final int F_SETLK = placeholder();
-    public static final int F_SETLK64 = placeholder();
-    public static final int F_SETLKW = placeholder();
-    public static final int F_SETLKW64 = placeholder();
-    public static final int F_SETOWN = placeholder();
-    public static final int F_UNLCK = placeholder();
-    public static final int F_WRLCK = placeholder();
-    public static final int IFA_F_DADFAILED = placeholder();
-    public static final int IFA_F_DEPRECATED = placeholder();
-    public static final int IFA_F_HOMEADDRESS = placeholder();
-    public static final int IFA_F_NODAD = placeholder();
-    public static final int IFA_F_OPTIMISTIC = placeholder();
-    public static final int IFA_F_PERMANENT = placeholder();
-    public static final int IFA_F_SECONDARY = placeholder();
-    public static final int IFA_F_TEMPORARY = placeholder();
-    public static final int IFA_F_TENTATIVE = placeholder();
-    public static final int IFF_ALLMULTI = placeholder();
-    public static final int IFF_AUTOMEDIA = placeholder();
-    public static final int IFF_BROADCAST = placeholder();
-    public static final int IFF_DEBUG = placeholder();
-    public static final int IFF_DYNAMIC = placeholder();
-    public static final int IFF_LOOPBACK = placeholder();
-    public static final int IFF_MASTER = placeholder();
-    public static final int IFF_MULTICAST = placeholder();
-    public static final int IFF_NOARP = placeholder();
-    public static final int IFF_NOTRAILERS = placeholder();
-    public static final int IFF_POINTOPOINT = placeholder();
-    public static final int IFF_PORTSEL = placeholder();
-    public static final int IFF_PROMISC = placeholder();
-    public static final int IFF_RUNNING = placeholder();
-    public static final int IFF_SLAVE = placeholder();
-    public static final int IFF_UP = placeholder();
-    public static final int IPPROTO_ICMP = placeholder();
-    public static final int IPPROTO_ICMPV6 = placeholder();
-    public static final int IPPROTO_IP = placeholder();
-    public static final int IPPROTO_IPV6 = placeholder();
-    public static final int IPPROTO_RAW = placeholder();
-    public static final int IPPROTO_TCP = placeholder();
-    public static final int IPPROTO_UDP = placeholder();
-    public static final int IPV6_CHECKSUM = placeholder();
-    public static final int IPV6_MULTICAST_HOPS = placeholder();
-    public static final int IPV6_MULTICAST_IF = placeholder();
-    public static final int IPV6_MULTICAST_LOOP = placeholder();
-    public static final int IPV6_RECVDSTOPTS = placeholder();
-    public static final int IPV6_RECVHOPLIMIT = placeholder();
-    public static final int IPV6_RECVHOPOPTS = placeholder();
-    public static final int IPV6_RECVPKTINFO = placeholder();
-    public static final int IPV6_RECVRTHDR = placeholder();
-    public static final int IPV6_RECVTCLASS = placeholder();
-    public static final int IPV6_TCLASS = placeholder();
-    public static final int IPV6_UNICAST_HOPS = placeholder();
-    public static final int IPV6_V6ONLY = placeholder();
-    public static final int IP_MULTICAST_IF = placeholder();
-    public static final int IP_MULTICAST_LOOP = placeholder();
-    public static final int IP_MULTICAST_TTL = placeholder();
-    public static final int IP_TOS = placeholder();
-    public static final int IP_TTL = placeholder();
-    public static final int MAP_FIXED = placeholder();
-    public static final int MAP_PRIVATE = placeholder();
-    public static final int MAP_SHARED = placeholder();
-    public static final int MCAST_JOIN_GROUP = placeholder();
-    public static final int MCAST_LEAVE_GROUP = placeholder();
-    public static final int MCAST_JOIN_SOURCE_GROUP = placeholder();
-    public static final int MCAST_LEAVE_SOURCE_GROUP = placeholder();
-    public static final int MCAST_BLOCK_SOURCE = placeholder();
-    public static final int MCAST_UNBLOCK_SOURCE = placeholder();
-    public static final int MCL_CURRENT = placeholder();
-    public static final int MCL_FUTURE = placeholder();
-    public static final int MSG_CTRUNC = placeholder();
-    public static final int MSG_DONTROUTE = placeholder();
-    public static final int MSG_EOR = placeholder();
-    public static final int MSG_OOB = placeholder();
-    public static final int MSG_PEEK = placeholder();
-    public static final int MSG_TRUNC = placeholder();
-    public static final int MSG_WAITALL = placeholder();
-    public static final int MS_ASYNC = placeholder();
-    public static final int MS_INVALIDATE = placeholder();
-    public static final int MS_SYNC = placeholder();
-    public static final int NI_DGRAM = placeholder();
-    public static final int NI_NAMEREQD = placeholder();
-    public static final int NI_NOFQDN = placeholder();
-    public static final int NI_NUMERICHOST = placeholder();
-    public static final int NI_NUMERICSERV = placeholder();
-    public static final int O_ACCMODE = placeholder();
-    public static final int O_APPEND = placeholder();
-    public static final int O_CREAT = placeholder();
-    public static final int O_EXCL = placeholder();
-    public static final int O_NOCTTY = placeholder();
-    public static final int O_NOFOLLOW = placeholder();
-    public static final int O_NONBLOCK = placeholder();
-    public static final int O_RDONLY = placeholder();
-    public static final int O_RDWR = placeholder();
-    public static final int O_SYNC = placeholder();
-    public static final int O_TRUNC = placeholder();
-    public static final int O_WRONLY = placeholder();
-    public static final int POLLERR = placeholder();
-    public static final int POLLHUP = placeholder();
-    public static final int POLLIN = placeholder();
-    public static final int POLLNVAL = placeholder();
-    public static final int POLLOUT = placeholder();
-    public static final int POLLPRI = placeholder();
-    public static final int POLLRDBAND = placeholder();
-    public static final int POLLRDNORM = placeholder();
-    public static final int POLLWRBAND = placeholder();
-    public static final int POLLWRNORM = placeholder();
-    public static final int PR_GET_DUMPABLE = placeholder();
-    public static final int PR_SET_DUMPABLE = placeholder();
-    public static final int PR_SET_NO_NEW_PRIVS = placeholder();
-    public static final int PROT_EXEC = placeholder();
-    public static final int PROT_NONE = placeholder();
-    public static final int PROT_READ = placeholder();
-    public static final int PROT_WRITE = placeholder();
-    public static final int R_OK = placeholder();
-    public static final int RT_SCOPE_HOST = placeholder();
-    public static final int RT_SCOPE_LINK = placeholder();
-    public static final int RT_SCOPE_NOWHERE = placeholder();
-    public static final int RT_SCOPE_SITE = placeholder();
-    public static final int RT_SCOPE_UNIVERSE = placeholder();
-    public static final int SEEK_CUR = placeholder();
-    public static final int SEEK_END = placeholder();
-    public static final int SEEK_SET = placeholder();
-    public static final int SHUT_RD = placeholder();
-    public static final int SHUT_RDWR = placeholder();
-    public static final int SHUT_WR = placeholder();
-    public static final int SIGABRT = placeholder();
-    public static final int SIGALRM = placeholder();
-    public static final int SIGBUS = placeholder();
-    public static final int SIGCHLD = placeholder();
-    public static final int SIGCONT = placeholder();
-    public static final int SIGFPE = placeholder();
-    public static final int SIGHUP = placeholder();
-    public static final int SIGILL = placeholder();
-    public static final int SIGINT = placeholder();
-    public static final int SIGIO = placeholder();
-    public static final int SIGKILL = placeholder();
-    public static final int SIGPIPE = placeholder();
-    public static final int SIGPROF = placeholder();
-    public static final int SIGPWR = placeholder();
-    public static final int SIGQUIT = placeholder();
-    public static final int SIGRTMAX = placeholder();
-    public static final int SIGRTMIN = placeholder();
-    public static final int SIGSEGV = placeholder();
-    public static final int SIGSTKFLT = placeholder();
-    public static final int SIGSTOP = placeholder();
-    public static final int SIGSYS = placeholder();
-    public static final int SIGTERM = placeholder();
-    public static final int SIGTRAP = placeholder();
-    public static final int SIGTSTP = placeholder();
-    public static final int SIGTTIN = placeholder();
-    public static final int SIGTTOU = placeholder();
-    public static final int SIGURG = placeholder();
-    public static final int SIGUSR1 = placeholder();
-    public static final int SIGUSR2 = placeholder();
-    public static final int SIGVTALRM = placeholder();
-    public static final int SIGWINCH = placeholder();
-    public static final int SIGXCPU = placeholder();
-    public static final int SIGXFSZ = placeholder();
-    public static final int SIOCGIFADDR = placeholder();
-    public static final int SIOCGIFBRDADDR = placeholder();
-    public static final int SIOCGIFDSTADDR = placeholder();
-    public static final int SIOCGIFNETMASK = placeholder();
-    public static final int SOCK_DGRAM = placeholder();
-    public static final int SOCK_RAW = placeholder();
-    public static final int SOCK_SEQPACKET = placeholder();
-    public static final int SOCK_STREAM = placeholder();
-    public static final int SOL_SOCKET = placeholder();
-    public static final int SO_BINDTODEVICE = placeholder();
-    public static final int SO_BROADCAST = placeholder();
-    public static final int SO_DEBUG = placeholder();
-    public static final int SO_DONTROUTE = placeholder();
-    public static final int SO_ERROR = placeholder();
-    public static final int SO_KEEPALIVE = placeholder();
-    public static final int SO_LINGER = placeholder();
-    public static final int SO_OOBINLINE = placeholder();
-    public static final int SO_PASSCRED = placeholder();
-    public static final int SO_PEERCRED = placeholder();
-    public static final int SO_RCVBUF = placeholder();
-    public static final int SO_RCVLOWAT = placeholder();
-    public static final int SO_RCVTIMEO = placeholder();
-    public static final int SO_REUSEADDR = placeholder();
-    public static final int SO_SNDBUF = placeholder();
-    public static final int SO_SNDLOWAT = placeholder();
-    public static final int SO_SNDTIMEO = placeholder();
-    public static final int SO_TYPE = placeholder();
-    public static final int STDERR_FILENO = placeholder();
-    public static final int STDIN_FILENO = placeholder();
-    public static final int STDOUT_FILENO = placeholder();
-    public static final int S_IFBLK = placeholder();
-    public static final int S_IFCHR = placeholder();
-    public static final int S_IFDIR = placeholder();
-    public static final int S_IFIFO = placeholder();
-    public static final int S_IFLNK = placeholder();
-    public static final int S_IFMT = placeholder();
-    public static final int S_IFREG = placeholder();
-    public static final int S_IFSOCK = placeholder();
-    public static final int S_IRGRP = placeholder();
-    public static final int S_IROTH = placeholder();
-    public static final int S_IRUSR = placeholder();
-    public static final int S_IRWXG = placeholder();
-    public static final int S_IRWXO = placeholder();
-    public static final int S_IRWXU = placeholder();
-    public static final int S_ISGID = placeholder();
-    public static final int S_ISUID = placeholder();
-    public static final int S_ISVTX = placeholder();
-    public static final int S_IWGRP = placeholder();
-    public static final int S_IWOTH = placeholder();
-    public static final int S_IWUSR = placeholder();
-    public static final int S_IXGRP = placeholder();
-    public static final int S_IXOTH = placeholder();
-    public static final int S_IXUSR = placeholder();
-    public static final int TCP_NODELAY = placeholder();
-    public static final int WCONTINUED = placeholder();
-    public static final int WEXITED = placeholder();
-    public static final int WNOHANG = placeholder();
-    public static final int WNOWAIT = placeholder();
-    public static final int WSTOPPED = placeholder();
-    public static final int WUNTRACED = placeholder();
-    public static final int W_OK = placeholder();
-    public static final int X_OK = placeholder();
-    public static final int _SC_2_CHAR_TERM = placeholder();
-    public static final int _SC_2_C_BIND = placeholder();
-    public static final int _SC_2_C_DEV = placeholder();
-    public static final int _SC_2_C_VERSION = placeholder();
-    public static final int _SC_2_FORT_DEV = placeholder();
-    public static final int _SC_2_FORT_RUN = placeholder();
-    public static final int _SC_2_LOCALEDEF = placeholder();
-    public static final int _SC_2_SW_DEV = placeholder();
-    public static final int _SC_2_UPE = placeholder();
-    public static final int _SC_2_VERSION = placeholder();
-    public static final int _SC_AIO_LISTIO_MAX = placeholder();
-    public static final int _SC_AIO_MAX = placeholder();
-    public static final int _SC_AIO_PRIO_DELTA_MAX = placeholder();
-    public static final int _SC_ARG_MAX = placeholder();
-    public static final int _SC_ASYNCHRONOUS_IO = placeholder();
-    public static final int _SC_ATEXIT_MAX = placeholder();
-    public static final int _SC_AVPHYS_PAGES = placeholder();
-    public static final int _SC_BC_BASE_MAX = placeholder();
-    public static final int _SC_BC_DIM_MAX = placeholder();
-    public static final int _SC_BC_SCALE_MAX = placeholder();
-    public static final int _SC_BC_STRING_MAX = placeholder();
-    public static final int _SC_CHILD_MAX = placeholder();
-    public static final int _SC_CLK_TCK = placeholder();
-    public static final int _SC_COLL_WEIGHTS_MAX = placeholder();
-    public static final int _SC_DELAYTIMER_MAX = placeholder();
-    public static final int _SC_EXPR_NEST_MAX = placeholder();
-    public static final int _SC_FSYNC = placeholder();
-    public static final int _SC_GETGR_R_SIZE_MAX = placeholder();
-    public static final int _SC_GETPW_R_SIZE_MAX = placeholder();
-    public static final int _SC_IOV_MAX = placeholder();
-    public static final int _SC_JOB_CONTROL = placeholder();
-    public static final int _SC_LINE_MAX = placeholder();
-    public static final int _SC_LOGIN_NAME_MAX = placeholder();
-    public static final int _SC_MAPPED_FILES = placeholder();
-    public static final int _SC_MEMLOCK = placeholder();
-    public static final int _SC_MEMLOCK_RANGE = placeholder();
-    public static final int _SC_MEMORY_PROTECTION = placeholder();
-    public static final int _SC_MESSAGE_PASSING = placeholder();
-    public static final int _SC_MQ_OPEN_MAX = placeholder();
-    public static final int _SC_MQ_PRIO_MAX = placeholder();
-    public static final int _SC_NGROUPS_MAX = placeholder();
-    public static final int _SC_NPROCESSORS_CONF = placeholder();
-    public static final int _SC_NPROCESSORS_ONLN = placeholder();
-    public static final int _SC_OPEN_MAX = placeholder();
-    public static final int _SC_PAGESIZE = placeholder();
-    public static final int _SC_PAGE_SIZE = placeholder();
-    public static final int _SC_PASS_MAX = placeholder();
-    public static final int _SC_PHYS_PAGES = placeholder();
-    public static final int _SC_PRIORITIZED_IO = placeholder();
-    public static final int _SC_PRIORITY_SCHEDULING = placeholder();
-    public static final int _SC_REALTIME_SIGNALS = placeholder();
-    public static final int _SC_RE_DUP_MAX = placeholder();
-    public static final int _SC_RTSIG_MAX = placeholder();
-    public static final int _SC_SAVED_IDS = placeholder();
-    public static final int _SC_SEMAPHORES = placeholder();
-    public static final int _SC_SEM_NSEMS_MAX = placeholder();
-    public static final int _SC_SEM_VALUE_MAX = placeholder();
-    public static final int _SC_SHARED_MEMORY_OBJECTS = placeholder();
-    public static final int _SC_SIGQUEUE_MAX = placeholder();
-    public static final int _SC_STREAM_MAX = placeholder();
-    public static final int _SC_SYNCHRONIZED_IO = placeholder();
-    public static final int _SC_THREADS = placeholder();
-    public static final int _SC_THREAD_ATTR_STACKADDR = placeholder();
-    public static final int _SC_THREAD_ATTR_STACKSIZE = placeholder();
-    public static final int _SC_THREAD_DESTRUCTOR_ITERATIONS = placeholder();
-    public static final int _SC_THREAD_KEYS_MAX = placeholder();
-    public static final int _SC_THREAD_PRIORITY_SCHEDULING = placeholder();
-    public static final int _SC_THREAD_PRIO_INHERIT = placeholder();
-    public static final int _SC_THREAD_PRIO_PROTECT = placeholder();
-    public static final int _SC_THREAD_SAFE_FUNCTIONS = placeholder();
-    public static final int _SC_THREAD_STACK_MIN = placeholder();
-    public static final int _SC_THREAD_THREADS_MAX = placeholder();
-    public static final int _SC_TIMERS = placeholder();
-    public static final int _SC_TIMER_MAX = placeholder();
-    public static final int _SC_TTY_NAME_MAX = placeholder();
-    public static final int _SC_TZNAME_MAX = placeholder();
-    public static final int _SC_VERSION = placeholder();
-    public static final int _SC_XBS5_ILP32_OFF32 = placeholder();
-    public static final int _SC_XBS5_ILP32_OFFBIG = placeholder();
-    public static final int _SC_XBS5_LP64_OFF64 = placeholder();
-    public static final int _SC_XBS5_LPBIG_OFFBIG = placeholder();
-    public static final int _SC_XOPEN_CRYPT = placeholder();
-    public static final int _SC_XOPEN_ENH_I18N = placeholder();
-    public static final int _SC_XOPEN_LEGACY = placeholder();
-    public static final int _SC_XOPEN_REALTIME = placeholder();
-    public static final int _SC_XOPEN_REALTIME_THREADS = placeholder();
-    public static final int _SC_XOPEN_SHM = placeholder();
-    public static final int _SC_XOPEN_UNIX = placeholder();
-    public static final int _SC_XOPEN_VERSION = placeholder();
-    public static final int _SC_XOPEN_XCU_VERSION = placeholder();
+    public static final int EXDEV = next();
+    public static final int EXIT_FAILURE = next();
+    public static final int EXIT_SUCCESS = next();
+    public static final int FD_CLOEXEC = next();
+    public static final int FIONREAD = next();
+    public static final int F_DUPFD = next();
+    public static final int F_GETFD = next();
+    public static final int F_GETFL = next();
+    public static final int F_GETLK = next();
+    public static final int F_GETLK64 = next();
+    public static final int F_GETOWN = next();
+    public static final int F_OK = next();
+    public static final int F_RDLCK = next();
+    public static final int F_SETFD = next();
+    public static final int F_SETFL = next();
+    public static final int F_SETLK = next();
+    public static final int F_SETLK64 = next();
+    public static final int F_SETLKW = next();
+    public static final int F_SETLKW64 = next();
+    public static final int F_SETOWN = next();
+    public static final int F_UNLCK = next();
+    public static final int F_WRLCK = next();
+    public static final int IFA_F_DADFAILED = next();
+    public static final int IFA_F_DEPRECATED = next();
+    public static final int IFA_F_HOMEADDRESS = next();
+    public static final int IFA_F_NODAD = next();
+    public static final int IFA_F_OPTIMISTIC = next();
+    public static final int IFA_F_PERMANENT = next();
+    public static final int IFA_F_SECONDARY = next();
+    public static final int IFA_F_TEMPORARY = next();
+    public static final int IFA_F_TENTATIVE = next();
+    public static final int IFF_ALLMULTI = next();
+    public static final int IFF_AUTOMEDIA = next();
+    public static final int IFF_BROADCAST = next();
+    public static final int IFF_DEBUG = next();
+    public static final int IFF_DYNAMIC = next();
+    public static final int IFF_LOOPBACK = next();
+    public static final int IFF_MASTER = next();
+    public static final int IFF_MULTICAST = next();
+    public static final int IFF_NOARP = next();
+    public static final int IFF_NOTRAILERS = next();
+    public static final int IFF_POINTOPOINT = next();
+    public static final int IFF_PORTSEL = next();
+    public static final int IFF_PROMISC = next();
+    public static final int IFF_RUNNING = next();
+    public static final int IFF_SLAVE = next();
+    public static final int IFF_UP = next();
+    public static final int IPPROTO_ICMP = next();
+    public static final int IPPROTO_ICMPV6 = next();
+    public static final int IPPROTO_IP = next();
+    public static final int IPPROTO_IPV6 = next();
+    public static final int IPPROTO_RAW = next();
+    public static final int IPPROTO_TCP = next();
+    public static final int IPPROTO_UDP = next();
+    public static final int IPV6_CHECKSUM = next();
+    public static final int IPV6_MULTICAST_HOPS = next();
+    public static final int IPV6_MULTICAST_IF = next();
+    public static final int IPV6_MULTICAST_LOOP = next();
+    public static final int IPV6_RECVDSTOPTS = next();
+    public static final int IPV6_RECVHOPLIMIT = next();
+    public static final int IPV6_RECVHOPOPTS = next();
+    public static final int IPV6_RECVPKTINFO = next();
+    public static final int IPV6_RECVRTHDR = next();
+    public static final int IPV6_RECVTCLASS = next();
+    public static final int IPV6_TCLASS = next();
+    public static final int IPV6_UNICAST_HOPS = next();
+    public static final int IPV6_V6ONLY = next();
+    public static final int IP_MULTICAST_IF = next();
+    public static final int IP_MULTICAST_LOOP = next();
+    public static final int IP_MULTICAST_TTL = next();
+    public static final int IP_TOS = next();
+    public static final int IP_TTL = next();
+    /** @hide */ public static final int MADV_DONTNEED = next();
+    /** @hide */ public static final int MADV_HUGEPAGE = next();
+    /** @hide */ public static final int MADV_NORMAL = next();
+    /** @hide */ public static final int MADV_RANDOM = next();
+    /** @hide */ public static final int MADV_SEQUENTIAL = next();
+    /** @hide */ public static final int MADV_WILLNEED = next();
+    public static final int MAP_FIXED = next();
+    /** @hide */ public static final int MAP_HUGETLB = next();
+    /** @hide */ public static final int MAP_POPULATE = next();
+    public static final int MAP_PRIVATE = next();
+    public static final int MAP_SHARED = next();
+    public static final int MCAST_JOIN_GROUP = next();
+    public static final int MCAST_LEAVE_GROUP = next();
+    public static final int MCAST_JOIN_SOURCE_GROUP = next();
+    public static final int MCAST_LEAVE_SOURCE_GROUP = next();
+    public static final int MCAST_BLOCK_SOURCE = next();
+    public static final int MCAST_UNBLOCK_SOURCE = next();
+    public static final int MCL_CURRENT = next();
+    public static final int MCL_FUTURE = next();
+    public static final int MSG_CTRUNC = next();
+    public static final int MSG_DONTROUTE = next();
+    public static final int MSG_EOR = next();
+    public static final int MSG_OOB = next();
+    public static final int MSG_PEEK = next();
+    public static final int MSG_TRUNC = next();
+    public static final int MSG_WAITALL = next();
+    public static final int MS_ASYNC = next();
+    public static final int MS_INVALIDATE = next();
+    public static final int MS_SYNC = next();
+    public static final int NI_DGRAM = next();
+    public static final int NI_NAMEREQD = next();
+    public static final int NI_NOFQDN = next();
+    public static final int NI_NUMERICHOST = next();
+    public static final int NI_NUMERICSERV = next();
+    public static final int O_ACCMODE = next();
+    public static final int O_APPEND = next();
+    public static final int O_CREAT = next();
+    public static final int O_EXCL = next();
+    public static final int O_NOCTTY = next();
+    public static final int O_NOFOLLOW = next();
+    public static final int O_NONBLOCK = next();
+    /**
+     * Windows only: opens the file for overlapped I/O, so concurrent positional reads and
+     * writes don't serialize on the file pointer. Such descriptors support only pread and
+     * pwrite. 0 elsewhere.
+     * @hide
+     */
+    public static final int O_OVERLAPPED = next();
+    public static final int O_RDONLY = next();
+    public static final int O_RDWR = next();
+    public static final int O_SYNC = next();
+    public static final int O_TRUNC = next();
+    public static final int O_WRONLY = next();
+    public static final int POLLERR = next();
+    public static final int POLLHUP = next();
+    public static final int POLLIN = next();
+    public static final int POLLNVAL = next();
+    public static final int POLLOUT = next();
+    public static final int POLLPRI = next();
+    public static final int POLLRDBAND = next();
+    public static final int POLLRDNORM = next();
+    public static final int POLLWRBAND = next();
+    public static final int POLLWRNORM = next();
+    /** @hide */ public static final int POSIX_FADV_DONTNEED = next();
+    /** @hide */ public static final int POSIX_FADV_NOREUSE = next();
+    /** @hide */ public static final int POSIX_FADV_NORMAL = next();
+    /** @hide */ public static final int POSIX_FADV_RANDOM = next();
+    /** @hide */ public static final int POSIX_FADV_SEQUENTIAL = next();
+    /** @hide */ public static final int POSIX_FADV_WILLNEED = next();
+    public static final int PR_GET_DUMPABLE = next();
+    public static final int PR_SET_DUMPABLE = next();
+    public static final int PR_SET_NO_NEW_PRIVS = next();
+    public static final int PROT_EXEC = next();
+    public static final int PROT_NONE = next();
+    public static final int PROT_READ = next();
+    public static final int PROT_WRITE = next();
+    public static final int R_OK = next();
+    public static final int RT_SCOPE_HOST = next();
+    public static final int RT_SCOPE_LINK = next();
+    public static final int RT_SCOPE_NOWHERE = next();
+    public static final int RT_SCOPE_SITE = next();
+    public static final int RT_SCOPE_UNIVERSE = next();
+    public static final int SEEK_CUR = next();
+    public static final int SEEK_END = next();
+    public static final int SEEK_SET = next();
+    public static final int SHUT_RD = next();
+    public static final int SHUT_RDWR = next();
+    public static final int SHUT_WR = next();
+    public static final int SIGABRT = next();
+    public static final int SIGALRM = next();
+    public static final int SIGBUS = next();
+    public static final int SIGCHLD = next();
+    public static final int SIGCONT = next();
+    public static final int SIGFPE = next();
+    public static final int SIGHUP = next();
+    public static final int SIGILL = next();
+    public static final int SIGINT = next();
+    public static final int SIGIO = next();
+    public static final int SIGKILL = next();
+    public static final int SIGPIPE = next();
+    public static final int SIGPROF = next();
+    public static final int SIGPWR = next();
+    public static final int SIGQUIT = next();
+    public static final int SIGRTMAX = next();
+    public static final int SIGRTMIN = next();
+    public static final int SIGSEGV = next();
+    public static final int SIGSTKFLT = next();
+    public static final int SIGSTOP = next();
+    public static final int SIGSYS = next();
+    public static final int SIGTERM = next();
+    public static final int SIGTRAP = next();
+    public static final int SIGTSTP = next();
+    public static final int SIGTTIN = next();
+    public static final int SIGTTOU = next();
+    public static final int SIGURG = next();
+    public static final int SIGUSR1 = next();
+    public static final int SIGUSR2 = next();
+    public static final int SIGVTALRM = next();
+    public static final int SIGWINCH = next();
+    public static final int SIGXCPU = next();
+    public static final int SIGXFSZ = next();
+    public static final int SIOCGIFADDR = next();
+    public static final int SIOCGIFBRDADDR = next();
+    public static final int SIOCGIFDSTADDR = next();
+    public static final int SIOCGIFNETMASK = next();
+    /** @hide */ public static final int SOCK_CLOEXEC = next();
+    public static final int SOCK_DGRAM = next();
+    /** @hide */ public static final int SOCK_NONBLOCK = next();
+    public static final int SOCK_RAW = next();
+    public static final int SOCK_SEQPACKET = next();
+    public static final int SOCK_STREAM = next();
+    public static final int SOL_SOCKET = next();
+    public static final int SO_BINDTODEVICE = next();
+    public static final int SO_BROADCAST = next();
+    public static final int SO_DEBUG = next();
+    public static final int SO_DONTROUTE = next();
+    public static final int SO_ERROR = next();
+    /** @hide */ public static final int SO_INCOMING_CPU = next();
+    public static final int SO_KEEPALIVE = next();
+    public static final int SO_LINGER = next();
+    public static final int SO_OOBINLINE = next();
+    public static final int SO_PASSCRED = next();
+    public static final int SO_PEERCRED = next();
+    public static final int SO_RCVBUF = next();
+    public static final int SO_RCVLOWAT = next();
+    public static final int SO_RCVTIMEO = next();
+    public static final int SO_REUSEADDR = next();
+    /** @hide */ public static final int SO_REUSEPORT = next();
+    public static final int SO_SNDBUF = next();
+    public static final int SO_SNDLOWAT = next();
+    public static final int SO_SNDTIMEO = next();
+    public static final int SO_TYPE = next();
+    public static final int STDERR_FILENO = next();
+    public static final int STDIN_FILENO = next();
+    public static final int STDOUT_FILENO = next();
+    public static final int S_IFBLK = next();
+    public static final int S_IFCHR = next();
+    public static final int S_IFDIR = next();
+    public static final int S_IFIFO = next();
+    public static final int S_IFLNK = next();
+    public static final int S_IFMT = next();
+    public static final int S_IFREG = next();
+    public static final int S_IFSOCK = next();
+    public static final int S_IRGRP = next();
+    public static final int S_IROTH = next();
+    public static final int S_IRUSR = next();
+    public static final int S_IRWXG = next();
+    public static final int S_IRWXO = next();
+    public static final int S_IRWXU = next();
+    public static final int S_ISGID = next();
+    public static final int S_ISUID = next();
+    public static final int S_ISVTX = next();
+    public static final int S_IWGRP = next();
+    public static final int S_IWOTH = next();
+    public static final int S_IWUSR = next();
+    public static final int S_IXGRP = next();
+    public static final int S_IXOTH = next();
+    public static final int S_IXUSR = next();
+    public static final int TCP_NODELAY = next();
+    public static final int WCONTINUED = next();
+    public static final int WEXITED = next();
+    public static final int WNOHANG = next();
+    public static final int WNOWAIT = next();
+    public static final int WSTOPPED = next();
+    public static final int WUNTRACED = next();
+    public static final int W_OK = next();
+    public static final int X_OK = next();
+    public static final int _SC_2_CHAR_TERM = next();
+    public static final int _SC_2_C_BIND = next();
+    public static final int _SC_2_C_DEV = next();
+    public static final int _SC_2_C_VERSION = next();
+    public static final int _SC_2_FORT_DEV = next();
+    public static final int _SC_2_FORT_RUN = next();
+    public static final int _SC_2_LOCALEDEF = next();
+    public static final int _SC_2_SW_DEV = next();
+    public static final int _SC_2_UPE = next();
+    public static final int _SC_2_VERSION = next();
+    public static final int _SC_AIO_LISTIO_MAX = next();
+    public static final int _SC_AIO_MAX = next();
+    public static final int _SC_AIO_PRIO_DELTA_MAX = next();
+    public static final int _SC_ARG_MAX = next();
+    public static final int _SC_ASYNCHRONOUS_IO = next();
+    public static final int _SC_ATEXIT_MAX = next();
+    public static final int _SC_AVPHYS_PAGES = next();
+    public static final int _SC_BC_BASE_MAX = next();
+    public static final int _SC_BC_DIM_MAX = next();
+    public static final int _SC_BC_SCALE_MAX = next();
+    public static final int _SC_BC_STRING_MAX = next();
+    public static final int _SC_CHILD_MAX = next();
+    public static final int _SC_CLK_TCK = next();
+    public static final int _SC_COLL_WEIGHTS_MAX = next();
+    public static final int _SC_DELAYTIMER_MAX = next();
+    public static final int _SC_EXPR_NEST_MAX = next();
+    public static final int _SC_FSYNC = next();
+    public static final int _SC_GETGR_R_SIZE_MAX = next();
+    public static final int _SC_GETPW_R_SIZE_MAX = next();
+    public static final int _SC_IOV_MAX = next();
+    public static final int _SC_JOB_CONTROL = next();
+    public static final int _SC_LINE_MAX = next();
+    public static final int _SC_LOGIN_NAME_MAX = next();
+    public static final int _SC_MAPPED_FILES = next();
+    public static final int _SC_MEMLOCK = next();
+    public static final int _SC_MEMLOCK_RANGE = next();
+    public static final int _SC_MEMORY_PROTECTION = next();
+    public static final int _SC_MESSAGE_PASSING = next();
+    public static final int _SC_MQ_OPEN_MAX = next();
+    public static final int _SC_MQ_PRIO_MAX = next();
+    public static final int _SC_NGROUPS_MAX = next();
+    public static final int _SC_NPROCESSORS_CONF = next();
+    public static final int _SC_NPROCESSORS_ONLN = next();
+    public static final int _SC_OPEN_MAX = next();
+    public static final int _SC_PAGESIZE = next();
+    public static final int _SC_PAGE_SIZE = next();
+    public static final int _SC_PASS_MAX = next();
+    public static final int _SC_PHYS_PAGES = next();
+    public static final int _SC_PRIORITIZED_IO = next();
+    public static final int _SC_PRIORITY_SCHEDULING = next();
+    public static final int _SC_REALTIME_SIGNALS = next();
+    public static final int _SC_RE_DUP_MAX = next();
+    public static final int _SC_RTSIG_MAX = next();
+    public static final int _SC_SAVED_IDS = next();
+    public static final int _SC_SEMAPHORES = next();
+    public static final int _SC_SEM_NSEMS_MAX = next();
+    public static final int _SC_SEM_VALUE_MAX = next();
+    public static final int _SC_SHARED_MEMORY_OBJECTS = next();
+    public static final int _SC_SIGQUEUE_MAX = next();
+    public static final int _SC_STREAM_MAX = next();
+    public static final int _SC_SYNCHRONIZED_IO = next();
+    public static final int _SC_THREADS = next();
+    public static final int _SC_THREAD_ATTR_STACKADDR = next();
+    public static final int _SC_THREAD_ATTR_STACKSIZE = next();
+    public static final int _SC_THREAD_DESTRUCTOR_ITERATIONS = next();
+    public static final int _SC_THREAD_KEYS_MAX = next();
+    public static final int _SC_THREAD_PRIORITY_SCHEDULING = next();
+    public static final int _SC_THREAD_PRIO_INHERIT = next();
+    public static final int _SC_THREAD_PRIO_PROTECT = next();
+    public static final int _SC_THREAD_SAFE_FUNCTIONS = next();
+    public static final int _SC_THREAD_STACK_MIN = next();
+    public static final int _SC_THREAD_THREADS_MAX = next();
+    public static final int _SC_TIMERS = next();
+    public static final int _SC_TIMER_MAX = next();
+    public static final int _SC_TTY_NAME_MAX = next();
+    public static final int _SC_TZNAME_MAX = next();
+    public static final int _SC_VERSION = next();
+    public static final int _SC_XBS5_ILP32_OFF32 = next();
+    public static final int _SC_XBS5_ILP32_OFFBIG = next();
+    public static final int _SC_XBS5_LP64_OFF64 = next();
+    public static final int _SC_XBS5_LPBIG_OFFBIG = next();
+    public static final int _SC_XOPEN_CRYPT = next();
+    public static final int _SC_XOPEN_ENH_I18N = next();
+    public static final int _SC_XOPEN_LEGACY = next();
+    public static final int _SC_XOPEN_REALTIME = next();
+    public static final int _SC_XOPEN_REALTIME_THREADS = next();
+    public static final int _SC_XOPEN_SHM = next();
+    public static final int _SC_XOPEN_UNIX = next();
+    public static final int _SC_XOPEN_VERSION = next();
+    public static final int _SC_XOPEN_XCU_VERSION = next();
 
     /**
      * Returns the string name of a getaddrinfo(3) error value.
@@ -840,12 +871,19 @@ public final class OsConstants {
         return null;
     }
 
-    private static native void initConstants();
+    private static int next() {
+        return VALUES[nextValue++];
+    }
 
-    // A hack to avoid these constants being inlined by javac...
-    private static int placeholder() { return 0; }
-    // ...because we want to initialize them at runtime.
     static {
-        initConstants();
+        if (nextValue != VALUES.length) {
+            throw new AssertionError("OsConstants has " + nextValue + " fields but native code has " +
+                                     VALUES.length + " values");
+        }
     }
+
+    static native int[] values();
+
+    // Returns the names of the values, so tests can check they line up with the fields.
+    static native String[] names();
 }
@@ -426,6 +426,21 @@ public class File implements Serializable, Comparable<File> {
 
     private static native String canonicalizePath(String path);
 
+    /**
+     * Sets whether getCanonicalPath may cache how the components of the paths it resolves
+     * resolved, which saves an lstat(2) per component. The cache watches the directories
+     * involved with inotify(7), and is discarded whenever any of them change. It's off by
+     * default because each watched directory counts against the per-user inotify limit.
+     * Turning it off discards all cached state. This has no effect on systems without inotify.
+     *
+     * @hide
+     */
+    public static void setCanonicalPathCacheEnabled(boolean enabled) {
+        setCanonicalPathCacheEnabledImpl(enabled);
+    }
+
+    private static native void setCanonicalPathCacheEnabledImpl(boolean enabled);
+
     /**
      * Returns a new file created using the canonical path of this file.
      * Equivalent to {@code new File(this.getCanonicalPath())}.
@@ -758,6 +773,26 @@ public class File implements Serializable, Comparable<File> {
 
     private static native String[] listImpl(String path);
 
+    /**
+     * Like {@link #list}, but also describes each entry without a separate {@code stat} call from
+     * Java. On return {@code attributes[0]} holds three longs per returned name, in the same
+     * order: its {@code st_mode} file type bits (test them with {@code OsConstants.S_ISDIR} and
+     * friends), its length, and its last-modified time in milliseconds. Symbolic links are
+     * followed. If {@code statEntries} is false, the type comes from the directory itself where
+     * the file system records it, and the length and time are -1; this usually needs no extra
+     * system calls at all. An entry that can't be described has type 0.
+     *
+     * @hide internal use only
+     */
+    public String[] listWithAttributes$(long[][] attributes, boolean statEntries) {
+        if (attributes.length < 1) {
+            throw new IllegalArgumentException("attributes.length < 1");
+        }
+        return listAttributesImpl(path, attributes, statEntries);
+    }
+
+    private static native String[] listAttributesImpl(String path, long[][] attributes, boolean statEntries);
+
     /**
      * Gets a list of the files in the directory represented by this file. This
      * list is then filtered through a FilenameFilter and the names of files
@@ -477,6 +477,7 @@ public class ObjectStreamClass implements Serializable {
             }
 
             // Dump them
+            String[] fieldSignatures = getFieldSignatures(fields);
             for (int i = 0; i < fields.length; i++) {
                 Field field = fields[i];
                 int modifiers = field.getModifiers() & FIELD_MODIFIERS_MASK;
@@ -488,7 +489,7 @@ public class ObjectStreamClass implements Serializable {
                     // static and private transient
                     output.writeUTF(field.getName());
                     output.writeInt(modifiers);
-                    output.writeUTF(descriptorForFieldSignature(getFieldSignature(field)));
+                    output.writeUTF(descriptorForFieldSignature(fieldSignatures[i]));
                 }
             }
 
@@ -504,29 +505,22 @@ public class ObjectStreamClass implements Serializable {
                 output.writeUTF(CLINIT_SIGNATURE);
             }
 
-            // Constructor information
+            // Constructor information. All constructors have the same name, so
+            // they sort by signature alone. The signatures are fetched in bulk
+            // up front, rather than once per comparison.
             Constructor<?>[] constructors = cl.getDeclaredConstructors();
-            if (constructors.length > 1) {
-                // Only attempt to sort if really needed (saves object creation,
-                // etc)
-                Comparator<Constructor<?>> constructorComparator = new Comparator<Constructor<?>>() {
-                    public int compare(Constructor<?> ctr1, Constructor<?> ctr2) {
-                        // All constructors have same name, so we sort based on
-                        // signature
-                        return (getConstructorSignature(ctr1)
-                                .compareTo(getConstructorSignature(ctr2)));
-                    }
-                };
-                Arrays.sort(constructors, constructorComparator);
+            String[] constructorSignatures = getConstructorSignatures(constructors);
+            MemberDescriptor[] constructorDescriptors = new MemberDescriptor[constructors.length];
+            for (int i = 0; i < constructors.length; i++) {
+                constructorDescriptors[i] = new MemberDescriptor("<init>",
+                        constructors[i].getModifiers() & METHOD_MODIFIERS_MASK,
+                        constructorSignatures[i]);
             }
+            Arrays.sort(constructorDescriptors);
 
             // Dump them
-            for (int i = 0; i < constructors.length; i++) {
-                Constructor<?> constructor = constructors[i];
-                int modifiers = constructor.getModifiers()
-                        & METHOD_MODIFIERS_MASK;
-                boolean isPrivate = Modifier.isPrivate(modifiers);
-                if (!isPrivate) {
+            for (MemberDescriptor constructor : constructorDescriptors) {
+                if (!Modifier.isPrivate(constructor.modifiers)) {
                     /*
                      * write name, modifier & "descriptor" of all but private
                      * ones
@@ -534,44 +528,31 @@ public class ObjectStreamClass implements Serializable {
                      * constructor.getName() returns the constructor name as
                      * typed, not the VM name
                      */
-                    output.writeUTF("<init>");
-                    output.writeInt(modifiers);
-                    output.writeUTF(descriptorForSignature(
-                            getConstructorSignature(constructor)).replace('/',
-                            '.'));
+                    output.writeUTF(constructor.name);
+                    output.writeInt(constructor.modifiers);
+                    output.writeUTF(descriptorForSignature(constructor.signature).replace('/', '.'));
                 }
             }
 
             // Method information
             Method[] methods = cl.getDeclaredMethods();
-            if (methods.length > 1) {
-                Comparator<Method> methodComparator = new Comparator<Method>() {
-                    public int compare(Method m1, Method m2) {
-                        int result = m1.getName().compareTo(m2.getName());
-                        if (result == 0) {
-                            // same name, signature will tell which one comes
-                            // first
-                            return getMethodSignature(m1).compareTo(
-                                    getMethodSignature(m2));
-                        }
-                        return result;
-                    }
-                };
-                Arrays.sort(methods, methodComparator);
+            String[] methodSignatures = getMethodSignatures(methods);
+            MemberDescriptor[] methodDescriptors = new MemberDescriptor[methods.length];
+            for (int i = 0; i < methods.length; i++) {
+                methodDescriptors[i] = new MemberDescriptor(methods[i].getName(),
+                        methods[i].getModifiers() & METHOD_MODIFIERS_MASK,
+                        methodSignatures[i]);
             }
+            Arrays.sort(methodDescriptors);
 
             // Dump them
-            for (int i = 0; i < methods.length; i++) {
-                Method method = methods[i];
-                int modifiers = method.getModifiers() & METHOD_MODIFIERS_MASK;
-                boolean isPrivate = Modifier.isPrivate(modifiers);
-                if (!isPrivate) {
+            for (MemberDescriptor method : methodDescriptors) {
+                if (!Modifier.isPrivate(method.modifiers)) {
                     // write name, modifier & "descriptor" of all but private
                     // ones
-                    output.writeUTF(method.getName());
-                    output.writeInt(modifiers);
-                    output.writeUTF(descriptorForSignature(
-                            getMethodSignature(method)).replace('/', '.'));
+                    output.writeUTF(method.name);
+                    output.writeInt(method.modifiers);
+                    output.writeUTF(descriptorForSignature(method.signature).replace('/', '.'));
                 }
             }
         } catch (IOException e) {
@@ -583,6 +564,27 @@ public class ObjectStreamClass implements Serializable {
         return Memory.peekLong(hash, 0, ByteOrder.LITTLE_ENDIAN);
     }
 
+    /**
+     * The name, masked modifiers and signature of a constructor or method, in
+     * the order the SUID computation writes them: by name, then by signature.
+     */
+    private static final class MemberDescriptor implements Comparable<MemberDescriptor> {
+        final String name;
+        final int modifiers;
+        final String signature;
+
+        MemberDescriptor(String name, int modifiers, String signature) {
+            this.name = name;
+            this.modifiers = modifiers;
+            this.signature = signature;
+        }
+
+        public int compareTo(MemberDescriptor other) {
+            int result = name.compareTo(other.name);
+            return (result != 0) ? result : signature.compareTo(other.signature);
+        }
+    }
+
     /**
      * Returns what the serialization specification calls "descriptor" given a
      * field signature.
@@ -756,6 +758,12 @@ public class ObjectStreamClass implements Serializable {
      */
     static native String getConstructorSignature(Constructor<?> c);
 
+    /**
+     * Returns the signatures of all of {@code constructors}, in order, resolved
+     * in a single native call.
+     */
+    static native String[] getConstructorSignatures(Constructor<?>[] constructors);
+
     /**
      * Gets a field descriptor of the class represented by this class
      * descriptor.
@@ -872,6 +880,12 @@ public class ObjectStreamClass implements Serializable {
      */
     private static native String getFieldSignature(Field f);
 
+    /**
+     * Returns the signatures of all of {@code fields}, in order, resolved in a
+     * single native call.
+     */
+    private static native String[] getFieldSignatures(Field[] fields);
+
     /**
      * Returns the flags for this descriptor, where possible combined values are
      *
@@ -894,6 +908,12 @@ public class ObjectStreamClass implements Serializable {
      */
     static native String getMethodSignature(Method m);
 
+    /**
+     * Returns the signatures of all of {@code methods}, in order, resolved in a
+     * single native call.
+     */
+    static native String[] getMethodSignatures(Method[] methods);
+
     /**
      * Returns the name of the class represented by this descriptor.
      *
@@ -2508,6 +2508,9 @@ public final class Character implements Serializable, Comparable<Character> {
      * @return the Unicode category of {@code codePoint}.
      */
     public static int getType(int codePoint) {
+        if (codePoint >= 0 && codePoint < MIN_SUPPLEMENTARY_CODE_POINT) {
+            return TypeTable.get(codePoint);
+        }
         int type = getTypeImpl(codePoint);
         // The type values returned by ICU are not RI-compatible. The RI skips the value 17.
         if (type <= Character.FORMAT) {
@@ -2518,6 +2521,55 @@ public final class Character implements Serializable, Comparable<Character> {
 
     private static native int getTypeImpl(int codePoint);
 
+    /**
+     * Stores the general category of each code point in {@code chars[offset..offset+count)} in
+     * the corresponding element of {@code types}, starting at {@code typesOffset}. Both halves of
+     * a surrogate pair get the category of the supplementary code point they encode; an unpaired
+     * surrogate gets {@link #SURROGATE}. This is much faster than calling {@link #getType} for
+     * each char.
+     *
+     * @hide
+     */
+    public static void getTypes(char[] chars, int offset, int count, byte[] types, int typesOffset) {
+        Arrays.checkOffsetAndCount(chars.length, offset, count);
+        Arrays.checkOffsetAndCount(types.length, typesOffset, count);
+        int end = offset + count;
+        for (int i = offset; i < end; ++i) {
+            char ch = chars[i];
+            if (isHighSurrogate(ch) && i + 1 < end && isLowSurrogate(chars[i + 1])) {
+                byte type = (byte) getType(toCodePoint(ch, chars[i + 1]));
+                types[typesOffset++] = type;
+                types[typesOffset++] = type;
+                ++i;
+            } else {
+                types[typesOffset++] = (byte) TypeTable.get(ch);
+            }
+        }
+    }
+
+    /**
+     * The general category of every BMP code point, built from ICU's data the first time it's
+     * needed so that {@code getType} and the predicates that depend only on the category don't
+     * make a JNI call per char. The BMP is split into blocks of 64 chars, and {@code INDEX} gives
+     * the offset in {@code TYPES} of each block, identical blocks being stored once. That's about
+     * 15KiB rather than 64KiB.
+     */
+    private static final class TypeTable {
+        private static final int BLOCK_SHIFT = 6;
+        private static final int BLOCK_MASK = (1 << BLOCK_SHIFT) - 1;
+        private static final char[] INDEX = new char[MIN_SUPPLEMENTARY_CODE_POINT >> BLOCK_SHIFT];
+        private static final byte[] TYPES = getTypeTableImpl(INDEX, 1 << BLOCK_SHIFT);
+
+        static int get(int ch) {
+            return TYPES[INDEX[ch >> BLOCK_SHIFT] + (ch & BLOCK_MASK)];
+        }
+    }
+
+    private static native byte[] getTypeTableImpl(char[] index, int blockSize);
+
+    private static final int LETTER_TYPES = (1 << UPPERCASE_LETTER) | (1 << LOWERCASE_LETTER) |
+            (1 << TITLECASE_LETTER) | (1 << MODIFIER_LETTER) | (1 << OTHER_LETTER);
+
     /**
      * Gets the Unicode directionality of the specified character.
      *
@@ -2674,6 +2726,9 @@ public final class Character implements Serializable, Comparable<Character> {
         if (codePoint < 1632) {
             return false;
         }
+        if (codePoint < MIN_SUPPLEMENTARY_CODE_POINT) {
+            return TypeTable.get(codePoint) == DECIMAL_DIGIT_NUMBER;
+        }
         return isDigitImpl(codePoint);
     }
 
@@ -2868,6 +2923,9 @@ public final class Character implements Serializable, Comparable<Character> {
         if (codePoint < 128) {
             return false;
         }
+        if (codePoint < MIN_SUPPLEMENTARY_CODE_POINT) {
+            return ((1 << TypeTable.get(codePoint)) & LETTER_TYPES) != 0;
+        }
         return isLetterImpl(codePoint);
     }
 
@@ -2904,6 +2962,10 @@ public final class Character implements Serializable, Comparable<Character> {
         if (codePoint < 128) {
             return false;
         }
+        if (codePoint < MIN_SUPPLEMENTARY_CODE_POINT) {
+            int type = TypeTable.get(codePoint);
+            return type == DECIMAL_DIGIT_NUMBER || ((1 << type) & LETTER_TYPES) != 0;
+        }
         return isLetterOrDigitImpl(codePoint);
     }
 
@@ -2937,6 +2999,9 @@ public final class Character implements Serializable, Comparable<Character> {
         if (codePoint < 128) {
             return false;
         }
+        if (codePoint < MIN_SUPPLEMENTARY_CODE_POINT) {
+            return TypeTable.get(codePoint) == LOWERCASE_LETTER;
+        }
         return isLowerCaseImpl(codePoint);
     }
 
@@ -3013,6 +3078,9 @@ public final class Character implements Serializable, Comparable<Character> {
      *         {@code false} otherwise.
      */
     public static boolean isTitleCase(int codePoint) {
+        if (codePoint >= 0 && codePoint < MIN_SUPPLEMENTARY_CODE_POINT) {
+            return TypeTable.get(codePoint) == TITLECASE_LETTER;
+        }
         return isTitleCaseImpl(codePoint);
     }
 
@@ -3102,6 +3170,9 @@ public final class Character implements Serializable, Comparable<Character> {
         if (codePoint < 128) {
             return false;
         }
+        if (codePoint < MIN_SUPPLEMENTARY_CODE_POINT) {
+            return TypeTable.get(codePoint) == UPPERCASE_LETTER;
+        }
         return isUpperCaseImpl(codePoint);
     }
 
@@ -301,6 +301,46 @@ public final class Double extends Number implements Comparable<Double> {
         return StringToReal.parseDouble(string);
     }
 
+    /**
+     * Parses the {@code delimiter}-separated doubles in {@code src[offset..offset+length)} into
+     * {@code dst} starting at {@code dstOffset}, crossing into native code once for the whole
+     * region. Each value may have surrounding white space, and accepts the syntax of
+     * {@link #parseDouble} except hexadecimal. An empty region holds no values.
+     *
+     * @return the number of values parsed.
+     * @throws NumberFormatException if any value is not a double.
+     * @throws ArrayIndexOutOfBoundsException if {@code dst} is too small.
+     * @hide
+     */
+    public static int parseDoubles(byte[] src, int offset, int length, byte delimiter,
+            double[] dst, int dstOffset) {
+        return StringToReal.parseDoubles(src, offset, length, delimiter, dst, dstOffset);
+    }
+
+    /**
+     * Like {@link #parseDoubles(byte[], int, int, byte, double[], int)}, but for chars.
+     *
+     * @hide
+     */
+    public static int parseDoubles(char[] src, int offset, int length, char delimiter,
+            double[] dst, int dstOffset) {
+        return StringToReal.parseDoubles(src, offset, length, delimiter, dst, dstOffset);
+    }
+
+    /**
+     * Writes {@code count} doubles from {@code src} starting at {@code srcOffset} to {@code dst}
+     * as ASCII, exactly as {@link #toString(double)} would format them, separated by
+     * {@code delimiter}. Each value takes at most 24 bytes.
+     *
+     * @return the number of bytes written.
+     * @throws ArrayIndexOutOfBoundsException if {@code dst} is too small.
+     * @hide
+     */
+    public static int formatDoubles(double[] src, int srcOffset, int count, byte[] dst,
+            int dstOffset, byte delimiter) {
+        return RealToString.formatDoubles(src, srcOffset, count, dst, dstOffset, delimiter);
+    }
+
     @Override
     public short shortValue() {
         return (short) value;
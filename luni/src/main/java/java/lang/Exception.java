@@ -70,4 +70,18 @@ public class Exception extends Throwable {
     public Exception(Throwable throwable) {
         super(throwable);
     }
+
+    /**
+     * Constructs a new {@code Exception} with the current stack trace, the
+     * specified detail message and the specified cause.
+     *
+     * @param enableSuppression if false, throwables passed to {@link
+     * #addSuppressed(Throwable)} will be silently discarded.
+     * @param writableStackTrace if false, this {@code Exception} will not be
+     * filled in with a stack trace.
+     * @since 1.7
+     */
+    protected Exception(String detailMessage, Throwable throwable, boolean enableSuppression, boolean writableStackTrace) {
+        super(detailMessage, throwable, enableSuppression, writableStackTrace);
+    }
 }
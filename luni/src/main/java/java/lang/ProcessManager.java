@@ -51,7 +51,18 @@ final class ProcessManager {
     /** Keeps track of garbage-collected Processes. */
     private final ProcessReferenceQueue referenceQueue = new ProcessReferenceQueue();
 
+    /**
+     * Set this system property to "true" to start children from a small helper process forked
+     * once, rather than from the VM itself. Useful for apps that run many short-lived commands.
+     */
+    private static final String LAUNCHER_PROPERTY = "java.lang.ProcessManager.launcher";
+
     private ProcessManager() {
+        if (Boolean.parseBoolean(System.getProperty(LAUNCHER_PROPERTY))) {
+            // If the launcher doesn't start, exec just starts children itself.
+            startLauncher();
+        }
+
         // Spawn a thread to listen for signals from child processes.
         Thread reaperThread = new Thread(ProcessManager.class.getName()) {
             @Override public void run() {
@@ -153,6 +164,12 @@ final class ProcessManager {
         }
     }
 
+    /**
+     * Forks the helper process that exec will use from now on, unless it's already running.
+     * Returns its pid, or -1 if it couldn't be started or isn't supported on this platform.
+     */
+    private static native int startLauncher();
+
     /**
      * Executes a native process. Fills in in, out, and err and returns the
      * new process ID upon success.
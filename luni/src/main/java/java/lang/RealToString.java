@@ -17,7 +17,7 @@
 
 package java.lang;
 
-import libcore.math.MathUtils;
+import java.util.Arrays;
 
 final class RealToString {
     private static final ThreadLocal<RealToString> INSTANCE = new ThreadLocal<RealToString>() {
@@ -26,12 +26,10 @@ final class RealToString {
         }
     };
 
-    private static final double invLogOfTenBaseTwo = Math.log(2.0) / Math.log(10.0);
-
     private int firstK;
 
     /**
-     * An array of decimal digits, filled by longDigitGenerator or bigIntDigitGenerator.
+     * An array of decimal digits, filled by shortestDigits.
      */
     private final int[] digits = new int[64];
 
@@ -91,14 +89,8 @@ final class RealToString {
 
         int p = Double.EXPONENT_BIAS + Double.MANTISSA_BITS; // the power offset (precision)
         int pow;
-        int numBits = Double.MANTISSA_BITS;
         if (e == 0) {
             pow = 1 - p; // a denormalized number
-            long ff = f;
-            while ((ff & 0x0010000000000000L) == 0) {
-                ff = ff << 1;
-                numBits--;
-            }
         } else {
             // 0 < e < 2047
             // a "normalized" number
@@ -106,12 +98,8 @@ final class RealToString {
             pow = e - p;
         }
 
-        firstK = digitCount = 0;
-        if (-59 < pow && pow < 6 || (pow == -59 && !mantissaIsZero)) {
-            longDigitGenerator(f, pow, e == 0, mantissaIsZero, numBits);
-        } else {
-            bigIntDigitGenerator(f, pow, e == 0, numBits);
-        }
+        // The gap below a power of two is half the gap above, except at the bottom of the range.
+        unpackDigits(shortestDigits(f, pow, !mantissaIsZero || e <= 1, digits));
         AbstractStringBuilder dst = (sb != null) ? sb : new StringBuilder(26);
         if (inputNumber >= 1e7D || inputNumber <= -1e7D
                 || (inputNumber > -1e-3D && inputNumber < 1e-3D)) {
@@ -122,6 +110,13 @@ final class RealToString {
         return (sb != null) ? null : dst.toString();
     }
 
+    public static int formatDoubles(double[] src, int srcOffset, int count, byte[] dst,
+            int dstOffset, byte delimiter) {
+        Arrays.checkOffsetAndCount(src.length, srcOffset, count);
+        Arrays.checkOffsetAndCount(dst.length, dstOffset, 0);
+        return formatDoublesImpl(src, srcOffset, count, dst, dstOffset, delimiter);
+    }
+
     public String floatToString(float f) {
         return convertFloat(null, f);
     }
@@ -153,18 +148,12 @@ final class RealToString {
 
         int p = Float.EXPONENT_BIAS + Float.MANTISSA_BITS; // the power offset (precision)
         int pow;
-        int numBits = Float.MANTISSA_BITS;
         if (e == 0) {
             pow = 1 - p; // a denormalized number
             if (f < 8) { // want more precision with smallest values
                 f = f << 2;
                 pow -= 2;
             }
-            int ff = f;
-            while ((ff & 0x00800000) == 0) {
-                ff = ff << 1;
-                numBits--;
-            }
         } else {
             // 0 < e < 255
             // a "normalized" number
@@ -172,12 +161,7 @@ final class RealToString {
             pow = e - p;
         }
 
-        firstK = digitCount = 0;
-        if (-59 < pow && pow < 35 || (pow == -59 && !mantissaIsZero)) {
-            longDigitGenerator(f, pow, e == 0, mantissaIsZero, numBits);
-        } else {
-            bigIntDigitGenerator(f, pow, e == 0, numBits);
-        }
+        unpackDigits(shortestDigits(f, pow, !mantissaIsZero || e <= 1, digits));
         AbstractStringBuilder dst = (sb != null) ? sb : new StringBuilder(26);
         if (inputNumber >= 1e7f || inputNumber <= -1e7f
                 || (inputNumber > -1e-3f && inputNumber < 1e-3f)) {
@@ -241,80 +225,19 @@ final class RealToString {
         } while (U != -1 || k >= -1);
     }
 
-    private native void bigIntDigitGenerator(long f, int e, boolean isDenormalized, int p);
-
-    private void longDigitGenerator(long f, int e, boolean isDenormalized,
-            boolean mantissaIsZero, int p) {
-        long R, S, M;
-        if (e >= 0) {
-            M = 1l << e;
-            if (!mantissaIsZero) {
-                R = f << (e + 1);
-                S = 2;
-            } else {
-                R = f << (e + 2);
-                S = 4;
-            }
-        } else {
-            M = 1;
-            if (isDenormalized || !mantissaIsZero) {
-                R = f << 1;
-                S = 1l << (1 - e);
-            } else {
-                R = f << 2;
-                S = 1l << (2 - e);
-            }
-        }
-
-        int k = (int) Math.ceil((e + p - 1) * invLogOfTenBaseTwo - 1e-10);
-
-        if (k > 0) {
-            S = S * MathUtils.LONG_POWERS_OF_TEN[k];
-        } else if (k < 0) {
-            long scale = MathUtils.LONG_POWERS_OF_TEN[-k];
-            R = R * scale;
-            M = M == 1 ? scale : M * scale;
-        }
-
-        if (R + M > S) { // was M_plus
-            firstK = k;
-        } else {
-            firstK = k - 1;
-            R = R * 10;
-            M = M * 10;
-        }
-
-        boolean low, high;
-        int U;
-        while (true) {
-            // Set U to floor(R/S) and R to the remainder, using *unsigned* 64-bit division
-            U = 0;
-            for (int i = 3; i >= 0; i--) {
-                long remainder = R - (S << i);
-                if (remainder >= 0) {
-                    R = remainder;
-                    U += 1 << i;
-                }
-            }
+    private void unpackDigits(int packed) {
+        firstK = packed >> 8;
+        digitCount = packed & 0xff;
+    }
 
-            low = R < M; // was M_minus
-            high = R + M > S; // was M_plus
+    /**
+     * Writes the shortest decimal digits that uniquely identify f * 2^e to 'digits', choosing the
+     * closest such digits to the exact value. 'symmetric' is false if the next value down is
+     * nearer than the next value up. Returns the power of ten of the first digit shifted left by
+     * 8, or'ed with the number of digits.
+     */
+    private static native int formatDoublesImpl(double[] src, int srcOffset, int count,
+            byte[] dst, int dstOffset, byte delimiter);
 
-            if (low || high) {
-                break;
-            }
-            R = R * 10;
-            M = M * 10;
-            digits[digitCount++] = U;
-        }
-        if (low && !high) {
-            digits[digitCount++] = U;
-        } else if (high && !low) {
-            digits[digitCount++] = U + 1;
-        } else if ((R << 1) < S) {
-            digits[digitCount++] = U;
-        } else {
-            digits[digitCount++] = U + 1;
-        }
-    }
+    private static native int shortestDigits(long f, int e, boolean symmetric, int[] digits);
 }
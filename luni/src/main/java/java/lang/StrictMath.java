@@ -30,6 +30,8 @@
 
 package java.lang;
 
+import java.util.Arrays;
+
 /**
  * Class StrictMath provides basic math constants and operations such as
  * trigonometric functions, hyperbolic functions, exponential, logarithms, etc.
@@ -2541,6 +2543,74 @@ public final class StrictMath {
         return 0;
     }
 
+    /**
+     * Stores {@code StrictMath.sin(in[i])} in {@code out[i]} for each {@code i} in
+     * {@code [offset, offset + length)}. {@code in} and {@code out} may be the same array.
+     * This is equivalent to, but much cheaper than, calling {@link #sin(double)} in a loop.
+     *
+     * @throws ArrayIndexOutOfBoundsException if the range is out of bounds for either array.
+     * @hide
+     */
+    public static void sin(double[] in, double[] out, int offset, int length) {
+        checkArrays(in, out, offset, length);
+        sinArray(in, out, offset, length);
+    }
+
+    /**
+     * Like {@link #sin(double[], double[], int, int)}, but for {@link #cos(double)}.
+     *
+     * @hide
+     */
+    public static void cos(double[] in, double[] out, int offset, int length) {
+        checkArrays(in, out, offset, length);
+        cosArray(in, out, offset, length);
+    }
+
+    /**
+     * Like {@link #sin(double[], double[], int, int)}, but for {@link #tan(double)}.
+     *
+     * @hide
+     */
+    public static void tan(double[] in, double[] out, int offset, int length) {
+        checkArrays(in, out, offset, length);
+        tanArray(in, out, offset, length);
+    }
+
+    /**
+     * Like {@link #sin(double[], double[], int, int)}, but for {@link #sqrt(double)}.
+     *
+     * @hide
+     */
+    public static void sqrt(double[] in, double[] out, int offset, int length) {
+        checkArrays(in, out, offset, length);
+        sqrtArray(in, out, offset, length);
+    }
+
+    /**
+     * Stores {@code StrictMath.pow(x[i], y[i])} in {@code out[i]} for each {@code i} in
+     * {@code [offset, offset + length)}. {@code out} may be the same array as {@code x} or
+     * {@code y}.
+     *
+     * @throws ArrayIndexOutOfBoundsException if the range is out of bounds for any array.
+     * @hide
+     */
+    public static void pow(double[] x, double[] y, double[] out, int offset, int length) {
+        checkArrays(x, out, offset, length);
+        Arrays.checkOffsetAndCount(y.length, offset, length);
+        powArray(x, y, out, offset, length);
+    }
+
+    private static void checkArrays(double[] in, double[] out, int offset, int length) {
+        Arrays.checkOffsetAndCount(in.length, offset, length);
+        Arrays.checkOffsetAndCount(out.length, offset, length);
+    }
+
+    private static native void sinArray(double[] in, double[] out, int offset, int length);
+    private static native void cosArray(double[] in, double[] out, int offset, int length);
+    private static native void tanArray(double[] in, double[] out, int offset, int length);
+    private static native void sqrtArray(double[] in, double[] out, int offset, int length);
+    private static native void powArray(double[] x, double[] y, double[] out, int offset, int length);
+
     // Shifts long bits as double, if the digits is positive, left-shift; if
     // not, shift to right and calculate its carry.
     private static long shiftLongBits(long bits, long digits) {
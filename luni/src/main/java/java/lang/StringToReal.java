@@ -17,6 +17,8 @@
 
 package java.lang;
 
+import java.util.Arrays;
+
 /**
  * Used to parse a string and return either a single or double precision
  * floating point number.
@@ -59,6 +61,12 @@ final class StringToReal {
      */
     private static native float parseFltImpl(String s, int e);
 
+    private static native int parseDoublesFromBytes(byte[] src, int offset, int length,
+            byte delimiter, double[] dst, int dstOffset);
+
+    private static native int parseDoublesFromChars(char[] src, int offset, int length,
+            char delimiter, double[] dst, int dstOffset);
+
     private static NumberFormatException invalidReal(String s, boolean isDouble) {
         throw new NumberFormatException("Invalid " + (isDouble ? "double" : "float") + ": \"" + s + "\"");
     }
@@ -290,6 +298,20 @@ final class StringToReal {
         return info.negative ? -result : result;
     }
 
+    public static int parseDoubles(byte[] src, int offset, int length, byte delimiter,
+            double[] dst, int dstOffset) {
+        Arrays.checkOffsetAndCount(src.length, offset, length);
+        Arrays.checkOffsetAndCount(dst.length, dstOffset, 0);
+        return parseDoublesFromBytes(src, offset, length, delimiter, dst, dstOffset);
+    }
+
+    public static int parseDoubles(char[] src, int offset, int length, char delimiter,
+            double[] dst, int dstOffset) {
+        Arrays.checkOffsetAndCount(src.length, offset, length);
+        Arrays.checkOffsetAndCount(dst.length, dstOffset, 0);
+        return parseDoublesFromChars(src, offset, length, delimiter, dst, dstOffset);
+    }
+
     /**
      * Returns the closest float value to the real number in the string.
      *
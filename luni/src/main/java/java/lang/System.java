@@ -624,6 +624,42 @@ public final class System {
      */
     public static native long nanoTime();
 
+    /**
+     * Like {@link #currentTimeMillis}, but cheaper and only as precise as the kernel's
+     * scheduler tick (typically between 1ms and 10ms). Equivalent to Linux's
+     * {@code CLOCK_REALTIME_COARSE}, where available.
+     *
+     * @hide
+     */
+    public static native long coarseCurrentTimeMillis();
+
+    /**
+     * Like {@link #nanoTime}, but cheaper and only as precise as the kernel's scheduler tick
+     * (typically between 1ms and 10ms). Equivalent to Linux's {@code CLOCK_MONOTONIC_COARSE},
+     * where available.
+     *
+     * @hide
+     */
+    public static native long coarseNanoTime();
+
+    /**
+     * Returns the CPU's cycle counter, which costs a few nanoseconds to read. This is for
+     * profiling short stretches of code on one thread: the counter may not be synchronized
+     * between CPUs, and on older x86 CPUs its rate changes with the clock speed. Divide
+     * differences by {@link #cycleCounterFrequency} to get seconds.
+     *
+     * @hide
+     */
+    public static native long cycleCounter();
+
+    /**
+     * Returns the number of {@link #cycleCounter} ticks per second. On x86 this is calibrated
+     * against {@link #nanoTime} the first time it's called, which takes about 10ms.
+     *
+     * @hide
+     */
+    public static native long cycleCounterFrequency();
+
     /**
      * Causes the VM to stop running and the program to exit with the given exit status.
      * If {@link #runFinalizersOnExit(boolean)} has been previously invoked with a
@@ -1014,6 +1050,24 @@ public final class System {
 
     private static native void log(char type, String message, Throwable th);
 
+    /**
+     * Sets whether {@link #logI} and friends hand messages to a background thread rather than
+     * writing them to the log before returning. Messages with a {@code Throwable}, fatal
+     * messages, and messages too long for the queue are still logged synchronously. When the
+     * queue is full, messages are dropped rather than waited for; see
+     * {@link #droppedLogMessageCount}.
+     *
+     * @hide internal use only
+     */
+    public static native void setAsynchronousLogging(boolean enabled);
+
+    /**
+     * Returns the number of messages dropped because the asynchronous log queue was full.
+     *
+     * @hide internal use only
+     */
+    public static native long droppedLogMessageCount();
+
     /**
      * Provides a hint to the VM that it would be useful to attempt
      * to perform any outstanding object finalization.
@@ -168,8 +168,12 @@ final class BigInt {
     }
 
     void putBigEndian(byte[] a, boolean neg) {
+        putBigEndian(a, 0, a.length, neg);
+    }
+
+    void putBigEndian(byte[] a, int offset, int length, boolean neg) {
         this.makeValid();
-        NativeBN.BN_bin2bn(a, a.length, neg, this.bignum);
+        NativeBN.BN_bin2bn(a, offset, length, neg, this.bignum);
     }
 
     void putLittleEndianInts(int[] a, boolean neg) {
@@ -178,8 +182,12 @@ final class BigInt {
     }
 
     void putBigEndianTwosComplement(byte[] a) {
+        putBigEndianTwosComplement(a, 0, a.length);
+    }
+
+    void putBigEndianTwosComplement(byte[] a, int offset, int length) {
         this.makeValid();
-        NativeBN.twosComp2bn(a, a.length, this.bignum);
+        NativeBN.twosComp2bn(a, offset, length, this.bignum);
     }
 
 
@@ -199,6 +207,14 @@ final class BigInt {
         return NativeBN.BN_bn2bin(this.bignum);
     }
 
+    /**
+     * Writes the big-endian magnitude to {@code dst} at {@code offset} if it fits.
+     * Returns the magnitude's length in bytes either way.
+     */
+    int bigEndianMagnitude(byte[] dst, int offset) {
+        return NativeBN.bn2binInto(this.bignum, dst, offset);
+    }
+
     int[] littleEndianIntsMagnitude() {
         return NativeBN.bn2litEndInts(this.bignum);
     }
@@ -321,13 +337,48 @@ final class BigInt {
         return r;
     }
 
-    static BigInt modExp(BigInt a, BigInt p, BigInt m) {
-        // Sign of p is ignored!
+    static BigInt modPow(BigInt a, BigInt p, BigInt m) {
+        // A negative p means pow(modInverse(a, m), -p).
         BigInt r = newBigInt();
-        NativeBN.BN_mod_exp(r.bignum, a.bignum, p.bignum, m.bignum);
+        NativeBN.modPow(r.bignum, a.bignum, p.bignum, m.bignum);
         return r;
     }
 
+    static BigInt modProduct(BigInt a, BigInt b, BigInt m) {
+        BigInt r = newBigInt();
+        NativeBN.BN_mod_mul(r.bignum, a.bignum, b.bignum, m.bignum);
+        return r;
+    }
+
+    static BigInt productPlus(BigInt a, BigInt b, BigInt c) {
+        BigInt r = newBigInt();
+        NativeBN.mulAdd(r.bignum, a.bignum, b.bignum, c.bignum);
+        return r;
+    }
+
+    static BigInt sum(BigInt[] values) {
+        long[] handles = new long[values.length];
+        for (int i = 0; i < values.length; ++i) {
+            handles[i] = values[i].bignum;
+        }
+        BigInt r = newBigInt();
+        NativeBN.sum(r.bignum, handles);
+        return r;
+    }
+
+    static BigInt sumOfProducts(BigInt[] lhs, BigInt[] rhs) {
+        long[] lhsHandles = new long[lhs.length];
+        for (int i = 0; i < lhs.length; ++i) {
+            lhsHandles[i] = lhs[i].bignum;
+        }
+        long[] rhsHandles = new long[rhs.length];
+        for (int i = 0; i < rhs.length; ++i) {
+            rhsHandles[i] = rhs[i].bignum;
+        }
+        BigInt r = newBigInt();
+        NativeBN.sumOfProducts(r.bignum, lhsHandles, rhsHandles);
+        return r;
+    }
 
     static BigInt modInverse(BigInt a, BigInt m) {
         BigInt r = newBigInt();
@@ -21,6 +21,7 @@ import java.io.IOException;
 import java.io.ObjectInputStream;
 import java.io.ObjectOutputStream;
 import java.io.Serializable;
+import java.util.Arrays;
 import java.util.Random;
 
 /**
@@ -99,9 +100,9 @@ public class BigInteger extends Number
     }
 
     BigInteger(int sign, long value) {
-        BigInt bigInt = new BigInt();
-        bigInt.putULongInt(value, (sign < 0));
-        setBigInt(bigInt);
+        // Start with just the Java representation: arithmetic on small values
+        // can then stay in Java, and most never need a BIGNUM at all.
+        setJavaRepresentation(sign, 2, new int[] { (int) value, (int) (value >>> 32) });
     }
 
     /**
@@ -267,21 +268,37 @@ public class BigInteger extends Number
      *     the sign is zero and the magnitude contains non-zero entries.
      */
     public BigInteger(int signum, byte[] magnitude) {
+        this(signum, checkNotNull(magnitude, "magnitude == null"), 0, magnitude.length);
+    }
+
+    /**
+     * Constructs a new {@code BigInteger} instance with the given sign and the
+     * magnitude in {@code magnitude[offset..offset+length)}, so a value can be
+     * read straight out of a larger buffer without copying it first.
+     *
+     * @throws NullPointerException if {@code magnitude == null}.
+     * @throws IndexOutOfBoundsException if {@code offset} or {@code length} are out of bounds.
+     * @throws NumberFormatException if the sign is not one of -1, 0, 1 or if
+     *     the sign is zero and the magnitude contains non-zero entries.
+     * @hide
+     */
+    public BigInteger(int signum, byte[] magnitude, int offset, int length) {
         if (magnitude == null) {
             throw new NullPointerException("magnitude == null");
         }
+        Arrays.checkOffsetAndCount(magnitude.length, offset, length);
         if (signum < -1 || signum > 1) {
             throw new NumberFormatException("Invalid signum: " + signum);
         }
         if (signum == 0) {
-            for (byte element : magnitude) {
-                if (element != 0) {
+            for (int i = offset; i < offset + length; ++i) {
+                if (magnitude[i] != 0) {
                     throw new NumberFormatException("signum-magnitude mismatch");
                 }
             }
         }
         BigInt bigInt = new BigInt();
-        bigInt.putBigEndian(magnitude, signum < 0);
+        bigInt.putBigEndian(magnitude, offset, length, signum < 0);
         setBigInt(bigInt);
     }
 
@@ -297,14 +314,36 @@ public class BigInteger extends Number
      * @throws NumberFormatException if the length of {@code value} is zero.
      */
     public BigInteger(byte[] value) {
-        if (value.length == 0) {
+        this(value, 0, value.length);
+    }
+
+    /**
+     * Constructs a new {@code BigInteger} from the two's complement
+     * representation in {@code value[offset..offset+length)}, which must be
+     * nonempty.
+     *
+     * @throws NullPointerException if {@code value == null}.
+     * @throws IndexOutOfBoundsException if {@code offset} or {@code length} are out of bounds.
+     * @throws NumberFormatException if {@code length} is zero.
+     * @hide
+     */
+    public BigInteger(byte[] value, int offset, int length) {
+        Arrays.checkOffsetAndCount(value.length, offset, length);
+        if (length == 0) {
             throw new NumberFormatException("value.length == 0");
         }
         BigInt bigInt = new BigInt();
-        bigInt.putBigEndianTwosComplement(value);
+        bigInt.putBigEndianTwosComplement(value, offset, length);
         setBigInt(bigInt);
     }
 
+    private static byte[] checkNotNull(byte[] array, String message) {
+        if (array == null) {
+            throw new NullPointerException(message);
+        }
+        return array;
+    }
+
     /**
      * Returns the internal native representation of this big integer, computing
      * it if necessary.
@@ -382,6 +421,28 @@ public class BigInteger extends Number
         return twosComplement();
     }
 
+    /**
+     * Writes the magnitude of this {@code BigInteger}, most significant byte
+     * first and with no sign bit, to {@code dst} starting at {@code offset}.
+     * This lets callers serializing many values reuse one buffer rather than
+     * allocating an array per value. Zero has an empty magnitude.
+     *
+     * @return the number of bytes written.
+     * @throws IndexOutOfBoundsException if the magnitude doesn't fit.
+     * @hide
+     */
+    public int writeMagnitude(byte[] dst, int offset) {
+        if (offset < 0 || offset > dst.length) {
+            throw new IndexOutOfBoundsException("offset=" + offset + "; dst.length=" + dst.length);
+        }
+        int length = getBigInt().bigEndianMagnitude(dst, offset);
+        if (length > dst.length - offset) {
+            throw new IndexOutOfBoundsException("magnitude length=" + length + "; offset=" +
+                    offset + "; dst.length=" + dst.length);
+        }
+        return length;
+    }
+
     /**
      * Returns a {@code BigInteger} whose value is the absolute value of {@code
      * this}.
@@ -414,6 +475,9 @@ public class BigInteger extends Number
      * Returns a {@code BigInteger} whose value is {@code this + value}.
      */
     public BigInteger add(BigInteger value) {
+        if (isSmall() && value.isSmall()) {
+            return value.sign == 0 ? this : addSmall(this, value, value.sign);
+        }
         BigInt lhs = getBigInt();
         BigInt rhs = value.getBigInt();
         if (rhs.sign() == 0) {
@@ -429,6 +493,9 @@ public class BigInteger extends Number
      * Returns a {@code BigInteger} whose value is {@code this - value}.
      */
     public BigInteger subtract(BigInteger value) {
+        if (isSmall() && value.isSmall()) {
+            return value.sign == 0 ? this : addSmall(this, value, -value.sign);
+        }
         BigInt lhs = getBigInt();
         BigInt rhs = value.getBigInt();
         if (rhs.sign() == 0) {
@@ -800,6 +867,12 @@ public class BigInteger extends Number
      * @throws NullPointerException if {@code value == null}.
      */
     public int compareTo(BigInteger value) {
+        if (isSmall() && value.isSmall()) {
+            if (sign != value.sign) {
+                return sign < value.sign ? -1 : 1;
+            }
+            return sign * compareUnsigned(smallMagnitude(), value.smallMagnitude());
+        }
         return BigInt.cmp(getBigInt(), value.getBigInt());
     }
 
@@ -892,9 +965,87 @@ public class BigInteger extends Number
      * @throws NullPointerException if {@code value == null}.
      */
     public BigInteger multiply(BigInteger value) {
+        if (isSmall() && value.isSmall()) {
+            return multiplySmall(this, value);
+        }
         return new BigInteger(BigInt.product(getBigInt(), value.getBigInt()));
     }
 
+    /**
+     * Returns true if this value's Java representation is valid and its
+     * magnitude fits in two digits, that is, in an unsigned 64-bit long.
+     * Operations on such values are computed in Java rather than by OpenSSL;
+     * results too big to qualify themselves simply take the native path next
+     * time.
+     */
+    private boolean isSmall() {
+        return javaIsValid && numberLength <= 2;
+    }
+
+    /** Returns the magnitude of a value for which {@link #isSmall} is true. */
+    private long smallMagnitude() {
+        long lo = digits[0] & 0xFFFFFFFFL;
+        return numberLength == 2 ? ((long) digits[1]) << 32 | lo : lo;
+    }
+
+    /**
+     * Returns {@code a + b}, where {@code b}'s sign is taken to be {@code
+     * bSign}. Both must be small, and {@code bSign} must be nonzero.
+     */
+    private static BigInteger addSmall(BigInteger a, BigInteger b, int bSign) {
+        long bMagnitude = b.smallMagnitude();
+        if (a.sign == 0) {
+            return new BigInteger(bSign, 2, new int[] { (int) bMagnitude, (int) (bMagnitude >>> 32) });
+        }
+        long aMagnitude = a.smallMagnitude();
+        if (a.sign == bSign) {
+            long sum = aMagnitude + bMagnitude;
+            int carry = (sum ^ Long.MIN_VALUE) < (aMagnitude ^ Long.MIN_VALUE) ? 1 : 0;
+            return new BigInteger(bSign, 3, new int[] { (int) sum, (int) (sum >>> 32), carry });
+        }
+        // The signs differ, so subtract the smaller magnitude from the larger.
+        int cmp = compareUnsigned(aMagnitude, bMagnitude);
+        if (cmp == 0) {
+            return ZERO;
+        }
+        long difference = (cmp > 0) ? aMagnitude - bMagnitude : bMagnitude - aMagnitude;
+        int resultSign = (cmp > 0) ? a.sign : bSign;
+        return new BigInteger(resultSign, 2, new int[] { (int) difference, (int) (difference >>> 32) });
+    }
+
+    /**
+     * Returns {@code a * b} for small {@code a} and {@code b}, computing the
+     * full 128-bit product of their magnitudes from 32-bit halves.
+     */
+    private static BigInteger multiplySmall(BigInteger a, BigInteger b) {
+        int resultSign = a.sign * b.sign;
+        if (resultSign == 0) {
+            return ZERO;
+        }
+        long aMagnitude = a.smallMagnitude();
+        long bMagnitude = b.smallMagnitude();
+        long a0 = aMagnitude & 0xFFFFFFFFL;
+        long a1 = aMagnitude >>> 32;
+        long b0 = bMagnitude & 0xFFFFFFFFL;
+        long b1 = bMagnitude >>> 32;
+        long p00 = a0 * b0;
+        long p01 = a0 * b1;
+        long p10 = a1 * b0;
+        long p11 = a1 * b1;
+        long middle = (p00 >>> 32) + (p01 & 0xFFFFFFFFL) + (p10 & 0xFFFFFFFFL);
+        long high = (middle >>> 32) + (p01 >>> 32) + (p10 >>> 32) + (p11 & 0xFFFFFFFFL);
+        int[] digits = new int[] {
+            (int) p00, (int) middle, (int) high, (int) ((high >>> 32) + (p11 >>> 32))
+        };
+        return new BigInteger(resultSign, 4, digits);
+    }
+
+    private static int compareUnsigned(long a, long b) {
+        a ^= Long.MIN_VALUE;
+        b ^= Long.MIN_VALUE;
+        return (a < b) ? -1 : (a == b ? 0 : 1);
+    }
+
     /**
      * Returns a {@code BigInteger} whose value is {@code pow(this, exp)}.
      *
@@ -989,12 +1140,74 @@ public class BigInteger extends Number
         if (modulus.signum() <= 0) {
             throw new ArithmeticException("modulus.signum() <= 0");
         }
-        int exponentSignum = exponent.signum();
-        if (exponentSignum == 0) { // OpenSSL gets this case wrong; http://b/8574367.
-            return ONE.mod(modulus);
+        // The native code handles zero and negative exponents itself, so this is one call.
+        return new BigInteger(BigInt.modPow(getBigInt(), exponent.getBigInt(), modulus.getBigInt()));
+    }
+
+    /**
+     * Returns a {@code BigInteger} whose value is {@code (this * value) mod m}.
+     * The modulus {@code m} must be positive. The result is in the interval
+     * {@code [0, m)}. This is equivalent to, but cheaper than,
+     * {@code multiply(value).mod(m)}.
+     *
+     * @throws NullPointerException if {@code value == null} or {@code m == null}.
+     * @throws ArithmeticException if {@code m <= 0}.
+     * @hide
+     */
+    public BigInteger modMultiply(BigInteger value, BigInteger m) {
+        if (m.signum() <= 0) {
+            throw new ArithmeticException("m.signum() <= 0");
+        }
+        return new BigInteger(BigInt.modProduct(getBigInt(), value.getBigInt(), m.getBigInt()));
+    }
+
+    /**
+     * Returns a {@code BigInteger} whose value is {@code this * multiplier + addend},
+     * computed in a single native call.
+     *
+     * @throws NullPointerException if {@code multiplier == null} or {@code addend == null}.
+     * @hide
+     */
+    public BigInteger multiplyAdd(BigInteger multiplier, BigInteger addend) {
+        return new BigInteger(BigInt.productPlus(getBigInt(), multiplier.getBigInt(),
+                addend.getBigInt()));
+    }
+
+    /**
+     * Returns the sum of {@code values}, computed in a single native call.
+     * The sum of no values is zero.
+     *
+     * @throws NullPointerException if {@code values} or any of its elements is null.
+     * @hide
+     */
+    public static BigInteger sum(BigInteger... values) {
+        BigInt[] bigInts = new BigInt[values.length];
+        for (int i = 0; i < values.length; ++i) {
+            bigInts[i] = values[i].getBigInt();
+        }
+        return new BigInteger(BigInt.sum(bigInts));
+    }
+
+    /**
+     * Returns {@code lhs[0] * rhs[0] + lhs[1] * rhs[1] + ...}, computed in a
+     * single native call.
+     *
+     * @throws NullPointerException if either array or any of their elements is null.
+     * @throws IllegalArgumentException if the arrays' lengths differ.
+     * @hide
+     */
+    public static BigInteger sumOfProducts(BigInteger[] lhs, BigInteger[] rhs) {
+        if (lhs.length != rhs.length) {
+            throw new IllegalArgumentException("lhs.length=" + lhs.length +
+                    "; rhs.length=" + rhs.length);
+        }
+        BigInt[] lhsBigInts = new BigInt[lhs.length];
+        BigInt[] rhsBigInts = new BigInt[rhs.length];
+        for (int i = 0; i < lhs.length; ++i) {
+            lhsBigInts[i] = lhs[i].getBigInt();
+            rhsBigInts[i] = rhs[i].getBigInt();
         }
-        BigInteger base = exponentSignum < 0 ? modInverse(modulus) : this;
-        return new BigInteger(BigInt.modExp(base.getBigInt(), exponent.getBigInt(), modulus.getBigInt()));
+        return new BigInteger(BigInt.sumOfProducts(lhsBigInts, rhsBigInts));
     }
 
     /**
@@ -39,14 +39,14 @@ final class NativeBN {
     public static native int BN_hex2bn(long a, String str);
     // int BN_hex2bn(BIGNUM **a, const char *str);
 
-    public static native void BN_bin2bn(byte[] s, int len, boolean neg, long ret);
+    public static native void BN_bin2bn(byte[] s, int offset, int len, boolean neg, long ret);
     // BIGNUM * BN_bin2bn(const unsigned char *s, int len, BIGNUM *ret);
     // BN-Docu: s is taken as unsigned big endian;
-    // Additional parameter: neg.
+    // Additional parameters: offset, neg.
 
     public static native void litEndInts2bn(int[] ints, int len, boolean neg, long ret);
 
-    public static native void twosComp2bn(byte[] s, int len, long ret);
+    public static native void twosComp2bn(byte[] s, int offset, int len, long ret);
 
 
     public static native long longInt(long a);
@@ -62,6 +62,10 @@ final class NativeBN {
     // Returns result byte[] AND NOT length.
     // int BN_bn2bin(const BIGNUM *a, unsigned char *to);
 
+    public static native int bn2binInto(long a, byte[] to, int offset);
+    // Like BN_bn2bin, but writes to 'to' at 'offset', and only if the result fits.
+    // Returns the length of the result either way.
+
     public static native int[] bn2litEndInts(long a);
 
     public static native int sign(long a);
@@ -118,6 +122,21 @@ final class NativeBN {
     public static native void BN_mod_inverse(long ret, long a, long n);
     // BIGNUM * BN_mod_inverse(BIGNUM *ret, const BIGNUM *a, const BIGNUM *n, BN_CTX *ctx);
 
+    public static native void BN_mod_mul(long r, long a, long b, long m);
+    // int BN_mod_mul(BIGNUM *r, BIGNUM *a, BIGNUM *b, const BIGNUM *m, BN_CTX *ctx);
+
+    public static native void modPow(long r, long a, long p, long m);
+    // Like BN_mod_exp, but also handles zero and negative exponents.
+
+    public static native void mulAdd(long r, long a, long b, long c);
+    // r = a * b + c
+
+    public static native void sum(long r, long[] operands);
+    // r = operands[0] + operands[1] + ...
+
+    public static native void sumOfProducts(long r, long[] lhs, long[] rhs);
+    // r = lhs[0] * rhs[0] + lhs[1] * rhs[1] + ...
+
 
     public static native void BN_generate_prime_ex(long ret, int bits, boolean safe,
                                                    long add, long rem, long cb);
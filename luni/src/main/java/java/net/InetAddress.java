@@ -29,10 +29,17 @@ import java.io.ObjectStreamException;
 import java.io.ObjectStreamField;
 import java.io.Serializable;
 import java.nio.ByteOrder;
+import java.util.ArrayList;
 import java.util.Arrays;
 import java.util.Collections;
+import java.util.HashMap;
 import java.util.concurrent.atomic.AtomicBoolean;
+import java.util.concurrent.ConcurrentHashMap;
 import java.util.concurrent.CountDownLatch;
+import java.util.concurrent.LinkedBlockingQueue;
+import java.util.concurrent.ThreadFactory;
+import java.util.concurrent.ThreadPoolExecutor;
+import java.util.concurrent.TimeUnit;
 import java.util.List;
 import libcore.io.IoBridge;
 import libcore.io.Libcore;
@@ -125,6 +132,20 @@ public class InetAddress implements Serializable {
     /** Our Java-side DNS cache. */
     private static final AddressCache addressCache = new AddressCache();
 
+    /**
+     * Hostnames someone is currently asking getaddrinfo(3) about, mapped to a latch that's
+     * released when the answer is in {@code addressCache}.
+     */
+    private static final ConcurrentHashMap<String, CountDownLatch> pendingLookups
+            = new ConcurrentHashMap<String, CountDownLatch>();
+
+    /**
+     * Hostnames an {@link #getAllByNameAsync} lookup is in flight for, mapped to everyone
+     * waiting for the answer. Guarded by itself.
+     */
+    private static final HashMap<String, List<LookupCallback>> pendingAsyncLookups
+            = new HashMap<String, List<LookupCallback>>();
+
     private static final long serialVersionUID = 3286316764910316507L;
 
     private int family;
@@ -381,17 +402,56 @@ public class InetAddress implements Serializable {
      */
     private static InetAddress[] lookupHostByName(String host) throws UnknownHostException {
         BlockGuard.getThreadPolicy().onNetwork();
-        // Do we have a result cached?
-        Object cachedResult = addressCache.get(host);
-        if (cachedResult != null) {
-            if (cachedResult instanceof InetAddress[]) {
-                // A cached positive result.
-                return (InetAddress[]) cachedResult;
-            } else {
-                // A cached negative result.
-                throw new UnknownHostException((String) cachedResult);
+        while (true) {
+            // Do we have a result cached?
+            Object cachedResult = addressCache.get(host);
+            if (cachedResult != null) {
+                if (cachedResult instanceof InetAddress[]) {
+                    // A cached positive result.
+                    return (InetAddress[]) cachedResult;
+                } else {
+                    // A cached negative result.
+                    throw new UnknownHostException((String) cachedResult);
+                }
+            }
+
+            // Only one thread at a time asks the resolver about a given host. When it's slow,
+            // everyone else waiting on that host costs one parked thread, not one more query.
+            CountDownLatch ours = new CountDownLatch(1);
+            CountDownLatch pending = pendingLookups.putIfAbsent(host, ours);
+            if (pending == null) {
+                try {
+                    return resolveHostByName(host);
+                } finally {
+                    pendingLookups.remove(host);
+                    ours.countDown();
+                }
+            }
+            // The answer is normally in the cache when we wake. If not (the lookup threw
+            // SecurityException, or the entry was already evicted), we'll ask ourselves.
+            awaitUninterruptibly(pending);
+        }
+    }
+
+    private static void awaitUninterruptibly(CountDownLatch latch) {
+        boolean interrupted = false;
+        while (true) {
+            try {
+                latch.await();
+                break;
+            } catch (InterruptedException e) {
+                interrupted = true;
             }
         }
+        if (interrupted) {
+            Thread.currentThread().interrupt();
+        }
+    }
+
+    /**
+     * Resolves a hostname with getaddrinfo(3), and caches the result.
+     */
+    private static InetAddress[] resolveHostByName(String host) throws UnknownHostException {
         try {
             StructAddrinfo hints = new StructAddrinfo();
             hints.ai_flags = AI_ADDRCONFIG;
@@ -423,6 +483,121 @@ public class InetAddress implements Serializable {
         }
     }
 
+    /**
+     * Receives the answer to a {@link #getAllByNameAsync} lookup.
+     *
+     * @hide
+     */
+    public interface LookupCallback {
+        /**
+         * Called with the addresses of {@code host}, or with {@code addresses} null and the
+         * reason the lookup failed.
+         */
+        void onLookupComplete(String host, InetAddress[] addresses, UnknownHostException failure);
+    }
+
+    /**
+     * The threads that make the blocking getaddrinfo(3) calls for {@link #getAllByNameAsync}.
+     * There are only a few, so a stalled resolver ties up those and nothing else; lookups of
+     * other hosts queue behind them. Idle threads exit.
+     */
+    private static class AsyncResolver {
+        private static final int THREAD_COUNT = 4;
+
+        static final ThreadPoolExecutor executor = new ThreadPoolExecutor(
+                THREAD_COUNT, THREAD_COUNT, 30, TimeUnit.SECONDS,
+                new LinkedBlockingQueue<Runnable>(),
+                new ThreadFactory() {
+                    @Override public Thread newThread(Runnable r) {
+                        Thread thread = new Thread(r, "InetAddress resolver");
+                        thread.setDaemon(true);
+                        return thread;
+                    }
+                });
+        static {
+            executor.allowCoreThreadTimeOut(true);
+        }
+    }
+
+    /**
+     * Like {@link #getAllByName}, but never blocks: the answer is delivered to {@code callback}
+     * on one of a small, fixed set of resolver threads. If the answer doesn't need a DNS lookup
+     * (because {@code host} is numeric, or already cached), {@code callback} is called on this
+     * thread before this method returns. Concurrent lookups of the same host share one query.
+     *
+     * @hide
+     */
+    public static void getAllByNameAsync(final String host, LookupCallback callback) {
+        if (host != null && !host.isEmpty() && parseNumericAddressNoThrow(host) == null) {
+            Object cachedResult = addressCache.get(host);
+            if (cachedResult instanceof InetAddress[]) {
+                callback.onLookupComplete(host, ((InetAddress[]) cachedResult).clone(), null);
+            } else if (cachedResult != null) {
+                callback.onLookupComplete(host, null,
+                        new UnknownHostException((String) cachedResult));
+            } else {
+                synchronized (pendingAsyncLookups) {
+                    List<LookupCallback> waiting = pendingAsyncLookups.get(host);
+                    if (waiting != null) {
+                        waiting.add(callback);
+                        return;
+                    }
+                    waiting = new ArrayList<LookupCallback>();
+                    waiting.add(callback);
+                    pendingAsyncLookups.put(host, waiting);
+                }
+                AsyncResolver.executor.execute(new Runnable() {
+                    @Override public void run() {
+                        resolveAsync(host);
+                    }
+                });
+            }
+            return;
+        }
+
+        // Nothing for the resolver to do.
+        InetAddress[] addresses = null;
+        UnknownHostException failure = null;
+        try {
+            addresses = getAllByNameImpl(host).clone();
+        } catch (UnknownHostException e) {
+            failure = e;
+        }
+        callback.onLookupComplete(host, addresses, failure);
+    }
+
+    private static void resolveAsync(String host) {
+        InetAddress[] addresses = null;
+        UnknownHostException failure = null;
+        try {
+            addresses = lookupHostByName(host);
+        } catch (UnknownHostException e) {
+            failure = e;
+        } catch (SecurityException e) {
+            failure = new UnknownHostException(e.getMessage());
+            failure.initCause(e);
+        }
+        List<LookupCallback> waiting;
+        synchronized (pendingAsyncLookups) {
+            waiting = pendingAsyncLookups.remove(host);
+        }
+        // Make sure one broken callback doesn't keep the answer from the others.
+        RuntimeException thrown = null;
+        for (LookupCallback callback : waiting) {
+            try {
+                callback.onLookupComplete(host, (addresses != null) ? addresses.clone() : null,
+                        failure);
+            } catch (RuntimeException e) {
+                if (thrown == null) {
+                    thrown = e;
+                }
+            }
+        }
+        if (thrown != null) {
+            throw thrown;
+        }
+    }
+
     /**
      * Removes all entries from the VM's DNS cache. This does not affect the C library's DNS
      * cache, nor any caching DNS servers between you and the canonical server.
@@ -0,0 +1,99 @@
+/*
+ * Copyright (C) 2014 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+package java.net;
+
+import java.util.Arrays;
+
+/**
+ * Turns the packed socket addresses written by {@code Libcore.os.acceptPacked} and friends into
+ * InetAddress instances, reusing the InetAddress for peers we've seen recently. A server that
+ * keeps hearing from the same few peers (a load balancer, say) then doesn't allocate an
+ * InetAddress and its byte[] per connection.
+ *
+ * The cache is a small direct-mapped table of immutable entries, so concurrent callers can share
+ * it without locking: at worst they both miss and one entry overwrites the other.
+ */
+final class PeerAddressCache {
+    /** The length of a packed socket address: a big-endian port, then a 16-byte IPv6 address. */
+    static final int PACKED_LENGTH = 18;
+
+    /** The number of slots. Must be a power of two. */
+    private static final int SIZE = 16;
+
+    private static final class Entry {
+        final byte[] ipAddress;
+        final InetAddress inetAddress;
+
+        Entry(byte[] ipAddress, InetAddress inetAddress) {
+            this.ipAddress = ipAddress;
+            this.inetAddress = inetAddress;
+        }
+    }
+
+    private final Entry[] entries = new Entry[SIZE];
+
+    /**
+     * Returns the port from the packed socket address 'packed'.
+     */
+    static int port(byte[] packed) {
+        return ((packed[0] & 0xff) << 8) | (packed[1] & 0xff);
+    }
+
+    /**
+     * Returns true if 'packed' is an IPv6 link-local address. Those come with a scope id, which
+     * the packed form has no room for, so callers must get the address some other way.
+     */
+    static boolean isLinkLocal(byte[] packed) {
+        return packed[2] == (byte) 0xfe && (packed[3] & 0xc0) == 0x80;
+    }
+
+    /**
+     * Returns the InetAddress for the packed socket address 'packed'. This has no scope id, so
+     * callers should check isLinkLocal first.
+     */
+    InetAddress get(byte[] packed) {
+        int hash = 1;
+        for (int i = 2; i < PACKED_LENGTH; ++i) {
+            hash = 31 * hash + packed[i];
+        }
+        int slot = (hash ^ (hash >>> 16)) & (SIZE - 1);
+
+        Entry entry = entries[slot];
+        if (entry != null && matches(entry.ipAddress, packed)) {
+            return entry.inetAddress;
+        }
+        byte[] ipAddress = Arrays.copyOfRange(packed, 2, PACKED_LENGTH);
+        InetAddress inetAddress;
+        try {
+            // This unmaps IPv4-mapped addresses, as the RI requires.
+            inetAddress = InetAddress.getByAddress(ipAddress);
+        } catch (UnknownHostException impossible) {
+            throw new AssertionError(impossible);
+        }
+        entries[slot] = new Entry(ipAddress, inetAddress);
+        return inetAddress;
+    }
+
+    private static boolean matches(byte[] ipAddress, byte[] packed) {
+        for (int i = 0; i < ipAddress.length; ++i) {
+            if (ipAddress[i] != packed[i + 2]) {
+                return false;
+            }
+        }
+        return true;
+    }
+}
@@ -50,6 +50,9 @@ public class PlainSocketImpl extends SocketImpl {
 
     private final CloseGuard guard = CloseGuard.get();
 
+    /** Recently-seen peers of a listening socket. Created by the first accept. */
+    private PeerAddressCache peerAddressCache;
+
     public PlainSocketImpl(FileDescriptor fd) {
         this.fd = fd;
         if (fd.valid()) {
@@ -85,15 +88,26 @@ public class PlainSocketImpl extends SocketImpl {
         }
 
         try {
-            InetSocketAddress peerAddress = new InetSocketAddress();
-            FileDescriptor clientFd = Libcore.os.accept(fd, peerAddress);
+            byte[] peerAddress = new byte[PeerAddressCache.PACKED_LENGTH];
+            FileDescriptor clientFd = Libcore.os.acceptPacked(fd, peerAddress);
 
             // TODO: we can't just set newImpl.fd to clientFd because a nio SocketChannel may
             // be sharing the FileDescriptor. http://b//4452981.
             newImpl.fd.setInt$(clientFd.getInt$());
 
-            newImpl.address = peerAddress.getAddress();
-            newImpl.port = peerAddress.getPort();
+            // The packed address has no room for a link-local peer's scope id, so those need
+            // the whole socket address.
+            boolean haveScopedPeer =
+                    PeerAddressCache.isLinkLocal(peerAddress) && setScopedPeer(newImpl, clientFd);
+            if (!haveScopedPeer) {
+                // Racing accepts may each create a cache; that's harmless.
+                PeerAddressCache cache = peerAddressCache;
+                if (cache == null) {
+                    cache = peerAddressCache = new PeerAddressCache();
+                }
+                newImpl.address = cache.get(peerAddress);
+                newImpl.port = PeerAddressCache.port(peerAddress);
+            }
         } catch (ErrnoException errnoException) {
             if (errnoException.errno == EAGAIN) {
                 throw new SocketTimeoutException(errnoException);
@@ -107,6 +121,22 @@ public class PlainSocketImpl extends SocketImpl {
         newImpl.localport = IoBridge.getSocketLocalPort(newImpl.fd);
     }
 
+    /**
+     * Sets the address and port of 'newImpl' from the full socket address of its peer, scope id
+     * included. Returns false if the peer has already gone, leaving the packed address as the
+     * best we have.
+     */
+    private static boolean setScopedPeer(SocketImpl newImpl, FileDescriptor clientFd) {
+        try {
+            InetSocketAddress peer = (InetSocketAddress) Libcore.os.getpeername(clientFd);
+            newImpl.address = peer.getAddress();
+            newImpl.port = peer.getPort();
+            return true;
+        } catch (ErrnoException errnoException) {
+            return false;
+        }
+    }
+
     private boolean usingSocks() {
         return proxy != null && proxy.type() == Proxy.Type.SOCKS;
     }
@@ -420,15 +420,20 @@ final class FileChannelImpl extends FileChannel {
         }
         count = Math.min(count, size() - position);
 
-        // Try sendfile(2) first...
+        // Try an in-kernel copy (copy_file_range(2), sendfile(2) or splice(2)) first...
         boolean completed = false;
+        FileDescriptor outFd = null;
         if (target instanceof SocketChannelImpl) {
-            FileDescriptor outFd = ((SocketChannelImpl) target).getFD();
+            outFd = ((SocketChannelImpl) target).getFD();
+        } else if (target instanceof FileChannelImpl) {
+            outFd = ((FileChannelImpl) target).getFD();
+        }
+        if (outFd != null) {
             try {
                 begin();
                 try {
                     MutableLong offset = new MutableLong(position);
-                    long rc = Libcore.os.sendfile(outFd, fd, offset, count);
+                    long rc = Libcore.os.transfer(fd, offset, outFd, count);
                     completed = true;
                     return rc;
                 } catch (ErrnoException errnoException) {
@@ -37,6 +37,14 @@ public final class NioUtils {
         ((DirectByteBuffer) buffer).free();
     }
 
+    /**
+     * Returns the address of the first element (not the element at the current position) of
+     * the direct buffer 'b', or 0 if 'b' is not direct.
+     */
+    public static long getDirectBufferAddress(Buffer b) {
+        return b.effectiveDirectAddress;
+    }
+
     /**
      * Returns the int file descriptor from within the given FileChannel 'fc'.
      */
@@ -16,6 +16,7 @@ package java.nio.charset;
 
 import java.nio.ByteBuffer;
 import java.nio.CharBuffer;
+import java.nio.NioUtils;
 import java.util.HashMap;
 import java.util.Map;
 import libcore.icu.ICU;
@@ -38,6 +39,12 @@ final class CharsetEncoderICU extends CharsetEncoder {
         DEFAULT_REPLACEMENTS.put("US-ASCII",   questionMark);
     }
 
+    // The charsets whose common characters Charsets can encode straight into a direct buffer.
+    private static final int DIRECT_NONE = 0;
+    private static final int DIRECT_ASCII = 1;
+    private static final int DIRECT_ISO_8859_1 = 2;
+    private static final int DIRECT_UTF_8 = 3;
+
     private static final int INPUT_OFFSET = 0;
     private static final int OUTPUT_OFFSET = 1;
     private static final int INVALID_CHAR_COUNT = 2;
@@ -62,6 +69,19 @@ final class CharsetEncoderICU extends CharsetEncoder {
     private int inEnd;
     private int outEnd;
 
+    /**
+     * Which of the Charsets direct encoders (if any) produces the same bytes ICU would for
+     * the characters it accepts.
+     */
+    private final int directEncoder;
+
+    /**
+     * True if ICU may be holding state from an earlier call: a lead surrogate waiting for its
+     * trail, or bytes that didn't fit in the last output buffer. While it is, everything goes
+     * through ICU so that output stays in order.
+     */
+    private boolean icuHasPendingState;
+
     public static CharsetEncoderICU newInstance(Charset cs, String icuCanonicalName) {
         // This complexity is necessary to ensure that even if the constructor, superclass
         // constructor, or call to updateCallback throw, we still free the native peer.
@@ -71,7 +91,7 @@ final class CharsetEncoderICU extends CharsetEncoder {
             float averageBytesPerChar = NativeConverter.getAveBytesPerChar(address);
             float maxBytesPerChar = NativeConverter.getMaxBytesPerChar(address);
             byte[] replacement = makeReplacement(icuCanonicalName, address);
-            CharsetEncoderICU result = new CharsetEncoderICU(cs, averageBytesPerChar, maxBytesPerChar, replacement, address);
+            CharsetEncoderICU result = new CharsetEncoderICU(cs, averageBytesPerChar, maxBytesPerChar, replacement, address, directEncoderFor(icuCanonicalName));
             address = 0; // CharsetEncoderICU has taken ownership; its finalizer will do the free.
             return result;
         } finally {
@@ -91,10 +111,22 @@ final class CharsetEncoderICU extends CharsetEncoder {
         return NativeConverter.getSubstitutionBytes(address);
     }
 
-    private CharsetEncoderICU(Charset cs, float averageBytesPerChar, float maxBytesPerChar, byte[] replacement, long address) {
+    private static int directEncoderFor(String icuCanonicalName) {
+        if (icuCanonicalName.equals("UTF-8")) {
+            return DIRECT_UTF_8;
+        } else if (icuCanonicalName.equals("ISO-8859-1")) {
+            return DIRECT_ISO_8859_1;
+        } else if (icuCanonicalName.equals("US-ASCII")) {
+            return DIRECT_ASCII;
+        }
+        return DIRECT_NONE;
+    }
+
+    private CharsetEncoderICU(Charset cs, float averageBytesPerChar, float maxBytesPerChar, byte[] replacement, long address, int directEncoder) {
         super(cs, averageBytesPerChar, maxBytesPerChar, replacement, true);
         // Our native peer needs to know what just happened...
         this.converterHandle = address;
+        this.directEncoder = directEncoder;
         updateCallback();
     }
 
@@ -125,6 +157,7 @@ final class CharsetEncoderICU extends CharsetEncoder {
         allocatedOutput = null;
         inEnd = 0;
         outEnd = 0;
+        icuHasPendingState = false;
     }
 
     @Override protected CoderResult implFlush(ByteBuffer out) {
@@ -159,10 +192,24 @@ final class CharsetEncoderICU extends CharsetEncoder {
             return CoderResult.UNDERFLOW;
         }
 
+        if (directEncoder != DIRECT_NONE && !icuHasPendingState && out.isDirect() &&
+                !out.isReadOnly()) {
+            // Encode as much as we can without ICU's intermediate byte[], and leave anything
+            // that needs an error action or a surrogate pair to ICU.
+            encodeDirect(in, out);
+            if (!in.hasRemaining()) {
+                return CoderResult.UNDERFLOW;
+            }
+            if (!out.hasRemaining()) {
+                return CoderResult.OVERFLOW;
+            }
+        }
+
         data[INPUT_OFFSET] = getArray(in);
         data[OUTPUT_OFFSET]= getArray(out);
         data[INVALID_CHAR_COUNT] = 0; // Make sure we don't see earlier errors.
 
+        icuHasPendingState = true;
         try {
             int error = NativeConverter.encode(converterHandle, input, inEnd, output, outEnd, data, false);
             if (ICU.U_FAILURE(error)) {
@@ -176,7 +223,9 @@ final class CharsetEncoderICU extends CharsetEncoder {
                     throw new AssertionError(error);
                 }
             }
-            // Decoding succeeded: give us more data.
+            // Decoding succeeded: give us more data. ICU has consumed all our input, and holds
+            // on to nothing unless it ended with a lead surrogate.
+            icuHasPendingState = Character.isHighSurrogate(input[inEnd - 1]);
             return CoderResult.UNDERFLOW;
         } finally {
             setPosition(in);
@@ -184,6 +233,56 @@ final class CharsetEncoderICU extends CharsetEncoder {
         }
     }
 
+    /**
+     * Encodes the longest prefix of 'in' that Charsets can encode exactly as ICU would and
+     * that fits in the direct buffer 'out', writing straight to the buffer's memory.
+     */
+    private void encodeDirect(CharBuffer in, ByteBuffer out) {
+        int offset = getArray(in);
+        char[] chars = input;
+        int end = inEnd;
+        input = null;
+        int capacity = out.remaining();
+        int i = offset;
+        int byteCount;
+        if (directEncoder == DIRECT_UTF_8) {
+            byteCount = 0;
+            for (; i < end; ++i) {
+                char ch = chars[i];
+                if (Character.isSurrogate(ch)) {
+                    break;
+                }
+                int length = (ch < 0x80) ? 1 : (ch < 0x800) ? 2 : 3;
+                if (byteCount + length > capacity) {
+                    break;
+                }
+                byteCount += length;
+            }
+        } else {
+            char max = (directEncoder == DIRECT_ASCII) ? (char) 0x7f : (char) 0xff;
+            end = Math.min(end, offset + capacity);
+            while (i < end && chars[i] <= max) {
+                ++i;
+            }
+            byteCount = i - offset;
+        }
+        int charCount = i - offset;
+        if (charCount == 0) {
+            return;
+        }
+
+        long address = NioUtils.getDirectBufferAddress(out) + out.position();
+        if (directEncoder == DIRECT_UTF_8) {
+            Charsets.toUtf8BytesDirect(chars, offset, charCount, address, byteCount);
+        } else if (directEncoder == DIRECT_ISO_8859_1) {
+            Charsets.toIsoLatin1BytesDirect(chars, offset, charCount, address);
+        } else {
+            Charsets.toAsciiBytesDirect(chars, offset, charCount, address);
+        }
+        in.position(in.position() + charCount);
+        out.position(out.position() + byteCount);
+    }
+
     @Override protected void finalize() throws Throwable {
         try {
             NativeConverter.closeConverter(converterHandle);
@@ -75,6 +75,26 @@ public final class Charsets {
      */
     public static native void isoLatin1BytesToChars(byte[] bytes, int offset, int length, char[] chars);
 
+    /**
+     * Like {@link #toAsciiBytes}, but writes the 'length' bytes to native memory starting at
+     * 'address' instead of allocating a new byte array.
+     */
+    public static native void toAsciiBytesDirect(char[] chars, int offset, int length, long address);
+
+    /**
+     * Like {@link #toIsoLatin1Bytes}, but writes the 'length' bytes to native memory starting at
+     * 'address' instead of allocating a new byte array.
+     */
+    public static native void toIsoLatin1BytesDirect(char[] chars, int offset, int length, long address);
+
+    /**
+     * Like {@link #toUtf8Bytes}, but writes the bytes to the 'capacity' bytes of native memory
+     * starting at 'address' instead of allocating a new byte array. Returns the number of bytes
+     * written, or -1 (having written nothing) if they wouldn't all fit. A capacity of
+     * 'length * 3' is always sufficient.
+     */
+    public static native int toUtf8BytesDirect(char[] chars, int offset, int length, long address, int capacity);
+
     private Charsets() {
     }
 }
@@ -21,6 +21,7 @@ import java.awt.font.NumericShaper;
 import java.awt.font.TextAttribute;
 import java.util.ArrayList;
 import java.util.Arrays;
+import libcore.util.NativeRegistration;
 
 /**
  * Implements the <a href="http://unicode.org/reports/tr9/">Unicode Bidirectional Algorithm</a>.
@@ -36,6 +37,10 @@ import java.util.Arrays;
  * even levels while right-to-left runs have odd levels.
  */
 public final class Bidi {
+    static {
+        NativeRegistration.ensureRegistered("java/text/Bidi");
+    }
+
     /**
      * Constant that indicates the default base level. If there is no strong
      * character, then set the paragraph level to 0 (left-to-right).
@@ -59,7 +64,8 @@ public final class Bidi {
     public static final int DIRECTION_RIGHT_TO_LEFT = 1;
 
     /**
-     * TODO: if we care about performance, we might just want to use an int[] instead of a Run[].
+     * Bidi keeps its runs as (start, limit, level) triples in an int[], but the runtime still
+     * looks this class up when it starts.
      */
     static class Run {
         private final int start;
@@ -231,6 +237,19 @@ public final class Bidi {
             throw new IllegalArgumentException("Negative paragraph length " + paragraphLength);
         }
 
+        // Most text has no right-to-left characters, so skip ICU when the paragraph is
+        // left-to-right (which is what out-of-range flags mean) or defaults to it.
+        if (embeddings == null && flags != DIRECTION_RIGHT_TO_LEFT
+                && flags != DIRECTION_DEFAULT_RIGHT_TO_LEFT
+                && !containsBidiChars(text, textStart, paragraphLength)) {
+            length = paragraphLength;
+            offsetLevel = (length == 0) ? null : new byte[length];
+            baseLevel = 0;
+            direction = UBiDiDirection_UBIDI_LTR;
+            unidirectional = true;
+            return;
+        }
+
         long bidi = 0;
         try {
             bidi = createUBiDi(text, textStart, embeddings, embStart, paragraphLength, flags);
@@ -336,7 +355,7 @@ public final class Bidi {
             runs = ubidi_getRuns(pBidi);
 
             // Simplified case for one run which has the base level
-            if (runCount == 1 && runs[0].getLevel() == baseLevel) {
+            if (runCount == 1 && runs[2] == baseLevel) {
                 unidirectional = true;
                 runs = null;
             }
@@ -351,7 +370,8 @@ public final class Bidi {
 
     private byte[] offsetLevel;
 
-    private Run[] runs;
+    // (start, limit, level) triples, or null if unidirectional.
+    private int[] runs;
 
     private int direction;
 
@@ -448,28 +468,28 @@ public final class Bidi {
      * Returns the number of runs in the text, at least 1.
      */
     public int getRunCount() {
-        return unidirectional ? 1 : runs.length;
+        return unidirectional ? 1 : runs.length / 3;
     }
 
     /**
      * Returns the level of the given run.
      */
     public int getRunLevel(int run) {
-        return unidirectional ? baseLevel : runs[run].getLevel();
+        return unidirectional ? baseLevel : runs[3 * run + 2];
     }
 
     /**
      * Returns the limit offset of the given run.
      */
     public int getRunLimit(int run) {
-        return unidirectional ? length : runs[run].getLimit();
+        return unidirectional ? length : runs[3 * run + 1];
     }
 
     /**
      * Returns the start offset of the given run.
      */
     public int getRunStart(int run) {
-        return unidirectional ? 0 : runs[run].getStart();
+        return unidirectional ? 0 : runs[3 * run];
     }
 
     /**
@@ -562,6 +582,9 @@ public final class Bidi {
             throw new IllegalArgumentException();
         }
 
+        if (!containsBidiChars(text, start, limit - start)) {
+            return false;
+        }
         Bidi bidi = new Bidi(text, start, null, 0, limit - start, 0);
         return !bidi.isLeftToRight();
     }
@@ -579,6 +602,10 @@ public final class Bidi {
     private static final int UBiDiDirection_UBIDI_RTL = 1;
     private static final int UBiDiDirection_UBIDI_MIXED = 2;
 
+    // Returns false if text[start, start + length) has nothing that could need more than one
+    // level in a left-to-right paragraph. May return true for text that doesn't.
+    private static native boolean containsBidiChars(char[] text, int start, int length);
+
     // ICU4C functions.
     private static native long ubidi_open();
     private static native void ubidi_close(long pBiDi);
@@ -589,6 +616,6 @@ public final class Bidi {
     private static native byte ubidi_getParaLevel(final long pBiDi);
     private static native byte[] ubidi_getLevels(long pBiDi);
     private static native int ubidi_countRuns(long pBiDi);
-    private static native Bidi.Run[] ubidi_getRuns(long pBidi);
+    private static native int[] ubidi_getRuns(long pBidi);
     private static native int[] ubidi_reorderVisual(byte[] levels, int length);
 }
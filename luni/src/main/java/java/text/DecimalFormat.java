@@ -688,6 +688,28 @@ public class DecimalFormat extends NumberFormat {
         return buffer;
     }
 
+    /**
+     * Formats all of {@code values} at once, which is much faster than formatting
+     * them one at a time. The result is the formatted numbers concatenated;
+     * number {@code i} is the chars from {@code offsets[i]} to
+     * {@code offsets[i + 1]}, so {@code offsets.length} must be
+     * {@code values.length + 1}.
+     *
+     * @hide
+     */
+    public char[] format(double[] values, int[] offsets) {
+        return ndf.formatDoubles(values, offsets);
+    }
+
+    /**
+     * Like {@link #format(double[], int[])}, but for longs.
+     *
+     * @hide
+     */
+    public char[] format(long[] values, int[] offsets) {
+        return ndf.formatLongs(values, offsets);
+    }
+
     @Override
     public final StringBuffer format(Object number, StringBuffer buffer, FieldPosition position) {
         checkBufferAndFieldPosition(buffer, position);
@@ -190,8 +190,7 @@ public abstract class TimeZone implements Serializable, Cloneable {
             throw new IllegalArgumentException("Bad style: " + style);
         }
 
-        String[][] zoneStrings = TimeZoneNames.getZoneStrings(locale);
-        String result = TimeZoneNames.getDisplayName(zoneStrings, getID(), daylightTime, style);
+        String result = TimeZoneNames.getDisplayName(locale, getID(), daylightTime, style);
         if (result != null) {
             return result;
         }
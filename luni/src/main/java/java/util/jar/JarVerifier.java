@@ -21,6 +21,7 @@ import org.apache.harmony.security.utils.JarUtils;
 import java.io.ByteArrayInputStream;
 import java.io.IOException;
 import java.io.OutputStream;
+import java.nio.ByteBuffer;
 import java.nio.charset.StandardCharsets;
 import java.security.GeneralSecurityException;
 import java.security.MessageDigest;
@@ -116,6 +117,13 @@ class JarVerifier {
             digest.update(buf, off, nbytes);
         }
 
+        /**
+         * Updates a digest with the remaining bytes of a buffer.
+         */
+        void write(ByteBuffer buffer) {
+            digest.update(buffer);
+        }
+
         /**
          * Verifies that the digests stored in the manifest match the decrypted
          * digests from the .SF file. This indicates the validity of the
@@ -21,9 +21,12 @@ import dalvik.system.CloseGuard;
 import java.io.IOException;
 import java.io.InputStream;
 import java.io.RandomAccessFile;
+import java.nio.ByteBuffer;
+import java.nio.channels.FileChannel;
 import java.security.cert.Certificate;
 import java.util.HashMap;
 import java.util.Iterator;
+import java.util.NoSuchElementException;
 import java.util.zip.Inflater;
 import java.util.zip.ZipEntry;
 import java.util.zip.ZipFile;
@@ -53,6 +56,14 @@ public final class StrictJarFile {
     private final CloseGuard guard = CloseGuard.get();
     private boolean closed;
 
+    // The central directory, read in one native call the first time it's needed.
+    private EntryTable entryTable;
+
+    // A read-only mapping of the whole archive, made the first time a stored entry's data is
+    // asked for. Buffers handed out by getStoredEntryBuffer share its memory, which is unmapped
+    // only once they are all unreachable, so it is deliberately not freed in close.
+    private ByteBuffer mapping;
+
     public StrictJarFile(String fileName) throws IOException {
         this.nativeHandle = nativeOpenJarFile(fileName);
         this.raf = new RandomAccessFile(fileName, "r");
@@ -79,11 +90,44 @@ public final class StrictJarFile {
     }
 
     public Iterator<ZipEntry> iterator() throws IOException {
-        return new EntryIterator(nativeHandle, "");
+        final EntryTable table = getEntryTable();
+        return new Iterator<ZipEntry>() {
+            private int next;
+
+            public boolean hasNext() {
+                return next < table.names.length;
+            }
+
+            public ZipEntry next() {
+                if (next >= table.names.length) {
+                    throw new NoSuchElementException();
+                }
+                return table.newZipEntry(next++);
+            }
+
+            public void remove() {
+                throw new UnsupportedOperationException();
+            }
+        };
     }
 
     public ZipEntry findEntry(String name) {
-        return nativeFindEntry(nativeHandle, name);
+        try {
+            EntryTable table = getEntryTable();
+            int index = table.indexOf(name);
+            return (index == -1) ? null : table.newZipEntry(index);
+        } catch (IOException e) {
+            return nativeFindEntry(nativeHandle, name);
+        }
+    }
+
+    private synchronized EntryTable getEntryTable() throws IOException {
+        if (entryTable == null) {
+            long[][] fields = new long[1][];
+            String[] names = nativeReadEntries(nativeHandle, fields);
+            entryTable = new EntryTable(names, fields[0]);
+        }
+        return entryTable;
     }
 
     /**
@@ -117,6 +161,52 @@ public final class StrictJarFile {
         return is;
     }
 
+    /**
+     * Returns a read-only direct buffer over the data of the {@link ZipEntry#STORED} entry
+     * {@code ze}, which reads straight from a mapping of the archive: no copy is made and
+     * no system call is needed to read it. For a signed jar the entry's digest is verified
+     * before the buffer is returned, so its certificates are available immediately.
+     *
+     * @throws IllegalArgumentException if {@code ze} is compressed.
+     * @throws SecurityException if the entry's digest doesn't match the manifest.
+     */
+    public ByteBuffer getStoredEntryBuffer(ZipEntry ze) throws IOException {
+        if (ze.getMethod() != ZipEntry.STORED) {
+            throw new IllegalArgumentException("Not a stored entry: " + ze.getName());
+        }
+        long offset = ze.getDataOffset();
+        long size = ze.getSize();
+        ByteBuffer buffer;
+        synchronized (this) {
+            if (closed) {
+                throw new IllegalStateException("Jar file is closed");
+            }
+            if (mapping == null && raf.length() <= Integer.MAX_VALUE) {
+                mapping = raf.getChannel().map(FileChannel.MapMode.READ_ONLY, 0, raf.length());
+            }
+            if (mapping != null) {
+                if (offset < 0 || size < 0 || offset + size > mapping.capacity()) {
+                    throw new IOException("Entry " + ze.getName() + " lies outside the archive");
+                }
+                buffer = mapping.duplicate();
+                buffer.limit((int) (offset + size)).position((int) offset);
+                buffer = buffer.slice();
+            } else {
+                // Too big to map in one piece; map just this entry.
+                buffer = raf.getChannel().map(FileChannel.MapMode.READ_ONLY, offset, size);
+            }
+        }
+
+        if (isSigned) {
+            JarVerifier.VerifierEntry entry = verifier.initEntry(ze.getName());
+            if (entry != null) {
+                entry.write(buffer.duplicate());
+                entry.verify();
+            }
+        }
+        return buffer.asReadOnlyBuffer();
+    }
+
     public void close() throws IOException {
         if (!closed) {
             guard.close();
@@ -140,6 +230,70 @@ public final class StrictJarFile {
         }
     }
 
+    /**
+     * Every entry in the archive, in central directory order. Entry {@code i} is called
+     * {@code names[i]} and its attributes are the {@code ENTRY_FIELD_COUNT} values starting at
+     * {@code fields[ENTRY_FIELD_COUNT * i]}. Lookups by name go through an open-addressing hash
+     * table of entry indexes keyed by {@code String.hashCode}, which the name caches, so a repeated
+     * lookup neither crosses JNI nor re-hashes the name.
+     */
+    static final class EntryTable {
+        // The layout of nativeReadEntries' fields, per entry.
+        private static final int CRC = 0;
+        private static final int COMPRESSED_SIZE = 1;
+        private static final int SIZE = 2;
+        private static final int METHOD = 3;
+        private static final int DATA_OFFSET = 4;
+        private static final int ENTRY_FIELD_COUNT = 5;
+
+        final String[] names;
+        private final long[] fields;
+
+        // Entry index plus one, or 0 for an empty slot. The length is a power of two at least
+        // twice the entry count, so probe sequences stay short.
+        private final int[] slots;
+
+        EntryTable(String[] names, long[] fields) {
+            this.names = names;
+            this.fields = fields;
+            int capacity = Integer.highestOneBit(Math.max(names.length, 1) * 2 - 1) << 1;
+            this.slots = new int[capacity];
+            for (int i = 0; i < names.length; ++i) {
+                int mask = slots.length - 1;
+                int slot = names[i].hashCode() & mask;
+                while (slots[slot] != 0) {
+                    if (names[slots[slot] - 1].equals(names[i])) {
+                        break; // Keep the first of any duplicates, like libziparchive.
+                    }
+                    slot = (slot + 1) & mask;
+                }
+                if (slots[slot] == 0) {
+                    slots[slot] = i + 1;
+                }
+            }
+        }
+
+        int indexOf(String name) {
+            int mask = slots.length - 1;
+            int slot = name.hashCode() & mask;
+            int entry;
+            while ((entry = slots[slot]) != 0) {
+                if (names[entry - 1].equals(name)) {
+                    return entry - 1;
+                }
+                slot = (slot + 1) & mask;
+            }
+            return -1;
+        }
+
+        ZipEntry newZipEntry(int index) {
+            int base = ENTRY_FIELD_COUNT * index;
+            return new ZipEntry(names[index], null, fields[base + CRC],
+                    fields[base + COMPRESSED_SIZE], fields[base + SIZE], (int) fields[base + METHOD],
+                    0, 0, null, -1, fields[base + DATA_OFFSET]);
+        }
+    }
+
     static final class EntryIterator implements Iterator<ZipEntry> {
         private final long iterationHandle;
         private ZipEntry nextEntry;
@@ -193,5 +347,6 @@ public final class StrictJarFile {
     private static native long nativeStartIteration(long nativeHandle, String prefix);
     private static native ZipEntry nativeNextEntry(long iterationHandle);
     private static native ZipEntry nativeFindEntry(long nativeHandle, String entryName);
+    private static native String[] nativeReadEntries(long nativeHandle, long[][] fields) throws IOException;
     private static native void nativeClose(long nativeHandle);
 }
@@ -16,12 +16,24 @@
 
 package java.util.regex;
 
+import libcore.util.NativeRegistration;
+
 /**
  * The result of applying a {@code Pattern} to a given input. See {@link Pattern} for
  * example uses.
  */
 public final class Matcher implements MatchResult {
 
+    static {
+        NativeRegistration.ensureRegistered("java/util/regex/Matcher");
+    }
+
+    /**
+     * The number of matches fetched per native call by operations that walk
+     * through all of the matches in the input.
+     */
+    static final int FIND_ALL_BATCH_SIZE = 64;
+
     /**
      * Holds the pattern, that is, the compiled regular expression.
      */
@@ -315,8 +327,23 @@ public final class Matcher implements MatchResult {
     public String replaceAll(String replacement) {
         reset();
         StringBuffer buffer = new StringBuffer(input.length());
-        while (find()) {
-            appendReplacement(buffer, replacement);
+        if (replacement.indexOf('$') == -1 && replacement.indexOf('\\') == -1) {
+            // A literal replacement never needs group(), so we can fetch the matches in bulk.
+            int stride = matchOffsets.length;
+            int[] offsets = new int[stride * FIND_ALL_BATCH_SIZE];
+            int count;
+            do {
+                count = findAll(offsets, FIND_ALL_BATCH_SIZE);
+                for (int i = 0; i < count; ++i) {
+                    buffer.append(input, appendPos, offsets[i * stride]);
+                    buffer.append(replacement);
+                    appendPos = offsets[i * stride + 1];
+                }
+            } while (count == FIND_ALL_BATCH_SIZE);
+        } else {
+            while (find()) {
+                appendReplacement(buffer, replacement);
+            }
         }
         return appendTail(buffer).toString();
     }
@@ -360,6 +387,41 @@ public final class Matcher implements MatchResult {
         return matchFound;
     }
 
+    /**
+     * Finds up to {@code maxMatches} further occurrences of the pattern, just
+     * as that many calls to {@link #find()} would, but in a single native call.
+     * The start and end of group 0 and of each capturing group, that is
+     * {@code 2 * (groupCount() + 1)} ints per match, are written to successive
+     * rows of {@code offsets}. Afterwards this matcher's current match is the
+     * last one found, or there is no current match if the input ran out.
+     *
+     * @return the number of matches found, which is less than
+     *     {@code maxMatches} only if there are no more matches.
+     * @throws IllegalArgumentException if {@code maxMatches} is negative or
+     *     {@code offsets} has room for fewer than {@code maxMatches} matches.
+     * @hide
+     */
+    public int findAll(int[] offsets, int maxMatches) {
+        int stride = matchOffsets.length;
+        if (maxMatches < 0 || offsets.length / stride < maxMatches) {
+            throw new IllegalArgumentException("maxMatches=" + maxMatches +
+                    "; offsets.length=" + offsets.length + "; groupCount=" + (stride / 2 - 1));
+        }
+        if (maxMatches == 0) {
+            return 0;
+        }
+
+        synchronized (this) {
+            int count = findAllImpl(address, input, offsets, maxMatches);
+            // Only a run that stopped at maxMatches ended with a successful find().
+            matchFound = (count == maxMatches);
+            if (matchFound) {
+                System.arraycopy(offsets, (count - 1) * stride, matchOffsets, 0, stride);
+            }
+            return Math.max(count, 0);
+        }
+    }
+
     /**
      * Tries to match the {@link Pattern}, starting from the beginning of the
      * region (or the beginning of the input, if no region has been set).
@@ -614,6 +676,7 @@ public final class Matcher implements MatchResult {
     }
 
     private static native void closeImpl(long addr);
+    private static native int findAllImpl(long addr, String s, int[] offsets, int maxMatches);
     private static native boolean findImpl(long addr, String s, int startIndex, int[] offsets);
     private static native boolean findNextImpl(long addr, String s, int[] offsets);
     private static native int groupCountImpl(long addr);
@@ -19,6 +19,7 @@ package java.util.regex;
 import java.io.IOException;
 import java.io.ObjectInputStream;
 import java.io.Serializable;
+import libcore.util.NativeRegistration;
 
 /**
  * Patterns are compiled regular expressions. In many cases, convenience methods such as
@@ -224,6 +225,10 @@ import java.io.Serializable;
  */
 public final class Pattern implements Serializable {
 
+    static {
+        NativeRegistration.ensureRegistered("java/util/regex/Pattern");
+    }
+
     private static final long serialVersionUID = 5073258162644648461L;
 
     /**
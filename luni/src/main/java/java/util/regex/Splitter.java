@@ -116,10 +116,23 @@ public class Splitter {
         // Collect text preceding each occurrence of the separator, while there's enough space.
         ArrayList<String> list = new ArrayList<String>();
         Matcher matcher = new Matcher(pattern, input);
+        int stride = 2 * (matcher.groupCount() + 1);
+        int[] offsets = new int[stride * Matcher.FIND_ALL_BATCH_SIZE];
         int begin = 0;
-        while (list.size() + 1 != limit && matcher.find()) {
-            list.add(input.substring(begin, matcher.start()));
-            begin = matcher.end();
+        while (list.size() + 1 != limit) {
+            // Fetch the matches in bulk, but never more than the limit lets us use.
+            int maxMatches = Matcher.FIND_ALL_BATCH_SIZE;
+            if (limit > 0) {
+                maxMatches = Math.min(maxMatches, limit - 1 - list.size());
+            }
+            int count = matcher.findAll(offsets, maxMatches);
+            for (int i = 0; i < count; ++i) {
+                list.add(input.substring(begin, offsets[i * stride]));
+                begin = offsets[i * stride + 1];
+            }
+            if (count < maxMatches) {
+                break;
+            }
         }
         return finishSplit(list, input, begin, limit);
     }
@@ -17,6 +17,8 @@
 
 package java.util.zip;
 
+import java.nio.ByteBuffer;
+import java.nio.NioUtils;
 import java.util.Arrays;
 
 /**
@@ -26,6 +28,9 @@ import java.util.Arrays;
  */
 public class Adler32 implements Checksum {
 
+    // The largest prime smaller than 65536, from RFC 1950.
+    private static final int BASE = 65521;
+
     private long adler = 1;
 
     /**
@@ -52,7 +57,16 @@ public class Adler32 implements Checksum {
      *            the byte to update checksum with.
      */
     public void update(int i) {
-        adler = updateByteImpl(i, adler);
+        // Done here rather than in native code: a JNI call would cost more than the arithmetic.
+        int s1 = ((int) adler & 0xffff) + (i & 0xff);
+        if (s1 >= BASE) {
+            s1 -= BASE;
+        }
+        int s2 = ((int) (adler >>> 16)) + s1;
+        if (s2 >= BASE) {
+            s2 -= BASE;
+        }
+        adler = ((long) s2 << 16) | s1;
     }
 
     /**
@@ -74,7 +88,45 @@ public class Adler32 implements Checksum {
         adler = updateImpl(buf, offset, byteCount, adler);
     }
 
+    /**
+     * Updates this checksum with the remaining bytes of {@code buffer}, advancing its position
+     * to its limit. The memory of a direct buffer, such as a {@link java.nio.MappedByteBuffer},
+     * is read in place.
+     *
+     * @hide
+     */
+    public void update(ByteBuffer buffer) {
+        int byteCount = buffer.remaining();
+        if (buffer.isDirect()) {
+            long address = NioUtils.getDirectBufferAddress(buffer) + buffer.position();
+            adler = updateAddressImpl(address, byteCount, adler);
+        } else if (buffer.hasArray()) {
+            adler = updateImpl(buffer.array(), buffer.arrayOffset() + buffer.position(), byteCount,
+                    adler);
+        } else {
+            adler = updateImpl(NioUtils.unsafeArray(buffer),
+                    NioUtils.unsafeArrayOffset(buffer) + buffer.position(), byteCount, adler);
+        }
+        buffer.position(buffer.limit());
+    }
+
+    /**
+     * Returns the Adler-32 checksum of two byte sequences concatenated, given {@code adler1},
+     * the checksum of the first, and {@code adler2}, the checksum of the second, which is
+     * {@code len2} bytes long.
+     *
+     * @hide
+     */
+    public static long combine(long adler1, long adler2, long len2) {
+        if (len2 < 0) {
+            throw new IllegalArgumentException("len2 < 0: " + len2);
+        }
+        return combineImpl(adler1, adler2, len2);
+    }
+
+    private static native long combineImpl(long adler1, long adler2, long len2);
+
     private native long updateImpl(byte[] buf, int offset, int byteCount, long adler1);
 
-    private native long updateByteImpl(int val, long adler1);
+    private static native long updateAddressImpl(long address, int byteCount, long adler1);
 }
@@ -17,6 +17,8 @@
 
 package java.util.zip;
 
+import java.nio.ByteBuffer;
+import java.nio.NioUtils;
 import java.util.Arrays;
 
 /**
@@ -25,6 +27,19 @@ import java.util.Arrays;
  */
 public class CRC32 implements Checksum {
 
+    // The byte-at-a-time table for the reflected gzip polynomial, so that update(int) needn't
+    // cross into native code for a single byte.
+    private static final int[] TABLE = new int[256];
+    static {
+        for (int i = 0; i < 256; ++i) {
+            int c = i;
+            for (int k = 0; k < 8; ++k) {
+                c = ((c & 1) != 0) ? (0xedb88320 ^ (c >>> 1)) : (c >>> 1);
+            }
+            TABLE[i] = c;
+        }
+    }
+
     private long crc = 0L;
 
     long tbytes = 0L;
@@ -53,7 +68,9 @@ public class CRC32 implements Checksum {
      *            represents the byte to update the checksum.
      */
     public void update(int val) {
-        crc = updateByteImpl((byte) val, crc);
+        int c = ~(int) crc;
+        c = TABLE[(c ^ val) & 0xff] ^ (c >>> 8);
+        crc = ~c & 0xffffffffL;
     }
 
     /**
@@ -76,7 +93,45 @@ public class CRC32 implements Checksum {
         crc = updateImpl(buf, offset, byteCount, crc);
     }
 
+    /**
+     * Updates this checksum with the remaining bytes of {@code buffer}, advancing its position
+     * to its limit. The memory of a direct buffer, such as a {@link java.nio.MappedByteBuffer},
+     * is read in place.
+     *
+     * @hide
+     */
+    public void update(ByteBuffer buffer) {
+        int byteCount = buffer.remaining();
+        if (buffer.isDirect()) {
+            long address = NioUtils.getDirectBufferAddress(buffer) + buffer.position();
+            crc = updateAddressImpl(address, byteCount, crc);
+        } else if (buffer.hasArray()) {
+            crc = updateImpl(buffer.array(), buffer.arrayOffset() + buffer.position(), byteCount, crc);
+        } else {
+            crc = updateImpl(NioUtils.unsafeArray(buffer),
+                    NioUtils.unsafeArrayOffset(buffer) + buffer.position(), byteCount, crc);
+        }
+        tbytes += byteCount;
+        buffer.position(buffer.limit());
+    }
+
+    /**
+     * Returns the CRC32 of two byte sequences concatenated, given {@code crc1}, the CRC32 of the
+     * first, and {@code crc2}, the CRC32 of the second, which is {@code len2} bytes long. This
+     * lets a long input be checksummed in independent pieces, for example on several threads.
+     *
+     * @hide
+     */
+    public static long combine(long crc1, long crc2, long len2) {
+        if (len2 < 0) {
+            throw new IllegalArgumentException("len2 < 0: " + len2);
+        }
+        return combineImpl(crc1, crc2, len2);
+    }
+
+    private static native long combineImpl(long crc1, long crc2, long len2);
+
     private native long updateImpl(byte[] buf, int offset, int byteCount, long crc1);
 
-    private native long updateByteImpl(byte val, long crc1);
+    private static native long updateAddressImpl(long address, int byteCount, long crc1);
 }
@@ -18,6 +18,9 @@
 package java.util.zip;
 
 import dalvik.system.CloseGuard;
+import java.nio.ByteBuffer;
+import java.nio.NioUtils;
+import java.nio.ReadOnlyBufferException;
 import java.util.Arrays;
 import libcore.util.EmptyArray;
 
@@ -146,7 +149,12 @@ public class Deflater {
 
     private long streamHandle = -1;
 
-    private byte[] inputBuffer;
+    // The byte[] or ByteBuffer most recently passed to setInput, or null before the first call.
+    // zlib may read a direct buffer's memory in place, so it must stay reachable until consumed.
+    private Object inputBuffer;
+
+    // The position of a ByteBuffer input when it was set; its position tracks inRead from there.
+    private int inputBufferStart;
 
     private int inRead;
 
@@ -238,11 +246,70 @@ public class Deflater {
         if (inputBuffer == null) {
             setInput(EmptyArray.BYTE);
         }
-        return deflateImpl(buf, offset, byteCount, streamHandle, flush);
+        return deflated(deflateImpl(buf, offset, byteCount, streamHandle, flush));
+    }
+
+    /**
+     * Deflates data (previously passed to {@link #setInput setInput}) into the remaining space
+     * of {@code output}, advancing its position by the number of bytes written. A direct
+     * buffer, including a {@link java.nio.MappedByteBuffer}, is written in place without an
+     * intermediate copy.
+     *
+     * @return the number of bytes of compressed data written to {@code output}.
+     * @throws ReadOnlyBufferException if {@code output} is read-only.
+     * @hide
+     */
+    public synchronized int deflate(ByteBuffer output) {
+        return deflateImpl(output, flushParm);
+    }
+
+    /**
+     * Like {@link #deflate(ByteBuffer)}, but with the flush mode {@code flush}, one of
+     * {@link #NO_FLUSH}, {@link #SYNC_FLUSH} or {@link #FULL_FLUSH}.
+     *
+     * @throws IllegalArgumentException if {@code flush} is invalid.
+     * @hide
+     */
+    public synchronized int deflate(ByteBuffer output, int flush) {
+        if (flush != NO_FLUSH && flush != SYNC_FLUSH && flush != FULL_FLUSH) {
+            throw new IllegalArgumentException("Bad flush value: " + flush);
+        }
+        return deflateImpl(output, flush);
+    }
+
+    private synchronized int deflateImpl(ByteBuffer output, int flush) {
+        if (output.isReadOnly()) {
+            throw new ReadOnlyBufferException();
+        }
+        checkOpen();
+        if (inputBuffer == null) {
+            setInput(EmptyArray.BYTE);
+        }
+        int result;
+        if (output.isDirect()) {
+            long address = NioUtils.getDirectBufferAddress(output) + output.position();
+            result = deflateAddressImpl(address, output.remaining(), streamHandle, flush);
+        } else {
+            result = deflateImpl(output.array(), output.arrayOffset() + output.position(),
+                    output.remaining(), streamHandle, flush);
+        }
+        if (result > 0) {
+            output.position(output.position() + result);
+        }
+        return deflated(result);
+    }
+
+    private int deflated(int result) {
+        if (inputBuffer instanceof ByteBuffer) {
+            ((ByteBuffer) inputBuffer).position(inputBufferStart + inRead);
+        }
+        return result;
     }
 
     private native int deflateImpl(byte[] buf, int offset, int byteCount, long handle, int flushParm);
 
+    private native int deflateAddressImpl(long address, int byteCount, long handle, int flushParm);
+
     /**
      * Frees all resources held onto by this deflating algorithm. Any unused
      * input or output is discarded. This method should be called explicitly in
@@ -409,10 +476,41 @@ public class Deflater {
         setInputImpl(buf, offset, byteCount, streamHandle);
     }
 
+    /**
+     * Sets the remaining bytes of {@code input} as the input to be compressed. Its position
+     * advances as they are consumed. The bytes of a direct buffer are read in place rather than
+     * copied, so they mustn't be modified until {@link #needsInput} returns true.
+     *
+     * @hide
+     */
+    public synchronized void setInput(ByteBuffer input) {
+        checkOpen();
+        int byteCount = input.remaining();
+        if (inputBuffer == null) {
+            setLevelsImpl(compressLevel, strategy, streamHandle);
+        }
+        if (input.isDirect()) {
+            long address = NioUtils.getDirectBufferAddress(input) + input.position();
+            setInputAddressImpl(address, byteCount, streamHandle);
+        } else if (input.hasArray()) {
+            setInputImpl(input.array(), input.arrayOffset() + input.position(), byteCount,
+                    streamHandle);
+        } else {
+            setInputImpl(NioUtils.unsafeArray(input),
+                    NioUtils.unsafeArrayOffset(input) + input.position(), byteCount, streamHandle);
+        }
+        inLength = byteCount;
+        inRead = 0;
+        inputBuffer = input;
+        inputBufferStart = input.position();
+    }
+
     private native void setLevelsImpl(int level, int strategy, long handle);
 
     private native void setInputImpl(byte[] buf, int offset, int byteCount, long handle);
 
+    private native void setInputAddressImpl(long address, int byteCount, long handle);
+
     /**
      * Sets the given <a href="#compression_level">compression level</a>
      * to be used when compressing data. This value must be set
@@ -19,6 +19,9 @@ package java.util.zip;
 
 import dalvik.system.CloseGuard;
 import java.io.FileDescriptor;
+import java.nio.ByteBuffer;
+import java.nio.NioUtils;
+import java.nio.ReadOnlyBufferException;
 import java.util.Arrays;
 
 /**
@@ -58,6 +61,12 @@ public class Inflater {
 
     private long streamHandle = -1;
 
+    // The buffer most recently passed to setInput(ByteBuffer), whose position tracks inRead, and
+    // its position at that time. zlib may read a direct buffer's memory in place, so we also
+    // keep it reachable for as long as it's the current input.
+    private ByteBuffer inputBuffer;
+    private int inputBufferStart;
+
     private final CloseGuard guard = CloseGuard.get();
 
     /**
@@ -96,6 +105,7 @@ public class Inflater {
             endImpl(streamHandle);
             inRead = 0;
             inLength = 0;
+            inputBuffer = null;
             streamHandle = -1;
         }
     }
@@ -235,6 +245,51 @@ public class Inflater {
         boolean neededDict = needsDictionary;
         needsDictionary = false;
         int result = inflateImpl(buf, offset, byteCount, streamHandle);
+        return inflated(result, neededDict);
+    }
+
+    /**
+     * Inflates bytes from the current input into the remaining space of {@code output},
+     * advancing its position by the number of bytes inflated. A direct buffer, including a
+     * {@link java.nio.MappedByteBuffer}, is written in place without an intermediate copy.
+     *
+     * @throws DataFormatException
+     *             if the underlying stream is corrupted or was not compressed
+     *             using a {@code Deflater}.
+     * @throws ReadOnlyBufferException if {@code output} is read-only.
+     * @return the number of bytes inflated.
+     * @hide
+     */
+    public synchronized int inflate(ByteBuffer output) throws DataFormatException {
+        if (output.isReadOnly()) {
+            throw new ReadOnlyBufferException();
+        }
+        checkOpen();
+
+        if (needsInput()) {
+            return 0;
+        }
+
+        boolean neededDict = needsDictionary;
+        needsDictionary = false;
+        int result;
+        if (output.isDirect()) {
+            long address = NioUtils.getDirectBufferAddress(output) + output.position();
+            result = inflateAddressImpl(address, output.remaining(), streamHandle);
+        } else {
+            result = inflateImpl(output.array(), output.arrayOffset() + output.position(),
+                    output.remaining(), streamHandle);
+        }
+        if (result > 0) {
+            output.position(output.position() + result);
+        }
+        return inflated(result, neededDict);
+    }
+
+    private int inflated(int result, boolean neededDict) throws DataFormatException {
+        if (inputBuffer != null) {
+            inputBuffer.position(inputBufferStart + inRead);
+        }
         if (needsDictionary && neededDict) {
             throw new DataFormatException("Needs dictionary");
         }
@@ -243,6 +298,8 @@ public class Inflater {
 
     private native int inflateImpl(byte[] buf, int offset, int byteCount, long handle);
 
+    private native int inflateAddressImpl(long address, int byteCount, long handle);
+
     /**
      * Returns true if the input bytes were compressed with a preset
      * dictionary. This method should be called if the first call to {@link #inflate} returns 0,
@@ -270,6 +327,7 @@ public class Inflater {
         finished = false;
         needsDictionary = false;
         inLength = inRead = 0;
+        inputBuffer = null;
         resetImpl(streamHandle);
     }
 
@@ -313,14 +371,45 @@ public class Inflater {
         Arrays.checkOffsetAndCount(buf.length, offset, byteCount);
         inRead = 0;
         inLength = byteCount;
+        inputBuffer = null;
         setInputImpl(buf, offset, byteCount, streamHandle);
     }
 
+    /**
+     * Sets the current input to the remaining bytes of {@code input}, whose position advances
+     * as they are inflated. The bytes of a direct buffer are read in place rather than copied,
+     * so they mustn't be modified until they have been consumed. This method should only be
+     * called if {@link #needsInput} returns {@code true}.
+     *
+     * @hide
+     */
+    public synchronized void setInput(ByteBuffer input) {
+        checkOpen();
+        int byteCount = input.remaining();
+        if (input.isDirect()) {
+            long address = NioUtils.getDirectBufferAddress(input) + input.position();
+            setInputAddressImpl(address, byteCount, streamHandle);
+        } else if (input.hasArray()) {
+            setInputImpl(input.array(), input.arrayOffset() + input.position(), byteCount,
+                    streamHandle);
+        } else {
+            setInputImpl(NioUtils.unsafeArray(input),
+                    NioUtils.unsafeArrayOffset(input) + input.position(), byteCount, streamHandle);
+        }
+        inRead = 0;
+        inLength = byteCount;
+        inputBuffer = input;
+        inputBufferStart = input.position();
+    }
+
     private native void setInputImpl(byte[] buf, int offset, int byteCount, long handle);
 
+    private native void setInputAddressImpl(long address, int byteCount, long handle);
+
     synchronized int setFileInput(FileDescriptor fd, long offset, int byteCount) {
         checkOpen();
         inRead = 0;
+        inputBuffer = null;
         inLength = setFileInputImpl(fd, offset, byteCount, streamHandle);
         return inLength;
     }
@@ -0,0 +1,325 @@
+/*
+ * Copyright (C) 2014 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+package java.util.zip;
+
+import dalvik.system.CloseGuard;
+import java.nio.ByteBuffer;
+import java.nio.NioUtils;
+import java.nio.ReadOnlyBufferException;
+import java.util.Arrays;
+
+/**
+ * Compresses data to the <a href="https://github.com/lz4/lz4/blob/dev/doc/lz4_Frame_format.md">
+ * LZ4 frame format</a>, which trades some of {@link Deflater}'s compression ratio for several
+ * times its speed, in both directions. The output can be read by {@link Lz4Decompressor} or the
+ * reference {@code lz4} tool.
+ *
+ * <p>This class is driven like {@code Deflater}: call {@link #setInput} whenever {@link
+ * #needsInput} returns true, then {@link #finish} once all the input has been given, and call
+ * {@link #compress} repeatedly until {@link #finished} returns true. Input is compressed in
+ * 64KiB blocks, so output only appears once a block is full, or when a flush is requested.
+ *
+ * @hide
+ */
+public final class Lz4Compressor {
+
+    private int inLength;
+
+    private int inRead; // Set by compressImpl.
+    private boolean finished; // Set by compressImpl.
+    private boolean pendingOutput; // Set by compressImpl.
+
+    private boolean finish;
+    private boolean started;
+
+    private long streamHandle = -1;
+
+    // The buffer most recently passed to setInput(ByteBuffer), whose position tracks inRead, and
+    // its position at that time. A direct buffer's memory is read in place, so we also keep it
+    // reachable for as long as it's the current input.
+    private ByteBuffer inputBuffer;
+    private int inputBufferStart;
+
+    private final CloseGuard guard = CloseGuard.get();
+
+    public Lz4Compressor() {
+        streamHandle = createStream();
+        guard.open("end");
+    }
+
+    private native long createStream();
+
+    /**
+     * Compresses as much input as possible into {@code buf}, returning the number of bytes
+     * written.
+     */
+    public int compress(byte[] buf) {
+        return compress(buf, 0, buf.length, false);
+    }
+
+    /**
+     * Compresses as much input as possible into {@code byteCount} bytes of {@code buf} starting
+     * at {@code offset}, returning the number of bytes written.
+     */
+    public int compress(byte[] buf, int offset, int byteCount) {
+        return compress(buf, offset, byteCount, false);
+    }
+
+    /**
+     * Like {@link #compress(byte[], int, int)}, but if {@code flush} is true, also writes out any
+     * input that doesn't yet fill a block, so that a recipient can decompress everything given
+     * so far. Flushing too often hurts the compression ratio.
+     */
+    public synchronized int compress(byte[] buf, int offset, int byteCount, boolean flush) {
+        Arrays.checkOffsetAndCount(buf.length, offset, byteCount);
+        checkOpen();
+        started = true;
+        int result = compressImpl(buf, offset, byteCount, streamHandle, flush, finish);
+        return compressed(result);
+    }
+
+    /**
+     * Compresses as much input as possible into the remaining space of {@code output},
+     * advancing its position by the number of bytes written. A direct buffer is written in
+     * place without an intermediate copy.
+     *
+     * @throws ReadOnlyBufferException if {@code output} is read-only.
+     */
+    public int compress(ByteBuffer output) {
+        return compress(output, false);
+    }
+
+    /**
+     * Like {@link #compress(ByteBuffer)}, with a flush as described for {@link
+     * #compress(byte[], int, int, boolean)}.
+     *
+     * @throws ReadOnlyBufferException if {@code output} is read-only.
+     */
+    public synchronized int compress(ByteBuffer output, boolean flush) {
+        if (output.isReadOnly()) {
+            throw new ReadOnlyBufferException();
+        }
+        checkOpen();
+        started = true;
+        int result;
+        if (output.isDirect()) {
+            long address = NioUtils.getDirectBufferAddress(output) + output.position();
+            result = compressAddressImpl(address, output.remaining(), streamHandle, flush, finish);
+        } else {
+            result = compressImpl(output.array(), output.arrayOffset() + output.position(),
+                    output.remaining(), streamHandle, flush, finish);
+        }
+        if (result > 0) {
+            output.position(output.position() + result);
+        }
+        return compressed(result);
+    }
+
+    private int compressed(int result) {
+        if (inputBuffer != null) {
+            inputBuffer.position(inputBufferStart + inRead);
+        }
+        return result;
+    }
+
+    private native int compressImpl(byte[] buf, int offset, int byteCount, long handle,
+            boolean flush, boolean finish);
+
+    private native int compressAddressImpl(long address, int byteCount, long handle,
+            boolean flush, boolean finish);
+
+    /**
+     * Releases the native resources associated with this compressor. After {@code end()} is
+     * called, other methods will typically throw {@code IllegalStateException}.
+     */
+    public synchronized void end() {
+        guard.close();
+        if (streamHandle != -1) {
+            endImpl(streamHandle);
+            inRead = 0;
+            inLength = 0;
+            inputBuffer = null;
+            streamHandle = -1;
+        }
+    }
+
+    private native void endImpl(long handle);
+
+    @Override protected void finalize() {
+        try {
+            if (guard != null) {
+                guard.warnIfOpen();
+            }
+            end();
+        } finally {
+            try {
+                super.finalize();
+            } catch (Throwable t) {
+                throw new AssertionError(t);
+            }
+        }
+    }
+
+    /**
+     * Indicates that all the input has been given, so that {@link #compress} will end the frame
+     * once it has compressed it.
+     */
+    public synchronized void finish() {
+        finish = true;
+    }
+
+    /**
+     * Returns true once the whole frame has been written out.
+     */
+    public synchronized boolean finished() {
+        return finished;
+    }
+
+    /**
+     * Returns the total number of bytes of input read by this compressor.
+     */
+    public synchronized long getBytesRead() {
+        checkOpen();
+        return getTotalInImpl(streamHandle);
+    }
+
+    private native long getTotalInImpl(long handle);
+
+    /**
+     * Returns the total number of bytes of output written by this compressor.
+     */
+    public synchronized long getBytesWritten() {
+        checkOpen();
+        return getTotalOutImpl(streamHandle);
+    }
+
+    private native long getTotalOutImpl(long handle);
+
+    /**
+     * Returns the number of bytes of the current input that have yet to be read.
+     */
+    public synchronized int getRemaining() {
+        return inLength - inRead;
+    }
+
+    /**
+     * Returns true if {@link #setInput} must be called before compression can continue: that
+     * is, if the current input has been read and all the output it produced written out.
+     */
+    public synchronized boolean needsInput() {
+        return inRead == inLength && !pendingOutput;
+    }
+
+    /**
+     * Resets this compressor to start a new frame, keeping its dictionary.
+     */
+    public synchronized void reset() {
+        checkOpen();
+        finish = false;
+        finished = false;
+        pendingOutput = false;
+        started = false;
+        inLength = inRead = 0;
+        inputBuffer = null;
+        resetImpl(streamHandle);
+    }
+
+    private native void resetImpl(long handle);
+
+    /**
+     * Sets the dictionary to compress against, which must also be given to the {@link
+     * Lz4Decompressor}. A dictionary of data like the input helps most when the input is
+     * small. Only the last 64KiB of the dictionary are used.
+     *
+     * @throws IllegalStateException if called after {@link #compress} (and before {@link
+     *     #reset}).
+     */
+    public synchronized void setDictionary(byte[] dictionary) {
+        setDictionary(dictionary, 0, dictionary.length);
+    }
+
+    /**
+     * Sets the dictionary to {@code byteCount} bytes of {@code dictionary} starting at {@code
+     * offset}. See {@link #setDictionary(byte[])}.
+     */
+    public synchronized void setDictionary(byte[] dictionary, int offset, int byteCount) {
+        checkOpen();
+        Arrays.checkOffsetAndCount(dictionary.length, offset, byteCount);
+        if (started) {
+            throw new IllegalStateException("setDictionary called after compress");
+        }
+        setDictionaryImpl(dictionary, offset, byteCount, streamHandle);
+    }
+
+    private native void setDictionaryImpl(byte[] dictionary, int offset, int byteCount, long handle);
+
+    /**
+     * Sets the input to be compressed. This method should only be called if {@link
+     * #needsInput} returns true.
+     */
+    public synchronized void setInput(byte[] buf) {
+        setInput(buf, 0, buf.length);
+    }
+
+    /**
+     * Sets the input to be compressed to {@code byteCount} bytes of {@code buf} starting at
+     * {@code offset}. This method should only be called if {@link #needsInput} returns true.
+     */
+    public synchronized void setInput(byte[] buf, int offset, int byteCount) {
+        checkOpen();
+        Arrays.checkOffsetAndCount(buf.length, offset, byteCount);
+        inRead = 0;
+        inLength = byteCount;
+        inputBuffer = null;
+        setInputImpl(buf, offset, byteCount, streamHandle);
+    }
+
+    /**
+     * Sets the input to the remaining bytes of {@code input}, whose position advances as they
+     * are read. The bytes of a direct buffer are read in place rather than copied, so they
+     * mustn't be modified until they have been read. This method should only be called if
+     * {@link #needsInput} returns true.
+     */
+    public synchronized void setInput(ByteBuffer input) {
+        checkOpen();
+        int byteCount = input.remaining();
+        if (input.isDirect()) {
+            long address = NioUtils.getDirectBufferAddress(input) + input.position();
+            setInputAddressImpl(address, byteCount, streamHandle);
+        } else if (input.hasArray()) {
+            setInputImpl(input.array(), input.arrayOffset() + input.position(), byteCount,
+                    streamHandle);
+        } else {
+            setInputImpl(NioUtils.unsafeArray(input),
+                    NioUtils.unsafeArrayOffset(input) + input.position(), byteCount, streamHandle);
+        }
+        inRead = 0;
+        inLength = byteCount;
+        inputBuffer = input;
+        inputBufferStart = input.position();
+    }
+
+    private native void setInputImpl(byte[] buf, int offset, int byteCount, long handle);
+
+    private native void setInputAddressImpl(long address, int byteCount, long handle);
+
+    private void checkOpen() {
+        if (streamHandle == -1) {
+            throw new IllegalStateException("attempt to use Lz4Compressor after calling end");
+        }
+    }
+}
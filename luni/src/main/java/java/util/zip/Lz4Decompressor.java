@@ -0,0 +1,302 @@
+/*
+ * Copyright (C) 2014 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+package java.util.zip;
+
+import dalvik.system.CloseGuard;
+import java.nio.ByteBuffer;
+import java.nio.NioUtils;
+import java.nio.ReadOnlyBufferException;
+import java.util.Arrays;
+
+/**
+ * Decompresses an <a href="https://github.com/lz4/lz4/blob/dev/doc/lz4_Frame_format.md">LZ4
+ * frame</a>, such as one written by {@link Lz4Compressor} or the reference {@code lz4} tool.
+ * Frames with linked or independent blocks, any block size, and block or content checksums
+ * are all supported; the checksums are verified.
+ *
+ * <p>This class is driven like {@link Inflater}: call {@link #setInput} whenever {@link
+ * #needsInput} returns true, and call {@link #decompress} repeatedly until {@link #finished}
+ * returns true. Any input after the end of the frame is left unread (see {@link
+ * #getRemaining}).
+ *
+ * @hide
+ */
+public final class Lz4Decompressor {
+
+    private int inLength;
+
+    private int inRead; // Set by decompressImpl.
+    private boolean finished; // Set by decompressImpl.
+    private boolean pendingOutput; // Set by decompressImpl.
+
+    private boolean started;
+
+    private long streamHandle = -1;
+
+    // The buffer most recently passed to setInput(ByteBuffer), whose position tracks inRead, and
+    // its position at that time. A direct buffer's memory is read in place, so we also keep it
+    // reachable for as long as it's the current input.
+    private ByteBuffer inputBuffer;
+    private int inputBufferStart;
+
+    private final CloseGuard guard = CloseGuard.get();
+
+    public Lz4Decompressor() {
+        streamHandle = createStream();
+        guard.open("end");
+    }
+
+    private native long createStream();
+
+    /**
+     * Decompresses as much input as possible into {@code buf}, returning the number of bytes
+     * written.
+     *
+     * @throws DataFormatException if the input isn't a valid LZ4 frame.
+     */
+    public int decompress(byte[] buf) throws DataFormatException {
+        return decompress(buf, 0, buf.length);
+    }
+
+    /**
+     * Decompresses as much input as possible into {@code byteCount} bytes of {@code buf}
+     * starting at {@code offset}, returning the number of bytes written.
+     *
+     * @throws DataFormatException if the input isn't a valid LZ4 frame.
+     */
+    public synchronized int decompress(byte[] buf, int offset, int byteCount)
+            throws DataFormatException {
+        Arrays.checkOffsetAndCount(buf.length, offset, byteCount);
+        checkOpen();
+        started = true;
+        int result = decompressImpl(buf, offset, byteCount, streamHandle);
+        return decompressed(result);
+    }
+
+    /**
+     * Decompresses as much input as possible into the remaining space of {@code output},
+     * advancing its position by the number of bytes written. A direct buffer is written in
+     * place without an intermediate copy.
+     *
+     * @throws DataFormatException if the input isn't a valid LZ4 frame.
+     * @throws ReadOnlyBufferException if {@code output} is read-only.
+     */
+    public synchronized int decompress(ByteBuffer output) throws DataFormatException {
+        if (output.isReadOnly()) {
+            throw new ReadOnlyBufferException();
+        }
+        checkOpen();
+        started = true;
+        int result;
+        if (output.isDirect()) {
+            long address = NioUtils.getDirectBufferAddress(output) + output.position();
+            result = decompressAddressImpl(address, output.remaining(), streamHandle);
+        } else {
+            result = decompressImpl(output.array(), output.arrayOffset() + output.position(),
+                    output.remaining(), streamHandle);
+        }
+        if (result > 0) {
+            output.position(output.position() + result);
+        }
+        return decompressed(result);
+    }
+
+    private int decompressed(int result) {
+        if (inputBuffer != null) {
+            inputBuffer.position(inputBufferStart + inRead);
+        }
+        return result;
+    }
+
+    private native int decompressImpl(byte[] buf, int offset, int byteCount, long handle)
+            throws DataFormatException;
+
+    private native int decompressAddressImpl(long address, int byteCount, long handle)
+            throws DataFormatException;
+
+    /**
+     * Releases the native resources associated with this decompressor. After {@code end()} is
+     * called, other methods will typically throw {@code IllegalStateException}.
+     */
+    public synchronized void end() {
+        guard.close();
+        if (streamHandle != -1) {
+            endImpl(streamHandle);
+            inRead = 0;
+            inLength = 0;
+            inputBuffer = null;
+            streamHandle = -1;
+        }
+    }
+
+    private native void endImpl(long handle);
+
+    @Override protected void finalize() {
+        try {
+            if (guard != null) {
+                guard.warnIfOpen();
+            }
+            end();
+        } finally {
+            try {
+                super.finalize();
+            } catch (Throwable t) {
+                throw new AssertionError(t);
+            }
+        }
+    }
+
+    /**
+     * Returns true once the whole frame has been read and its content written out.
+     */
+    public synchronized boolean finished() {
+        return finished;
+    }
+
+    /**
+     * Returns the total number of bytes of input read by this decompressor.
+     */
+    public synchronized long getBytesRead() {
+        checkOpen();
+        return getTotalInImpl(streamHandle);
+    }
+
+    private native long getTotalInImpl(long handle);
+
+    /**
+     * Returns the total number of bytes of output written by this decompressor.
+     */
+    public synchronized long getBytesWritten() {
+        checkOpen();
+        return getTotalOutImpl(streamHandle);
+    }
+
+    private native long getTotalOutImpl(long handle);
+
+    /**
+     * Returns the number of bytes of the current input that have yet to be read. Once {@link
+     * #finished} returns true, these are the bytes that followed the frame.
+     */
+    public synchronized int getRemaining() {
+        return inLength - inRead;
+    }
+
+    /**
+     * Returns true if {@link #setInput} must be called before decompression can continue: that
+     * is, if the current input has been read and all the output it produced written out.
+     */
+    public synchronized boolean needsInput() {
+        return inRead == inLength && !pendingOutput;
+    }
+
+    /**
+     * Resets this decompressor to read a new frame, keeping its dictionary.
+     */
+    public synchronized void reset() {
+        checkOpen();
+        finished = false;
+        pendingOutput = false;
+        started = false;
+        inLength = inRead = 0;
+        inputBuffer = null;
+        resetImpl(streamHandle);
+    }
+
+    private native void resetImpl(long handle);
+
+    /**
+     * Sets the dictionary the frame was compressed against. LZ4 frames don't say whether they
+     * need one, so this must be called before {@link #decompress} when they do.
+     *
+     * @throws IllegalStateException if called after {@link #decompress} (and before {@link
+     *     #reset}).
+     */
+    public synchronized void setDictionary(byte[] dictionary) {
+        setDictionary(dictionary, 0, dictionary.length);
+    }
+
+    /**
+     * Sets the dictionary to {@code byteCount} bytes of {@code dictionary} starting at {@code
+     * offset}. See {@link #setDictionary(byte[])}.
+     */
+    public synchronized void setDictionary(byte[] dictionary, int offset, int byteCount) {
+        checkOpen();
+        Arrays.checkOffsetAndCount(dictionary.length, offset, byteCount);
+        if (started) {
+            throw new IllegalStateException("setDictionary called after decompress");
+        }
+        setDictionaryImpl(dictionary, offset, byteCount, streamHandle);
+    }
+
+    private native void setDictionaryImpl(byte[] dictionary, int offset, int byteCount, long handle);
+
+    /**
+     * Sets the input to be decompressed. This method should only be called if {@link
+     * #needsInput} returns true.
+     */
+    public synchronized void setInput(byte[] buf) {
+        setInput(buf, 0, buf.length);
+    }
+
+    /**
+     * Sets the input to be decompressed to {@code byteCount} bytes of {@code buf} starting at
+     * {@code offset}. This method should only be called if {@link #needsInput} returns true.
+     */
+    public synchronized void setInput(byte[] buf, int offset, int byteCount) {
+        checkOpen();
+        Arrays.checkOffsetAndCount(buf.length, offset, byteCount);
+        inRead = 0;
+        inLength = byteCount;
+        inputBuffer = null;
+        setInputImpl(buf, offset, byteCount, streamHandle);
+    }
+
+    /**
+     * Sets the input to the remaining bytes of {@code input}, whose position advances as they
+     * are read. The bytes of a direct buffer are read in place rather than copied, so they
+     * mustn't be modified until they have been read. This method should only be called if
+     * {@link #needsInput} returns true.
+     */
+    public synchronized void setInput(ByteBuffer input) {
+        checkOpen();
+        int byteCount = input.remaining();
+        if (input.isDirect()) {
+            long address = NioUtils.getDirectBufferAddress(input) + input.position();
+            setInputAddressImpl(address, byteCount, streamHandle);
+        } else if (input.hasArray()) {
+            setInputImpl(input.array(), input.arrayOffset() + input.position(), byteCount,
+                    streamHandle);
+        } else {
+            setInputImpl(NioUtils.unsafeArray(input),
+                    NioUtils.unsafeArrayOffset(input) + input.position(), byteCount, streamHandle);
+        }
+        inRead = 0;
+        inLength = byteCount;
+        inputBuffer = input;
+        inputBufferStart = input.position();
+    }
+
+    private native void setInputImpl(byte[] buf, int offset, int byteCount, long handle);
+
+    private native void setInputAddressImpl(long address, int byteCount, long handle);
+
+    private void checkOpen() {
+        if (streamHandle == -1) {
+            throw new IllegalStateException("attempt to use Lz4Decompressor after calling end");
+        }
+    }
+}
@@ -0,0 +1,392 @@
+/*
+ * Copyright (C) 2014 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+package java.util.zip;
+
+import java.io.FilterOutputStream;
+import java.io.IOException;
+import java.io.InterruptedIOException;
+import java.io.OutputStream;
+import java.util.ArrayDeque;
+import java.util.ArrayList;
+import java.util.Arrays;
+import java.util.concurrent.Callable;
+import java.util.concurrent.ExecutionException;
+import java.util.concurrent.ExecutorService;
+import java.util.concurrent.Executors;
+import java.util.concurrent.Future;
+import java.util.concurrent.ThreadFactory;
+
+/**
+ * An output stream that compresses on several threads at once, in the manner of pigz. Input is
+ * cut into blocks that are deflated independently, each primed with the last 32KiB of the block
+ * before it as a preset dictionary so the compression ratio stays close to that of a single
+ * stream. Every block but the last ends on a {@link Deflater#SYNC_FLUSH} boundary, so the
+ * compressed blocks concatenate into one ordinary deflate stream, which this class wraps in a
+ * gzip or zlib header and trailer. The checksums of the blocks are computed in parallel too, and
+ * joined with {@link CRC32#combine} or {@link Adler32#combine}.
+ *
+ * <p>The output can be read by {@link GZIPInputStream}, {@link InflaterInputStream} or any
+ * other inflater. It is not byte-for-byte the output of {@link GZIPOutputStream}.
+ *
+ * @hide
+ */
+public final class ParallelDeflaterOutputStream extends FilterOutputStream {
+    /** Writes a bare deflate stream, as {@code new Deflater(level, true)} does. */
+    public static final int FORMAT_RAW = 0;
+
+    /** Writes a zlib stream, as {@code new Deflater(level)} does. */
+    public static final int FORMAT_ZLIB = 1;
+
+    /** Writes a gzip stream, as {@link GZIPOutputStream} does. */
+    public static final int FORMAT_GZIP = 2;
+
+    public static final int DEFAULT_BLOCK_SIZE = 128 * 1024;
+
+    // The size of deflate's window, and so the most of the previous block worth priming with.
+    private static final int DICTIONARY_SIZE = 32 * 1024;
+
+    private final int level;
+    private final int format;
+    private final int blockSize;
+    private final ExecutorService executor;
+
+    // Compressed-but-unwritten blocks, oldest first. We stop accepting input when there are
+    // this many, so memory use is bounded however fast the caller writes.
+    private final ArrayDeque<Future<Block>> pending = new ArrayDeque<Future<Block>>();
+    private final int maxPending;
+
+    // Deflaters not currently in use by a worker.
+    private final ArrayList<Deflater> idleDeflaters = new ArrayList<Deflater>();
+
+    private byte[] buffer;
+    private int count;
+    private byte[] previousBlock;
+    private int previousBlockLength;
+
+    private long checksum;
+    private long totalIn;
+    private boolean finished;
+    private boolean closed;
+
+    /**
+     * Constructs a stream that writes a gzip stream at the default compression level to
+     * {@code os}, using one thread per available processor.
+     */
+    public ParallelDeflaterOutputStream(OutputStream os) throws IOException {
+        this(os, Deflater.DEFAULT_COMPRESSION, FORMAT_GZIP,
+                Runtime.getRuntime().availableProcessors(), DEFAULT_BLOCK_SIZE);
+    }
+
+    /**
+     * Constructs a stream that writes {@code format} to {@code os} at compression level
+     * {@code level}, compressing blocks of {@code blockSize} bytes on {@code threadCount}
+     * threads.
+     */
+    public ParallelDeflaterOutputStream(OutputStream os, int level, int format, int threadCount,
+            int blockSize) throws IOException {
+        super(os);
+        if (os == null) {
+            throw new NullPointerException("os == null");
+        }
+        if (level < Deflater.DEFAULT_COMPRESSION || level > Deflater.BEST_COMPRESSION) {
+            throw new IllegalArgumentException("Bad level: " + level);
+        }
+        if (format != FORMAT_RAW && format != FORMAT_ZLIB && format != FORMAT_GZIP) {
+            throw new IllegalArgumentException("Bad format: " + format);
+        }
+        if (threadCount < 1) {
+            throw new IllegalArgumentException("threadCount < 1: " + threadCount);
+        }
+        if (blockSize < DICTIONARY_SIZE) {
+            throw new IllegalArgumentException("blockSize < " + DICTIONARY_SIZE + ": " + blockSize);
+        }
+        this.level = level;
+        this.format = format;
+        this.blockSize = blockSize;
+        this.maxPending = 2 * threadCount;
+        this.executor = Executors.newFixedThreadPool(threadCount, new ThreadFactory() {
+            @Override public Thread newThread(Runnable r) {
+                Thread thread = new Thread(r, "ParallelDeflater");
+                thread.setDaemon(true);
+                return thread;
+            }
+        });
+        this.buffer = new byte[blockSize];
+        this.checksum = (format == FORMAT_ZLIB) ? 1 : 0;
+        writeHeader();
+    }
+
+    @Override public void write(int oneByte) throws IOException {
+        write(new byte[] { (byte) oneByte }, 0, 1);
+    }
+
+    @Override public void write(byte[] b, int off, int len) throws IOException {
+        checkNotFinished();
+        Arrays.checkOffsetAndCount(b.length, off, len);
+        while (len > 0) {
+            int n = Math.min(len, blockSize - count);
+            System.arraycopy(b, off, buffer, count, n);
+            count += n;
+            off += n;
+            len -= n;
+            if (count == blockSize) {
+                submit(false);
+            }
+        }
+    }
+
+    /**
+     * Writes all buffered input as compressed data, waiting for the workers to catch up. The
+     * stream stays usable; each flush ends a block early, so flushing often costs compression.
+     */
+    @Override public void flush() throws IOException {
+        checkNotFinished();
+        if (count > 0) {
+            submit(false);
+        }
+        while (!pending.isEmpty()) {
+            writeOldest();
+        }
+        out.flush();
+    }
+
+    /**
+     * Writes the remaining compressed data and the trailer, without closing the underlying
+     * stream, and stops the worker threads.
+     */
+    public void finish() throws IOException {
+        if (finished) {
+            return;
+        }
+        try {
+            submit(true);
+            while (!pending.isEmpty()) {
+                writeOldest();
+            }
+            writeTrailer();
+        } finally {
+            finished = true;
+            shutDown();
+        }
+    }
+
+    @Override public void close() throws IOException {
+        if (closed) {
+            return;
+        }
+        closed = true;
+        Throwable thrown = null;
+        try {
+            finish();
+        } catch (Throwable t) {
+            thrown = t;
+        }
+        try {
+            out.close();
+        } catch (Throwable t) {
+            if (thrown == null) {
+                thrown = t;
+            }
+        }
+        if (thrown != null) {
+            if (thrown instanceof IOException) {
+                throw (IOException) thrown;
+            }
+            throw new IOException(thrown);
+        }
+    }
+
+    private void checkNotFinished() throws IOException {
+        if (finished) {
+            throw new IOException("Stream finished");
+        }
+    }
+
+    private void submit(boolean last) throws IOException {
+        if (pending.size() >= maxPending) {
+            writeOldest();
+        }
+        final Block block = new Block(buffer, count, previousBlock, previousBlockLength, last);
+        pending.add(executor.submit(block));
+        totalIn += count;
+        // The block keeps its input, which becomes the next block's dictionary, so it can't be
+        // reused for more input.
+        previousBlock = buffer;
+        previousBlockLength = count;
+        buffer = new byte[blockSize];
+        count = 0;
+    }
+
+    private void writeOldest() throws IOException {
+        Block block;
+        try {
+            block = pending.remove().get();
+        } catch (InterruptedException e) {
+            throw new InterruptedIOException();
+        } catch (ExecutionException e) {
+            throw new IOException("Compression failed", e.getCause());
+        }
+        out.write(block.output, 0, block.outputLength);
+        if (format == FORMAT_GZIP) {
+            checksum = CRC32.combine(checksum, block.inputChecksum, block.inputLength);
+        } else if (format == FORMAT_ZLIB) {
+            checksum = Adler32.combine(checksum, block.inputChecksum, block.inputLength);
+        }
+    }
+
+    private void writeHeader() throws IOException {
+        if (format == FORMAT_GZIP) {
+            out.write(new byte[] {
+                (byte) GZIPInputStream.GZIP_MAGIC, (byte) (GZIPInputStream.GZIP_MAGIC >> 8),
+                Deflater.DEFLATED, 0, // flags
+                0, 0, 0, 0, // mod time
+                0, // extra flags
+                0, // operating system
+            });
+        } else if (format == FORMAT_ZLIB) {
+            // RFC 1950: CM 8 with a 32KiB window, then FLEVEL and the FCHECK bits that make the
+            // pair a multiple of 31.
+            int cmf = 0x78;
+            int flevel;
+            if (level == Deflater.DEFAULT_COMPRESSION || level == 6) {
+                flevel = 2;
+            } else if (level < 2) {
+                flevel = 0;
+            } else if (level < 6) {
+                flevel = 1;
+            } else {
+                flevel = 3;
+            }
+            int flg = flevel << 6;
+            flg += 31 - ((cmf << 8) + flg) % 31;
+            out.write(new byte[] { (byte) cmf, (byte) flg });
+        }
+    }
+
+    private void writeTrailer() throws IOException {
+        if (format == FORMAT_GZIP) {
+            int crc = (int) checksum;
+            int size = (int) totalIn;
+            out.write(new byte[] {
+                (byte) crc, (byte) (crc >> 8), (byte) (crc >> 16), (byte) (crc >> 24),
+                (byte) size, (byte) (size >> 8), (byte) (size >> 16), (byte) (size >> 24),
+            });
+        } else if (format == FORMAT_ZLIB) {
+            int adler = (int) checksum;
+            out.write(new byte[] {
+                (byte) (adler >> 24), (byte) (adler >> 16), (byte) (adler >> 8), (byte) adler,
+            });
+        }
+    }
+
+    private void shutDown() {
+        executor.shutdownNow();
+        synchronized (idleDeflaters) {
+            for (Deflater deflater : idleDeflaters) {
+                deflater.end();
+            }
+            idleDeflaters.clear();
+        }
+    }
+
+    private Deflater takeDeflater() {
+        synchronized (idleDeflaters) {
+            if (!idleDeflaters.isEmpty()) {
+                return idleDeflaters.remove(idleDeflaters.size() - 1);
+            }
+        }
+        return new Deflater(level, true);
+    }
+
+    private void returnDeflater(Deflater deflater) {
+        deflater.reset();
+        synchronized (idleDeflaters) {
+            if (!finished) {
+                idleDeflaters.add(deflater);
+                return;
+            }
+        }
+        deflater.end();
+    }
+
+    /**
+     * One block of input, compressed on a worker thread to a run of raw deflate data that ends
+     * on a byte boundary (or, for the last block, at the end of the stream).
+     */
+    private final class Block implements Callable<Block> {
+        private final byte[] input;
+        private final int inputLength;
+        private final byte[] dictionary;
+        private final int dictionaryLength;
+        private final boolean last;
+
+        byte[] output;
+        int outputLength;
+        long inputChecksum;
+
+        Block(byte[] input, int inputLength, byte[] dictionary, int dictionaryLength,
+                boolean last) {
+            this.input = input;
+            this.inputLength = inputLength;
+            this.dictionary = dictionary;
+            this.dictionaryLength = dictionaryLength;
+            this.last = last;
+        }
+
+        @Override public Block call() {
+            if (format == FORMAT_GZIP) {
+                CRC32 crc = new CRC32();
+                crc.update(input, 0, inputLength);
+                inputChecksum = crc.getValue();
+            } else if (format == FORMAT_ZLIB) {
+                Adler32 adler = new Adler32();
+                adler.update(input, 0, inputLength);
+                inputChecksum = adler.getValue();
+            }
+
+            Deflater deflater = takeDeflater();
+            try {
+                if (dictionary != null) {
+                    int n = Math.min(dictionaryLength, DICTIONARY_SIZE);
+                    deflater.setDictionary(dictionary, dictionaryLength - n, n);
+                }
+                deflater.setInput(input, 0, inputLength);
+                if (last) {
+                    deflater.finish();
+                }
+                output = new byte[Math.max(64, inputLength + (inputLength >> 3))];
+                while (true) {
+                    int available = output.length - outputLength;
+                    int n = last
+                            ? deflater.deflate(output, outputLength, available)
+                            : deflater.deflate(output, outputLength, available, Deflater.SYNC_FLUSH);
+                    outputLength += n;
+                    // A flush is complete once deflate returns with output space to spare.
+                    if (last ? deflater.finished() : n < available) {
+                        break;
+                    }
+                    if (outputLength == output.length) {
+                        output = Arrays.copyOf(output, output.length * 2);
+                    }
+                }
+            } finally {
+                returnDeflater(deflater);
+            }
+            return this;
+        }
+    }
+}
@@ -17,6 +17,7 @@
 
 package java.util.zip;
 
+import android.system.ErrnoException;
 import dalvik.system.CloseGuard;
 import java.io.BufferedInputStream;
 import java.io.Closeable;
@@ -33,6 +34,7 @@ import java.util.LinkedHashMap;
 import libcore.io.BufferIterator;
 import libcore.io.HeapBufferIterator;
 import libcore.io.IoUtils;
+import libcore.io.Libcore;
 import libcore.io.Streams;
 
 /**
@@ -486,19 +488,23 @@ public class ZipFile implements Closeable, ZipConstants {
         }
 
         @Override public int read(byte[] buffer, int byteOffset, int byteCount) throws IOException {
-            synchronized (sharedRaf) {
-                final long length = endOffset - offset;
-                if (byteCount > length) {
-                    byteCount = (int) length;
-                }
-                sharedRaf.seek(offset);
-                int count = sharedRaf.read(buffer, byteOffset, byteCount);
-                if (count > 0) {
-                    offset += count;
-                    return count;
-                } else {
-                    return -1;
-                }
+            // pread(2) leaves the file offset alone, so streams sharing the file needn't
+            // serialize on it.
+            final long length = endOffset - offset;
+            if (byteCount > length) {
+                byteCount = (int) length;
+            }
+            int count;
+            try {
+                count = Libcore.os.pread(sharedRaf.getFD(), buffer, byteOffset, byteCount, offset);
+            } catch (ErrnoException errnoException) {
+                throw errnoException.rethrowAsIOException();
+            }
+            if (count > 0) {
+                offset += count;
+                return count;
+            } else {
+                return -1;
             }
         }
 
@@ -511,14 +517,10 @@ public class ZipFile implements Closeable, ZipConstants {
         }
 
         public int fill(Inflater inflater, int nativeEndBufSize) throws IOException {
-            synchronized (sharedRaf) {
-                int len = Math.min((int) (endOffset - offset), nativeEndBufSize);
-                int cnt = inflater.setFileInput(sharedRaf.getFD(), offset, nativeEndBufSize);
-                // setFileInput read from the file, so we need to get the OS and RAFStream back
-                // in sync...
-                skip(cnt);
-                return len;
-            }
+            int len = Math.min((int) (endOffset - offset), nativeEndBufSize);
+            int cnt = inflater.setFileInput(sharedRaf.getFD(), offset, nativeEndBufSize);
+            skip(cnt);
+            return len;
         }
     }
 
@@ -0,0 +1,62 @@
+/*
+ * Copyright (C) 2014 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+package java.util.zip;
+
+/**
+ * Controls the process-wide cache of zlib streams behind {@link Inflater} and {@link Deflater}.
+ * Ending an inflater or deflater resets its native stream and keeps it for the next one of the
+ * same kind (inflate or deflate, with or without a zlib header), saving the allocation and
+ * initialization of zlib's window and hash tables. Each of the four kinds keeps at most
+ * {@link #getCapacity} streams; an idle deflate stream holds about 256KiB and an inflate
+ * stream about 40KiB.
+ *
+ * <p>Only streams that are ended, explicitly or by finalization, are recycled.
+ *
+ * @hide
+ */
+public final class ZipStreamPool {
+    private ZipStreamPool() {
+    }
+
+    /**
+     * Returns the most idle streams kept for each kind.
+     */
+    public static native int getCapacity();
+
+    /**
+     * Sets the most idle streams kept for each kind, freeing any idle streams beyond the new
+     * limit. Zero disables pooling.
+     */
+    public static void setCapacity(int capacity) {
+        if (capacity < 0) {
+            throw new IllegalArgumentException("capacity < 0: " + capacity);
+        }
+        setCapacityImpl(capacity);
+    }
+
+    /**
+     * Returns how many inflaters and deflaters have been created with a pooled stream.
+     */
+    public static native long getHitCount();
+
+    /**
+     * Returns how many inflaters and deflaters have had to initialize a new stream.
+     */
+    public static native long getMissCount();
+
+    private static native void setCapacityImpl(int capacity);
+}
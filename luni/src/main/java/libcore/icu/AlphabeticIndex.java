@@ -17,12 +17,17 @@
 package libcore.icu;
 
 import java.util.Locale;
+import libcore.util.NativeRegistration;
 
 /**
  * Exposes icu4c's AlphabeticIndex.
  */
 public final class AlphabeticIndex {
 
+  static {
+    NativeRegistration.ensureRegistered("libcore/icu/AlphabeticIndex");
+  }
+
   /**
    * Exposes icu4c's ImmutableIndex (new to icu 51). This exposes a read-only,
    * thread safe snapshot view of an AlphabeticIndex at the moment it was
@@ -60,6 +65,16 @@ public final class AlphabeticIndex {
       return getBucketIndex(peer, s);
     }
 
+    /**
+     * Stores the index of the bucket in which 'names[i]' should appear in 'out[i]'. This is
+     * equivalent to calling getBucketIndex for each name, but without a JNI transition for
+     * each one.
+     */
+    public void getBucketIndices(String[] names, int[] out) {
+      checkBucketIndicesArrays(names, out);
+      getBucketIndices(peer, names, out);
+    }
+
     /**
      * Returns the label for the bucket at the given index (as returned by getBucketIndex).
      */
@@ -69,6 +84,7 @@ public final class AlphabeticIndex {
 
     private static native int getBucketCount(long peer);
     private static native int getBucketIndex(long peer, String s);
+    private static native void getBucketIndices(long peer, String[] names, int[] out);
     private static native String getBucketLabel(long peer, int index);
   }
 
@@ -144,6 +160,35 @@ public final class AlphabeticIndex {
     return getBucketIndex(peer, s);
   }
 
+  /**
+   * Stores the index of the bucket in which 'names[i]' should appear in 'out[i]'. This is
+   * equivalent to calling getBucketIndex for each name, but without a JNI transition for each
+   * one.
+   */
+  public void getBucketIndices(String[] names, int[] out) {
+    getBucketIndices(names, out, 1);
+  }
+
+  /**
+   * Like getBucketIndices(String[], int[]), but splits the work across up to 'threadCount'
+   * native threads (including the caller's), each with its own ImmutableIndex snapshot. Large
+   * arrays only: each thread is given at least a thousand or so names.
+   */
+  public synchronized void getBucketIndices(String[] names, int[] out, int threadCount) {
+    checkBucketIndicesArrays(names, out);
+    if (threadCount < 1) {
+      throw new IllegalArgumentException("threadCount < 1: " + threadCount);
+    }
+    getBucketIndices(peer, names, out, threadCount);
+  }
+
+  private static void checkBucketIndicesArrays(String[] names, int[] out) {
+    if (out.length < names.length) {
+      throw new IllegalArgumentException("out.length " + out.length + " < names.length " +
+                                         names.length);
+    }
+  }
+
   /**
    * Returns the label for the bucket at the given index (as returned by getBucketIndex).
    */
@@ -166,6 +211,8 @@ public final class AlphabeticIndex {
   private static native void addLabelRange(long peer, int codePointStart, int codePointEnd);
   private static native int getBucketCount(long peer);
   private static native int getBucketIndex(long peer, String s);
+  private static native void getBucketIndices(long peer, String[] names, int[] out,
+                                              int threadCount);
   private static native String getBucketLabel(long peer, int index);
   private static native long buildImmutableIndex(long peer);
 }
@@ -16,16 +16,22 @@
 
 package libcore.icu;
 
+import java.util.Arrays;
 import java.util.Calendar;
 import java.util.Locale;
 import java.util.TimeZone;
 import libcore.util.BasicLruCache;
+import libcore.util.NativeRegistration;
 
 /**
  * Exposes icu4c's DateIntervalFormat.
  */
 public final class DateIntervalFormat {
 
+  static {
+    NativeRegistration.ensureRegistered("libcore/icu/DateIntervalFormat");
+  }
+
   // These are all public API in DateUtils. There are others, but they're either for use with
   // other methods (like FORMAT_ABBREV_RELATIVE), don't internationalize (like FORMAT_CAP_AMPM),
   // or have never been implemented anyway.
@@ -74,15 +80,73 @@ public final class DateIntervalFormat {
   // This is our slightly more sensible internal API. (A truly sane replacement would take a
   // skeleton instead of int flags.)
   public static String formatDateRange(Locale locale, TimeZone tz, long startMs, long endMs, int flags) {
+    long[] endMsHolder = { endMs };
+    String skeleton = toSkeleton(tz, startMs, endMsHolder, 0, flags);
+    synchronized (CACHED_FORMATTERS) {
+      return formatDateInterval(getFormatter(skeleton, locale.toString(), tz.getID()), startMs, endMsHolder[0]);
+    }
+  }
+
+  /**
+   * Formats each range [startMs[i], endMs[i]] as formatDateRange would, in as few native calls
+   * as the formatter cache allows.
+   */
+  public static String[] formatDateRanges(Locale locale, TimeZone tz, long[] startMs, long[] endMs, int flags) {
+    if (startMs.length != endMs.length) {
+      throw new IllegalArgumentException("startMs.length=" + startMs.length + " endMs.length=" + endMs.length);
+    }
+    String localeName = locale.toString();
+    String tzName = tz.getID();
+    int count = startMs.length;
+    long[] ends = endMs.clone();
+    String[] skeletons = new String[count];
+    for (int i = 0; i < count; ++i) {
+      skeletons[i] = toSkeleton(tz, startMs[i], ends, i, flags);
+    }
+
+    String[] result = new String[count];
+    long[] addresses = new long[count];
+    synchronized (CACHED_FORMATTERS) {
+      // Creating a formatter can evict (and destroy) another, so format everything collected
+      // so far before each cache miss.
+      int formatted = 0;
+      for (int i = 0; i < count; ++i) {
+        String key = skeletons[i] + "\t" + localeName + "\t" + tzName;
+        Long formatter = CACHED_FORMATTERS.get(key);
+        if (formatter == null) {
+          formatted = formatPending(addresses, startMs, ends, formatted, i, result);
+          formatter = createDateIntervalFormat(skeletons[i], localeName, tzName);
+          CACHED_FORMATTERS.put(key, formatter);
+        }
+        addresses[i] = formatter;
+      }
+      formatPending(addresses, startMs, ends, formatted, count, result);
+    }
+    return result;
+  }
+
+  // Formats the ranges in [start, end) into 'result', and returns 'end'.
+  private static int formatPending(long[] addresses, long[] startMs, long[] endMs, int start, int end, String[] result) {
+    if (start < end) {
+      String[] formatted = formatDateIntervals(Arrays.copyOfRange(addresses, start, end),
+          Arrays.copyOfRange(startMs, start, end), Arrays.copyOfRange(endMs, start, end));
+      System.arraycopy(formatted, 0, result, start, formatted.length);
+    }
+    return end;
+  }
+
+  // Returns the skeleton for the range [startMs, endMs[index]]. If the range shouldn't count
+  // the day that starts at its end, this also moves endMs[index] back a day.
+  private static String toSkeleton(TimeZone tz, long startMs, long[] endMs, int index, int flags) {
     Calendar startCalendar = Calendar.getInstance(tz);
     startCalendar.setTimeInMillis(startMs);
 
     Calendar endCalendar;
-    if (startMs == endMs) {
+    if (startMs == endMs[index]) {
       endCalendar = startCalendar;
     } else {
       endCalendar = Calendar.getInstance(tz);
-      endCalendar.setTimeInMillis(endMs);
+      endCalendar.setTimeInMillis(endMs[index]);
     }
 
     boolean endsAtMidnight = isMidnight(endCalendar);
@@ -91,16 +155,13 @@ public final class DateIntervalFormat {
     // end time is midnight, fudge the end date so we don't count the day that's about to start.
     // This is not the behavior of icu4c's DateIntervalFormat, but it's the historical behavior
     // of Android's DateUtils.formatDateRange.
-    if (startMs != endMs && endsAtMidnight &&
+    if (startMs != endMs[index] && endsAtMidnight &&
         ((flags & FORMAT_SHOW_TIME) == 0 || dayDistance(startCalendar, endCalendar) <= 1)) {
       endCalendar.roll(Calendar.DAY_OF_MONTH, false);
-      endMs -= DAY_IN_MS;
+      endMs[index] -= DAY_IN_MS;
     }
 
-    String skeleton = toSkeleton(startCalendar, endCalendar, flags);
-    synchronized (CACHED_FORMATTERS) {
-      return formatDateInterval(getFormatter(skeleton, locale.toString(), tz.getID()), startMs, endMs);
-    }
+    return toSkeleton(startCalendar, endCalendar, flags);
   }
 
   private static long getFormatter(String skeleton, String localeName, String tzName) {
@@ -236,4 +297,5 @@ public final class DateIntervalFormat {
   private static native long createDateIntervalFormat(String skeleton, String localeName, String tzName);
   private static native void destroyDateIntervalFormat(long address);
   private static native String formatDateInterval(long address, long fromDate, long toDate);
+  private static native String[] formatDateIntervals(long[] addresses, long[] fromDates, long[] toDates);
 }
@@ -24,11 +24,16 @@ import java.util.Locale;
 import java.util.Map;
 import java.util.Set;
 import libcore.util.BasicLruCache;
+import libcore.util.NativeRegistration;
 
 /**
  * Makes ICU data accessible to Java.
  */
 public final class ICU {
+  static {
+    NativeRegistration.ensureRegistered("libcore/icu/ICU");
+  }
+
   private static final BasicLruCache<String, String> CACHED_PATTERNS =
       new BasicLruCache<String, String>(8);
 
@@ -19,6 +19,7 @@ package libcore.icu;
 import java.text.DateFormat;
 import java.util.Arrays;
 import java.util.HashMap;
+import java.util.List;
 import java.util.Locale;
 import libcore.util.Objects;
 
@@ -32,6 +33,11 @@ import libcore.util.Objects;
 public final class LocaleData {
     // A cache for the locale-specific data.
     private static final HashMap<String, LocaleData> localeDataCache = new HashMap<String, LocaleData>();
+
+    // Locales that differ only in region usually have identical month names, weekday names
+    // and so on, so cached LocaleData instances share equal arrays. Guarded by localeDataCache.
+    private static final HashMap<List<String>, String[]> sharedArrays =
+            new HashMap<List<String>, String[]>();
     static {
         // Ensure that we pull in the locale data for the root locale, en_US, and the
         // user's default locale. (All devices must support the root locale and en_US,
@@ -145,11 +151,42 @@ public final class LocaleData {
             if (localeData != null) {
                 return localeData;
             }
+            newLocaleData.shareArrays();
             localeDataCache.put(languageTag, newLocaleData);
             return newLocaleData;
         }
     }
 
+    private static String[] share(String[] array) {
+        if (array == null) {
+            return null;
+        }
+        List<String> key = Arrays.asList(array);
+        String[] shared = sharedArrays.get(key);
+        if (shared == null) {
+            sharedArrays.put(key, array);
+            return array;
+        }
+        return shared;
+    }
+
+    private void shareArrays() {
+        amPm = share(amPm);
+        eras = share(eras);
+        longMonthNames = share(longMonthNames);
+        shortMonthNames = share(shortMonthNames);
+        tinyMonthNames = share(tinyMonthNames);
+        longStandAloneMonthNames = share(longStandAloneMonthNames);
+        shortStandAloneMonthNames = share(shortStandAloneMonthNames);
+        tinyStandAloneMonthNames = share(tinyStandAloneMonthNames);
+        longWeekdayNames = share(longWeekdayNames);
+        shortWeekdayNames = share(shortWeekdayNames);
+        tinyWeekdayNames = share(tinyWeekdayNames);
+        longStandAloneWeekdayNames = share(longStandAloneWeekdayNames);
+        shortStandAloneWeekdayNames = share(shortStandAloneWeekdayNames);
+        tinyStandAloneWeekdayNames = share(tinyStandAloneWeekdayNames);
+    }
+
     @Override public String toString() {
         return Objects.toString(this);
     }
@@ -19,8 +19,13 @@ package libcore.icu;
 import java.text.CharacterIterator;
 import java.text.StringCharacterIterator;
 import java.util.Locale;
+import libcore.util.NativeRegistration;
 
 public final class NativeBreakIterator implements Cloneable {
+    static {
+        NativeRegistration.ensureRegistered("libcore/icu/NativeBreakIterator");
+    }
+
     // Acceptable values for the 'type' field.
     private static final int BI_CHAR_INSTANCE = 1;
     private static final int BI_WORD_INSTANCE = 2;
@@ -89,6 +94,15 @@ public final class NativeBreakIterator implements Cloneable {
         return followingImpl(this.address, this.string, offset);
     }
 
+    /**
+     * Writes the boundaries at or after {@code from} to {@code boundaries}, in order, until
+     * the array is full or there are no more boundaries. Returns the number written. The
+     * iterator is left at the last boundary written.
+     */
+    public int boundaries(int from, int[] boundaries) {
+        return boundariesImpl(this.address, this.string, from, boundaries);
+    }
+
     public CharacterIterator getText() {
         int newLocation = currentImpl(this.address, this.string);
         this.charIterator.setIndex(newLocation);
@@ -173,5 +187,6 @@ public final class NativeBreakIterator implements Cloneable {
     private static synchronized native int currentImpl(long address, String text);
     private static synchronized native int firstImpl(long address, String text);
     private static synchronized native int followingImpl(long address, String text, int offset);
+    private static synchronized native int boundariesImpl(long address, String text, int from, int[] boundaries);
     private static synchronized native int lastImpl(long address, String text);
 }
@@ -11,6 +11,7 @@
 package libcore.icu;
 
 import java.util.Locale;
+import libcore.util.NativeRegistration;
 
 /**
 * Package static class for declaring all native methods for collation use.
@@ -18,6 +19,10 @@ import java.util.Locale;
 * @internal ICU 2.4
 */
 public final class NativeCollation {
+    static {
+        NativeRegistration.ensureRegistered("libcore/icu/NativeCollation");
+    }
+
     private NativeCollation() {
     }
 
@@ -28,6 +33,7 @@ public final class NativeCollation {
     public static native long getCollationElementIterator(long address, String source);
     public static native String getRules(long address);
     public static native byte[] getSortKey(long address, String source);
+    public static native byte[] getSortKeys(long address, String[] sources, int[] offsets);
     public static long openCollator(Locale locale) {
       return openCollator(locale.toLanguageTag());
     }
@@ -35,6 +41,7 @@ public final class NativeCollation {
     public static native long openCollatorFromRules(String rules, int normalizationMode, int collationStrength);
     public static native long safeClone(long address);
     public static native void setAttribute(long address, int type, int value);
+    public static native int[] sortIndices(long address, String[] strings);
 
     // CollationElementIterator.
     public static native void closeElements(long address);
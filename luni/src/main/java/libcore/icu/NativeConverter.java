@@ -13,8 +13,13 @@ import java.nio.charset.Charset;
 import java.nio.charset.CharsetDecoder;
 import java.nio.charset.CharsetEncoder;
 import java.nio.charset.CodingErrorAction;
+import libcore.util.NativeRegistration;
 
 public final class NativeConverter {
+    static {
+        NativeRegistration.ensureRegistered("libcore/icu/NativeConverter");
+    }
+
     public static native int decode(long converterHandle, byte[] input, int inEnd,
             char[] output, int outEnd, int[] data, boolean flush);
 
@@ -27,8 +27,13 @@ import java.text.Format;
 import java.text.NumberFormat;
 import java.text.ParsePosition;
 import java.util.Currency;
+import libcore.util.NativeRegistration;
 
 public final class NativeDecimalFormat implements Cloneable {
+    static {
+        NativeRegistration.ensureRegistered("libcore/icu/NativeDecimalFormat");
+    }
+
     /**
      * Constants corresponding to the native type UNumberFormatSymbol, for setSymbol.
      */
@@ -316,6 +321,32 @@ public final class NativeDecimalFormat implements Cloneable {
         return result;
     }
 
+    /**
+     * Formats all of {@code values} in one native call. The result is the formatted numbers
+     * concatenated; number {@code i} is the chars from {@code offsets[i]} to
+     * {@code offsets[i + 1]}, so {@code offsets.length} must be {@code values.length + 1}.
+     */
+    public char[] formatDoubles(double[] values, int[] offsets) {
+        return formatDoubles(this.address, values, offsets);
+    }
+
+    /**
+     * Like {@link #formatDoubles}, but for longs.
+     */
+    public char[] formatLongs(long[] values, int[] offsets) {
+        return formatLongs(this.address, values, offsets);
+    }
+
+    /**
+     * The inverse of {@link #formatDoubles}: parses number {@code i} from the chars of
+     * {@code text} between {@code offsets[i]} and {@code offsets[i + 1]} into
+     * {@code values[i]}. Stops at the first number that doesn't parse or that has
+     * trailing chars, and returns the number of values parsed.
+     */
+    public int parseDoubles(char[] text, int[] offsets, double[] values) {
+        return parseDoubles(this.address, text, offsets, values);
+    }
+
     private static void updateFieldPosition(FieldPosition fp, FieldPositionIterator fpi) {
         int field = translateFieldId(fp);
         if (field != -1) {
@@ -621,6 +652,8 @@ public final class NativeDecimalFormat implements Cloneable {
     private static native char[] formatLong(long addr, long value, FieldPositionIterator iter);
     private static native char[] formatDouble(long addr, double value, FieldPositionIterator iter);
     private static native char[] formatDigitList(long addr, String value, FieldPositionIterator iter);
+    private static native char[] formatDoubles(long addr, double[] values, int[] offsets);
+    private static native char[] formatLongs(long addr, long[] values, int[] offsets);
     private static native int getAttribute(long addr, int symbol);
     private static native String getTextAttribute(long addr, int symbol);
     private static native long open(String pattern, String currencySymbol,
@@ -629,6 +662,7 @@ public final class NativeDecimalFormat implements Cloneable {
             char monetaryDecimalSeparator, String nan, char patternSeparator, char percent,
             char perMill, char zeroDigit);
     private static native Number parse(long addr, String string, ParsePosition position, boolean parseBigDecimal);
+    private static native int parseDoubles(long addr, char[] text, int[] offsets, double[] values);
     private static native void setDecimalFormatSymbols(long addr, String currencySymbol,
             char decimalSeparator, char digit, String exponentSeparator, char groupingSeparator,
             String infinity, String internationalCurrencySymbol, String minusSign,
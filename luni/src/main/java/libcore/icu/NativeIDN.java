@@ -16,7 +16,13 @@
 
 package libcore.icu;
 
+import libcore.util.NativeRegistration;
+
 public final class NativeIDN {
+    static {
+        NativeRegistration.ensureRegistered("libcore/icu/NativeIDN");
+    }
+
     public static String toASCII(String s, int flags) {
         return convert(s, flags, true);
     }
@@ -32,6 +38,26 @@ public final class NativeIDN {
         }
     }
 
+    /**
+     * Converts each of 'strings' as toASCII would, throwing for the first that can't be.
+     */
+    public static String[] toASCII(String[] strings, int flags) {
+        if (strings == null) {
+            throw new NullPointerException("strings == null");
+        }
+        return convertAllImpl(strings, flags, true);
+    }
+
+    /**
+     * Converts each of 'strings' as toUnicode would, so any that can't be are returned as is.
+     */
+    public static String[] toUnicode(String[] strings, int flags) {
+        if (strings == null) {
+            throw new NullPointerException("strings == null");
+        }
+        return convertAllImpl(strings, flags, false);
+    }
+
     private static String convert(String s, int flags, boolean toAscii) {
         if (s == null) {
             throw new NullPointerException("s == null");
@@ -39,6 +65,7 @@ public final class NativeIDN {
         return convertImpl(s, flags, toAscii);
     }
     private static native String convertImpl(String s, int flags, boolean toAscii);
+    private static native String[] convertAllImpl(String[] strings, int flags, boolean toAscii);
 
     private NativeIDN() {}
 }
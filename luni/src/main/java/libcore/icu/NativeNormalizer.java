@@ -17,8 +17,13 @@
 package libcore.icu;
 
 import java.text.Normalizer.Form;
+import libcore.util.NativeRegistration;
 
 public final class NativeNormalizer {
+    static {
+        NativeRegistration.ensureRegistered("libcore/icu/NativeNormalizer");
+    }
+
     public static boolean isNormalized(CharSequence src, Form form) {
         return isNormalizedImpl(src.toString(), toUNormalizationMode(form));
     }
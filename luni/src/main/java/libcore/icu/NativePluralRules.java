@@ -17,6 +17,7 @@
 package libcore.icu;
 
 import java.util.Locale;
+import libcore.util.NativeRegistration;
 
 /**
  * Provides access to ICU's
@@ -25,6 +26,10 @@ import java.util.Locale;
  * ease localization of strings to languages with complex grammatical rules regarding number.
  */
 public final class NativePluralRules {
+    static {
+        NativeRegistration.ensureRegistered("libcore/icu/NativePluralRules");
+    }
+
     public static final int ZERO  = 0;
     public static final int ONE   = 1;
     public static final int TWO   = 2;
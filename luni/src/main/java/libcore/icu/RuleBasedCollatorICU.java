@@ -13,6 +13,7 @@ package libcore.icu;
 import java.text.CharacterIterator;
 import java.text.CollationKey;
 import java.text.ParseException;
+import java.util.Arrays;
 import java.util.Locale;
 
 public final class RuleBasedCollatorICU implements Cloneable {
@@ -102,6 +103,34 @@ public final class RuleBasedCollatorICU implements Cloneable {
         return new CollationKeyICU(source, key);
     }
 
+    /**
+     * Returns the collation key of each of {@code sources}, all computed in one native call.
+     * Unlike {@link #getCollationKey}, null sources are not allowed.
+     */
+    public CollationKey[] getCollationKeys(String[] sources) {
+        int[] offsets = new int[sources.length + 1];
+        byte[] keys = NativeCollation.getSortKeys(address, sources, offsets);
+        CollationKey[] result = new CollationKey[sources.length];
+        for (int i = 0; i < sources.length; ++i) {
+            result[i] = new CollationKeyICU(sources[i],
+                    Arrays.copyOfRange(keys, offsets[i], offsets[i + 1]));
+        }
+        return result;
+    }
+
+    /**
+     * Sorts {@code strings} into collation order, stably. This gives the same result as
+     * {@code Arrays.sort(strings, collator)}, but generates each sort key once and does all
+     * the comparisons natively.
+     */
+    public void sort(String[] strings) {
+        int[] order = NativeCollation.sortIndices(address, strings);
+        String[] unsorted = strings.clone();
+        for (int i = 0; i < order.length; ++i) {
+            strings[i] = unsorted[order[i]];
+        }
+    }
+
     public String getRules() {
         return NativeCollation.getRules(address);
     }
@@ -23,12 +23,17 @@ import java.util.HashMap;
 import java.util.Locale;
 import java.util.TimeZone;
 import libcore.util.BasicLruCache;
+import libcore.util.NativeRegistration;
 import libcore.util.ZoneInfoDB;
 
 /**
  * Provides access to ICU's time zone name data.
  */
 public final class TimeZoneNames {
+    static {
+        NativeRegistration.ensureRegistered("libcore/icu/TimeZoneNames");
+    }
+
     private static final String[] availableTimeZoneIds = TimeZone.getAvailableIDs();
 
     /*
@@ -41,7 +46,29 @@ public final class TimeZoneNames {
     public static final int SHORT_NAME_DST = 4;
     public static final int NAME_COUNT = 5;
 
+    // Filling in every zone's names is slow, so big tables are split between this many threads.
+    private static final int FILL_THREAD_COUNT =
+            Math.min(4, Runtime.getRuntime().availableProcessors());
+    private static final int MIN_ROWS_PER_FILL_THREAD = 64;
+
+    // False while this class is being initialized. Worker threads can't call our static natives
+    // until initialization finishes, so the tables warmed by the static initializer below must
+    // be filled on the initializing thread alone.
+    private static boolean initialized;
+
     private static final ZoneStringsCache cachedZoneStrings = new ZoneStringsCache();
+
+    // Single rows looked up by getDisplayNames, keyed by locale and id separated by a tab.
+    private static final BasicLruCache<String, String[]> cachedZoneRows =
+            new BasicLruCache<String, String[]>(64) {
+        @Override protected String[] create(String key) {
+            int tab = key.indexOf('\t');
+            String[][] rows = new String[1][NAME_COUNT];
+            rows[0][OLSON_NAME] = key.substring(tab + 1);
+            fillZoneStrings(key.substring(0, tab), rows, 0, 1);
+            return rows[0];
+        }
+    };
     static {
         // Ensure that we pull in the zone strings for the root locale, en_US, and the
         // user's default locale. (All devices must support the root locale and en_US,
@@ -50,6 +77,7 @@ public final class TimeZoneNames {
         cachedZoneStrings.get(Locale.ROOT);
         cachedZoneStrings.get(Locale.US);
         cachedZoneStrings.get(Locale.getDefault());
+        initialized = true;
     }
 
     public static class ZoneStringsCache extends BasicLruCache<Locale, String[][]> {
@@ -67,7 +95,7 @@ public final class TimeZoneNames {
             }
 
             long nativeStart = System.currentTimeMillis();
-            fillZoneStrings(locale.toString(), result);
+            fillZoneStrings(locale.toString(), result, FILL_THREAD_COUNT);
             long nativeEnd = System.currentTimeMillis();
 
             internStrings(result);
@@ -99,6 +127,63 @@ public final class TimeZoneNames {
         }
     }
 
+    // Fills in 'result' using up to 'threadCount' threads (including this one), each of which
+    // takes a contiguous range of rows. Always uses just this thread during class initialization.
+    private static void fillZoneStrings(final String localeName, final String[][] result,
+            int threadCount) {
+        threadCount = Math.min(threadCount, result.length / MIN_ROWS_PER_FILL_THREAD);
+        if (!initialized) {
+            threadCount = 1;
+        }
+        if (threadCount <= 1) {
+            fillZoneStrings(localeName, result, 0, result.length);
+            return;
+        }
+
+        final int rowsPerThread = (result.length + threadCount - 1) / threadCount;
+        final Throwable[] failures = new Throwable[threadCount];
+        Thread[] threads = new Thread[threadCount];
+        for (int i = 1; i < threadCount; ++i) {
+            final int index = i;
+            threads[i] = new Thread("TimeZoneNames") {
+                @Override public void run() {
+                    try {
+                        int start = index * rowsPerThread;
+                        fillZoneStrings(localeName, result, start,
+                                Math.min(start + rowsPerThread, result.length));
+                    } catch (Throwable t) {
+                        failures[index] = t;
+                    }
+                }
+            };
+            threads[i].setDaemon(true);
+            threads[i].start();
+        }
+        fillZoneStrings(localeName, result, 0, rowsPerThread);
+
+        boolean interrupted = false;
+        for (int i = 1; i < threadCount; ++i) {
+            while (true) {
+                try {
+                    threads[i].join();
+                    break;
+                } catch (InterruptedException e) {
+                    interrupted = true;
+                }
+            }
+        }
+        if (interrupted) {
+            Thread.currentThread().interrupt();
+        }
+        for (Throwable failure : failures) {
+            if (failure instanceof RuntimeException) {
+                throw (RuntimeException) failure;
+            } else if (failure instanceof Error) {
+                throw (Error) failure;
+            }
+        }
+    }
+
     private static final Comparator<String[]> ZONE_STRINGS_COMPARATOR = new Comparator<String[]>() {
         public int compare(String[] lhs, String[] rhs) {
             return lhs[OLSON_NAME].compareTo(rhs[OLSON_NAME]);
@@ -124,6 +209,58 @@ public final class TimeZoneNames {
         return null;
     }
 
+    /**
+     * Returns the names of the zone 'id' in 'locale', as a row of the array returned by
+     * getZoneStrings, or null if 'id' isn't a known zone. Unlike getZoneStrings, this doesn't
+     * load the names of every zone if they're not already loaded. The result must not be
+     * modified.
+     */
+    public static String[] getDisplayNames(Locale locale, String id) {
+        if (locale == null) {
+            locale = Locale.getDefault();
+        }
+        String[][] zoneStrings = cachedZoneStrings.getIfCached(locale);
+        if (zoneStrings != null) {
+            int index = Arrays.binarySearch(zoneStrings, new String[] { id },
+                    ZONE_STRINGS_COMPARATOR);
+            return (index >= 0) ? zoneStrings[index] : null;
+        }
+        if (Arrays.binarySearch(availableTimeZoneIds, id) < 0) {
+            return null;
+        }
+        return cachedZoneRows.get(locale.toString() + "\t" + id);
+    }
+
+    /**
+     * Returns the appropriate name of the zone 'id' in 'locale', or null. Like getDisplayNames,
+     * this doesn't load the names of every zone.
+     */
+    public static String getDisplayName(Locale locale, String id, boolean daylight, int style) {
+        String[] row = getDisplayNames(locale, id);
+        if (row == null) {
+            return null;
+        }
+        if (daylight) {
+            return (style == TimeZone.LONG) ? row[LONG_NAME_DST] : row[SHORT_NAME_DST];
+        } else {
+            return (style == TimeZone.LONG) ? row[LONG_NAME] : row[SHORT_NAME];
+        }
+    }
+
+    /**
+     * Starts loading the names of every zone in 'locale' on a background thread, so that a
+     * later getZoneStrings for that locale doesn't have to wait as long.
+     */
+    public static void prewarmZoneStrings(final Locale locale) {
+        Thread thread = new Thread("TimeZoneNames prewarm") {
+            @Override public void run() {
+                getZoneStrings(locale);
+            }
+        };
+        thread.setDaemon(true);
+        thread.start();
+    }
+
     /**
      * Returns an array of time zone strings, as used by DateFormatSymbols.getZoneStrings.
      */
@@ -159,5 +296,5 @@ public final class TimeZoneNames {
 
     public static native String getExemplarLocation(String locale, String tz);
 
-    private static native void fillZoneStrings(String locale, String[][] result);
+    private static native void fillZoneStrings(String locale, String[][] result, int start, int end);
 }
@@ -16,10 +16,16 @@
 
 package libcore.icu;
 
+import libcore.util.NativeRegistration;
+
 /**
  * Exposes icu4c's Transliterator.
  */
 public final class Transliterator {
+  static {
+    NativeRegistration.ensureRegistered("libcore/icu/Transliterator");
+  }
+
   private long peer;
 
   /**
@@ -50,7 +56,18 @@ public final class Transliterator {
     return transliterate(peer, s);
   }
 
+  /**
+   * Transliterates each of the specified strings, returning the results in a new array.
+   */
+  public String[] transliterate(String[] strings) {
+    if (strings == null) {
+      throw new NullPointerException("strings == null");
+    }
+    return transliterateAll(peer, strings);
+  }
+
   private static native long create(String id);
   private static native void destroy(long peer);
   private static native String transliterate(long peer, String s);
+  private static native String[] transliterateAll(long peer, String[] strings);
 }
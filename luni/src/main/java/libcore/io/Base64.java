@@ -21,12 +21,24 @@
 
 package libcore.io;
 
+import java.nio.BufferOverflowException;
+import java.nio.ByteBuffer;
+import java.nio.NioUtils;
+import java.nio.ReadOnlyBufferException;
 import java.nio.charset.StandardCharsets;
+import java.util.Arrays;
 import libcore.util.EmptyArray;
 
 /**
  * <a href="http://www.ietf.org/rfc/rfc2045.txt">Base64</a> encoder/decoder.
  * In violation of the RFC, this encoder doesn't wrap lines at 76 columns.
+ *
+ * <p>The work is done natively, with SIMD kernels where the CPU has them.
+ *
+ * <p>Decoding is lenient by default: spaces, tabs, CRs and LFs are ignored, trailing padding is
+ * optional, and an unpadded incomplete final group is dropped. Strict decoding accepts only
+ * canonical RFC 4648 input: a multiple of four characters with no whitespace, at most two
+ * padding characters at the end, and the unused bits of a final partial group zero.
  */
 public final class Base64 {
     private Base64() {
@@ -36,126 +48,143 @@ public final class Base64 {
         return decode(in, in.length);
     }
 
+    /**
+     * Leniently decodes the first {@code len} bytes of {@code in}. Returns null if they
+     * contain anything but Base64 characters, padding and whitespace.
+     */
     public static byte[] decode(byte[] in, int len) {
+        Arrays.checkOffsetAndCount(in.length, 0, len);
         // approximate output length
         int length = len / 4 * 3;
         // return an empty array on empty or short input without padding
         if (length == 0) {
             return EmptyArray.BYTE;
         }
-        // temporary array
-        byte[] out = new byte[length];
-        // number of padding characters ('=')
-        int pad = 0;
-        byte chr;
-        // compute the number of the padding characters
-        // and adjust the length of the input
-        for (;;len--) {
-            chr = in[len-1];
-            // skip the neutral characters
-            if ((chr == '\n') || (chr == '\r') ||
-                    (chr == ' ') || (chr == '\t')) {
-                continue;
-            }
-            if (chr == '=') {
-                pad++;
-            } else {
-                break;
-            }
+        return decode(in, 0, len, length, false);
+    }
+
+    /**
+     * Strictly decodes {@code length} bytes of {@code in} starting at {@code offset}. Returns
+     * null if they aren't canonical Base64.
+     */
+    public static byte[] decodeStrict(byte[] in, int offset, int length) {
+        Arrays.checkOffsetAndCount(in.length, offset, length);
+        return decode(in, offset, length, length / 4 * 3, true);
+    }
+
+    private static byte[] decode(byte[] in, int offset, int length, int capacity, boolean strict) {
+        byte[] out = new byte[capacity];
+        int byteCount = decode(in, offset, length, out, 0, capacity, strict);
+        if (byteCount == -1) {
+            return null;
         }
-        // index in the output array
-        int outIndex = 0;
-        // index in the input array
-        int inIndex = 0;
-        // holds the value of the input character
-        int bits = 0;
-        // holds the value of the input quantum
-        int quantum = 0;
-        for (int i=0; i<len; i++) {
-            chr = in[i];
-            // skip the neutral characters
-            if ((chr == '\n') || (chr == '\r') ||
-                    (chr == ' ') || (chr == '\t')) {
-                continue;
-            }
-            if ((chr >= 'A') && (chr <= 'Z')) {
-                // char ASCII value
-                //  A    65    0
-                //  Z    90    25 (ASCII - 65)
-                bits = chr - 65;
-            } else if ((chr >= 'a') && (chr <= 'z')) {
-                // char ASCII value
-                //  a    97    26
-                //  z    122   51 (ASCII - 71)
-                bits = chr - 71;
-            } else if ((chr >= '0') && (chr <= '9')) {
-                // char ASCII value
-                //  0    48    52
-                //  9    57    61 (ASCII + 4)
-                bits = chr + 4;
-            } else if (chr == '+') {
-                bits = 62;
-            } else if (chr == '/') {
-                bits = 63;
-            } else {
-                return null;
-            }
-            // append the value to the quantum
-            quantum = (quantum << 6) | (byte) bits;
-            if (inIndex%4 == 3) {
-                // 4 characters were read, so make the output:
-                out[outIndex++] = (byte) (quantum >> 16);
-                out[outIndex++] = (byte) (quantum >> 8);
-                out[outIndex++] = (byte) quantum;
+        return (byteCount == capacity) ? out : Arrays.copyOf(out, byteCount);
+    }
+
+    /**
+     * Decodes the remaining bytes of {@code in} to {@code out}, which must have room for
+     * {@code in.remaining() / 4 * 3} bytes. On success, advances both buffers' positions and
+     * returns the number of bytes decoded. If the input is malformed, returns -1 and leaves the
+     * positions alone, though bytes after {@code out}'s position may have been overwritten.
+     * Direct buffers are read and written in place.
+     *
+     * @throws BufferOverflowException if {@code out} may be too small.
+     * @throws ReadOnlyBufferException if {@code out} is read-only.
+     */
+    public static int decode(ByteBuffer in, ByteBuffer out, boolean strict) {
+        int length = in.remaining();
+        int capacity = length / 4 * 3;
+        checkWritable(out, capacity);
+        int byteCount;
+        if (in.isDirect() && out.isDirect()) {
+            byteCount = decodeDirect(address(in), length, address(out), capacity, strict);
+        } else if (!in.isDirect() && !out.isDirect()) {
+            byteCount = decode(array(in), arrayOffset(in), length, array(out), arrayOffset(out),
+                    capacity, strict);
+        } else {
+            byte[] src = new byte[length];
+            in.duplicate().get(src);
+            byte[] dst = new byte[capacity];
+            byteCount = decode(src, 0, length, dst, 0, capacity, strict);
+            if (byteCount != -1) {
+                out.duplicate().put(dst, 0, byteCount);
             }
-            inIndex++;
         }
-        if (pad > 0) {
-            // adjust the quantum value according to the padding
-            quantum = quantum << (6*pad);
-            // make output
-            out[outIndex++] = (byte) (quantum >> 16);
-            if (pad == 1) {
-                out[outIndex++] = (byte) (quantum >> 8);
-            }
+        if (byteCount != -1) {
+            in.position(in.limit());
+            out.position(out.position() + byteCount);
         }
-        // create the resulting array
-        byte[] result = new byte[outIndex];
-        System.arraycopy(out, 0, result, 0, outIndex);
-        return result;
+        return byteCount;
     }
 
-    private static final byte[] map = new byte[]
-        {'A', 'B', 'C', 'D', 'E', 'F', 'G', 'H', 'I', 'J', 'K', 'L', 'M', 'N',
-         'O', 'P', 'Q', 'R', 'S', 'T', 'U', 'V', 'W', 'X', 'Y', 'Z', 'a', 'b',
-         'c', 'd', 'e', 'f', 'g', 'h', 'i', 'j', 'k', 'l', 'm', 'n', 'o', 'p',
-         'q', 'r', 's', 't', 'u', 'v', 'w', 'x', 'y', 'z', '0', '1', '2', '3',
-         '4', '5', '6', '7', '8', '9', '+', '/'};
-
     public static String encode(byte[] in) {
-        int length = (in.length + 2) * 4 / 3;
-        byte[] out = new byte[length];
-        int index = 0, end = in.length - in.length % 3;
-        for (int i = 0; i < end; i += 3) {
-            out[index++] = map[(in[i] & 0xff) >> 2];
-            out[index++] = map[((in[i] & 0x03) << 4) | ((in[i+1] & 0xff) >> 4)];
-            out[index++] = map[((in[i+1] & 0x0f) << 2) | ((in[i+2] & 0xff) >> 6)];
-            out[index++] = map[(in[i+2] & 0x3f)];
+        byte[] out = new byte[encodedLength(in.length)];
+        int index = encode(in, 0, in.length, out, 0);
+        return new String(out, 0, index, StandardCharsets.US_ASCII);
+    }
+
+    /**
+     * Encodes the remaining bytes of {@code in} to {@code out}, advancing both buffers'
+     * positions. Returns the number of bytes written, which is always
+     * {@code (in.remaining() + 2) / 3 * 4}. Direct buffers are read and written in place.
+     *
+     * @throws BufferOverflowException if {@code out} is too small.
+     * @throws ReadOnlyBufferException if {@code out} is read-only.
+     */
+    public static int encode(ByteBuffer in, ByteBuffer out) {
+        int length = in.remaining();
+        int byteCount = encodedLength(length);
+        checkWritable(out, byteCount);
+        if (in.isDirect() && out.isDirect()) {
+            encodeDirect(address(in), length, address(out));
+        } else if (!in.isDirect() && !out.isDirect()) {
+            encode(array(in), arrayOffset(in), length, array(out), arrayOffset(out));
+        } else {
+            byte[] src = new byte[length];
+            in.duplicate().get(src);
+            byte[] dst = new byte[byteCount];
+            encode(src, 0, length, dst, 0);
+            out.duplicate().put(dst);
         }
-        switch (in.length % 3) {
-            case 1:
-                out[index++] = map[(in[end] & 0xff) >> 2];
-                out[index++] = map[(in[end] & 0x03) << 4];
-                out[index++] = '=';
-                out[index++] = '=';
-                break;
-            case 2:
-                out[index++] = map[(in[end] & 0xff) >> 2];
-                out[index++] = map[((in[end] & 0x03) << 4) | ((in[end+1] & 0xff) >> 4)];
-                out[index++] = map[((in[end+1] & 0x0f) << 2)];
-                out[index++] = '=';
-                break;
+        in.position(in.limit());
+        out.position(out.position() + byteCount);
+        return byteCount;
+    }
+
+    private static int encodedLength(int length) {
+        // Computed in long arithmetic so very large inputs fail cleanly in the allocation.
+        long result = ((long) length + 2) / 3 * 4;
+        if (result > Integer.MAX_VALUE) {
+            throw new OutOfMemoryError("Base64 encoding of " + length + " bytes is too long");
+        }
+        return (int) result;
+    }
+
+    private static void checkWritable(ByteBuffer out, int byteCount) {
+        if (out.isReadOnly()) {
+            throw new ReadOnlyBufferException();
+        }
+        if (out.remaining() < byteCount) {
+            throw new BufferOverflowException();
         }
-        return new String(out, 0, index, StandardCharsets.US_ASCII);
     }
+
+    private static long address(ByteBuffer b) {
+        return NioUtils.getDirectBufferAddress(b) + b.position();
+    }
+
+    private static byte[] array(ByteBuffer b) {
+        return NioUtils.unsafeArray(b);
+    }
+
+    private static int arrayOffset(ByteBuffer b) {
+        return NioUtils.unsafeArrayOffset(b) + b.position();
+    }
+
+    // These trust their callers to have checked the bounds, and that 'dst' has room for the
+    // encoded length or 'capacity' bytes respectively. The decoders return -1 for bad input.
+    private static native int encode(byte[] src, int offset, int length, byte[] dst, int dstOffset);
+    private static native int encodeDirect(long srcAddress, int length, long dstAddress);
+    private static native int decode(byte[] src, int offset, int length, byte[] dst, int dstOffset, int capacity, boolean strict);
+    private static native int decodeDirect(long srcAddress, int length, long dstAddress, int capacity, boolean strict);
 }
@@ -63,6 +63,35 @@ public class BlockGuardOs extends ForwardingOs {
         return tagSocket(os.accept(fd, peerAddress));
     }
 
+    @Override public int acceptMany(FileDescriptor fd, int[] fds, byte[] peerAddresses, int flags) throws ErrnoException, SocketException {
+        BlockGuard.getThreadPolicy().onNetwork();
+        int count = os.acceptMany(fd, fds, peerAddresses, flags);
+        // Tag the new sockets just as accept would.
+        FileDescriptor tmp = new FileDescriptor();
+        for (int i = 0; i < count; ++i) {
+            tmp.setInt$(fds[i]);
+            tagSocket(tmp);
+        }
+        return count;
+    }
+
+    @Override public FileDescriptor acceptPacked(FileDescriptor fd, byte[] peerAddress) throws ErrnoException, SocketException {
+        BlockGuard.getThreadPolicy().onNetwork();
+        return tagSocket(os.acceptPacked(fd, peerAddress));
+    }
+
+    @Override public int acceptErrno(FileDescriptor fd, byte[] peerAddress, int flags) throws InterruptedIOException, SocketException {
+        BlockGuard.getThreadPolicy().onNetwork();
+        int clientFd = os.acceptErrno(fd, peerAddress, flags);
+        if (clientFd >= 0) {
+            // Tag the new socket just as accept would.
+            FileDescriptor tmp = new FileDescriptor();
+            tmp.setInt$(clientFd);
+            SocketTagger.get().tag(tmp);
+        }
+        return clientFd;
+    }
+
     @Override public boolean access(String path, int mode) throws ErrnoException {
         BlockGuard.getThreadPolicy().onReadFromDisk();
         return os.access(path, mode);
@@ -110,6 +139,11 @@ public class BlockGuardOs extends ForwardingOs {
         os.connect(fd, address, port);
     }
 
+    @Override public int connectErrno(FileDescriptor fd, InetAddress address, int port) throws InterruptedIOException, SocketException {
+        BlockGuard.getThreadPolicy().onNetwork();
+        return os.connectErrno(fd, address, port);
+    }
+
     @Override public void fchmod(FileDescriptor fd, int mode) throws ErrnoException {
         BlockGuard.getThreadPolicy().onWriteToDisk();
         os.fchmod(fd, mode);
@@ -229,6 +263,22 @@ public class BlockGuardOs extends ForwardingOs {
         return os.read(fd, bytes, byteOffset, byteCount);
     }
 
+    @Override public int readErrno(FileDescriptor fd, ByteBuffer buffer) throws InterruptedIOException {
+        BlockGuard.getThreadPolicy().onReadFromDisk();
+        return os.readErrno(fd, buffer);
+    }
+
+    @Override public int readErrno(FileDescriptor fd, byte[] bytes, int byteOffset, int byteCount) throws InterruptedIOException {
+        BlockGuard.getThreadPolicy().onReadFromDisk();
+        return os.readErrno(fd, bytes, byteOffset, byteCount);
+    }
+
+    @Override public void readahead(FileDescriptor fd, long offset, long byteCount) throws ErrnoException {
+        // readahead(2) blocks until the data has been read into the page cache.
+        BlockGuard.getThreadPolicy().onReadFromDisk();
+        os.readahead(fd, offset, byteCount);
+    }
+
     @Override public String readlink(String path) throws ErrnoException {
       BlockGuard.getThreadPolicy().onReadFromDisk();
       return os.readlink(path);
@@ -249,6 +299,31 @@ public class BlockGuardOs extends ForwardingOs {
         return os.recvfrom(fd, bytes, byteOffset, byteCount, flags, srcAddress);
     }
 
+    @Override public int recvfromPacked(FileDescriptor fd, ByteBuffer buffer, int flags, byte[] srcAddress) throws ErrnoException, SocketException {
+        BlockGuard.getThreadPolicy().onNetwork();
+        return os.recvfromPacked(fd, buffer, flags, srcAddress);
+    }
+
+    @Override public int recvfromPacked(FileDescriptor fd, byte[] bytes, int byteOffset, int byteCount, int flags, byte[] srcAddress) throws ErrnoException, SocketException {
+        BlockGuard.getThreadPolicy().onNetwork();
+        return os.recvfromPacked(fd, bytes, byteOffset, byteCount, flags, srcAddress);
+    }
+
+    @Override public int recvfromErrno(FileDescriptor fd, ByteBuffer buffer, int flags, byte[] srcAddress) throws InterruptedIOException, SocketException {
+        BlockGuard.getThreadPolicy().onNetwork();
+        return os.recvfromErrno(fd, buffer, flags, srcAddress);
+    }
+
+    @Override public int recvfromErrno(FileDescriptor fd, byte[] bytes, int byteOffset, int byteCount, int flags, byte[] srcAddress) throws InterruptedIOException, SocketException {
+        BlockGuard.getThreadPolicy().onNetwork();
+        return os.recvfromErrno(fd, bytes, byteOffset, byteCount, flags, srcAddress);
+    }
+
+    @Override public int recvmmsg(FileDescriptor fd, byte[] bytes, int[] byteOffsets, int[] byteCounts, int[] receivedByteCounts, byte[] addresses, int flags) throws ErrnoException, SocketException {
+        BlockGuard.getThreadPolicy().onNetwork();
+        return os.recvmmsg(fd, bytes, byteOffsets, byteCounts, receivedByteCounts, addresses, flags);
+    }
+
     @Override public void remove(String path) throws ErrnoException {
         BlockGuard.getThreadPolicy().onWriteToDisk();
         os.remove(path);
@@ -264,6 +339,14 @@ public class BlockGuardOs extends ForwardingOs {
         return os.sendfile(outFd, inFd, inOffset, byteCount);
     }
 
+    @Override public int sendmmsg(FileDescriptor fd, byte[] bytes, int[] byteOffsets, int[] byteCounts, byte[] addresses, int flags) throws ErrnoException, SocketException {
+        // We permit datagrams without hostname lookups.
+        if (addresses != null) {
+            BlockGuard.getThreadPolicy().onNetwork();
+        }
+        return os.sendmmsg(fd, bytes, byteOffsets, byteCounts, addresses, flags);
+    }
+
     @Override public int sendto(FileDescriptor fd, ByteBuffer buffer, int flags, InetAddress inetAddress, int port) throws ErrnoException, SocketException {
         BlockGuard.getThreadPolicy().onNetwork();
         return os.sendto(fd, buffer, flags, inetAddress, port);
@@ -277,6 +360,19 @@ public class BlockGuardOs extends ForwardingOs {
         return os.sendto(fd, bytes, byteOffset, byteCount, flags, inetAddress, port);
     }
 
+    @Override public int sendtoErrno(FileDescriptor fd, ByteBuffer buffer, int flags, InetAddress inetAddress, int port) throws InterruptedIOException, SocketException {
+        BlockGuard.getThreadPolicy().onNetwork();
+        return os.sendtoErrno(fd, buffer, flags, inetAddress, port);
+    }
+
+    @Override public int sendtoErrno(FileDescriptor fd, byte[] bytes, int byteOffset, int byteCount, int flags, InetAddress inetAddress, int port) throws InterruptedIOException, SocketException {
+        // We permit datagrams without hostname lookups.
+        if (inetAddress != null) {
+            BlockGuard.getThreadPolicy().onNetwork();
+        }
+        return os.sendtoErrno(fd, bytes, byteOffset, byteCount, flags, inetAddress, port);
+    }
+
     @Override public FileDescriptor socket(int domain, int type, int protocol) throws ErrnoException {
         return tagSocket(os.socket(domain, type, protocol));
     }
@@ -292,6 +388,11 @@ public class BlockGuardOs extends ForwardingOs {
         return os.stat(path);
     }
 
+    @Override public void statInto(String path, long[] out) throws ErrnoException {
+        BlockGuard.getThreadPolicy().onReadFromDisk();
+        os.statInto(path, out);
+    }
+
     @Override public StructStatVfs statvfs(String path) throws ErrnoException {
         BlockGuard.getThreadPolicy().onReadFromDisk();
         return os.statvfs(path);
@@ -302,6 +403,11 @@ public class BlockGuardOs extends ForwardingOs {
         os.symlink(oldPath, newPath);
     }
 
+    @Override public long transfer(FileDescriptor inFd, MutableLong inOffset, FileDescriptor outFd, long byteCount) throws ErrnoException {
+        BlockGuard.getThreadPolicy().onWriteToDisk();
+        return os.transfer(inFd, inOffset, outFd, byteCount);
+    }
+
     @Override public int write(FileDescriptor fd, ByteBuffer buffer) throws ErrnoException, InterruptedIOException {
         BlockGuard.getThreadPolicy().onWriteToDisk();
         return os.write(fd, buffer);
@@ -312,6 +418,16 @@ public class BlockGuardOs extends ForwardingOs {
         return os.write(fd, bytes, byteOffset, byteCount);
     }
 
+    @Override public int writeErrno(FileDescriptor fd, ByteBuffer buffer) throws InterruptedIOException {
+        BlockGuard.getThreadPolicy().onWriteToDisk();
+        return os.writeErrno(fd, buffer);
+    }
+
+    @Override public int writeErrno(FileDescriptor fd, byte[] bytes, int byteOffset, int byteCount) throws InterruptedIOException {
+        BlockGuard.getThreadPolicy().onWriteToDisk();
+        return os.writeErrno(fd, bytes, byteOffset, byteCount);
+    }
+
     @Override public int writev(FileDescriptor fd, Object[] buffers, int[] offsets, int[] byteCounts) throws ErrnoException, InterruptedIOException {
         BlockGuard.getThreadPolicy().onWriteToDisk();
         return os.writev(fd, buffers, offsets, byteCounts);
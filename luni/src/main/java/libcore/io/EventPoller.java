@@ -0,0 +1,104 @@
+/*
+ * Copyright (C) 2014 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+package libcore.io;
+
+import android.system.ErrnoException;
+import dalvik.system.CloseGuard;
+import java.io.FileDescriptor;
+import java.io.IOException;
+
+/**
+ * A persistent set of file descriptors to watch for readiness, backed by epoll(7) on Linux,
+ * kqueue(2) on Mac OS and WSAPoll on Windows. Unlike {@link Os#poll}, the interest set lives in
+ * the kernel, so the cost of {@link #poll} depends on the number of ready descriptors rather than
+ * the number registered. Windows has no such kernel object, so there the set is kept natively
+ * and handed to WSAPoll whole, which still avoids rebuilding it from Java on every call.
+ *
+ * <p>Events use the poll(2) constants from {@link android.system.OsConstants}: register
+ * {@code POLLIN}, {@code POLLPRI} and {@code POLLOUT}; {@code POLLERR} and {@code POLLHUP} are
+ * always reported. On kqueue the read and write conditions of one descriptor may be reported as
+ * two separate entries.
+ *
+ * <p>Closing this poller wakes a thread blocked in {@code poll}, which then throws an
+ * {@code ErrnoException} with {@code EINTR}, as does {@code Os.poll} when interrupted.
+ */
+public final class EventPoller implements AutoCloseable {
+    private final FileDescriptor fd;
+
+    private final CloseGuard guard = CloseGuard.get();
+
+    public EventPoller() throws ErrnoException {
+        fd = create();
+        guard.open("close");
+    }
+
+    /**
+     * Starts watching {@code target} for {@code events}.
+     */
+    public void add(FileDescriptor target, int events) throws ErrnoException {
+        add(fd, target, events);
+    }
+
+    /**
+     * Replaces the events watched for on {@code target}, which must already have been added.
+     */
+    public void modify(FileDescriptor target, int events) throws ErrnoException {
+        modify(fd, target, events);
+    }
+
+    /**
+     * Stops watching {@code target}. Closing a descriptor removes it implicitly, except on
+     * Windows, where it's reported with {@code POLLNVAL} until removed.
+     */
+    public void remove(FileDescriptor target) throws ErrnoException {
+        remove(fd, target);
+    }
+
+    /**
+     * Waits up to {@code timeoutMs} milliseconds (or forever if negative) for registered
+     * descriptors to become ready, and writes them to {@code ready} as pairs of raw file
+     * descriptor and ready events: {@code ready[2*i]} is a descriptor and {@code ready[2*i + 1]}
+     * its events. Returns the number of pairs written, which is 0 on timeout.
+     */
+    public int poll(int[] ready, int timeoutMs) throws ErrnoException {
+        return poll(fd, ready, timeoutMs);
+    }
+
+    @Override public void close() throws IOException {
+        guard.close();
+        destroy(fd);
+        IoBridge.closeAndSignalBlockedThreads(fd);
+    }
+
+    @Override protected void finalize() throws Throwable {
+        try {
+            if (guard != null) {
+                guard.warnIfOpen();
+            }
+            close();
+        } finally {
+            super.finalize();
+        }
+    }
+
+    private static native FileDescriptor create() throws ErrnoException;
+    private static native void destroy(FileDescriptor fd);
+    private static native void add(FileDescriptor fd, FileDescriptor target, int events) throws ErrnoException;
+    private static native void modify(FileDescriptor fd, FileDescriptor target, int events) throws ErrnoException;
+    private static native int poll(FileDescriptor fd, int[] ready, int timeoutMs) throws ErrnoException;
+    private static native void remove(FileDescriptor fd, FileDescriptor target) throws ErrnoException;
+}
@@ -51,12 +51,16 @@ public class ForwardingOs implements Os {
     }
 
     public FileDescriptor accept(FileDescriptor fd, InetSocketAddress peerAddress) throws ErrnoException, SocketException { return os.accept(fd, peerAddress); }
+    public int acceptMany(FileDescriptor fd, int[] fds, byte[] peerAddresses, int flags) throws ErrnoException, SocketException { return os.acceptMany(fd, fds, peerAddresses, flags); }
+    public FileDescriptor acceptPacked(FileDescriptor fd, byte[] peerAddress) throws ErrnoException, SocketException { return os.acceptPacked(fd, peerAddress); }
+    public int acceptErrno(FileDescriptor fd, byte[] peerAddress, int flags) throws InterruptedIOException, SocketException { return os.acceptErrno(fd, peerAddress, flags); }
     public boolean access(String path, int mode) throws ErrnoException { return os.access(path, mode); }
     public void bind(FileDescriptor fd, InetAddress address, int port) throws ErrnoException, SocketException { os.bind(fd, address, port); }
     public void chmod(String path, int mode) throws ErrnoException { os.chmod(path, mode); }
     public void chown(String path, int uid, int gid) throws ErrnoException { os.chown(path, uid, gid); }
     public void close(FileDescriptor fd) throws ErrnoException { os.close(fd); }
     public void connect(FileDescriptor fd, InetAddress address, int port) throws ErrnoException, SocketException { os.connect(fd, address, port); }
+    public int connectErrno(FileDescriptor fd, InetAddress address, int port) throws InterruptedIOException, SocketException { return os.connectErrno(fd, address, port); }
     public FileDescriptor dup(FileDescriptor oldFd) throws ErrnoException { return os.dup(oldFd); }
     public FileDescriptor dup2(FileDescriptor oldFd, int newFd) throws ErrnoException { return os.dup2(oldFd, newFd); }
     public String[] environ() { return os.environ(); }
@@ -80,6 +84,7 @@ public class ForwardingOs implements Os {
     public String getenv(String name) { return os.getenv(name); }
     public String getnameinfo(InetAddress address, int flags) throws GaiException { return os.getnameinfo(address, flags); }
     public SocketAddress getpeername(FileDescriptor fd) throws ErrnoException { return os.getpeername(fd); }
+    public void getpeernamePacked(FileDescriptor fd, byte[] peerAddress) throws ErrnoException { os.getpeernamePacked(fd, peerAddress); }
     public int getpid() { return os.getpid(); }
     public int getppid() { return os.getppid(); }
     public StructPasswd getpwnam(String name) throws ErrnoException { return os.getpwnam(name); }
@@ -104,6 +109,7 @@ public class ForwardingOs implements Os {
     public void listen(FileDescriptor fd, int backlog) throws ErrnoException { os.listen(fd, backlog); }
     public long lseek(FileDescriptor fd, long offset, int whence) throws ErrnoException { return os.lseek(fd, offset, whence); }
     public StructStat lstat(String path) throws ErrnoException { return os.lstat(path); }
+    public void madvise(long address, long byteCount, int advice) throws ErrnoException { os.madvise(address, byteCount, advice); }
     public void mincore(long address, long byteCount, byte[] vector) throws ErrnoException { os.mincore(address, byteCount, vector); }
     public void mkdir(String path, int mode) throws ErrnoException { os.mkdir(path, mode); }
     public void mkfifo(String path, int mode) throws ErrnoException { os.mkfifo(path, mode); }
@@ -115,6 +121,7 @@ public class ForwardingOs implements Os {
     public FileDescriptor open(String path, int flags, int mode) throws ErrnoException { return os.open(path, flags, mode); }
     public FileDescriptor[] pipe() throws ErrnoException { return os.pipe(); }
     public int poll(StructPollfd[] fds, int timeoutMs) throws ErrnoException { return os.poll(fds, timeoutMs); }
+    public void posix_fadvise(FileDescriptor fd, long offset, long length, int advice) throws ErrnoException { os.posix_fadvise(fd, offset, length, advice); }
     public void posix_fallocate(FileDescriptor fd, long offset, long length) throws ErrnoException { os.posix_fallocate(fd, offset, length); }
     public int prctl(int option, long arg2, long arg3, long arg4, long arg5) throws ErrnoException { return os.prctl(option, arg2, arg3, arg4, arg5); };
     public int pread(FileDescriptor fd, ByteBuffer buffer, long offset) throws ErrnoException, InterruptedIOException { return os.pread(fd, buffer, offset); }
@@ -123,15 +130,26 @@ public class ForwardingOs implements Os {
     public int pwrite(FileDescriptor fd, byte[] bytes, int byteOffset, int byteCount, long offset) throws ErrnoException, InterruptedIOException { return os.pwrite(fd, bytes, byteOffset, byteCount, offset); }
     public int read(FileDescriptor fd, ByteBuffer buffer) throws ErrnoException, InterruptedIOException { return os.read(fd, buffer); }
     public int read(FileDescriptor fd, byte[] bytes, int byteOffset, int byteCount) throws ErrnoException, InterruptedIOException { return os.read(fd, bytes, byteOffset, byteCount); }
+    public int readErrno(FileDescriptor fd, ByteBuffer buffer) throws InterruptedIOException { return os.readErrno(fd, buffer); }
+    public int readErrno(FileDescriptor fd, byte[] bytes, int byteOffset, int byteCount) throws InterruptedIOException { return os.readErrno(fd, bytes, byteOffset, byteCount); }
+    public void readahead(FileDescriptor fd, long offset, long byteCount) throws ErrnoException { os.readahead(fd, offset, byteCount); }
     public String readlink(String path) throws ErrnoException { return os.readlink(path); }
     public int readv(FileDescriptor fd, Object[] buffers, int[] offsets, int[] byteCounts) throws ErrnoException, InterruptedIOException { return os.readv(fd, buffers, offsets, byteCounts); }
     public int recvfrom(FileDescriptor fd, ByteBuffer buffer, int flags, InetSocketAddress srcAddress) throws ErrnoException, SocketException { return os.recvfrom(fd, buffer, flags, srcAddress); }
     public int recvfrom(FileDescriptor fd, byte[] bytes, int byteOffset, int byteCount, int flags, InetSocketAddress srcAddress) throws ErrnoException, SocketException { return os.recvfrom(fd, bytes, byteOffset, byteCount, flags, srcAddress); }
+    public int recvfromPacked(FileDescriptor fd, ByteBuffer buffer, int flags, byte[] srcAddress) throws ErrnoException, SocketException { return os.recvfromPacked(fd, buffer, flags, srcAddress); }
+    public int recvfromPacked(FileDescriptor fd, byte[] bytes, int byteOffset, int byteCount, int flags, byte[] srcAddress) throws ErrnoException, SocketException { return os.recvfromPacked(fd, bytes, byteOffset, byteCount, flags, srcAddress); }
+    public int recvfromErrno(FileDescriptor fd, ByteBuffer buffer, int flags, byte[] srcAddress) throws InterruptedIOException, SocketException { return os.recvfromErrno(fd, buffer, flags, srcAddress); }
+    public int recvfromErrno(FileDescriptor fd, byte[] bytes, int byteOffset, int byteCount, int flags, byte[] srcAddress) throws InterruptedIOException, SocketException { return os.recvfromErrno(fd, bytes, byteOffset, byteCount, flags, srcAddress); }
+    public int recvmmsg(FileDescriptor fd, byte[] bytes, int[] byteOffsets, int[] byteCounts, int[] receivedByteCounts, byte[] addresses, int flags) throws ErrnoException, SocketException { return os.recvmmsg(fd, bytes, byteOffsets, byteCounts, receivedByteCounts, addresses, flags); }
     public void remove(String path) throws ErrnoException { os.remove(path); }
     public void rename(String oldPath, String newPath) throws ErrnoException { os.rename(oldPath, newPath); }
     public long sendfile(FileDescriptor outFd, FileDescriptor inFd, MutableLong inOffset, long byteCount) throws ErrnoException { return os.sendfile(outFd, inFd, inOffset, byteCount); }
+    public int sendmmsg(FileDescriptor fd, byte[] bytes, int[] byteOffsets, int[] byteCounts, byte[] addresses, int flags) throws ErrnoException, SocketException { return os.sendmmsg(fd, bytes, byteOffsets, byteCounts, addresses, flags); }
     public int sendto(FileDescriptor fd, ByteBuffer buffer, int flags, InetAddress inetAddress, int port) throws ErrnoException, SocketException { return os.sendto(fd, buffer, flags, inetAddress, port); }
     public int sendto(FileDescriptor fd, byte[] bytes, int byteOffset, int byteCount, int flags, InetAddress inetAddress, int port) throws ErrnoException, SocketException { return os.sendto(fd, bytes, byteOffset, byteCount, flags, inetAddress, port); }
+    public int sendtoErrno(FileDescriptor fd, ByteBuffer buffer, int flags, InetAddress inetAddress, int port) throws InterruptedIOException, SocketException { return os.sendtoErrno(fd, buffer, flags, inetAddress, port); }
+    public int sendtoErrno(FileDescriptor fd, byte[] bytes, int byteOffset, int byteCount, int flags, InetAddress inetAddress, int port) throws InterruptedIOException, SocketException { return os.sendtoErrno(fd, bytes, byteOffset, byteCount, flags, inetAddress, port); }
     public void setegid(int egid) throws ErrnoException { os.setegid(egid); }
     public void setenv(String name, String value, boolean overwrite) throws ErrnoException { os.setenv(name, value, overwrite); }
     public void seteuid(int euid) throws ErrnoException { os.seteuid(euid); }
@@ -144,12 +162,14 @@ public class ForwardingOs implements Os {
     public void setsockoptGroupReq(FileDescriptor fd, int level, int option, StructGroupReq value) throws ErrnoException { os.setsockoptGroupReq(fd, level, option, value); }
     public void setsockoptGroupSourceReq(FileDescriptor fd, int level, int option, StructGroupSourceReq value) throws ErrnoException { os.setsockoptGroupSourceReq(fd, level, option, value); }
     public void setsockoptLinger(FileDescriptor fd, int level, int option, StructLinger value) throws ErrnoException { os.setsockoptLinger(fd, level, option, value); }
+    public void setsockoptMany(FileDescriptor fd, int[] levelOptionValues) throws ErrnoException { os.setsockoptMany(fd, levelOptionValues); }
     public void setsockoptTimeval(FileDescriptor fd, int level, int option, StructTimeval value) throws ErrnoException { os.setsockoptTimeval(fd, level, option, value); }
     public void setuid(int uid) throws ErrnoException { os.setuid(uid); }
     public void shutdown(FileDescriptor fd, int how) throws ErrnoException { os.shutdown(fd, how); }
     public FileDescriptor socket(int domain, int type, int protocol) throws ErrnoException { return os.socket(domain, type, protocol); }
     public void socketpair(int domain, int type, int protocol, FileDescriptor fd1, FileDescriptor fd2) throws ErrnoException { os.socketpair(domain, type, protocol, fd1, fd2); }
     public StructStat stat(String path) throws ErrnoException { return os.stat(path); }
+    public void statInto(String path, long[] out) throws ErrnoException { os.statInto(path, out); }
     public StructStatVfs statvfs(String path) throws ErrnoException { return os.statvfs(path); }
     public String strerror(int errno) { return os.strerror(errno); }
     public String strsignal(int signal) { return os.strsignal(signal); }
@@ -157,11 +177,14 @@ public class ForwardingOs implements Os {
     public long sysconf(int name) { return os.sysconf(name); }
     public void tcdrain(FileDescriptor fd) throws ErrnoException { os.tcdrain(fd); }
     public void tcsendbreak(FileDescriptor fd, int duration) throws ErrnoException { os.tcsendbreak(fd, duration); }
+    public long transfer(FileDescriptor inFd, MutableLong inOffset, FileDescriptor outFd, long byteCount) throws ErrnoException { return os.transfer(inFd, inOffset, outFd, byteCount); }
     public int umask(int mask) { return os.umask(mask); }
     public StructUtsname uname() { return os.uname(); }
     public void unsetenv(String name) throws ErrnoException { os.unsetenv(name); }
     public int waitpid(int pid, MutableInt status, int options) throws ErrnoException { return os.waitpid(pid, status, options); }
     public int write(FileDescriptor fd, ByteBuffer buffer) throws ErrnoException, InterruptedIOException { return os.write(fd, buffer); }
     public int write(FileDescriptor fd, byte[] bytes, int byteOffset, int byteCount) throws ErrnoException, InterruptedIOException { return os.write(fd, bytes, byteOffset, byteCount); }
+    public int writeErrno(FileDescriptor fd, ByteBuffer buffer) throws InterruptedIOException { return os.writeErrno(fd, buffer); }
+    public int writeErrno(FileDescriptor fd, byte[] bytes, int byteOffset, int byteCount) throws InterruptedIOException { return os.writeErrno(fd, bytes, byteOffset, byteCount); }
     public int writev(FileDescriptor fd, Object[] buffers, int[] offsets, int[] byteCounts) throws ErrnoException, InterruptedIOException { return os.writev(fd, buffers, offsets, byteCounts); }
 }
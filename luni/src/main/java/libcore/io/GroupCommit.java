@@ -0,0 +1,96 @@
+/*
+ * Copyright (C) 2014 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+package libcore.io;
+
+import android.system.ErrnoException;
+import dalvik.system.BlockGuard;
+import java.io.FileDescriptor;
+
+/**
+ * Group commit for write-ahead logs and the like, where many threads sync the same file
+ * descriptor concurrently. Rather than each caller paying for its own device flush, a caller
+ * that arrives while a sync of the same fd is in progress waits, and then one sync is made on
+ * behalf of everyone who queued meanwhile. Each caller returns (or throws) with the result of
+ * a sync that started after it called, so the usual durability guarantee is unchanged.
+ *
+ * <p>Syncs of the same fd are only coalesced if they go through this class. If any caller in a
+ * batch asked for {@link #fsync}, the whole batch gets an fsync(2); otherwise it's
+ * fdatasync(2).
+ */
+public final class GroupCommit {
+    /**
+     * Counters summed over every sync made through this class since the process started. They
+     * are never reset, so to measure an interval, take a snapshot at each end and subtract.
+     */
+    public static final class Stats {
+        /** The number of calls to {@link GroupCommit#fsync} and {@link GroupCommit#fdatasync}. */
+        public final long requests;
+        /** The number of system calls actually made on their behalf. */
+        public final long syncs;
+        /** The most callers served by a single system call. */
+        public final long maxBatchSize;
+        /** The total time spent in the system calls. */
+        public final long syncNanos;
+        /** The total time callers spent waiting, including queueing behind an earlier sync. */
+        public final long waitNanos;
+
+        private Stats(long[] values) {
+            this.requests = values[0];
+            this.syncs = values[1];
+            this.maxBatchSize = values[2];
+            this.syncNanos = values[3];
+            this.waitNanos = values[4];
+        }
+
+        @Override public String toString() {
+            return "GroupCommit.Stats[requests=" + requests + ",syncs=" + syncs +
+                    ",maxBatchSize=" + maxBatchSize + ",syncNanos=" + syncNanos +
+                    ",waitNanos=" + waitNanos + "]";
+        }
+    }
+
+    private GroupCommit() {
+    }
+
+    /**
+     * Equivalent to {@link Os#fdatasync}, but coalesced with concurrent callers syncing the
+     * same fd.
+     */
+    public static void fdatasync(FileDescriptor fd) throws ErrnoException {
+        BlockGuard.getThreadPolicy().onWriteToDisk();
+        sync(fd, false);
+    }
+
+    /**
+     * Equivalent to {@link Os#fsync}, but coalesced with concurrent callers syncing the same fd.
+     */
+    public static void fsync(FileDescriptor fd) throws ErrnoException {
+        BlockGuard.getThreadPolicy().onWriteToDisk();
+        sync(fd, true);
+    }
+
+    /**
+     * Returns the current counters.
+     */
+    public static Stats stats() {
+        return new Stats(nativeStats());
+    }
+
+    private static native void sync(FileDescriptor fd, boolean metadata) throws ErrnoException;
+    private static native long[] nativeStats();
+}
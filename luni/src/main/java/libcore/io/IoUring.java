@@ -0,0 +1,176 @@
+/*
+ * Copyright (C) 2014 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+package libcore.io;
+
+import android.system.ErrnoException;
+import dalvik.system.CloseGuard;
+import java.io.FileDescriptor;
+import java.io.InterruptedIOException;
+import java.nio.ByteBuffer;
+import java.nio.NioUtils;
+
+/**
+ * A batched I/O engine backed by Linux's io_uring(7). Operations are queued with the
+ * {@code prepare} methods, handed to the kernel in one system call by {@link #submit}, and their
+ * results collected in bulk by {@link #reap}. Each operation carries a caller-chosen
+ * {@code long} that comes back with its result, which is the value the equivalent system call
+ * would have returned, or a negated errno value on failure.
+ *
+ * <p>The kernel accesses buffers asynchronously, so they're given as native addresses (or direct
+ * {@code ByteBuffer}s), and the caller must keep them valid until the corresponding completion
+ * has been reaped.
+ *
+ * <p>Closing a file descriptor via {@link IoBridge#closeAndSignalBlockedThreads} while a thread
+ * is waiting in {@code submit} cancels that descriptor's outstanding operations, which then
+ * complete with {@code -ECANCELED}, and makes {@code submit} throw
+ * {@code InterruptedIOException}, just as a blocking {@code read} would.
+ *
+ * <p>A ring isn't thread-safe. Use {@link #isSupported} to check that the running kernel
+ * provides io_uring before creating one.
+ */
+public final class IoUring implements AutoCloseable {
+    private long address;
+
+    private final CloseGuard guard = CloseGuard.get();
+
+    /**
+     * Creates a ring with room for at least {@code entries} queued operations. Up to twice that
+     * many may be outstanding at once, counting completions that haven't been reaped, less a few
+     * that the ring keeps back so that it can always cancel operations on a closed descriptor.
+     */
+    public IoUring(int entries) throws ErrnoException {
+        address = setup(entries);
+        guard.open("close");
+    }
+
+    /**
+     * Returns true if this kernel supports io_uring.
+     */
+    public static native boolean isSupported();
+
+    /**
+     * Queues a read of up to {@code byteCount} bytes at {@code offset} into the native memory at
+     * {@code buffer}. An {@code offset} of -1 reads from the current file position. Returns false
+     * if the ring is full, in which case the caller should {@link #submit} and {@link #reap}.
+     */
+    public boolean prepareRead(FileDescriptor fd, long buffer, int byteCount, long offset, long userData) {
+        return prepareRead(checkOpen(), fd, buffer, byteCount, offset, userData);
+    }
+
+    /**
+     * Queues a read into the remaining space of the direct buffer {@code buffer}. The buffer's
+     * position is not updated.
+     */
+    public boolean prepareRead(FileDescriptor fd, ByteBuffer buffer, long offset, long userData) {
+        return prepareRead(fd, directAddress(buffer), buffer.remaining(), offset, userData);
+    }
+
+    /**
+     * Queues a write of {@code byteCount} bytes from the native memory at {@code buffer} to
+     * {@code offset}. An {@code offset} of -1 writes at the current file position. Returns false
+     * if the ring is full.
+     */
+    public boolean prepareWrite(FileDescriptor fd, long buffer, int byteCount, long offset, long userData) {
+        return prepareWrite(checkOpen(), fd, buffer, byteCount, offset, userData);
+    }
+
+    /**
+     * Queues a write of the remaining bytes of the direct buffer {@code buffer}. The buffer's
+     * position is not updated.
+     */
+    public boolean prepareWrite(FileDescriptor fd, ByteBuffer buffer, long offset, long userData) {
+        return prepareWrite(fd, directAddress(buffer), buffer.remaining(), offset, userData);
+    }
+
+    /**
+     * Queues an accept4(2) on the listening socket {@code fd}. The result is the raw file
+     * descriptor of the accepted connection. Returns false if the ring is full.
+     */
+    public boolean prepareAccept(FileDescriptor fd, int flags, long userData) {
+        return prepareAccept(checkOpen(), fd, flags, userData);
+    }
+
+    /**
+     * Queues an fsync(2), or an fdatasync(2) if {@code dataOnly} is true. Returns false if the
+     * ring is full.
+     */
+    public boolean prepareFsync(FileDescriptor fd, boolean dataOnly, long userData) {
+        return prepareFsync(checkOpen(), fd, dataOnly, userData);
+    }
+
+    /**
+     * Hands all queued operations to the kernel, then waits until at least {@code minComplete}
+     * completions are available to {@link #reap}. Returns the number of operations submitted.
+     */
+    public int submit(int minComplete) throws ErrnoException, InterruptedIOException {
+        return submit(checkOpen(), minComplete);
+    }
+
+    /**
+     * Copies up to {@code min(userData.length, results.length)} available completions into the
+     * given arrays without blocking, and returns how many were copied.
+     */
+    public int reap(long[] userData, int[] results) {
+        return reap(checkOpen(), userData, results);
+    }
+
+    /**
+     * Releases the ring. Operations still in flight are abandoned: their buffers may still be
+     * written to until the kernel notices, so only free them once their descriptors are closed.
+     */
+    @Override public void close() {
+        guard.close();
+        if (address != 0) {
+            destroy(address);
+            address = 0;
+        }
+    }
+
+    @Override protected void finalize() throws Throwable {
+        try {
+            if (guard != null) {
+                guard.warnIfOpen();
+            }
+            close();
+        } finally {
+            super.finalize();
+        }
+    }
+
+    private long checkOpen() {
+        if (address == 0) {
+            throw new IllegalStateException("IoUring has been closed");
+        }
+        return address;
+    }
+
+    private static long directAddress(ByteBuffer buffer) {
+        if (!buffer.isDirect()) {
+            throw new IllegalArgumentException("buffer is not direct");
+        }
+        return NioUtils.getDirectBufferAddress(buffer) + buffer.position();
+    }
+
+    private static native long setup(int entries) throws ErrnoException;
+    private static native void destroy(long address);
+    private static native boolean prepareRead(long address, FileDescriptor fd, long buffer, int byteCount, long offset, long userData);
+    private static native boolean prepareWrite(long address, FileDescriptor fd, long buffer, int byteCount, long offset, long userData);
+    private static native boolean prepareAccept(long address, FileDescriptor fd, int flags, long userData);
+    private static native boolean prepareFsync(long address, FileDescriptor fd, boolean dataOnly, long userData);
+    private static native int submit(long address, int minComplete) throws ErrnoException, InterruptedIOException;
+    private static native int reap(long address, long[] userData, int[] results);
+}
@@ -42,6 +42,23 @@ public final class Memory {
     public static native void unsafeBulkPut(byte[] dst, int dstOffset, int byteCount,
             Object src, int srcOffset, int sizeofElements, boolean swap);
 
+    /**
+     * Gathers 'count' elements of 'sizeofElements' bytes, starting at byte 'srcOffset' of 'src'
+     * and 'srcStride' bytes apart, into consecutive elements of 'dst', which must be a primitive
+     * array. 'dstOffset' is measured in units of 'sizeofElements' bytes. This turns one field of
+     * an array of fixed-size records into a column.
+     */
+    public static native void unsafeStridedGet(Object dst, int dstOffset, int count,
+            byte[] src, int srcOffset, int srcStride, int sizeofElements, boolean swap);
+
+    /**
+     * Scatters 'count' consecutive elements of 'src', which must be a primitive array, into
+     * 'dst' starting at byte 'dstOffset' and 'dstStride' bytes apart. 'srcOffset' is measured
+     * in units of 'sizeofElements' bytes. The inverse of unsafeStridedGet.
+     */
+    public static native void unsafeStridedPut(byte[] dst, int dstOffset, int dstStride,
+            int count, Object src, int srcOffset, int sizeofElements, boolean swap);
+
     public static int peekInt(byte[] src, int offset, ByteOrder order) {
         if (order == ByteOrder.BIG_ENDIAN) {
             return (((src[offset++] & 0xff) << 24) |
@@ -150,6 +167,23 @@ public final class Memory {
      */
     public static native void memmove(Object dstObject, int dstOffset, Object srcObject, int srcOffset, long byteCount);
 
+    /**
+     * Allows a copy of tens of MiB or more between direct buffers (by memmove or copyNative) to
+     * be split across up to 'count' threads, including the caller's. The default, 1, keeps every
+     * copy on the calling thread. Whatever the thread count, copies too big for the cache are
+     * made with non-temporal stores where the CPU has them, so they don't evict it.
+     */
+    public static void setMaxCopyThreads(int count) {
+        if (count < 1) {
+            throw new IllegalArgumentException("count < 1: " + count);
+        }
+        setMaxCopyThreadsImpl(count);
+    }
+
+    private static native void setMaxCopyThreadsImpl(int count);
+
+    // peekByte, pokeByte and the peek/poke*Native methods are listed in MemoryIntrinsics.h so
+    // that a VM can recognize and inline them. Keep their names and signatures in sync.
     public static native byte peekByte(long address);
 
     public static int peekInt(long address, boolean swap) {
@@ -187,6 +221,12 @@ public final class Memory {
     public static native void peekLongArray(long address, long[] dst, int dstOffset, int longCount, boolean swap);
     public static native void peekShortArray(long address, short[] dst, int dstOffset, int shortCount, boolean swap);
 
+    /**
+     * Like unsafeStridedGet, but gathering from native memory.
+     */
+    public static native void peekStrided(long address, int stride, Object dst, int dstOffset,
+            int count, int sizeofElements, boolean swap);
+
     public static native void pokeByte(long address, byte value);
 
     public static void pokeInt(long address, int value, boolean swap) {
@@ -220,4 +260,18 @@ public final class Memory {
     public static native void pokeIntArray(long address, int[] src, int offset, int count, boolean swap);
     public static native void pokeLongArray(long address, long[] src, int offset, int count, boolean swap);
     public static native void pokeShortArray(long address, short[] src, int offset, int count, boolean swap);
+
+    /**
+     * Like unsafeStridedPut, but scattering to native memory.
+     */
+    public static native void pokeStrided(long address, int stride, Object src, int srcOffset,
+            int count, int sizeofElements, boolean swap);
+
+    /**
+     * Copies 'count' elements of 'sizeofElements' bytes between two native addresses, with the
+     * given strides in bytes, optionally swapping each. Overlapping regions are only allowed for
+     * unswapped contiguous copies.
+     */
+    public static native void copyNative(long dstAddress, int dstStride, long srcAddress,
+            int srcStride, int count, int sizeofElements, boolean swap);
 }
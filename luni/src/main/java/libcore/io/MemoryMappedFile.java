@@ -33,6 +33,17 @@ import static android.system.OsConstants.*;
  * {@link BufferIterator} over the mapped data.
  */
 public final class MemoryMappedFile implements AutoCloseable {
+    /** No special treatment: the kernel's default read-ahead. */
+    public static final int ACCESS_NORMAL = 0;
+    /** The data will be read from start to end, so read ahead aggressively and let pages go soon after they're used. */
+    public static final int ACCESS_SEQUENTIAL = 1;
+    /** The data will be read in no particular order, so don't read ahead. */
+    public static final int ACCESS_RANDOM = 2;
+    /** The data will be needed soon, so start reading it in now. */
+    public static final int ACCESS_WILLNEED = 3;
+
+    private static long pageSize;
+
     private long address;
     private final long size;
 
@@ -48,11 +59,78 @@ public final class MemoryMappedFile implements AutoCloseable {
      * Use this to mmap the whole file read-only.
      */
     public static MemoryMappedFile mmapRO(String path) throws ErrnoException {
+        return mmapRO(path, ACCESS_NORMAL, false);
+    }
+
+    /**
+     * Use this to mmap the whole file read-only, telling the kernel that it will be accessed
+     * as described by {@code access}, one of the {@code ACCESS_} constants. If {@code hugePages}
+     * is true, also asks for the mapping to be backed by transparent huge pages. That's only a
+     * hint, and is silently ignored by kernels that can't do it for files.
+     */
+    public static MemoryMappedFile mmapRO(String path, int access, boolean hugePages) throws ErrnoException {
         FileDescriptor fd = Libcore.os.open(path, O_RDONLY, 0);
         long size = Libcore.os.fstat(fd).st_size;
         long address = Libcore.os.mmap(0L, size, PROT_READ, MAP_SHARED, fd, 0);
         Libcore.os.close(fd);
-        return new MemoryMappedFile(address, size);
+        MemoryMappedFile result = new MemoryMappedFile(address, size);
+        try {
+            if (hugePages && MADV_HUGEPAGE != MADV_NORMAL) {
+                try {
+                    Libcore.os.madvise(address, size, MADV_HUGEPAGE);
+                } catch (ErrnoException ignored) {
+                    // Most likely EINVAL from a kernel without transparent huge page support.
+                }
+            }
+            result.advise(access);
+        } catch (ErrnoException e) {
+            result.close();
+            throw e;
+        }
+        return result;
+    }
+
+    /**
+     * Tells the kernel that the whole of the mapped data will be accessed as described by
+     * {@code access}, one of the {@code ACCESS_} constants, using madvise(2).
+     */
+    public void advise(int access) throws ErrnoException {
+        advise(access, 0, size);
+    }
+
+    /**
+     * Tells the kernel that {@code byteCount} bytes of the mapped data starting at
+     * {@code offset} will be accessed as described by {@code access}. This is how a long scan
+     * can ask for the next window to be read in with {@link #ACCESS_WILLNEED}. The range is
+     * widened to whole pages.
+     */
+    public synchronized void advise(int access, long offset, long byteCount) throws ErrnoException {
+        if (offset < 0 || byteCount < 0 || offset > size - byteCount) {
+            throw new IndexOutOfBoundsException("offset=" + offset + " byteCount=" + byteCount + " size=" + size);
+        }
+        if (address == 0) {
+            throw new IllegalStateException("MemoryMappedFile closed");
+        }
+        int advice;
+        switch (access) {
+        case ACCESS_NORMAL: advice = MADV_NORMAL; break;
+        case ACCESS_SEQUENTIAL: advice = MADV_SEQUENTIAL; break;
+        case ACCESS_RANDOM: advice = MADV_RANDOM; break;
+        case ACCESS_WILLNEED: advice = MADV_WILLNEED; break;
+        default: throw new IllegalArgumentException("Unknown access pattern: " + access);
+        }
+        if (byteCount == 0) {
+            return;
+        }
+        long alignedOffset = offset & ~(pageSize() - 1);
+        Libcore.os.madvise(address + alignedOffset, offset + byteCount - alignedOffset, advice);
+    }
+
+    private static synchronized long pageSize() {
+        if (pageSize == 0) {
+            pageSize = Libcore.os.sysconf(_SC_PAGESIZE);
+        }
+        return pageSize;
     }
 
     /**
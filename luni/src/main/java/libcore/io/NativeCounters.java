@@ -0,0 +1,95 @@
+/*
+ * Copyright (C) 2014 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+package libcore.io;
+
+import java.util.ArrayList;
+import java.util.Collections;
+import java.util.Comparator;
+import java.util.List;
+
+/**
+ * Per-method counters for libcore's native methods: how often each was called, how many bytes
+ * it moved, and how long it took. Counters are only collected when libjavacore is built with
+ * {@code LIBCORE_NATIVE_COUNTERS=true}; otherwise {@link #isEnabled} returns false and
+ * {@link #snapshot} returns an empty list. Counters are never reset, so to measure an interval,
+ * take a snapshot at each end and subtract.
+ */
+public final class NativeCounters {
+    /**
+     * The number of buckets in {@link Counter#histogram}. Bucket {@code i} counts calls that took
+     * at least 2<sup>i</sup> and less than 2<sup>i+1</sup> nanoseconds, except that bucket 0 also
+     * counts calls that took 0ns and the last bucket has no upper bound.
+     */
+    public static final int HISTOGRAM_BUCKETS = 32;
+
+    /** One native method's counters, summed over all threads. */
+    public static final class Counter {
+        /** The method's name, such as {@code "Posix.read"}. */
+        public final String name;
+        public final long calls;
+        /** The bytes read, written, or (for zip) consumed and produced, where the native says. */
+        public final long bytes;
+        public final long nanos;
+        public final long[] histogram;
+
+        private Counter(String name, long[] values, int offset) {
+            this.name = name;
+            this.calls = values[offset];
+            this.bytes = values[offset + 1];
+            this.nanos = values[offset + 2];
+            this.histogram = new long[HISTOGRAM_BUCKETS];
+            System.arraycopy(values, offset + 3, histogram, 0, HISTOGRAM_BUCKETS);
+        }
+
+        @Override public String toString() {
+            return name + "[calls=" + calls + ",bytes=" + bytes + ",nanos=" + nanos + "]";
+        }
+    }
+
+    private NativeCounters() {
+    }
+
+    /**
+     * Returns whether this build collects native counters.
+     */
+    public static native boolean isEnabled();
+
+    /**
+     * Returns the counters of every native that has been called at least once, with the most
+     * total time first.
+     */
+    public static List<Counter> snapshot() {
+        String[] names = names();
+        long[] values = snapshot(names.length);
+        int stride = 3 + HISTOGRAM_BUCKETS;
+        List<Counter> result = new ArrayList<Counter>();
+        for (int i = 0; i < names.length; ++i) {
+            if (values[i * stride] != 0) {
+                result.add(new Counter(names[i], values, i * stride));
+            }
+        }
+        Collections.sort(result, new Comparator<Counter>() {
+            @Override public int compare(Counter lhs, Counter rhs) {
+                return Long.compare(rhs.nanos, lhs.nanos);
+            }
+        });
+        return result;
+    }
+
+    private static native String[] names();
+    private static native long[] snapshot(int count);
+}
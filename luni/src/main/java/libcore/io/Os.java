@@ -42,12 +42,38 @@ import java.nio.ByteBuffer;
 
 public interface Os {
     public FileDescriptor accept(FileDescriptor fd, InetSocketAddress peerAddress) throws ErrnoException, SocketException;
+    /*
+     * Like accept, but if peerAddress is non-null writes the peer's port (big-endian) and IPv6
+     * address (IPv4-mapped for IPv4 peers) to its first 18 bytes, the same packed form recvmmsg
+     * uses, rather than allocating an InetAddress. A peer with no IP address is all zeros.
+     */
+    public FileDescriptor acceptPacked(FileDescriptor fd, byte[] peerAddress) throws ErrnoException, SocketException;
+    /*
+     * acceptErrno, connectErrno, readErrno, recvfromErrno, sendtoErrno and writeErrno are the
+     * "errno-returning" variants of the hot I/O calls, for callers such as non-blocking NIO that
+     * expect EAGAIN or EINPROGRESS often and shouldn't allocate an ErrnoException each time. Each
+     * returns what the throwing version would, or -errno (-EBADF for a closed FileDescriptor)
+     * instead of throwing. Peer addresses are in acceptPacked's packed form. acceptErrno takes
+     * accept4(2)'s flags (which must be 0 other than on Linux), and returns the new raw fd, which
+     * the caller owns and must close; connectErrno returns 0 on success. Being interrupted by an
+     * asynchronous close still throws.
+     */
+    public int acceptErrno(FileDescriptor fd, byte[] peerAddress, int flags) throws InterruptedIOException, SocketException;
+    /*
+     * Accepts up to fds.length connections with accept4(2), passing it 'flags' (SOCK_NONBLOCK
+     * and/or SOCK_CLOEXEC), and stores the raw fds in fds. If peerAddresses is non-null, the
+     * i'th peer is written in packed form to the 18 bytes at peerAddresses[18 * i]. Only the
+     * first accept may block; the rest take only connections that are already waiting. Returns
+     * the number of connections accepted. The caller owns the fds and must close them.
+     */
+    public int acceptMany(FileDescriptor fd, int[] fds, byte[] peerAddresses, int flags) throws ErrnoException, SocketException;
     public boolean access(String path, int mode) throws ErrnoException;
     public void bind(FileDescriptor fd, InetAddress address, int port) throws ErrnoException, SocketException;
     public void chmod(String path, int mode) throws ErrnoException;
     public void chown(String path, int uid, int gid) throws ErrnoException;
     public void close(FileDescriptor fd) throws ErrnoException;
     public void connect(FileDescriptor fd, InetAddress address, int port) throws ErrnoException, SocketException;
+    public int connectErrno(FileDescriptor fd, InetAddress address, int port) throws InterruptedIOException, SocketException;
     public FileDescriptor dup(FileDescriptor oldFd) throws ErrnoException;
     public FileDescriptor dup2(FileDescriptor oldFd, int newFd) throws ErrnoException;
     public String[] environ();
@@ -72,6 +98,8 @@ public interface Os {
     /* TODO: break into getnameinfoHost and getnameinfoService? */
     public String getnameinfo(InetAddress address, int flags) throws GaiException;
     public SocketAddress getpeername(FileDescriptor fd) throws ErrnoException;
+    /* Like getpeername, but writes the peer to peerAddress in acceptPacked's packed form. */
+    public void getpeernamePacked(FileDescriptor fd, byte[] peerAddress) throws ErrnoException;
     public int getpid();
     public int getppid();
     public StructPasswd getpwnam(String name) throws ErrnoException;
@@ -96,6 +124,7 @@ public interface Os {
     public void listen(FileDescriptor fd, int backlog) throws ErrnoException;
     public long lseek(FileDescriptor fd, long offset, int whence) throws ErrnoException;
     public StructStat lstat(String path) throws ErrnoException;
+    public void madvise(long address, long byteCount, int advice) throws ErrnoException;
     public void mincore(long address, long byteCount, byte[] vector) throws ErrnoException;
     public void mkdir(String path, int mode) throws ErrnoException;
     public void mkfifo(String path, int mode) throws ErrnoException;
@@ -108,6 +137,7 @@ public interface Os {
     public FileDescriptor[] pipe() throws ErrnoException;
     /* TODO: if we used the non-standard ppoll(2) behind the scenes, we could take a long timeout. */
     public int poll(StructPollfd[] fds, int timeoutMs) throws ErrnoException;
+    public void posix_fadvise(FileDescriptor fd, long offset, long length, int advice) throws ErrnoException;
     public void posix_fallocate(FileDescriptor fd, long offset, long length) throws ErrnoException;
     public int prctl(int option, long arg2, long arg3, long arg4, long arg5) throws ErrnoException;
     public int pread(FileDescriptor fd, ByteBuffer buffer, long offset) throws ErrnoException, InterruptedIOException;
@@ -116,15 +146,36 @@ public interface Os {
     public int pwrite(FileDescriptor fd, byte[] bytes, int byteOffset, int byteCount, long offset) throws ErrnoException, InterruptedIOException;
     public int read(FileDescriptor fd, ByteBuffer buffer) throws ErrnoException, InterruptedIOException;
     public int read(FileDescriptor fd, byte[] bytes, int byteOffset, int byteCount) throws ErrnoException, InterruptedIOException;
+    public int readErrno(FileDescriptor fd, ByteBuffer buffer) throws InterruptedIOException;
+    public int readErrno(FileDescriptor fd, byte[] bytes, int byteOffset, int byteCount) throws InterruptedIOException;
+    public void readahead(FileDescriptor fd, long offset, long byteCount) throws ErrnoException;
     public String readlink(String path) throws ErrnoException;
     public int readv(FileDescriptor fd, Object[] buffers, int[] offsets, int[] byteCounts) throws ErrnoException, InterruptedIOException;
     public int recvfrom(FileDescriptor fd, ByteBuffer buffer, int flags, InetSocketAddress srcAddress) throws ErrnoException, SocketException;
     public int recvfrom(FileDescriptor fd, byte[] bytes, int byteOffset, int byteCount, int flags, InetSocketAddress srcAddress) throws ErrnoException, SocketException;
+    /* Like recvfrom, but writes the sender to srcAddress, if non-null, in acceptPacked's packed form. */
+    public int recvfromPacked(FileDescriptor fd, ByteBuffer buffer, int flags, byte[] srcAddress) throws ErrnoException, SocketException;
+    public int recvfromPacked(FileDescriptor fd, byte[] bytes, int byteOffset, int byteCount, int flags, byte[] srcAddress) throws ErrnoException, SocketException;
+    public int recvfromErrno(FileDescriptor fd, ByteBuffer buffer, int flags, byte[] srcAddress) throws InterruptedIOException, SocketException;
+    public int recvfromErrno(FileDescriptor fd, byte[] bytes, int byteOffset, int byteCount, int flags, byte[] srcAddress) throws InterruptedIOException, SocketException;
+    /*
+     * Receives up to byteOffsets.length datagrams in one call, the i'th into bytes[byteOffsets[i]]
+     * with room for byteCounts[i] bytes, storing its length in receivedByteCounts[i] and, if
+     * addresses is non-null, its sender's port (big-endian) and IPv6 address (IPv4-mapped for
+     * IPv4 peers) in the 18 bytes at addresses[18 * i]. Returns the number of datagrams received.
+     * On a blocking socket this waits only for the first datagram, then takes whatever else has
+     * already arrived.
+     */
+    public int recvmmsg(FileDescriptor fd, byte[] bytes, int[] byteOffsets, int[] byteCounts, int[] receivedByteCounts, byte[] addresses, int flags) throws ErrnoException, SocketException;
     public void remove(String path) throws ErrnoException;
     public void rename(String oldPath, String newPath) throws ErrnoException;
     public int sendto(FileDescriptor fd, ByteBuffer buffer, int flags, InetAddress inetAddress, int port) throws ErrnoException, SocketException;
     public int sendto(FileDescriptor fd, byte[] bytes, int byteOffset, int byteCount, int flags, InetAddress inetAddress, int port) throws ErrnoException, SocketException;
+    public int sendtoErrno(FileDescriptor fd, ByteBuffer buffer, int flags, InetAddress inetAddress, int port) throws InterruptedIOException, SocketException;
+    public int sendtoErrno(FileDescriptor fd, byte[] bytes, int byteOffset, int byteCount, int flags, InetAddress inetAddress, int port) throws InterruptedIOException, SocketException;
     public long sendfile(FileDescriptor outFd, FileDescriptor inFd, MutableLong inOffset, long byteCount) throws ErrnoException;
+    /* The inverse of recvmmsg. A null addresses array means the socket is connected. Returns the number of datagrams sent. */
+    public int sendmmsg(FileDescriptor fd, byte[] bytes, int[] byteOffsets, int[] byteCounts, byte[] addresses, int flags) throws ErrnoException, SocketException;
     public void setegid(int egid) throws ErrnoException;
     public void setenv(String name, String value, boolean overwrite) throws ErrnoException;
     public void seteuid(int euid) throws ErrnoException;
@@ -137,12 +188,23 @@ public interface Os {
     public void setsockoptGroupReq(FileDescriptor fd, int level, int option, StructGroupReq value) throws ErrnoException;
     public void setsockoptGroupSourceReq(FileDescriptor fd, int level, int option, StructGroupSourceReq value) throws ErrnoException;
     public void setsockoptLinger(FileDescriptor fd, int level, int option, StructLinger value) throws ErrnoException;
+    /**
+     * Sets several int-valued options with one call. {@code levelOptionValues} holds
+     * (level, option, value) triples, which are applied in order up to the first failure.
+     */
+    public void setsockoptMany(FileDescriptor fd, int[] levelOptionValues) throws ErrnoException;
     public void setsockoptTimeval(FileDescriptor fd, int level, int option, StructTimeval value) throws ErrnoException;
     public void setuid(int uid) throws ErrnoException;
     public void shutdown(FileDescriptor fd, int how) throws ErrnoException;
     public FileDescriptor socket(int domain, int type, int protocol) throws ErrnoException;
     public void socketpair(int domain, int type, int protocol, FileDescriptor fd1, FileDescriptor fd2) throws ErrnoException;
     public StructStat stat(String path) throws ErrnoException;
+    /*
+     * Like stat, but writes the StructStat fields (st_dev, st_ino, st_mode, st_nlink, st_uid,
+     * st_gid, st_rdev, st_size, st_atime, st_mtime, st_ctime, st_blksize, st_blocks, in that
+     * order) to out, which must have room for 13 values, so callers can reuse one array.
+     */
+    public void statInto(String path, long[] out) throws ErrnoException;
     public StructStatVfs statvfs(String path) throws ErrnoException;
     public String strerror(int errno);
     public String strsignal(int signal);
@@ -150,11 +212,20 @@ public interface Os {
     public long sysconf(int name);
     public void tcdrain(FileDescriptor fd) throws ErrnoException;
     public void tcsendbreak(FileDescriptor fd, int duration) throws ErrnoException;
+    /*
+     * Copies up to byteCount bytes from inFd (starting at inOffset, or its file position if
+     * inOffset is null) to outFd without going through user space. Picks copy_file_range(2) for
+     * file to file, sendfile(2) with 64-bit offsets for file to socket or pipe, and splice(2)
+     * otherwise. Fails with ENOSYS where none of these are available.
+     */
+    public long transfer(FileDescriptor inFd, MutableLong inOffset, FileDescriptor outFd, long byteCount) throws ErrnoException;
     public int umask(int mask);
     public StructUtsname uname();
     public void unsetenv(String name) throws ErrnoException;
     public int waitpid(int pid, MutableInt status, int options) throws ErrnoException;
     public int write(FileDescriptor fd, ByteBuffer buffer) throws ErrnoException, InterruptedIOException;
     public int write(FileDescriptor fd, byte[] bytes, int byteOffset, int byteCount) throws ErrnoException, InterruptedIOException;
+    public int writeErrno(FileDescriptor fd, ByteBuffer buffer) throws InterruptedIOException;
+    public int writeErrno(FileDescriptor fd, byte[] bytes, int byteOffset, int byteCount) throws InterruptedIOException;
     public int writev(FileDescriptor fd, Object[] buffers, int[] offsets, int[] byteCounts) throws ErrnoException, InterruptedIOException;
 }
@@ -55,12 +55,16 @@ public final class Posix implements Os {
     Posix() { }
 
     public native FileDescriptor accept(FileDescriptor fd, InetSocketAddress peerAddress) throws ErrnoException, SocketException;
+    public native int acceptMany(FileDescriptor fd, int[] fds, byte[] peerAddresses, int flags) throws ErrnoException, SocketException;
+    public native FileDescriptor acceptPacked(FileDescriptor fd, byte[] peerAddress) throws ErrnoException, SocketException;
+    public native int acceptErrno(FileDescriptor fd, byte[] peerAddress, int flags) throws InterruptedIOException, SocketException;
     public native boolean access(String path, int mode) throws ErrnoException;
     public native void bind(FileDescriptor fd, InetAddress address, int port) throws ErrnoException, SocketException;
     public native void chmod(String path, int mode) throws ErrnoException;
     public native void chown(String path, int uid, int gid) throws ErrnoException;
     public native void close(FileDescriptor fd) throws ErrnoException;
     public native void connect(FileDescriptor fd, InetAddress address, int port) throws ErrnoException, SocketException;
+    public native int connectErrno(FileDescriptor fd, InetAddress address, int port) throws InterruptedIOException, SocketException;
     public native FileDescriptor dup(FileDescriptor oldFd) throws ErrnoException;
     public native FileDescriptor dup2(FileDescriptor oldFd, int newFd) throws ErrnoException;
     public native String[] environ();
@@ -84,6 +88,7 @@ public final class Posix implements Os {
     public native String getenv(String name);
     public native String getnameinfo(InetAddress address, int flags) throws GaiException;
     public native SocketAddress getpeername(FileDescriptor fd) throws ErrnoException;
+    public native void getpeernamePacked(FileDescriptor fd, byte[] peerAddress) throws ErrnoException;
     public native int getpid();
     public native int getppid();
     public native StructPasswd getpwnam(String name) throws ErrnoException;
@@ -108,6 +113,7 @@ public final class Posix implements Os {
     public native void listen(FileDescriptor fd, int backlog) throws ErrnoException;
     public native long lseek(FileDescriptor fd, long offset, int whence) throws ErrnoException;
     public native StructStat lstat(String path) throws ErrnoException;
+    public native void madvise(long address, long byteCount, int advice) throws ErrnoException;
     public native void mincore(long address, long byteCount, byte[] vector) throws ErrnoException;
     public native void mkdir(String path, int mode) throws ErrnoException;
     public native void mkfifo(String path, int mode) throws ErrnoException;
@@ -119,6 +125,7 @@ public final class Posix implements Os {
     public native FileDescriptor open(String path, int flags, int mode) throws ErrnoException;
     public native FileDescriptor[] pipe() throws ErrnoException;
     public native int poll(StructPollfd[] fds, int timeoutMs) throws ErrnoException;
+    public native void posix_fadvise(FileDescriptor fd, long offset, long length, int advice) throws ErrnoException;
     public native void posix_fallocate(FileDescriptor fd, long offset, long length) throws ErrnoException;
     public native int prctl(int option, long arg2, long arg3, long arg4, long arg5) throws ErrnoException;
     public int pread(FileDescriptor fd, ByteBuffer buffer, long offset) throws ErrnoException, InterruptedIOException {
@@ -157,6 +164,18 @@ public final class Posix implements Os {
         return readBytes(fd, bytes, byteOffset, byteCount);
     }
     private native int readBytes(FileDescriptor fd, Object buffer, int offset, int byteCount) throws ErrnoException, InterruptedIOException;
+    public int readErrno(FileDescriptor fd, ByteBuffer buffer) throws InterruptedIOException {
+        if (buffer.isDirect()) {
+            return readBytesErrno(fd, buffer, buffer.position(), buffer.remaining());
+        } else {
+            return readBytesErrno(fd, NioUtils.unsafeArray(buffer), NioUtils.unsafeArrayOffset(buffer) + buffer.position(), buffer.remaining());
+        }
+    }
+    public int readErrno(FileDescriptor fd, byte[] bytes, int byteOffset, int byteCount) throws InterruptedIOException {
+        return readBytesErrno(fd, bytes, byteOffset, byteCount);
+    }
+    private native int readBytesErrno(FileDescriptor fd, Object buffer, int offset, int byteCount) throws InterruptedIOException;
+    public native void readahead(FileDescriptor fd, long offset, long byteCount) throws ErrnoException;
     public native String readlink(String path) throws ErrnoException;
     public native int readv(FileDescriptor fd, Object[] buffers, int[] offsets, int[] byteCounts) throws ErrnoException, InterruptedIOException;
     public int recvfrom(FileDescriptor fd, ByteBuffer buffer, int flags, InetSocketAddress srcAddress) throws ErrnoException, SocketException {
@@ -171,9 +190,33 @@ public final class Posix implements Os {
         return recvfromBytes(fd, bytes, byteOffset, byteCount, flags, srcAddress);
     }
     private native int recvfromBytes(FileDescriptor fd, Object buffer, int byteOffset, int byteCount, int flags, InetSocketAddress srcAddress) throws ErrnoException, SocketException;
+    public int recvfromPacked(FileDescriptor fd, ByteBuffer buffer, int flags, byte[] srcAddress) throws ErrnoException, SocketException {
+        if (buffer.isDirect()) {
+            return recvfromBytesPacked(fd, buffer, buffer.position(), buffer.remaining(), flags, srcAddress);
+        } else {
+            return recvfromBytesPacked(fd, NioUtils.unsafeArray(buffer), NioUtils.unsafeArrayOffset(buffer) + buffer.position(), buffer.remaining(), flags, srcAddress);
+        }
+    }
+    public int recvfromPacked(FileDescriptor fd, byte[] bytes, int byteOffset, int byteCount, int flags, byte[] srcAddress) throws ErrnoException, SocketException {
+        return recvfromBytesPacked(fd, bytes, byteOffset, byteCount, flags, srcAddress);
+    }
+    private native int recvfromBytesPacked(FileDescriptor fd, Object buffer, int byteOffset, int byteCount, int flags, byte[] srcAddress) throws ErrnoException, SocketException;
+    public int recvfromErrno(FileDescriptor fd, ByteBuffer buffer, int flags, byte[] srcAddress) throws InterruptedIOException, SocketException {
+        if (buffer.isDirect()) {
+            return recvfromBytesErrno(fd, buffer, buffer.position(), buffer.remaining(), flags, srcAddress);
+        } else {
+            return recvfromBytesErrno(fd, NioUtils.unsafeArray(buffer), NioUtils.unsafeArrayOffset(buffer) + buffer.position(), buffer.remaining(), flags, srcAddress);
+        }
+    }
+    public int recvfromErrno(FileDescriptor fd, byte[] bytes, int byteOffset, int byteCount, int flags, byte[] srcAddress) throws InterruptedIOException, SocketException {
+        return recvfromBytesErrno(fd, bytes, byteOffset, byteCount, flags, srcAddress);
+    }
+    private native int recvfromBytesErrno(FileDescriptor fd, Object buffer, int byteOffset, int byteCount, int flags, byte[] srcAddress) throws InterruptedIOException, SocketException;
+    public native int recvmmsg(FileDescriptor fd, byte[] bytes, int[] byteOffsets, int[] byteCounts, int[] receivedByteCounts, byte[] addresses, int flags) throws ErrnoException, SocketException;
     public native void remove(String path) throws ErrnoException;
     public native void rename(String oldPath, String newPath) throws ErrnoException;
     public native long sendfile(FileDescriptor outFd, FileDescriptor inFd, MutableLong inOffset, long byteCount) throws ErrnoException;
+    public native int sendmmsg(FileDescriptor fd, byte[] bytes, int[] byteOffsets, int[] byteCounts, byte[] addresses, int flags) throws ErrnoException, SocketException;
     public int sendto(FileDescriptor fd, ByteBuffer buffer, int flags, InetAddress inetAddress, int port) throws ErrnoException, SocketException {
         if (buffer.isDirect()) {
             return sendtoBytes(fd, buffer, buffer.position(), buffer.remaining(), flags, inetAddress, port);
@@ -186,6 +229,17 @@ public final class Posix implements Os {
         return sendtoBytes(fd, bytes, byteOffset, byteCount, flags, inetAddress, port);
     }
     private native int sendtoBytes(FileDescriptor fd, Object buffer, int byteOffset, int byteCount, int flags, InetAddress inetAddress, int port) throws ErrnoException, SocketException;
+    public int sendtoErrno(FileDescriptor fd, ByteBuffer buffer, int flags, InetAddress inetAddress, int port) throws InterruptedIOException, SocketException {
+        if (buffer.isDirect()) {
+            return sendtoBytesErrno(fd, buffer, buffer.position(), buffer.remaining(), flags, inetAddress, port);
+        } else {
+            return sendtoBytesErrno(fd, NioUtils.unsafeArray(buffer), NioUtils.unsafeArrayOffset(buffer) + buffer.position(), buffer.remaining(), flags, inetAddress, port);
+        }
+    }
+    public int sendtoErrno(FileDescriptor fd, byte[] bytes, int byteOffset, int byteCount, int flags, InetAddress inetAddress, int port) throws InterruptedIOException, SocketException {
+        return sendtoBytesErrno(fd, bytes, byteOffset, byteCount, flags, inetAddress, port);
+    }
+    private native int sendtoBytesErrno(FileDescriptor fd, Object buffer, int byteOffset, int byteCount, int flags, InetAddress inetAddress, int port) throws InterruptedIOException, SocketException;
     public native void setegid(int egid) throws ErrnoException;
     public native void setenv(String name, String value, boolean overwrite) throws ErrnoException;
     public native void seteuid(int euid) throws ErrnoException;
@@ -198,12 +252,14 @@ public final class Posix implements Os {
     public native void setsockoptGroupReq(FileDescriptor fd, int level, int option, StructGroupReq value) throws ErrnoException;
     public native void setsockoptGroupSourceReq(FileDescriptor fd, int level, int option, StructGroupSourceReq value) throws ErrnoException;
     public native void setsockoptLinger(FileDescriptor fd, int level, int option, StructLinger value) throws ErrnoException;
+    public native void setsockoptMany(FileDescriptor fd, int[] levelOptionValues) throws ErrnoException;
     public native void setsockoptTimeval(FileDescriptor fd, int level, int option, StructTimeval value) throws ErrnoException;
     public native void setuid(int uid) throws ErrnoException;
     public native void shutdown(FileDescriptor fd, int how) throws ErrnoException;
     public native FileDescriptor socket(int domain, int type, int protocol) throws ErrnoException;
     public native void socketpair(int domain, int type, int protocol, FileDescriptor fd1, FileDescriptor fd2) throws ErrnoException;
     public native StructStat stat(String path) throws ErrnoException;
+    public native void statInto(String path, long[] out) throws ErrnoException;
     public native StructStatVfs statvfs(String path) throws ErrnoException;
     public native String strerror(int errno);
     public native String strsignal(int signal);
@@ -211,6 +267,7 @@ public final class Posix implements Os {
     public native long sysconf(int name);
     public native void tcdrain(FileDescriptor fd) throws ErrnoException;
     public native void tcsendbreak(FileDescriptor fd, int duration) throws ErrnoException;
+    public native long transfer(FileDescriptor inFd, MutableLong inOffset, FileDescriptor outFd, long byteCount) throws ErrnoException;
     public int umask(int mask) {
         if ((mask & 0777) != mask) {
             throw new IllegalArgumentException("Invalid umask: " + mask);
@@ -233,5 +290,16 @@ public final class Posix implements Os {
         return writeBytes(fd, bytes, byteOffset, byteCount);
     }
     private native int writeBytes(FileDescriptor fd, Object buffer, int offset, int byteCount) throws ErrnoException, InterruptedIOException;
+    public int writeErrno(FileDescriptor fd, ByteBuffer buffer) throws InterruptedIOException {
+        if (buffer.isDirect()) {
+            return writeBytesErrno(fd, buffer, buffer.position(), buffer.remaining());
+        } else {
+            return writeBytesErrno(fd, NioUtils.unsafeArray(buffer), NioUtils.unsafeArrayOffset(buffer) + buffer.position(), buffer.remaining());
+        }
+    }
+    public int writeErrno(FileDescriptor fd, byte[] bytes, int byteOffset, int byteCount) throws InterruptedIOException {
+        return writeBytesErrno(fd, bytes, byteOffset, byteCount);
+    }
+    private native int writeBytesErrno(FileDescriptor fd, Object buffer, int offset, int byteCount) throws InterruptedIOException;
     public native int writev(FileDescriptor fd, Object[] buffers, int[] offsets, int[] byteCounts) throws ErrnoException, InterruptedIOException;
 }
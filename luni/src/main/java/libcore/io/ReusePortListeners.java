@@ -0,0 +1,92 @@
+/*
+ * Copyright (C) 2014 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+package libcore.io;
+
+import android.system.ErrnoException;
+import java.io.FileDescriptor;
+import java.net.InetAddress;
+import java.net.InetSocketAddress;
+import java.net.SocketException;
+import static android.system.OsConstants.*;
+
+/**
+ * Opens a group of TCP listeners sharing one address and port through SO_REUSEPORT. The kernel
+ * spreads incoming connections across them, so each worker thread can accept from its own
+ * listener rather than every worker contending for a single accept queue.
+ *
+ * <p>Where SO_INCOMING_CPU is supported, listener {@code i} is also tagged with CPU
+ * {@code i % Runtime.getRuntime().availableProcessors()}. The kernel then prefers that
+ * listener for connections whose packets arrive on that CPU. A worker that runs on (or is
+ * pinned to) the matching CPU accepts connections that are already cache-local. Pinning the
+ * workers is left to the caller.
+ */
+public final class ReusePortListeners {
+    private ReusePortListeners() {
+    }
+
+    /**
+     * Opens {@code count} listeners on {@code address} and {@code port}, and returns their
+     * file descriptors. If {@code port} is 0, the first listener gets an ephemeral port, and
+     * the rest share it. {@code extraOptions} (which may be null) holds (level, option, value)
+     * triples set on every listener before it binds, as for {@link Os#setsockoptMany}.
+     * If anything fails, the listeners opened so far are closed before the exception
+     * propagates.
+     */
+    public static FileDescriptor[] open(InetAddress address, int port, int count, int backlog,
+            int[] extraOptions) throws ErrnoException, SocketException {
+        if (count <= 0) {
+            throw new IllegalArgumentException("count <= 0: " + count);
+        }
+        if (SO_REUSEPORT == 0) {
+            throw new ErrnoException("setsockopt", ENOPROTOOPT);
+        }
+        int cpuCount = Runtime.getRuntime().availableProcessors();
+        int[] options = { SOL_SOCKET, SO_REUSEADDR, 1, SOL_SOCKET, SO_REUSEPORT, 1 };
+        FileDescriptor[] result = new FileDescriptor[count];
+        boolean success = false;
+        try {
+            for (int i = 0; i < count; ++i) {
+                FileDescriptor fd = Libcore.os.socket(AF_INET6, SOCK_STREAM, 0);
+                result[i] = fd;
+                Libcore.os.setsockoptMany(fd, options);
+                if (extraOptions != null) {
+                    Libcore.os.setsockoptMany(fd, extraOptions);
+                }
+                if (SO_INCOMING_CPU != 0) {
+                    try {
+                        Libcore.os.setsockoptInt(fd, SOL_SOCKET, SO_INCOMING_CPU, i % cpuCount);
+                    } catch (ErrnoException e) {
+                        // Older kernels only support getting SO_INCOMING_CPU; it's only a hint.
+                    }
+                }
+                Libcore.os.bind(fd, address, port);
+                if (port == 0) {
+                    port = ((InetSocketAddress) Libcore.os.getsockname(fd)).getPort();
+                }
+                Libcore.os.listen(fd, backlog);
+            }
+            success = true;
+            return result;
+        } finally {
+            if (!success) {
+                for (FileDescriptor fd : result) {
+                    IoUtils.closeQuietly(fd);
+                }
+            }
+        }
+    }
+}
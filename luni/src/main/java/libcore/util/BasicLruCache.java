@@ -60,6 +60,18 @@ public class BasicLruCache<K, V> {
         return result;
     }
 
+    /**
+     * Returns the value for {@code key} if it exists in the cache, without
+     * calling {@code #create}. If a value was returned, it is moved to the
+     * head of the queue.
+     */
+    public synchronized final V getIfCached(K key) {
+        if (key == null) {
+            throw new NullPointerException("key == null");
+        }
+        return map.get(key);
+    }
+
     /**
      * Caches {@code value} for {@code key}. The value is moved to the head of
      * the queue.
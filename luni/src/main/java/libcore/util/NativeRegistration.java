@@ -0,0 +1,36 @@
+/*
+ * Copyright (C) 2014 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+package libcore.util;
+
+/**
+ * Registers the native methods that libjavacore leaves until first use when it's built with
+ * {@code LIBCORE_LAZY_REGISTRATION=true}: those of the ICU-backed classes, whose registration
+ * also maps ICU's data file. Each such class calls {@link #ensureRegistered} from its static
+ * initializer. In a normal build their natives are registered when libjavacore is loaded, and
+ * this does nothing.
+ */
+public final class NativeRegistration {
+    private NativeRegistration() {
+    }
+
+    /**
+     * Registers the natives of the class with the JNI name {@code className}, such as
+     * {@code "libcore/icu/ICU"}, if that hasn't already been done.
+     */
+    public static native void ensureRegistered(String className);
+}
@@ -22,6 +22,8 @@ import java.io.Reader;
 import java.net.URI;
 import java.net.URL;
 import java.net.URLConnection;
+import java.nio.ByteBuffer;
+import java.nio.NioUtils;
 import libcore.io.IoUtils;
 import org.xml.sax.Attributes;
 import org.xml.sax.ContentHandler;
@@ -32,6 +34,7 @@ import org.xml.sax.Locator;
 import org.xml.sax.SAXException;
 import org.xml.sax.SAXParseException;
 import org.xml.sax.ext.LexicalHandler;
+import org.xml.sax.helpers.AttributesImpl;
 
 /**
  * Adapts SAX API to the Expat native XML parser. Not intended for reuse
@@ -61,6 +64,10 @@ class ExpatParser {
 
     private final ExpatAttributes attributes = new CurrentAttributes();
 
+    /** Attributes of the current element when events are batched. */
+    private final BatchedAttributes batchedAttributes = new BatchedAttributes();
+    private boolean inBatchedStartElement = false;
+
     private static final String OUTSIDE_START_ELEMENT
             = "Attributes can only be used within the scope of startElement().";
 
@@ -73,11 +80,28 @@ class ExpatParser {
     /** Timeout for HTTP connections (in ms) */
     private static final int TIMEOUT = 20 * 1000;
 
+    /*
+     * Event types recorded by the native parser in batched mode. These must
+     * match the BatchedEventType values in ExpatParser.cpp.
+     */
+    private static final int EVENT_START_ELEMENT = 1;
+    private static final int EVENT_END_ELEMENT = 2;
+    private static final int EVENT_TEXT = 3;
+    private static final int EVENT_START_NAMESPACE = 4;
+    private static final int EVENT_END_NAMESPACE = 5;
+
+    /** Ints per attribute in a batched start element event. */
+    private static final int BATCHED_ATTRIBUTE_SIZE = 5;
+
     /**
-     * Constructs a new parser with the specified encoding.
+     * Constructs a new parser with the specified encoding. If {@code
+     * batchEvents} is true, the native parser records element, text and
+     * namespace events and hands them to {@link #handleEvents} in bulk. The
+     * locator then reports the position at which the batch was delivered.
      */
     /*package*/ ExpatParser(String encoding, ExpatReader xmlReader,
-            boolean processNamespaces, String publicId, String systemId) {
+            boolean processNamespaces, boolean batchEvents, String publicId,
+            String systemId) {
         this.publicId = publicId;
         this.systemId = systemId;
 
@@ -93,7 +117,8 @@ class ExpatParser {
         this.encoding = encoding == null ? DEFAULT_ENCODING : encoding;
         this.pointer = initialize(
             this.encoding,
-            processNamespaces
+            processNamespaces,
+            batchEvents
         );
     }
 
@@ -114,7 +139,8 @@ class ExpatParser {
      *
      * @return the pointer to the native parser
      */
-    private native long initialize(String encoding, boolean namespacesEnabled);
+    private native long initialize(String encoding, boolean namespacesEnabled,
+            boolean batchEvents);
 
     /**
      * Called at the start of an element.
@@ -149,6 +175,26 @@ class ExpatParser {
         }
     }
 
+    /**
+     * Called at the start of an element whose event was batched.
+     */
+    /*package*/ void startElement(String uri, String localName, String qName,
+            Attributes attributes) throws SAXException {
+        ContentHandler contentHandler = xmlReader.contentHandler;
+        if (contentHandler == null) {
+            return;
+        }
+
+        try {
+            inStartElement = true;
+            inBatchedStartElement = true;
+            contentHandler.startElement(uri, localName, qName, attributes);
+        } finally {
+            inStartElement = false;
+            inBatchedStartElement = false;
+        }
+    }
+
     /*package*/ void endElement(String uri, String localName, String qName)
             throws SAXException {
         ContentHandler contentHandler = xmlReader.contentHandler;
@@ -237,6 +283,54 @@ class ExpatParser {
         }
     }
 
+    /**
+     * Delivers a batch of events recorded by the native parser.
+     *
+     * @param events the encoded events: each is a type followed by its
+     *  arguments, with names as indices into {@code names}
+     * @param eventCount the number of ints of {@code events} in use
+     * @param text the characters of text events and attribute values
+     * @param names interned names
+     */
+    /*package*/ void handleEvents(int[] events, int eventCount, char[] text,
+            String[] names) throws SAXException {
+        int i = 0;
+        while (i < eventCount) {
+            switch (events[i]) {
+            case EVENT_START_ELEMENT: {
+                int attributeCount = events[i + 4];
+                batchedAttributes.set(events, i + 5, attributeCount, text, names);
+                startElement(names[events[i + 1]], names[events[i + 2]],
+                        names[events[i + 3]], batchedAttributes);
+                i += 5 + attributeCount * BATCHED_ATTRIBUTE_SIZE;
+                break;
+            }
+            case EVENT_END_ELEMENT:
+                endElement(names[events[i + 1]], names[events[i + 2]], names[events[i + 3]]);
+                i += 4;
+                break;
+            case EVENT_TEXT: {
+                ContentHandler contentHandler = xmlReader.contentHandler;
+                if (contentHandler != null) {
+                    contentHandler.characters(text, events[i + 1], events[i + 2]);
+                }
+                i += 3;
+                break;
+            }
+            case EVENT_START_NAMESPACE:
+                startNamespace(names[events[i + 1]], names[events[i + 2]]);
+                i += 3;
+                break;
+            case EVENT_END_NAMESPACE:
+                endNamespace(names[events[i + 1]]);
+                i += 2;
+                break;
+            default:
+                throw new AssertionError("Unknown event " + events[i]);
+            }
+        }
+    }
+
     /**
      * Handles an external entity.
      *
@@ -465,6 +559,33 @@ class ExpatParser {
     private native void appendBytes(long pointer, byte[] xml, int offset,
             int length) throws SAXException, ExpatException;
 
+    /**
+     * Appends the remaining bytes of {@code xml} and finishes parsing. A
+     * direct buffer, including one mapping a file, is parsed in place
+     * without being copied. On return the buffer's position is its limit.
+     *
+     * @throws SAXException if an error occurs during parsing
+     */
+    private void appendFinal(ByteBuffer xml) throws SAXException {
+        int byteCount = xml.remaining();
+        try {
+            if (xml.isDirect()) {
+                long address = NioUtils.getDirectBufferAddress(xml) + xml.position();
+                appendAddress(this.pointer, address, byteCount, true);
+            } else {
+                appendBytes(this.pointer, NioUtils.unsafeArray(xml),
+                        NioUtils.unsafeArrayOffset(xml) + xml.position(), byteCount);
+                appendString(this.pointer, "", true);
+            }
+        } catch (ExpatException e) {
+            throw new ParseException(e.getMessage(), this.locator);
+        }
+        xml.position(xml.limit());
+    }
+
+    private native void appendAddress(long pointer, long address, int byteCount,
+            boolean isFinal) throws SAXException, ExpatException;
+
     /**
      * Parses an XML document from the given input stream.
      */
@@ -476,6 +597,15 @@ class ExpatParser {
         endDocument();
     }
 
+    /**
+     * Parses an XML document from the remaining bytes of the given buffer.
+     */
+    /*package*/ void parseDocument(ByteBuffer in) throws SAXException {
+        startDocument();
+        appendFinal(in);
+        endDocument();
+    }
+
     /**
      * Parses an XML Document from the given reader.
      */
@@ -567,6 +697,12 @@ class ExpatParser {
      */
     private static native void releaseParser(long pointer);
 
+    /**
+     * Controls whether parsers created from now on share a process-wide cache
+     * of interned element and attribute names.
+     */
+    /*package*/ static native void setSharedNameCacheEnabled(boolean enabled);
+
     /**
      * Initialize static resources.
      */
@@ -603,6 +739,10 @@ class ExpatParser {
             throw new IllegalStateException(OUTSIDE_START_ELEMENT);
         }
 
+        if (inBatchedStartElement) {
+            return new AttributesImpl(batchedAttributes);
+        }
+
         if (attributeCount == 0) {
             return ClonedAttributes.EMPTY;
         }
@@ -719,6 +859,102 @@ class ExpatParser {
         }
     }
 
+    /**
+     * Attributes of a batched start element event. Like {@link
+     * CurrentAttributes}, these are only valid during startElement().
+     */
+    private static class BatchedAttributes implements Attributes {
+
+        private static final String CDATA = "CDATA";
+
+        private int[] events;
+        private int offset;
+        private int length;
+        private char[] text;
+        private String[] names;
+
+        void set(int[] events, int offset, int length, char[] text, String[] names) {
+            this.events = events;
+            this.offset = offset;
+            this.length = length;
+            this.text = text;
+            this.names = names;
+        }
+
+        private int field(int index, int field) {
+            return events[offset + index * BATCHED_ATTRIBUTE_SIZE + field];
+        }
+
+        public int getLength() {
+            return length;
+        }
+
+        public String getURI(int index) {
+            return (index < 0 || index >= length) ? null : names[field(index, 0)];
+        }
+
+        public String getLocalName(int index) {
+            return (index < 0 || index >= length) ? null : names[field(index, 1)];
+        }
+
+        public String getQName(int index) {
+            return (index < 0 || index >= length) ? null : names[field(index, 2)];
+        }
+
+        public String getType(int index) {
+            return (index < 0 || index >= length) ? null : CDATA;
+        }
+
+        public String getValue(int index) {
+            return (index < 0 || index >= length)
+                    ? null
+                    : new String(text, field(index, 3), field(index, 4));
+        }
+
+        public int getIndex(String uri, String localName) {
+            if (uri == null) {
+                throw new NullPointerException("uri == null");
+            }
+            if (localName == null) {
+                throw new NullPointerException("localName == null");
+            }
+            for (int i = 0; i < length; i++) {
+                if (uri.equals(getURI(i)) && localName.equals(getLocalName(i))) {
+                    return i;
+                }
+            }
+            return -1;
+        }
+
+        public int getIndex(String qName) {
+            if (qName == null) {
+                throw new NullPointerException("qName == null");
+            }
+            for (int i = 0; i < length; i++) {
+                if (qName.equals(getQName(i))) {
+                    return i;
+                }
+            }
+            return -1;
+        }
+
+        public String getType(String uri, String localName) {
+            return getIndex(uri, localName) == -1 ? null : CDATA;
+        }
+
+        public String getType(String qName) {
+            return getIndex(qName) == -1 ? null : CDATA;
+        }
+
+        public String getValue(String uri, String localName) {
+            return getValue(getIndex(uri, localName));
+        }
+
+        public String getValue(String qName) {
+            return getValue(getIndex(qName));
+        }
+    }
+
     /**
      * Includes line and column in the message.
      */
@@ -783,6 +1019,14 @@ class ExpatParser {
             }
         }
 
+        @Override
+        void startElement(String uri, String localName, String qName,
+                Attributes attributes) throws SAXException {
+            if (depth++ > 0) {
+                super.startElement(uri, localName, qName, attributes);
+            }
+        }
+
         @Override
         void endElement(String uri, String localName, String qName)
                 throws SAXException {
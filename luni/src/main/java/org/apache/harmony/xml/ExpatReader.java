@@ -19,6 +19,7 @@ package org.apache.harmony.xml;
 import java.io.IOException;
 import java.io.InputStream;
 import java.io.Reader;
+import java.nio.ByteBuffer;
 import libcore.io.IoUtils;
 import org.xml.sax.ContentHandler;
 import org.xml.sax.DTDHandler;
@@ -48,6 +49,7 @@ public class ExpatReader implements XMLReader {
 
     private boolean processNamespaces = true;
     private boolean processNamespacePrefixes = false;
+    private boolean batchEvents = false;
 
     private static final String LEXICAL_HANDLER_PROPERTY
             = "http://xml.org/sax/properties/lexical-handler";
@@ -62,6 +64,15 @@ public class ExpatReader implements XMLReader {
                 = BASE_URI + "external-general-entities";
         private static final String EXTERNAL_PARAMETER_ENTITIES
                 = BASE_URI + "external-parameter-entities";
+
+        /**
+         * When true, element, text and namespace events are recorded natively
+         * and delivered to the handlers in bulk. Handlers see the same events
+         * in the same order, but the locator reports the position at which
+         * each batch was delivered rather than that of each event.
+         */
+        private static final String BATCHED_EVENTS
+                = "http://android.com/sax/features/batched-events";
     }
 
     public boolean getFeature(String name)
@@ -88,9 +99,27 @@ public class ExpatReader implements XMLReader {
             return true;
         }
 
+        if (name.equals(Feature.BATCHED_EVENTS)) {
+            return batchEvents;
+        }
+
         throw new SAXNotRecognizedException(name);
     }
 
+    /**
+     * Enables or disables the process-wide name cache for readers that start
+     * parsing after this call. When enabled, interned names are shared across
+     * documents, so a warm cache makes no {@code String.intern()} calls. This
+     * is worthwhile for services that parse many small documents with the
+     * same vocabulary. The cache is bounded; names beyond its capacity are
+     * interned per document as usual.
+     *
+     * @hide
+     */
+    public static void setSharedNameCacheEnabled(boolean enabled) {
+        ExpatParser.setSharedNameCacheEnabled(enabled);
+    }
+
     public void setFeature(String name, boolean value)
             throws SAXNotRecognizedException, SAXNotSupportedException {
         if (name == null) {
@@ -127,6 +156,11 @@ public class ExpatReader implements XMLReader {
             }
         }
 
+        if (name.equals(Feature.BATCHED_EVENTS)) {
+            batchEvents = value;
+            return;
+        }
+
         throw new SAXNotRecognizedException(name);
     }
 
@@ -247,18 +281,7 @@ public class ExpatReader implements XMLReader {
     }
 
     public void parse(InputSource input) throws IOException, SAXException {
-        if (processNamespacePrefixes && processNamespaces) {
-            /*
-             * Expat has XML_SetReturnNSTriplet, but that still doesn't
-             * include xmlns attributes like this feature requires. We may
-             * have to implement namespace processing ourselves if we want
-             * this (not too difficult). We obviously "support" namespace
-             * prefixes if namespaces are disabled.
-             */
-            throw new SAXNotSupportedException("The 'namespace-prefix' " +
-                    "feature is not supported while the 'namespaces' " +
-                    "feature is enabled.");
-        }
+        checkNamespacePrefixesSupported();
 
         // Try the character stream.
         Reader reader = input.getCharacterStream();
@@ -297,12 +320,45 @@ public class ExpatReader implements XMLReader {
         }
     }
 
+    private void checkNamespacePrefixesSupported() throws SAXNotSupportedException {
+        if (processNamespacePrefixes && processNamespaces) {
+            /*
+             * Expat has XML_SetReturnNSTriplet, but that still doesn't
+             * include xmlns attributes like this feature requires. We may
+             * have to implement namespace processing ourselves if we want
+             * this (not too difficult). We obviously "support" namespace
+             * prefixes if namespaces are disabled.
+             */
+            throw new SAXNotSupportedException("The 'namespace-prefix' " +
+                    "feature is not supported while the 'namespaces' " +
+                    "feature is enabled.");
+        }
+    }
+
+    /**
+     * Parses the remaining bytes of {@code xml} as a document. A direct
+     * buffer, such as a file mapped with {@link
+     * java.nio.channels.FileChannel#map}, is parsed in place, so large
+     * documents needn't be read into the Java heap or copied in chunks.
+     *
+     * @param encoding the document's encoding, or null for UTF-8
+     * @hide
+     */
+    public void parse(ByteBuffer xml, String encoding, String publicId, String systemId)
+            throws SAXException {
+        checkNamespacePrefixesSupported();
+        ExpatParser parser =
+            new ExpatParser(encoding, this, processNamespaces, batchEvents, publicId, systemId);
+        parser.parseDocument(xml);
+    }
+
     private void parse(Reader in, String publicId, String systemId)
             throws IOException, SAXException {
         ExpatParser parser = new ExpatParser(
                 ExpatParser.CHARACTER_ENCODING,
                 this,
                 processNamespaces,
+                batchEvents,
                 publicId,
                 systemId
         );
@@ -312,7 +368,8 @@ public class ExpatReader implements XMLReader {
     private void parse(InputStream in, String charsetName, String publicId, String systemId)
             throws IOException, SAXException {
         ExpatParser parser =
-            new ExpatParser(charsetName, this, processNamespaces, publicId, systemId);
+            new ExpatParser(charsetName, this, processNamespaces, batchEvents, publicId,
+                    systemId);
         parser.parseDocument(in);
     }
 
@@ -0,0 +1,131 @@
+/*
+ * Copyright (C) 2014 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#define LOG_TAG "AsyncLogSink"
+
+#include "AsyncLogSink.h"
+#include "cutils/log.h"
+
+#include <errno.h>
+#include <pthread.h>
+#include <sched.h>
+#include <semaphore.h>
+#include <string.h>
+
+/**
+ * This is Dmitry Vyukov's bounded queue, with one consumer. Each slot has a sequence number:
+ * the producer that claims position 'p' may fill in the slot when its sequence is 'p', and the
+ * consumer may read it once the producer has set its sequence to 'p + 1'. The consumer then
+ * sets it to 'p + SLOT_COUNT', making it free for the producer that claims the position a lap
+ * later. Producers also post a semaphore once a message is ready, for the consumer to sleep on.
+ */
+struct AsyncLogSlot {
+    size_t sequence;
+    int priority;
+    const char* tag;
+    char message[ASYNC_LOG_MAX_MESSAGE_LENGTH + 1];
+};
+
+static const size_t SLOT_COUNT = 128; // Must be a power of two.
+static AsyncLogSlot gSlots[SLOT_COUNT];
+static size_t gEnqueuePosition;
+static uint32_t gDroppedCount;
+static sem_t gMessagesAvailable;
+static pthread_once_t gStartOnce = PTHREAD_ONCE_INIT;
+static bool gStarted;
+
+static void* drainAsyncLog(void*) {
+    size_t position = 0;
+    uint32_t reportedDropCount = 0;
+    while (true) {
+        while (sem_wait(&gMessagesAvailable) == -1 && errno == EINTR) {
+        }
+        // Producers can finish out of order, so the semaphore may have been posted by a later
+        // producer than the one filling in this slot. It won't be long.
+        AsyncLogSlot& slot(gSlots[position & (SLOT_COUNT - 1)]);
+        while (__atomic_load_n(&slot.sequence, __ATOMIC_ACQUIRE) != position + 1) {
+            sched_yield();
+        }
+        LOG_PRI(slot.priority, slot.tag, "%s", slot.message);
+        __atomic_store_n(&slot.sequence, position + SLOT_COUNT, __ATOMIC_RELEASE);
+        ++position;
+
+        uint32_t dropCount = __atomic_load_n(&gDroppedCount, __ATOMIC_RELAXED);
+        if (dropCount != reportedDropCount) {
+            ALOGW("Dropped %u log messages because the queue was full",
+                  dropCount - reportedDropCount);
+            reportedDropCount = dropCount;
+        }
+    }
+    return NULL;
+}
+
+static void startAsyncLog() {
+    for (size_t i = 0; i < SLOT_COUNT; ++i) {
+        gSlots[i].sequence = i;
+    }
+    if (sem_init(&gMessagesAvailable, 0, 0) == -1) {
+        return;
+    }
+    pthread_attr_t attributes;
+    pthread_attr_init(&attributes);
+    pthread_attr_setdetachstate(&attributes, PTHREAD_CREATE_DETACHED);
+    pthread_t thread;
+    gStarted = (pthread_create(&thread, &attributes, drainAsyncLog, NULL) == 0);
+    pthread_attr_destroy(&attributes);
+}
+
+bool asyncLog(int priority, const char* tag, const char* message, size_t length) {
+    pthread_once(&gStartOnce, startAsyncLog);
+    if (!gStarted) {
+        LOG_PRI(priority, tag, "%.*s", static_cast<int>(length), message);
+        return true;
+    }
+
+    size_t position = __atomic_load_n(&gEnqueuePosition, __ATOMIC_RELAXED);
+    AsyncLogSlot* slot;
+    while (true) {
+        slot = &gSlots[position & (SLOT_COUNT - 1)];
+        size_t sequence = __atomic_load_n(&slot->sequence, __ATOMIC_ACQUIRE);
+        intptr_t difference = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(position);
+        if (difference == 0) {
+            // The slot is free. Try to claim it (which updates 'position' if we lose the race).
+            if (__atomic_compare_exchange_n(&gEnqueuePosition, &position, position + 1, true,
+                                            __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+                break;
+            }
+        } else if (difference < 0) {
+            // The consumer hasn't finished with this slot from the last lap: we're full.
+            __atomic_add_fetch(&gDroppedCount, 1, __ATOMIC_RELAXED);
+            return false;
+        } else {
+            // Another producer claimed this position first.
+            position = __atomic_load_n(&gEnqueuePosition, __ATOMIC_RELAXED);
+        }
+    }
+
+    slot->priority = priority;
+    slot->tag = tag;
+    memcpy(slot->message, message, length);
+    slot->message[length] = '\0';
+    __atomic_store_n(&slot->sequence, position + 1, __ATOMIC_RELEASE);
+    sem_post(&gMessagesAvailable);
+    return true;
+}
+
+uint32_t asyncLogDroppedCount() {
+    return __atomic_load_n(&gDroppedCount, __ATOMIC_RELAXED);
+}
@@ -0,0 +1,40 @@
+/*
+ * Copyright (C) 2014 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ASYNC_LOG_SINK_H_included
+#define ASYNC_LOG_SINK_H_included
+
+#include <stddef.h>
+#include <stdint.h>
+
+// A bounded queue of log messages that a background thread writes to the log, so that threads
+// logging never wait for the log device. Any number of threads can log at once without taking
+// a lock. When the queue is full, messages are dropped and counted, and the background thread
+// logs how many were dropped once it catches up.
+
+// The longest message the queue can hold, in bytes, not counting the terminating NUL.
+#define ASYNC_LOG_MAX_MESSAGE_LENGTH 1023
+
+// Queues the 'length' bytes of 'message', which needn't be NUL-terminated, to be logged with
+// 'priority' and 'tag'. 'length' must be at most ASYNC_LOG_MAX_MESSAGE_LENGTH, and 'tag' must
+// remain valid forever (a string literal, say). If the background thread can't be started,
+// this logs synchronously instead. Returns false if the message was dropped.
+bool asyncLog(int priority, const char* tag, const char* message, size_t length);
+
+// Returns the number of messages dropped because the queue was full.
+uint32_t asyncLogDroppedCount();
+
+#endif  // ASYNC_LOG_SINK_H_included
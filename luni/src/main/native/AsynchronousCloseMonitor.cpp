@@ -17,25 +17,48 @@
 #define LOG_TAG "AsynchronousCloseMonitor"
 
 #include "AsynchronousCloseMonitor.h"
+#include "AdaptiveMutex.h"
 #include "cutils/log.h"
+#include "ScopedPthreadRwLock.h"
 
 #include <errno.h>
 #include <signal.h>
+#include <stdint.h>
 #include <string.h>
 
 /**
- * We use an intrusive doubly-linked list to keep track of blocked threads.
- * This gives us O(1) insertion and removal, and means we don't need to do any allocation.
- * (The objects themselves are stack-allocated.)
- * Waking potentially-blocked threads when a file descriptor is closed is O(n) in the total number
- * of blocked threads (not the number of threads actually blocked on the file descriptor in
- * question). For now at least, this seems like a good compromise for Android.
+ * We keep track of blocked threads in a hash table keyed by file descriptor. Each bucket is an
+ * intrusive doubly-linked list with its own lock. This gives us O(1) insertion and removal, means
+ * we don't need to do any allocation (the objects themselves are stack-allocated), and means
+ * threads blocking on different file descriptors rarely contend for the same lock. Each critical
+ * section is a handful of pointer updates, so the locks spin briefly before blocking.
+ * Waking potentially-blocked threads when a file descriptor is closed is O(n) in the number of
+ * threads blocked on file descriptors that share that file descriptor's bucket.
  */
-static pthread_mutex_t blockedThreadListMutex = PTHREAD_MUTEX_INITIALIZER;
-static AsynchronousCloseMonitor* blockedThreadList = NULL;
+static const unsigned BLOCKED_THREAD_BUCKET_BITS = 8;
+static const size_t BLOCKED_THREAD_BUCKET_COUNT = 1 << BLOCKED_THREAD_BUCKET_BITS;
+
+class BlockedThreadBucket {
+public:
+    BlockedThreadBucket() : head(NULL) {
+    }
+
+    AdaptiveMutex mutex;
+    AsynchronousCloseMonitor* head;
+} __attribute__((aligned(64))); // Keep each bucket's lock on its own cache line.
+
+static BlockedThreadBucket blockedThreadBuckets[BLOCKED_THREAD_BUCKET_COUNT];
+
+static BlockedThreadBucket& bucketFor(SOCKET fd) {
+    // File descriptors are allocated densely (and Windows sockets are multiples of 4), so use a
+    // multiplicative hash rather than just the low bits.
+    uint32_t hash = static_cast<uint32_t>(fd) * 2654435761U;
+    return blockedThreadBuckets[hash >> (32 - BLOCKED_THREAD_BUCKET_BITS)];
+}
 
 #if defined(__MINGW32__) || defined(__MINGW64__)
-static pthread_mutex_t blockedPollMutex = PTHREAD_MUTEX_INITIALIZER;
+// Guards unlockPairs, which changes only as polling threads come and go.
+static pthread_rwlock_t blockedPollLock = PTHREAD_RWLOCK_INITIALIZER;
 std::map<DWORD, UnlockPair*> AsynchronousCloseMonitor::unlockPairs;
 #endif
 
@@ -66,13 +89,41 @@ VOID CALLBACK closeSocketApcCallback(ULONG_PTR socketParam) {
 
 #include "mingw-extensions.h"
 
+static pthread_key_t unlockPairKey;
+static pthread_once_t unlockPairKeyOnce = PTHREAD_ONCE_INIT;
+
+static void createUnlockPairKey() {
+	pthread_key_create(&unlockPairKey, UnlockPair::destroy);
+}
+
+UnlockPair* UnlockPair::forCurrentThread() {
+	pthread_once(&unlockPairKeyOnce, createUnlockPairKey);
+	UnlockPair* result = reinterpret_cast<UnlockPair*>(pthread_getspecific(unlockPairKey));
+	if (result == NULL) {
+		result = new UnlockPair();
+		if (result->end1 == INVALID_SOCKET) {
+			delete result;
+			return NULL;
+		}
+		pthread_setspecific(unlockPairKey, result);
+	}
+	return result;
+}
+
+void UnlockPair::destroy(void* unlockPair) {
+	delete reinterpret_cast<UnlockPair*>(unlockPair);
+}
+
 UnlockPair::UnlockPair() {
-	ScopedPthreadMutexLock pollLock(&blockedPollMutex);
+	ScopedPthreadWriteLock pollLock(&blockedPollLock);
 	pushed = false;
 	pthread_mutex_init(&pushMutex, NULL);
 	
 	int pipefd[2];
-	pipe(pipefd);
+	if (pipe(pipefd) == -1) {
+		end1 = end2 = INVALID_SOCKET;
+		return;
+	}
 	
 	end1 = static_cast<SOCKET>(pipefd[0]);
 	end2 = static_cast<SOCKET>(pipefd[1]);
@@ -85,7 +136,6 @@ void UnlockPair::push() {
 	ScopedPthreadMutexLock pushLock(&pushMutex);
 	if (!pushed) {
 		char byteToSend = 123;
-		//__mingw_printf("[sending]");
 		int ret = send(end1, &byteToSend, 1, 0);
 		if (ret != -1) {
 			pushed = true;
@@ -95,26 +145,29 @@ void UnlockPair::push() {
 	}
 }
 
-void UnlockPair::pop() {
+bool UnlockPair::pop() {
 	ScopedPthreadMutexLock pushLock(&pushMutex);
 	if (pushed) {
 		char byteToRecv;
-		//__mingw_printf("[receiveing]");
 		int ret = recv(end2, &byteToRecv, 1, 0);
 		if (ret != -1) {
 			pushed = false;
+			return true;
 		} else {
 			__mingw_printf("Can't receive a byte to the unlocking pair: %d", WSAGetLastError());
 		}
 	}
+	return false;
 }
 
 UnlockPair::~UnlockPair() {
-	ScopedPthreadMutexLock pollLock(&blockedPollMutex);
-	DWORD threadId = GetCurrentThreadId();
-	closesocket(end1);
-	closesocket(end2);
-	AsynchronousCloseMonitor::unlockPairs.erase(threadId);
+	ScopedPthreadWriteLock pollLock(&blockedPollLock);
+	if (end1 != INVALID_SOCKET) {
+		DWORD threadId = GetCurrentThreadId();
+		closesocket(end1);
+		closesocket(end2);
+		AsynchronousCloseMonitor::unlockPairs.erase(threadId);
+	}
 	pthread_mutex_destroy(&pushMutex);
 }
 #endif
@@ -136,8 +189,9 @@ void AsynchronousCloseMonitor::init() {
 }
 
 void AsynchronousCloseMonitor::signalBlockedThreads(SOCKET fd) {
-    ScopedPthreadMutexLock lock(&blockedThreadListMutex);
-    for (AsynchronousCloseMonitor* it = blockedThreadList; it != NULL; it = it->mNext) {
+    BlockedThreadBucket& bucket = bucketFor(fd);
+    ScopedAdaptiveMutexLock lock(&bucket.mutex);
+    for (AsynchronousCloseMonitor* it = bucket.head; it != NULL; it = it->mNext) {
         if (it->mFd == fd) {
             it->mSignaled = true;
 #if !defined(__MINGW32__) && !defined(__MINGW64__)
@@ -145,7 +199,7 @@ void AsynchronousCloseMonitor::signalBlockedThreads(SOCKET fd) {
 #else
             HANDLE hThread = OpenThread(THREAD_SET_CONTEXT, FALSE, it->mThreadId);
 			{
-				ScopedPthreadMutexLock pollLock(&blockedPollMutex);
+				ScopedPthreadReadLock pollLock(&blockedPollLock);
 
 				if (unlockPairs.find(it->mThreadId) != unlockPairs.end()) {
 					UnlockPair& up = *(unlockPairs.at(it->mThreadId));
@@ -166,7 +220,8 @@ bool AsynchronousCloseMonitor::wasSignaled() const {
 }
 
 AsynchronousCloseMonitor::AsynchronousCloseMonitor(SOCKET fd) {
-    ScopedPthreadMutexLock lock(&blockedThreadListMutex);
+    BlockedThreadBucket& bucket = bucketFor(fd);
+    ScopedAdaptiveMutexLock lock(&bucket.mutex);
     // Who are we, and what are we waiting for?
 #if !defined(__MINGW32__) && !defined(__MINGW64__)
     mThread = pthread_self();
@@ -175,23 +230,24 @@ AsynchronousCloseMonitor::AsynchronousCloseMonitor(SOCKET fd) {
 #endif
     mFd = fd;
     mSignaled = false;
-    // Insert ourselves at the head of the intrusive doubly-linked list...
+    // Insert ourselves at the head of our bucket's intrusive doubly-linked list...
     mPrev = NULL;
-    mNext = blockedThreadList;
+    mNext = bucket.head;
     if (mNext != NULL) {
         mNext->mPrev = this;
     }
-    blockedThreadList = this;
+    bucket.head = this;
 }
 
 AsynchronousCloseMonitor::~AsynchronousCloseMonitor() {
-    ScopedPthreadMutexLock lock(&blockedThreadListMutex);
-    // Unlink ourselves from the intrusive doubly-linked list...
+    BlockedThreadBucket& bucket = bucketFor(mFd);
+    ScopedAdaptiveMutexLock lock(&bucket.mutex);
+    // Unlink ourselves from our bucket's intrusive doubly-linked list...
     if (mNext != NULL) {
         mNext->mPrev = mPrev;
     }
     if (mPrev == NULL) {
-        blockedThreadList = mNext;
+        bucket.head = mNext;
     } else {
         mPrev->mNext = mNext;
     }
@@ -30,16 +30,26 @@
 #endif
 
 #if defined(__MINGW32__) || defined(__MINGW64__)
+/**
+ * Windows can't interrupt a blocked poll() with a signal, so each polling thread also polls
+ * end2 of its own connected socket pair, and signalBlockedThreads writes a byte to end1.
+ */
 class UnlockPair {
 private:
 	pthread_mutex_t pushMutex;
 	bool pushed;
-public:
-	SOCKET end1, end2;
 	UnlockPair();
 	~UnlockPair();
+public:
+	SOCKET end1, end2;
+	// Returns the calling thread's pair, creating it on first use. It lives until the thread
+	// exits, or NULL if it couldn't be created.
+	static UnlockPair* forCurrentThread();
+	// Thread-exit destructor for the pair returned by forCurrentThread.
+	static void destroy(void* unlockPair);
 	void push();
-	void pop();
+	// Consumes a pending push, if any. Returns true if there was one.
+	bool pop();
 };
 #endif
 
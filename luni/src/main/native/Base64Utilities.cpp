@@ -0,0 +1,543 @@
+/*
+ * Copyright (C) 2014 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#define LOG_TAG "Base64Utilities"
+
+#include "Base64Utilities.h"
+
+#include <stdint.h>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+// SSSE3 and AVX2 kernels are compiled with per-function target attributes and chosen at
+// runtime, so the library as a whole still runs on CPUs that only have SSE2.
+#include <immintrin.h>
+#define BASE64_HAVE_X86 1
+#elif defined(__aarch64__) && defined(__ARM_NEON)
+#include <arm_neon.h>
+#include <pthread.h>
+#define BASE64_HAVE_NEON 1
+#endif
+
+static const uint8_t ENCODE_TABLE[64] = {
+    'A', 'B', 'C', 'D', 'E', 'F', 'G', 'H', 'I', 'J', 'K', 'L', 'M', 'N', 'O', 'P',
+    'Q', 'R', 'S', 'T', 'U', 'V', 'W', 'X', 'Y', 'Z', 'a', 'b', 'c', 'd', 'e', 'f',
+    'g', 'h', 'i', 'j', 'k', 'l', 'm', 'n', 'o', 'p', 'q', 'r', 's', 't', 'u', 'v',
+    'w', 'x', 'y', 'z', '0', '1', '2', '3', '4', '5', '6', '7', '8', '9', '+', '/',
+};
+
+// The value of each Base64 char, WHITESPACE for the chars lenient decoding skips, and
+// INVALID for everything else (including '=', which is handled separately).
+static const int8_t INVALID = -1;
+static const int8_t WHITESPACE = -2;
+static const int8_t DECODE_TABLE[256] = {
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -2, -2, -1, -1, -2, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -2, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 62, -1, -1, -1, 63,
+    52, 53, 54, 55, 56, 57, 58, 59, 60, 61, -1, -1, -1, -1, -1, -1,
+    -1,  0,  1,  2,  3,  4,  5,  6,  7,  8,  9, 10, 11, 12, 13, 14,
+    15, 16, 17, 18, 19, 20, 21, 22, 23, 24, 25, -1, -1, -1, -1, -1,
+    -1, 26, 27, 28, 29, 30, 31, 32, 33, 34, 35, 36, 37, 38, 39, 40,
+    41, 42, 43, 44, 45, 46, 47, 48, 49, 50, 51, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,};
+
+//
+// Scalar loops. These define the semantics; the vector kernels below must match them exactly.
+//
+
+static inline void scalarEncodeGroup(const uint8_t* src, uint8_t* dst) {
+    dst[0] = ENCODE_TABLE[src[0] >> 2];
+    dst[1] = ENCODE_TABLE[((src[0] & 0x03) << 4) | (src[1] >> 4)];
+    dst[2] = ENCODE_TABLE[((src[1] & 0x0f) << 2) | (src[2] >> 6)];
+    dst[3] = ENCODE_TABLE[src[2] & 0x3f];
+}
+
+// Decodes one group of four chars. Returns false if any of them isn't a Base64 char.
+static inline bool scalarDecodeGroup(const uint8_t* src, uint8_t* dst) {
+    int a = DECODE_TABLE[src[0]];
+    int b = DECODE_TABLE[src[1]];
+    int c = DECODE_TABLE[src[2]];
+    int d = DECODE_TABLE[src[3]];
+    if ((a | b | c | d) < 0) {
+        return false;
+    }
+    uint32_t group = (a << 18) | (b << 12) | (c << 6) | d;
+    dst[0] = static_cast<uint8_t>(group >> 16);
+    dst[1] = static_cast<uint8_t>(group >> 8);
+    dst[2] = static_cast<uint8_t>(group);
+    return true;
+}
+
+#if defined(BASE64_HAVE_X86)
+
+//
+// SSSE3 and AVX2. These are Wojciech Muła's pshufb-based algorithms: encoding spreads each
+// 3 bytes over four 6-bit lanes with multiplies and then maps the lanes to ASCII with a
+// 16-entry offset table; decoding validates and maps each char by looking up its high and low
+// nibbles, then packs the 6-bit values back together with multiply-adds.
+//
+
+static bool cpuHasSsse3() {
+    static const bool hasSsse3 = __builtin_cpu_supports("ssse3");
+    return hasSsse3;
+}
+
+static bool cpuHasAvx2() {
+    static const bool hasAvx2 = __builtin_cpu_supports("avx2");
+    return hasAvx2;
+}
+
+__attribute__((target("ssse3")))
+static inline __m128i encodeSpreadSsse3(__m128i in) {
+    in = _mm_shuffle_epi8(in, _mm_set_epi8(10, 11, 9, 10, 7, 8, 6, 7, 4, 5, 3, 4, 1, 2, 0, 1));
+    __m128i t0 = _mm_and_si128(in, _mm_set1_epi32(0x0fc0fc00));
+    __m128i t1 = _mm_mulhi_epu16(t0, _mm_set1_epi32(0x04000040));
+    __m128i t2 = _mm_and_si128(in, _mm_set1_epi32(0x003f03f0));
+    __m128i t3 = _mm_mullo_epi16(t2, _mm_set1_epi32(0x01000010));
+    return _mm_or_si128(t1, t3);
+}
+
+__attribute__((target("ssse3")))
+static inline __m128i encodeTranslateSsse3(__m128i indices) {
+    const __m128i offsets = _mm_setr_epi8('a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+            '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '+' - 62, '/' - 63, 'A',
+            0, 0);
+    // 0..25 -> 13, 26..51 -> 0, 52..61 -> 1..10, 62 -> 11, 63 -> 12.
+    __m128i selector = _mm_subs_epu8(indices, _mm_set1_epi8(51));
+    __m128i isUpper = _mm_cmpgt_epi8(_mm_set1_epi8(26), indices);
+    selector = _mm_or_si128(selector, _mm_and_si128(isUpper, _mm_set1_epi8(13)));
+    return _mm_add_epi8(indices, _mm_shuffle_epi8(offsets, selector));
+}
+
+// Encodes 12 bytes per 16-byte load while a whole load fits. Returns the bytes consumed.
+__attribute__((target("ssse3")))
+static size_t encodeSsse3(const uint8_t* src, size_t length, uint8_t* dst) {
+    size_t i = 0;
+    for (; i + 16 <= length; i += 12, dst += 16) {
+        __m128i in = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst), encodeTranslateSsse3(encodeSpreadSsse3(in)));
+    }
+    return i;
+}
+
+__attribute__((target("avx2")))
+static size_t encodeAvx2(const uint8_t* src, size_t length, uint8_t* dst) {
+    const __m256i spread = _mm256_set_epi8(
+            10, 11, 9, 10, 7, 8, 6, 7, 4, 5, 3, 4, 1, 2, 0, 1,
+            10, 11, 9, 10, 7, 8, 6, 7, 4, 5, 3, 4, 1, 2, 0, 1);
+    const __m256i offsets = _mm256_setr_epi8('a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+            '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '+' - 62, '/' - 63, 'A',
+            0, 0,
+            'a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+            '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '+' - 62, '/' - 63, 'A',
+            0, 0);
+    size_t i = 0;
+    // Each 128-bit lane takes 12 bytes, from two overlapping 16-byte loads.
+    for (; i + 28 <= length; i += 24, dst += 32) {
+        __m128i lo = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+        __m128i hi = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i + 12));
+        __m256i in = _mm256_inserti128_si256(_mm256_castsi128_si256(lo), hi, 1);
+        in = _mm256_shuffle_epi8(in, spread);
+        __m256i t0 = _mm256_and_si256(in, _mm256_set1_epi32(0x0fc0fc00));
+        __m256i t1 = _mm256_mulhi_epu16(t0, _mm256_set1_epi32(0x04000040));
+        __m256i t2 = _mm256_and_si256(in, _mm256_set1_epi32(0x003f03f0));
+        __m256i t3 = _mm256_mullo_epi16(t2, _mm256_set1_epi32(0x01000010));
+        __m256i indices = _mm256_or_si256(t1, t3);
+        __m256i selector = _mm256_subs_epu8(indices, _mm256_set1_epi8(51));
+        __m256i isUpper = _mm256_cmpgt_epi8(_mm256_set1_epi8(26), indices);
+        selector = _mm256_or_si256(selector, _mm256_and_si256(isUpper, _mm256_set1_epi8(13)));
+        __m256i out = _mm256_add_epi8(indices, _mm256_shuffle_epi8(offsets, selector));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst), out);
+    }
+    return i;
+}
+
+// Maps 16 chars to their 6-bit values. Returns a mask with a bit set for each char that isn't
+// a Base64 char; 'values' is only meaningful for the others.
+__attribute__((target("ssse3")))
+static inline int decodeTranslateSsse3(__m128i in, __m128i& values) {
+    const __m128i offsets = _mm_setr_epi8(0, 0, 19, 4, -65, -65, -71, -71,
+            0, 0, 0, 0, 0, 0, 0, 0);
+    // For each low nibble, a bit per high nibble saying whether that char is in the alphabet.
+    const __m128i lowNibbleMasks = _mm_setr_epi8(
+            static_cast<char>(0xa8), static_cast<char>(0xf8), static_cast<char>(0xf8),
+            static_cast<char>(0xf8), static_cast<char>(0xf8), static_cast<char>(0xf8),
+            static_cast<char>(0xf8), static_cast<char>(0xf8), static_cast<char>(0xf8),
+            static_cast<char>(0xf8), static_cast<char>(0xf0), 0x54, 0x50, 0x50, 0x50, 0x54);
+    const __m128i highNibbleBits = _mm_setr_epi8(0x01, 0x02, 0x04, 0x08, 0x10, 0x20, 0x40,
+            static_cast<char>(0x80), 0, 0, 0, 0, 0, 0, 0, 0);
+    __m128i highNibbles = _mm_and_si128(_mm_srli_epi32(in, 4), _mm_set1_epi8(0x0f));
+    __m128i lowNibbles = _mm_and_si128(in, _mm_set1_epi8(0x0f));
+    __m128i valid = _mm_and_si128(_mm_shuffle_epi8(lowNibbleMasks, lowNibbles),
+            _mm_shuffle_epi8(highNibbleBits, highNibbles));
+    int invalid = _mm_movemask_epi8(_mm_cmpeq_epi8(valid, _mm_setzero_si128()));
+    // '/' shares its high nibble with '+', but needs an offset of 16 rather than 19.
+    __m128i offset = _mm_shuffle_epi8(offsets, highNibbles);
+    __m128i isSlash = _mm_cmpeq_epi8(in, _mm_set1_epi8('/'));
+    offset = _mm_add_epi8(offset, _mm_and_si128(isSlash, _mm_set1_epi8(-3)));
+    values = _mm_add_epi8(in, offset);
+    return invalid;
+}
+
+// Packs 16 6-bit values into 12 bytes at the bottom of the result.
+__attribute__((target("ssse3")))
+static inline __m128i decodePackSsse3(__m128i values) {
+    __m128i pairs = _mm_maddubs_epi16(values, _mm_set1_epi32(0x01400140));
+    __m128i groups = _mm_madd_epi16(pairs, _mm_set1_epi32(0x00011000));
+    return _mm_shuffle_epi8(groups, _mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12,
+            -1, -1, -1, -1));
+}
+
+// Decodes 16-char blocks of Base64 chars until a block contains anything else, or a 16-byte
+// store would pass 'capacity'. In that final block, the whole groups before the first non-Base64
+// char are decoded too, so a line break costs the caller only its own chars. Returns the chars
+// consumed.
+__attribute__((target("ssse3")))
+static size_t decodeSsse3(const uint8_t* src, size_t length, uint8_t* dst, size_t capacity) {
+    size_t i = 0;
+    size_t o = 0;
+    for (; i + 16 <= length && o + 16 <= capacity; i += 16, o += 12) {
+        __m128i values;
+        int invalid = decodeTranslateSsse3(_mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i)), values);
+        if (invalid != 0) {
+            size_t groupsChars = __builtin_ctz(invalid) & ~3;
+            if (groupsChars > 0) {
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + o), decodePackSsse3(values));
+                i += groupsChars;
+            }
+            break;
+        }
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + o), decodePackSsse3(values));
+    }
+    return i;
+}
+
+__attribute__((target("avx2")))
+static size_t decodeAvx2(const uint8_t* src, size_t length, uint8_t* dst, size_t capacity) {
+    const __m256i offsets = _mm256_setr_epi8(0, 0, 19, 4, -65, -65, -71, -71,
+            0, 0, 0, 0, 0, 0, 0, 0,
+            0, 0, 19, 4, -65, -65, -71, -71,
+            0, 0, 0, 0, 0, 0, 0, 0);
+    const __m256i lowNibbleMasks = _mm256_setr_epi8(
+            static_cast<char>(0xa8), static_cast<char>(0xf8), static_cast<char>(0xf8),
+            static_cast<char>(0xf8), static_cast<char>(0xf8), static_cast<char>(0xf8),
+            static_cast<char>(0xf8), static_cast<char>(0xf8), static_cast<char>(0xf8),
+            static_cast<char>(0xf8), static_cast<char>(0xf0), 0x54, 0x50, 0x50, 0x50, 0x54,
+            static_cast<char>(0xa8), static_cast<char>(0xf8), static_cast<char>(0xf8),
+            static_cast<char>(0xf8), static_cast<char>(0xf8), static_cast<char>(0xf8),
+            static_cast<char>(0xf8), static_cast<char>(0xf8), static_cast<char>(0xf8),
+            static_cast<char>(0xf8), static_cast<char>(0xf0), 0x54, 0x50, 0x50, 0x50, 0x54);
+    const __m256i highNibbleBits = _mm256_setr_epi8(0x01, 0x02, 0x04, 0x08, 0x10, 0x20, 0x40,
+            static_cast<char>(0x80), 0, 0, 0, 0, 0, 0, 0, 0,
+            0x01, 0x02, 0x04, 0x08, 0x10, 0x20, 0x40,
+            static_cast<char>(0x80), 0, 0, 0, 0, 0, 0, 0, 0);
+    const __m256i pack = _mm256_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1,
+            2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1);
+    size_t i = 0;
+    size_t o = 0;
+    for (; i + 32 <= length && o + 32 <= capacity; i += 32, o += 24) {
+        __m256i in = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+        __m256i highNibbles = _mm256_and_si256(_mm256_srli_epi32(in, 4), _mm256_set1_epi8(0x0f));
+        __m256i lowNibbles = _mm256_and_si256(in, _mm256_set1_epi8(0x0f));
+        __m256i valid = _mm256_and_si256(_mm256_shuffle_epi8(lowNibbleMasks, lowNibbles),
+                _mm256_shuffle_epi8(highNibbleBits, highNibbles));
+        if (_mm256_movemask_epi8(_mm256_cmpeq_epi8(valid, _mm256_setzero_si256())) != 0) {
+            break;
+        }
+        __m256i offset = _mm256_shuffle_epi8(offsets, highNibbles);
+        __m256i isSlash = _mm256_cmpeq_epi8(in, _mm256_set1_epi8('/'));
+        offset = _mm256_add_epi8(offset, _mm256_and_si256(isSlash, _mm256_set1_epi8(-3)));
+        __m256i values = _mm256_add_epi8(in, offset);
+        __m256i pairs = _mm256_maddubs_epi16(values, _mm256_set1_epi32(0x01400140));
+        __m256i groups = _mm256_madd_epi16(pairs, _mm256_set1_epi32(0x00011000));
+        __m256i bytes = _mm256_shuffle_epi8(groups, pack);
+        // Close the gap between the lanes' 12-byte results.
+        bytes = _mm256_permutevar8x32_epi32(bytes, _mm256_setr_epi32(0, 1, 2, 4, 5, 6, 3, 7));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + o), bytes);
+    }
+    return i;
+}
+
+#endif  // BASE64_HAVE_X86
+
+#if defined(BASE64_HAVE_NEON)
+
+//
+// NEON. The structured loads and stores do the (de)interleaving of each group of 3 bytes or
+// 4 chars, leaving only shifts and 64-entry table lookups.
+//
+
+static inline uint8x16x4_t loadTable64(const uint8_t* table) {
+    uint8x16x4_t result;
+    result.val[0] = vld1q_u8(table);
+    result.val[1] = vld1q_u8(table + 16);
+    result.val[2] = vld1q_u8(table + 32);
+    result.val[3] = vld1q_u8(table + 48);
+    return result;
+}
+
+static size_t encodeNeon(const uint8_t* src, size_t length, uint8_t* dst) {
+    const uint8x16x4_t table = loadTable64(ENCODE_TABLE);
+    const uint8x16_t mask = vdupq_n_u8(0x3f);
+    size_t i = 0;
+    for (; i + 48 <= length; i += 48, dst += 64) {
+        uint8x16x3_t in = vld3q_u8(src + i);
+        uint8x16x4_t out;
+        out.val[0] = vshrq_n_u8(in.val[0], 2);
+        out.val[1] = vandq_u8(vorrq_u8(vshlq_n_u8(in.val[0], 4), vshrq_n_u8(in.val[1], 4)), mask);
+        out.val[2] = vandq_u8(vorrq_u8(vshlq_n_u8(in.val[1], 2), vshrq_n_u8(in.val[2], 6)), mask);
+        out.val[3] = vandq_u8(in.val[2], mask);
+        for (int j = 0; j < 4; ++j) {
+            out.val[j] = vqtbl4q_u8(table, out.val[j]);
+        }
+        vst4q_u8(dst, out);
+    }
+    return i;
+}
+
+// DECODE_TABLE's first 128 entries as unsigned bytes, with bit 7 set for non-Base64 chars.
+static uint8_t gNeonDecodeTable[128];
+
+static void initNeonDecodeTable() {
+    for (int i = 0; i < 128; ++i) {
+        gNeonDecodeTable[i] = (DECODE_TABLE[i] < 0) ? 0xff : DECODE_TABLE[i];
+    }
+}
+
+static size_t decodeNeon(const uint8_t* src, size_t length, uint8_t* dst, size_t capacity) {
+    static pthread_once_t once = PTHREAD_ONCE_INIT;
+    pthread_once(&once, initNeonDecodeTable);
+    const uint8x16x4_t lo = loadTable64(gNeonDecodeTable);
+    const uint8x16x4_t hi = loadTable64(gNeonDecodeTable + 64);
+    const uint8x16_t sixtyFour = vdupq_n_u8(64);
+    size_t i = 0;
+    size_t o = 0;
+    for (; i + 64 <= length && o + 48 <= capacity; i += 64, o += 48) {
+        uint8x16x4_t in = vld4q_u8(src + i);
+        uint8x16_t invalid = vdupq_n_u8(0);
+        for (int j = 0; j < 4; ++j) {
+            // Indices 0..63 hit the first table and 64..127 the second; anything higher
+            // (non-ASCII) misses both, and is caught by its own bit 7.
+            uint8x16_t c = in.val[j];
+            uint8x16_t v = vqtbx4q_u8(vqtbl4q_u8(lo, c), hi, vsubq_u8(c, sixtyFour));
+            invalid = vorrq_u8(invalid, vorrq_u8(c, v));
+            in.val[j] = v;
+        }
+        if (vmaxvq_u8(invalid) & 0x80) {
+            break;
+        }
+        uint8x16x3_t out;
+        out.val[0] = vorrq_u8(vshlq_n_u8(in.val[0], 2), vshrq_n_u8(in.val[1], 4));
+        out.val[1] = vorrq_u8(vshlq_n_u8(in.val[1], 4), vshrq_n_u8(in.val[2], 2));
+        out.val[2] = vorrq_u8(vshlq_n_u8(in.val[2], 6), in.val[3]);
+        vst3q_u8(dst + o, out);
+    }
+    return i;
+}
+
+#endif  // BASE64_HAVE_NEON
+
+//
+// Dispatch.
+//
+
+static size_t encodeVector(const uint8_t* src, size_t length, uint8_t* dst) {
+    size_t done = 0;
+#if defined(BASE64_HAVE_X86)
+    if (cpuHasAvx2()) {
+        done = encodeAvx2(src, length, dst);
+    }
+    if (cpuHasSsse3()) {
+        done += encodeSsse3(src + done, length - done, dst + done / 3 * 4);
+    }
+#elif defined(BASE64_HAVE_NEON)
+    done = encodeNeon(src, length, dst);
+#endif
+    (void) src; (void) length; (void) dst;
+    return done;
+}
+
+// Returns how many chars (a multiple of 4) the vector kernels decoded, writing 3 bytes for
+// every 4 of them. They stop at the first block that isn't entirely Base64 chars.
+static size_t decodeVector(const uint8_t* src, size_t length, uint8_t* dst, size_t capacity) {
+    size_t done = 0;
+#if defined(BASE64_HAVE_X86)
+    if (cpuHasAvx2()) {
+        done = decodeAvx2(src, length, dst, capacity);
+    }
+    if (cpuHasSsse3()) {
+        size_t written = done / 4 * 3;
+        done += decodeSsse3(src + done, length - done, dst + written, capacity - written);
+    }
+#elif defined(BASE64_HAVE_NEON)
+    done = decodeNeon(src, length, dst, capacity);
+#endif
+    (void) src; (void) length; (void) dst; (void) capacity;
+    return done;
+}
+
+size_t base64Encode(const jbyte* bytes, size_t length, jbyte* chars) {
+    const uint8_t* src = reinterpret_cast<const uint8_t*>(bytes);
+    uint8_t* dst = reinterpret_cast<uint8_t*>(chars);
+    size_t i = encodeVector(src, length, dst);
+    size_t o = i / 3 * 4;
+    for (; i + 3 <= length; i += 3, o += 4) {
+        scalarEncodeGroup(src + i, dst + o);
+    }
+    if (i < length) {
+        uint8_t tail[3] = { src[i], static_cast<uint8_t>((i + 1 < length) ? src[i + 1] : 0), 0 };
+        scalarEncodeGroup(tail, dst + o);
+        if (i + 1 == length) {
+            dst[o + 2] = '=';
+        }
+        dst[o + 3] = '=';
+        o += 4;
+    }
+    return o;
+}
+
+static ssize_t decodeStrict(const uint8_t* src, size_t length, uint8_t* dst, size_t capacity) {
+    if (length % 4 != 0) {
+        return -1;
+    }
+    if (length == 0) {
+        return 0;
+    }
+    size_t pad = (src[length - 1] == '=') ? ((src[length - 2] == '=') ? 2 : 1) : 0;
+    if (length / 4 * 3 - pad > capacity) {
+        return -1;
+    }
+    // Every group but a padded final one is a whole group.
+    size_t wholeEnd = (pad > 0) ? length - 4 : length;
+    size_t i = 0;
+    size_t o = 0;
+    while (i < wholeEnd) {
+        size_t done = decodeVector(src + i, wholeEnd - i, dst + o, capacity - o);
+        i += done;
+        o += done / 4 * 3;
+        if (i < wholeEnd) {
+            if (!scalarDecodeGroup(src + i, dst + o)) {
+                return -1;
+            }
+            i += 4;
+            o += 3;
+        }
+    }
+    if (pad > 0) {
+        int a = DECODE_TABLE[src[i]];
+        int b = DECODE_TABLE[src[i + 1]];
+        int c = (pad == 1) ? DECODE_TABLE[src[i + 2]] : 0;
+        if ((a | b | c) < 0) {
+            return -1;
+        }
+        uint32_t group = (a << 18) | (b << 12) | (c << 6);
+        // The bits the padding stands in for must be zero.
+        if ((pad == 1 && (group & 0xff) != 0) || (pad == 2 && (group & 0xffff) != 0)) {
+            return -1;
+        }
+        dst[o++] = static_cast<uint8_t>(group >> 16);
+        if (pad == 1) {
+            dst[o++] = static_cast<uint8_t>(group >> 8);
+        }
+    }
+    return o;
+}
+
+// This reproduces the original Java loop's treatment of every input, valid or not, except that
+// input that would have overrun the output array is rejected rather than throwing.
+static ssize_t decodeLenient(const uint8_t* src, size_t length, uint8_t* dst, size_t capacity) {
+    if (length == 0) {
+        return 0;
+    }
+    // Count (and drop) the trailing padding, along with any whitespace among it.
+    unsigned pad = 0;
+    for (;; --length) {
+        if (length == 0) {
+            // Nothing but padding and whitespace.
+            return -1;
+        }
+        uint8_t ch = src[length - 1];
+        if (ch == '=') {
+            ++pad;
+        } else if (DECODE_TABLE[ch] != WHITESPACE) {
+            break;
+        }
+    }
+    uint32_t quantum = 0;
+    size_t charCount = 0;
+    size_t o = 0;
+    bool vectorBlocked = false;
+    for (size_t i = 0; i < length; ) {
+        // At a group boundary, try the vector kernels. If they can't make progress (usually
+        // because of a line break), don't try again until the scalar loop has skipped some
+        // whitespace.
+        if ((charCount & 3) == 0 && !vectorBlocked && length - i >= 16 &&
+                DECODE_TABLE[src[i]] >= 0) {
+            size_t done = decodeVector(src + i, length - i, dst + o, capacity - o);
+            if (done > 0) {
+                i += done;
+                charCount += done;
+                o += done / 4 * 3;
+                quantum = (dst[o - 3] << 16) | (dst[o - 2] << 8) | dst[o - 1];
+                continue;
+            }
+            vectorBlocked = true;
+        }
+        int bits = DECODE_TABLE[src[i++]];
+        if (bits == WHITESPACE) {
+            vectorBlocked = false;
+            continue;
+        }
+        if (bits == INVALID) {
+            return -1;
+        }
+        quantum = (quantum << 6) | bits;
+        if ((charCount & 3) == 3) {
+            if (capacity - o < 3) {
+                return -1;
+            }
+            dst[o++] = static_cast<uint8_t>(quantum >> 16);
+            dst[o++] = static_cast<uint8_t>(quantum >> 8);
+            dst[o++] = static_cast<uint8_t>(quantum);
+        }
+        ++charCount;
+    }
+    if (pad > 0) {
+        // As with Java's int shift, only the low five bits of the shift count matter.
+        quantum <<= (6 * pad) & 31;
+        if (capacity - o < ((pad == 1) ? 2u : 1u)) {
+            return -1;
+        }
+        dst[o++] = static_cast<uint8_t>(quantum >> 16);
+        if (pad == 1) {
+            dst[o++] = static_cast<uint8_t>(quantum >> 8);
+        }
+    }
+    return o;
+}
+
+ssize_t base64Decode(const jbyte* chars, size_t length, jbyte* bytes, size_t capacity, bool strict) {
+    const uint8_t* src = reinterpret_cast<const uint8_t*>(chars);
+    uint8_t* dst = reinterpret_cast<uint8_t*>(bytes);
+    return strict ? decodeStrict(src, length, dst, capacity)
+                  : decodeLenient(src, length, dst, capacity);
+}
@@ -0,0 +1,48 @@
+/*
+ * Copyright (C) 2014 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef BASE64_UTILITIES_H_included
+#define BASE64_UTILITIES_H_included
+
+#include "jni.h"
+
+#include <stddef.h>
+#include <sys/types.h>
+
+// RFC 4648 Base64 kernels behind libcore.io.Base64. Like the charset kernels, these work on raw
+// memory. On x86 they use SSSE3, or AVX2 when the CPU supports it; on ARMv8 they use NEON.
+// Input the vector kernels can't take whole is finished by a scalar loop.
+
+// Returns the number of chars base64Encode produces for 'length' bytes.
+inline size_t base64EncodedLength(size_t length) {
+    return (length + 2) / 3 * 4;
+}
+
+// Encodes 'length' bytes as padded Base64 with no line breaks. 'dst' must have room for
+// base64EncodedLength(length) bytes. Returns the number of bytes written.
+size_t base64Encode(const jbyte* src, size_t length, jbyte* dst);
+
+// Decodes 'length' Base64 chars to at most 'capacity' bytes at 'dst'. Returns the number of
+// bytes written, or -1 if the input is malformed (or would need more than 'capacity' bytes).
+//
+// In strict mode, the input must be canonical: a multiple of four chars, with no whitespace,
+// '=' only as one or two chars of final padding, and the unused bits of a final partial
+// group zero. Otherwise, decoding follows libcore.io.Base64's long-standing lenient rules:
+// spaces, tabs, CRs and LFs are ignored anywhere, trailing padding is optional, and any
+// incomplete final group without padding is dropped.
+ssize_t base64Decode(const jbyte* src, size_t length, jbyte* dst, size_t capacity, bool strict);
+
+#endif  // BASE64_UTILITIES_H_included
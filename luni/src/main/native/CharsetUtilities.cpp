@@ -0,0 +1,714 @@
+/*
+ * Copyright (C) 2014 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#define LOG_TAG "CharsetUtilities"
+
+#include "CharsetUtilities.h"
+#include "unicode/utf16.h"
+
+#include <stdint.h>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#define CHARSETS_HAVE_SSE2 1
+// AVX2 kernels are compiled with a per-function target attribute and chosen at runtime, so
+// the library as a whole still runs on CPUs that only have SSE2.
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define CHARSETS_HAVE_AVX2 1
+#endif
+#elif defined(__ARM_NEON__) || defined(__ARM_NEON)
+#include <arm_neon.h>
+#define CHARSETS_HAVE_NEON 1
+#endif
+
+static const jchar REPLACEMENT_CHAR = 0xfffd;
+
+//
+// Scalar loops. These define the semantics; the vector kernels below must match them exactly.
+//
+
+static inline void scalarAsciiBytesToChars(const jbyte* src, jchar* dst, size_t length) {
+    for (size_t i = 0; i < length; ++i) {
+        jchar ch = static_cast<jchar>(src[i] & 0xff);
+        dst[i] = (ch <= 0x7f) ? ch : REPLACEMENT_CHAR;
+    }
+}
+
+static inline void scalarIsoLatin1BytesToChars(const jbyte* src, jchar* dst, size_t length) {
+    for (size_t i = 0; i < length; ++i) {
+        dst[i] = static_cast<jchar>(src[i] & 0xff);
+    }
+}
+
+static inline void scalarCharsToBytes(const jchar* src, jbyte* dst, size_t length,
+        jchar maxValidChar) {
+    for (size_t i = 0; i < length; ++i) {
+        jchar ch = src[i];
+        if (ch > maxValidChar) {
+            ch = '?';
+        }
+        dst[i] = static_cast<jbyte>(ch);
+    }
+}
+
+static inline size_t scalarAsciiCharsToBytesPrefix(const jchar* src, jbyte* dst, size_t length) {
+    size_t i = 0;
+    for (; i < length && src[i] < 0x80; ++i) {
+        dst[i] = static_cast<jbyte>(src[i]);
+    }
+    return i;
+}
+
+static inline size_t scalarIsoLatin1CharsToBytesPrefix(const jchar* src, jbyte* dst, size_t length) {
+    size_t i = 0;
+    for (; i < length && src[i] <= 0xff; ++i) {
+        dst[i] = static_cast<jbyte>(src[i]);
+    }
+    return i;
+}
+
+static inline size_t scalarAsciiBytesToCharsPrefix(const jbyte* src, jchar* dst, size_t length) {
+    size_t i = 0;
+    for (; i < length && src[i] >= 0; ++i) {
+        dst[i] = src[i];
+    }
+    return i;
+}
+
+static inline size_t scalarCharsToUtf16BytesPrefix(const jchar* src, jbyte* dst, size_t length,
+        bool bigEndian) {
+    size_t i = 0;
+    for (; i < length && !U16_IS_SURROGATE(src[i]); ++i) {
+        jbyte hi = static_cast<jbyte>(src[i] >> 8);
+        jbyte lo = static_cast<jbyte>(src[i]);
+        dst[2 * i] = bigEndian ? hi : lo;
+        dst[2 * i + 1] = bigEndian ? lo : hi;
+    }
+    return i;
+}
+
+static inline size_t scalarUtf16BytesToCharsPrefix(const jbyte* src, jchar* dst, size_t length,
+        bool bigEndian) {
+    size_t i = 0;
+    for (; i < length; ++i) {
+        jchar hi = src[2 * i + (bigEndian ? 0 : 1)] & 0xff;
+        jchar lo = src[2 * i + (bigEndian ? 1 : 0)] & 0xff;
+        jchar ch = (hi << 8) | lo;
+        if (U16_IS_SURROGATE(ch)) {
+            break;
+        }
+        dst[i] = ch;
+    }
+    return i;
+}
+
+// Returns the number of UTF-8 bytes needed for the chars in [i, end), where 'end' may be
+// overrun by one to complete a surrogate pair. Updates 'i' to the first char not counted.
+static inline size_t scalarUtf8Length(const jchar* src, size_t& i, size_t end, size_t length) {
+    size_t total = 0;
+    for (; i < end; ++i) {
+        jchar ch = src[i];
+        if (ch < 0x80) {
+            total += 1;
+        } else if (ch < 0x800) {
+            total += 2;
+        } else if (!U16_IS_SURROGATE(ch)) {
+            total += 3;
+        } else if (U16_IS_SURROGATE_LEAD(ch) && i + 1 < length && U16_IS_TRAIL(src[i + 1])) {
+            total += 4;
+            ++i;
+        } else {
+            // An unpaired surrogate is replaced by '?'.
+            total += 1;
+        }
+    }
+    return total;
+}
+
+// We count in 16-bit lanes, adding at most 2 per lane per block, so the lanes must be summed
+// and reset at least this often.
+static const size_t UTF8_LENGTH_BLOCKS_PER_FLUSH = 8192;
+
+#if defined(CHARSETS_HAVE_SSE2)
+
+static size_t asciiBytesToCharsSse2(const jbyte* src, jchar* dst, size_t length) {
+    const __m128i zero = _mm_setzero_si128();
+    size_t i = 0;
+    for (; i + 16 <= length; i += 16) {
+        __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm_unpacklo_epi8(bytes, zero));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i + 8), _mm_unpackhi_epi8(bytes, zero));
+        // Patch up any lanes that had the high bit set.
+        for (unsigned mask = _mm_movemask_epi8(bytes); mask != 0; mask &= mask - 1) {
+            dst[i + __builtin_ctz(mask)] = REPLACEMENT_CHAR;
+        }
+    }
+    return i;
+}
+
+static size_t isoLatin1BytesToCharsSse2(const jbyte* src, jchar* dst, size_t length) {
+    const __m128i zero = _mm_setzero_si128();
+    size_t i = 0;
+    for (; i + 16 <= length; i += 16) {
+        __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm_unpacklo_epi8(bytes, zero));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i + 8), _mm_unpackhi_epi8(bytes, zero));
+    }
+    return i;
+}
+
+static size_t charsToBytesSse2(const jchar* src, jbyte* dst, size_t length, jchar maxValidChar) {
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i max = _mm_set1_epi16(static_cast<short>(maxValidChar));
+    const __m128i questionMarks = _mm_set1_epi8('?');
+    size_t i = 0;
+    for (; i + 16 <= length; i += 16) {
+        __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+        __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i + 8));
+        // A lane is valid iff saturating (ch - max) is zero.
+        __m128i validA = _mm_cmpeq_epi16(_mm_subs_epu16(a, max), zero);
+        __m128i validB = _mm_cmpeq_epi16(_mm_subs_epu16(b, max), zero);
+        __m128i valid = _mm_packs_epi16(validA, validB);
+        __m128i bytes = _mm_packus_epi16(a, b);
+        bytes = _mm_or_si128(_mm_and_si128(valid, bytes), _mm_andnot_si128(valid, questionMarks));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), bytes);
+    }
+    return i;
+}
+
+static size_t asciiCharsToBytesPrefixSse2(const jchar* src, jbyte* dst, size_t length) {
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i max = _mm_set1_epi16(0x7f);
+    size_t i = 0;
+    for (; i + 16 <= length; i += 16) {
+        __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+        __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i + 8));
+        __m128i excess = _mm_subs_epu16(_mm_or_si128(a, b), max);
+        if (_mm_movemask_epi8(_mm_cmpeq_epi16(excess, zero)) != 0xffff) {
+            break;
+        }
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm_packus_epi16(a, b));
+    }
+    return i;
+}
+
+static size_t isoLatin1CharsToBytesPrefixSse2(const jchar* src, jbyte* dst, size_t length) {
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i max = _mm_set1_epi16(0xff);
+    size_t i = 0;
+    for (; i + 16 <= length; i += 16) {
+        __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+        __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i + 8));
+        __m128i excess = _mm_subs_epu16(_mm_or_si128(a, b), max);
+        if (_mm_movemask_epi8(_mm_cmpeq_epi16(excess, zero)) != 0xffff) {
+            break;
+        }
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm_packus_epi16(a, b));
+    }
+    return i;
+}
+
+static size_t asciiBytesToCharsPrefixSse2(const jbyte* src, jchar* dst, size_t length) {
+    const __m128i zero = _mm_setzero_si128();
+    size_t i = 0;
+    for (; i + 16 <= length; i += 16) {
+        __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+        if (_mm_movemask_epi8(bytes) != 0) {
+            break;
+        }
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm_unpacklo_epi8(bytes, zero));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i + 8), _mm_unpackhi_epi8(bytes, zero));
+    }
+    return i;
+}
+
+// x86 is little-endian, so UTF-16LE is a plain copy and UTF-16BE swaps each lane's bytes.
+static inline __m128i hasSurrogateSse2(__m128i chars) {
+    const __m128i surrogateMask = _mm_set1_epi16(static_cast<short>(0xf800));
+    const __m128i surrogateBits = _mm_set1_epi16(static_cast<short>(0xd800));
+    return _mm_cmpeq_epi16(_mm_and_si128(chars, surrogateMask), surrogateBits);
+}
+
+static inline __m128i swapLanesSse2(__m128i v) {
+    return _mm_or_si128(_mm_slli_epi16(v, 8), _mm_srli_epi16(v, 8));
+}
+
+static size_t charsToUtf16BytesPrefixSse2(const jchar* src, jbyte* dst, size_t length,
+        bool bigEndian) {
+    size_t i = 0;
+    for (; i + 8 <= length; i += 8) {
+        __m128i chars = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+        if (_mm_movemask_epi8(hasSurrogateSse2(chars)) != 0) {
+            break;
+        }
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + 2 * i),
+                bigEndian ? swapLanesSse2(chars) : chars);
+    }
+    return i;
+}
+
+static size_t utf16BytesToCharsPrefixSse2(const jbyte* src, jchar* dst, size_t length,
+        bool bigEndian) {
+    size_t i = 0;
+    for (; i + 8 <= length; i += 8) {
+        __m128i chars = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 2 * i));
+        if (bigEndian) {
+            chars = swapLanesSse2(chars);
+        }
+        if (_mm_movemask_epi8(hasSurrogateSse2(chars)) != 0) {
+            break;
+        }
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), chars);
+    }
+    return i;
+}
+
+// Counts the UTF-8 bytes for whole blocks of 8 chars, stopping at the first block holding a
+// surrogate. Updates 'i' to the first char not counted.
+static size_t utf8LengthSse2(const jchar* src, size_t& i, size_t length) {
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i oneByteMax = _mm_set1_epi16(0x7f);
+    const __m128i twoByteMax = _mm_set1_epi16(0x7ff);
+    const __m128i surrogateMask = _mm_set1_epi16(static_cast<short>(0xf800));
+    const __m128i surrogateBits = _mm_set1_epi16(static_cast<short>(0xd800));
+    const __m128i ones = _mm_set1_epi16(1);
+    size_t total = 0;
+    bool blocked = false;
+    while (!blocked && i + 8 <= length) {
+        // Each lane accumulates -1 for every char that fits in fewer than 3 bytes, so the
+        // block's byte count is 3 * 8 plus the sum of the lanes.
+        __m128i acc = _mm_setzero_si128();
+        size_t blocks = 0;
+        for (; blocks < UTF8_LENGTH_BLOCKS_PER_FLUSH && i + 8 <= length; ++blocks, i += 8) {
+            __m128i c = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+            __m128i surrogates = _mm_cmpeq_epi16(_mm_and_si128(c, surrogateMask), surrogateBits);
+            if (_mm_movemask_epi8(surrogates) != 0) {
+                blocked = true;
+                break;
+            }
+            __m128i le1 = _mm_cmpeq_epi16(_mm_subs_epu16(c, oneByteMax), zero);
+            __m128i le2 = _mm_cmpeq_epi16(_mm_subs_epu16(c, twoByteMax), zero);
+            acc = _mm_add_epi16(acc, _mm_add_epi16(le1, le2));
+        }
+        __m128i sums = _mm_madd_epi16(acc, ones);
+        sums = _mm_add_epi32(sums, _mm_shuffle_epi32(sums, _MM_SHUFFLE(1, 0, 3, 2)));
+        sums = _mm_add_epi32(sums, _mm_shuffle_epi32(sums, _MM_SHUFFLE(2, 3, 0, 1)));
+        total += 3 * 8 * blocks + _mm_cvtsi128_si32(sums);
+    }
+    return total;
+}
+
+#endif  // CHARSETS_HAVE_SSE2
+
+#if defined(CHARSETS_HAVE_AVX2)
+
+static bool cpuHasAvx2() {
+    static const bool hasAvx2 = __builtin_cpu_supports("avx2");
+    return hasAvx2;
+}
+
+__attribute__((target("avx2")))
+static size_t asciiBytesToCharsAvx2(const jbyte* src, jchar* dst, size_t length) {
+    size_t i = 0;
+    for (; i + 32 <= length; i += 32) {
+        __m256i bytes = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+        __m256i lo = _mm256_cvtepu8_epi16(_mm256_castsi256_si128(bytes));
+        __m256i hi = _mm256_cvtepu8_epi16(_mm256_extracti128_si256(bytes, 1));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), lo);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i + 16), hi);
+        for (unsigned mask = _mm256_movemask_epi8(bytes); mask != 0; mask &= mask - 1) {
+            dst[i + __builtin_ctz(mask)] = REPLACEMENT_CHAR;
+        }
+    }
+    return i;
+}
+
+__attribute__((target("avx2")))
+static size_t isoLatin1BytesToCharsAvx2(const jbyte* src, jchar* dst, size_t length) {
+    size_t i = 0;
+    for (; i + 32 <= length; i += 32) {
+        __m256i bytes = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+        __m256i lo = _mm256_cvtepu8_epi16(_mm256_castsi256_si128(bytes));
+        __m256i hi = _mm256_cvtepu8_epi16(_mm256_extracti128_si256(bytes, 1));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), lo);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i + 16), hi);
+    }
+    return i;
+}
+
+__attribute__((target("avx2")))
+static size_t charsToBytesAvx2(const jchar* src, jbyte* dst, size_t length, jchar maxValidChar) {
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i max = _mm256_set1_epi16(static_cast<short>(maxValidChar));
+    const __m256i questionMarks = _mm256_set1_epi8('?');
+    size_t i = 0;
+    for (; i + 32 <= length; i += 32) {
+        __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+        __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i + 16));
+        __m256i validA = _mm256_cmpeq_epi16(_mm256_subs_epu16(a, max), zero);
+        __m256i validB = _mm256_cmpeq_epi16(_mm256_subs_epu16(b, max), zero);
+        // The packs work within 128-bit lanes; the blend doesn't care, and one permute at the
+        // end puts the quadwords back in order.
+        __m256i valid = _mm256_packs_epi16(validA, validB);
+        __m256i bytes = _mm256_packus_epi16(a, b);
+        bytes = _mm256_or_si256(_mm256_and_si256(valid, bytes),
+                                _mm256_andnot_si256(valid, questionMarks));
+        bytes = _mm256_permute4x64_epi64(bytes, 0xd8);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), bytes);
+    }
+    return i;
+}
+
+__attribute__((target("avx2")))
+static size_t asciiCharsToBytesPrefixAvx2(const jchar* src, jbyte* dst, size_t length) {
+    const __m256i nonAscii = _mm256_set1_epi16(static_cast<short>(0xff80));
+    size_t i = 0;
+    for (; i + 32 <= length; i += 32) {
+        __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+        __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i + 16));
+        if (!_mm256_testz_si256(_mm256_or_si256(a, b), nonAscii)) {
+            break;
+        }
+        __m256i bytes = _mm256_permute4x64_epi64(_mm256_packus_epi16(a, b), 0xd8);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), bytes);
+    }
+    return i;
+}
+
+__attribute__((target("avx2")))
+static size_t utf8LengthAvx2(const jchar* src, size_t& i, size_t length) {
+    const __m256i oneByteMax = _mm256_set1_epi16(0x7f);
+    const __m256i twoByteMax = _mm256_set1_epi16(0x7ff);
+    const __m256i surrogateMask = _mm256_set1_epi16(static_cast<short>(0xf800));
+    const __m256i surrogateBits = _mm256_set1_epi16(static_cast<short>(0xd800));
+    const __m256i ones = _mm256_set1_epi16(1);
+    size_t total = 0;
+    bool blocked = false;
+    while (!blocked && i + 16 <= length) {
+        __m256i acc = _mm256_setzero_si256();
+        size_t blocks = 0;
+        for (; blocks < UTF8_LENGTH_BLOCKS_PER_FLUSH && i + 16 <= length; ++blocks, i += 16) {
+            __m256i c = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+            __m256i surrogates = _mm256_cmpeq_epi16(_mm256_and_si256(c, surrogateMask),
+                                                    surrogateBits);
+            if (!_mm256_testz_si256(surrogates, surrogates)) {
+                blocked = true;
+                break;
+            }
+            // AVX2 has unsigned 16-bit max, so "c <= limit" is "max(c, limit) == limit".
+            __m256i le1 = _mm256_cmpeq_epi16(_mm256_max_epu16(c, oneByteMax), oneByteMax);
+            __m256i le2 = _mm256_cmpeq_epi16(_mm256_max_epu16(c, twoByteMax), twoByteMax);
+            acc = _mm256_add_epi16(acc, _mm256_add_epi16(le1, le2));
+        }
+        __m256i wide = _mm256_madd_epi16(acc, ones);
+        __m128i sums = _mm_add_epi32(_mm256_castsi256_si128(wide),
+                                     _mm256_extracti128_si256(wide, 1));
+        sums = _mm_add_epi32(sums, _mm_shuffle_epi32(sums, _MM_SHUFFLE(1, 0, 3, 2)));
+        sums = _mm_add_epi32(sums, _mm_shuffle_epi32(sums, _MM_SHUFFLE(2, 3, 0, 1)));
+        total += 3 * 16 * blocks + _mm_cvtsi128_si32(sums);
+    }
+    return total;
+}
+
+#endif  // CHARSETS_HAVE_AVX2
+
+#if defined(CHARSETS_HAVE_NEON)
+
+static inline uint16_t maxLane(uint16x8_t v) {
+    uint16x4_t m = vmax_u16(vget_low_u16(v), vget_high_u16(v));
+    m = vpmax_u16(m, m);
+    m = vpmax_u16(m, m);
+    return vget_lane_u16(m, 0);
+}
+
+static size_t asciiBytesToCharsNeon(const jbyte* src, jchar* dst, size_t length) {
+    const uint16x8_t max = vdupq_n_u16(0x7f);
+    const uint16x8_t replacement = vdupq_n_u16(REPLACEMENT_CHAR);
+    uint16_t* out = reinterpret_cast<uint16_t*>(dst);
+    size_t i = 0;
+    for (; i + 16 <= length; i += 16) {
+        uint8x16_t bytes = vld1q_u8(reinterpret_cast<const uint8_t*>(src + i));
+        uint16x8_t lo = vmovl_u8(vget_low_u8(bytes));
+        uint16x8_t hi = vmovl_u8(vget_high_u8(bytes));
+        vst1q_u16(out + i, vbslq_u16(vcgtq_u16(lo, max), replacement, lo));
+        vst1q_u16(out + i + 8, vbslq_u16(vcgtq_u16(hi, max), replacement, hi));
+    }
+    return i;
+}
+
+static size_t isoLatin1BytesToCharsNeon(const jbyte* src, jchar* dst, size_t length) {
+    uint16_t* out = reinterpret_cast<uint16_t*>(dst);
+    size_t i = 0;
+    for (; i + 16 <= length; i += 16) {
+        uint8x16_t bytes = vld1q_u8(reinterpret_cast<const uint8_t*>(src + i));
+        vst1q_u16(out + i, vmovl_u8(vget_low_u8(bytes)));
+        vst1q_u16(out + i + 8, vmovl_u8(vget_high_u8(bytes)));
+    }
+    return i;
+}
+
+static size_t charsToBytesNeon(const jchar* src, jbyte* dst, size_t length, jchar maxValidChar) {
+    const uint16x8_t max = vdupq_n_u16(maxValidChar);
+    const uint8x8_t questionMarks = vdup_n_u8('?');
+    const uint16_t* in = reinterpret_cast<const uint16_t*>(src);
+    uint8_t* out = reinterpret_cast<uint8_t*>(dst);
+    size_t i = 0;
+    for (; i + 16 <= length; i += 16) {
+        uint16x8_t a = vld1q_u16(in + i);
+        uint16x8_t b = vld1q_u16(in + i + 8);
+        uint8x8_t bytesA = vbsl_u8(vmovn_u16(vcleq_u16(a, max)), vmovn_u16(a), questionMarks);
+        uint8x8_t bytesB = vbsl_u8(vmovn_u16(vcleq_u16(b, max)), vmovn_u16(b), questionMarks);
+        vst1q_u8(out + i, vcombine_u8(bytesA, bytesB));
+    }
+    return i;
+}
+
+static size_t asciiCharsToBytesPrefixNeon(const jchar* src, jbyte* dst, size_t length) {
+    const uint16_t* in = reinterpret_cast<const uint16_t*>(src);
+    uint8_t* out = reinterpret_cast<uint8_t*>(dst);
+    size_t i = 0;
+    for (; i + 16 <= length; i += 16) {
+        uint16x8_t a = vld1q_u16(in + i);
+        uint16x8_t b = vld1q_u16(in + i + 8);
+        if (maxLane(vmaxq_u16(a, b)) >= 0x80) {
+            break;
+        }
+        vst1q_u8(out + i, vcombine_u8(vmovn_u16(a), vmovn_u16(b)));
+    }
+    return i;
+}
+
+static size_t isoLatin1CharsToBytesPrefixNeon(const jchar* src, jbyte* dst, size_t length) {
+    const uint16_t* in = reinterpret_cast<const uint16_t*>(src);
+    uint8_t* out = reinterpret_cast<uint8_t*>(dst);
+    size_t i = 0;
+    for (; i + 16 <= length; i += 16) {
+        uint16x8_t a = vld1q_u16(in + i);
+        uint16x8_t b = vld1q_u16(in + i + 8);
+        if (maxLane(vmaxq_u16(a, b)) > 0xff) {
+            break;
+        }
+        vst1q_u8(out + i, vcombine_u8(vmovn_u16(a), vmovn_u16(b)));
+    }
+    return i;
+}
+
+static size_t asciiBytesToCharsPrefixNeon(const jbyte* src, jchar* dst, size_t length) {
+    const uint8_t* in = reinterpret_cast<const uint8_t*>(src);
+    uint16_t* out = reinterpret_cast<uint16_t*>(dst);
+    size_t i = 0;
+    for (; i + 16 <= length; i += 16) {
+        uint8x16_t bytes = vld1q_u8(in + i);
+        uint8x8_t max = vpmax_u8(vget_low_u8(bytes), vget_high_u8(bytes));
+        max = vpmax_u8(max, max);
+        max = vpmax_u8(max, max);
+        max = vpmax_u8(max, max);
+        if (vget_lane_u8(max, 0) >= 0x80) {
+            break;
+        }
+        vst1q_u16(out + i, vmovl_u8(vget_low_u8(bytes)));
+        vst1q_u16(out + i + 8, vmovl_u8(vget_high_u8(bytes)));
+    }
+    return i;
+}
+
+static size_t utf8LengthNeon(const jchar* src, size_t& i, size_t length) {
+    const uint16x8_t oneByteLimit = vdupq_n_u16(0x80);
+    const uint16x8_t twoByteLimit = vdupq_n_u16(0x800);
+    const uint16x8_t surrogateMask = vdupq_n_u16(0xf800);
+    const uint16x8_t surrogateBits = vdupq_n_u16(0xd800);
+    const uint16_t* in = reinterpret_cast<const uint16_t*>(src);
+    size_t total = 0;
+    bool blocked = false;
+    while (!blocked && i + 8 <= length) {
+        // Each lane counts the extra bytes beyond the first that its chars need.
+        uint16x8_t acc = vdupq_n_u16(0);
+        size_t blocks = 0;
+        for (; blocks < UTF8_LENGTH_BLOCKS_PER_FLUSH && i + 8 <= length; ++blocks, i += 8) {
+            uint16x8_t c = vld1q_u16(in + i);
+            if (maxLane(vceqq_u16(vandq_u16(c, surrogateMask), surrogateBits)) != 0) {
+                blocked = true;
+                break;
+            }
+            // The comparisons produce all-ones lanes, so subtracting them adds one.
+            acc = vsubq_u16(acc, vcgeq_u16(c, oneByteLimit));
+            acc = vsubq_u16(acc, vcgeq_u16(c, twoByteLimit));
+        }
+        uint64x2_t sums = vpaddlq_u32(vpaddlq_u16(acc));
+        total += 8 * blocks + vgetq_lane_u64(sums, 0) + vgetq_lane_u64(sums, 1);
+    }
+    return total;
+}
+
+#endif  // CHARSETS_HAVE_NEON
+
+//
+// Dispatch. Each vector kernel handles whole blocks and returns how far it got; the scalar
+// loop finishes off whatever is left.
+//
+
+void asciiBytesToChars(const jbyte* src, jchar* dst, size_t length) {
+    size_t done = 0;
+#if defined(CHARSETS_HAVE_AVX2)
+    if (cpuHasAvx2()) {
+        done = asciiBytesToCharsAvx2(src, dst, length);
+    }
+#endif
+#if defined(CHARSETS_HAVE_SSE2)
+    done += asciiBytesToCharsSse2(src + done, dst + done, length - done);
+#elif defined(CHARSETS_HAVE_NEON)
+    done += asciiBytesToCharsNeon(src + done, dst + done, length - done);
+#endif
+    scalarAsciiBytesToChars(src + done, dst + done, length - done);
+}
+
+void isoLatin1BytesToChars(const jbyte* src, jchar* dst, size_t length) {
+    size_t done = 0;
+#if defined(CHARSETS_HAVE_AVX2)
+    if (cpuHasAvx2()) {
+        done = isoLatin1BytesToCharsAvx2(src, dst, length);
+    }
+#endif
+#if defined(CHARSETS_HAVE_SSE2)
+    done += isoLatin1BytesToCharsSse2(src + done, dst + done, length - done);
+#elif defined(CHARSETS_HAVE_NEON)
+    done += isoLatin1BytesToCharsNeon(src + done, dst + done, length - done);
+#endif
+    scalarIsoLatin1BytesToChars(src + done, dst + done, length - done);
+}
+
+void charsToBytes(const jchar* src, jbyte* dst, size_t length, jchar maxValidChar) {
+    size_t done = 0;
+#if defined(CHARSETS_HAVE_AVX2)
+    if (cpuHasAvx2()) {
+        done = charsToBytesAvx2(src, dst, length, maxValidChar);
+    }
+#endif
+#if defined(CHARSETS_HAVE_SSE2)
+    done += charsToBytesSse2(src + done, dst + done, length - done, maxValidChar);
+#elif defined(CHARSETS_HAVE_NEON)
+    done += charsToBytesNeon(src + done, dst + done, length - done, maxValidChar);
+#endif
+    scalarCharsToBytes(src + done, dst + done, length - done, maxValidChar);
+}
+
+size_t asciiCharsToBytesPrefix(const jchar* src, jbyte* dst, size_t length) {
+    size_t done = 0;
+#if defined(CHARSETS_HAVE_AVX2)
+    if (cpuHasAvx2()) {
+        done = asciiCharsToBytesPrefixAvx2(src, dst, length);
+    }
+#endif
+#if defined(CHARSETS_HAVE_SSE2)
+    done += asciiCharsToBytesPrefixSse2(src + done, dst + done, length - done);
+#elif defined(CHARSETS_HAVE_NEON)
+    done += asciiCharsToBytesPrefixNeon(src + done, dst + done, length - done);
+#endif
+    return done + scalarAsciiCharsToBytesPrefix(src + done, dst + done, length - done);
+}
+
+size_t isoLatin1CharsToBytesPrefix(const jchar* src, jbyte* dst, size_t length) {
+    size_t done = 0;
+#if defined(CHARSETS_HAVE_SSE2)
+    done = isoLatin1CharsToBytesPrefixSse2(src, dst, length);
+#elif defined(CHARSETS_HAVE_NEON)
+    done = isoLatin1CharsToBytesPrefixNeon(src, dst, length);
+#endif
+    return done + scalarIsoLatin1CharsToBytesPrefix(src + done, dst + done, length - done);
+}
+
+size_t asciiBytesToCharsPrefix(const jbyte* src, jchar* dst, size_t length) {
+    size_t done = 0;
+#if defined(CHARSETS_HAVE_SSE2)
+    done = asciiBytesToCharsPrefixSse2(src, dst, length);
+#elif defined(CHARSETS_HAVE_NEON)
+    done = asciiBytesToCharsPrefixNeon(src, dst, length);
+#endif
+    return done + scalarAsciiBytesToCharsPrefix(src + done, dst + done, length - done);
+}
+
+size_t charsToUtf16BytesPrefix(const jchar* src, jbyte* dst, size_t length, bool bigEndian) {
+    size_t done = 0;
+#if defined(CHARSETS_HAVE_SSE2)
+    done = charsToUtf16BytesPrefixSse2(src, dst, length, bigEndian);
+#endif
+    return done + scalarCharsToUtf16BytesPrefix(src + done, dst + 2 * done, length - done,
+            bigEndian);
+}
+
+size_t utf16BytesToCharsPrefix(const jbyte* src, jchar* dst, size_t length, bool bigEndian) {
+    size_t done = 0;
+#if defined(CHARSETS_HAVE_SSE2)
+    done = utf16BytesToCharsPrefixSse2(src, dst, length, bigEndian);
+#endif
+    return done + scalarUtf16BytesToCharsPrefix(src + 2 * done, dst + done, length - done,
+            bigEndian);
+}
+
+size_t utf8Length(const jchar* src, size_t length) {
+    size_t total = 0;
+    size_t i = 0;
+    while (i < length) {
+#if defined(CHARSETS_HAVE_AVX2)
+        if (cpuHasAvx2()) {
+            total += utf8LengthAvx2(src, i, length);
+        }
+#endif
+#if defined(CHARSETS_HAVE_SSE2)
+        total += utf8LengthSse2(src, i, length);
+#elif defined(CHARSETS_HAVE_NEON)
+        total += utf8LengthNeon(src, i, length);
+#endif
+        // Count the block the vector loop stopped at (or the tail) one char at a time, then
+        // give the vector loop another go.
+        size_t end = i + 16;
+        total += scalarUtf8Length(src, i, (end < length) ? end : length, length);
+    }
+    return total;
+}
+
+size_t charsToUtf8Bytes(const jchar* src, size_t length, jbyte* dst) {
+    jbyte* out = dst;
+    size_t i = 0;
+    while (i < length) {
+        size_t run = asciiCharsToBytesPrefix(src + i, out, length - i);
+        i += run;
+        out += run;
+        // Encode the following run of non-ASCII chars without going back to the ASCII kernel.
+        for (; i < length && src[i] >= 0x80; ++i) {
+            jint ch = src[i];
+            if (ch < 0x800) {
+                *out++ = (ch >> 6) | 0xc0;
+                *out++ = (ch & 0x3f) | 0x80;
+            } else if (!U16_IS_SURROGATE(ch)) {
+                *out++ = (ch >> 12) | 0xe0;
+                *out++ = ((ch >> 6) & 0x3f) | 0x80;
+                *out++ = (ch & 0x3f) | 0x80;
+            } else if (U16_IS_SURROGATE_LEAD(ch) && i + 1 < length && U16_IS_TRAIL(src[i + 1])) {
+                ch = U16_GET_SUPPLEMENTARY(ch, src[i + 1]);
+                ++i;
+                *out++ = (ch >> 18) | 0xf0;
+                *out++ = ((ch >> 12) & 0x3f) | 0x80;
+                *out++ = ((ch >> 6) & 0x3f) | 0x80;
+                *out++ = (ch & 0x3f) | 0x80;
+            } else {
+                *out++ = '?';
+            }
+        }
+    }
+    return out - dst;
+}
@@ -0,0 +1,68 @@
+/*
+ * Copyright (C) 2014 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef CHARSET_UTILITIES_H_included
+#define CHARSET_UTILITIES_H_included
+
+#include "jni.h"
+
+#include <stddef.h>
+
+// Bulk transcoding kernels shared by the Charsets and NativeConverter fast paths. These work
+// on raw memory, so callers are responsible for pinning (or otherwise locating) their buffers.
+// On x86 they use SSE2, or AVX2 when the CPU supports it; on ARM they use NEON where the
+// compiler makes it available. Every kernel falls back to a scalar loop for the tail, and for
+// any block that contains a character needing individual treatment.
+
+// Decodes 'length' US-ASCII bytes to chars. Bytes above 0x7f become U+FFFD.
+void asciiBytesToChars(const jbyte* src, jchar* dst, size_t length);
+
+// Decodes 'length' ISO-8859-1 bytes to chars.
+void isoLatin1BytesToChars(const jbyte* src, jchar* dst, size_t length);
+
+// Encodes 'length' chars to single bytes. Chars above 'maxValidChar', which must be at most
+// 0xff, become '?'.
+void charsToBytes(const jchar* src, jbyte* dst, size_t length, jchar maxValidChar);
+
+// Copies the longest prefix of 'src' consisting only of chars below U+0080 to 'dst' as bytes,
+// stopping after at most 'length' chars. Returns the number of chars copied.
+size_t asciiCharsToBytesPrefix(const jchar* src, jbyte* dst, size_t length);
+
+// Copies the longest prefix of 'src' consisting only of chars below U+0100 to 'dst' as bytes,
+// stopping after at most 'length' chars. Returns the number of chars copied.
+size_t isoLatin1CharsToBytesPrefix(const jchar* src, jbyte* dst, size_t length);
+
+// Copies the longest prefix of 'src' consisting only of US-ASCII bytes to 'dst' as chars,
+// stopping after at most 'length' bytes. Returns the number of bytes copied.
+size_t asciiBytesToCharsPrefix(const jbyte* src, jchar* dst, size_t length);
+
+// Encodes the longest prefix of 'src' containing no surrogates as UTF-16BE (or UTF-16LE),
+// stopping after at most 'length' chars. Returns the number of chars encoded.
+size_t charsToUtf16BytesPrefix(const jchar* src, jbyte* dst, size_t length, bool bigEndian);
+
+// Decodes the longest prefix of UTF-16BE (or UTF-16LE) 'src' containing no surrogates,
+// stopping after at most 'length' chars (2 * 'length' bytes). Returns the number of chars.
+size_t utf16BytesToCharsPrefix(const jbyte* src, jchar* dst, size_t length, bool bigEndian);
+
+// Returns the number of bytes needed to encode 'length' chars as UTF-8, where each unpaired
+// surrogate is replaced by '?'.
+size_t utf8Length(const jchar* src, size_t length);
+
+// Encodes 'length' chars as UTF-8, replacing each unpaired surrogate by '?'. 'dst' must have
+// room for utf8Length(src, length) bytes. Returns the number of bytes written.
+size_t charsToUtf8Bytes(const jchar* src, size_t length, jbyte* dst);
+
+#endif  // CHARSET_UTILITIES_H_included
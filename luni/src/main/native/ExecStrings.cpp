@@ -14,56 +14,35 @@
  * limitations under the License.
  */
 
-#define LOG_TAG "ExecStrings"
-
 #include "ExecStrings.h"
 
-#include <stdlib.h>
-
-#include "cutils/log.h"
+#include "JniException.h"
 #include "ScopedLocalRef.h"
 
-ExecStrings::ExecStrings(JNIEnv* env, jobjectArray java_string_array)
-    : env_(env), java_array_(java_string_array), array_(NULL) {
-  if (java_array_ == NULL) {
+ExecStrings::ExecStrings(JNIEnv* env, jobjectArray java_string_array) : array_(NULL) {
+  if (java_string_array == NULL) {
     return;
   }
 
-  jsize length = env_->GetArrayLength(java_array_);
-  array_ = new char*[length + 1];
-  array_[length] = NULL;
-  for (jsize i = 0; i < length; ++i) {
-    ScopedLocalRef<jstring> java_string(env_, reinterpret_cast<jstring>(env_->GetObjectArrayElement(java_array_, i)));
-    // We need to pass these strings to const-unfriendly code.
-    char* string = const_cast<char*>(env_->GetStringUTFChars(java_string.get(), NULL));
-    array_[i] = string;
-  }
-}
-
-ExecStrings::~ExecStrings() {
-  if (array_ == NULL) {
+  jsize length = env->GetArrayLength(java_string_array);
+  char** array = arena_.allocateArray<char*>(length + 1);
+  if (array == NULL) {
+    jniThrowOutOfMemoryError(env, NULL);
     return;
   }
-
-  // Temporarily clear any pending exception so we can clean up.
-  jthrowable pending_exception = env_->ExceptionOccurred();
-  if (pending_exception != NULL) {
-    env_->ExceptionClear();
-  }
-
-  jsize length = env_->GetArrayLength(java_array_);
   for (jsize i = 0; i < length; ++i) {
-    ScopedLocalRef<jstring> java_string(env_, reinterpret_cast<jstring>(env_->GetObjectArrayElement(java_array_, i)));
-    env_->ReleaseStringUTFChars(java_string.get(), array_[i]);
-  }
-  delete[] array_;
-
-  // Re-throw any pending exception.
-  if (pending_exception != NULL) {
-    if (env_->Throw(pending_exception) < 0) {
-      ALOGE("Error rethrowing exception!");
+    ScopedLocalRef<jstring> java_string(env, reinterpret_cast<jstring>(env->GetObjectArrayElement(java_string_array, i)));
+    array[i] = arena_.utfChars(env, java_string.get());
+    if (array[i] == NULL) {
+      return;
     }
   }
+  array[length] = NULL;
+  array_ = array;
+}
+
+ExecStrings::~ExecStrings() {
+  // Everything lives in arena_, which gives it all back.
 }
 
 char** ExecStrings::get() {
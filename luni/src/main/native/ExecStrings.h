@@ -15,7 +15,12 @@
  */
 
 #include "jni.h"
+#include "ScratchArena.h"
 
+// Converts a Java String[] to a NULL-terminated char* array suitable for execv(3) and friends.
+// The array and the strings are copied into the calling thread's ScratchArena, so the
+// conversion makes no heap allocations. If 'java_string_array' is null, so is get(). If the
+// conversion fails, get() returns NULL with an exception pending.
 class ExecStrings {
  public:
   ExecStrings(JNIEnv* env, jobjectArray java_string_array);
@@ -25,8 +30,7 @@ class ExecStrings {
   char** get();
 
  private:
-  JNIEnv* env_;
-  jobjectArray java_array_;
+  ScopedScratchArena arena_;
   char** array_;
 
   // Disallow copy and assignment.
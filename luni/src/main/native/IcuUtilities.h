@@ -27,4 +27,7 @@
 extern jobjectArray fromStringEnumeration(JNIEnv* env, UErrorCode& status, const char* provider, StringEnumeration*);
 bool maybeThrowIcuException(JNIEnv* env, const char* function, UErrorCode error);
 
+// Maps ICU's data file and points ICU at it, the first time it's called.
+void initIcuData();
+
 #endif  // ICU_UTILITIES_H_included
@@ -21,6 +21,9 @@
 
 void jniThrowExceptionWithErrno(JNIEnv* env, const char* exceptionClassName, int error);
 
+// Throws an android.system.ErrnoException for a failed call to 'functionName'.
+void jniThrowErrnoException(JNIEnv* env, const char* functionName, int error);
+
 void jniThrowOutOfMemoryError(JNIEnv* env, const char* message);
 void jniThrowSocketException(JNIEnv* env, int error);
 
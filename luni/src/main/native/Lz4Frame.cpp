@@ -0,0 +1,749 @@
+/*
+ * Copyright (C) 2014 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#define LOG_TAG "Lz4Frame"
+
+#include "Lz4Frame.h"
+
+#include <string.h>
+
+#include <algorithm>
+
+static const uint32_t PRIME32_1 = 2654435761U;
+static const uint32_t PRIME32_2 = 2246822519U;
+static const uint32_t PRIME32_3 = 3266489917U;
+static const uint32_t PRIME32_4 = 668265263U;
+static const uint32_t PRIME32_5 = 374761393U;
+
+static inline uint32_t read32(const uint8_t* p) {
+    uint32_t result;
+    memcpy(&result, p, sizeof(result));
+    return result;
+}
+
+static inline uint32_t readLittleEndian32(const uint8_t* p) {
+    return p[0] | (p[1] << 8) | (p[2] << 16) | (static_cast<uint32_t>(p[3]) << 24);
+}
+
+static inline void writeLittleEndian32(uint8_t* p, uint32_t value) {
+    p[0] = value;
+    p[1] = value >> 8;
+    p[2] = value >> 16;
+    p[3] = value >> 24;
+}
+
+static inline uint32_t rotateLeft(uint32_t value, int distance) {
+    return (value << distance) | (value >> (32 - distance));
+}
+
+//
+// XXH32.
+//
+
+static inline uint32_t xxh32Round(uint32_t acc, uint32_t input) {
+    acc += input * PRIME32_2;
+    return rotateLeft(acc, 13) * PRIME32_1;
+}
+
+void Xxh32::reset(uint32_t seed) {
+    mSeed = seed;
+    mAcc[0] = seed + PRIME32_1 + PRIME32_2;
+    mAcc[1] = seed + PRIME32_2;
+    mAcc[2] = seed;
+    mAcc[3] = seed - PRIME32_1;
+    mTotalLength = 0;
+    mBufferLength = 0;
+}
+
+void Xxh32::update(const uint8_t* data, size_t length) {
+    mTotalLength += length;
+    if (mBufferLength + length < 16) {
+        memcpy(mBuffer + mBufferLength, data, length);
+        mBufferLength += length;
+        return;
+    }
+    if (mBufferLength > 0) {
+        size_t n = 16 - mBufferLength;
+        memcpy(mBuffer + mBufferLength, data, n);
+        for (int i = 0; i < 4; ++i) {
+            mAcc[i] = xxh32Round(mAcc[i], readLittleEndian32(mBuffer + 4 * i));
+        }
+        data += n;
+        length -= n;
+        mBufferLength = 0;
+    }
+    for (; length >= 16; data += 16, length -= 16) {
+        mAcc[0] = xxh32Round(mAcc[0], readLittleEndian32(data));
+        mAcc[1] = xxh32Round(mAcc[1], readLittleEndian32(data + 4));
+        mAcc[2] = xxh32Round(mAcc[2], readLittleEndian32(data + 8));
+        mAcc[3] = xxh32Round(mAcc[3], readLittleEndian32(data + 12));
+    }
+    memcpy(mBuffer, data, length);
+    mBufferLength = length;
+}
+
+uint32_t Xxh32::digest() const {
+    uint32_t h;
+    if (mTotalLength >= 16) {
+        h = rotateLeft(mAcc[0], 1) + rotateLeft(mAcc[1], 7) + rotateLeft(mAcc[2], 12)
+                + rotateLeft(mAcc[3], 18);
+    } else {
+        h = mSeed + PRIME32_5;
+    }
+    h += static_cast<uint32_t>(mTotalLength);
+    size_t i = 0;
+    for (; i + 4 <= mBufferLength; i += 4) {
+        h += readLittleEndian32(mBuffer + i) * PRIME32_3;
+        h = rotateLeft(h, 17) * PRIME32_4;
+    }
+    for (; i < mBufferLength; ++i) {
+        h += mBuffer[i] * PRIME32_5;
+        h = rotateLeft(h, 11) * PRIME32_1;
+    }
+    h ^= h >> 15;
+    h *= PRIME32_2;
+    h ^= h >> 13;
+    h *= PRIME32_3;
+    h ^= h >> 16;
+    return h;
+}
+
+uint32_t Xxh32::hash(const uint8_t* data, size_t length, uint32_t seed) {
+    Xxh32 state(seed);
+    state.update(data, length);
+    return state.digest();
+}
+
+//
+// LZ4 blocks.
+//
+
+static const size_t MIN_MATCH = 4;
+// The last match must start at least this far from the end of the block...
+static const size_t MF_LIMIT = 12;
+// ...and the block must end with at least this many literals.
+static const size_t LAST_LITERALS = 5;
+static const size_t MAX_DISTANCE = 65535;
+static const int HASH_LOG = 12;
+
+static inline uint32_t hashPosition(const uint8_t* p) {
+    return (read32(p) * PRIME32_1) >> (32 - HASH_LOG);
+}
+
+// Returns how many bytes from 'p' and 'q' match, stopping at 'limit' (which bounds 'p').
+static inline size_t matchLength(const uint8_t* p, const uint8_t* q, const uint8_t* limit) {
+    const uint8_t* start = p;
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+    while (p + 8 <= limit) {
+        uint64_t a, b;
+        memcpy(&a, p, 8);
+        memcpy(&b, q, 8);
+        if (a != b) {
+            return p - start + (__builtin_ctzll(a ^ b) >> 3);
+        }
+        p += 8;
+        q += 8;
+    }
+#endif
+    while (p < limit && *p == *q) {
+        ++p;
+        ++q;
+    }
+    return p - start;
+}
+
+// Writes a 4-bit length into the token, and any remainder as a run of bytes after it.
+static inline uint8_t* writeLength(uint8_t* op, uint8_t* token, size_t length, int shift) {
+    if (length >= 15) {
+        *token |= 15 << shift;
+        for (length -= 15; length >= 255; length -= 255) {
+            *op++ = 255;
+        }
+        *op++ = length;
+    } else {
+        *token |= length << shift;
+    }
+    return op;
+}
+
+size_t lz4CompressBlock(const uint8_t* window, size_t start, size_t length, uint8_t* dst,
+        uint32_t* table) {
+    const uint8_t* ip = window + start;
+    const uint8_t* anchor = ip;
+    const uint8_t* iend = ip + length;
+    uint8_t* op = dst;
+    if (length > MF_LIMIT) {
+        const uint8_t* mfLimit = iend - MF_LIMIT;
+        const uint8_t* matchLimit = iend - LAST_LITERALS;
+        table[hashPosition(ip)] = ip - window;
+        ++ip;
+        while (true) {
+            // Find a match, stepping further between attempts the longer we go without one.
+            const uint8_t* ref;
+            size_t attempts = 64;
+            while (true) {
+                if (ip > mfLimit) {
+                    goto lastLiterals;
+                }
+                uint32_t h = hashPosition(ip);
+                ref = window + table[h];
+                table[h] = ip - window;
+                if (static_cast<size_t>(ip - ref) - 1 < MAX_DISTANCE && read32(ref) == read32(ip)) {
+                    break;
+                }
+                ip += attempts++ >> 6;
+            }
+            while (ip > anchor && ref > window && ip[-1] == ref[-1]) {
+                --ip;
+                --ref;
+            }
+
+            uint8_t* token = op++;
+            *token = 0;
+            size_t literalLength = ip - anchor;
+            op = writeLength(op, token, literalLength, 4);
+            memcpy(op, anchor, literalLength);
+            op += literalLength;
+            size_t offset = ip - ref;
+            *op++ = offset;
+            *op++ = offset >> 8;
+            size_t length = MIN_MATCH + matchLength(ip + MIN_MATCH, ref + MIN_MATCH, matchLimit);
+            op = writeLength(op, token, length - MIN_MATCH, 0);
+
+            ip += length;
+            anchor = ip;
+            if (ip > mfLimit) {
+                break;
+            }
+            table[hashPosition(ip - 2)] = ip - 2 - window;
+        }
+    }
+lastLiterals:
+    uint8_t* token = op++;
+    *token = 0;
+    size_t literalLength = iend - anchor;
+    op = writeLength(op, token, literalLength, 4);
+    memcpy(op, anchor, literalLength);
+    op += literalLength;
+    return op - dst;
+}
+
+// Reads the extra bytes of a 4-bit length that was 15. Returns false at the end of the input.
+static inline bool readLength(const uint8_t*& ip, const uint8_t* iend, size_t& length) {
+    uint8_t b;
+    do {
+        if (ip == iend) {
+            return false;
+        }
+        b = *ip++;
+        length += b;
+    } while (b == 255);
+    return true;
+}
+
+ssize_t lz4DecompressBlock(const uint8_t* src, size_t srcLength, uint8_t* dst, size_t dstCapacity,
+        size_t historyLength) {
+    const uint8_t* ip = src;
+    const uint8_t* iend = src + srcLength;
+    uint8_t* op = dst;
+    uint8_t* oend = dst + dstCapacity;
+    while (true) {
+        if (ip == iend) {
+            return -1;
+        }
+        unsigned token = *ip++;
+        size_t literalLength = token >> 4;
+        if (literalLength == 15 && !readLength(ip, iend, literalLength)) {
+            return -1;
+        }
+        if (literalLength > static_cast<size_t>(iend - ip) ||
+                literalLength > static_cast<size_t>(oend - op)) {
+            return -1;
+        }
+        if (literalLength <= 16 && iend - ip >= 16 && oend - op >= 16) {
+            // Most runs are short, and a fixed-size copy is much cheaper than a variable one.
+            // The bytes written past the run are overwritten by what follows it.
+            memcpy(op, ip, 16);
+        } else {
+            memcpy(op, ip, literalLength);
+        }
+        ip += literalLength;
+        op += literalLength;
+        if (ip == iend) {
+            // The last sequence has only literals.
+            return op - dst;
+        }
+
+        if (iend - ip < 2) {
+            return -1;
+        }
+        size_t offset = ip[0] | (ip[1] << 8);
+        ip += 2;
+        if (offset == 0 || offset > static_cast<size_t>(op - dst) + historyLength) {
+            return -1;
+        }
+        size_t length = token & 15;
+        if (length == 15 && !readLength(ip, iend, length)) {
+            return -1;
+        }
+        length += MIN_MATCH;
+        if (length > static_cast<size_t>(oend - op)) {
+            return -1;
+        }
+        const uint8_t* match = op - offset;
+        if (offset >= 16 && length <= 16 && oend - op >= 16) {
+            memcpy(op, match, 16);
+            op += length;
+        } else if (offset >= length) {
+            memcpy(op, match, length);
+            op += length;
+        } else if (offset >= 8) {
+            // Each chunk only reads bytes written before it.
+            uint8_t* end = op + length;
+            for (; op + 8 <= end; op += 8, match += 8) {
+                memcpy(op, match, 8);
+            }
+            while (op < end) {
+                *op++ = *match++;
+            }
+        } else {
+            // A short offset repeats a short pattern, such as a run of one byte.
+            for (size_t i = 0; i < length; ++i) {
+                op[i] = match[i];
+            }
+            op += length;
+        }
+    }
+}
+
+//
+// Frames.
+//
+
+static const uint32_t FRAME_MAGIC = 0x184D2204;
+static const uint8_t FLG_VERSION = 0x40;
+static const uint8_t FLG_VERSION_MASK = 0xc0;
+static const uint8_t FLG_BLOCK_INDEPENDENCE = 0x20;
+static const uint8_t FLG_BLOCK_CHECKSUM = 0x10;
+static const uint8_t FLG_CONTENT_SIZE = 0x08;
+static const uint8_t FLG_CONTENT_CHECKSUM = 0x04;
+static const uint8_t FLG_RESERVED = 0x02;
+static const uint8_t FLG_DICT_ID = 0x01;
+static const uint8_t BD_RESERVED = 0x8f;
+static const uint32_t BLOCK_UNCOMPRESSED = 0x80000000;
+static const size_t MAX_HEADER_LENGTH = 19;
+// Matches reach back at most 64KiB, so that's all of a dictionary or history that matters.
+static const size_t HISTORY_SIZE = 64 * 1024;
+// We write 64KiB blocks, which keeps a stream's memory small and latency low.
+static const size_t ENCODER_BLOCK_SIZE = 64 * 1024;
+static const uint8_t ENCODER_BD = 4 << 4;
+
+static inline uint8_t headerChecksum(const uint8_t* descriptor, size_t length) {
+    return (Xxh32::hash(descriptor, length) >> 8) & 0xff;
+}
+
+Lz4FrameInput::Lz4FrameInput()
+        : nextIn(NULL), availIn(0), totalIn(0), totalOut(0), mCopy(NULL), mCopyCapacity(0) {
+}
+
+bool Lz4FrameInput::copyInput(const uint8_t* data, size_t length) {
+    if (length > mCopyCapacity) {
+        mCopy.reset(new uint8_t[length]);
+        if (mCopy.get() == NULL) {
+            mCopyCapacity = 0;
+            availIn = 0;
+            return false;
+        }
+        mCopyCapacity = length;
+    }
+    if (length > 0) {
+        memcpy(&mCopy[0], data, length);
+    }
+    nextIn = mCopy.get();
+    availIn = length;
+    return true;
+}
+
+void Lz4FrameInput::borrowInput(const uint8_t* data, size_t length) {
+    nextIn = data;
+    availIn = length;
+}
+
+Lz4FrameEncoder::Lz4FrameEncoder()
+        : mState(HEADER), mWindow(NULL), mDictLength(0), mBlockLength(0), mDictTable(NULL),
+          mTable(NULL), mPending(NULL), mPendingStart(0), mPendingEnd(0) {
+}
+
+bool Lz4FrameEncoder::init() {
+    mWindow.reset(new uint8_t[HISTORY_SIZE + ENCODER_BLOCK_SIZE]);
+    mTable.reset(new uint32_t[LZ4_HASH_TABLE_SIZE]);
+    // Room for a block (with its size), or the header, or the end mark and checksum.
+    mPending.reset(new uint8_t[4 + lz4CompressBound(ENCODER_BLOCK_SIZE)]);
+    return mWindow.get() != NULL && mTable.get() != NULL && mPending.get() != NULL;
+}
+
+void Lz4FrameEncoder::setDictionary(const uint8_t* dictionary, size_t length) {
+    if (length > HISTORY_SIZE) {
+        dictionary += length - HISTORY_SIZE;
+        length = HISTORY_SIZE;
+    }
+    memcpy(&mWindow[0], dictionary, length);
+    mDictLength = length;
+    if (mDictTable.get() == NULL) {
+        mDictTable.reset(new uint32_t[LZ4_HASH_TABLE_SIZE]);
+        if (mDictTable.get() == NULL) {
+            // Compress without the dictionary: the output is still valid, just bigger.
+            mDictLength = 0;
+            return;
+        }
+    }
+    memset(&mDictTable[0], 0, LZ4_HASH_TABLE_SIZE * sizeof(uint32_t));
+    for (size_t i = 0; i + MIN_MATCH <= length; ++i) {
+        mDictTable[hashPosition(&mWindow[i])] = i;
+    }
+}
+
+void Lz4FrameEncoder::writeHeader() {
+    uint8_t* p = &mPending[0];
+    writeLittleEndian32(p, FRAME_MAGIC);
+    p[4] = FLG_VERSION | FLG_BLOCK_INDEPENDENCE | FLG_CONTENT_CHECKSUM;
+    p[5] = ENCODER_BD;
+    p[6] = headerChecksum(p + 4, 2);
+    mPendingStart = 0;
+    mPendingEnd = 7;
+}
+
+void Lz4FrameEncoder::writeBlock() {
+    // Blocks are independent, so that each one can only refer back into the dictionary.
+    if (mDictLength > 0) {
+        memcpy(&mTable[0], &mDictTable[0], LZ4_HASH_TABLE_SIZE * sizeof(uint32_t));
+    } else {
+        memset(&mTable[0], 0, LZ4_HASH_TABLE_SIZE * sizeof(uint32_t));
+    }
+    size_t length = lz4CompressBlock(&mWindow[0], mDictLength, mBlockLength, &mPending[4],
+            &mTable[0]);
+    if (length < mBlockLength) {
+        writeLittleEndian32(&mPending[0], length);
+    } else {
+        writeLittleEndian32(&mPending[0], mBlockLength | BLOCK_UNCOMPRESSED);
+        memcpy(&mPending[4], &mWindow[mDictLength], mBlockLength);
+        length = mBlockLength;
+    }
+    mPendingStart = 0;
+    mPendingEnd = 4 + length;
+    mBlockLength = 0;
+}
+
+void Lz4FrameEncoder::writeTrailer() {
+    writeLittleEndian32(&mPending[0], 0);
+    writeLittleEndian32(&mPending[4], mContentHash.digest());
+    mPendingStart = 0;
+    mPendingEnd = 8;
+}
+
+size_t Lz4FrameEncoder::encode(uint8_t* out, size_t capacity, bool flush, bool finish) {
+    size_t written = 0;
+    while (true) {
+        if (mPendingStart != mPendingEnd) {
+            size_t n = std::min(mPendingEnd - mPendingStart, capacity - written);
+            memcpy(out + written, &mPending[mPendingStart], n);
+            mPendingStart += n;
+            written += n;
+            if (mPendingStart != mPendingEnd) {
+                break;
+            }
+        }
+        if (mState == HEADER) {
+            writeHeader();
+            mState = BLOCKS;
+        } else if (mState == DONE) {
+            break;
+        } else if (availIn > 0 && mBlockLength < ENCODER_BLOCK_SIZE) {
+            size_t n = std::min(availIn, ENCODER_BLOCK_SIZE - mBlockLength);
+            memcpy(&mWindow[mDictLength + mBlockLength], nextIn, n);
+            mContentHash.update(nextIn, n);
+            mBlockLength += n;
+            nextIn += n;
+            availIn -= n;
+            totalIn += n;
+        } else if (mBlockLength == ENCODER_BLOCK_SIZE || ((flush || finish) && mBlockLength > 0)) {
+            writeBlock();
+        } else if (finish) {
+            writeTrailer();
+            mState = DONE;
+        } else {
+            break;
+        }
+    }
+    totalOut += written;
+    return written;
+}
+
+bool Lz4FrameEncoder::finished() const {
+    return mState == DONE && mPendingStart == mPendingEnd;
+}
+
+void Lz4FrameEncoder::reset() {
+    mState = HEADER;
+    mBlockLength = 0;
+    mPendingStart = mPendingEnd = 0;
+    mContentHash.reset();
+    nextIn = NULL;
+    availIn = 0;
+    totalIn = totalOut = 0;
+}
+
+Lz4FrameDecoder::Lz4FrameDecoder()
+        : mState(HEADER), mError(NULL), mStaging(NULL), mStagingLength(0), mStagingCapacity(0),
+          mHeaderLength(0), mIndependentBlocks(false), mBlockChecksums(false),
+          mContentChecksum(false), mHasContentSize(false), mContentSize(0), mMaxBlockSize(0),
+          mBlockSize(0), mBlockCompressed(false), mBlockChecksum(0), mDecodedLength(0), mWindow(NULL), mWindowCapacity(0),
+          mHistoryLength(0), mPendingStart(0), mPendingEnd(0), mDictionary(NULL),
+          mDictLength(0) {
+}
+
+bool Lz4FrameDecoder::setDictionary(const uint8_t* dictionary, size_t length) {
+    if (length > HISTORY_SIZE) {
+        dictionary += length - HISTORY_SIZE;
+        length = HISTORY_SIZE;
+    }
+    mDictionary.reset(new uint8_t[length]);
+    if (mDictionary.get() == NULL) {
+        mDictLength = 0;
+        return false;
+    }
+    memcpy(&mDictionary[0], dictionary, length);
+    mDictLength = length;
+    return true;
+}
+
+void Lz4FrameDecoder::reset() {
+    mState = HEADER;
+    mError = NULL;
+    mStagingLength = 0;
+    mHistoryLength = 0;
+    mPendingStart = mPendingEnd = 0;
+    mDecodedLength = 0;
+    mContentHash.reset();
+    nextIn = NULL;
+    availIn = 0;
+    totalIn = totalOut = 0;
+}
+
+ssize_t Lz4FrameDecoder::fail(const char* error) {
+    mState = FAILED;
+    mError = error;
+    return -1;
+}
+
+// Gathers input in mStaging until it holds 'wanted' bytes. Returns false if the input ran out
+// first.
+bool Lz4FrameDecoder::fill(size_t wanted) {
+    size_t n = std::min(wanted - mStagingLength, availIn);
+    memcpy(&mStaging[mStagingLength], nextIn, n);
+    mStagingLength += n;
+    nextIn += n;
+    availIn -= n;
+    totalIn += n;
+    return mStagingLength == wanted;
+}
+
+bool Lz4FrameDecoder::parseHeader() {
+    const uint8_t* header = &mStaging[0];
+    uint8_t flg = header[4];
+    uint8_t bd = header[5];
+    if (headerChecksum(header + 4, mHeaderLength - 5) != header[mHeaderLength - 1]) {
+        mError = "Bad LZ4 frame header checksum";
+        return false;
+    }
+    if ((bd & BD_RESERVED) != 0 || ((bd >> 4) & 7) < 4) {
+        mError = "Bad LZ4 block size";
+        return false;
+    }
+    mIndependentBlocks = (flg & FLG_BLOCK_INDEPENDENCE) != 0;
+    mBlockChecksums = (flg & FLG_BLOCK_CHECKSUM) != 0;
+    mContentChecksum = (flg & FLG_CONTENT_CHECKSUM) != 0;
+    mHasContentSize = (flg & FLG_CONTENT_SIZE) != 0;
+    if (mHasContentSize) {
+        mContentSize = readLittleEndian32(header + 6)
+                | (static_cast<uint64_t>(readLittleEndian32(header + 10)) << 32);
+    }
+    // The dictionary ID (if any) only identifies the dictionary, which must already be set.
+    mMaxBlockSize = static_cast<size_t>(1) << (2 * ((bd >> 4) & 7) + 8);
+
+    size_t windowCapacity = HISTORY_SIZE + mMaxBlockSize;
+    if (mWindowCapacity < windowCapacity) {
+        mWindow.reset(new uint8_t[windowCapacity]);
+        mWindowCapacity = (mWindow.get() != NULL) ? windowCapacity : 0;
+    }
+    if (mStagingCapacity < mMaxBlockSize) {
+        UniquePtr<uint8_t[]> staging(new uint8_t[mMaxBlockSize]);
+        if (staging.get() != NULL) {
+            mStaging.reset(staging.release());
+            mStagingCapacity = mMaxBlockSize;
+        }
+    }
+    if (mWindowCapacity < windowCapacity || mStagingCapacity < mMaxBlockSize) {
+        mError = "Out of memory for LZ4 block buffers";
+        return false;
+    }
+    if (mDictLength > 0) {
+        memcpy(&mWindow[0], &mDictionary[0], mDictLength);
+    }
+    mHistoryLength = mDictLength;
+    mPendingStart = mPendingEnd = mHistoryLength;
+    return true;
+}
+
+bool Lz4FrameDecoder::decodeBlock() {
+    const uint8_t* block;
+    if (mStagingLength == 0 && availIn >= mBlockSize) {
+        // The whole block is in the input, so decode it in place.
+        block = nextIn;
+        nextIn += mBlockSize;
+        availIn -= mBlockSize;
+        totalIn += mBlockSize;
+    } else if (fill(mBlockSize)) {
+        block = &mStaging[0];
+    } else {
+        return false;
+    }
+    if (mBlockChecksums) {
+        // Keep the checksum of the raw block until its stored checksum arrives.
+        mBlockChecksum = Xxh32::hash(block, mBlockSize);
+    }
+    if (!mIndependentBlocks) {
+        // Linked blocks refer back into the previous 64KiB of output.
+        size_t keep = std::min(mPendingEnd, HISTORY_SIZE);
+        memmove(&mWindow[0], &mWindow[mPendingEnd - keep], keep);
+        mHistoryLength = keep;
+    }
+    uint8_t* dst = &mWindow[mHistoryLength];
+    ssize_t length;
+    if (mBlockCompressed) {
+        length = lz4DecompressBlock(block, mBlockSize, dst, mMaxBlockSize, mHistoryLength);
+    } else {
+        memcpy(dst, block, mBlockSize);
+        length = mBlockSize;
+    }
+    if (length < 0) {
+        mError = "Corrupt LZ4 block";
+        return false;
+    }
+    if (mContentChecksum) {
+        mContentHash.update(dst, length);
+    }
+    mDecodedLength += length;
+    mPendingStart = mHistoryLength;
+    mPendingEnd = mHistoryLength + length;
+    mStagingLength = 0;
+    return true;
+}
+
+ssize_t Lz4FrameDecoder::decode(uint8_t* out, size_t capacity) {
+    if (mState == FAILED) {
+        return -1;
+    }
+    size_t written = 0;
+    while (true) {
+        if (mPendingStart != mPendingEnd) {
+            size_t n = std::min(mPendingEnd - mPendingStart, capacity - written);
+            memcpy(out + written, &mWindow[mPendingStart], n);
+            mPendingStart += n;
+            written += n;
+            if (mPendingStart != mPendingEnd) {
+                break;
+            }
+        }
+        if (mState == HEADER) {
+            if (mStaging.get() == NULL) {
+                mStaging.reset(new uint8_t[MAX_HEADER_LENGTH]);
+                if (mStaging.get() == NULL) {
+                    return fail("Out of memory for LZ4 block buffers");
+                }
+                mStagingCapacity = MAX_HEADER_LENGTH;
+            }
+            if (!fill(7)) {
+                break;
+            }
+            uint8_t flg = mStaging[4];
+            if (readLittleEndian32(&mStaging[0]) != FRAME_MAGIC) {
+                return fail("Not an LZ4 frame");
+            }
+            if ((flg & FLG_VERSION_MASK) != FLG_VERSION || (flg & FLG_RESERVED) != 0) {
+                return fail("Unsupported LZ4 frame version");
+            }
+            mHeaderLength = 7 + ((flg & FLG_CONTENT_SIZE) ? 8 : 0) + ((flg & FLG_DICT_ID) ? 4 : 0);
+            if (!fill(mHeaderLength)) {
+                break;
+            }
+            if (!parseHeader()) {
+                return fail(mError);
+            }
+            mStagingLength = 0;
+            mState = BLOCK_SIZE;
+        } else if (mState == BLOCK_SIZE) {
+            if (!fill(4)) {
+                break;
+            }
+            uint32_t blockSize = readLittleEndian32(&mStaging[0]);
+            mStagingLength = 0;
+            if (blockSize == 0) {
+                if (mHasContentSize && mDecodedLength != mContentSize) {
+                    return fail("LZ4 frame content size mismatch");
+                }
+                mState = mContentChecksum ? CONTENT_CHECKSUM : DONE;
+                continue;
+            }
+            mBlockCompressed = (blockSize & BLOCK_UNCOMPRESSED) == 0;
+            mBlockSize = blockSize & ~BLOCK_UNCOMPRESSED;
+            if (mBlockSize > mMaxBlockSize) {
+                return fail("LZ4 block larger than the frame's maximum");
+            }
+            mState = BLOCK_DATA;
+        } else if (mState == BLOCK_DATA) {
+            if (!decodeBlock()) {
+                if (mError != NULL) {
+                    return fail(mError);
+                }
+                break;
+            }
+            mState = mBlockChecksums ? BLOCK_CHECKSUM : BLOCK_SIZE;
+        } else if (mState == BLOCK_CHECKSUM) {
+            if (!fill(4)) {
+                break;
+            }
+            mStagingLength = 0;
+            if (readLittleEndian32(&mStaging[0]) != mBlockChecksum) {
+                return fail("LZ4 block checksum mismatch");
+            }
+            mState = BLOCK_SIZE;
+        } else if (mState == CONTENT_CHECKSUM) {
+            if (!fill(4)) {
+                break;
+            }
+            mStagingLength = 0;
+            if (readLittleEndian32(&mStaging[0]) != mContentHash.digest()) {
+                return fail("LZ4 content checksum mismatch");
+            }
+            mState = DONE;
+        } else {
+            break;
+        }
+    }
+    totalOut += written;
+    return written;
+}
@@ -0,0 +1,211 @@
+/*
+ * Copyright (C) 2014 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef LZ4_FRAME_H_included
+#define LZ4_FRAME_H_included
+
+#include "UniquePtr.h"
+
+#include <stddef.h>
+#include <stdint.h>
+#include <sys/types.h>
+
+/*
+ * A self-contained implementation of the LZ4 frame format
+ * (https://github.com/lz4/lz4/blob/dev/doc/lz4_Frame_format.md), for payloads where deflate's
+ * CPU cost matters more than its ratio. The streams are driven like a z_stream: point them at
+ * some input, then call encode or decode with an output buffer until they finish or need more
+ * input. The frames interoperate with the reference lz4 tool, including "lz4 -D dictionary".
+ */
+
+// Streaming XXH32, which the frame format uses for its header and content checksums.
+class Xxh32 {
+public:
+    explicit Xxh32(uint32_t seed = 0) {
+        reset(seed);
+    }
+    void reset(uint32_t seed = 0);
+    void update(const uint8_t* data, size_t length);
+    uint32_t digest() const;
+
+    static uint32_t hash(const uint8_t* data, size_t length, uint32_t seed = 0);
+
+private:
+    uint32_t mAcc[4];
+    uint32_t mSeed;
+    uint64_t mTotalLength;
+    uint8_t mBuffer[16];
+    size_t mBufferLength;
+};
+
+// The input of a stream, which is either copied (from a Java array) or borrowed (from
+// caller-owned memory such as a direct buffer, which must stay valid until it's consumed).
+class Lz4FrameInput {
+public:
+    Lz4FrameInput();
+
+    // Returns false if the copy couldn't be allocated.
+    bool copyInput(const uint8_t* data, size_t length);
+    void borrowInput(const uint8_t* data, size_t length);
+
+    const uint8_t* nextIn;
+    size_t availIn;
+    uint64_t totalIn;
+    uint64_t totalOut;
+
+private:
+    UniquePtr<uint8_t[]> mCopy;
+    size_t mCopyCapacity;
+
+    // Disallow copy and assignment.
+    Lz4FrameInput(const Lz4FrameInput&);
+    void operator=(const Lz4FrameInput&);
+};
+
+class Lz4FrameEncoder : public Lz4FrameInput {
+public:
+    Lz4FrameEncoder();
+
+    // Returns false if the stream's buffers couldn't be allocated.
+    bool init();
+
+    // Compresses against the last 64KiB of 'dictionary', which the decoder must also be given.
+    // Only valid before the first call to encode.
+    void setDictionary(const uint8_t* dictionary, size_t length);
+
+    // Consumes input and writes up to 'capacity' bytes of frame to 'out', returning the number
+    // written. Buffered input is compressed as a block once the block is full, or when 'flush'
+    // or 'finish' is set; 'finish' also ends the frame once all input has been consumed.
+    size_t encode(uint8_t* out, size_t capacity, bool flush, bool finish);
+
+    // True once the whole frame, up to its content checksum, has been written out.
+    bool finished() const;
+
+    // True if there are bytes of frame waiting for output space.
+    bool hasPendingOutput() const {
+        return mPendingStart != mPendingEnd;
+    }
+
+    // Starts a new frame, keeping the dictionary.
+    void reset();
+
+private:
+    void writeHeader();
+    void writeBlock();
+    void writeTrailer();
+
+    enum State { HEADER, BLOCKS, DONE };
+    State mState;
+    // The dictionary, followed by the block being filled.
+    UniquePtr<uint8_t[]> mWindow;
+    size_t mDictLength;
+    size_t mBlockLength;
+    // The compressor's hash table after loading just the dictionary.
+    UniquePtr<uint32_t[]> mDictTable;
+    UniquePtr<uint32_t[]> mTable;
+    UniquePtr<uint8_t[]> mPending;
+    size_t mPendingStart;
+    size_t mPendingEnd;
+    Xxh32 mContentHash;
+};
+
+class Lz4FrameDecoder : public Lz4FrameInput {
+public:
+    Lz4FrameDecoder();
+
+    // Decompresses blocks as though 'dictionary' preceded them. Only valid before the first
+    // call to decode.
+    bool setDictionary(const uint8_t* dictionary, size_t length);
+
+    // Consumes input and writes up to 'capacity' bytes of content to 'out', returning the
+    // number written, or -1 if the input isn't a valid frame (see error()). Input after the end
+    // of the frame is left unconsumed.
+    ssize_t decode(uint8_t* out, size_t capacity);
+
+    // True once the whole frame has been consumed and its content written out.
+    bool finished() const {
+        return mState == DONE && mPendingStart == mPendingEnd;
+    }
+
+    bool hasPendingOutput() const {
+        return mPendingStart != mPendingEnd;
+    }
+
+    // A description of why decode failed.
+    const char* error() const {
+        return mError;
+    }
+
+    // Starts a new frame, keeping the dictionary.
+    void reset();
+
+private:
+    bool fill(size_t wanted);
+    bool parseHeader();
+    bool decodeBlock();
+    ssize_t fail(const char* error);
+
+    enum State { HEADER, BLOCK_SIZE, BLOCK_DATA, BLOCK_CHECKSUM, CONTENT_CHECKSUM, DONE, FAILED };
+    State mState;
+    const char* mError;
+    // Header fields, blocks and checksums are gathered here when they span calls.
+    UniquePtr<uint8_t[]> mStaging;
+    size_t mStagingLength;
+    size_t mStagingCapacity;
+    size_t mHeaderLength;
+    bool mIndependentBlocks;
+    bool mBlockChecksums;
+    bool mContentChecksum;
+    bool mHasContentSize;
+    uint64_t mContentSize;
+    size_t mMaxBlockSize;
+    uint32_t mBlockSize;
+    bool mBlockCompressed;
+    uint32_t mBlockChecksum;
+    uint64_t mDecodedLength;
+    // The decoded history (the dictionary, or the previous 64KiB of output), followed by the
+    // block being written out. mPendingStart and mPendingEnd index into this.
+    UniquePtr<uint8_t[]> mWindow;
+    size_t mWindowCapacity;
+    size_t mHistoryLength;
+    size_t mPendingStart;
+    size_t mPendingEnd;
+    UniquePtr<uint8_t[]> mDictionary;
+    size_t mDictLength;
+    Xxh32 mContentHash;
+};
+
+// Returns the most lz4CompressBlock can write for 'length' bytes of input.
+inline size_t lz4CompressBound(size_t length) {
+    return length + length / 255 + 16;
+}
+
+static const size_t LZ4_HASH_TABLE_SIZE = 4096;
+
+// Compresses the 'length' bytes at 'window + start' as one LZ4 block, finding matches up to
+// 64KiB back, including in the 'start' bytes of history before them. 'table' is the hash table
+// (LZ4_HASH_TABLE_SIZE positions relative to 'window'), which must be zeroed or hold only
+// positions in the history. 'dst' must have room for lz4CompressBound(length) bytes. Returns
+// the compressed length.
+size_t lz4CompressBlock(const uint8_t* window, size_t start, size_t length, uint8_t* dst,
+        uint32_t* table);
+
+// Decompresses one LZ4 block, which may refer back up to 'historyLength' bytes before 'dst'.
+// Returns the decompressed length, or -1 if the block is malformed or doesn't fit.
+ssize_t lz4DecompressBlock(const uint8_t* src, size_t srcLength, uint8_t* dst, size_t dstCapacity,
+        size_t historyLength);
+
+#endif  // LZ4_FRAME_H_included
@@ -0,0 +1,172 @@
+/*
+ * Copyright (C) 2014 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#define LOG_TAG "NativeCounters"
+
+#include "NativeCounters.h"
+
+#if defined(LIBCORE_NATIVE_COUNTERS)
+
+#include "ScopedPthreadMutexLock.h"
+#include "cutils/log.h"
+
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+// There are a little over 500 natives. Shards are allocated with calloc, so the pages for
+// counters a thread never touches are never dirtied.
+static const int MAX_COUNTED_NATIVES = 1024;
+
+// One thread's counters. Only the owning thread writes them, so updates are plain relaxed
+// loads and stores rather than read-modify-writes; readers may see a slightly stale value.
+struct NativeCounterShard {
+    NativeCounterTotals counters[MAX_COUNTED_NATIVES];
+    NativeCounterShard* next;
+    bool inUse;
+};
+
+static pthread_mutex_t gNativeCountersMutex = PTHREAD_MUTEX_INITIALIZER;
+static const char* gNativeCounterNames[MAX_COUNTED_NATIVES];
+static int gNativeCounterCount = 0;
+
+// Every shard ever allocated. A thread's shard is released for reuse when it exits, keeping its
+// counts, so the list only grows to the peak number of threads that have called a native.
+static NativeCounterShard* gShards = NULL;
+
+static __thread NativeCounterShard* tShard = NULL;
+static __thread int tCurrentIndex = -1;
+
+static pthread_key_t gShardKey;
+static pthread_once_t gShardKeyOnce = PTHREAD_ONCE_INIT;
+
+// Runs on the exiting thread.
+static void releaseShard(void* shard) {
+    tShard = NULL;
+    ScopedPthreadMutexLock lock(&gNativeCountersMutex);
+    reinterpret_cast<NativeCounterShard*>(shard)->inUse = false;
+}
+
+static void createShardKey() {
+    pthread_key_create(&gShardKey, releaseShard);
+}
+
+static NativeCounterShard* acquireShard() {
+    pthread_once(&gShardKeyOnce, createShardKey);
+    NativeCounterShard* shard = NULL;
+    {
+        ScopedPthreadMutexLock lock(&gNativeCountersMutex);
+        for (NativeCounterShard* it = gShards; it != NULL; it = it->next) {
+            if (!it->inUse) {
+                shard = it;
+                break;
+            }
+        }
+        if (shard == NULL) {
+            shard = reinterpret_cast<NativeCounterShard*>(calloc(1, sizeof(NativeCounterShard)));
+            if (shard == NULL) {
+                return NULL;
+            }
+            shard->next = gShards;
+            gShards = shard;
+        }
+        shard->inUse = true;
+    }
+    pthread_setspecific(gShardKey, shard);
+    return shard;
+}
+
+static long long monotonicNanos() {
+    timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec * 1000000000LL + now.tv_nsec;
+}
+
+static inline void addRelaxed(uint64_t* counter, uint64_t delta) {
+    __atomic_store_n(counter, __atomic_load_n(counter, __ATOMIC_RELAXED) + delta,
+                     __ATOMIC_RELAXED);
+}
+
+int registerCountedNative(const char* name) {
+    ScopedPthreadMutexLock lock(&gNativeCountersMutex);
+    if (gNativeCounterCount == MAX_COUNTED_NATIVES) {
+        ALOGW("Too many natives to count; not counting %s", name);
+        return -1;
+    }
+    gNativeCounterNames[gNativeCounterCount] = name;
+    return gNativeCounterCount++;
+}
+
+void countNativeBytes(size_t byteCount) {
+    if (tCurrentIndex != -1 && tShard != NULL) {
+        addRelaxed(&tShard->counters[tCurrentIndex].bytes, byteCount);
+    }
+}
+
+ScopedNativeCounter::ScopedNativeCounter(int index) : mIndex(index), mOuterIndex(tCurrentIndex) {
+    if (mIndex != -1 && tShard == NULL) {
+        tShard = acquireShard();
+    }
+    tCurrentIndex = mIndex;
+    mStartNs = monotonicNanos();
+}
+
+ScopedNativeCounter::~ScopedNativeCounter() {
+    long long elapsedNs = monotonicNanos() - mStartNs;
+    tCurrentIndex = mOuterIndex;
+    if (mIndex == -1 || tShard == NULL) {
+        return;
+    }
+    NativeCounterTotals& counter = tShard->counters[mIndex];
+    addRelaxed(&counter.calls, 1);
+    addRelaxed(&counter.nanos, elapsedNs);
+    int bucket = (elapsedNs > 1) ? 63 - __builtin_clzll(elapsedNs) : 0;
+    if (bucket >= NATIVE_COUNTER_HISTOGRAM_BUCKETS) {
+        bucket = NATIVE_COUNTER_HISTOGRAM_BUCKETS - 1;
+    }
+    addRelaxed(&counter.histogram[bucket], 1);
+}
+
+int nativeCounterCount() {
+    ScopedPthreadMutexLock lock(&gNativeCountersMutex);
+    return gNativeCounterCount;
+}
+
+const char* nativeCounterName(int index) {
+    ScopedPthreadMutexLock lock(&gNativeCountersMutex);
+    return gNativeCounterNames[index];
+}
+
+void sumNativeCounters(NativeCounterTotals* totals, int count) {
+    memset(totals, 0, count * sizeof(NativeCounterTotals));
+    ScopedPthreadMutexLock lock(&gNativeCountersMutex);
+    for (NativeCounterShard* shard = gShards; shard != NULL; shard = shard->next) {
+        for (int i = 0; i < count; ++i) {
+            const NativeCounterTotals& counter = shard->counters[i];
+            NativeCounterTotals& total = totals[i];
+            total.calls += __atomic_load_n(&counter.calls, __ATOMIC_RELAXED);
+            total.bytes += __atomic_load_n(&counter.bytes, __ATOMIC_RELAXED);
+            total.nanos += __atomic_load_n(&counter.nanos, __ATOMIC_RELAXED);
+            for (int bucket = 0; bucket < NATIVE_COUNTER_HISTOGRAM_BUCKETS; ++bucket) {
+                total.histogram[bucket] +=
+                        __atomic_load_n(&counter.histogram[bucket], __ATOMIC_RELAXED);
+            }
+        }
+    }
+}
+
+#endif  // LIBCORE_NATIVE_COUNTERS
@@ -0,0 +1,110 @@
+/*
+ * Copyright (C) 2014 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef NATIVE_COUNTERS_H_included
+#define NATIVE_COUNTERS_H_included
+
+#include "JNIHelp.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Per-method counters for the natives registered in Register.cpp: number of calls, bytes moved,
+// total time, and a histogram of call durations. They're only collected in builds made with
+// LIBCORE_NATIVE_COUNTERS=true, which force-includes this header into every native source file
+// so that NATIVE_METHOD registers a counting trampoline in place of each function. Each thread
+// updates its own shard without atomic read-modify-writes; libcore.io.NativeCounters merges the
+// shards on demand.
+
+// The number of histogram buckets. Bucket 'i' counts calls that took [2^i, 2^(i+1)) ns, except
+// that bucket 0 also counts calls that took 0ns, and the last bucket has no upper bound.
+#define NATIVE_COUNTER_HISTOGRAM_BUCKETS 32
+
+#if defined(LIBCORE_NATIVE_COUNTERS)
+
+// Returns the counter index for the native called 'name', or -1 if there are no more counters.
+int registerCountedNative(const char* name);
+
+// Adds 'byteCount' to the bytes moved by the innermost counted native running on this thread.
+void countNativeBytes(size_t byteCount);
+
+struct NativeCounterTotals {
+    uint64_t calls;
+    uint64_t bytes;
+    uint64_t nanos;
+    uint64_t histogram[NATIVE_COUNTER_HISTOGRAM_BUCKETS];
+};
+
+// Returns the number of registered counters. Indexes below this are valid.
+int nativeCounterCount();
+
+// Returns the name passed to registerCountedNative for counter 'index'.
+const char* nativeCounterName(int index);
+
+// Sums every thread's shard of the first 'count' counters into 'totals'. Counters updated while
+// this runs may or may not be included.
+void sumNativeCounters(NativeCounterTotals* totals, int count);
+
+// Times the enclosing scope and charges it to counter 'index'.
+class ScopedNativeCounter {
+public:
+    explicit ScopedNativeCounter(int index);
+    ~ScopedNativeCounter();
+
+private:
+    int mIndex;
+    int mOuterIndex;
+    long long mStartNs;
+
+    // Disallow copy and assignment.
+    ScopedNativeCounter(const ScopedNativeCounter&);
+    void operator=(const ScopedNativeCounter&);
+};
+
+template <typename F, F function> struct CountedNative;
+
+template <typename R, typename... Args, R (*function)(JNIEnv*, Args...)>
+struct CountedNative<R (*)(JNIEnv*, Args...), function> {
+    static int index;
+
+    static R call(JNIEnv* env, Args... args) {
+        ScopedNativeCounter counter(index);
+        return function(env, args...);
+    }
+
+    static void* registerTrampoline(const char* name) {
+        index = registerCountedNative(name);
+        return reinterpret_cast<void*>(call);
+    }
+};
+
+template <typename R, typename... Args, R (*function)(JNIEnv*, Args...)>
+int CountedNative<R (*)(JNIEnv*, Args...), function>::index = -1;
+
+#undef NATIVE_METHOD
+#define NATIVE_METHOD(className, functionName, signature) \
+    { #functionName, signature, \
+      CountedNative<decltype(&className ## _ ## functionName), &className ## _ ## functionName>:: \
+          registerTrampoline(#className "." #functionName) }
+
+#else
+
+inline void countNativeBytes(size_t) {
+}
+
+#endif  // LIBCORE_NATIVE_COUNTERS
+
+#endif  // NATIVE_COUNTERS_H_included
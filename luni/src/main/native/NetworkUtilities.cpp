@@ -112,6 +112,29 @@ jobject sockaddrToInetAddress(JNIEnv* env, const sockaddr_storage& ss, jint* por
             NULL, byteArray.get(), scope_id);
 }
 
+void sockaddrToPackedSockaddr(const sockaddr_storage& ss, jbyte* dst) {
+    memset(dst, 0, PACKED_SOCKADDR_LENGTH);
+    if (ss.ss_family == AF_INET6) {
+        const sockaddr_in6& sin6 = reinterpret_cast<const sockaddr_in6&>(ss);
+        memcpy(dst, &sin6.sin6_port, 2);
+        memcpy(dst + 2, &sin6.sin6_addr, 16);
+    } else if (ss.ss_family == AF_INET) {
+        const sockaddr_in& sin = reinterpret_cast<const sockaddr_in&>(ss);
+        memcpy(dst, &sin.sin_port, 2);
+        dst[2 + 10] = dst[2 + 11] = static_cast<jbyte>(0xff);
+        memcpy(dst + 2 + 12, &sin.sin_addr, 4);
+    }
+}
+
+socklen_t packedSockaddrToSockaddr(const jbyte* src, sockaddr_storage& ss) {
+    memset(&ss, 0, sizeof(ss));
+    sockaddr_in6& sin6 = reinterpret_cast<sockaddr_in6&>(ss);
+    sin6.sin6_family = AF_INET6;
+    memcpy(&sin6.sin6_port, src, 2);
+    memcpy(&sin6.sin6_addr, src + 2, 16);
+    return sizeof(sin6);
+}
+
 static bool inetAddressToSockaddr(JNIEnv* env, jobject inetAddress, int port, sockaddr_storage& ss, socklen_t& sa_len, bool map) {
     memset(&ss, 0, sizeof(ss));
     sa_len = 0;
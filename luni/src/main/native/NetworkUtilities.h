@@ -44,7 +44,18 @@ bool inetAddressToSockaddr(JNIEnv* env, jobject inetAddress, int port,
 bool inetAddressToSockaddrVerbatim(JNIEnv* env, jobject inetAddress, int port,
                                    sockaddr_storage& ss, socklen_t& sa_len);
 
+// A packed socket address is a big-endian port followed by a 16-byte IPv6 address, with IPv4
+// addresses IPv4-mapped, since all our sockets are AF_INET6. Natives use it to report a peer
+// into a caller-supplied byte[] rather than allocating an InetAddress.
+#define PACKED_SOCKADDR_LENGTH 18
 
+// Writes 'ss' to 'dst' as a packed socket address. Families other than AF_INET and AF_INET6
+// (such as an unnamed AF_UNIX peer) are written as all zeros.
+void sockaddrToPackedSockaddr(const sockaddr_storage& ss, jbyte* dst);
+
+// The inverse of sockaddrToPackedSockaddr. Always produces an AF_INET6 sockaddr_in6, and
+// returns its length.
+socklen_t packedSockaddrToSockaddr(const jbyte* src, sockaddr_storage& ss);
 
 // Changes 'fd' to be blocking/non-blocking. Returns false and sets errno on failure.
 // @Deprecated - use IoUtils.setBlocking
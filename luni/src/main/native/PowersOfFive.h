@@ -0,0 +1,45 @@
+/*
+ * Copyright (C) 2014 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef POWERS_OF_FIVE_H_included
+#define POWERS_OF_FIVE_H_included
+
+#include <stdint.h>
+
+/*
+ * 128-bit approximations of 5^q for q in [SMALLEST_POWER_OF_FIVE, LARGEST_POWER_OF_FIVE], each
+ * scaled by a power of two so that its most significant bit is set, stored as (high, low) pairs
+ * of 64-bit words. Powers with q >= 0 are truncated and those with q < 0 are rounded up, which is
+ * what the Eisel-Lemire decimal-to-binary algorithm in java_lang_StringToReal.cpp relies on.
+ */
+static const int SMALLEST_POWER_OF_FIVE = -342;
+static const int LARGEST_POWER_OF_FIVE = 308;
+extern const uint64_t POWERS_OF_FIVE_128[2 * (LARGEST_POWER_OF_FIVE - SMALLEST_POWER_OF_FIVE + 1)];
+
+/*
+ * The tables used by the Ryu shortest-digits algorithm in java_lang_RealToString.cpp, stored as
+ * (low, high) pairs of 64-bit words. POW5_INV_SPLIT[i] is 2^(k + 124) / 5^i + 1, where k is the
+ * bit length of 5^i, for i in [0, POW5_INV_TABLE_SIZE). POW5_SPLIT[i] is 5^i scaled to a 125 bit
+ * number, truncating, for i in [0, POW5_TABLE_SIZE).
+ */
+static const int POW5_BIT_COUNT = 125;
+static const int POW5_INV_BIT_COUNT = 125;
+static const int POW5_INV_TABLE_SIZE = 342;
+static const int POW5_TABLE_SIZE = 326;
+extern const uint64_t POW5_INV_SPLIT[POW5_INV_TABLE_SIZE][2];
+extern const uint64_t POW5_SPLIT[POW5_TABLE_SIZE][2];
+
+#endif  // POWERS_OF_FIVE_H_included
@@ -17,10 +17,91 @@
 #define LOG_TAG "libcore" // We'll be next to "dalvikvm" in the log; make the distinction clear.
 
 #include "cutils/log.h"
+#include "IcuUtilities.h"
+#include "JNIHelp.h"
 #include "JniConstants.h"
 #include "ScopedLocalFrame.h"
+#include "ScopedPthreadMutexLock.h"
+#include "ScopedUtfChars.h"
 
+#include <pthread.h>
 #include <stdlib.h>
+#include <string.h>
+
+extern void register_java_text_Bidi(JNIEnv*);
+extern void register_java_util_regex_Matcher(JNIEnv*);
+extern void register_java_util_regex_Pattern(JNIEnv*);
+extern void register_libcore_icu_AlphabeticIndex(JNIEnv*);
+extern void register_libcore_icu_DateIntervalFormat(JNIEnv*);
+extern void register_libcore_icu_ICU(JNIEnv*);
+extern void register_libcore_icu_NativeBreakIterator(JNIEnv*);
+extern void register_libcore_icu_NativeCollation(JNIEnv*);
+extern void register_libcore_icu_NativeConverter(JNIEnv*);
+extern void register_libcore_icu_NativeDecimalFormat(JNIEnv*);
+extern void register_libcore_icu_NativeIDN(JNIEnv*);
+extern void register_libcore_icu_NativeNormalizer(JNIEnv*);
+extern void register_libcore_icu_NativePluralRules(JNIEnv*);
+extern void register_libcore_icu_TimeZoneNames(JNIEnv*);
+extern void register_libcore_icu_Transliterator(JNIEnv*);
+
+// The ICU-backed classes. Registering them resolves classes and, for ICU itself, maps ICU's data
+// file, which short-lived processes that never touch ICU needn't pay for. Normally they're
+// registered by JNI_OnLoad like everything else, but when built with LIBCORE_LAZY_REGISTRATION
+// each is registered from its class' static initializer, via NativeRegistration.ensureRegistered.
+struct LazyRegistration {
+    const char* className;
+    void (*registerNatives)(JNIEnv*);
+    bool registered;
+};
+
+static LazyRegistration gLazyRegistrations[] = {
+    { "java/text/Bidi", register_java_text_Bidi, false },
+    { "java/util/regex/Matcher", register_java_util_regex_Matcher, false },
+    { "java/util/regex/Pattern", register_java_util_regex_Pattern, false },
+    { "libcore/icu/AlphabeticIndex", register_libcore_icu_AlphabeticIndex, false },
+    { "libcore/icu/DateIntervalFormat", register_libcore_icu_DateIntervalFormat, false },
+    { "libcore/icu/ICU", register_libcore_icu_ICU, false },
+    { "libcore/icu/NativeBreakIterator", register_libcore_icu_NativeBreakIterator, false },
+    { "libcore/icu/NativeCollation", register_libcore_icu_NativeCollation, false },
+    { "libcore/icu/NativeConverter", register_libcore_icu_NativeConverter, false },
+    { "libcore/icu/NativeDecimalFormat", register_libcore_icu_NativeDecimalFormat, false },
+    { "libcore/icu/NativeIDN", register_libcore_icu_NativeIDN, false },
+    { "libcore/icu/NativeNormalizer", register_libcore_icu_NativeNormalizer, false },
+    { "libcore/icu/NativePluralRules", register_libcore_icu_NativePluralRules, false },
+    { "libcore/icu/TimeZoneNames", register_libcore_icu_TimeZoneNames, false },
+    { "libcore/icu/Transliterator", register_libcore_icu_Transliterator, false },
+};
+
+static pthread_mutex_t gLazyRegistrationsMutex = PTHREAD_MUTEX_INITIALIZER;
+
+static void registerLazily(JNIEnv* env, LazyRegistration& registration) {
+    // Every lazily registered class needs ICU's data, so map it first.
+    initIcuData();
+    registration.registerNatives(env);
+    registration.registered = true;
+}
+
+static void NativeRegistration_ensureRegistered(JNIEnv* env, jclass, jstring javaClassName) {
+    ScopedUtfChars className(env, javaClassName);
+    if (className.c_str() == NULL) {
+        return;
+    }
+    ScopedPthreadMutexLock lock(&gLazyRegistrationsMutex);
+    for (size_t i = 0; i < NELEM(gLazyRegistrations); ++i) {
+        LazyRegistration& registration = gLazyRegistrations[i];
+        if (strcmp(registration.className, className.c_str()) == 0) {
+            if (!registration.registered) {
+                registerLazily(env, registration);
+            }
+            return;
+        }
+    }
+    jniThrowException(env, "java/lang/IllegalArgumentException", className.c_str());
+}
+
+static JNINativeMethod gNativeRegistrationMethods[] = {
+    NATIVE_METHOD(NativeRegistration, ensureRegistered, "(Ljava/lang/String;)V"),
+};
 
 // DalvikVM calls this on startup, so we can statically register all our native methods.
 jint JNI_OnLoad(JavaVM* vm, void*) {
@@ -48,35 +129,37 @@ jint JNI_OnLoad(JavaVM* vm, void*) {
     REGISTER(register_java_math_NativeBN);
     REGISTER(register_java_nio_ByteOrder);
     REGISTER(register_java_nio_charset_Charsets);
-    REGISTER(register_java_text_Bidi);
     REGISTER(register_java_util_jar_StrictJarFile);
-    REGISTER(register_java_util_regex_Matcher);
-    REGISTER(register_java_util_regex_Pattern);
     REGISTER(register_java_util_zip_Adler32);
     REGISTER(register_java_util_zip_CRC32);
     REGISTER(register_java_util_zip_Deflater);
     REGISTER(register_java_util_zip_Inflater);
-    REGISTER(register_libcore_icu_AlphabeticIndex);
-    REGISTER(register_libcore_icu_DateIntervalFormat);
-    REGISTER(register_libcore_icu_ICU);
-    REGISTER(register_libcore_icu_NativeBreakIterator);
-    REGISTER(register_libcore_icu_NativeCollation);
-    REGISTER(register_libcore_icu_NativeConverter);
-    REGISTER(register_libcore_icu_NativeDecimalFormat);
-    REGISTER(register_libcore_icu_NativeIDN);
-    REGISTER(register_libcore_icu_NativeNormalizer);
-    REGISTER(register_libcore_icu_NativePluralRules);
-    REGISTER(register_libcore_icu_TimeZoneNames);
-    REGISTER(register_libcore_icu_Transliterator);
+    REGISTER(register_java_util_zip_Lz4Compressor);
+    REGISTER(register_java_util_zip_Lz4Decompressor);
+    REGISTER(register_java_util_zip_ZipStreamPool);
     REGISTER(register_libcore_io_AsynchronousCloseMonitor);
+    REGISTER(register_libcore_io_Base64);
+    REGISTER(register_libcore_io_EventPoller);
+    REGISTER(register_libcore_io_GroupCommit);
+    REGISTER(register_libcore_io_IoUring);
     REGISTER(register_libcore_io_Libcore);
     REGISTER(register_libcore_io_Memory);
+    REGISTER(register_libcore_io_NativeCounters);
     REGISTER(register_libcore_io_Posix);
     REGISTER(register_libcore_io_Windows);
     REGISTER(register_org_apache_harmony_dalvik_NativeTestTarget);
     REGISTER(register_org_apache_harmony_xml_ExpatParser);
+    REGISTER(register_org_json_JSONTokener);
     REGISTER(register_sun_misc_Unsafe);
 #undef REGISTER
 
+    jniRegisterNativeMethods(env, "libcore/util/NativeRegistration",
+            gNativeRegistrationMethods, NELEM(gNativeRegistrationMethods));
+#if !defined(LIBCORE_LAZY_REGISTRATION)
+    for (size_t i = 0; i < NELEM(gLazyRegistrations); ++i) {
+        registerLazily(env, gLazyRegistrations[i]);
+    }
+#endif
+
     return JNI_VERSION_1_6;
 }
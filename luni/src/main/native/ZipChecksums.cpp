@@ -0,0 +1,268 @@
+/*
+ * Copyright (C) 2014 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "ZipChecksums.h"
+
+#include <stdint.h>
+#include <string.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#define HAVE_X86_KERNELS 1
+#include <emmintrin.h>
+#include <smmintrin.h>
+#include <tmmintrin.h>
+#include <wmmintrin.h>
+#elif defined(__aarch64__) && defined(__ARM_FEATURE_CRC32)
+// The CRC32 instructions are optional in ARMv8.0, so we only use them when the compiler has been
+// told the target has them; there's no cheap portable way to ask at runtime.
+#define HAVE_ARM_CRC32 1
+#include <arm_acle.h>
+#endif
+
+// zlib's length arguments are uInt, so feed it large inputs in pieces.
+static uLong zlibCrc32(uLong crc, const Bytef* buf, size_t len) {
+    while (len > 0) {
+        uInt n = (len > 0x40000000) ? 0x40000000 : static_cast<uInt>(len);
+        crc = crc32(crc, buf, n);
+        buf += n;
+        len -= n;
+    }
+    return crc;
+}
+
+static uLong zlibAdler32(uLong adler, const Bytef* buf, size_t len) {
+    while (len > 0) {
+        uInt n = (len > 0x40000000) ? 0x40000000 : static_cast<uInt>(len);
+        adler = adler32(adler, buf, n);
+        buf += n;
+        len -= n;
+    }
+    return adler;
+}
+
+#if defined(HAVE_X86_KERNELS)
+
+static bool cpuHasPclmul() {
+    static const bool result = __builtin_cpu_supports("pclmul") && __builtin_cpu_supports("sse4.1");
+    return result;
+}
+
+static bool cpuHasSsse3() {
+    static const bool result = __builtin_cpu_supports("ssse3");
+    return result;
+}
+
+/*
+ * CRC-32 by folding 64 bytes at a time with carry-less multiplication, after Gopal et al.,
+ * "Fast CRC Computation for Generic Polynomials Using PCLMULQDQ Instruction" (Intel, 2009).
+ * The constants are the bit-reflected x^n mod P(x) values for the gzip polynomial given at the
+ * end of that paper. On entry and exit 'crc' is the raw (not inverted) register, len is at
+ * least 64 and a multiple of 16.
+ */
+__attribute__((target("sse4.1,pclmul")))
+static uint32_t crc32Pclmul(uint32_t crc, const uint8_t* buf, size_t len) {
+    static const uint64_t k1k2[] __attribute__((aligned(16))) = { 0x0154442bd4, 0x01c6e41596 };
+    static const uint64_t k3k4[] __attribute__((aligned(16))) = { 0x01751997d0, 0x00ccaa009e };
+    static const uint64_t k5k0[] __attribute__((aligned(16))) = { 0x0163cd6124, 0x0000000000 };
+    static const uint64_t poly[] __attribute__((aligned(16))) = { 0x01db710641, 0x01f7011641 };
+
+    __m128i x1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(buf + 0x00));
+    __m128i x2 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(buf + 0x10));
+    __m128i x3 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(buf + 0x20));
+    __m128i x4 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(buf + 0x30));
+    x1 = _mm_xor_si128(x1, _mm_cvtsi32_si128(crc));
+    __m128i x0 = _mm_load_si128(reinterpret_cast<const __m128i*>(k1k2));
+    buf += 64;
+    len -= 64;
+
+    // Fold four lanes in parallel while there are whole 64-byte blocks.
+    while (len >= 64) {
+        __m128i x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+        __m128i x6 = _mm_clmulepi64_si128(x2, x0, 0x00);
+        __m128i x7 = _mm_clmulepi64_si128(x3, x0, 0x00);
+        __m128i x8 = _mm_clmulepi64_si128(x4, x0, 0x00);
+        x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+        x2 = _mm_clmulepi64_si128(x2, x0, 0x11);
+        x3 = _mm_clmulepi64_si128(x3, x0, 0x11);
+        x4 = _mm_clmulepi64_si128(x4, x0, 0x11);
+        x1 = _mm_xor_si128(_mm_xor_si128(x1, x5),
+                _mm_loadu_si128(reinterpret_cast<const __m128i*>(buf + 0x00)));
+        x2 = _mm_xor_si128(_mm_xor_si128(x2, x6),
+                _mm_loadu_si128(reinterpret_cast<const __m128i*>(buf + 0x10)));
+        x3 = _mm_xor_si128(_mm_xor_si128(x3, x7),
+                _mm_loadu_si128(reinterpret_cast<const __m128i*>(buf + 0x20)));
+        x4 = _mm_xor_si128(_mm_xor_si128(x4, x8),
+                _mm_loadu_si128(reinterpret_cast<const __m128i*>(buf + 0x30)));
+        buf += 64;
+        len -= 64;
+    }
+
+    // Fold the four lanes into one.
+    x0 = _mm_load_si128(reinterpret_cast<const __m128i*>(k3k4));
+    __m128i x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+    x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+    x1 = _mm_xor_si128(_mm_xor_si128(x1, x2), x5);
+    x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+    x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+    x1 = _mm_xor_si128(_mm_xor_si128(x1, x3), x5);
+    x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+    x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+    x1 = _mm_xor_si128(_mm_xor_si128(x1, x4), x5);
+
+    // Fold in any remaining 16-byte blocks.
+    while (len >= 16) {
+        x2 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(buf));
+        x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+        x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+        x1 = _mm_xor_si128(_mm_xor_si128(x1, x2), x5);
+        buf += 16;
+        len -= 16;
+    }
+
+    // Fold 128 bits to 64.
+    x2 = _mm_clmulepi64_si128(x1, x0, 0x10);
+    x3 = _mm_setr_epi32(~0, 0, ~0, 0);
+    x1 = _mm_xor_si128(_mm_srli_si128(x1, 8), x2);
+    x0 = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(k5k0));
+    x2 = _mm_srli_si128(x1, 4);
+    x1 = _mm_and_si128(x1, x3);
+    x1 = _mm_clmulepi64_si128(x1, x0, 0x00);
+    x1 = _mm_xor_si128(x1, x2);
+
+    // Barrett reduction to 32 bits.
+    x0 = _mm_load_si128(reinterpret_cast<const __m128i*>(poly));
+    x2 = _mm_and_si128(x1, x3);
+    x2 = _mm_clmulepi64_si128(x2, x0, 0x10);
+    x2 = _mm_and_si128(x2, x3);
+    x2 = _mm_clmulepi64_si128(x2, x0, 0x00);
+    x1 = _mm_xor_si128(x1, x2);
+    return _mm_extract_epi32(x1, 1);
+}
+
+// The largest n such that 255n(n+1)/2 + (n+1)(BASE-1) fits in 32 bits, as in zlib's adler32.c.
+static const unsigned ADLER_NMAX = 5552;
+static const unsigned ADLER_BASE = 65521;
+
+/*
+ * Adler-32 over whole 32-byte blocks: s1 is a horizontal byte sum (psadbw), and s2's weighted
+ * sum uses multiply-add with the descending byte positions as taps. The s1 contribution to s2
+ * that accumulates between blocks is tracked in v_ps and added in once per NMAX run.
+ */
+__attribute__((target("ssse3")))
+static uLong adler32Ssse3(uLong adler, const uint8_t* buf, size_t blocks) {
+    const unsigned BLOCK_SIZE = 32;
+    uint32_t s1 = adler & 0xffff;
+    uint32_t s2 = adler >> 16;
+    const __m128i tap1 = _mm_setr_epi8(32, 31, 30, 29, 28, 27, 26, 25, 24, 23, 22, 21, 20, 19, 18, 17);
+    const __m128i tap2 = _mm_setr_epi8(16, 15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1);
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i ones = _mm_set1_epi16(1);
+
+    while (blocks > 0) {
+        unsigned n = ADLER_NMAX / BLOCK_SIZE;
+        if (n > blocks) {
+            n = blocks;
+        }
+        blocks -= n;
+
+        __m128i v_ps = _mm_set_epi32(0, 0, 0, s1 * n);
+        __m128i v_s2 = _mm_set_epi32(0, 0, 0, s2);
+        __m128i v_s1 = _mm_setzero_si128();
+        do {
+            const __m128i bytes1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(buf));
+            const __m128i bytes2 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(buf + 16));
+            v_ps = _mm_add_epi32(v_ps, v_s1);
+            v_s1 = _mm_add_epi32(v_s1, _mm_sad_epu8(bytes1, zero));
+            v_s2 = _mm_add_epi32(v_s2, _mm_madd_epi16(_mm_maddubs_epi16(bytes1, tap1), ones));
+            v_s1 = _mm_add_epi32(v_s1, _mm_sad_epu8(bytes2, zero));
+            v_s2 = _mm_add_epi32(v_s2, _mm_madd_epi16(_mm_maddubs_epi16(bytes2, tap2), ones));
+            buf += BLOCK_SIZE;
+        } while (--n);
+        v_s2 = _mm_add_epi32(v_s2, _mm_slli_epi32(v_ps, 5));
+
+        // Sum the 32-bit lanes.
+        v_s1 = _mm_add_epi32(v_s1, _mm_shuffle_epi32(v_s1, _MM_SHUFFLE(1, 0, 3, 2)));
+        s1 += _mm_cvtsi128_si32(v_s1);
+        v_s2 = _mm_add_epi32(v_s2, _mm_shuffle_epi32(v_s2, _MM_SHUFFLE(2, 3, 0, 1)));
+        v_s2 = _mm_add_epi32(v_s2, _mm_shuffle_epi32(v_s2, _MM_SHUFFLE(1, 0, 3, 2)));
+        s2 = _mm_cvtsi128_si32(v_s2);
+        s1 %= ADLER_BASE;
+        s2 %= ADLER_BASE;
+    }
+    return s1 | (s2 << 16);
+}
+
+#endif  // HAVE_X86_KERNELS
+
+#if defined(HAVE_ARM_CRC32)
+
+// The ARMv8 CRC32X instructions implement the gzip polynomial on the raw register directly.
+static uint32_t crc32Arm(uint32_t crc, const uint8_t* buf, size_t len) {
+    while (len > 0 && (reinterpret_cast<uintptr_t>(buf) & 7) != 0) {
+        crc = __crc32b(crc, *buf++);
+        --len;
+    }
+    while (len >= 32) {
+        uint64_t words[4];
+        memcpy(words, buf, sizeof(words));
+        crc = __crc32d(crc, words[0]);
+        crc = __crc32d(crc, words[1]);
+        crc = __crc32d(crc, words[2]);
+        crc = __crc32d(crc, words[3]);
+        buf += 32;
+        len -= 32;
+    }
+    while (len >= 8) {
+        uint64_t word;
+        memcpy(&word, buf, sizeof(word));
+        crc = __crc32d(crc, word);
+        buf += 8;
+        len -= 8;
+    }
+    while (len > 0) {
+        crc = __crc32b(crc, *buf++);
+        --len;
+    }
+    return crc;
+}
+
+#endif  // HAVE_ARM_CRC32
+
+uLong fastCrc32(uLong crc, const Bytef* buf, size_t len) {
+#if defined(HAVE_X86_KERNELS)
+    if (len >= 64 && cpuHasPclmul()) {
+        size_t chunk = len & ~static_cast<size_t>(15);
+        crc = ~crc32Pclmul(~static_cast<uint32_t>(crc), buf, chunk) & 0xffffffffUL;
+        buf += chunk;
+        len -= chunk;
+    }
+#elif defined(HAVE_ARM_CRC32)
+    return ~crc32Arm(~static_cast<uint32_t>(crc), buf, len) & 0xffffffffUL;
+#endif
+    return zlibCrc32(crc, buf, len);
+}
+
+uLong fastAdler32(uLong adler, const Bytef* buf, size_t len) {
+#if defined(HAVE_X86_KERNELS)
+    if (len >= 64 && cpuHasSsse3()) {
+        size_t blocks = len / 32;
+        adler = adler32Ssse3(adler, buf, blocks);
+        buf += blocks * 32;
+        len -= blocks * 32;
+    }
+#endif
+    return zlibAdler32(adler, buf, len);
+}
@@ -0,0 +1,33 @@
+/*
+ * Copyright (C) 2014 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ZIP_CHECKSUMS_H_included
+#define ZIP_CHECKSUMS_H_included
+
+#include <stddef.h>
+
+#include "zlib.h"
+
+/*
+ * Drop-in replacements for zlib's crc32(3) and adler32(3), taking and returning the same
+ * checksum values. They use carry-less multiplication (x86 PCLMULQDQ) or the ARMv8 CRC32
+ * instructions for CRC-32, and SSSE3 for Adler-32, where the CPU has them, and hand anything
+ * else (including short inputs and unaligned tails) to zlib.
+ */
+uLong fastCrc32(uLong crc, const Bytef* buf, size_t len);
+uLong fastAdler32(uLong adler, const Bytef* buf, size_t len);
+
+#endif  // ZIP_CHECKSUMS_H_included
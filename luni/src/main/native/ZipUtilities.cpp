@@ -15,11 +15,19 @@
  * limitations under the License.
  */
 
+#define LOG_TAG "ZipUtilities"
+
+#include "JNIHelp.h"
 #include "JniConstants.h"
 #include "JniException.h"
+#include "ScopedPthreadMutexLock.h"
 #include "UniquePtr.h"
 #include "ZipUtilities.h"
 
+#include <pthread.h>
+
+#include <vector>
+
 void throwExceptionForZlibError(JNIEnv* env, const char* exceptionClassName, int error,
     NativeZipStream* stream) {
   if (error == Z_MEM_ERROR) {
@@ -31,7 +39,7 @@ void throwExceptionForZlibError(JNIEnv* env, const char* exceptionClassName, int
   }
 }
 
-NativeZipStream::NativeZipStream() : input(NULL), inCap(0), mDict(NULL) {
+NativeZipStream::NativeZipStream() : input(NULL), inCap(0), poolKind(-1), mDict(NULL) {
   // Let zlib use its default allocator.
   stream.opaque = Z_NULL;
   stream.zalloc = Z_NULL;
@@ -78,6 +86,121 @@ void NativeZipStream::setInput(JNIEnv* env, jbyteArray buf, jint off, jint len)
   stream.avail_in = len;
 }
 
+void NativeZipStream::releaseDictionary() {
+  mDict.reset();
+}
+
+void NativeZipStream::setInput(jlong address, jint len) {
+  stream.next_in = reinterpret_cast<Bytef*>(static_cast<uintptr_t>(address));
+  stream.avail_in = len;
+}
+
 NativeZipStream* toNativeZipStream(jlong address) {
   return reinterpret_cast<NativeZipStream*>(static_cast<uintptr_t>(address));
 }
+
+// Each free list holds at most this many streams; 0 disables pooling.
+static size_t gZipStreamPoolCapacity = 4;
+static std::vector<NativeZipStream*> gZipStreamPool[POOL_KIND_COUNT];
+static jlong gZipStreamPoolHits = 0;
+static jlong gZipStreamPoolMisses = 0;
+static pthread_mutex_t gZipStreamPoolMutex = PTHREAD_MUTEX_INITIALIZER;
+
+static bool isInflateKind(int kind) {
+  return kind == POOL_INFLATE_ZLIB || kind == POOL_INFLATE_RAW;
+}
+
+static void endZipStream(NativeZipStream* stream) {
+  if (isInflateKind(stream->poolKind)) {
+    inflateEnd(&stream->stream);
+  } else {
+    deflateEnd(&stream->stream);
+  }
+  delete stream;
+}
+
+NativeZipStream* takePooledZipStream(int kind) {
+  ScopedPthreadMutexLock lock(&gZipStreamPoolMutex);
+  std::vector<NativeZipStream*>& freeList = gZipStreamPool[kind];
+  if (freeList.empty()) {
+    ++gZipStreamPoolMisses;
+    return NULL;
+  }
+  ++gZipStreamPoolHits;
+  NativeZipStream* stream = freeList.back();
+  freeList.pop_back();
+  return stream;
+}
+
+void releaseZipStream(NativeZipStream* stream) {
+  int kind = stream->poolKind;
+  if (kind < 0 || kind >= POOL_KIND_COUNT) {
+    endZipStream(stream);
+    return;
+  }
+  // Reset outside the lock: it's cheap, but not free.
+  int err = isInflateKind(kind) ? inflateReset(&stream->stream) : deflateReset(&stream->stream);
+  if (err != Z_OK) {
+    endZipStream(stream);
+    return;
+  }
+  // inflateReset leaves adler alone for raw streams; match a freshly created stream.
+  stream->stream.adler = 1;
+  stream->stream.next_in = NULL;
+  stream->stream.avail_in = 0;
+  stream->stream.next_out = NULL;
+  stream->stream.avail_out = 0;
+  stream->releaseDictionary();
+  {
+    ScopedPthreadMutexLock lock(&gZipStreamPoolMutex);
+    std::vector<NativeZipStream*>& freeList = gZipStreamPool[kind];
+    if (freeList.size() < gZipStreamPoolCapacity) {
+      freeList.push_back(stream);
+      return;
+    }
+  }
+  endZipStream(stream);
+}
+
+static void ZipStreamPool_setCapacityImpl(JNIEnv*, jclass, jint capacity) {
+  std::vector<NativeZipStream*> evicted;
+  {
+    ScopedPthreadMutexLock lock(&gZipStreamPoolMutex);
+    gZipStreamPoolCapacity = capacity;
+    for (int kind = 0; kind < POOL_KIND_COUNT; ++kind) {
+      std::vector<NativeZipStream*>& freeList = gZipStreamPool[kind];
+      while (freeList.size() > gZipStreamPoolCapacity) {
+        evicted.push_back(freeList.back());
+        freeList.pop_back();
+      }
+    }
+  }
+  for (size_t i = 0; i < evicted.size(); ++i) {
+    endZipStream(evicted[i]);
+  }
+}
+
+static jint ZipStreamPool_getCapacity(JNIEnv*, jclass) {
+  ScopedPthreadMutexLock lock(&gZipStreamPoolMutex);
+  return gZipStreamPoolCapacity;
+}
+
+static jlong ZipStreamPool_getHitCount(JNIEnv*, jclass) {
+  ScopedPthreadMutexLock lock(&gZipStreamPoolMutex);
+  return gZipStreamPoolHits;
+}
+
+static jlong ZipStreamPool_getMissCount(JNIEnv*, jclass) {
+  ScopedPthreadMutexLock lock(&gZipStreamPoolMutex);
+  return gZipStreamPoolMisses;
+}
+
+static JNINativeMethod gMethods[] = {
+  NATIVE_METHOD(ZipStreamPool, getCapacity, "()I"),
+  NATIVE_METHOD(ZipStreamPool, getHitCount, "()J"),
+  NATIVE_METHOD(ZipStreamPool, getMissCount, "()J"),
+  NATIVE_METHOD(ZipStreamPool, setCapacityImpl, "(I)V"),
+};
+void register_java_util_zip_ZipStreamPool(JNIEnv* env) {
+  jniRegisterNativeMethods(env, "java/util/zip/ZipStreamPool", gMethods, NELEM(gMethods));
+}
@@ -27,11 +27,16 @@ public:
     UniquePtr<jbyte[]> input;
     int inCap;
     z_stream stream;
+    // Which of the stream pool's free lists this stream can be returned to, or -1 if none.
+    int poolKind;
 
     NativeZipStream();
     ~NativeZipStream();
     void setDictionary(JNIEnv* env, jbyteArray javaDictionary, int off, int len, bool inflate);
     void setInput(JNIEnv* env, jbyteArray buf, jint off, jint len);
+    // Points zlib straight at caller-owned memory, which must stay valid until it is consumed.
+    void setInput(jlong address, jint len);
+    void releaseDictionary();
 
 private:
     UniquePtr<jbyte[]> mDict;
@@ -46,4 +51,25 @@ NativeZipStream* toNativeZipStream(jlong address);
 void throwExceptionForZlibError(JNIEnv* env, const char* exceptionClassName, int error,
         NativeZipStream* stream);
 
+/*
+ * A process-wide cache of ended streams. inflateInit2 and deflateInit2 allocate and initialize
+ * tens or hundreds of KiB of zlib state, which dominates the cost of a short-lived stream, so
+ * the end of one stream hands its state (reset with inflateReset/deflateReset) to the next
+ * stream of the same kind. A stream's kind is everything set at init time that reset keeps.
+ */
+enum ZipStreamPoolKind {
+    POOL_INFLATE_ZLIB,
+    POOL_INFLATE_RAW,
+    POOL_DEFLATE_ZLIB,
+    POOL_DEFLATE_RAW,
+    POOL_KIND_COUNT,
+};
+
+// Returns a reset stream of the given kind, or NULL if there are none cached.
+NativeZipStream* takePooledZipStream(int kind);
+
+// Resets 'stream' and caches it for reuse, or ends and deletes it if its kind's free list is
+// full or it can't be reset. 'stream' must not be used afterwards.
+void releaseZipStream(NativeZipStream* stream);
+
 #endif  // ZIP_UTILITIES_H_included
@@ -19,11 +19,13 @@
 #include "JNIHelp.h"
 #include "JniConstants.h"
 #include "Portability.h"
+#include "ScopedLocalRef.h"
 
 #include <errno.h>
 #include <fcntl.h>
 #include <signal.h>
 #include <stdlib.h>
+#include <string.h>
 #include <sys/stat.h>
 #include <unistd.h>
 
@@ -67,578 +69,827 @@
 #include <linux/capability.h>
 #endif
 
-static void initConstant(JNIEnv* env, jclass c, const char* fieldName, int value) {
-    jfieldID field = env->GetStaticFieldID(c, fieldName, "I");
-    env->SetStaticIntField(c, field, value);
-}
+// Every constant in OsConstants, in the order the Java fields are declared. Constants missing
+// from this platform's headers are 0, which is what the Java fields have always been then.
+// Keeping the values in a compile-time table means initializing OsConstants costs one JNI
+// call, rather than a field lookup and store for each of hundreds of constants.
+struct OsConstant {
+    const char* name;
+    int value;
+};
+
+#define OS_CONSTANT(name) { #name, name }
+#define MISSING_OS_CONSTANT(name) { #name, 0 }
 
-static void OsConstants_initConstants(JNIEnv* env, jclass c) {
-    initConstant(env, c, "AF_INET", AF_INET);
-    initConstant(env, c, "AF_INET6", AF_INET6);
-    initConstant(env, c, "AF_UNIX", AF_UNIX);
-    initConstant(env, c, "AF_UNSPEC", AF_UNSPEC);
-    initConstant(env, c, "AI_ADDRCONFIG", AI_ADDRCONFIG);
-    initConstant(env, c, "AI_ALL", AI_ALL);
-    initConstant(env, c, "AI_CANONNAME", AI_CANONNAME);
-    initConstant(env, c, "AI_NUMERICHOST", AI_NUMERICHOST);
+static constexpr OsConstant gConstants[] = {
+    OS_CONSTANT(AF_INET),
+    OS_CONSTANT(AF_INET6),
+    OS_CONSTANT(AF_UNIX),
+    OS_CONSTANT(AF_UNSPEC),
+    OS_CONSTANT(AI_ADDRCONFIG),
+    OS_CONSTANT(AI_ALL),
+    OS_CONSTANT(AI_CANONNAME),
+    OS_CONSTANT(AI_NUMERICHOST),
 #if defined(AI_NUMERICSERV)
-    initConstant(env, c, "AI_NUMERICSERV", AI_NUMERICSERV);
+    OS_CONSTANT(AI_NUMERICSERV),
+#else
+    MISSING_OS_CONSTANT(AI_NUMERICSERV),
 #endif
-    initConstant(env, c, "AI_PASSIVE", AI_PASSIVE);
-    initConstant(env, c, "AI_V4MAPPED", AI_V4MAPPED);
+    OS_CONSTANT(AI_PASSIVE),
+    OS_CONSTANT(AI_V4MAPPED),
 #if defined(CAP_LAST_CAP)
-    initConstant(env, c, "CAP_AUDIT_CONTROL", CAP_AUDIT_CONTROL);
-    initConstant(env, c, "CAP_AUDIT_WRITE", CAP_AUDIT_WRITE);
-    initConstant(env, c, "CAP_BLOCK_SUSPEND", CAP_BLOCK_SUSPEND);
-    initConstant(env, c, "CAP_CHOWN", CAP_CHOWN);
-    initConstant(env, c, "CAP_DAC_OVERRIDE", CAP_DAC_OVERRIDE);
-    initConstant(env, c, "CAP_DAC_READ_SEARCH", CAP_DAC_READ_SEARCH);
-    initConstant(env, c, "CAP_FOWNER", CAP_FOWNER);
-    initConstant(env, c, "CAP_FSETID", CAP_FSETID);
-    initConstant(env, c, "CAP_IPC_LOCK", CAP_IPC_LOCK);
-    initConstant(env, c, "CAP_IPC_OWNER", CAP_IPC_OWNER);
-    initConstant(env, c, "CAP_KILL", CAP_KILL);
-    initConstant(env, c, "CAP_LAST_CAP", CAP_LAST_CAP);
-    initConstant(env, c, "CAP_LEASE", CAP_LEASE);
-    initConstant(env, c, "CAP_LINUX_IMMUTABLE", CAP_LINUX_IMMUTABLE);
-    initConstant(env, c, "CAP_MAC_ADMIN", CAP_MAC_ADMIN);
-    initConstant(env, c, "CAP_MAC_OVERRIDE", CAP_MAC_OVERRIDE);
-    initConstant(env, c, "CAP_MKNOD", CAP_MKNOD);
-    initConstant(env, c, "CAP_NET_ADMIN", CAP_NET_ADMIN);
-    initConstant(env, c, "CAP_NET_BIND_SERVICE", CAP_NET_BIND_SERVICE);
-    initConstant(env, c, "CAP_NET_BROADCAST", CAP_NET_BROADCAST);
-    initConstant(env, c, "CAP_NET_RAW", CAP_NET_RAW);
-    initConstant(env, c, "CAP_SETFCAP", CAP_SETFCAP);
-    initConstant(env, c, "CAP_SETGID", CAP_SETGID);
-    initConstant(env, c, "CAP_SETPCAP", CAP_SETPCAP);
-    initConstant(env, c, "CAP_SETUID", CAP_SETUID);
-    initConstant(env, c, "CAP_SYS_ADMIN", CAP_SYS_ADMIN);
-    initConstant(env, c, "CAP_SYS_BOOT", CAP_SYS_BOOT);
-    initConstant(env, c, "CAP_SYS_CHROOT", CAP_SYS_CHROOT);
-    initConstant(env, c, "CAP_SYSLOG", CAP_SYSLOG);
-    initConstant(env, c, "CAP_SYS_MODULE", CAP_SYS_MODULE);
-    initConstant(env, c, "CAP_SYS_NICE", CAP_SYS_NICE);
-    initConstant(env, c, "CAP_SYS_PACCT", CAP_SYS_PACCT);
-    initConstant(env, c, "CAP_SYS_PTRACE", CAP_SYS_PTRACE);
-    initConstant(env, c, "CAP_SYS_RAWIO", CAP_SYS_RAWIO);
-    initConstant(env, c, "CAP_SYS_RESOURCE", CAP_SYS_RESOURCE);
-    initConstant(env, c, "CAP_SYS_TIME", CAP_SYS_TIME);
-    initConstant(env, c, "CAP_SYS_TTY_CONFIG", CAP_SYS_TTY_CONFIG);
-    initConstant(env, c, "CAP_WAKE_ALARM", CAP_WAKE_ALARM);
-#endif
-    initConstant(env, c, "E2BIG", E2BIG);
-    initConstant(env, c, "EACCES", EACCES);
-    initConstant(env, c, "EADDRINUSE", EADDRINUSE);
-    initConstant(env, c, "EADDRNOTAVAIL", EADDRNOTAVAIL);
-    initConstant(env, c, "EAFNOSUPPORT", EAFNOSUPPORT);
-    initConstant(env, c, "EAGAIN", EAGAIN);
-    initConstant(env, c, "EAI_AGAIN", EAI_AGAIN);
-    initConstant(env, c, "EAI_BADFLAGS", EAI_BADFLAGS);
-    initConstant(env, c, "EAI_FAIL", EAI_FAIL);
-    initConstant(env, c, "EAI_FAMILY", EAI_FAMILY);
-    initConstant(env, c, "EAI_MEMORY", EAI_MEMORY);
-    initConstant(env, c, "EAI_NODATA", EAI_NODATA);
-    initConstant(env, c, "EAI_NONAME", EAI_NONAME);
+    OS_CONSTANT(CAP_AUDIT_CONTROL),
+    OS_CONSTANT(CAP_AUDIT_WRITE),
+    OS_CONSTANT(CAP_BLOCK_SUSPEND),
+    OS_CONSTANT(CAP_CHOWN),
+    OS_CONSTANT(CAP_DAC_OVERRIDE),
+    OS_CONSTANT(CAP_DAC_READ_SEARCH),
+    OS_CONSTANT(CAP_FOWNER),
+    OS_CONSTANT(CAP_FSETID),
+    OS_CONSTANT(CAP_IPC_LOCK),
+    OS_CONSTANT(CAP_IPC_OWNER),
+    OS_CONSTANT(CAP_KILL),
+    OS_CONSTANT(CAP_LAST_CAP),
+    OS_CONSTANT(CAP_LEASE),
+    OS_CONSTANT(CAP_LINUX_IMMUTABLE),
+    OS_CONSTANT(CAP_MAC_ADMIN),
+    OS_CONSTANT(CAP_MAC_OVERRIDE),
+    OS_CONSTANT(CAP_MKNOD),
+    OS_CONSTANT(CAP_NET_ADMIN),
+    OS_CONSTANT(CAP_NET_BIND_SERVICE),
+    OS_CONSTANT(CAP_NET_BROADCAST),
+    OS_CONSTANT(CAP_NET_RAW),
+    OS_CONSTANT(CAP_SETFCAP),
+    OS_CONSTANT(CAP_SETGID),
+    OS_CONSTANT(CAP_SETPCAP),
+    OS_CONSTANT(CAP_SETUID),
+    OS_CONSTANT(CAP_SYS_ADMIN),
+    OS_CONSTANT(CAP_SYS_BOOT),
+    OS_CONSTANT(CAP_SYS_CHROOT),
+    OS_CONSTANT(CAP_SYSLOG),
+    OS_CONSTANT(CAP_SYS_MODULE),
+    OS_CONSTANT(CAP_SYS_NICE),
+    OS_CONSTANT(CAP_SYS_PACCT),
+    OS_CONSTANT(CAP_SYS_PTRACE),
+    OS_CONSTANT(CAP_SYS_RAWIO),
+    OS_CONSTANT(CAP_SYS_RESOURCE),
+    OS_CONSTANT(CAP_SYS_TIME),
+    OS_CONSTANT(CAP_SYS_TTY_CONFIG),
+    OS_CONSTANT(CAP_WAKE_ALARM),
+#else
+    MISSING_OS_CONSTANT(CAP_AUDIT_CONTROL),
+    MISSING_OS_CONSTANT(CAP_AUDIT_WRITE),
+    MISSING_OS_CONSTANT(CAP_BLOCK_SUSPEND),
+    MISSING_OS_CONSTANT(CAP_CHOWN),
+    MISSING_OS_CONSTANT(CAP_DAC_OVERRIDE),
+    MISSING_OS_CONSTANT(CAP_DAC_READ_SEARCH),
+    MISSING_OS_CONSTANT(CAP_FOWNER),
+    MISSING_OS_CONSTANT(CAP_FSETID),
+    MISSING_OS_CONSTANT(CAP_IPC_LOCK),
+    MISSING_OS_CONSTANT(CAP_IPC_OWNER),
+    MISSING_OS_CONSTANT(CAP_KILL),
+    MISSING_OS_CONSTANT(CAP_LAST_CAP),
+    MISSING_OS_CONSTANT(CAP_LEASE),
+    MISSING_OS_CONSTANT(CAP_LINUX_IMMUTABLE),
+    MISSING_OS_CONSTANT(CAP_MAC_ADMIN),
+    MISSING_OS_CONSTANT(CAP_MAC_OVERRIDE),
+    MISSING_OS_CONSTANT(CAP_MKNOD),
+    MISSING_OS_CONSTANT(CAP_NET_ADMIN),
+    MISSING_OS_CONSTANT(CAP_NET_BIND_SERVICE),
+    MISSING_OS_CONSTANT(CAP_NET_BROADCAST),
+    MISSING_OS_CONSTANT(CAP_NET_RAW),
+    MISSING_OS_CONSTANT(CAP_SETFCAP),
+    MISSING_OS_CONSTANT(CAP_SETGID),
+    MISSING_OS_CONSTANT(CAP_SETPCAP),
+    MISSING_OS_CONSTANT(CAP_SETUID),
+    MISSING_OS_CONSTANT(CAP_SYS_ADMIN),
+    MISSING_OS_CONSTANT(CAP_SYS_BOOT),
+    MISSING_OS_CONSTANT(CAP_SYS_CHROOT),
+    MISSING_OS_CONSTANT(CAP_SYSLOG),
+    MISSING_OS_CONSTANT(CAP_SYS_MODULE),
+    MISSING_OS_CONSTANT(CAP_SYS_NICE),
+    MISSING_OS_CONSTANT(CAP_SYS_PACCT),
+    MISSING_OS_CONSTANT(CAP_SYS_PTRACE),
+    MISSING_OS_CONSTANT(CAP_SYS_RAWIO),
+    MISSING_OS_CONSTANT(CAP_SYS_RESOURCE),
+    MISSING_OS_CONSTANT(CAP_SYS_TIME),
+    MISSING_OS_CONSTANT(CAP_SYS_TTY_CONFIG),
+    MISSING_OS_CONSTANT(CAP_WAKE_ALARM),
+#endif
+    OS_CONSTANT(E2BIG),
+    OS_CONSTANT(EACCES),
+    OS_CONSTANT(EADDRINUSE),
+    OS_CONSTANT(EADDRNOTAVAIL),
+    OS_CONSTANT(EAFNOSUPPORT),
+    OS_CONSTANT(EAGAIN),
+    OS_CONSTANT(EAI_AGAIN),
+    OS_CONSTANT(EAI_BADFLAGS),
+    OS_CONSTANT(EAI_FAIL),
+    OS_CONSTANT(EAI_FAMILY),
+    OS_CONSTANT(EAI_MEMORY),
+    OS_CONSTANT(EAI_NODATA),
+    OS_CONSTANT(EAI_NONAME),
 #if defined(EAI_OVERFLOW)
-    initConstant(env, c, "EAI_OVERFLOW", EAI_OVERFLOW);
-#endif
-    initConstant(env, c, "EAI_SERVICE", EAI_SERVICE);
-    initConstant(env, c, "EAI_SOCKTYPE", EAI_SOCKTYPE);
-    initConstant(env, c, "EAI_SYSTEM", EAI_SYSTEM);
-    initConstant(env, c, "EALREADY", EALREADY);
-    initConstant(env, c, "EBADF", EBADF);
-    initConstant(env, c, "EBADMSG", EBADMSG);
-    initConstant(env, c, "EBUSY", EBUSY);
-    initConstant(env, c, "ECANCELED", ECANCELED);
-    initConstant(env, c, "ECHILD", ECHILD);
-    initConstant(env, c, "ECONNABORTED", ECONNABORTED);
-    initConstant(env, c, "ECONNREFUSED", ECONNREFUSED);
-    initConstant(env, c, "ECONNRESET", ECONNRESET);
-    initConstant(env, c, "EDEADLK", EDEADLK);
-    initConstant(env, c, "EDESTADDRREQ", EDESTADDRREQ);
-    initConstant(env, c, "EDOM", EDOM);
-    initConstant(env, c, "EDQUOT", EDQUOT);
-    initConstant(env, c, "EEXIST", EEXIST);
-    initConstant(env, c, "EFAULT", EFAULT);
-    initConstant(env, c, "EFBIG", EFBIG);
-    initConstant(env, c, "EHOSTUNREACH", EHOSTUNREACH);
-    initConstant(env, c, "EIDRM", EIDRM);
-    initConstant(env, c, "EILSEQ", EILSEQ);
-    initConstant(env, c, "EINPROGRESS", EINPROGRESS);
-    initConstant(env, c, "EINTR", EINTR);
-    initConstant(env, c, "EINVAL", EINVAL);
-    initConstant(env, c, "EIO", EIO);
-    initConstant(env, c, "EISCONN", EISCONN);
-    initConstant(env, c, "EISDIR", EISDIR);
-    initConstant(env, c, "ELOOP", ELOOP);
-    initConstant(env, c, "EMFILE", EMFILE);
-    initConstant(env, c, "EMLINK", EMLINK);
-    initConstant(env, c, "EMSGSIZE", EMSGSIZE);
-    initConstant(env, c, "EMULTIHOP", EMULTIHOP);
-    initConstant(env, c, "ENAMETOOLONG", ENAMETOOLONG);
-    initConstant(env, c, "ENETDOWN", ENETDOWN);
-    initConstant(env, c, "ENETRESET", ENETRESET);
-    initConstant(env, c, "ENETUNREACH", ENETUNREACH);
-    initConstant(env, c, "ENFILE", ENFILE);
-    initConstant(env, c, "ENOBUFS", ENOBUFS);
-    initConstant(env, c, "ENODATA", ENODATA);
-    initConstant(env, c, "ENODEV", ENODEV);
-    initConstant(env, c, "ENOENT", ENOENT);
-    initConstant(env, c, "ENOEXEC", ENOEXEC);
-    initConstant(env, c, "ENOLCK", ENOLCK);
-    initConstant(env, c, "ENOLINK", ENOLINK);
-    initConstant(env, c, "ENOMEM", ENOMEM);
-    initConstant(env, c, "ENOMSG", ENOMSG);
-    initConstant(env, c, "ENOPROTOOPT", ENOPROTOOPT);
-    initConstant(env, c, "ENOSPC", ENOSPC);
-    initConstant(env, c, "ENOSR", ENOSR);
-    initConstant(env, c, "ENOSTR", ENOSTR);
-    initConstant(env, c, "ENOSYS", ENOSYS);
-    initConstant(env, c, "ENOTCONN", ENOTCONN);
-    initConstant(env, c, "ENOTDIR", ENOTDIR);
-    initConstant(env, c, "ENOTEMPTY", ENOTEMPTY);
-    initConstant(env, c, "ENOTSOCK", ENOTSOCK);
-    initConstant(env, c, "ENOTSUP", ENOTSUP);
-    initConstant(env, c, "ENOTTY", ENOTTY);
-    initConstant(env, c, "ENXIO", ENXIO);
-    initConstant(env, c, "EOPNOTSUPP", EOPNOTSUPP);
-    initConstant(env, c, "EOVERFLOW", EOVERFLOW);
-    initConstant(env, c, "EPERM", EPERM);
-    initConstant(env, c, "EPIPE", EPIPE);
-    initConstant(env, c, "EPROTO", EPROTO);
-    initConstant(env, c, "EPROTONOSUPPORT", EPROTONOSUPPORT);
-    initConstant(env, c, "EPROTOTYPE", EPROTOTYPE);
-    initConstant(env, c, "ERANGE", ERANGE);
-    initConstant(env, c, "EROFS", EROFS);
-    initConstant(env, c, "ESPIPE", ESPIPE);
-    initConstant(env, c, "ESRCH", ESRCH);
-    initConstant(env, c, "ESTALE", ESTALE);
-    initConstant(env, c, "ETIME", ETIME);
-    initConstant(env, c, "ETIMEDOUT", ETIMEDOUT);
-    initConstant(env, c, "ETXTBSY", ETXTBSY);
+    OS_CONSTANT(EAI_OVERFLOW),
+#else
+    MISSING_OS_CONSTANT(EAI_OVERFLOW),
+#endif
+    OS_CONSTANT(EAI_SERVICE),
+    OS_CONSTANT(EAI_SOCKTYPE),
+    OS_CONSTANT(EAI_SYSTEM),
+    OS_CONSTANT(EALREADY),
+    OS_CONSTANT(EBADF),
+    OS_CONSTANT(EBADMSG),
+    OS_CONSTANT(EBUSY),
+    OS_CONSTANT(ECANCELED),
+    OS_CONSTANT(ECHILD),
+    OS_CONSTANT(ECONNABORTED),
+    OS_CONSTANT(ECONNREFUSED),
+    OS_CONSTANT(ECONNRESET),
+    OS_CONSTANT(EDEADLK),
+    OS_CONSTANT(EDESTADDRREQ),
+    OS_CONSTANT(EDOM),
+    OS_CONSTANT(EDQUOT),
+    OS_CONSTANT(EEXIST),
+    OS_CONSTANT(EFAULT),
+    OS_CONSTANT(EFBIG),
+    OS_CONSTANT(EHOSTUNREACH),
+    OS_CONSTANT(EIDRM),
+    OS_CONSTANT(EILSEQ),
+    OS_CONSTANT(EINPROGRESS),
+    OS_CONSTANT(EINTR),
+    OS_CONSTANT(EINVAL),
+    OS_CONSTANT(EIO),
+    OS_CONSTANT(EISCONN),
+    OS_CONSTANT(EISDIR),
+    OS_CONSTANT(ELOOP),
+    OS_CONSTANT(EMFILE),
+    OS_CONSTANT(EMLINK),
+    OS_CONSTANT(EMSGSIZE),
+    OS_CONSTANT(EMULTIHOP),
+    OS_CONSTANT(ENAMETOOLONG),
+    OS_CONSTANT(ENETDOWN),
+    OS_CONSTANT(ENETRESET),
+    OS_CONSTANT(ENETUNREACH),
+    OS_CONSTANT(ENFILE),
+    OS_CONSTANT(ENOBUFS),
+    OS_CONSTANT(ENODATA),
+    OS_CONSTANT(ENODEV),
+    OS_CONSTANT(ENOENT),
+    OS_CONSTANT(ENOEXEC),
+    OS_CONSTANT(ENOLCK),
+    OS_CONSTANT(ENOLINK),
+    OS_CONSTANT(ENOMEM),
+    OS_CONSTANT(ENOMSG),
+    OS_CONSTANT(ENOPROTOOPT),
+    OS_CONSTANT(ENOSPC),
+    OS_CONSTANT(ENOSR),
+    OS_CONSTANT(ENOSTR),
+    OS_CONSTANT(ENOSYS),
+    OS_CONSTANT(ENOTCONN),
+    OS_CONSTANT(ENOTDIR),
+    OS_CONSTANT(ENOTEMPTY),
+    OS_CONSTANT(ENOTSOCK),
+    OS_CONSTANT(ENOTSUP),
+    OS_CONSTANT(ENOTTY),
+    OS_CONSTANT(ENXIO),
+    OS_CONSTANT(EOPNOTSUPP),
+    OS_CONSTANT(EOVERFLOW),
+    OS_CONSTANT(EPERM),
+    OS_CONSTANT(EPIPE),
+    OS_CONSTANT(EPROTO),
+    OS_CONSTANT(EPROTONOSUPPORT),
+    OS_CONSTANT(EPROTOTYPE),
+    OS_CONSTANT(ERANGE),
+    OS_CONSTANT(EROFS),
+    OS_CONSTANT(ESPIPE),
+    OS_CONSTANT(ESRCH),
+    OS_CONSTANT(ESTALE),
+    OS_CONSTANT(ETIME),
+    OS_CONSTANT(ETIMEDOUT),
+    OS_CONSTANT(ETXTBSY),
 #if EWOULDBLOCK != EAGAIN
 #error EWOULDBLOCK != EAGAIN
 #endif
-    initConstant(env, c, "EXDEV", EXDEV);
-    initConstant(env, c, "EXIT_FAILURE", EXIT_FAILURE);
-    initConstant(env, c, "EXIT_SUCCESS", EXIT_SUCCESS);
-    initConstant(env, c, "FD_CLOEXEC", FD_CLOEXEC);
-    initConstant(env, c, "FIONREAD", FIONREAD);
-    initConstant(env, c, "F_DUPFD", F_DUPFD);
-    initConstant(env, c, "F_GETFD", F_GETFD);
-    initConstant(env, c, "F_GETFL", F_GETFL);
-    initConstant(env, c, "F_GETLK", F_GETLK);
+    OS_CONSTANT(EXDEV),
+    OS_CONSTANT(EXIT_FAILURE),
+    OS_CONSTANT(EXIT_SUCCESS),
+    OS_CONSTANT(FD_CLOEXEC),
+    OS_CONSTANT(FIONREAD),
+    OS_CONSTANT(F_DUPFD),
+    OS_CONSTANT(F_GETFD),
+    OS_CONSTANT(F_GETFL),
+    OS_CONSTANT(F_GETLK),
 #if defined(F_GETLK64)
-    initConstant(env, c, "F_GETLK64", F_GETLK64);
-#endif
-    initConstant(env, c, "F_GETOWN", F_GETOWN);
-    initConstant(env, c, "F_OK", F_OK);
-    initConstant(env, c, "F_RDLCK", F_RDLCK);
-    initConstant(env, c, "F_SETFD", F_SETFD);
-    initConstant(env, c, "F_SETFL", F_SETFL);
-    initConstant(env, c, "F_SETLK", F_SETLK);
+    OS_CONSTANT(F_GETLK64),
+#else
+    MISSING_OS_CONSTANT(F_GETLK64),
+#endif
+    OS_CONSTANT(F_GETOWN),
+    OS_CONSTANT(F_OK),
+    OS_CONSTANT(F_RDLCK),
+    OS_CONSTANT(F_SETFD),
+    OS_CONSTANT(F_SETFL),
+    OS_CONSTANT(F_SETLK),
 #if defined(F_SETLK64)
-    initConstant(env, c, "F_SETLK64", F_SETLK64);
+    OS_CONSTANT(F_SETLK64),
+#else
+    MISSING_OS_CONSTANT(F_SETLK64),
 #endif
-    initConstant(env, c, "F_SETLKW", F_SETLKW);
+    OS_CONSTANT(F_SETLKW),
 #if defined(F_SETLKW64)
-    initConstant(env, c, "F_SETLKW64", F_SETLKW64);
+    OS_CONSTANT(F_SETLKW64),
+#else
+    MISSING_OS_CONSTANT(F_SETLKW64),
 #endif
-    initConstant(env, c, "F_SETOWN", F_SETOWN);
-    initConstant(env, c, "F_UNLCK", F_UNLCK);
-    initConstant(env, c, "F_WRLCK", F_WRLCK);
+    OS_CONSTANT(F_SETOWN),
+    OS_CONSTANT(F_UNLCK),
+    OS_CONSTANT(F_WRLCK),
 #if defined(IFA_F_DADFAILED)
-    initConstant(env, c, "IFA_F_DADFAILED", IFA_F_DADFAILED);
+    OS_CONSTANT(IFA_F_DADFAILED),
+#else
+    MISSING_OS_CONSTANT(IFA_F_DADFAILED),
 #endif
 #if defined(IFA_F_DEPRECATED)
-    initConstant(env, c, "IFA_F_DEPRECATED", IFA_F_DEPRECATED);
+    OS_CONSTANT(IFA_F_DEPRECATED),
+#else
+    MISSING_OS_CONSTANT(IFA_F_DEPRECATED),
 #endif
 #if defined(IFA_F_HOMEADDRESS)
-    initConstant(env, c, "IFA_F_HOMEADDRESS", IFA_F_HOMEADDRESS);
+    OS_CONSTANT(IFA_F_HOMEADDRESS),
+#else
+    MISSING_OS_CONSTANT(IFA_F_HOMEADDRESS),
 #endif
 #if defined(IFA_F_NODAD)
-    initConstant(env, c, "IFA_F_NODAD", IFA_F_NODAD);
+    OS_CONSTANT(IFA_F_NODAD),
+#else
+    MISSING_OS_CONSTANT(IFA_F_NODAD),
 #endif
 #if defined(IFA_F_OPTIMISTIC)
-    initConstant(env, c, "IFA_F_OPTIMISTIC", IFA_F_OPTIMISTIC);
+    OS_CONSTANT(IFA_F_OPTIMISTIC),
+#else
+    MISSING_OS_CONSTANT(IFA_F_OPTIMISTIC),
 #endif
 #if defined(IFA_F_PERMANENT)
-    initConstant(env, c, "IFA_F_PERMANENT", IFA_F_PERMANENT);
+    OS_CONSTANT(IFA_F_PERMANENT),
+#else
+    MISSING_OS_CONSTANT(IFA_F_PERMANENT),
 #endif
 #if defined(IFA_F_SECONDARY)
-    initConstant(env, c, "IFA_F_SECONDARY", IFA_F_SECONDARY);
+    OS_CONSTANT(IFA_F_SECONDARY),
+#else
+    MISSING_OS_CONSTANT(IFA_F_SECONDARY),
 #endif
 #if defined(IFA_F_TEMPORARY)
-    initConstant(env, c, "IFA_F_TEMPORARY", IFA_F_TEMPORARY);
+    OS_CONSTANT(IFA_F_TEMPORARY),
+#else
+    MISSING_OS_CONSTANT(IFA_F_TEMPORARY),
 #endif
 #if defined(IFA_F_TENTATIVE)
-    initConstant(env, c, "IFA_F_TENTATIVE", IFA_F_TENTATIVE);
+    OS_CONSTANT(IFA_F_TENTATIVE),
+#else
+    MISSING_OS_CONSTANT(IFA_F_TENTATIVE),
 #endif
-    initConstant(env, c, "IFF_ALLMULTI", IFF_ALLMULTI);
+    OS_CONSTANT(IFF_ALLMULTI),
 #if defined(IFF_AUTOMEDIA)
-    initConstant(env, c, "IFF_AUTOMEDIA", IFF_AUTOMEDIA);
+    OS_CONSTANT(IFF_AUTOMEDIA),
+#else
+    MISSING_OS_CONSTANT(IFF_AUTOMEDIA),
 #endif
-    initConstant(env, c, "IFF_BROADCAST", IFF_BROADCAST);
-    initConstant(env, c, "IFF_DEBUG", IFF_DEBUG);
+    OS_CONSTANT(IFF_BROADCAST),
+    OS_CONSTANT(IFF_DEBUG),
 #if defined(IFF_DYNAMIC)
-    initConstant(env, c, "IFF_DYNAMIC", IFF_DYNAMIC);
+    OS_CONSTANT(IFF_DYNAMIC),
+#else
+    MISSING_OS_CONSTANT(IFF_DYNAMIC),
 #endif
-    initConstant(env, c, "IFF_LOOPBACK", IFF_LOOPBACK);
+    OS_CONSTANT(IFF_LOOPBACK),
 #if defined(IFF_MASTER)
-    initConstant(env, c, "IFF_MASTER", IFF_MASTER);
+    OS_CONSTANT(IFF_MASTER),
+#else
+    MISSING_OS_CONSTANT(IFF_MASTER),
 #endif
-    initConstant(env, c, "IFF_MULTICAST", IFF_MULTICAST);
-    initConstant(env, c, "IFF_NOARP", IFF_NOARP);
-    initConstant(env, c, "IFF_NOTRAILERS", IFF_NOTRAILERS);
-    initConstant(env, c, "IFF_POINTOPOINT", IFF_POINTOPOINT);
+    OS_CONSTANT(IFF_MULTICAST),
+    OS_CONSTANT(IFF_NOARP),
+    OS_CONSTANT(IFF_NOTRAILERS),
+    OS_CONSTANT(IFF_POINTOPOINT),
 #if defined(IFF_PORTSEL)
-    initConstant(env, c, "IFF_PORTSEL", IFF_PORTSEL);
+    OS_CONSTANT(IFF_PORTSEL),
+#else
+    MISSING_OS_CONSTANT(IFF_PORTSEL),
 #endif
-    initConstant(env, c, "IFF_PROMISC", IFF_PROMISC);
-    initConstant(env, c, "IFF_RUNNING", IFF_RUNNING);
+    OS_CONSTANT(IFF_PROMISC),
+    OS_CONSTANT(IFF_RUNNING),
 #if defined(IFF_SLAVE)
-    initConstant(env, c, "IFF_SLAVE", IFF_SLAVE);
-#endif
-    initConstant(env, c, "IFF_UP", IFF_UP);
-    initConstant(env, c, "IPPROTO_ICMP", IPPROTO_ICMP);
-    initConstant(env, c, "IPPROTO_ICMPV6", IPPROTO_ICMPV6);
-    initConstant(env, c, "IPPROTO_IP", IPPROTO_IP);
-    initConstant(env, c, "IPPROTO_IPV6", IPPROTO_IPV6);
-    initConstant(env, c, "IPPROTO_RAW", IPPROTO_RAW);
-    initConstant(env, c, "IPPROTO_TCP", IPPROTO_TCP);
-    initConstant(env, c, "IPPROTO_UDP", IPPROTO_UDP);
-    initConstant(env, c, "IPV6_CHECKSUM", IPV6_CHECKSUM);
-    initConstant(env, c, "IPV6_MULTICAST_HOPS", IPV6_MULTICAST_HOPS);
-    initConstant(env, c, "IPV6_MULTICAST_IF", IPV6_MULTICAST_IF);
-    initConstant(env, c, "IPV6_MULTICAST_LOOP", IPV6_MULTICAST_LOOP);
+    OS_CONSTANT(IFF_SLAVE),
+#else
+    MISSING_OS_CONSTANT(IFF_SLAVE),
+#endif
+    OS_CONSTANT(IFF_UP),
+    OS_CONSTANT(IPPROTO_ICMP),
+    OS_CONSTANT(IPPROTO_ICMPV6),
+    OS_CONSTANT(IPPROTO_IP),
+    OS_CONSTANT(IPPROTO_IPV6),
+    OS_CONSTANT(IPPROTO_RAW),
+    OS_CONSTANT(IPPROTO_TCP),
+    OS_CONSTANT(IPPROTO_UDP),
+    OS_CONSTANT(IPV6_CHECKSUM),
+    OS_CONSTANT(IPV6_MULTICAST_HOPS),
+    OS_CONSTANT(IPV6_MULTICAST_IF),
+    OS_CONSTANT(IPV6_MULTICAST_LOOP),
 #if defined(IPV6_RECVDSTOPTS)
-    initConstant(env, c, "IPV6_RECVDSTOPTS", IPV6_RECVDSTOPTS);
+    OS_CONSTANT(IPV6_RECVDSTOPTS),
+#else
+    MISSING_OS_CONSTANT(IPV6_RECVDSTOPTS),
 #endif
 #if defined(IPV6_RECVHOPLIMIT)
-    initConstant(env, c, "IPV6_RECVHOPLIMIT", IPV6_RECVHOPLIMIT);
+    OS_CONSTANT(IPV6_RECVHOPLIMIT),
+#else
+    MISSING_OS_CONSTANT(IPV6_RECVHOPLIMIT),
 #endif
 #if defined(IPV6_RECVHOPOPTS)
-    initConstant(env, c, "IPV6_RECVHOPOPTS", IPV6_RECVHOPOPTS);
+    OS_CONSTANT(IPV6_RECVHOPOPTS),
+#else
+    MISSING_OS_CONSTANT(IPV6_RECVHOPOPTS),
 #endif
 #if defined(IPV6_RECVPKTINFO)
-    initConstant(env, c, "IPV6_RECVPKTINFO", IPV6_RECVPKTINFO);
+    OS_CONSTANT(IPV6_RECVPKTINFO),
+#else
+    MISSING_OS_CONSTANT(IPV6_RECVPKTINFO),
 #endif
 #if defined(IPV6_RECVRTHDR)
-    initConstant(env, c, "IPV6_RECVRTHDR", IPV6_RECVRTHDR);
+    OS_CONSTANT(IPV6_RECVRTHDR),
+#else
+    MISSING_OS_CONSTANT(IPV6_RECVRTHDR),
 #endif
 #if defined(IPV6_RECVTCLASS)
-    initConstant(env, c, "IPV6_RECVTCLASS", IPV6_RECVTCLASS);
+    OS_CONSTANT(IPV6_RECVTCLASS),
+#else
+    MISSING_OS_CONSTANT(IPV6_RECVTCLASS),
 #endif
 #if defined(IPV6_TCLASS)
-    initConstant(env, c, "IPV6_TCLASS", IPV6_TCLASS);
-#endif
-    initConstant(env, c, "IPV6_UNICAST_HOPS", IPV6_UNICAST_HOPS);
-    initConstant(env, c, "IPV6_V6ONLY", IPV6_V6ONLY);
-    initConstant(env, c, "IP_MULTICAST_IF", IP_MULTICAST_IF);
-    initConstant(env, c, "IP_MULTICAST_LOOP", IP_MULTICAST_LOOP);
-    initConstant(env, c, "IP_MULTICAST_TTL", IP_MULTICAST_TTL);
-    initConstant(env, c, "IP_TOS", IP_TOS);
-    initConstant(env, c, "IP_TTL", IP_TTL);
-    initConstant(env, c, "MAP_FIXED", MAP_FIXED);
-    initConstant(env, c, "MAP_PRIVATE", MAP_PRIVATE);
-    initConstant(env, c, "MAP_SHARED", MAP_SHARED);
+    OS_CONSTANT(IPV6_TCLASS),
+#else
+    MISSING_OS_CONSTANT(IPV6_TCLASS),
+#endif
+    OS_CONSTANT(IPV6_UNICAST_HOPS),
+    OS_CONSTANT(IPV6_V6ONLY),
+    OS_CONSTANT(IP_MULTICAST_IF),
+    OS_CONSTANT(IP_MULTICAST_LOOP),
+    OS_CONSTANT(IP_MULTICAST_TTL),
+    OS_CONSTANT(IP_TOS),
+    OS_CONSTANT(IP_TTL),
+    OS_CONSTANT(MADV_DONTNEED),
+#if defined(MADV_HUGEPAGE)
+    OS_CONSTANT(MADV_HUGEPAGE),
+#else
+    MISSING_OS_CONSTANT(MADV_HUGEPAGE),
+#endif
+    OS_CONSTANT(MADV_NORMAL),
+    OS_CONSTANT(MADV_RANDOM),
+    OS_CONSTANT(MADV_SEQUENTIAL),
+    OS_CONSTANT(MADV_WILLNEED),
+    OS_CONSTANT(MAP_FIXED),
+#if defined(MAP_HUGETLB)
+    OS_CONSTANT(MAP_HUGETLB),
+#else
+    MISSING_OS_CONSTANT(MAP_HUGETLB),
+#endif
+#if defined(MAP_POPULATE)
+    OS_CONSTANT(MAP_POPULATE),
+#else
+    MISSING_OS_CONSTANT(MAP_POPULATE),
+#endif
+    OS_CONSTANT(MAP_PRIVATE),
+    OS_CONSTANT(MAP_SHARED),
 #if defined(MCAST_JOIN_GROUP)
-    initConstant(env, c, "MCAST_JOIN_GROUP", MCAST_JOIN_GROUP);
+    OS_CONSTANT(MCAST_JOIN_GROUP),
+#else
+    MISSING_OS_CONSTANT(MCAST_JOIN_GROUP),
 #endif
 #if defined(MCAST_LEAVE_GROUP)
-    initConstant(env, c, "MCAST_LEAVE_GROUP", MCAST_LEAVE_GROUP);
+    OS_CONSTANT(MCAST_LEAVE_GROUP),
+#else
+    MISSING_OS_CONSTANT(MCAST_LEAVE_GROUP),
 #endif
 #if defined(MCAST_JOIN_SOURCE_GROUP)
-    initConstant(env, c, "MCAST_JOIN_SOURCE_GROUP", MCAST_JOIN_SOURCE_GROUP);
+    OS_CONSTANT(MCAST_JOIN_SOURCE_GROUP),
+#else
+    MISSING_OS_CONSTANT(MCAST_JOIN_SOURCE_GROUP),
 #endif
 #if defined(MCAST_LEAVE_SOURCE_GROUP)
-    initConstant(env, c, "MCAST_LEAVE_SOURCE_GROUP", MCAST_LEAVE_SOURCE_GROUP);
+    OS_CONSTANT(MCAST_LEAVE_SOURCE_GROUP),
+#else
+    MISSING_OS_CONSTANT(MCAST_LEAVE_SOURCE_GROUP),
 #endif
 #if defined(MCAST_BLOCK_SOURCE)
-    initConstant(env, c, "MCAST_BLOCK_SOURCE", MCAST_BLOCK_SOURCE);
+    OS_CONSTANT(MCAST_BLOCK_SOURCE),
+#else
+    MISSING_OS_CONSTANT(MCAST_BLOCK_SOURCE),
 #endif
 #if defined(MCAST_UNBLOCK_SOURCE)
-    initConstant(env, c, "MCAST_UNBLOCK_SOURCE", MCAST_UNBLOCK_SOURCE);
-#endif
-    initConstant(env, c, "MCL_CURRENT", MCL_CURRENT);
-    initConstant(env, c, "MCL_FUTURE", MCL_FUTURE);
-    initConstant(env, c, "MSG_CTRUNC", MSG_CTRUNC);
-    initConstant(env, c, "MSG_DONTROUTE", MSG_DONTROUTE);
-    initConstant(env, c, "MSG_EOR", MSG_EOR);
-    initConstant(env, c, "MSG_OOB", MSG_OOB);
-    initConstant(env, c, "MSG_PEEK", MSG_PEEK);
-    initConstant(env, c, "MSG_TRUNC", MSG_TRUNC);
-    initConstant(env, c, "MSG_WAITALL", MSG_WAITALL);
-    initConstant(env, c, "MS_ASYNC", MS_ASYNC);
-    initConstant(env, c, "MS_INVALIDATE", MS_INVALIDATE);
-    initConstant(env, c, "MS_SYNC", MS_SYNC);
-    initConstant(env, c, "NI_DGRAM", NI_DGRAM);
-    initConstant(env, c, "NI_NAMEREQD", NI_NAMEREQD);
-    initConstant(env, c, "NI_NOFQDN", NI_NOFQDN);
-    initConstant(env, c, "NI_NUMERICHOST", NI_NUMERICHOST);
-    initConstant(env, c, "NI_NUMERICSERV", NI_NUMERICSERV);
-    initConstant(env, c, "O_ACCMODE", O_ACCMODE);
-    initConstant(env, c, "O_APPEND", O_APPEND);
-    initConstant(env, c, "O_CREAT", O_CREAT);
-    initConstant(env, c, "O_EXCL", O_EXCL);
-    initConstant(env, c, "O_NOCTTY", O_NOCTTY);
-    initConstant(env, c, "O_NOFOLLOW", O_NOFOLLOW);
-    initConstant(env, c, "O_NONBLOCK", O_NONBLOCK);
-    initConstant(env, c, "O_RDONLY", O_RDONLY);
-    initConstant(env, c, "O_RDWR", O_RDWR);
-    initConstant(env, c, "O_SYNC", O_SYNC);
-    initConstant(env, c, "O_TRUNC", O_TRUNC);
-    initConstant(env, c, "O_WRONLY", O_WRONLY);
-    initConstant(env, c, "POLLERR", POLLERR);
-    initConstant(env, c, "POLLHUP", POLLHUP);
-    initConstant(env, c, "POLLIN", POLLIN);
-    initConstant(env, c, "POLLNVAL", POLLNVAL);
-    initConstant(env, c, "POLLOUT", POLLOUT);
-    initConstant(env, c, "POLLPRI", POLLPRI);
-    initConstant(env, c, "POLLRDBAND", POLLRDBAND);
-    initConstant(env, c, "POLLRDNORM", POLLRDNORM);
-    initConstant(env, c, "POLLWRBAND", POLLWRBAND);
-    initConstant(env, c, "POLLWRNORM", POLLWRNORM);
+    OS_CONSTANT(MCAST_UNBLOCK_SOURCE),
+#else
+    MISSING_OS_CONSTANT(MCAST_UNBLOCK_SOURCE),
+#endif
+    OS_CONSTANT(MCL_CURRENT),
+    OS_CONSTANT(MCL_FUTURE),
+    OS_CONSTANT(MSG_CTRUNC),
+    OS_CONSTANT(MSG_DONTROUTE),
+    OS_CONSTANT(MSG_EOR),
+    OS_CONSTANT(MSG_OOB),
+    OS_CONSTANT(MSG_PEEK),
+    OS_CONSTANT(MSG_TRUNC),
+    OS_CONSTANT(MSG_WAITALL),
+    OS_CONSTANT(MS_ASYNC),
+    OS_CONSTANT(MS_INVALIDATE),
+    OS_CONSTANT(MS_SYNC),
+    OS_CONSTANT(NI_DGRAM),
+    OS_CONSTANT(NI_NAMEREQD),
+    OS_CONSTANT(NI_NOFQDN),
+    OS_CONSTANT(NI_NUMERICHOST),
+    OS_CONSTANT(NI_NUMERICSERV),
+    OS_CONSTANT(O_ACCMODE),
+    OS_CONSTANT(O_APPEND),
+    OS_CONSTANT(O_CREAT),
+    OS_CONSTANT(O_EXCL),
+    OS_CONSTANT(O_NOCTTY),
+    OS_CONSTANT(O_NOFOLLOW),
+    OS_CONSTANT(O_NONBLOCK),
+#if defined(O_OVERLAPPED)
+    OS_CONSTANT(O_OVERLAPPED),
+#else
+    MISSING_OS_CONSTANT(O_OVERLAPPED),
+#endif
+    OS_CONSTANT(O_RDONLY),
+    OS_CONSTANT(O_RDWR),
+    OS_CONSTANT(O_SYNC),
+    OS_CONSTANT(O_TRUNC),
+    OS_CONSTANT(O_WRONLY),
+    OS_CONSTANT(POLLERR),
+    OS_CONSTANT(POLLHUP),
+    OS_CONSTANT(POLLIN),
+    OS_CONSTANT(POLLNVAL),
+    OS_CONSTANT(POLLOUT),
+    OS_CONSTANT(POLLPRI),
+    OS_CONSTANT(POLLRDBAND),
+    OS_CONSTANT(POLLRDNORM),
+    OS_CONSTANT(POLLWRBAND),
+    OS_CONSTANT(POLLWRNORM),
+#if defined(POSIX_FADV_DONTNEED)
+    OS_CONSTANT(POSIX_FADV_DONTNEED),
+#else
+    MISSING_OS_CONSTANT(POSIX_FADV_DONTNEED),
+#endif
+#if defined(POSIX_FADV_NOREUSE)
+    OS_CONSTANT(POSIX_FADV_NOREUSE),
+#else
+    MISSING_OS_CONSTANT(POSIX_FADV_NOREUSE),
+#endif
+#if defined(POSIX_FADV_NORMAL)
+    OS_CONSTANT(POSIX_FADV_NORMAL),
+#else
+    MISSING_OS_CONSTANT(POSIX_FADV_NORMAL),
+#endif
+#if defined(POSIX_FADV_RANDOM)
+    OS_CONSTANT(POSIX_FADV_RANDOM),
+#else
+    MISSING_OS_CONSTANT(POSIX_FADV_RANDOM),
+#endif
+#if defined(POSIX_FADV_SEQUENTIAL)
+    OS_CONSTANT(POSIX_FADV_SEQUENTIAL),
+#else
+    MISSING_OS_CONSTANT(POSIX_FADV_SEQUENTIAL),
+#endif
+#if defined(POSIX_FADV_WILLNEED)
+    OS_CONSTANT(POSIX_FADV_WILLNEED),
+#else
+    MISSING_OS_CONSTANT(POSIX_FADV_WILLNEED),
+#endif
 #if defined(PR_GET_DUMPABLE)
-    initConstant(env, c, "PR_GET_DUMPABLE", PR_GET_DUMPABLE);
+    OS_CONSTANT(PR_GET_DUMPABLE),
+#else
+    MISSING_OS_CONSTANT(PR_GET_DUMPABLE),
 #endif
 #if defined(PR_SET_DUMPABLE)
-    initConstant(env, c, "PR_SET_DUMPABLE", PR_SET_DUMPABLE);
+    OS_CONSTANT(PR_SET_DUMPABLE),
+#else
+    MISSING_OS_CONSTANT(PR_SET_DUMPABLE),
 #endif
 #if defined(PR_SET_NO_NEW_PRIVS)
-    initConstant(env, c, "PR_SET_NO_NEW_PRIVS", PR_SET_NO_NEW_PRIVS);
+    OS_CONSTANT(PR_SET_NO_NEW_PRIVS),
+#else
+    MISSING_OS_CONSTANT(PR_SET_NO_NEW_PRIVS),
 #endif
-    initConstant(env, c, "PROT_EXEC", PROT_EXEC);
-    initConstant(env, c, "PROT_NONE", PROT_NONE);
-    initConstant(env, c, "PROT_READ", PROT_READ);
-    initConstant(env, c, "PROT_WRITE", PROT_WRITE);
-    initConstant(env, c, "R_OK", R_OK);
+    OS_CONSTANT(PROT_EXEC),
+    OS_CONSTANT(PROT_NONE),
+    OS_CONSTANT(PROT_READ),
+    OS_CONSTANT(PROT_WRITE),
+    OS_CONSTANT(R_OK),
 // NOTE: The RT_* constants are not preprocessor defines, they're enum
 // members. The best we can do (barring UAPI / kernel version checks) is
 // to hope they exist on all host linuxes we're building on. These
 // constants have been around since 2.6.35 at least, so we should be ok.
 #if !defined(__APPLE__)
-    initConstant(env, c, "RT_SCOPE_HOST", RT_SCOPE_HOST);
-    initConstant(env, c, "RT_SCOPE_LINK", RT_SCOPE_LINK);
-    initConstant(env, c, "RT_SCOPE_NOWHERE", RT_SCOPE_NOWHERE);
-    initConstant(env, c, "RT_SCOPE_SITE", RT_SCOPE_SITE);
-    initConstant(env, c, "RT_SCOPE_UNIVERSE", RT_SCOPE_UNIVERSE);
-#endif
-    initConstant(env, c, "SEEK_CUR", SEEK_CUR);
-    initConstant(env, c, "SEEK_END", SEEK_END);
-    initConstant(env, c, "SEEK_SET", SEEK_SET);
-    initConstant(env, c, "SHUT_RD", SHUT_RD);
-    initConstant(env, c, "SHUT_RDWR", SHUT_RDWR);
-    initConstant(env, c, "SHUT_WR", SHUT_WR);
-    initConstant(env, c, "SIGABRT", SIGABRT);
-    initConstant(env, c, "SIGALRM", SIGALRM);
-    initConstant(env, c, "SIGBUS", SIGBUS);
-    initConstant(env, c, "SIGCHLD", SIGCHLD);
-    initConstant(env, c, "SIGCONT", SIGCONT);
-    initConstant(env, c, "SIGFPE", SIGFPE);
-    initConstant(env, c, "SIGHUP", SIGHUP);
-    initConstant(env, c, "SIGILL", SIGILL);
-    initConstant(env, c, "SIGINT", SIGINT);
-    initConstant(env, c, "SIGIO", SIGIO);
-    initConstant(env, c, "SIGKILL", SIGKILL);
-    initConstant(env, c, "SIGPIPE", SIGPIPE);
-    initConstant(env, c, "SIGPROF", SIGPROF);
+    OS_CONSTANT(RT_SCOPE_HOST),
+    OS_CONSTANT(RT_SCOPE_LINK),
+    OS_CONSTANT(RT_SCOPE_NOWHERE),
+    OS_CONSTANT(RT_SCOPE_SITE),
+    OS_CONSTANT(RT_SCOPE_UNIVERSE),
+#else
+    MISSING_OS_CONSTANT(RT_SCOPE_HOST),
+    MISSING_OS_CONSTANT(RT_SCOPE_LINK),
+    MISSING_OS_CONSTANT(RT_SCOPE_NOWHERE),
+    MISSING_OS_CONSTANT(RT_SCOPE_SITE),
+    MISSING_OS_CONSTANT(RT_SCOPE_UNIVERSE),
+#endif
+    OS_CONSTANT(SEEK_CUR),
+    OS_CONSTANT(SEEK_END),
+    OS_CONSTANT(SEEK_SET),
+    OS_CONSTANT(SHUT_RD),
+    OS_CONSTANT(SHUT_RDWR),
+    OS_CONSTANT(SHUT_WR),
+    OS_CONSTANT(SIGABRT),
+    OS_CONSTANT(SIGALRM),
+    OS_CONSTANT(SIGBUS),
+    OS_CONSTANT(SIGCHLD),
+    OS_CONSTANT(SIGCONT),
+    OS_CONSTANT(SIGFPE),
+    OS_CONSTANT(SIGHUP),
+    OS_CONSTANT(SIGILL),
+    OS_CONSTANT(SIGINT),
+    OS_CONSTANT(SIGIO),
+    OS_CONSTANT(SIGKILL),
+    OS_CONSTANT(SIGPIPE),
+    OS_CONSTANT(SIGPROF),
 #if defined(SIGPWR)
-    initConstant(env, c, "SIGPWR", SIGPWR);
+    OS_CONSTANT(SIGPWR),
+#else
+    MISSING_OS_CONSTANT(SIGPWR),
 #endif
-    initConstant(env, c, "SIGQUIT", SIGQUIT);
-#if defined(SIGRTMAX)
-    initConstant(env, c, "SIGRTMAX", SIGRTMAX);
+    OS_CONSTANT(SIGQUIT),
+    // glibc's SIGRTMAX and SIGRTMIN are function calls, so they're filled in at runtime.
+    MISSING_OS_CONSTANT(SIGRTMAX),
+    MISSING_OS_CONSTANT(SIGRTMIN),
+    OS_CONSTANT(SIGSEGV),
+#if defined(SIGSTKFLT)
+    OS_CONSTANT(SIGSTKFLT),
+#else
+    MISSING_OS_CONSTANT(SIGSTKFLT),
+#endif
+    OS_CONSTANT(SIGSTOP),
+    OS_CONSTANT(SIGSYS),
+    OS_CONSTANT(SIGTERM),
+    OS_CONSTANT(SIGTRAP),
+    OS_CONSTANT(SIGTSTP),
+    OS_CONSTANT(SIGTTIN),
+    OS_CONSTANT(SIGTTOU),
+    OS_CONSTANT(SIGURG),
+    OS_CONSTANT(SIGUSR1),
+    OS_CONSTANT(SIGUSR2),
+    OS_CONSTANT(SIGVTALRM),
+    OS_CONSTANT(SIGWINCH),
+    OS_CONSTANT(SIGXCPU),
+    OS_CONSTANT(SIGXFSZ),
+    OS_CONSTANT(SIOCGIFADDR),
+    OS_CONSTANT(SIOCGIFBRDADDR),
+    OS_CONSTANT(SIOCGIFDSTADDR),
+    OS_CONSTANT(SIOCGIFNETMASK),
+#if defined(SOCK_CLOEXEC)
+    OS_CONSTANT(SOCK_CLOEXEC),
+#else
+    MISSING_OS_CONSTANT(SOCK_CLOEXEC),
 #endif
-#if defined(SIGRTMIN)
-    initConstant(env, c, "SIGRTMIN", SIGRTMIN);
+    OS_CONSTANT(SOCK_DGRAM),
+#if defined(SOCK_NONBLOCK)
+    OS_CONSTANT(SOCK_NONBLOCK),
+#else
+    MISSING_OS_CONSTANT(SOCK_NONBLOCK),
 #endif
-    initConstant(env, c, "SIGSEGV", SIGSEGV);
-#if defined(SIGSTKFLT)
-    initConstant(env, c, "SIGSTKFLT", SIGSTKFLT);
-#endif
-    initConstant(env, c, "SIGSTOP", SIGSTOP);
-    initConstant(env, c, "SIGSYS", SIGSYS);
-    initConstant(env, c, "SIGTERM", SIGTERM);
-    initConstant(env, c, "SIGTRAP", SIGTRAP);
-    initConstant(env, c, "SIGTSTP", SIGTSTP);
-    initConstant(env, c, "SIGTTIN", SIGTTIN);
-    initConstant(env, c, "SIGTTOU", SIGTTOU);
-    initConstant(env, c, "SIGURG", SIGURG);
-    initConstant(env, c, "SIGUSR1", SIGUSR1);
-    initConstant(env, c, "SIGUSR2", SIGUSR2);
-    initConstant(env, c, "SIGVTALRM", SIGVTALRM);
-    initConstant(env, c, "SIGWINCH", SIGWINCH);
-    initConstant(env, c, "SIGXCPU", SIGXCPU);
-    initConstant(env, c, "SIGXFSZ", SIGXFSZ);
-    initConstant(env, c, "SIOCGIFADDR", SIOCGIFADDR);
-    initConstant(env, c, "SIOCGIFBRDADDR", SIOCGIFBRDADDR);
-    initConstant(env, c, "SIOCGIFDSTADDR", SIOCGIFDSTADDR);
-    initConstant(env, c, "SIOCGIFNETMASK", SIOCGIFNETMASK);
-    initConstant(env, c, "SOCK_DGRAM", SOCK_DGRAM);
-    initConstant(env, c, "SOCK_RAW", SOCK_RAW);
-    initConstant(env, c, "SOCK_SEQPACKET", SOCK_SEQPACKET);
-    initConstant(env, c, "SOCK_STREAM", SOCK_STREAM);
-    initConstant(env, c, "SOL_SOCKET", SOL_SOCKET);
+    OS_CONSTANT(SOCK_RAW),
+    OS_CONSTANT(SOCK_SEQPACKET),
+    OS_CONSTANT(SOCK_STREAM),
+    OS_CONSTANT(SOL_SOCKET),
 #if defined(SO_BINDTODEVICE)
-    initConstant(env, c, "SO_BINDTODEVICE", SO_BINDTODEVICE);
-#endif
-    initConstant(env, c, "SO_BROADCAST", SO_BROADCAST);
-    initConstant(env, c, "SO_DEBUG", SO_DEBUG);
-    initConstant(env, c, "SO_DONTROUTE", SO_DONTROUTE);
-    initConstant(env, c, "SO_ERROR", SO_ERROR);
-    initConstant(env, c, "SO_KEEPALIVE", SO_KEEPALIVE);
-    initConstant(env, c, "SO_LINGER", SO_LINGER);
-    initConstant(env, c, "SO_OOBINLINE", SO_OOBINLINE);
+    OS_CONSTANT(SO_BINDTODEVICE),
+#else
+    MISSING_OS_CONSTANT(SO_BINDTODEVICE),
+#endif
+    OS_CONSTANT(SO_BROADCAST),
+    OS_CONSTANT(SO_DEBUG),
+    OS_CONSTANT(SO_DONTROUTE),
+    OS_CONSTANT(SO_ERROR),
+#if defined(SO_INCOMING_CPU)
+    OS_CONSTANT(SO_INCOMING_CPU),
+#else
+    MISSING_OS_CONSTANT(SO_INCOMING_CPU),
+#endif
+    OS_CONSTANT(SO_KEEPALIVE),
+    OS_CONSTANT(SO_LINGER),
+    OS_CONSTANT(SO_OOBINLINE),
 #if defined(SO_PASSCRED)
-    initConstant(env, c, "SO_PASSCRED", SO_PASSCRED);
+    OS_CONSTANT(SO_PASSCRED),
+#else
+    MISSING_OS_CONSTANT(SO_PASSCRED),
 #endif
 #if defined(SO_PEERCRED)
-    initConstant(env, c, "SO_PEERCRED", SO_PEERCRED);
-#endif
-    initConstant(env, c, "SO_RCVBUF", SO_RCVBUF);
-    initConstant(env, c, "SO_RCVLOWAT", SO_RCVLOWAT);
-    initConstant(env, c, "SO_RCVTIMEO", SO_RCVTIMEO);
-    initConstant(env, c, "SO_REUSEADDR", SO_REUSEADDR);
-    initConstant(env, c, "SO_SNDBUF", SO_SNDBUF);
-    initConstant(env, c, "SO_SNDLOWAT", SO_SNDLOWAT);
-    initConstant(env, c, "SO_SNDTIMEO", SO_SNDTIMEO);
-    initConstant(env, c, "SO_TYPE", SO_TYPE);
-    initConstant(env, c, "STDERR_FILENO", STDERR_FILENO);
-    initConstant(env, c, "STDIN_FILENO", STDIN_FILENO);
-    initConstant(env, c, "STDOUT_FILENO", STDOUT_FILENO);
-    initConstant(env, c, "S_IFBLK", S_IFBLK);
-    initConstant(env, c, "S_IFCHR", S_IFCHR);
-    initConstant(env, c, "S_IFDIR", S_IFDIR);
-    initConstant(env, c, "S_IFIFO", S_IFIFO);
-    initConstant(env, c, "S_IFLNK", S_IFLNK);
-    initConstant(env, c, "S_IFMT", S_IFMT);
-    initConstant(env, c, "S_IFREG", S_IFREG);
-    initConstant(env, c, "S_IFSOCK", S_IFSOCK);
-    initConstant(env, c, "S_IRGRP", S_IRGRP);
-    initConstant(env, c, "S_IROTH", S_IROTH);
-    initConstant(env, c, "S_IRUSR", S_IRUSR);
-    initConstant(env, c, "S_IRWXG", S_IRWXG);
-    initConstant(env, c, "S_IRWXO", S_IRWXO);
-    initConstant(env, c, "S_IRWXU", S_IRWXU);
-    initConstant(env, c, "S_ISGID", S_ISGID);
-    initConstant(env, c, "S_ISUID", S_ISUID);
-    initConstant(env, c, "S_ISVTX", S_ISVTX);
-    initConstant(env, c, "S_IWGRP", S_IWGRP);
-    initConstant(env, c, "S_IWOTH", S_IWOTH);
-    initConstant(env, c, "S_IWUSR", S_IWUSR);
-    initConstant(env, c, "S_IXGRP", S_IXGRP);
-    initConstant(env, c, "S_IXOTH", S_IXOTH);
-    initConstant(env, c, "S_IXUSR", S_IXUSR);
-    initConstant(env, c, "TCP_NODELAY", TCP_NODELAY);
-    initConstant(env, c, "WCONTINUED", WCONTINUED);
-    initConstant(env, c, "WEXITED", WEXITED);
-    initConstant(env, c, "WNOHANG", WNOHANG);
-    initConstant(env, c, "WNOWAIT", WNOWAIT);
-    initConstant(env, c, "WSTOPPED", WSTOPPED);
-    initConstant(env, c, "WUNTRACED", WUNTRACED);
-    initConstant(env, c, "W_OK", W_OK);
-    initConstant(env, c, "X_OK", X_OK);
-    initConstant(env, c, "_SC_2_CHAR_TERM", _SC_2_CHAR_TERM);
-    initConstant(env, c, "_SC_2_C_BIND", _SC_2_C_BIND);
-    initConstant(env, c, "_SC_2_C_DEV", _SC_2_C_DEV);
+    OS_CONSTANT(SO_PEERCRED),
+#else
+    MISSING_OS_CONSTANT(SO_PEERCRED),
+#endif
+    OS_CONSTANT(SO_RCVBUF),
+    OS_CONSTANT(SO_RCVLOWAT),
+    OS_CONSTANT(SO_RCVTIMEO),
+    OS_CONSTANT(SO_REUSEADDR),
+#if defined(SO_REUSEPORT)
+    OS_CONSTANT(SO_REUSEPORT),
+#else
+    MISSING_OS_CONSTANT(SO_REUSEPORT),
+#endif
+    OS_CONSTANT(SO_SNDBUF),
+    OS_CONSTANT(SO_SNDLOWAT),
+    OS_CONSTANT(SO_SNDTIMEO),
+    OS_CONSTANT(SO_TYPE),
+    OS_CONSTANT(STDERR_FILENO),
+    OS_CONSTANT(STDIN_FILENO),
+    OS_CONSTANT(STDOUT_FILENO),
+    OS_CONSTANT(S_IFBLK),
+    OS_CONSTANT(S_IFCHR),
+    OS_CONSTANT(S_IFDIR),
+    OS_CONSTANT(S_IFIFO),
+    OS_CONSTANT(S_IFLNK),
+    OS_CONSTANT(S_IFMT),
+    OS_CONSTANT(S_IFREG),
+    OS_CONSTANT(S_IFSOCK),
+    OS_CONSTANT(S_IRGRP),
+    OS_CONSTANT(S_IROTH),
+    OS_CONSTANT(S_IRUSR),
+    OS_CONSTANT(S_IRWXG),
+    OS_CONSTANT(S_IRWXO),
+    OS_CONSTANT(S_IRWXU),
+    OS_CONSTANT(S_ISGID),
+    OS_CONSTANT(S_ISUID),
+    OS_CONSTANT(S_ISVTX),
+    OS_CONSTANT(S_IWGRP),
+    OS_CONSTANT(S_IWOTH),
+    OS_CONSTANT(S_IWUSR),
+    OS_CONSTANT(S_IXGRP),
+    OS_CONSTANT(S_IXOTH),
+    OS_CONSTANT(S_IXUSR),
+    OS_CONSTANT(TCP_NODELAY),
+    OS_CONSTANT(WCONTINUED),
+    OS_CONSTANT(WEXITED),
+    OS_CONSTANT(WNOHANG),
+    OS_CONSTANT(WNOWAIT),
+    OS_CONSTANT(WSTOPPED),
+    OS_CONSTANT(WUNTRACED),
+    OS_CONSTANT(W_OK),
+    OS_CONSTANT(X_OK),
+    OS_CONSTANT(_SC_2_CHAR_TERM),
+    OS_CONSTANT(_SC_2_C_BIND),
+    OS_CONSTANT(_SC_2_C_DEV),
 #if defined(_SC_2_C_VERSION)
-    initConstant(env, c, "_SC_2_C_VERSION", _SC_2_C_VERSION);
-#endif
-    initConstant(env, c, "_SC_2_FORT_DEV", _SC_2_FORT_DEV);
-    initConstant(env, c, "_SC_2_FORT_RUN", _SC_2_FORT_RUN);
-    initConstant(env, c, "_SC_2_LOCALEDEF", _SC_2_LOCALEDEF);
-    initConstant(env, c, "_SC_2_SW_DEV", _SC_2_SW_DEV);
-    initConstant(env, c, "_SC_2_UPE", _SC_2_UPE);
-    initConstant(env, c, "_SC_2_VERSION", _SC_2_VERSION);
-    initConstant(env, c, "_SC_AIO_LISTIO_MAX", _SC_AIO_LISTIO_MAX);
-    initConstant(env, c, "_SC_AIO_MAX", _SC_AIO_MAX);
-    initConstant(env, c, "_SC_AIO_PRIO_DELTA_MAX", _SC_AIO_PRIO_DELTA_MAX);
-    initConstant(env, c, "_SC_ARG_MAX", _SC_ARG_MAX);
-    initConstant(env, c, "_SC_ASYNCHRONOUS_IO", _SC_ASYNCHRONOUS_IO);
-    initConstant(env, c, "_SC_ATEXIT_MAX", _SC_ATEXIT_MAX);
+    OS_CONSTANT(_SC_2_C_VERSION),
+#else
+    MISSING_OS_CONSTANT(_SC_2_C_VERSION),
+#endif
+    OS_CONSTANT(_SC_2_FORT_DEV),
+    OS_CONSTANT(_SC_2_FORT_RUN),
+    OS_CONSTANT(_SC_2_LOCALEDEF),
+    OS_CONSTANT(_SC_2_SW_DEV),
+    OS_CONSTANT(_SC_2_UPE),
+    OS_CONSTANT(_SC_2_VERSION),
+    OS_CONSTANT(_SC_AIO_LISTIO_MAX),
+    OS_CONSTANT(_SC_AIO_MAX),
+    OS_CONSTANT(_SC_AIO_PRIO_DELTA_MAX),
+    OS_CONSTANT(_SC_ARG_MAX),
+    OS_CONSTANT(_SC_ASYNCHRONOUS_IO),
+    OS_CONSTANT(_SC_ATEXIT_MAX),
 #if defined(_SC_AVPHYS_PAGES)
-    initConstant(env, c, "_SC_AVPHYS_PAGES", _SC_AVPHYS_PAGES);
-#endif
-    initConstant(env, c, "_SC_BC_BASE_MAX", _SC_BC_BASE_MAX);
-    initConstant(env, c, "_SC_BC_DIM_MAX", _SC_BC_DIM_MAX);
-    initConstant(env, c, "_SC_BC_SCALE_MAX", _SC_BC_SCALE_MAX);
-    initConstant(env, c, "_SC_BC_STRING_MAX", _SC_BC_STRING_MAX);
-    initConstant(env, c, "_SC_CHILD_MAX", _SC_CHILD_MAX);
-    initConstant(env, c, "_SC_CLK_TCK", _SC_CLK_TCK);
-    initConstant(env, c, "_SC_COLL_WEIGHTS_MAX", _SC_COLL_WEIGHTS_MAX);
-    initConstant(env, c, "_SC_DELAYTIMER_MAX", _SC_DELAYTIMER_MAX);
-    initConstant(env, c, "_SC_EXPR_NEST_MAX", _SC_EXPR_NEST_MAX);
-    initConstant(env, c, "_SC_FSYNC", _SC_FSYNC);
-    initConstant(env, c, "_SC_GETGR_R_SIZE_MAX", _SC_GETGR_R_SIZE_MAX);
-    initConstant(env, c, "_SC_GETPW_R_SIZE_MAX", _SC_GETPW_R_SIZE_MAX);
-    initConstant(env, c, "_SC_IOV_MAX", _SC_IOV_MAX);
-    initConstant(env, c, "_SC_JOB_CONTROL", _SC_JOB_CONTROL);
-    initConstant(env, c, "_SC_LINE_MAX", _SC_LINE_MAX);
-    initConstant(env, c, "_SC_LOGIN_NAME_MAX", _SC_LOGIN_NAME_MAX);
-    initConstant(env, c, "_SC_MAPPED_FILES", _SC_MAPPED_FILES);
-    initConstant(env, c, "_SC_MEMLOCK", _SC_MEMLOCK);
-    initConstant(env, c, "_SC_MEMLOCK_RANGE", _SC_MEMLOCK_RANGE);
-    initConstant(env, c, "_SC_MEMORY_PROTECTION", _SC_MEMORY_PROTECTION);
-    initConstant(env, c, "_SC_MESSAGE_PASSING", _SC_MESSAGE_PASSING);
-    initConstant(env, c, "_SC_MQ_OPEN_MAX", _SC_MQ_OPEN_MAX);
-    initConstant(env, c, "_SC_MQ_PRIO_MAX", _SC_MQ_PRIO_MAX);
-    initConstant(env, c, "_SC_NGROUPS_MAX", _SC_NGROUPS_MAX);
-    initConstant(env, c, "_SC_NPROCESSORS_CONF", _SC_NPROCESSORS_CONF);
-    initConstant(env, c, "_SC_NPROCESSORS_ONLN", _SC_NPROCESSORS_ONLN);
-    initConstant(env, c, "_SC_OPEN_MAX", _SC_OPEN_MAX);
-    initConstant(env, c, "_SC_PAGESIZE", _SC_PAGESIZE);
-    initConstant(env, c, "_SC_PAGE_SIZE", _SC_PAGE_SIZE);
-    initConstant(env, c, "_SC_PASS_MAX", _SC_PASS_MAX);
+    OS_CONSTANT(_SC_AVPHYS_PAGES),
+#else
+    MISSING_OS_CONSTANT(_SC_AVPHYS_PAGES),
+#endif
+    OS_CONSTANT(_SC_BC_BASE_MAX),
+    OS_CONSTANT(_SC_BC_DIM_MAX),
+    OS_CONSTANT(_SC_BC_SCALE_MAX),
+    OS_CONSTANT(_SC_BC_STRING_MAX),
+    OS_CONSTANT(_SC_CHILD_MAX),
+    OS_CONSTANT(_SC_CLK_TCK),
+    OS_CONSTANT(_SC_COLL_WEIGHTS_MAX),
+    OS_CONSTANT(_SC_DELAYTIMER_MAX),
+    OS_CONSTANT(_SC_EXPR_NEST_MAX),
+    OS_CONSTANT(_SC_FSYNC),
+    OS_CONSTANT(_SC_GETGR_R_SIZE_MAX),
+    OS_CONSTANT(_SC_GETPW_R_SIZE_MAX),
+    OS_CONSTANT(_SC_IOV_MAX),
+    OS_CONSTANT(_SC_JOB_CONTROL),
+    OS_CONSTANT(_SC_LINE_MAX),
+    OS_CONSTANT(_SC_LOGIN_NAME_MAX),
+    OS_CONSTANT(_SC_MAPPED_FILES),
+    OS_CONSTANT(_SC_MEMLOCK),
+    OS_CONSTANT(_SC_MEMLOCK_RANGE),
+    OS_CONSTANT(_SC_MEMORY_PROTECTION),
+    OS_CONSTANT(_SC_MESSAGE_PASSING),
+    OS_CONSTANT(_SC_MQ_OPEN_MAX),
+    OS_CONSTANT(_SC_MQ_PRIO_MAX),
+    OS_CONSTANT(_SC_NGROUPS_MAX),
+    OS_CONSTANT(_SC_NPROCESSORS_CONF),
+    OS_CONSTANT(_SC_NPROCESSORS_ONLN),
+    OS_CONSTANT(_SC_OPEN_MAX),
+    OS_CONSTANT(_SC_PAGESIZE),
+    OS_CONSTANT(_SC_PAGE_SIZE),
+    OS_CONSTANT(_SC_PASS_MAX),
 #if defined(_SC_PHYS_PAGES)
-    initConstant(env, c, "_SC_PHYS_PAGES", _SC_PHYS_PAGES);
-#endif
-    initConstant(env, c, "_SC_PRIORITIZED_IO", _SC_PRIORITIZED_IO);
-    initConstant(env, c, "_SC_PRIORITY_SCHEDULING", _SC_PRIORITY_SCHEDULING);
-    initConstant(env, c, "_SC_REALTIME_SIGNALS", _SC_REALTIME_SIGNALS);
-    initConstant(env, c, "_SC_RE_DUP_MAX", _SC_RE_DUP_MAX);
-    initConstant(env, c, "_SC_RTSIG_MAX", _SC_RTSIG_MAX);
-    initConstant(env, c, "_SC_SAVED_IDS", _SC_SAVED_IDS);
-    initConstant(env, c, "_SC_SEMAPHORES", _SC_SEMAPHORES);
-    initConstant(env, c, "_SC_SEM_NSEMS_MAX", _SC_SEM_NSEMS_MAX);
-    initConstant(env, c, "_SC_SEM_VALUE_MAX", _SC_SEM_VALUE_MAX);
-    initConstant(env, c, "_SC_SHARED_MEMORY_OBJECTS", _SC_SHARED_MEMORY_OBJECTS);
-    initConstant(env, c, "_SC_SIGQUEUE_MAX", _SC_SIGQUEUE_MAX);
-    initConstant(env, c, "_SC_STREAM_MAX", _SC_STREAM_MAX);
-    initConstant(env, c, "_SC_SYNCHRONIZED_IO", _SC_SYNCHRONIZED_IO);
-    initConstant(env, c, "_SC_THREADS", _SC_THREADS);
-    initConstant(env, c, "_SC_THREAD_ATTR_STACKADDR", _SC_THREAD_ATTR_STACKADDR);
-    initConstant(env, c, "_SC_THREAD_ATTR_STACKSIZE", _SC_THREAD_ATTR_STACKSIZE);
-    initConstant(env, c, "_SC_THREAD_DESTRUCTOR_ITERATIONS", _SC_THREAD_DESTRUCTOR_ITERATIONS);
-    initConstant(env, c, "_SC_THREAD_KEYS_MAX", _SC_THREAD_KEYS_MAX);
-    initConstant(env, c, "_SC_THREAD_PRIORITY_SCHEDULING", _SC_THREAD_PRIORITY_SCHEDULING);
-    initConstant(env, c, "_SC_THREAD_PRIO_INHERIT", _SC_THREAD_PRIO_INHERIT);
-    initConstant(env, c, "_SC_THREAD_PRIO_PROTECT", _SC_THREAD_PRIO_PROTECT);
-    initConstant(env, c, "_SC_THREAD_SAFE_FUNCTIONS", _SC_THREAD_SAFE_FUNCTIONS);
-    initConstant(env, c, "_SC_THREAD_STACK_MIN", _SC_THREAD_STACK_MIN);
-    initConstant(env, c, "_SC_THREAD_THREADS_MAX", _SC_THREAD_THREADS_MAX);
-    initConstant(env, c, "_SC_TIMERS", _SC_TIMERS);
-    initConstant(env, c, "_SC_TIMER_MAX", _SC_TIMER_MAX);
-    initConstant(env, c, "_SC_TTY_NAME_MAX", _SC_TTY_NAME_MAX);
-    initConstant(env, c, "_SC_TZNAME_MAX", _SC_TZNAME_MAX);
-    initConstant(env, c, "_SC_VERSION", _SC_VERSION);
-    initConstant(env, c, "_SC_XBS5_ILP32_OFF32", _SC_XBS5_ILP32_OFF32);
-    initConstant(env, c, "_SC_XBS5_ILP32_OFFBIG", _SC_XBS5_ILP32_OFFBIG);
-    initConstant(env, c, "_SC_XBS5_LP64_OFF64", _SC_XBS5_LP64_OFF64);
-    initConstant(env, c, "_SC_XBS5_LPBIG_OFFBIG", _SC_XBS5_LPBIG_OFFBIG);
-    initConstant(env, c, "_SC_XOPEN_CRYPT", _SC_XOPEN_CRYPT);
-    initConstant(env, c, "_SC_XOPEN_ENH_I18N", _SC_XOPEN_ENH_I18N);
-    initConstant(env, c, "_SC_XOPEN_LEGACY", _SC_XOPEN_LEGACY);
-    initConstant(env, c, "_SC_XOPEN_REALTIME", _SC_XOPEN_REALTIME);
-    initConstant(env, c, "_SC_XOPEN_REALTIME_THREADS", _SC_XOPEN_REALTIME_THREADS);
-    initConstant(env, c, "_SC_XOPEN_SHM", _SC_XOPEN_SHM);
-    initConstant(env, c, "_SC_XOPEN_UNIX", _SC_XOPEN_UNIX);
-    initConstant(env, c, "_SC_XOPEN_VERSION", _SC_XOPEN_VERSION);
-    initConstant(env, c, "_SC_XOPEN_XCU_VERSION", _SC_XOPEN_XCU_VERSION);
+    OS_CONSTANT(_SC_PHYS_PAGES),
+#else
+    MISSING_OS_CONSTANT(_SC_PHYS_PAGES),
+#endif
+    OS_CONSTANT(_SC_PRIORITIZED_IO),
+    OS_CONSTANT(_SC_PRIORITY_SCHEDULING),
+    OS_CONSTANT(_SC_REALTIME_SIGNALS),
+    OS_CONSTANT(_SC_RE_DUP_MAX),
+    OS_CONSTANT(_SC_RTSIG_MAX),
+    OS_CONSTANT(_SC_SAVED_IDS),
+    OS_CONSTANT(_SC_SEMAPHORES),
+    OS_CONSTANT(_SC_SEM_NSEMS_MAX),
+    OS_CONSTANT(_SC_SEM_VALUE_MAX),
+    OS_CONSTANT(_SC_SHARED_MEMORY_OBJECTS),
+    OS_CONSTANT(_SC_SIGQUEUE_MAX),
+    OS_CONSTANT(_SC_STREAM_MAX),
+    OS_CONSTANT(_SC_SYNCHRONIZED_IO),
+    OS_CONSTANT(_SC_THREADS),
+    OS_CONSTANT(_SC_THREAD_ATTR_STACKADDR),
+    OS_CONSTANT(_SC_THREAD_ATTR_STACKSIZE),
+    OS_CONSTANT(_SC_THREAD_DESTRUCTOR_ITERATIONS),
+    OS_CONSTANT(_SC_THREAD_KEYS_MAX),
+    OS_CONSTANT(_SC_THREAD_PRIORITY_SCHEDULING),
+    OS_CONSTANT(_SC_THREAD_PRIO_INHERIT),
+    OS_CONSTANT(_SC_THREAD_PRIO_PROTECT),
+    OS_CONSTANT(_SC_THREAD_SAFE_FUNCTIONS),
+    OS_CONSTANT(_SC_THREAD_STACK_MIN),
+    OS_CONSTANT(_SC_THREAD_THREADS_MAX),
+    OS_CONSTANT(_SC_TIMERS),
+    OS_CONSTANT(_SC_TIMER_MAX),
+    OS_CONSTANT(_SC_TTY_NAME_MAX),
+    OS_CONSTANT(_SC_TZNAME_MAX),
+    OS_CONSTANT(_SC_VERSION),
+    OS_CONSTANT(_SC_XBS5_ILP32_OFF32),
+    OS_CONSTANT(_SC_XBS5_ILP32_OFFBIG),
+    OS_CONSTANT(_SC_XBS5_LP64_OFF64),
+    OS_CONSTANT(_SC_XBS5_LPBIG_OFFBIG),
+    OS_CONSTANT(_SC_XOPEN_CRYPT),
+    OS_CONSTANT(_SC_XOPEN_ENH_I18N),
+    OS_CONSTANT(_SC_XOPEN_LEGACY),
+    OS_CONSTANT(_SC_XOPEN_REALTIME),
+    OS_CONSTANT(_SC_XOPEN_REALTIME_THREADS),
+    OS_CONSTANT(_SC_XOPEN_SHM),
+    OS_CONSTANT(_SC_XOPEN_UNIX),
+    OS_CONSTANT(_SC_XOPEN_VERSION),
+    OS_CONSTANT(_SC_XOPEN_XCU_VERSION),
+};
+
+static jintArray OsConstants_values(JNIEnv* env, jclass) {
+    static const size_t count = NELEM(gConstants);
+    jint values[count];
+    for (size_t i = 0; i < count; ++i) {
+        values[i] = gConstants[i].value;
+#if defined(SIGRTMAX)
+        if (strcmp(gConstants[i].name, "SIGRTMAX") == 0) {
+            values[i] = SIGRTMAX;
+        }
+#endif
+#if defined(SIGRTMIN)
+        if (strcmp(gConstants[i].name, "SIGRTMIN") == 0) {
+            values[i] = SIGRTMIN;
+        }
+#endif
+    }
+    jintArray result = env->NewIntArray(count);
+    if (result != NULL) {
+        env->SetIntArrayRegion(result, 0, count, values);
+    }
+    return result;
+}
+
+static jobjectArray OsConstants_names(JNIEnv* env, jclass) {
+    jobjectArray result = env->NewObjectArray(NELEM(gConstants), JniConstants::stringClass, NULL);
+    if (result == NULL) {
+        return NULL;
+    }
+    for (size_t i = 0; i < NELEM(gConstants); ++i) {
+        ScopedLocalRef<jstring> name(env, env->NewStringUTF(gConstants[i].name));
+        if (name.get() == NULL) {
+            return NULL;
+        }
+        env->SetObjectArrayElement(result, i, name.get());
+    }
+    return result;
 }
 
 static JNINativeMethod gMethods[] = {
-    NATIVE_METHOD(OsConstants, initConstants, "()V"),
+    NATIVE_METHOD(OsConstants, names, "()[Ljava/lang/String;"),
+    NATIVE_METHOD(OsConstants, values, "()[I"),
 };
 void register_android_system_OsConstants(JNIEnv* env) {
     jniRegisterNativeMethods(env, "android/system/OsConstants", gMethods, NELEM(gMethods));
@@ -41,11 +41,178 @@ bool canonicalize_path(const wchar_t* path, std::wstring& resolved_path) {
 	return res;
 }
 
+void set_canonicalize_path_cache_enabled(bool) {
+}
+
 #else
+#include "ScopedPthreadMutexLock.h"
+#include "ScratchArena.h"
+
+#include <algorithm>
 #include <errno.h>
+#include <map>
+#include <pthread.h>
+#include <set>
+#include <string.h>
 #include <sys/param.h>
 #include <sys/stat.h>
 #include <unistd.h>
+#if defined(__linux__)
+#include <sys/inotify.h>
+#endif
+
+// Sets 'isSymlink' to whether 'path' is a symbolic link, and 'target' to its contents if so.
+// A path that can't be examined isn't a symbolic link. Sets errno and returns false if 'path'
+// is a symbolic link that can't be read.
+static bool lookUpPathComponent(const std::string& path, bool& isSymlink, std::string& target) {
+    struct stat sb;
+    isSymlink = (lstat(path.c_str(), &sb) == 0 && S_ISLNK(sb.st_mode));
+    return !isSymlink || readlink(path.c_str(), target);
+}
+
+#if defined(__linux__)
+
+/**
+ * An optional cache of how path components resolved: whether each is a symbolic link, and its
+ * contents if so. A component is only cached once its parent directory has an inotify watch,
+ * and any event from any watch (or an overflowing event queue) discards the whole cache. Each
+ * canonicalization starts by draining the events, so checking that the cache is still valid
+ * costs a single non-blocking read(2), rather than an lstat(2) per component. When either cap
+ * is reached, the cache starts again from scratch. The cache is off by default, since each
+ * watch uses some of the (per-user) inotify limit.
+ */
+struct CachedPathComponent {
+    bool isSymlink;
+    std::string target;
+};
+static const size_t MAX_CACHED_PATH_COMPONENTS = 4096;
+static const size_t MAX_WATCHED_DIRECTORIES = 512;
+static const uint32_t kWatchedEvents = IN_CREATE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO |
+        IN_DELETE_SELF | IN_MOVE_SELF | IN_DONT_FOLLOW | IN_ONLYDIR;
+static bool gPathCacheEnabled = false;
+static int gPathCacheInotifyFd = -1;
+// Incremented whenever the cache is discarded, so results from before then aren't cached.
+static unsigned gPathCacheGeneration = 0;
+static std::map<std::string, CachedPathComponent> gCachedPathComponents;
+static std::set<std::string> gWatchedDirectories;
+static pthread_mutex_t gPathCacheLock = PTHREAD_MUTEX_INITIALIZER;
+
+// Must be called with gPathCacheLock held. Closing the inotify fd removes all its watches.
+static void discardPathCache() {
+    if (gPathCacheInotifyFd != -1) {
+        close(gPathCacheInotifyFd);
+        gPathCacheInotifyFd = -1;
+    }
+    gCachedPathComponents.clear();
+    gWatchedDirectories.clear();
+    ++gPathCacheGeneration;
+}
+
+// Discards the cache if anything has changed in a watched directory since we last looked.
+static void validatePathCache() {
+    ScopedPthreadMutexLock lock(&gPathCacheLock);
+    if (gPathCacheInotifyFd == -1) {
+        return;
+    }
+    char events[4096] __attribute__((aligned(__alignof__(struct inotify_event))));
+    ssize_t byteCount = TEMP_FAILURE_RETRY(read(gPathCacheInotifyFd, events, sizeof(events)));
+    if (byteCount != -1 || errno != EAGAIN) {
+        discardPathCache();
+    }
+}
+
+// Makes sure the parent directory of 'path' is watched, and returns the cache generation to
+// pass to cachePathComponent, or returns false if the component shouldn't be cached.
+static bool watchParentDirectory(const std::string& path, unsigned& generation) {
+    std::string parent(path, 0, std::max<size_t>(path.rfind('/'), 1));
+    ScopedPthreadMutexLock lock(&gPathCacheLock);
+    if (!gPathCacheEnabled) {
+        return false;
+    }
+    if (gWatchedDirectories.find(parent) == gWatchedDirectories.end()) {
+        if (gWatchedDirectories.size() >= MAX_WATCHED_DIRECTORIES) {
+            discardPathCache();
+        }
+        if (gPathCacheInotifyFd == -1) {
+            gPathCacheInotifyFd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+            if (gPathCacheInotifyFd == -1) {
+                return false;
+            }
+        }
+        if (inotify_add_watch(gPathCacheInotifyFd, parent.c_str(), kWatchedEvents) == -1) {
+            return false;
+        }
+        gWatchedDirectories.insert(parent);
+    }
+    generation = gPathCacheGeneration;
+    return true;
+}
+
+static void cachePathComponent(const std::string& path, unsigned generation, bool isSymlink,
+                               const std::string& target) {
+    ScopedPthreadMutexLock lock(&gPathCacheLock);
+    if (generation != gPathCacheGeneration) {
+        return;
+    }
+    if (gCachedPathComponents.size() >= MAX_CACHED_PATH_COMPONENTS) {
+        discardPathCache();
+        return;
+    }
+    CachedPathComponent& component(gCachedPathComponents[path]);
+    component.isSymlink = isSymlink;
+    component.target = target;
+}
+
+static bool getCachedPathComponent(const std::string& path, bool& isSymlink, std::string& target) {
+    ScopedPthreadMutexLock lock(&gPathCacheLock);
+    std::map<std::string, CachedPathComponent>::const_iterator it =
+            gCachedPathComponents.find(path);
+    if (it == gCachedPathComponents.end()) {
+        return false;
+    }
+    isSymlink = it->second.isSymlink;
+    target = it->second.target;
+    return true;
+}
+
+// Like lookUpPathComponent, but going through the cache.
+static bool resolvePathComponent(const std::string& path, bool& isSymlink, std::string& target) {
+    if (getCachedPathComponent(path, isSymlink, target)) {
+        return true;
+    }
+    // The watch has to be in place before we look, or we could miss a change.
+    unsigned generation;
+    bool cacheable = watchParentDirectory(path, generation);
+    if (!lookUpPathComponent(path, isSymlink, target)) {
+        return false;
+    }
+    if (cacheable) {
+        cachePathComponent(path, generation, isSymlink, target);
+    }
+    return true;
+}
+
+void set_canonicalize_path_cache_enabled(bool enabled) {
+    ScopedPthreadMutexLock lock(&gPathCacheLock);
+    gPathCacheEnabled = enabled;
+    if (!enabled) {
+        discardPathCache();
+    }
+}
+
+#else
+
+static void validatePathCache() {
+}
+
+static bool resolvePathComponent(const std::string& path, bool& isSymlink, std::string& target) {
+    return lookUpPathComponent(path, isSymlink, target);
+}
+
+void set_canonicalize_path_cache_enabled(bool) {
+}
+
+#endif
 
 /**
  * This differs from realpath(3) mainly in its behavior when a path element does not exist or can
@@ -55,7 +222,9 @@ bool canonicalize_path(const wchar_t* path, std::wstring& resolved_path) {
  * can resolve (as in "/tmp/does-not-exist/../blah.txt" which would be an error for realpath(3)
  * but "/tmp/blah.txt" under the traditional Java interpretation).
  *
- * This implementation also removes all the fixed-length buffers of the C original.
+ * This implementation also removes all the fixed-length buffers of the C original. The
+ * unresolved remainder of the path lives in the thread's ScratchArena, so apart from growing
+ * 'resolved' (and any path cache entries), canonicalization doesn't touch the heap.
  */
 bool canonicalize_path(const char* path, std::string& resolved) {
     // 'path' must be an absolute path.
@@ -69,23 +238,31 @@ bool canonicalize_path(const char* path, std::string& resolved) {
         return true;
     }
 
+    validatePathCache();
+
     // Iterate over path components in 'left'.
+    ScopedScratchArena arena;
     int symlinkCount = 0;
-    std::string left(path + 1);
-    while (!left.empty()) {
+    const char* left = path + 1;
+    std::string symlink;
+    while (*left != '\0') {
         // Extract the next path component.
-        size_t nextSlash = left.find('/');
-        std::string nextPathComponent = left.substr(0, nextSlash);
-        if (nextSlash != std::string::npos) {
-            left.erase(0, nextSlash + 1);
+        const char* nextPathComponent = left;
+        const char* nextSlash = strchr(left, '/');
+        size_t nextPathComponentLength;
+        if (nextSlash != NULL) {
+            nextPathComponentLength = nextSlash - left;
+            left = nextSlash + 1;
         } else {
-            left.clear();
+            nextPathComponentLength = strlen(left);
+            left += nextPathComponentLength;
         }
-        if (nextPathComponent.empty()) {
+        if (nextPathComponentLength == 0) {
             continue;
-        } else if (nextPathComponent == ".") {
+        } else if (nextPathComponentLength == 1 && nextPathComponent[0] == '.') {
             continue;
-        } else if (nextPathComponent == "..") {
+        } else if (nextPathComponentLength == 2 && nextPathComponent[0] == '.' &&
+                nextPathComponent[1] == '.') {
             // Strip the last path component except when we have single "/".
             if (resolved.size() > 1) {
                 resolved.erase(resolved.rfind('/'));
@@ -97,20 +274,18 @@ bool canonicalize_path(const char* path, std::string& resolved) {
         if (resolved[resolved.size() - 1] != '/') {
             resolved += '/';
         }
-        resolved += nextPathComponent;
+        resolved.append(nextPathComponent, nextPathComponentLength);
 
         // See if we've got a symbolic link, and resolve it if so.
-        struct stat sb;
-        if (lstat(resolved.c_str(), &sb) == 0 && S_ISLNK(sb.st_mode)) {
+        bool isSymlink;
+        if (!resolvePathComponent(resolved, isSymlink, symlink)) {
+            return false;
+        }
+        if (isSymlink) {
             if (symlinkCount++ > MAXSYMLINKS) {
                 errno = ELOOP;
                 return false;
             }
-
-            std::string symlink;
-            if (!readlink(resolved.c_str(), symlink)) {
-                return false;
-            }
             if (symlink[0] == '/') {
                 // The symbolic link is absolute, so we need to start from scratch.
                 resolved = "/";
@@ -120,12 +295,19 @@ bool canonicalize_path(const char* path, std::string& resolved) {
                 resolved.erase(resolved.rfind('/'));
             }
 
-            if (!left.empty()) {
-                const char* maybeSlash = (symlink[symlink.size() - 1] != '/') ? "/" : "";
-                left = symlink + maybeSlash + left;
-            } else {
-                left = symlink;
+            // The new remainder is the link's contents followed by the old remainder. There
+            // are at most MAXSYMLINKS of these, and they all go when the arena scope ends.
+            size_t leftLength = strlen(left);
+            size_t slashLength = (leftLength > 0 && symlink[symlink.size() - 1] != '/') ? 1 : 0;
+            char* newLeft = arena.allocateArray<char>(symlink.size() + slashLength + leftLength + 1);
+            if (newLeft == NULL) {
+                errno = ENOMEM;
+                return false;
             }
+            memcpy(newLeft, symlink.data(), symlink.size());
+            memcpy(newLeft + symlink.size(), "/", slashLength);
+            memcpy(newLeft + symlink.size() + slashLength, left, leftLength + 1);
+            left = newLeft;
         }
     }
 
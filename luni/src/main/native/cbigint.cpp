@@ -104,6 +104,14 @@
 
 #define E_OFFSET (1075)
 
+/* Where the compiler has a 128-bit integer type, the multiplications and additions below use
+ * whole 64-bit limbs. It compiles to the machine's widening multiply and add-with-carry
+ * instructions, replacing the portable loops over 32-bit halves. */
+#if defined(__SIZEOF_INT128__)
+#define USE_INT128
+typedef unsigned __int128 uint128_t;
+#endif
+
 #define FLOAT_MANTISSA_MASK (0x007FFFFF)
 #define FLOAT_EXPONENT_MASK (0x7F800000)
 #define FLOAT_NORMAL_MASK   (0x00800000)
@@ -127,6 +135,41 @@ simpleAddHighPrecision (uint64_t * arg1, int32_t length, uint64_t arg2)
   return index == length;
 }
 
+#if defined(USE_INT128)
+int32_t
+addHighPrecision (uint64_t * arg1, int32_t length1, uint64_t * arg2, int32_t length2)
+{
+  /* addition is limited by length of arg1 as it this function is
+   * storing the result in arg1 */
+  if (length1 == 0 || length2 == 0)
+    {
+      return 0;
+    }
+  else if (length1 < length2)
+    {
+      length2 = length1;
+    }
+
+  uint64_t carry = 0;
+  int32_t index = 0;
+  do
+    {
+      uint128_t sum = static_cast<uint128_t>(arg1[index]) + arg2[index] + carry;
+      arg1[index] = static_cast<uint64_t>(sum);
+      carry = static_cast<uint64_t>(sum >> 64);
+    }
+  while (++index < length2);
+  if (!carry)
+    return 0;
+  else if (index == length1)
+    return 1;
+
+  while (++arg1[index] == 0 && ++index < length1) {
+  }
+
+  return index == length1;
+}
+#else
 int32_t
 addHighPrecision (uint64_t * arg1, int32_t length1, uint64_t * arg2, int32_t length2)
 {
@@ -172,6 +215,7 @@ addHighPrecision (uint64_t * arg1, int32_t length1, uint64_t * arg2, int32_t len
 
   return index == length1;
 }
+#endif
 
 void
 subtractHighPrecision (uint64_t * arg1, int32_t length1, uint64_t * arg2, int32_t length2)
@@ -192,6 +236,22 @@ subtractHighPrecision (uint64_t * arg1, int32_t length1, uint64_t * arg2, int32_
   simpleAddHighPrecision (arg1, length1, 1);
 }
 
+#if defined(USE_INT128)
+static uint32_t simpleMultiplyHighPrecision(uint64_t* arg1, int32_t length, uint64_t arg2) {
+  /* assumes arg2 only holds 32 bits of information, so the overflow does too */
+  uint64_t carry = 0;
+  int32_t index = 0;
+  do
+    {
+      uint128_t product = static_cast<uint128_t>(arg1[index]) * arg2 + carry;
+      arg1[index] = static_cast<uint64_t>(product);
+      carry = static_cast<uint64_t>(product >> 64);
+    }
+  while (++index < length);
+
+  return static_cast<uint32_t>(carry);
+}
+#else
 static uint32_t simpleMultiplyHighPrecision(uint64_t* arg1, int32_t length, uint64_t arg2) {
   /* assumes arg2 only holds 32 bits of information */
   uint64_t product;
@@ -213,7 +273,9 @@ static uint32_t simpleMultiplyHighPrecision(uint64_t* arg1, int32_t length, uint
 
   return HIGH_U32_FROM_VAR (product);
 }
+#endif
 
+#if !defined(USE_INT128)
 static void
 simpleMultiplyAddHighPrecision (uint64_t * arg1, int32_t length, uint64_t arg2,
                                 uint32_t * result)
@@ -251,7 +313,9 @@ simpleMultiplyAddHighPrecision (uint64_t * arg1, int32_t length, uint64_t arg2,
     }
 }
 
-#if __BYTE_ORDER != __LITTLE_ENDIAN
+#endif
+
+#if !defined(USE_INT128) && __BYTE_ORDER != __LITTLE_ENDIAN
 void simpleMultiplyAddHighPrecisionBigEndianFix(uint64_t* arg1, int32_t length, uint64_t arg2, uint32_t* result) {
     /* Assumes result can hold the product and arg2 only holds 32 bits of information */
     int32_t index = 0;
@@ -276,6 +340,32 @@ void simpleMultiplyAddHighPrecisionBigEndianFix(uint64_t* arg1, int32_t length,
 }
 #endif
 
+#if defined(USE_INT128)
+void
+multiplyHighPrecision (uint64_t * arg1, int32_t length1, uint64_t * arg2, int32_t length2,
+                       uint64_t * result, int32_t length)
+{
+  /* assumes result is large enough to hold product */
+  memset (result, 0, sizeof (uint64_t) * length);
+
+  for (int32_t j = 0; j < length2; ++j)
+    {
+      uint64_t multiplier = arg2[j];
+      if (multiplier == 0)
+        continue;
+      uint64_t carry = 0;
+      for (int32_t i = 0; i < length1; ++i)
+        {
+          uint128_t product =
+            static_cast<uint128_t>(arg1[i]) * multiplier + result[i + j] + carry;
+          result[i + j] = static_cast<uint64_t>(product);
+          carry = static_cast<uint64_t>(product >> 64);
+        }
+      /* nothing has been written this far up yet */
+      result[j + length1] = carry;
+    }
+}
+#else
 void
 multiplyHighPrecision (uint64_t * arg1, int32_t length1, uint64_t * arg2, int32_t length2,
                        uint64_t * result, int32_t length)
@@ -311,7 +401,26 @@ multiplyHighPrecision (uint64_t * arg1, int32_t length1, uint64_t * arg2, int32_
 #endif
     }
 }
+#endif
+
+#if defined(USE_INT128)
+uint32_t
+simpleAppendDecimalDigitHighPrecision (uint64_t * arg1, int32_t length, uint64_t digit)
+{
+  /* assumes digit is less than 32 bits */
+  uint64_t carry = digit;
+  int32_t index = 0;
+  do
+    {
+      uint128_t product = static_cast<uint128_t>(arg1[index]) * 10 + carry;
+      arg1[index] = static_cast<uint64_t>(product);
+      carry = static_cast<uint64_t>(product >> 64);
+    }
+  while (++index < length);
 
+  return static_cast<uint32_t>(carry);
+}
+#else
 uint32_t
 simpleAppendDecimalDigitHighPrecision (uint64_t * arg1, int32_t length, uint64_t digit)
 {
@@ -334,6 +443,7 @@ simpleAppendDecimalDigitHighPrecision (uint64_t * arg1, int32_t length, uint64_t
 
   return HIGH_U32_FROM_VAR (digit);
 }
+#endif
 
 void
 simpleShiftLeftHighPrecision (uint64_t * arg1, int32_t length, int32_t arg2)
@@ -365,6 +475,19 @@ simpleShiftLeftHighPrecision (uint64_t * arg1, int32_t length, int32_t arg2)
   *arg1 <<= arg2;
 }
 
+#if defined(__GNUC__)
+int32_t
+highestSetBit (uint64_t * y)
+{
+  return (*y == 0) ? 0 : 64 - __builtin_clzll (*y);
+}
+
+int32_t
+lowestSetBit (uint64_t * y)
+{
+  return (*y == 0) ? 0 : 1 + __builtin_ctzll (*y);
+}
+#else
 int32_t
 highestSetBit (uint64_t * y)
 {
@@ -507,6 +630,7 @@ lowestSetBit (uint64_t * y)
   else
     return result + 4;
 }
+#endif
 
 int32_t
 highestSetBitHighPrecision (uint64_t * arg, int32_t length)
@@ -822,55 +946,52 @@ floatExponent (jfloat z)
 }
 
 /* Allow a 64-bit value in arg2 */
+#if defined(USE_INT128)
 uint64_t
 simpleMultiplyHighPrecision64 (uint64_t * arg1, int32_t length, uint64_t arg2)
 {
-  uint64_t intermediate, carry1, carry2, prod1, prod2, sum;
-  uint64_t* pArg1;
-  int32_t index;
-  uint32_t buf32;
-
-  index = 0;
-  intermediate = 0;
-  pArg1 = arg1 + index;
-  carry1 = carry2 = 0;
-
+  uint64_t carry = 0;
+  int32_t index = 0;
   do
     {
-      if ((*pArg1 != 0) || (intermediate != 0))
-        {
-          prod1 =
-            static_cast<uint64_t>(LOW_U32_FROM_VAR (arg2)) * static_cast<uint64_t>(LOW_U32_FROM_PTR (pArg1));
-          sum = intermediate + prod1;
-          if ((sum < prod1) || (sum < intermediate))
-            {
-              carry1 = 1;
-            }
-          else
-            {
-              carry1 = 0;
-            }
-          prod1 =
-            static_cast<uint64_t>(LOW_U32_FROM_VAR (arg2)) * static_cast<uint64_t>(HIGH_U32_FROM_PTR (pArg1));
-          prod2 =
-            static_cast<uint64_t>(HIGH_U32_FROM_VAR (arg2)) * static_cast<uint64_t>(LOW_U32_FROM_PTR (pArg1));
-          intermediate = carry2 + HIGH_IN_U64 (sum) + prod1 + prod2;
-          if ((intermediate < prod1) || (intermediate < prod2))
-            {
-              carry2 = 1;
-            }
-          else
-            {
-              carry2 = 0;
-            }
-          LOW_U32_FROM_PTR (pArg1) = LOW_U32_FROM_VAR (sum);
-          buf32 = HIGH_U32_FROM_PTR (pArg1);
-          HIGH_U32_FROM_PTR (pArg1) = LOW_U32_FROM_VAR (intermediate);
-          intermediate = carry1 + HIGH_IN_U64 (intermediate)
-            + static_cast<uint64_t>(HIGH_U32_FROM_VAR (arg2)) * static_cast<uint64_t>(buf32);
-        }
-      pArg1++;
+      uint128_t product = static_cast<uint128_t>(arg1[index]) * arg2 + carry;
+      arg1[index] = static_cast<uint64_t>(product);
+      carry = static_cast<uint64_t>(product >> 64);
+    }
+  while (++index < length);
+  return carry;
+}
+#else
+uint64_t
+simpleMultiplyHighPrecision64 (uint64_t * arg1, int32_t length, uint64_t arg2)
+{
+  /* Forms each 128-bit limb product from four 32x32 partial products. The
+   * middle sum can't overflow (it's below 3 * 2^32), and neither can the
+   * high word, since a limb times arg2 plus a carry is below 2^128.
+   */
+  uint64_t arg2Low = LOW_U32_FROM_VAR (arg2);
+  uint64_t arg2High = HIGH_U32_FROM_VAR (arg2);
+  uint64_t carry = 0;
+  int32_t index = 0;
+  do
+    {
+      uint64_t limbLow = LOW_U32_FROM_PTR (arg1 + index);
+      uint64_t limbHigh = HIGH_U32_FROM_PTR (arg1 + index);
+      uint64_t lowLow = limbLow * arg2Low;
+      uint64_t lowHigh = limbLow * arg2High;
+      uint64_t highLow = limbHigh * arg2Low;
+      uint64_t highHigh = limbHigh * arg2High;
+      uint64_t middle = HIGH_IN_U64 (lowLow) + LOW_IN_U64 (lowHigh) + LOW_IN_U64 (highLow);
+      uint64_t low = LOW_IN_U64 (lowLow) | (middle << 32);
+      uint64_t high = highHigh + HIGH_IN_U64 (lowHigh) + HIGH_IN_U64 (highLow)
+        + HIGH_IN_U64 (middle);
+      low += carry;
+      if (low < carry)
+        high++;
+      arg1[index] = low;
+      carry = high;
     }
   while (++index < length);
-  return intermediate;
+  return carry;
 }
+#endif
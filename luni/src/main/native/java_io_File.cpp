@@ -20,6 +20,7 @@
 #include "JNIHelp.h"
 #include "JniConstants.h"
 #include "JniException.h"
+#include "ScopedLocalRef.h"
 #include "ScopedPrimitiveArray.h"
 #include "ScopedUtfChars.h"
 #include "toStringArray.h"
@@ -64,6 +65,11 @@ static jstring File_canonicalizePath(JNIEnv* env, jclass, jstring javaPath) {
 #endif
 }
 
+static void File_setCanonicalPathCacheEnabledImpl(JNIEnv*, jclass, jboolean enabled) {
+  extern void set_canonicalize_path_cache_enabled(bool enabled);
+  set_canonicalize_path_cache_enabled(enabled);
+}
+
 static jboolean File_setLastModifiedImpl(JNIEnv* env, jclass, jstring javaPath, jlong ms) {
   ScopedPathChars path(env, javaPath);
   if (path.c_str() == NULL) {
@@ -99,20 +105,30 @@ class ScopedReaddir {
 
   // Returns the next filename, or NULL.
   const u_char_t* next() {
+    u_dirent* result = nextEntry();
+    return (result != NULL) ? result->d_name : NULL;
+  }
+
+  // Returns the next directory entry, or NULL.
+  u_dirent* nextEntry() {
     if (mIsBad) {
       return NULL;
     }
     errno = 0;
     u_dirent* result = u_readdir(mDirStream);
-    if (result != NULL) {
-      return result->d_name;
-    }
-    if (errno != 0) {
+    if (result == NULL && errno != 0) {
       mIsBad = true;
     }
-    return NULL;
+    return result;
   }
 
+#if !defined(__MINGW32__) && !defined(__MINGW64__)
+  // Returns the directory's fd, for use with the *at(2) functions.
+  int fd() const {
+    return dirfd(mDirStream);
+  }
+#endif
+
   // Has an error occurred on this stream?
   bool isBad() const {
     return mIsBad;
@@ -152,6 +168,107 @@ static bool readDirectory(JNIEnv* env, jstring javaPath, DirEntries& entries) {
   return !dir.isBad();
 }
 
+// listAttributesImpl reports this many longs per entry: the st_mode file type bits, the length,
+// and the last-modified time in milliseconds.
+static const size_t ATTRIBUTES_PER_ENTRY = 3;
+
+static void statToAttributes(const struct _stat& sb, jlong* attributes) {
+  attributes[0] = sb.st_mode & S_IFMT;
+  attributes[1] = sb.st_size;
+  attributes[2] = static_cast<jlong>(sb.st_mtime) * 1000LL;
+}
+
+#if !defined(__MINGW32__) && !defined(__MINGW64__)
+// Returns the st_mode file type bits for a d_type, or 0 if the file system didn't say.
+static jlong direntTypeToMode(unsigned char type) {
+  switch (type) {
+  case DT_BLK: return S_IFBLK;
+  case DT_CHR: return S_IFCHR;
+  case DT_DIR: return S_IFDIR;
+  case DT_FIFO: return S_IFIFO;
+  case DT_LNK: return S_IFLNK;
+  case DT_REG: return S_IFREG;
+  case DT_SOCK: return S_IFSOCK;
+  default: return 0;
+  }
+}
+#endif
+
+// Like readDirectory, but also appends ATTRIBUTES_PER_ENTRY values per entry to 'attributes'.
+// The type comes from d_type when the file system provides it and 'statEntries' is false, at no
+// extra cost; otherwise each entry is stat'ed relative to the open directory, so the kernel
+// doesn't have to resolve the directory's path again for every entry.
+static bool readDirectoryAttributes(JNIEnv* env, jstring javaPath, bool statEntries,
+                                    DirEntries& entries, std::vector<jlong>& attributes) {
+  ScopedPathChars path(env, javaPath);
+  if (path.c_str() == NULL) {
+    return false;
+  }
+
+  ScopedReaddir dir(path.c_str());
+  u_dirent* entry;
+  while ((entry = dir.nextEntry()) != NULL) {
+    const u_char_t* filename = entry->d_name;
+#if defined(__MINGW32__) || defined(__MINGW64__)
+    if (wcscmp(filename, L".") == 0 || wcscmp(filename, L"..") == 0) {
+      continue;
+    }
+    // There's no d_type or fstatat(2) on Windows.
+    jlong values[ATTRIBUTES_PER_ENTRY] = { 0, -1, -1 };
+    u_string_t entryPath(path.c_str());
+    entryPath += L'\\';
+    entryPath += filename;
+    struct _stat sb;
+    if (u_stat(entryPath.c_str(), &sb) == 0) {
+      statToAttributes(sb, values);
+    }
+#else
+    if (strcmp(filename, ".") == 0 || strcmp(filename, "..") == 0) {
+      continue;
+    }
+    jlong values[ATTRIBUTES_PER_ENTRY] = { direntTypeToMode(entry->d_type), -1, -1 };
+    if (statEntries || values[0] == 0 || values[0] == S_IFLNK) {
+      // Follow symbolic links, as File.isDirectory does, but report a dangling one as a link.
+      // An entry that has vanished since readdir(3) keeps whatever d_type said.
+      struct stat sb;
+      if (fstatat(dir.fd(), filename, &sb, 0) == 0 ||
+          fstatat(dir.fd(), filename, &sb, AT_SYMLINK_NOFOLLOW) == 0) {
+        statToAttributes(sb, values);
+      }
+    }
+#endif
+    entries.push_back(filename);
+    attributes.insert(attributes.end(), values, values + ATTRIBUTES_PER_ENTRY);
+  }
+  return !dir.isBad();
+}
+
+static jobjectArray File_listAttributesImpl(JNIEnv* env, jclass, jstring javaPath,
+                                            jobjectArray javaAttributes, jboolean statEntries) {
+  DirEntries entries;
+  std::vector<jlong> attributes;
+  if (!readDirectoryAttributes(env, javaPath, statEntries, entries, attributes)) {
+    return NULL;
+  }
+
+  ScopedLocalRef<jlongArray> javaValues(env, env->NewLongArray(attributes.size()));
+  if (javaValues.get() == NULL) {
+    return NULL;
+  }
+  if (!attributes.empty()) {
+    env->SetLongArrayRegion(javaValues.get(), 0, attributes.size(), &attributes[0]);
+  }
+  env->SetObjectArrayElement(javaAttributes, 0, javaValues.get());
+  if (env->ExceptionCheck()) {
+    return NULL;
+  }
+#if defined(__MINGW32__) || defined(__MINGW64__)
+  return toStringArrayW(env, entries);
+#else
+  return toStringArray(env, entries);
+#endif
+}
+
 static jobjectArray File_listImpl(JNIEnv* env, jclass, jstring javaPath) {
   // Read the directory entries into an intermediate form.
   DirEntries entries;
@@ -168,7 +285,9 @@ static jobjectArray File_listImpl(JNIEnv* env, jclass, jstring javaPath) {
 
 static JNINativeMethod gMethods[] = {
   NATIVE_METHOD(File, canonicalizePath, "(Ljava/lang/String;)Ljava/lang/String;"),
+  NATIVE_METHOD(File, listAttributesImpl, "(Ljava/lang/String;[[JZ)[Ljava/lang/String;"),
   NATIVE_METHOD(File, listImpl, "(Ljava/lang/String;)[Ljava/lang/String;"),
+  NATIVE_METHOD(File, setCanonicalPathCacheEnabledImpl, "(Z)V"),
   NATIVE_METHOD(File, setLastModifiedImpl, "(Ljava/lang/String;J)Z"),
 };
 void register_java_io_File(JNIEnv* env) {
@@ -19,36 +19,197 @@
 
 #include "JNIHelp.h"
 #include "JniConstants.h"
+#include "ScopedLocalRef.h"
+#include "ScopedPthreadMutexLock.h"
 
-static jobject getSignature(JNIEnv* env, jclass c, jobject object) {
-    jmethodID mid = env->GetMethodID(c, "getSignature", "()Ljava/lang/String;");
-    if (!mid) {
+#include <algorithm>
+#include <pthread.h>
+#include <unordered_map>
+
+// The getSignature methods of Field, Method and Constructor, resolved once at registration
+// rather than looked up by name on every call.
+static jmethodID gFieldGetSignature;
+static jmethodID gMethodGetSignature;
+static jmethodID gConstructorGetSignature;
+
+static jclass gSystemClass;
+static jmethodID gIdentityHashCode;
+
+static jobject getSignature(JNIEnv* env, jobject object, jclass c, jmethodID mid) {
+    return env->CallNonvirtualObjectMethod(object, c, mid);
+}
+
+// Resolves the signatures of every member in 'members' with a single native transition.
+// A null element yields a null signature.
+static jobjectArray getSignatures(JNIEnv* env, jobjectArray members, jclass c, jmethodID mid) {
+    if (members == NULL) {
+        jniThrowNullPointerException(env, "members == null");
         return NULL;
     }
-    jclass objectClass = env->GetObjectClass(object);
-    return env->CallNonvirtualObjectMethod(object, objectClass, mid);
+    jsize count = env->GetArrayLength(members);
+    jobjectArray result = env->NewObjectArray(count, JniConstants::stringClass, NULL);
+    if (result == NULL) {
+        return NULL;
+    }
+    for (jsize i = 0; i < count; ++i) {
+        ScopedLocalRef<jobject> member(env, env->GetObjectArrayElement(members, i));
+        if (member.get() == NULL) {
+            continue;
+        }
+        ScopedLocalRef<jobject> signature(env, getSignature(env, member.get(), c, mid));
+        if (env->ExceptionCheck()) {
+            return NULL;
+        }
+        env->SetObjectArrayElement(result, i, signature.get());
+    }
+    return result;
 }
 
 static jobject ObjectStreamClass_getFieldSignature(JNIEnv* env, jclass, jobject field) {
-    return getSignature(env, JniConstants::fieldClass, field);
+    return getSignature(env, field, JniConstants::fieldClass, gFieldGetSignature);
+}
+
+static jobjectArray ObjectStreamClass_getFieldSignatures(JNIEnv* env, jclass, jobjectArray fields) {
+    return getSignatures(env, fields, JniConstants::fieldClass, gFieldGetSignature);
 }
 
 static jobject ObjectStreamClass_getMethodSignature(JNIEnv* env, jclass, jobject method) {
-    return getSignature(env, JniConstants::methodClass, method);
+    return getSignature(env, method, JniConstants::methodClass, gMethodGetSignature);
+}
+
+static jobjectArray ObjectStreamClass_getMethodSignatures(JNIEnv* env, jclass, jobjectArray methods) {
+    return getSignatures(env, methods, JniConstants::methodClass, gMethodGetSignature);
 }
 
 static jobject ObjectStreamClass_getConstructorSignature(JNIEnv* env, jclass, jobject constructor) {
-    return getSignature(env, JniConstants::constructorClass, constructor);
+    return getSignature(env, constructor, JniConstants::constructorClass, gConstructorGetSignature);
+}
+
+static jobjectArray ObjectStreamClass_getConstructorSignatures(JNIEnv* env, jclass, jobjectArray constructors) {
+    return getSignatures(env, constructors, JniConstants::constructorClass, gConstructorGetSignature);
+}
+
+// Per-class facts that ObjectStreamClass asks for every time it builds a descriptor. Each
+// ObjectStreamClass.lookup cache is per-thread and softly held, so without this a wide class
+// graph re-resolves the same classes over and over. Entries hold their class only weakly, so
+// caching never keeps a class (or its class loader) alive; entries whose class has been
+// unloaded are dropped when next encountered, and swept whenever the table doubles.
+struct ClassInfo {
+    jweak clazz;
+    jmethodID constructorId;
+    bool constructorIdKnown;
+    bool hasClinit;
+    bool hasClinitKnown;
+};
+
+typedef std::unordered_multimap<jint, ClassInfo> ClassInfoMap;
+static ClassInfoMap gClassInfo;
+static size_t gClassInfoSweepThreshold = 64;
+static pthread_mutex_t gClassInfoMutex = PTHREAD_MUTEX_INITIALIZER;
+
+static bool isCleared(JNIEnv* env, jweak ref) {
+    return env->IsSameObject(ref, NULL);
+}
+
+static void sweepClassInfoLocked(JNIEnv* env) {
+    for (ClassInfoMap::iterator it = gClassInfo.begin(); it != gClassInfo.end(); ) {
+        if (isCleared(env, it->second.clazz)) {
+            env->DeleteWeakGlobalRef(it->second.clazz);
+            it = gClassInfo.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    gClassInfoSweepThreshold = std::max<size_t>(64, 2 * gClassInfo.size());
+}
+
+// Returns the entry for 'c', creating an empty one if necessary, or NULL if one could not
+// be created (in which case an exception is pending). The caller must hold gClassInfoMutex.
+static ClassInfo* findClassInfoLocked(JNIEnv* env, jclass c, jint hash) {
+    std::pair<ClassInfoMap::iterator, ClassInfoMap::iterator> range = gClassInfo.equal_range(hash);
+    for (ClassInfoMap::iterator it = range.first; it != range.second; ) {
+        if (env->IsSameObject(it->second.clazz, c)) {
+            return &it->second;
+        }
+        if (isCleared(env, it->second.clazz)) {
+            env->DeleteWeakGlobalRef(it->second.clazz);
+            it = gClassInfo.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    if (gClassInfo.size() >= gClassInfoSweepThreshold) {
+        sweepClassInfoLocked(env);
+    }
+    jweak ref = env->NewWeakGlobalRef(c);
+    if (ref == NULL) {
+        return NULL;
+    }
+    ClassInfo info = { ref, NULL, false, false, false };
+    return &gClassInfo.insert(std::make_pair(hash, info))->second;
+}
+
+static jint identityHashCode(JNIEnv* env, jclass c) {
+    return env->CallStaticIntMethod(gSystemClass, gIdentityHashCode, c);
 }
 
 static jboolean ObjectStreamClass_hasClinit(JNIEnv * env, jclass, jclass targetClass) {
+    if (targetClass == NULL) {
+        jniThrowNullPointerException(env, "c == null");
+        return JNI_FALSE;
+    }
+    jint hash = identityHashCode(env, targetClass);
+    {
+        ScopedPthreadMutexLock lock(&gClassInfoMutex);
+        ClassInfo* info = findClassInfoLocked(env, targetClass, hash);
+        if (info != NULL && info->hasClinitKnown) {
+            return info->hasClinit;
+        }
+    }
+    // Resolve outside the lock: GetStaticMethodID may have to initialize the class.
     jmethodID mid = env->GetStaticMethodID(targetClass, "<clinit>", "()V");
     env->ExceptionClear();
-    return (mid != 0);
+    bool hasClinit = (mid != 0);
+    ScopedPthreadMutexLock lock(&gClassInfoMutex);
+    ClassInfo* info = findClassInfoLocked(env, targetClass, hash);
+    if (info != NULL) {
+        info->hasClinit = hasClinit;
+        info->hasClinitKnown = true;
+    } else {
+        env->ExceptionClear();
+    }
+    return hasClinit;
 }
 
 static jlong ObjectStreamClass_getConstructorId(JNIEnv* env, jclass, jclass constructorClass) {
-    return reinterpret_cast<jlong>(env->GetMethodID(constructorClass, "<init>", "()V"));
+    if (constructorClass == NULL) {
+        jniThrowNullPointerException(env, "c == null");
+        return 0;
+    }
+    jint hash = identityHashCode(env, constructorClass);
+    {
+        ScopedPthreadMutexLock lock(&gClassInfoMutex);
+        ClassInfo* info = findClassInfoLocked(env, constructorClass, hash);
+        if (info == NULL) {
+            return 0;
+        }
+        if (info->constructorIdKnown) {
+            return reinterpret_cast<jlong>(info->constructorId);
+        }
+    }
+    jmethodID mid = env->GetMethodID(constructorClass, "<init>", "()V");
+    if (mid == NULL) {
+        // Leave the NoSuchMethodError pending, and don't cache the failure.
+        return 0;
+    }
+    ScopedPthreadMutexLock lock(&gClassInfoMutex);
+    ClassInfo* info = findClassInfoLocked(env, constructorClass, hash);
+    if (info == NULL) {
+        return 0;
+    }
+    info->constructorId = mid;
+    info->constructorIdKnown = true;
+    return reinterpret_cast<jlong>(mid);
 }
 
 static jobject ObjectStreamClass_newInstance(JNIEnv* env, jclass, jclass instantiationClass, jlong methodId) {
@@ -58,11 +219,21 @@ static jobject ObjectStreamClass_newInstance(JNIEnv* env, jclass, jclass instant
 static JNINativeMethod gMethods[] = {
     NATIVE_METHOD(ObjectStreamClass, getConstructorId, "(Ljava/lang/Class;)J"),
     NATIVE_METHOD(ObjectStreamClass, getConstructorSignature, "(Ljava/lang/reflect/Constructor;)Ljava/lang/String;"),
+    NATIVE_METHOD(ObjectStreamClass, getConstructorSignatures, "([Ljava/lang/reflect/Constructor;)[Ljava/lang/String;"),
     NATIVE_METHOD(ObjectStreamClass, getFieldSignature, "(Ljava/lang/reflect/Field;)Ljava/lang/String;"),
+    NATIVE_METHOD(ObjectStreamClass, getFieldSignatures, "([Ljava/lang/reflect/Field;)[Ljava/lang/String;"),
     NATIVE_METHOD(ObjectStreamClass, getMethodSignature, "(Ljava/lang/reflect/Method;)Ljava/lang/String;"),
+    NATIVE_METHOD(ObjectStreamClass, getMethodSignatures, "([Ljava/lang/reflect/Method;)[Ljava/lang/String;"),
     NATIVE_METHOD(ObjectStreamClass, hasClinit, "(Ljava/lang/Class;)Z"),
     NATIVE_METHOD(ObjectStreamClass, newInstance, "(Ljava/lang/Class;J)Ljava/lang/Object;"),
 };
 void register_java_io_ObjectStreamClass(JNIEnv* env) {
+    const char* signature = "()Ljava/lang/String;";
+    gFieldGetSignature = env->GetMethodID(JniConstants::fieldClass, "getSignature", signature);
+    gMethodGetSignature = env->GetMethodID(JniConstants::methodClass, "getSignature", signature);
+    gConstructorGetSignature = env->GetMethodID(JniConstants::constructorClass, "getSignature", signature);
+    ScopedLocalRef<jclass> systemClass(env, env->FindClass("java/lang/System"));
+    gSystemClass = reinterpret_cast<jclass>(env->NewGlobalRef(systemClass.get()));
+    gIdentityHashCode = env->GetStaticMethodID(gSystemClass, "identityHashCode", "(Ljava/lang/Object;)I");
     jniRegisterNativeMethods(env, "java/io/ObjectStreamClass", gMethods, NELEM(gMethods));
 }
@@ -18,12 +18,16 @@
 
 #include "JNIHelp.h"
 #include "JniConstants.h"
+#include "ScopedPrimitiveArray.h"
 #include "ScopedUtfChars.h"
 #include "unicode/uchar.h"
 #include "unicode/uscript.h"
 #include <math.h>
 #include <stdio.h> // For BUFSIZ
 #include <stdlib.h>
+#include <string.h>
+
+#include <vector>
 
 static jint Character_digitImpl(JNIEnv*, jclass, jint codePoint, jint radix) {
     return u_digit(codePoint, radix);
@@ -33,6 +37,44 @@ static jint Character_getTypeImpl(JNIEnv*, jclass, jint codePoint) {
     return u_charType(codePoint);
 }
 
+// Builds Character.TypeTable: the RI-compatible general category of every BMP code point, split
+// into blocks of 'blockSize' chars with identical blocks stored once. Fills 'javaIndex' with the
+// offset of each block's types in the returned array.
+static jbyteArray Character_getTypeTableImpl(JNIEnv* env, jclass, jcharArray javaIndex, jint blockSize) {
+    ScopedCharArrayRW index(env, javaIndex);
+    if (index.get() == NULL) {
+        return NULL;
+    }
+    if (blockSize <= 0 || index.size() * blockSize != 0x10000) {
+        jniThrowException(env, "java/lang/IllegalArgumentException", "bad type table shape");
+        return NULL;
+    }
+
+    std::vector<jbyte> types;
+    std::vector<jbyte> block(blockSize);
+    for (size_t b = 0; b < index.size(); ++b) {
+        for (jint i = 0; i < blockSize; ++i) {
+            // The type values returned by ICU are not RI-compatible. The RI skips the value 17.
+            int type = u_charType(b * blockSize + i);
+            block[i] = (type <= U_FORMAT_CHAR) ? type : type + 1;
+        }
+        size_t offset = 0;
+        while (offset < types.size() && memcmp(&types[offset], &block[0], blockSize) != 0) {
+            offset += blockSize;
+        }
+        if (offset == types.size()) {
+            types.insert(types.end(), block.begin(), block.end());
+        }
+        index[b] = offset;
+    }
+
+    jbyteArray result = env->NewByteArray(types.size());
+    if (result != NULL) {
+        env->SetByteArrayRegion(result, 0, types.size(), &types[0]);
+    }
+    return result;
+}
+
 static jbyte Character_getIcuDirectionality(JNIEnv*, jclass, jint codePoint) {
     return u_charDirection(codePoint);
 }
@@ -170,6 +212,7 @@ static JNINativeMethod gMethods[] = {
     NATIVE_METHOD(Character, getNameImpl, "(I)Ljava/lang/String;"),
     NATIVE_METHOD(Character, getNumericValueImpl, "!(I)I"),
     NATIVE_METHOD(Character, getTypeImpl, "!(I)I"),
+    NATIVE_METHOD(Character, getTypeTableImpl, "([CI)[B"),
     NATIVE_METHOD(Character, isAlphabetic, "!(I)Z"),
     NATIVE_METHOD(Character, isDefinedImpl, "!(I)Z"),
     NATIVE_METHOD(Character, isDigitImpl, "!(I)Z"),
@@ -19,6 +19,7 @@
 #include "jni.h"
 #include "JNIHelp.h"
 #include "JniConstants.h"
+#include "ScopedPrimitiveArray.h"
 
 #include <stdlib.h>
 #include <math.h>
@@ -119,6 +120,70 @@ static jdouble Math_nextafter(JNIEnv*, jclass, jdouble a, jdouble b) {
     return nextafter(a, b);
 }
 
+// The array natives apply a function to in[offset, offset + length), writing the results to
+// the same range of 'out', which may be 'in' itself. The Java side checks the bounds. Each
+// element gets exactly the result of the scalar function, so these only save the JNI
+// transition per element (and let the compiler vectorize the cheap functions).
+template <double (*F)(double)>
+static void applyToArray(JNIEnv* env, jdoubleArray javaIn, jdoubleArray javaOut, jint offset,
+                         jint length) {
+    ScopedDoubleArrayRO in(env, javaIn);
+    if (in.get() == NULL) {
+        return;
+    }
+    ScopedDoubleArrayRW out(env, javaOut);
+    if (out.get() == NULL) {
+        return;
+    }
+    const jdouble* src = in.get() + offset;
+    jdouble* dst = out.get() + offset;
+    for (jint i = 0; i < length; ++i) {
+        dst[i] = F(src[i]);
+    }
+}
+
+template <double (*F)(double, double)>
+static void applyToArrays(JNIEnv* env, jdoubleArray javaX, jdoubleArray javaY,
+                          jdoubleArray javaOut, jint offset, jint length) {
+    ScopedDoubleArrayRO x(env, javaX);
+    if (x.get() == NULL) {
+        return;
+    }
+    ScopedDoubleArrayRO y(env, javaY);
+    if (y.get() == NULL) {
+        return;
+    }
+    ScopedDoubleArrayRW out(env, javaOut);
+    if (out.get() == NULL) {
+        return;
+    }
+    const jdouble* srcX = x.get() + offset;
+    const jdouble* srcY = y.get() + offset;
+    jdouble* dst = out.get() + offset;
+    for (jint i = 0; i < length; ++i) {
+        dst[i] = F(srcX[i], srcY[i]);
+    }
+}
+
+#define MATH_ARRAY_FUNCTION(name) \
+    static void Math_##name##Array(JNIEnv* env, jclass, jdoubleArray in, jdoubleArray out, \
+                                   jint offset, jint length) { \
+        applyToArray<name>(env, in, out, offset, length); \
+    }
+
+MATH_ARRAY_FUNCTION(cos)
+MATH_ARRAY_FUNCTION(exp)
+MATH_ARRAY_FUNCTION(log)
+MATH_ARRAY_FUNCTION(log10)
+MATH_ARRAY_FUNCTION(sin)
+MATH_ARRAY_FUNCTION(sqrt)
+MATH_ARRAY_FUNCTION(tan)
+
+static void Math_powArray(JNIEnv* env, jclass, jdoubleArray x, jdoubleArray y, jdoubleArray out,
+                          jint offset, jint length) {
+    applyToArrays<pow>(env, x, y, out, offset, length);
+}
+
 static JNINativeMethod gMethods[] = {
     NATIVE_METHOD(Math, IEEEremainder, "!(DD)D"),
     NATIVE_METHOD(Math, acos, "!(D)D"),
@@ -128,21 +193,29 @@ static JNINativeMethod gMethods[] = {
     NATIVE_METHOD(Math, cbrt, "!(D)D"),
     NATIVE_METHOD(Math, ceil, "!(D)D"),
     NATIVE_METHOD(Math, cos, "!(D)D"),
+    NATIVE_METHOD(Math, cosArray, "([D[DII)V"),
     NATIVE_METHOD(Math, cosh, "!(D)D"),
     NATIVE_METHOD(Math, exp, "!(D)D"),
+    NATIVE_METHOD(Math, expArray, "([D[DII)V"),
     NATIVE_METHOD(Math, expm1, "!(D)D"),
     NATIVE_METHOD(Math, floor, "!(D)D"),
     NATIVE_METHOD(Math, hypot, "!(DD)D"),
     NATIVE_METHOD(Math, log, "!(D)D"),
     NATIVE_METHOD(Math, log10, "!(D)D"),
+    NATIVE_METHOD(Math, log10Array, "([D[DII)V"),
     NATIVE_METHOD(Math, log1p, "!(D)D"),
+    NATIVE_METHOD(Math, logArray, "([D[DII)V"),
     NATIVE_METHOD(Math, nextafter, "!(DD)D"),
     NATIVE_METHOD(Math, pow, "!(DD)D"),
+    NATIVE_METHOD(Math, powArray, "([D[D[DII)V"),
     NATIVE_METHOD(Math, rint, "!(D)D"),
     NATIVE_METHOD(Math, sin, "!(D)D"),
+    NATIVE_METHOD(Math, sinArray, "([D[DII)V"),
     NATIVE_METHOD(Math, sinh, "!(D)D"),
     NATIVE_METHOD(Math, sqrt, "!(D)D"),
+    NATIVE_METHOD(Math, sqrtArray, "([D[DII)V"),
     NATIVE_METHOD(Math, tan, "!(D)D"),
+    NATIVE_METHOD(Math, tanArray, "([D[DII)V"),
     NATIVE_METHOD(Math, tanh, "!(D)D"),
 };
 void register_java_lang_Math(JNIEnv* env) {
@@ -19,6 +19,8 @@
 #include <dirent.h>
 #include <errno.h>
 #include <fcntl.h>
+#include <paths.h>
+#include <signal.h>
 #include <stdlib.h>
 #include <string.h>
 #include <sys/resource.h>
@@ -26,6 +28,16 @@
 #include <sys/wait.h>
 #include <unistd.h>
 
+#if defined(__linux__)
+#include <sched.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/syscall.h>
+#endif
+
+#include <string>
+#include <vector>
+
 #include "cutils/log.h"
 #include "jni.h"
 #include "ExecStrings.h"
@@ -33,37 +45,181 @@
 #include "JniConstants.h"
 #include "Portability.h"
 #include "ScopedLocalRef.h"
+#include "ScopedPthreadMutexLock.h"
 #include "toStringArray.h"
 
-static void CloseNonStandardFds(int status_pipe_fd) {
-  // On Cygwin, Linux, and Solaris, the best way to close iterates over "/proc/self/fd/".
-  const char* fd_path = "/proc/self/fd";
-#if defined(__APPLE__)
-  // On Mac OS, there's "/dev/fd/" which Linux seems to link to "/proc/self/fd/",
-  // but which on Solaris appears to be something quite different.
-  fd_path = "/dev/fd";
+#if defined(__linux__)
+struct linux_dirent64 {
+  uint64_t d_ino;
+  int64_t d_off;
+  unsigned short d_reclen;
+  unsigned char d_type;
+  char d_name[];
+};
+#endif
+
+// Closes fds [first, last], skipping 'keep1' and 'keep2'. Uses close_range(2) where the kernel has
+// it; otherwise reads /proc/self/fd with getdents64(2) into a stack buffer, since we're running
+// after vfork and mustn't allocate.
+static void CloseFdRange(int first, int keep1, int keep2) {
+  if (keep1 > keep2) {
+    int tmp = keep1;
+    keep1 = keep2;
+    keep2 = tmp;
+  }
+#if defined(__linux__) && defined(__NR_close_range)
+  // keep1 <= keep2, and either may be -1.
+  unsigned int lo = first;
+  bool ok = true;
+  const int keeps[] = { keep1, keep2 };
+  for (size_t i = 0; i < 2 && ok; ++i) {
+    if (keeps[i] < first || static_cast<unsigned int>(keeps[i]) < lo) {
+      continue;
+    }
+    if (static_cast<unsigned int>(keeps[i]) > lo) {
+      ok = syscall(__NR_close_range, lo, keeps[i] - 1, 0) == 0;
+    }
+    lo = keeps[i] + 1;
+  }
+  if (ok && syscall(__NR_close_range, lo, ~0U, 0) == 0) {
+    return;
+  }
+#endif
+
+#if defined(__linux__)
+  int dir_fd = open("/proc/self/fd", O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+  if (dir_fd != -1) {
+    char buf[4096];
+    long byteCount;
+    while ((byteCount = syscall(__NR_getdents64, dir_fd, buf, sizeof(buf))) > 0) {
+      for (long offset = 0; offset < byteCount; ) {
+        linux_dirent64* e = reinterpret_cast<linux_dirent64*>(buf + offset);
+        offset += e->d_reclen;
+        char* end;
+        int fd = strtol(e->d_name, &end, 10);
+        if (!*end && fd >= first && fd != dir_fd && fd != keep1 && fd != keep2) {
+          close(fd);
+        }
+      }
+    }
+    close(dir_fd);
+    return;
+  }
 #endif
 
-  // Keep track of the system properties fd so we don't close it.
-  int properties_fd = -1;
+  // Last resort: try every possible fd.
+  int max_fd = sysconf(_SC_OPEN_MAX);
+  for (int fd = first; fd < max_fd; ++fd) {
+    if (fd != keep1 && fd != keep2) {
+      close(fd);
+    }
+  }
+}
+
+static void CloseNonStandardFds(int status_pipe_fd, int properties_fd) {
+  CloseFdRange(STDERR_FILENO + 1, status_pipe_fd, properties_fd);
+}
+
+// Returns the system properties fd, so we don't close it, or -1.
+static int PropertiesFd() {
   char* properties_fd_string = getenv("ANDROID_PROPERTY_WORKSPACE");
-  if (properties_fd_string != NULL) {
-    properties_fd = atoi(properties_fd_string);
-  }
-
-  DIR* d = opendir(fd_path);
-  int dir_fd = dirfd(d);
-  dirent* e;
-  while ((e = readdir(d)) != NULL) {
-    char* end;
-    int fd = strtol(e->d_name, &end, 10);
-    if (!*end) {
-      if (fd > STDERR_FILENO && fd != dir_fd && fd != status_pipe_fd && fd != properties_fd) {
-        close(fd);
+  return (properties_fd_string != NULL) ? atoi(properties_fd_string) : -1;
+}
+
+/*
+ * Everything the child needs for execvp(3)'s PATH search, worked out in the parent so that the
+ * child only has to call execve(2). 'paths' are the full paths to try, in order. 'shellArgvs'
+ * holds, for each path, the argv that runs it through the shell, which is what execvp does on
+ * ENOEXEC. They're 'shellArgvStride' pointers apart. The child shares our memory, so it can't
+ * fill these in itself.
+ */
+struct ExecPlan {
+  std::vector<std::string> paths;
+  std::vector<char*> pathPointers;
+  std::vector<char*> shellArgvs;
+  size_t shellArgvStride;
+};
+
+static const char* FindPath(char** environment) {
+  if (environment == NULL) {
+    return getenv("PATH");
+  }
+  // The old fork(2)-based code installed the new environment before calling execvp(3), so
+  // the search used the child's PATH. Keep doing that.
+  for (char** e = environment; *e != NULL; ++e) {
+    if (strncmp(*e, "PATH=", 5) == 0) {
+      return *e + 5;
+    }
+  }
+  return NULL;
+}
+
+static void PlanExec(char** commands, char** environment, ExecPlan* plan) {
+  const char* file = commands[0];
+  if (*file == '\0') {
+    // Nothing to try: the child will fail with ENOENT.
+  } else if (strchr(file, '/') != NULL) {
+    plan->paths.push_back(file);
+  } else {
+    const char* path = FindPath(environment);
+    if (path == NULL) {
+      path = _PATH_DEFPATH;
+    }
+    while (true) {
+      const char* end = strchr(path, ':');
+      if (end == NULL) {
+        end = path + strlen(path);
+      }
+      std::string dir(path, end - path);
+      // An empty entry means the current directory.
+      plan->paths.push_back(dir.empty() ? std::string(file) : dir + "/" + file);
+      if (*end == '\0') {
+        break;
       }
+      path = end + 1;
     }
   }
-  closedir(d);
+  for (size_t i = 0; i < plan->paths.size(); ++i) {
+    plan->pathPointers.push_back(const_cast<char*>(plan->paths[i].c_str()));
+  }
+  plan->pathPointers.push_back(NULL);
+
+  size_t commandCount = 0;
+  while (commands[commandCount] != NULL) {
+    ++commandCount;
+  }
+  // The shell, the candidate, the rest of the arguments, and a NULL.
+  plan->shellArgvStride = commandCount + 2;
+  for (size_t i = 0; i < plan->paths.size(); ++i) {
+    plan->shellArgvs.push_back(const_cast<char*>(_PATH_BSHELL));
+    plan->shellArgvs.push_back(plan->pathPointers[i]);
+    plan->shellArgvs.insert(plan->shellArgvs.end(), commands + 1, commands + commandCount);
+    plan->shellArgvs.push_back(NULL);
+  }
+}
+
+// Tries each of the NULL-terminated 'paths' in turn, as execvp(3) would. Only returns on
+// failure, with errno set. Writes to nothing but locals, since it runs after vfork.
+static void ExecCandidates(char** paths, char** commands, char** environment,
+                           char** shellArgvs, size_t shellArgvStride) {
+  bool sawEacces = false;
+  errno = ENOENT;
+  for (size_t i = 0; paths[i] != NULL; ++i) {
+    execve(paths[i], commands, environment);
+    if (errno == ENOEXEC) {
+      char** shellArgv = shellArgvs + i * shellArgvStride;
+      execve(shellArgv[0], shellArgv, environment);
+      return;
+    } else if (errno == EACCES) {
+      sawEacces = true;
+    } else if (errno != ENOENT && errno != ENOTDIR && errno != ESTALE && errno != ENODEV &&
+               errno != ETIMEDOUT) {
+      return;
+    }
+  }
+  if (sawEacces) {
+    errno = EACCES;
+  }
 }
 
 #define PIPE_COUNT 4 // Number of pipes used to communicate with child.
@@ -84,6 +240,386 @@ static void AbortChild(int status_pipe_fd) {
   _exit(127);
 }
 
+/** What a new child does between vfork and exec, whoever started it. */
+struct ChildSpec {
+  int stdinFd;
+  int stdoutFd;
+  int stderrFd;
+  int statusFd;
+  bool redirectErrorStream;
+  const char* workingDirectory;
+  char** commands;
+  char** environment;
+  char** paths;
+  char** shellArgvs;
+  size_t shellArgvStride;
+  int propertiesFd;
+  // The signal mask to exec with. Whoever starts the child blocks every signal until then.
+  sigset_t signalMask;
+};
+
+// Signals stay blocked in the child until exec, but a handler that's still installed when we
+// unblock them would run our parent's code against our parent's memory. The defaults are what
+// execve(2) would leave anyway. Ignored signals stay ignored, as they would across exec.
+static void ResetSignalHandlers() {
+  for (int signo = 1; signo < NSIG; ++signo) {
+    struct sigaction action;
+    if (sigaction(signo, NULL, &action) == -1) {
+      continue;  // Not a signal this kernel (or libc) lets us touch.
+    }
+    if ((action.sa_flags & SA_SIGINFO) == 0 &&
+        (action.sa_handler == SIG_DFL || action.sa_handler == SIG_IGN)) {
+      continue;
+    }
+    memset(&action, 0, sizeof(action));
+    action.sa_handler = SIG_DFL;
+    sigemptyset(&action.sa_mask);
+    sigaction(signo, &action, NULL);
+  }
+}
+
+// Blocks every signal in the calling thread, saving the old mask in 'oldMask', so that no
+// handler can run in a child that shares our memory.
+static void BlockAllSignals(sigset_t* oldMask) {
+  sigset_t all;
+  sigfillset(&all);
+  pthread_sigmask(SIG_SETMASK, &all, oldMask);
+}
+
+// Note: We cannot malloc(3) or free(3), or write to anything but locals, in here!
+// We share our parent's memory until we exec or _exit, and the parent's other threads keep
+// running. We have our own file descriptor table and working directory, though.
+static void RunChild(const ChildSpec& spec) {
+  ResetSignalHandlers();
+
+  // Replace stdin, out, and err with pipes.
+  dup2(spec.stdinFd, 0);
+  dup2(spec.stdoutFd, 1);
+  if (spec.redirectErrorStream) {
+    dup2(spec.stdoutFd, 2);
+  } else {
+    dup2(spec.stderrFd, 2);
+  }
+
+  // Make the status pipe automatically close if exec succeeds.
+  fcntl(spec.statusFd, F_SETFD, FD_CLOEXEC);
+
+  // Close all other fds, including our copies of the pipes.
+  CloseNonStandardFds(spec.statusFd, spec.propertiesFd);
+
+  // Switch to working directory.
+  if (spec.workingDirectory != NULL) {
+    if (chdir(spec.workingDirectory) == -1) {
+      AbortChild(spec.statusFd);
+    }
+  }
+
+  // Execute process. By convention, the first argument in the arg array
+  // should be the command itself. We can't assign 'environ' because the parent would see it,
+  // so we pass the environment to execve(2) directly.
+  pthread_sigmask(SIG_SETMASK, &spec.signalMask, NULL);
+  ExecCandidates(spec.paths, spec.commands, spec.environment, spec.shellArgvs,
+                 spec.shellArgvStride);
+  AbortChild(spec.statusFd);
+}
+
+#if defined(__linux__)
+
+/*
+ * The launcher is an optional helper process, forked from us once, that starts children on our
+ * behalf. We send it a request over a SOCK_SEQPACKET socket: a LauncherRequest, then the
+ * command, environment and exec candidates as NUL-terminated strings, then the working
+ * directory if there is one. The child's ends of the four pipes come with the request, as
+ * SCM_RIGHTS. The reply is the new pid, or -errno.
+ *
+ * The launcher starts children with clone(2) using CLONE_PARENT, so they're our children rather
+ * than its own. Our waitpid(2) loop and kill(2) in Process.destroy work unchanged.
+ */
+struct LauncherRequest {
+  uint32_t commandCount;
+  uint32_t environmentCount;
+  uint32_t pathCount;
+  uint8_t hasWorkingDirectory;
+  uint8_t redirectErrorStream;
+};
+
+static const size_t LAUNCHER_REQUEST_MAX = 64 * 1024;
+static const size_t LAUNCHER_POINTERS_MAX = 8 * 1024;
+static const size_t LAUNCHER_STACK_SIZE = 64 * 1024;
+
+// The launcher can't allocate, so it mmaps all its memory up front.
+struct LauncherBuffers {
+  char request[LAUNCHER_REQUEST_MAX];
+  char* pointers[LAUNCHER_POINTERS_MAX];
+  char stack[LAUNCHER_STACK_SIZE] __attribute__((aligned(16)));
+};
+
+// Room for the command, environment and paths as NULL-terminated arrays, plus a shell argv
+// (the shell, the path, the rest of the command, and a NULL) for each path.
+static uint64_t LauncherPointerCount(const LauncherRequest& header) {
+  return uint64_t(header.commandCount) + 1 + header.environmentCount + 1 + header.pathCount + 1 +
+      uint64_t(header.pathCount) * (header.commandCount + 2);
+}
+
+static pthread_mutex_t gLauncherMutex = PTHREAD_MUTEX_INITIALIZER;
+static int gLauncherFd = -1;
+static pid_t gLauncherPid = -1;
+
+static int LauncherChild(void* arg) {
+  RunChild(*static_cast<ChildSpec*>(arg));
+  return 0;
+}
+
+// Splits 'count' strings off the front of [*p, end) into 'out', NULL-terminated.
+static bool ParseStrings(char** p, char* end, uint32_t count, char** out) {
+  for (uint32_t i = 0; i < count; ++i) {
+    char* nul = static_cast<char*>(memchr(*p, '\0', end - *p));
+    if (nul == NULL) {
+      return false;
+    }
+    out[i] = *p;
+    *p = nul + 1;
+  }
+  out[count] = NULL;
+  return true;
+}
+
+static int32_t LaunchFromRequest(LauncherBuffers* buffers, size_t byteCount, int fds[4],
+                                 int propertiesFd) {
+  LauncherRequest header;
+  if (byteCount < sizeof(header)) {
+    return -EINVAL;
+  }
+  memcpy(&header, buffers->request, sizeof(header));
+  uint64_t pointerCount = LauncherPointerCount(header);
+  if (header.commandCount == 0 || pointerCount > LAUNCHER_POINTERS_MAX) {
+    return -E2BIG;
+  }
+
+  char* p = buffers->request + sizeof(header);
+  char* end = buffers->request + byteCount;
+  char** commands = buffers->pointers;
+  char** environment = commands + header.commandCount + 1;
+  char** paths = environment + header.environmentCount + 1;
+  char** shellArgvs = paths + header.pathCount + 1;
+  char* workingDirectory[1];
+  if (!ParseStrings(&p, end, header.commandCount, commands) ||
+      !ParseStrings(&p, end, header.environmentCount, environment) ||
+      !ParseStrings(&p, end, header.pathCount, paths) ||
+      (header.hasWorkingDirectory && !ParseStrings(&p, end, 1, workingDirectory))) {
+    return -EINVAL;
+  }
+  size_t shellArgvStride = header.commandCount + 2;
+  for (uint32_t i = 0; i < header.pathCount; ++i) {
+    char** shellArgv = shellArgvs + i * shellArgvStride;
+    shellArgv[0] = const_cast<char*>(_PATH_BSHELL);
+    shellArgv[1] = paths[i];
+    // The rest of the arguments, and their NULL terminator.
+    memcpy(shellArgv + 2, commands + 1, header.commandCount * sizeof(char*));
+  }
+
+  ChildSpec spec;
+  spec.stdinFd = fds[0];
+  spec.stdoutFd = fds[1];
+  spec.stderrFd = fds[2];
+  spec.statusFd = fds[3];
+  spec.redirectErrorStream = header.redirectErrorStream;
+  spec.workingDirectory = header.hasWorkingDirectory ? workingDirectory[0] : NULL;
+  spec.commands = commands;
+  spec.environment = environment;
+  spec.paths = paths;
+  spec.shellArgvs = shellArgvs;
+  spec.shellArgvStride = shellArgvStride;
+  spec.propertiesFd = propertiesFd;
+
+  // CLONE_VFORK means we don't return until the child has exec'ed or exited.
+  BlockAllSignals(&spec.signalMask);
+  pid_t pid = clone(LauncherChild, buffers->stack + LAUNCHER_STACK_SIZE,
+                    CLONE_VM | CLONE_VFORK | CLONE_PARENT | SIGCHLD, &spec);
+  int cloneErrno = errno;
+  pthread_sigmask(SIG_SETMASK, &spec.signalMask, NULL);
+  return (pid == -1) ? -cloneErrno : pid;
+}
+
+// The launcher's main loop. We're a fork(2) of a multi-threaded process, so this must not
+// allocate either.
+//
+// We don't outlive the process we're serving: when it exits, its end of the socket closes and
+// our recvmsg sees EOF. (PR_SET_PDEATHSIG would fire when the *thread* that forked us exits,
+// which can be any thread that happened to use ProcessManager first.) If it died before we got
+// this far, we've been reparented and it has no need of us.
+static void RunLauncher(int socketFd, int propertiesFd, pid_t parentPid) {
+  if (getppid() != parentPid) {
+    _exit(0);
+  }
+  CloseNonStandardFds(socketFd, propertiesFd);
+
+  void* memory = mmap(NULL, sizeof(LauncherBuffers), PROT_READ | PROT_WRITE,
+                      MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if (memory == MAP_FAILED) {
+    _exit(1);
+  }
+  LauncherBuffers* buffers = static_cast<LauncherBuffers*>(memory);
+
+  while (true) {
+    iovec iov;
+    iov.iov_base = buffers->request;
+    iov.iov_len = sizeof(buffers->request);
+    char control[CMSG_SPACE(4 * sizeof(int))];
+    msghdr msg;
+    memset(&msg, 0, sizeof(msg));
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
+    msg.msg_control = control;
+    msg.msg_controllen = sizeof(control);
+    ssize_t byteCount = TEMP_FAILURE_RETRY(recvmsg(socketFd, &msg, 0));
+    if (byteCount <= 0) {
+      // Our parent has gone away.
+      _exit(0);
+    }
+
+    int fds[4] = { -1, -1, -1, -1 };
+    cmsghdr* cmsg = CMSG_FIRSTHDR(&msg);
+    bool haveFds = cmsg != NULL && cmsg->cmsg_level == SOL_SOCKET &&
+        cmsg->cmsg_type == SCM_RIGHTS && cmsg->cmsg_len == CMSG_LEN(sizeof(fds));
+    if (haveFds) {
+      memcpy(fds, CMSG_DATA(cmsg), sizeof(fds));
+    }
+
+    int32_t reply;
+    if (!haveFds || (msg.msg_flags & (MSG_TRUNC | MSG_CTRUNC)) != 0) {
+      reply = -EINVAL;
+    } else {
+      reply = LaunchFromRequest(buffers, byteCount, fds, propertiesFd);
+    }
+    // Our copies have to be closed before the reply, or our parent would never see EOF on the
+    // status pipe.
+    for (size_t i = 0; i < 4; ++i) {
+      if (fds[i] != -1) {
+        close(fds[i]);
+      }
+    }
+    if (TEMP_FAILURE_RETRY(send(socketFd, &reply, sizeof(reply), MSG_NOSIGNAL)) == -1) {
+      _exit(0);
+    }
+  }
+}
+
+static void AppendStrings(std::string& request, char** strings, uint32_t* count) {
+  *count = 0;
+  for (char** s = strings; *s != NULL; ++s) {
+    request.append(*s, strlen(*s) + 1);
+    ++*count;
+  }
+}
+
+static void StopLauncher() {
+  close(gLauncherFd);
+  gLauncherFd = -1;
+  gLauncherPid = -1;
+}
+
+/*
+ * Starts the child described by 'spec' via the launcher, if it's running. Returns false if the
+ * caller should fall back to vfork(2). Otherwise *childPid is the new pid, or -1 with errno set.
+ */
+static bool LaunchWithLauncher(const ChildSpec& spec, pid_t* childPid) {
+  ScopedPthreadMutexLock lock(&gLauncherMutex);
+  if (gLauncherFd == -1) {
+    return false;
+  }
+
+  LauncherRequest header;
+  memset(&header, 0, sizeof(header));
+  header.hasWorkingDirectory = (spec.workingDirectory != NULL);
+  header.redirectErrorStream = spec.redirectErrorStream;
+  std::string request(sizeof(header), '\0');
+  AppendStrings(request, spec.commands, &header.commandCount);
+  AppendStrings(request, spec.environment, &header.environmentCount);
+  AppendStrings(request, spec.paths, &header.pathCount);
+  if (spec.workingDirectory != NULL) {
+    request.append(spec.workingDirectory, strlen(spec.workingDirectory) + 1);
+  }
+  if (request.size() > LAUNCHER_REQUEST_MAX ||
+      LauncherPointerCount(header) > LAUNCHER_POINTERS_MAX) {
+    // Too big for the launcher's fixed buffers.
+    return false;
+  }
+  memcpy(&request[0], &header, sizeof(header));
+
+  int fds[4] = { spec.stdinFd, spec.stdoutFd, spec.stderrFd, spec.statusFd };
+  iovec iov;
+  iov.iov_base = &request[0];
+  iov.iov_len = request.size();
+  char control[CMSG_SPACE(sizeof(fds))];
+  memset(control, 0, sizeof(control));
+  msghdr msg;
+  memset(&msg, 0, sizeof(msg));
+  msg.msg_iov = &iov;
+  msg.msg_iovlen = 1;
+  msg.msg_control = control;
+  msg.msg_controllen = sizeof(control);
+  cmsghdr* cmsg = CMSG_FIRSTHDR(&msg);
+  cmsg->cmsg_level = SOL_SOCKET;
+  cmsg->cmsg_type = SCM_RIGHTS;
+  cmsg->cmsg_len = CMSG_LEN(sizeof(fds));
+  memcpy(CMSG_DATA(cmsg), fds, sizeof(fds));
+
+  int32_t reply;
+  if (TEMP_FAILURE_RETRY(sendmsg(gLauncherFd, &msg, MSG_NOSIGNAL)) == -1 ||
+      TEMP_FAILURE_RETRY(recv(gLauncherFd, &reply, sizeof(reply), 0)) != sizeof(reply)) {
+    ALOGW("process launcher failed, falling back to vfork: %s", strerror(errno));
+    StopLauncher();
+    return false;
+  }
+  if (reply < 0) {
+    errno = -reply;
+    *childPid = -1;
+  } else {
+    *childPid = reply;
+  }
+  return true;
+}
+
+#endif
+
+/*
+ * Forks the launcher, if it isn't already running, and returns its pid (or -1). This is the
+ * only time we pay for copying our page tables; after this, children are started by a process
+ * that isn't running the VM.
+ */
+static jint ProcessManager_startLauncher(JNIEnv*, jclass) {
+#if defined(__linux__)
+  ScopedPthreadMutexLock lock(&gLauncherMutex);
+  if (gLauncherFd != -1) {
+    return gLauncherPid;
+  }
+  int fds[2];
+  if (socketpair(AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC, 0, fds) == -1) {
+    ALOGW("couldn't create process launcher socket: %s", strerror(errno));
+    return -1;
+  }
+  int propertiesFd = PropertiesFd();
+  pid_t parentPid = getpid();
+  pid_t pid = fork();
+  if (pid == -1) {
+    ALOGW("couldn't fork process launcher: %s", strerror(errno));
+    close(fds[0]);
+    close(fds[1]);
+    return -1;
+  }
+  if (pid == 0) {
+    RunLauncher(fds[1], propertiesFd, parentPid);
+  }
+  close(fds[1]);
+  gLauncherFd = fds[0];
+  gLauncherPid = pid;
+  return pid;
+#else
+  return -1;
+#endif
+}
+
 /** Executes a command in a child process. */
 static pid_t ExecuteProcess(JNIEnv* env, char** commands, char** environment,
                             const char* workingDirectory, jobject inDescriptor,
@@ -108,58 +644,52 @@ static pid_t ExecuteProcess(JNIEnv* env, char** commands, char** environment,
   int statusIn = pipes[6];
   int statusOut = pipes[7];
 
-  pid_t childPid = fork();
+  if (environment == NULL) {
+    extern char** environ; // Standard, but not in any header file.
+    environment = environ;
+  }
+  ExecPlan plan;
+  PlanExec(commands, environment, &plan);
+
+  ChildSpec spec;
+  spec.stdinFd = stdinIn;
+  spec.stdoutFd = stdoutOut;
+  spec.stderrFd = stderrOut;
+  spec.statusFd = statusOut;
+  spec.redirectErrorStream = redirectErrorStream;
+  spec.workingDirectory = workingDirectory;
+  spec.commands = commands;
+  spec.environment = environment;
+  spec.paths = &plan.pathPointers[0];
+  spec.shellArgvs = plan.shellArgvs.empty() ? NULL : &plan.shellArgvs[0];
+  spec.shellArgvStride = plan.shellArgvStride;
+  spec.propertiesFd = PropertiesFd();
+
+  pid_t childPid;
+  bool launched = false;
+#if defined(__linux__)
+  launched = LaunchWithLauncher(spec, &childPid);
+#endif
+  if (!launched) {
+    // vfork(2) doesn't copy our page tables, so it costs the same however big the heap is.
+    // The child runs on our memory, so no signal may be handled there until it has exec'ed.
+    BlockAllSignals(&spec.signalMask);
+    childPid = vfork();
+    if (childPid == 0) {
+      RunChild(spec);
+    }
+    int vforkErrno = errno;
+    pthread_sigmask(SIG_SETMASK, &spec.signalMask, NULL);
+    errno = vforkErrno;
+  }
 
-  // If fork() failed...
+  // If we couldn't start a child...
   if (childPid == -1) {
     jniThrowIOException(env, errno);
     ClosePipes(pipes, -1);
     return -1;
   }
 
-  // If this is the child process...
-  if (childPid == 0) {
-    // Note: We cannot malloc(3) or free(3) after this point!
-    // A thread in the parent that no longer exists in the child may have held the heap lock
-    // when we forked, so an attempt to malloc(3) or free(3) would result in deadlock.
-
-    // Replace stdin, out, and err with pipes.
-    dup2(stdinIn, 0);
-    dup2(stdoutOut, 1);
-    if (redirectErrorStream) {
-      dup2(stdoutOut, 2);
-    } else {
-      dup2(stderrOut, 2);
-    }
-
-    // Close all but statusOut. This saves some work in the next step.
-    ClosePipes(pipes, statusOut);
-
-    // Make statusOut automatically close if execvp() succeeds.
-    fcntl(statusOut, F_SETFD, FD_CLOEXEC);
-
-    // Close remaining unwanted open fds.
-    CloseNonStandardFds(statusOut);
-
-    // Switch to working directory.
-    if (workingDirectory != NULL) {
-      if (chdir(workingDirectory) == -1) {
-        AbortChild(statusOut);
-      }
-    }
-
-    // Set up environment.
-    if (environment != NULL) {
-      extern char** environ; // Standard, but not in any header file.
-      environ = environment;
-    }
-
-    // Execute process. By convention, the first argument in the arg array
-    // should be the command itself.
-    execvp(commands[0], commands);
-    AbortChild(statusOut);
-  }
-
   // This is the parent process.
 
   // Close child's pipe ends.
@@ -210,7 +740,13 @@ static pid_t ProcessManager_exec(JNIEnv* env, jclass, jobjectArray javaCommands,
                                  jboolean redirectErrorStream) {
 
   ExecStrings commands(env, javaCommands);
+  if (env->ExceptionCheck()) {
+    return -1;
+  }
   ExecStrings environment(env, javaEnvironment);
+  if (env->ExceptionCheck()) {
+    return -1;
+  }
 
   // Extract working directory string.
   const char* workingDirectory = NULL;
@@ -230,6 +766,7 @@ static pid_t ProcessManager_exec(JNIEnv* env, jclass, jobjectArray javaCommands,
 }
 
 static JNINativeMethod gMethods[] = {
+  NATIVE_METHOD(ProcessManager, startLauncher, "()I"),
   NATIVE_METHOD(ProcessManager, exec, "([Ljava/lang/String;[Ljava/lang/String;Ljava/lang/String;Ljava/io/FileDescriptor;Ljava/io/FileDescriptor;Ljava/io/FileDescriptor;Z)I"),
 };
 void register_java_lang_ProcessManager(JNIEnv* env) {
@@ -17,225 +17,358 @@
 
 #define LOG_TAG "RealToString"
 
+#include <stdint.h>
 #include <string.h>
-#include <math.h>
-#include <stdlib.h>
 
 #include "JNIHelp.h"
 #include "JniConstants.h"
-#include "ScopedLocalRef.h"
+#include "PowersOfFive.h"
 #include "ScopedPrimitiveArray.h"
-#include "cbigint.h"
 
-#define INV_LOG_OF_TEN_BASE_2 (0.30102999566398114) /* Local */
+/*
+ * The shortest correctly rounded decimal digits for a double or float, using Ulf Adams' Ryu
+ * ("Ryu: Fast Float-to-String Conversion", PLDI 2018). This replaces the Burger-Dybvig digit
+ * generators, which did bignum arithmetic (or, in Java, repeated long division) for every
+ * conversion. Ryu needs only a few 64x128-bit multiplications with precomputed powers of five.
+ * It keeps no state between calls and writes its digits straight into the caller's array.
+ *
+ * Floats go through the same code as doubles. The algorithm is exact for any significand of
+ * up to 53 bits, and a float's rounding interval is exactly representable at double
+ * precision.
+ */
 
-/*NB the Number converter methods are synchronized so it is possible to
- *have global data for use by bigIntDigitGenerator */
-#define RM_SIZE 21     /* Local. */
-#define STemp_SIZE 22  /* Local. */
+static inline uint32_t pow5bits(int32_t e) {
+  // ceil(log2(5^e)), for 0 <= e <= 3528.
+  return static_cast<uint32_t>(((e * 1217359) >> 19) + 1);
+}
 
-/* The algorithm for this particular function can be found in:
- *
- *      Printing Floating-Point Numbers Quickly and Accurately, Robert
- *      G. Burger, and R. Kent Dybvig, Programming Language Design and
- *      Implementation (PLDI) 1996, pp.108-116.
- *
- * The previous implementation of this function combined m+ and m- into
- * one single M which caused some inaccuracy of the last digit. The
- * particular case below shows this inaccuracy:
- *
- *       System.out.println(new Double((1.234123412431233E107)).toString());
- *       System.out.println(new Double((1.2341234124312331E107)).toString());
- *       System.out.println(new Double((1.2341234124312332E107)).toString());
- *
- *       outputs the following:
- *
- *           1.234123412431233E107
- *           1.234123412431233E107
- *           1.234123412431233E107
- *
- *       instead of:
- *
- *           1.234123412431233E107
- *           1.2341234124312331E107
- *           1.2341234124312331E107
- *
+static inline uint32_t log10Pow2(int32_t e) {
+  // floor(log10(2^e)), for 0 <= e <= 1650.
+  return static_cast<uint32_t>((e * 78913) >> 18);
+}
+
+static inline uint32_t log10Pow5(int32_t e) {
+  // floor(log10(5^e)), for 0 <= e <= 2620.
+  return static_cast<uint32_t>((e * 732923) >> 20);
+}
+
+static inline bool multipleOfPowerOf5(uint64_t value, uint32_t p) {
+  uint32_t count = 0;
+  while (value % 5 == 0) {
+    value /= 5;
+    ++count;
+  }
+  return count >= p;
+}
+
+static inline bool multipleOfPowerOf2(uint64_t value, uint32_t p) {
+  return (value & ((UINT64_C(1) << p) - 1)) == 0;
+}
+
+/* Returns the high 64 bits of a * b, and stores the low 64 bits in *low. */
+static inline uint64_t multiplyFull(uint64_t a, uint64_t b, uint64_t* low) {
+#if defined(__SIZEOF_INT128__)
+  unsigned __int128 product = static_cast<unsigned __int128>(a) * b;
+  *low = static_cast<uint64_t>(product);
+  return static_cast<uint64_t>(product >> 64);
+#else
+  uint64_t aLo = a & 0xFFFFFFFF, aHi = a >> 32;
+  uint64_t bLo = b & 0xFFFFFFFF, bHi = b >> 32;
+  uint64_t lolo = aLo * bLo;
+  uint64_t hilo = aHi * bLo;
+  uint64_t lohi = aLo * bHi;
+  uint64_t hihi = aHi * bHi;
+  uint64_t middle = (lolo >> 32) + (hilo & 0xFFFFFFFF) + lohi;
+  *low = (middle << 32) | (lolo & 0xFFFFFFFF);
+  return hihi + (hilo >> 32) + (middle >> 32);
+#endif
+}
+
+/* Returns (m * mul) >> j, where mul is a 128-bit (low, high) pair and 64 < j < 128. */
+static inline uint64_t mulShift(uint64_t m, const uint64_t* mul, int32_t j) {
+  uint64_t low0;
+  uint64_t high0 = multiplyFull(m, mul[0], &low0);
+  uint64_t low1;
+  uint64_t high1 = multiplyFull(m, mul[1], &low1);
+  uint64_t sum = high0 + low1;
+  if (sum < high0) {
+    ++high1;
+  }
+  int32_t shift = j - 64;
+  return (high1 << (64 - shift)) | (sum >> shift);
+}
+
+/*
+ * Finds the shortest decimal in the rounding interval of m2 * 2^(e2 + 2), preferring the one
+ * nearest the exact value. The interval runs half a unit either side, except that it only extends
+ * a quarter unit below when 'symmetric' is false (for powers of two, whose predecessor is closer).
+ * Its bounds are included if m2 is even, as round-half-even would parse them back to this value.
+ * Returns the decimal significand and stores its power of ten in *exponent.
  */
-void RealToString_bigIntDigitGenerator(JNIEnv* env, jobject obj, jlong f, jint e,
-        jboolean isDenormalized, jint p) {
-  int RLength, SLength, TempLength, mplus_Length, mminus_Length;
-  int high, low, i;
-  jint k, firstK, U;
-
-  uint64_t R[RM_SIZE], S[STemp_SIZE], mplus[RM_SIZE], mminus[RM_SIZE], Temp[STemp_SIZE];
-
-  memset (R     , 0, RM_SIZE    * sizeof (uint64_t));
-  memset (S     , 0, STemp_SIZE * sizeof (uint64_t));
-  memset (mplus , 0, RM_SIZE    * sizeof (uint64_t));
-  memset (mminus, 0, RM_SIZE    * sizeof (uint64_t));
-  memset (Temp  , 0, STemp_SIZE * sizeof (uint64_t));
-
-  if (e >= 0)
-    {
-      *R = f;
-      *mplus = *mminus = 1;
-      simpleShiftLeftHighPrecision (mminus, RM_SIZE, e);
-      if (f != (2 << (p - 1)))
-        {
-          simpleShiftLeftHighPrecision (R, RM_SIZE, e + 1);
-          *S = 2;
-          /*
-           * m+ = m+ << e results in 1.0e23 to be printed as
-           * 0.9999999999999999E23
-           * m+ = m+ << e+1 results in 1.0e23 to be printed as
-           * 1.0e23 (caused too much rounding)
-           *      470fffffffffffff = 2.0769187434139308E34
-           *      4710000000000000 = 2.076918743413931E34
-           */
-          simpleShiftLeftHighPrecision (mplus, RM_SIZE, e);
-        }
-      else
-        {
-          simpleShiftLeftHighPrecision (R, RM_SIZE, e + 2);
-          *S = 4;
-          simpleShiftLeftHighPrecision (mplus, RM_SIZE, e + 1);
-        }
-    }
-  else
-    {
-      if (isDenormalized || (f != (2 << (p - 1))))
-        {
-          *R = f << 1;
-          *S = 1;
-          simpleShiftLeftHighPrecision (S, STemp_SIZE, 1 - e);
-          *mplus = *mminus = 1;
-        }
-      else
-        {
-          *R = f << 2;
-          *S = 1;
-          simpleShiftLeftHighPrecision (S, STemp_SIZE, 2 - e);
-          *mplus = 2;
-          *mminus = 1;
-        }
-    }
-
-  k = static_cast<int>(ceil ((e + p - 1) * INV_LOG_OF_TEN_BASE_2 - 1e-10));
-
-  if (k > 0)
-    {
-      timesTenToTheEHighPrecision (S, STemp_SIZE, k);
-    }
-  else
-    {
-      timesTenToTheEHighPrecision (R     , RM_SIZE, -k);
-      timesTenToTheEHighPrecision (mplus , RM_SIZE, -k);
-      timesTenToTheEHighPrecision (mminus, RM_SIZE, -k);
-    }
-
-  RLength = mplus_Length = mminus_Length = RM_SIZE;
-  SLength = TempLength = STemp_SIZE;
-
-  memset (Temp + RM_SIZE, 0, (STemp_SIZE - RM_SIZE) * sizeof (uint64_t));
-  memcpy (Temp, R, RM_SIZE * sizeof (uint64_t));
-
-  while (RLength > 1 && R[RLength - 1] == 0)
-    --RLength;
-  while (mplus_Length > 1 && mplus[mplus_Length - 1] == 0)
-    --mplus_Length;
-  while (mminus_Length > 1 && mminus[mminus_Length - 1] == 0)
-    --mminus_Length;
-  while (SLength > 1 && S[SLength - 1] == 0)
-    --SLength;
-  TempLength = (RLength > mplus_Length ? RLength : mplus_Length) + 1;
-  addHighPrecision (Temp, TempLength, mplus, mplus_Length);
-
-  if (compareHighPrecision (Temp, TempLength, S, SLength) >= 0)
-    {
-      firstK = k;
-    }
-  else
-    {
-      firstK = k - 1;
-      simpleAppendDecimalDigitHighPrecision (R     , ++RLength      , 0);
-      simpleAppendDecimalDigitHighPrecision (mplus , ++mplus_Length , 0);
-      simpleAppendDecimalDigitHighPrecision (mminus, ++mminus_Length, 0);
-      while (RLength > 1 && R[RLength - 1] == 0)
-        --RLength;
-      while (mplus_Length > 1 && mplus[mplus_Length - 1] == 0)
-        --mplus_Length;
-      while (mminus_Length > 1 && mminus[mminus_Length - 1] == 0)
-        --mminus_Length;
-    }
-
-  static jfieldID digitsFid = env->GetFieldID(JniConstants::realToStringClass, "digits", "[I");
-  ScopedLocalRef<jintArray> javaDigits(env, reinterpret_cast<jintArray>(env->GetObjectField(obj, digitsFid)));
-  ScopedIntArrayRW digits(env, javaDigits.get());
+static uint64_t shortestDecimal(uint64_t m2, int32_t e2, bool symmetric, int32_t* exponent) {
+  const bool acceptBounds = (m2 & 1) == 0;
+  const uint64_t mv = 4 * m2;
+  const uint32_t mmShift = symmetric ? 1 : 0;
+
+  // Step 1: Compute mv, and the interval bounds mp and mm, times a power of ten, rounded down
+  // except where we know them to be exact.
+  uint64_t vr, vp, vm;
+  int32_t e10;
+  bool vmIsTrailingZeros = false;
+  bool vrIsTrailingZeros = false;
+  if (e2 >= 0) {
+    const uint32_t q = log10Pow2(e2) - (e2 > 3);
+    e10 = static_cast<int32_t>(q);
+    const int32_t k = POW5_INV_BIT_COUNT + pow5bits(q) - 1;
+    const int32_t i = -e2 + static_cast<int32_t>(q) + k;
+    vr = mulShift(4 * m2, POW5_INV_SPLIT[q], i);
+    vp = mulShift(4 * m2 + 2, POW5_INV_SPLIT[q], i);
+    vm = mulShift(4 * m2 - 1 - mmShift, POW5_INV_SPLIT[q], i);
+    if (q <= 21) {
+      // Only one of mp, mv and mm can be a multiple of 5, if any.
+      if (mv % 5 == 0) {
+        vrIsTrailingZeros = multipleOfPowerOf5(mv, q);
+      } else if (acceptBounds) {
+        vmIsTrailingZeros = multipleOfPowerOf5(mv - 1 - mmShift, q);
+      } else {
+        vp -= multipleOfPowerOf5(mv + 2, q);
+      }
+    }
+  } else {
+    const uint32_t q = log10Pow5(-e2) - (-e2 > 1);
+    e10 = static_cast<int32_t>(q) + e2;
+    const int32_t i = -e2 - static_cast<int32_t>(q);
+    const int32_t k = pow5bits(i) - POW5_BIT_COUNT;
+    const int32_t j = static_cast<int32_t>(q) - k;
+    vr = mulShift(4 * m2, POW5_SPLIT[i], j);
+    vp = mulShift(4 * m2 + 2, POW5_SPLIT[i], j);
+    vm = mulShift(4 * m2 - 1 - mmShift, POW5_SPLIT[i], j);
+    if (q <= 1) {
+      // mv has at least q trailing zero bits, so vr is exact. So is vm, which has mmShift
+      // fewer bits of the interval below it, and vp, which we must exclude if we can't accept it.
+      vrIsTrailingZeros = true;
+      if (acceptBounds) {
+        vmIsTrailingZeros = mmShift == 1;
+      } else {
+        --vp;
+      }
+    } else if (q < 63) {
+      vrIsTrailingZeros = multipleOfPowerOf2(mv, q);
+    }
+  }
+
+  // Step 2: Remove digits while the bounds still differ, tracking the last digit removed from
+  // vr so we can round correctly.
+  int32_t removed = 0;
+  uint8_t lastRemovedDigit = 0;
+  uint64_t output;
+  if (vmIsTrailingZeros || vrIsTrailingZeros) {
+    // The rare general case.
+    while (vp / 10 > vm / 10) {
+      vmIsTrailingZeros &= vm % 10 == 0;
+      vrIsTrailingZeros &= lastRemovedDigit == 0;
+      lastRemovedDigit = static_cast<uint8_t>(vr % 10);
+      vr /= 10;
+      vp /= 10;
+      vm /= 10;
+      ++removed;
+    }
+    if (vmIsTrailingZeros) {
+      while (vm % 10 == 0) {
+        vrIsTrailingZeros &= lastRemovedDigit == 0;
+        lastRemovedDigit = static_cast<uint8_t>(vr % 10);
+        vr /= 10;
+        vp /= 10;
+        vm /= 10;
+        ++removed;
+      }
+    }
+    if (vrIsTrailingZeros && lastRemovedDigit == 5 && vr % 2 == 0) {
+      // Exactly halfway: round to even.
+      lastRemovedDigit = 4;
+    }
+    output = vr + ((vr == vm && (!acceptBounds || !vmIsTrailingZeros)) || lastRemovedDigit >= 5);
+  } else {
+    // The common case, where no bound is exact.
+    bool roundUp = false;
+    if (vp / 100 > vm / 100) {
+      roundUp = vr % 100 >= 50;
+      vr /= 100;
+      vp /= 100;
+      vm /= 100;
+      removed += 2;
+    }
+    while (vp / 10 > vm / 10) {
+      roundUp = vr % 10 >= 5;
+      vr /= 10;
+      vp /= 10;
+      vm /= 10;
+      ++removed;
+    }
+    output = vr + (vr == vm || roundUp);
+  }
+  *exponent = e10 + removed;
+  return output;
+}
+
+/*
+ * Writes the shortest digits of f * 2^e to 'javaDigits', most significant first, where f has at
+ * most 53 significant bits. Returns the number of digits in the low 8 bits of the result and,
+ * in the rest, the power of ten of the first digit.
+ */
+static jint RealToString_shortestDigits(JNIEnv* env, jclass, jlong f, jint e, jboolean symmetric,
+        jintArray javaDigits) {
+  int32_t exponent;
+  uint64_t output = shortestDecimal(static_cast<uint64_t>(f), e - 2, symmetric, &exponent);
+
+  jint digitCount = 1;
+  for (uint64_t rest = output / 10; rest != 0; rest /= 10) {
+    ++digitCount;
+  }
+  ScopedIntArrayRW digits(env, javaDigits);
   if (digits.get() == NULL) {
-    return;
-  }
-
-  jint digitCount = 0;
-  do
-    {
-      U = 0;
-      for (i = 3; i >= 0; --i)
-        {
-          TempLength = SLength + 1;
-          Temp[SLength] = 0;
-          memcpy (Temp, S, SLength * sizeof (uint64_t));
-          simpleShiftLeftHighPrecision (Temp, TempLength, i);
-          if (compareHighPrecision (R, RLength, Temp, TempLength) >= 0)
-            {
-              subtractHighPrecision (R, RLength, Temp, TempLength);
-              U += 1 << i;
-            }
-        }
-
-      low = compareHighPrecision (R, RLength, mminus, mminus_Length) <= 0;
-
-      memset (Temp + RLength, 0, (STemp_SIZE - RLength) * sizeof (uint64_t));
-      memcpy (Temp, R, RLength * sizeof (uint64_t));
-      TempLength = (RLength > mplus_Length ? RLength : mplus_Length) + 1;
-      addHighPrecision (Temp, TempLength, mplus, mplus_Length);
-
-      high = compareHighPrecision (Temp, TempLength, S, SLength) >= 0;
-
-      if (low || high)
-        break;
-
-      simpleAppendDecimalDigitHighPrecision (R     , ++RLength      , 0);
-      simpleAppendDecimalDigitHighPrecision (mplus , ++mplus_Length , 0);
-      simpleAppendDecimalDigitHighPrecision (mminus, ++mminus_Length, 0);
-      while (RLength > 1 && R[RLength - 1] == 0)
-        --RLength;
-      while (mplus_Length > 1 && mplus[mplus_Length - 1] == 0)
-        --mplus_Length;
-      while (mminus_Length > 1 && mminus[mminus_Length - 1] == 0)
-        --mminus_Length;
-      digits[digitCount++] = U;
-    }
-  while (1);
-
-  simpleShiftLeftHighPrecision (R, ++RLength, 1);
-  if (low && !high)
-    digits[digitCount++] = U;
-  else if (high && !low)
-    digits[digitCount++] = U + 1;
-  else if (compareHighPrecision (R, RLength, S, SLength) < 0)
-    digits[digitCount++] = U;
-  else
-    digits[digitCount++] = U + 1;
-
-  static jfieldID digitCountFid = env->GetFieldID(JniConstants::realToStringClass, "digitCount", "I");
-  env->SetIntField(obj, digitCountFid, digitCount);
-
-  static jfieldID firstKFid = env->GetFieldID(JniConstants::realToStringClass, "firstK", "I");
-  env->SetIntField(obj, firstKFid, firstK);
+    return 0;
+  }
+  for (jint i = digitCount - 1; i >= 0; --i) {
+    digits[i] = static_cast<jint>(output % 10);
+    output /= 10;
+  }
+  jint firstK = exponent + digitCount - 1;
+  return (firstK << 8) | digitCount;
+}
+
+/*
+ * Formats 'd' into 'dst' exactly as Double.toString would, returning the number of chars written.
+ * 'dst' must have room for MAX_DOUBLE_CHARS.
+ */
+static const size_t MAX_DOUBLE_CHARS = 24;  // "-2.2250738585072014E-308"
+
+static size_t formatDouble(jdouble d, char* dst) {
+  uint64_t bits;
+  memcpy(&bits, &d, sizeof(bits));
+  const bool negative = (bits >> 63) != 0;
+  const int32_t e = static_cast<int32_t>((bits >> 52) & 0x7ff);
+  uint64_t f = bits & ((UINT64_C(1) << 52) - 1);
+
+  const char* quickResult = NULL;
+  if (e == 0x7ff) {
+    quickResult = (f != 0) ? "NaN" : (negative ? "-Infinity" : "Infinity");
+  } else if (e == 0 && f == 0) {
+    quickResult = negative ? "-0.0" : "0.0";
+  } else if (e == 0 && f == 1) {
+    // See RealToString.convertDouble.
+    quickResult = negative ? "-4.9E-324" : "4.9E-324";
+  }
+  if (quickResult != NULL) {
+    size_t length = strlen(quickResult);
+    memcpy(dst, quickResult, length);
+    return length;
+  }
+
+  const bool symmetric = f != 0 || e <= 1;
+  int32_t pow;
+  if (e == 0) {
+    pow = -1074;
+  } else {
+    f |= UINT64_C(1) << 52;
+    pow = e - 1075;
+  }
+  int32_t exponent;
+  uint64_t output = shortestDecimal(f, pow - 2, symmetric, &exponent);
+  char digits[20];
+  int32_t digitCount = 0;
+  for (; output != 0; output /= 10) {
+    digits[digitCount++] = static_cast<char>('0' + output % 10);
+  }
+  // 'digits' is least significant first.
+  const int32_t firstK = exponent + digitCount - 1;
+
+  char* p = dst;
+  if (negative) {
+    *p++ = '-';
+  }
+  const double magnitude = negative ? -d : d;
+  if (magnitude >= 1e7 || magnitude < 1e-3) {
+    *p++ = digits[digitCount - 1];
+    *p++ = '.';
+    if (digitCount == 1) {
+      *p++ = '0';
+    }
+    for (int32_t i = digitCount - 2; i >= 0; --i) {
+      *p++ = digits[i];
+    }
+    *p++ = 'E';
+    int32_t k = firstK;
+    if (k < 0) {
+      *p++ = '-';
+      k = -k;
+    }
+    if (k >= 100) {
+      *p++ = static_cast<char>('0' + k / 100);
+    }
+    if (k >= 10) {
+      *p++ = static_cast<char>('0' + (k / 10) % 10);
+    }
+    *p++ = static_cast<char>('0' + k % 10);
+  } else if (firstK < 0) {
+    *p++ = '0';
+    *p++ = '.';
+    for (int32_t i = firstK + 1; i < 0; ++i) {
+      *p++ = '0';
+    }
+    for (int32_t i = digitCount - 1; i >= 0; --i) {
+      *p++ = digits[i];
+    }
+  } else {
+    // k counts down the power of ten of the digit being written.
+    int32_t i = digitCount - 1;
+    for (int32_t k = firstK; k >= 0; --k) {
+      *p++ = (i >= 0) ? digits[i--] : '0';
+    }
+    *p++ = '.';
+    if (i < 0) {
+      *p++ = '0';
+    }
+    for (; i >= 0; --i) {
+      *p++ = digits[i];
+    }
+  }
+  return p - dst;
+}
+
+static jint RealToString_formatDoublesImpl(JNIEnv* env, jclass, jdoubleArray javaSrc,
+        jint srcOffset, jint count, jbyteArray javaDst, jint dstOffset, jbyte delimiter) {
+  ScopedDoubleArrayRO src(env, javaSrc);
+  if (src.get() == NULL) {
+    return -1;
+  }
+  ScopedByteArrayRW dst(env, javaDst);
+  if (dst.get() == NULL) {
+    return -1;
+  }
+  const size_t dstLength = dst.size();
+  size_t offset = dstOffset;
+  for (jint i = 0; i < count; ++i) {
+    char formatted[MAX_DOUBLE_CHARS + 1];
+    size_t length = 0;
+    if (i > 0) {
+      formatted[length++] = static_cast<char>(delimiter);
+    }
+    length += formatDouble(src[srcOffset + i], formatted + length);
+    if (length > dstLength - offset) {
+      jniThrowExceptionFmt(env, "java/lang/ArrayIndexOutOfBoundsException",
+              "dst too small for %d values at offset %d", count, dstOffset);
+      return -1;
+    }
+    memcpy(dst.get() + offset, formatted, length);
+    offset += length;
+  }
+  return static_cast<jint>(offset - dstOffset);
 }
 
 static JNINativeMethod gMethods[] = {
-    NATIVE_METHOD(RealToString, bigIntDigitGenerator, "(JIZI)V"),
+    NATIVE_METHOD(RealToString, formatDoublesImpl, "([DII[BIB)I"),
+    NATIVE_METHOD(RealToString, shortestDigits, "(JIZ[I)I"),
 };
 void register_java_lang_RealToString(JNIEnv* env) {
     jniRegisterNativeMethods(env, "java/lang/RealToString", gMethods, NELEM(gMethods));
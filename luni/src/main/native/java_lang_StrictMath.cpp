@@ -21,6 +21,7 @@
 #include "jni.h"
 #include "JNIHelp.h"
 #include "JniConstants.h"
+#include "ScopedPrimitiveArray.h"
 
 static jdouble StrictMath_sin(JNIEnv*, jclass, jdouble a) {
     return ieee_sin(a);
@@ -42,12 +43,78 @@ static jdouble StrictMath_pow(JNIEnv*, jclass, jdouble a, jdouble b) {
     return ieee_pow(a,b);
 }
 
+// The array natives apply a function to in[offset, offset + length), writing the results to
+// the same range of 'out', which may be 'in' itself. The Java side checks the bounds. Each
+// element goes through the same fdlibm function as the scalar native, so the results are
+// bit-for-bit identical; these only save the JNI transition per element.
+template <double (*F)(double)>
+static void applyToArray(JNIEnv* env, jdoubleArray javaIn, jdoubleArray javaOut, jint offset,
+                         jint length) {
+    ScopedDoubleArrayRO in(env, javaIn);
+    if (in.get() == NULL) {
+        return;
+    }
+    ScopedDoubleArrayRW out(env, javaOut);
+    if (out.get() == NULL) {
+        return;
+    }
+    const jdouble* src = in.get() + offset;
+    jdouble* dst = out.get() + offset;
+    for (jint i = 0; i < length; ++i) {
+        dst[i] = F(src[i]);
+    }
+}
+
+template <double (*F)(double, double)>
+static void applyToArrays(JNIEnv* env, jdoubleArray javaX, jdoubleArray javaY,
+                          jdoubleArray javaOut, jint offset, jint length) {
+    ScopedDoubleArrayRO x(env, javaX);
+    if (x.get() == NULL) {
+        return;
+    }
+    ScopedDoubleArrayRO y(env, javaY);
+    if (y.get() == NULL) {
+        return;
+    }
+    ScopedDoubleArrayRW out(env, javaOut);
+    if (out.get() == NULL) {
+        return;
+    }
+    const jdouble* srcX = x.get() + offset;
+    const jdouble* srcY = y.get() + offset;
+    jdouble* dst = out.get() + offset;
+    for (jint i = 0; i < length; ++i) {
+        dst[i] = F(srcX[i], srcY[i]);
+    }
+}
+
+#define STRICT_MATH_ARRAY_FUNCTION(name) \
+    static void StrictMath_##name##Array(JNIEnv* env, jclass, jdoubleArray in, \
+                                         jdoubleArray out, jint offset, jint length) { \
+        applyToArray<ieee_##name>(env, in, out, offset, length); \
+    }
+
+STRICT_MATH_ARRAY_FUNCTION(cos)
+STRICT_MATH_ARRAY_FUNCTION(sin)
+STRICT_MATH_ARRAY_FUNCTION(sqrt)
+STRICT_MATH_ARRAY_FUNCTION(tan)
+
+static void StrictMath_powArray(JNIEnv* env, jclass, jdoubleArray x, jdoubleArray y,
+                                jdoubleArray out, jint offset, jint length) {
+    applyToArrays<ieee_pow>(env, x, y, out, offset, length);
+}
+
 static JNINativeMethod gMethods[] = {
     NATIVE_METHOD(StrictMath, cos, "!(D)D"),
+    NATIVE_METHOD(StrictMath, cosArray, "([D[DII)V"),
     NATIVE_METHOD(StrictMath, pow, "!(DD)D"),
+    NATIVE_METHOD(StrictMath, powArray, "([D[D[DII)V"),
     NATIVE_METHOD(StrictMath, sin, "!(D)D"),
+    NATIVE_METHOD(StrictMath, sinArray, "([D[DII)V"),
     NATIVE_METHOD(StrictMath, sqrt, "!(D)D"),
+    NATIVE_METHOD(StrictMath, sqrtArray, "([D[DII)V"),
     NATIVE_METHOD(StrictMath, tan, "!(D)D"),
+    NATIVE_METHOD(StrictMath, tanArray, "([D[DII)V"),
 };
 void register_java_lang_StrictMath(JNIEnv* env) {
     jniRegisterNativeMethods(env, "java/lang/StrictMath", gMethods, NELEM(gMethods));
@@ -15,12 +15,15 @@
  *  limitations under the License.
  */
 
+#include <float.h>
 #include <stdlib.h>
 #include <string.h>
 #include <math.h>
 #include "JNIHelp.h"
 #include "JniConstants.h"
 #include "JniException.h"
+#include "PowersOfFive.h"
+#include "ScopedPrimitiveArray.h"
 #include "ScopedUtfChars.h"
 #include "cbigint.h"
 
@@ -145,9 +148,191 @@ static jdouble doubleAlgorithm (JNIEnv* env, uint64_t * f, int32_t length, jint
 
 #define sizeOfTenToTheE(e) (((e) / 19) + 1)
 
+/* ****************** Eisel-Lemire fast path ****************** */
+
+/*
+ * Almost all inputs have at most 19 significant digits and a modest exponent. For those the
+ * correctly rounded result follows directly from a 64-bit significand and a 128-bit
+ * approximation of the power of ten, without any of the bignum arithmetic below: see Clinger's
+ * fast path, and Lemire, "Number Parsing at a Gigabyte per Second" (2021). We only fall back to
+ * the bignum code when the input has more digits than the fast path can be sure about, or when
+ * the result would be zero, subnormal or infinite, where the existing code's behavior is kept.
+ */
+
+struct BinaryFormat {
+  int mantissaBits;
+  int minimumExponent;
+  int infinitePower;
+  int minExponentRoundToEven;
+  int maxExponentRoundToEven;
+};
+
+static const BinaryFormat DOUBLE_FORMAT = { 52, -1023, 0x7FF, -4, 23 };
+static const BinaryFormat FLOAT_FORMAT = { 23, -127, 0xFF, -17, 10 };
+
+#define MAX_FAST_PATH_DIGITS 19
+
+/* Returns the high 64 bits of a * b, and stores the low 64 bits in *low. */
+static uint64_t multiplyFull(uint64_t a, uint64_t b, uint64_t* low) {
+#if defined(__SIZEOF_INT128__)
+  unsigned __int128 product = static_cast<unsigned __int128>(a) * b;
+  *low = static_cast<uint64_t>(product);
+  return static_cast<uint64_t>(product >> 64);
+#else
+  uint64_t aLo = a & 0xFFFFFFFF, aHi = a >> 32;
+  uint64_t bLo = b & 0xFFFFFFFF, bHi = b >> 32;
+  uint64_t lolo = aLo * bLo;
+  uint64_t hilo = aHi * bLo;
+  uint64_t lohi = aLo * bHi;
+  uint64_t hihi = aHi * bHi;
+  uint64_t middle = (lolo >> 32) + (hilo & 0xFFFFFFFF) + lohi;
+  *low = (middle << 32) | (lolo & 0xFFFFFFFF);
+  return hihi + (hilo >> 32) + (middle >> 32);
+#endif
+}
+
+/*
+ * Parses the leading MAX_FAST_PATH_DIGITS digits of 's' into *w, adjusting *e for any digits
+ * beyond those, and reports whether there were any. Returns false if 's' isn't all digits.
+ */
+static bool parseFastPathSignificand(const char* s, uint64_t* w, jint* e, bool* truncated) {
+  uint64_t value = 0;
+  int digits = 0;
+  for (; *s != '\0'; ++s, ++digits) {
+    if (*s < '0' || *s > '9') {
+      return false;
+    }
+    if (digits < MAX_FAST_PATH_DIGITS) {
+      value = value * 10 + (*s - '0');
+    }
+  }
+  *truncated = (digits > MAX_FAST_PATH_DIGITS);
+  if (*truncated) {
+    *e += digits - MAX_FAST_PATH_DIGITS;
+  }
+  *w = value;
+  return digits > 0;
+}
+
+/*
+ * Returns the IEEE bits for the correctly rounded w * 10^q, or -1 if the result would be zero,
+ * subnormal or infinite and the caller should use the slow path instead.
+ */
+static int64_t eiselLemire(uint64_t w, jint q, const BinaryFormat& format) {
+  if (w == 0 || q < SMALLEST_POWER_OF_FIVE || q > LARGEST_POWER_OF_FIVE) {
+    return -1;
+  }
+  int leadingZeros = __builtin_clzll(w);
+  w <<= leadingZeros;
+
+  // Multiply by the truncated 128-bit power of five, using the low word only when the high
+  // product leaves the bits we need in doubt.
+  const uint64_t* power = &POWERS_OF_FIVE_128[2 * (q - SMALLEST_POWER_OF_FIVE)];
+  uint64_t low;
+  uint64_t high = multiplyFull(w, power[0], &low);
+  const int bitPrecision = format.mantissaBits + 3;
+  const uint64_t precisionMask = UINT64_C(0xFFFFFFFFFFFFFFFF) >> bitPrecision;
+  if ((high & precisionMask) == precisionMask) {
+    uint64_t secondLow;
+    uint64_t secondHigh = multiplyFull(w, power[1], &secondLow);
+    low += secondHigh;
+    if (secondHigh > low) {
+      ++high;
+    }
+    // Still in doubt? Outside this range the table entries aren't exact, so don't guess.
+    if (low == UINT64_C(0xFFFFFFFFFFFFFFFF) && (q < -27 || q > 55)) {
+      return -1;
+    }
+  }
+
+  int upperBit = static_cast<int>(high >> 63);
+  int shift = upperBit + 64 - format.mantissaBits - 3;
+  uint64_t mantissa = high >> shift;
+  // floor(log2(10^q)) is ((217706 * q) >> 16), for q in our range.
+  int power2 = (((152170 + 65536) * q) >> 16) + 63 + upperBit - leadingZeros - format.minimumExponent;
+  if (power2 <= 0) {
+    return -1;
+  }
+
+  // A result exactly halfway between two floats can only arise for small q; round it to even.
+  if (low <= 1 && q >= format.minExponentRoundToEven && q <= format.maxExponentRoundToEven &&
+      (mantissa & 3) == 1 && (mantissa << shift) == high) {
+    mantissa &= ~UINT64_C(1);
+  }
+  mantissa += (mantissa & 1);
+  mantissa >>= 1;
+  if (mantissa >= (UINT64_C(2) << format.mantissaBits)) {
+    mantissa = UINT64_C(1) << format.mantissaBits;
+    ++power2;
+  }
+  mantissa &= ~(UINT64_C(1) << format.mantissaBits);
+  if (power2 >= format.infinitePower) {
+    return -1;
+  }
+  return static_cast<int64_t>(mantissa | (static_cast<uint64_t>(power2) << format.mantissaBits));
+}
+
+/*
+ * Returns the IEEE bits for the digits 's' times 10^e using the fast path, or -1 if the slow path
+ * is needed.
+ */
+static int64_t fastPathBits(const char* s, jint e, const BinaryFormat& format) {
+  uint64_t w;
+  bool truncated;
+  if (!parseFastPathSignificand(s, &w, &e, &truncated)) {
+    return -1;
+  }
+  int64_t bits = eiselLemire(w, e, format);
+  // If we dropped digits, the true significand lies strictly between w and w + 1, so the
+  // answer is only certain if both round the same way.
+  if (truncated && bits != -1 && bits != eiselLemire(w + 1, e, format)) {
+    return -1;
+  }
+  return bits;
+}
+
+static bool fastPathDouble(const char* s, jint e, jdouble* result) {
+#if FLT_EVAL_METHOD == 0
+  // Clinger's fast path: if both the significand and the power of ten are exactly
+  // representable, a single IEEE multiplication or division rounds correctly.
+  if (e >= -22 && e <= 22 && strlen(s) <= 15) {
+    uint64_t w;
+    bool truncated;
+    if (parseFastPathSignificand(s, &w, &e, &truncated)) {
+      jdouble value = static_cast<jdouble>(w);
+      *result = (e >= 0) ? value * doubleTenToTheE(e) : value / doubleTenToTheE(-e);
+      return true;
+    }
+    return false;
+  }
+#endif
+  int64_t bits = fastPathBits(s, e, DOUBLE_FORMAT);
+  if (bits == -1) {
+    return false;
+  }
+  DOUBLE_TO_LONGBITS(*result) = bits;
+  return true;
+}
+
+static bool fastPathFloat(const char* s, jint e, jfloat* result) {
+  int64_t bits = fastPathBits(s, e, FLOAT_FORMAT);
+  if (bits == -1) {
+    return false;
+  }
+  FLOAT_TO_INTBITS(*result) = static_cast<int32_t>(bits);
+  return true;
+}
+
+/* *********************************************************** */
+
 static jdouble createDouble(JNIEnv* env, const char* s, jint e) {
   /* assumes s is a null terminated string with at least one
    * character in it */
+  jdouble fastResult;
+  if (fastPathDouble(s, e, &fastResult)) {
+    return fastResult;
+  }
+
   uint64_t def[DEFAULT_DOUBLE_WIDTH];
   uint64_t defBackup[DEFAULT_DOUBLE_WIDTH];
   uint64_t* f;
@@ -584,6 +769,11 @@ static const uint32_t float_tens[] = {
     }
 
 static jfloat createFloat(JNIEnv* env, const char* s, jint e) {
+  jfloat fastResult;
+  if (fastPathFloat(s, e, &fastResult)) {
+    return fastResult;
+  }
+
   /* assumes s is a null terminated string with at least one
    * character in it */
   uint64_t def[DEFAULT_FLOAT_WIDTH];
@@ -1004,7 +1194,235 @@ static jdouble StringToReal_parseDblImpl(JNIEnv* env, jclass, jstring s, jint e)
     return createDouble(env, str.c_str(), e);
 }
 
+/*
+ * The batch parser accepts the same decimal syntax as StringToReal.parseDouble, including
+ * surrounding white space, a trailing 'd' or 'f', "NaN" and "Infinity", but not hexadecimal.
+ * It reduces each token to the significant digits and exponent that createDouble wants,
+ * applying the same range limits as StringToReal.initialParse.
+ */
+
+// Enough significant digits to round any double correctly, plus one for a sticky digit that
+// stands in for any nonzero digits beyond them.
+static const int MAX_SIGNIFICANT_DIGITS = 800;
+
+static inline bool isDigit(jint ch) {
+  return ch >= '0' && ch <= '9';
+}
+
+static inline bool isTrimmable(jint ch) {
+  // Bytes are signed, and those with the top bit set aren't white space.
+  return ch >= 0 && ch <= ' ';
+}
+
+template <typename CharT>
+static bool regionEquals(const CharT* p, const CharT* end, const char* s) {
+  for (; *s != '\0'; ++p, ++s) {
+    if (p == end || *p != *s) {
+      return false;
+    }
+  }
+  return p == end;
+}
+
+/*
+ * Parses [p, end). Returns false if it isn't a decimal number.
+ */
+template <typename CharT>
+static bool parseDecimalToken(JNIEnv* env, const CharT* p, const CharT* end, jdouble* result) {
+  // Trim white space the way String.trim does.
+  while (p < end && isTrimmable(*p)) {
+    ++p;
+  }
+  while (end > p && isTrimmable(end[-1])) {
+    --end;
+  }
+  if (p == end) {
+    return false;
+  }
+
+  bool negative = false;
+  if (*p == '-' || *p == '+') {
+    negative = (*p++ == '-');
+  }
+  if (regionEquals(p, end, "Infinity")) {
+    *result = negative ? -HUGE_VAL : HUGE_VAL;
+    return true;
+  } else if (regionEquals(p, end, "NaN")) {
+    *result = NAN;
+    return true;
+  }
+  if (end > p && (end[-1] == 'd' || end[-1] == 'D' || end[-1] == 'f' || end[-1] == 'F')) {
+    --end;
+  }
+
+  char digits[MAX_SIGNIFICANT_DIGITS + 2];
+  int digitCount = 0;
+  int64_t e = 0;
+  bool sawDigit = false;
+  bool sawPoint = false;
+  for (; p < end && (isDigit(*p) || *p == '.'); ++p) {
+    if (*p == '.') {
+      if (sawPoint) {
+        return false;
+      }
+      sawPoint = true;
+      continue;
+    }
+    sawDigit = true;
+    if (digitCount == 0 && *p == '0') {
+      // A leading zero is not significant.
+      if (sawPoint) {
+        --e;
+      }
+    } else if (digitCount < MAX_SIGNIFICANT_DIGITS) {
+      digits[digitCount++] = static_cast<char>(*p);
+      if (sawPoint) {
+        --e;
+      }
+    } else {
+      // Too many digits to keep: remember only whether any of the rest are nonzero.
+      if (*p != '0') {
+        digits[MAX_SIGNIFICANT_DIGITS] = '1';
+        digitCount = MAX_SIGNIFICANT_DIGITS + 1;
+      }
+      if (!sawPoint) {
+        ++e;
+      }
+    }
+  }
+  if (digitCount > MAX_SIGNIFICANT_DIGITS) {
+    // The sticky digit is one place below the last digit we kept.
+    --e;
+  }
+  if (!sawDigit) {
+    return false;
+  }
+
+  if (p < end) {
+    if (*p != 'e' && *p != 'E') {
+      return false;
+    }
+    ++p;
+    bool negativeExponent = false;
+    if (p < end && (*p == '-' || *p == '+')) {
+      negativeExponent = (*p++ == '-');
+    }
+    if (p == end) {
+      return false;
+    }
+    int64_t exponent = 0;
+    for (; p < end; ++p) {
+      if (!isDigit(*p)) {
+        return false;
+      }
+      // Saturate: anything this large is zero or infinity anyway.
+      if (exponent < 100000) {
+        exponent = exponent * 10 + (*p - '0');
+      }
+    }
+    e += negativeExponent ? -exponent : exponent;
+  }
+
+  // Drop trailing zeros.
+  while (digitCount > 0 && digits[digitCount - 1] == '0') {
+    --digitCount;
+    ++e;
+  }
+  if (digitCount == 0) {
+    *result = negative ? -0.0 : 0.0;
+    return true;
+  }
+
+  // The same limits as StringToReal.initialParse.
+  const int APPROX_MIN_MAGNITUDE = -359;
+  const int MAX_DIGITS = 52;
+  if (digitCount > MAX_DIGITS && e < APPROX_MIN_MAGNITUDE) {
+    int64_t d = APPROX_MIN_MAGNITUDE - e;
+    if (d > digitCount - 1) {
+      d = digitCount - 1;
+    }
+    digitCount -= d;
+    e += d;
+  }
+  if (e < -1024) {
+    *result = negative ? -0.0 : 0.0;
+    return true;
+  } else if (e > 1024) {
+    *result = negative ? -HUGE_VAL : HUGE_VAL;
+    return true;
+  }
+
+  digits[digitCount] = '\0';
+  jdouble value = createDouble(env, digits, static_cast<jint>(e));
+  *result = negative ? -value : value;
+  return true;
+}
+
+template <typename ScopedArrayT, typename JavaArrayT>
+static jint parseDoubles(JNIEnv* env, JavaArrayT javaSrc, jint offset, jint length,
+        jint delimiter, jdoubleArray javaDst, jint dstOffset) {
+  ScopedArrayT src(env, javaSrc);
+  if (src.get() == NULL) {
+    return -1;
+  }
+  ScopedDoubleArrayRW dst(env, javaDst);
+  if (dst.get() == NULL) {
+    return -1;
+  }
+  if (length == 0) {
+    return 0;
+  }
+
+  const jsize dstLength = env->GetArrayLength(javaDst);
+  const auto* p = src.get() + offset;
+  const auto* end = p + length;
+  jint count = 0;
+  while (true) {
+    const auto* tokenEnd = p;
+    while (tokenEnd < end && *tokenEnd != delimiter) {
+      ++tokenEnd;
+    }
+    if (dstOffset + count >= dstLength) {
+      jniThrowExceptionFmt(env, "java/lang/ArrayIndexOutOfBoundsException",
+              "too many values for dst: more than %d", dstLength - dstOffset);
+      return -1;
+    }
+    jdouble value;
+    if (!parseDecimalToken(env, p, tokenEnd, &value)) {
+      char token[64];
+      size_t i = 0;
+      for (; i < sizeof(token) - 1 && p + i < tokenEnd; ++i) {
+        token[i] = static_cast<char>(p[i]);
+      }
+      token[i] = '\0';
+      jniThrowExceptionFmt(env, "java/lang/NumberFormatException", "Invalid double: \"%s\"",
+              token);
+      return -1;
+    }
+    if (env->ExceptionCheck()) {
+      return -1;
+    }
+    dst[dstOffset + count++] = value;
+    if (tokenEnd == end) {
+      return count;
+    }
+    p = tokenEnd + 1;
+  }
+}
+
+static jint StringToReal_parseDoublesFromBytes(JNIEnv* env, jclass, jbyteArray src, jint offset,
+        jint length, jbyte delimiter, jdoubleArray dst, jint dstOffset) {
+  return parseDoubles<ScopedByteArrayRO>(env, src, offset, length, delimiter, dst, dstOffset);
+}
+
+static jint StringToReal_parseDoublesFromChars(JNIEnv* env, jclass, jcharArray src, jint offset,
+        jint length, jchar delimiter, jdoubleArray dst, jint dstOffset) {
+  return parseDoubles<ScopedCharArrayRO>(env, src, offset, length, delimiter, dst, dstOffset);
+}
+
 static JNINativeMethod gMethods[] = {
+    NATIVE_METHOD(StringToReal, parseDoublesFromBytes, "([BIIB[DI)I"),
+    NATIVE_METHOD(StringToReal, parseDoublesFromChars, "([CIIC[DI)I"),
     NATIVE_METHOD(StringToReal, parseFltImpl, "(Ljava/lang/String;I)F"),
     NATIVE_METHOD(StringToReal, parseDblImpl, "(Ljava/lang/String;I)D"),
 };
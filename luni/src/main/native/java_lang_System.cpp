@@ -16,6 +16,7 @@
 
 #define LOG_TAG "System"
 
+#include "AsyncLogSink.h"
 #include "JNIHelp.h"
 #include "JniConstants.h"
 #include "ScopedUtfChars.h"
@@ -27,7 +28,10 @@
 #include <string>
 #include <vector>
 
+#include <errno.h>
 #include <limits.h>
+#include <pthread.h>
+#include <stdint.h>
 #include <stdlib.h>
 #include <string.h>
 #include <sys/time.h>
@@ -38,17 +42,48 @@
 #include "mingw-extensions.h"
 #endif
 
+#if defined(__i386__) || defined(__x86_64__)
+#include <x86intrin.h>
+#endif
+
 #if defined(HAVE_ANDROID_OS)
 extern "C" void android_get_LD_LIBRARY_PATH(char*, size_t);
 #endif
 
-static void System_log(JNIEnv* env, jclass, jchar type, jstring javaMessage, jthrowable exception) {
-    ScopedUtfChars message(env, javaMessage);
-    if (message.c_str() == NULL) {
-        // Since this function is used for last-gasp debugging output, be noisy on failure.
-        ALOGE("message.c_str() == NULL");
-        return;
+static bool gAsynchronousLogging = false;
+
+// Encodes 'javaMessage' as UTF-8 into 'dst' (which has room for ASYNC_LOG_MAX_MESSAGE_LENGTH
+// bytes) without going through modified UTF-8, if it's all Latin-1 and short enough. Returns
+// the number of bytes written, or -1.
+static ssize_t latin1MessageToUtf8(JNIEnv* env, jstring javaMessage, char* dst) {
+    jsize length = env->GetStringLength(javaMessage);
+    if (length > ASYNC_LOG_MAX_MESSAGE_LENGTH) {
+        return -1;
     }
+    jchar chars[ASYNC_LOG_MAX_MESSAGE_LENGTH];
+    env->GetStringRegion(javaMessage, 0, length, chars);
+    size_t byteCount = 0;
+    for (jsize i = 0; i < length; ++i) {
+        jchar ch = chars[i];
+        if (ch < 0x80 && ch != 0) {
+            if (byteCount == ASYNC_LOG_MAX_MESSAGE_LENGTH) {
+                return -1;
+            }
+            dst[byteCount++] = ch;
+        } else if (ch < 0x100 && ch != 0) {
+            if (byteCount + 2 > ASYNC_LOG_MAX_MESSAGE_LENGTH) {
+                return -1;
+            }
+            dst[byteCount++] = 0xc0 | (ch >> 6);
+            dst[byteCount++] = 0x80 | (ch & 0x3f);
+        } else {
+            return -1;
+        }
+    }
+    return byteCount;
+}
+
+static void System_log(JNIEnv* env, jclass, jchar type, jstring javaMessage, jthrowable exception) {
     int priority;
     switch (type) {
     case 'D': case 'd': priority = ANDROID_LOG_DEBUG;   break;
@@ -60,6 +95,29 @@ static void System_log(JNIEnv* env, jclass, jchar type, jstring javaMessage, jth
     case 'W': case 'w': priority = ANDROID_LOG_WARN;    break;
     default:            priority = ANDROID_LOG_DEFAULT; break;
     }
+
+    // Exceptions need this thread's stack, and fatal messages shouldn't be left in a queue.
+    bool asynchronous = gAsynchronousLogging && exception == NULL &&
+            priority < ANDROID_LOG_FATAL;
+    if (asynchronous && javaMessage != NULL) {
+        char utf8[ASYNC_LOG_MAX_MESSAGE_LENGTH];
+        ssize_t byteCount = latin1MessageToUtf8(env, javaMessage, utf8);
+        if (byteCount != -1) {
+            asyncLog(priority, LOG_TAG, utf8, byteCount);
+            return;
+        }
+    }
+
+    ScopedUtfChars message(env, javaMessage);
+    if (message.c_str() == NULL) {
+        // Since this function is used for last-gasp debugging output, be noisy on failure.
+        ALOGE("message.c_str() == NULL");
+        return;
+    }
+    if (asynchronous && message.size() <= ASYNC_LOG_MAX_MESSAGE_LENGTH) {
+        asyncLog(priority, LOG_TAG, message.c_str(), message.size());
+        return;
+    }
     LOG_PRI(priority, LOG_TAG, "%s", message.c_str());
     if (exception != NULL) {
         jniLogException(env, priority, LOG_TAG, exception);
@@ -124,6 +182,18 @@ static jlong System_nanoTime(JNIEnv*, jclass) {
     timespec now;
     clock_gettime(CLOCK_MONOTONIC, &now);
     return now.tv_sec * 1000000000LL + now.tv_nsec;
+#elif defined(__MINGW32__) || defined(__MINGW64__)
+    // The performance counter's frequency is fixed at boot.
+    static LARGE_INTEGER frequency;
+    if (frequency.QuadPart == 0) {
+        QueryPerformanceFrequency(&frequency);
+    }
+    LARGE_INTEGER now;
+    QueryPerformanceCounter(&now);
+    // Split the conversion so that it can't overflow.
+    jlong seconds = now.QuadPart / frequency.QuadPart;
+    jlong remainder = now.QuadPart % frequency.QuadPart;
+    return seconds * 1000000000LL + remainder * 1000000000LL / frequency.QuadPart;
 #else
     timeval now;
     gettimeofday(&now, NULL);
@@ -131,6 +201,82 @@ static jlong System_nanoTime(JNIEnv*, jclass) {
 #endif
 }
 
+// The coarse clocks are read from the vDSO without touching the hardware clock, so they're
+// several times cheaper, but only advance once per scheduler tick (typically every 1-10ms).
+static jlong System_coarseCurrentTimeMillis(JNIEnv*, jclass) {
+#if defined(CLOCK_REALTIME_COARSE)
+    timespec now;
+    clock_gettime(CLOCK_REALTIME_COARSE, &now);
+    return now.tv_sec * 1000LL + now.tv_nsec / 1000000;
+#else
+    return System_currentTimeMillis(NULL, NULL);
+#endif
+}
+
+static jlong System_coarseNanoTime(JNIEnv*, jclass) {
+#if defined(HAVE_POSIX_CLOCKS) && defined(CLOCK_MONOTONIC_COARSE)
+    timespec now;
+    clock_gettime(CLOCK_MONOTONIC_COARSE, &now);
+    return now.tv_sec * 1000000000LL + now.tv_nsec;
+#else
+    return System_nanoTime(NULL, NULL);
+#endif
+}
+
+// Reads the CPU's cycle counter: the TSC on x86, and the virtual counter on arm64. Elsewhere,
+// this is nanoTime, with a frequency of 1GHz.
+static inline uint64_t readCycleCounter() {
+#if defined(__i386__) || defined(__x86_64__)
+    return __rdtsc();
+#elif defined(__aarch64__)
+    uint64_t value;
+    asm volatile("mrs %0, cntvct_el0" : "=r"(value));
+    return value;
+#else
+    return System_nanoTime(NULL, NULL);
+#endif
+}
+
+static jlong System_cycleCounter(JNIEnv*, jclass) {
+    return readCycleCounter();
+}
+
+static pthread_once_t gCycleCounterFrequencyOnce = PTHREAD_ONCE_INIT;
+static jlong gCycleCounterFrequency;
+
+static void calibrateCycleCounter() {
+#if defined(__i386__) || defined(__x86_64__)
+    // The TSC's rate isn't architecturally visible, so time it against nanoTime for 10ms.
+    jlong startNanos = System_nanoTime(NULL, NULL);
+    uint64_t startCycles = readCycleCounter();
+    timespec delay = { 0, 10000000 };
+    while (nanosleep(&delay, &delay) == -1 && errno == EINTR) {
+    }
+    uint64_t cycles = readCycleCounter() - startCycles;
+    jlong nanos = System_nanoTime(NULL, NULL) - startNanos;
+    gCycleCounterFrequency = static_cast<jlong>(cycles * 1e9 / nanos);
+#elif defined(__aarch64__)
+    uint64_t frequency;
+    asm volatile("mrs %0, cntfrq_el0" : "=r"(frequency));
+    gCycleCounterFrequency = frequency;
+#else
+    gCycleCounterFrequency = 1000000000LL;
+#endif
+}
+
+static jlong System_cycleCounterFrequency(JNIEnv*, jclass) {
+    pthread_once(&gCycleCounterFrequencyOnce, calibrateCycleCounter);
+    return gCycleCounterFrequency;
+}
+
+static void System_setAsynchronousLogging(JNIEnv*, jclass, jboolean enabled) {
+    gAsynchronousLogging = enabled;
+}
+
+static jlong System_droppedLogMessageCount(JNIEnv*, jclass) {
+    return asyncLogDroppedCount();
+}
+
 static jstring System_mapLibraryName(JNIEnv* env, jclass, jstring javaName) {
     ScopedUtfChars name(env, javaName);
     if (name.c_str() == NULL) {
@@ -144,10 +290,16 @@ static jstring System_mapLibraryName(JNIEnv* env, jclass, jstring javaName) {
 }
 
 static JNINativeMethod gMethods[] = {
+    NATIVE_METHOD(System, coarseCurrentTimeMillis, "!()J"),
+    NATIVE_METHOD(System, coarseNanoTime, "!()J"),
     NATIVE_METHOD(System, currentTimeMillis, "!()J"),
+    NATIVE_METHOD(System, cycleCounter, "!()J"),
+    NATIVE_METHOD(System, cycleCounterFrequency, "()J"),
+    NATIVE_METHOD(System, droppedLogMessageCount, "()J"),
     NATIVE_METHOD(System, log, "(CLjava/lang/String;Ljava/lang/Throwable;)V"),
     NATIVE_METHOD(System, mapLibraryName, "(Ljava/lang/String;)Ljava/lang/String;"),
     NATIVE_METHOD(System, nanoTime, "!()J"),
+    NATIVE_METHOD(System, setAsynchronousLogging, "(Z)V"),
     NATIVE_METHOD(System, setFieldImpl, "(Ljava/lang/String;Ljava/lang/String;Ljava/lang/Object;)V"),
     NATIVE_METHOD(System, specialProperties, "()[Ljava/lang/String;"),
 };
@@ -20,25 +20,83 @@
 #include "JniConstants.h"
 #include "JniException.h"
 #include "ScopedPrimitiveArray.h"
+#include "ScopedPthreadMutexLock.h"
 #include "ScopedUtfChars.h"
-#include "UniquePtr.h"
 #include "jni.h"
 #include <openssl/bn.h>
 #include <openssl/crypto.h>
 #include <openssl/err.h>
+#include <pthread.h>
 #include <stdio.h>
-
-struct BN_CTX_Deleter {
-  void operator()(BN_CTX* p) const {
-    BN_CTX_free(p);
-  }
-};
-typedef UniquePtr<BN_CTX, BN_CTX_Deleter> Unique_BN_CTX;
+#include <string.h>
 
 static BIGNUM* toBigNum(jlong address) {
   return reinterpret_cast<BIGNUM*>(static_cast<uintptr_t>(address));
 }
 
+/*
+ * A BN_CTX is just a stack of scratch BIGNUMs that operations push and pop, so rather than
+ * creating and destroying one per call we keep one per thread for as long as the thread lives.
+ * Its scratch BIGNUMs, digits and all, then stay allocated from one operation to the next.
+ */
+static pthread_key_t gBnCtxKey;
+static pthread_once_t gBnCtxKeyOnce = PTHREAD_ONCE_INIT;
+
+static void freeThreadBnCtx(void* ctx) {
+  BN_CTX_free(reinterpret_cast<BN_CTX*>(ctx));
+}
+
+static void createBnCtxKey() {
+  pthread_key_create(&gBnCtxKey, freeThreadBnCtx);
+}
+
+static BN_CTX* threadBnCtx(JNIEnv* env) {
+  pthread_once(&gBnCtxKeyOnce, createBnCtxKey);
+  BN_CTX* ctx = reinterpret_cast<BN_CTX*>(pthread_getspecific(gBnCtxKey));
+  if (ctx == NULL) {
+    ctx = BN_CTX_new();
+    if (ctx == NULL) {
+      jniThrowOutOfMemoryError(env, "BN_CTX_new failed");
+      return NULL;
+    }
+    pthread_setspecific(gBnCtxKey, ctx);
+  }
+  return ctx;
+}
+
+/*
+ * Every BigInt owns a BIGNUM that its finalizer frees, so short-lived values cost two mallocs
+ * and two frees (the BIGNUM and its digits). Freed BIGNUMs go into a small pool instead, for
+ * BN_new to hand back out with their digits already allocated. Only modestly sized BIGNUMs are
+ * kept, so the pool never pins much memory. Finalizers run on their own thread, so the pool is
+ * shared rather than per-thread.
+ */
+static const size_t BIGNUM_POOL_CAPACITY = 64;
+static const int BIGNUM_POOL_MAX_WORDS = 4096 / BN_BITS2;
+static BIGNUM* gBigNumPool[BIGNUM_POOL_CAPACITY];
+static size_t gBigNumPoolSize = 0;
+static pthread_mutex_t gBigNumPoolMutex = PTHREAD_MUTEX_INITIALIZER;
+
+static BIGNUM* takePooledBigNum() {
+  ScopedPthreadMutexLock lock(&gBigNumPoolMutex);
+  return (gBigNumPoolSize > 0) ? gBigNumPool[--gBigNumPoolSize] : NULL;
+}
+
+static bool poolBigNum(BIGNUM* a) {
+  if (a->dmax > BIGNUM_POOL_MAX_WORDS) {
+    return false;
+  }
+  // Wipe the old digits rather than just resetting the length: they may be key material, and
+  // the next owner could otherwise read them back through the spare capacity.
+  BN_clear(a);
+  ScopedPthreadMutexLock lock(&gBigNumPoolMutex);
+  if (gBigNumPoolSize == BIGNUM_POOL_CAPACITY) {
+    return false;
+  }
+  gBigNumPool[gBigNumPoolSize++] = a;
+  return true;
+}
+
 static bool throwExceptionIfNecessary(JNIEnv* env) {
   long error = ERR_get_error();
   if (error == 0) {
@@ -87,6 +145,10 @@ static int fourValidHandles(JNIEnv* env, jlong a, jlong b, jlong c, jlong d) {
 }
 
 static jlong NativeBN_BN_new(JNIEnv* env, jclass) {
+  BIGNUM* pooled = takePooledBigNum();
+  if (pooled != NULL) {
+    return static_cast<jlong>(reinterpret_cast<uintptr_t>(pooled));
+  }
   jlong result = static_cast<jlong>(reinterpret_cast<uintptr_t>(BN_new()));
   throwExceptionIfNecessary(env);
   return result;
@@ -94,7 +156,9 @@ static jlong NativeBN_BN_new(JNIEnv* env, jclass) {
 
 static void NativeBN_BN_free(JNIEnv* env, jclass, jlong a) {
   if (!oneValidHandle(env, a)) return;
-  BN_free(toBigNum(a));
+  if (!poolBigNum(toBigNum(a))) {
+    BN_free(toBigNum(a));
+  }
 }
 
 static int NativeBN_BN_cmp(JNIEnv* env, jclass, jlong a, jlong b) {
@@ -165,13 +229,13 @@ static int NativeBN_BN_hex2bn(JNIEnv* env, jclass, jlong a0, jstring str) {
   return result;
 }
 
-static void NativeBN_BN_bin2bn(JNIEnv* env, jclass, jbyteArray arr, int len, jboolean neg, jlong ret) {
+static void NativeBN_BN_bin2bn(JNIEnv* env, jclass, jbyteArray arr, int offset, int len, jboolean neg, jlong ret) {
   if (!oneValidHandle(env, ret)) return;
   ScopedByteArrayRO bytes(env, arr);
   if (bytes.get() == NULL) {
     return;
   }
-  BN_bin2bn(reinterpret_cast<const unsigned char*>(bytes.get()), len, toBigNum(ret));
+  BN_bin2bn(reinterpret_cast<const unsigned char*>(bytes.get() + offset), len, toBigNum(ret));
   if (!throwExceptionIfNecessary(env) && neg) {
     BN_set_negative(toBigNum(ret), true);
   }
@@ -200,7 +264,12 @@ static void NativeBN_litEndInts2bn(JNIEnv* env, jclass, jintArray arr, int len,
 #endif
     const unsigned int* tmpInts = reinterpret_cast<const unsigned int*>(scopedArray.get());
     if ((tmpInts != NULL) && (bn_wexpand(ret, wlen) != NULL)) {
-#ifdef __LP64__
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+      // Little-endian ints are laid out exactly like little-endian words,
+      // so this is one bulk copy plus, for an odd count, the top word's high half.
+      ret->d[wlen - 1] = 0;
+      memcpy(ret->d, tmpInts, len * sizeof(unsigned int));
+#elif defined(__LP64__)
       if (len % 2) {
         ret->d[wlen - 1] = tmpInts[--len];
       }
@@ -288,7 +357,7 @@ static void negBigEndianBytes2bn(JNIEnv*, jclass, const unsigned char* bytes, in
   }
 }
 
-static void NativeBN_twosComp2bn(JNIEnv* env, jclass cls, jbyteArray arr, int bytesLen, jlong ret0) {
+static void NativeBN_twosComp2bn(JNIEnv* env, jclass cls, jbyteArray arr, int offset, int bytesLen, jlong ret0) {
   if (!oneValidHandle(env, ret0)) return;
   BIGNUM* ret = toBigNum(ret0);
 
@@ -296,8 +365,8 @@ static void NativeBN_twosComp2bn(JNIEnv* env, jclass cls, jbyteArray arr, int by
   if (bytes.get() == NULL) {
     return;
   }
-  const unsigned char* s = reinterpret_cast<const unsigned char*>(bytes.get());
-  if ((bytes[0] & 0X80) == 0) { // Positive value!
+  const unsigned char* s = reinterpret_cast<const unsigned char*>(bytes.get() + offset);
+  if ((s[0] & 0X80) == 0) { // Positive value!
     //
     // We can use the existing BN implementation for unsigned big endian bytes:
     //
@@ -386,6 +455,25 @@ static jbyteArray NativeBN_BN_bn2bin(JNIEnv* env, jclass, jlong a0) {
   return result;
 }
 
+/**
+ * Writes the big-endian magnitude of 'a' into 'javaBytes' at 'offset', if it fits, so callers
+ * serializing many values can reuse one buffer. Returns the magnitude's length either way.
+ */
+static jint NativeBN_bn2binInto(JNIEnv* env, jclass, jlong a0, jbyteArray javaBytes, jint offset) {
+  if (!oneValidHandle(env, a0)) return -1;
+  BIGNUM* a = toBigNum(a0);
+  jint length = BN_num_bytes(a);
+  if (length > env->GetArrayLength(javaBytes) - offset) {
+    return length;
+  }
+  ScopedByteArrayRW bytes(env, javaBytes);
+  if (bytes.get() == NULL) {
+    return -1;
+  }
+  BN_bn2bin(a, reinterpret_cast<unsigned char*>(bytes.get() + offset));
+  return length;
+}
+
 static jintArray NativeBN_bn2litEndInts(JNIEnv* env, jclass, jlong a0) {
   if (!oneValidHandle(env, a0)) return NULL;
   BIGNUM* a = toBigNum(a0);
@@ -406,7 +494,10 @@ static jintArray NativeBN_bn2litEndInts(JNIEnv* env, jclass, jlong a0) {
   if (uints == NULL) {
     return NULL;
   }
-#ifdef __LP64__
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+  // The words are already little-endian ints in memory.
+  memcpy(uints, a->d, wLen * BN_BYTES);
+#elif defined(__LP64__)
   int i = wLen; do { i--; uints[i*2+1] = a->d[i] >> 32; uints[i*2] = a->d[i]; } while (i > 0);
 #else
   int i = wLen; do { i--; uints[i] = a->d[i]; } while (i > 0);
@@ -496,50 +587,182 @@ static void NativeBN_BN_sub(JNIEnv* env, jclass, jlong r, jlong a, jlong b) {
 
 static void NativeBN_BN_gcd(JNIEnv* env, jclass, jlong r, jlong a, jlong b) {
   if (!threeValidHandles(env, r, a, b)) return;
-  Unique_BN_CTX ctx(BN_CTX_new());
-  BN_gcd(toBigNum(r), toBigNum(a), toBigNum(b), ctx.get());
+  BN_CTX* ctx = threadBnCtx(env);
+  if (ctx == NULL) return;
+  BN_gcd(toBigNum(r), toBigNum(a), toBigNum(b), ctx);
   throwExceptionIfNecessary(env);
 }
 
 static void NativeBN_BN_mul(JNIEnv* env, jclass, jlong r, jlong a, jlong b) {
   if (!threeValidHandles(env, r, a, b)) return;
-  Unique_BN_CTX ctx(BN_CTX_new());
-  BN_mul(toBigNum(r), toBigNum(a), toBigNum(b), ctx.get());
+  BN_CTX* ctx = threadBnCtx(env);
+  if (ctx == NULL) return;
+  BN_mul(toBigNum(r), toBigNum(a), toBigNum(b), ctx);
   throwExceptionIfNecessary(env);
 }
 
 static void NativeBN_BN_exp(JNIEnv* env, jclass, jlong r, jlong a, jlong p) {
   if (!threeValidHandles(env, r, a, p)) return;
-  Unique_BN_CTX ctx(BN_CTX_new());
-  BN_exp(toBigNum(r), toBigNum(a), toBigNum(p), ctx.get());
+  BN_CTX* ctx = threadBnCtx(env);
+  if (ctx == NULL) return;
+  BN_exp(toBigNum(r), toBigNum(a), toBigNum(p), ctx);
   throwExceptionIfNecessary(env);
 }
 
 static void NativeBN_BN_div(JNIEnv* env, jclass, jlong dv, jlong rem, jlong m, jlong d) {
   if (!fourValidHandles(env, (rem ? rem : dv), (dv ? dv : rem), m, d)) return;
-  Unique_BN_CTX ctx(BN_CTX_new());
-  BN_div(toBigNum(dv), toBigNum(rem), toBigNum(m), toBigNum(d), ctx.get());
+  BN_CTX* ctx = threadBnCtx(env);
+  if (ctx == NULL) return;
+  BN_div(toBigNum(dv), toBigNum(rem), toBigNum(m), toBigNum(d), ctx);
   throwExceptionIfNecessary(env);
 }
 
 static void NativeBN_BN_nnmod(JNIEnv* env, jclass, jlong r, jlong a, jlong m) {
   if (!threeValidHandles(env, r, a, m)) return;
-  Unique_BN_CTX ctx(BN_CTX_new());
-  BN_nnmod(toBigNum(r), toBigNum(a), toBigNum(m), ctx.get());
+  BN_CTX* ctx = threadBnCtx(env);
+  if (ctx == NULL) return;
+  BN_nnmod(toBigNum(r), toBigNum(a), toBigNum(m), ctx);
   throwExceptionIfNecessary(env);
 }
 
 static void NativeBN_BN_mod_exp(JNIEnv* env, jclass, jlong r, jlong a, jlong p, jlong m) {
   if (!fourValidHandles(env, r, a, p, m)) return;
-  Unique_BN_CTX ctx(BN_CTX_new());
-  BN_mod_exp(toBigNum(r), toBigNum(a), toBigNum(p), toBigNum(m), ctx.get());
+  BN_CTX* ctx = threadBnCtx(env);
+  if (ctx == NULL) return;
+  BN_mod_exp(toBigNum(r), toBigNum(a), toBigNum(p), toBigNum(m), ctx);
   throwExceptionIfNecessary(env);
 }
 
 static void NativeBN_BN_mod_inverse(JNIEnv* env, jclass, jlong ret, jlong a, jlong n) {
   if (!threeValidHandles(env, ret, a, n)) return;
-  Unique_BN_CTX ctx(BN_CTX_new());
-  BN_mod_inverse(toBigNum(ret), toBigNum(a), toBigNum(n), ctx.get());
+  BN_CTX* ctx = threadBnCtx(env);
+  if (ctx == NULL) return;
+  BN_mod_inverse(toBigNum(ret), toBigNum(a), toBigNum(n), ctx);
+  throwExceptionIfNecessary(env);
+}
+
+static void NativeBN_BN_mod_mul(JNIEnv* env, jclass, jlong r, jlong a, jlong b, jlong m) {
+  if (!fourValidHandles(env, r, a, b, m)) return;
+  BN_CTX* ctx = threadBnCtx(env);
+  if (ctx == NULL) return;
+  BN_mod_mul(toBigNum(r), toBigNum(a), toBigNum(b), toBigNum(m), ctx);
+  throwExceptionIfNecessary(env);
+}
+
+/**
+ * Computes r = pow(a, p) mod m in a single call, including the cases BN_mod_exp can't handle:
+ * a negative p uses the inverse of a, and a zero p gives 1 mod m. The result is in [0, m).
+ */
+static void NativeBN_modPow(JNIEnv* env, jclass, jlong r, jlong a, jlong p0, jlong m0) {
+  if (!fourValidHandles(env, r, a, p0, m0)) return;
+  BN_CTX* ctx = threadBnCtx(env);
+  if (ctx == NULL) return;
+  BIGNUM* p = toBigNum(p0);
+  BIGNUM* m = toBigNum(m0);
+  if (BN_is_zero(p)) {
+    // OpenSSL gets this case wrong; http://b/8574367.
+    if (BN_is_one(m)) {
+      BN_zero(toBigNum(r));
+    } else {
+      BN_one(toBigNum(r));
+    }
+  } else if (BN_is_negative(p)) {
+    BN_CTX_start(ctx);
+    BIGNUM* inverse = BN_CTX_get(ctx);
+    BIGNUM* exponent = BN_CTX_get(ctx);
+    if (exponent != NULL && BN_mod_inverse(inverse, toBigNum(a), m, ctx) != NULL &&
+        BN_copy(exponent, p) != NULL) {
+      BN_set_negative(exponent, false);
+      BN_mod_exp(toBigNum(r), inverse, exponent, m, ctx);
+    }
+    BN_CTX_end(ctx);
+  } else {
+    BN_mod_exp(toBigNum(r), toBigNum(a), p, m, ctx);
+  }
+  throwExceptionIfNecessary(env);
+}
+
+/**
+ * Computes r = a * b + c. Any of the operands may be r itself.
+ */
+static void NativeBN_mulAdd(JNIEnv* env, jclass, jlong r, jlong a, jlong b, jlong c) {
+  if (!fourValidHandles(env, r, a, b, c)) return;
+  BN_CTX* ctx = threadBnCtx(env);
+  if (ctx == NULL) return;
+  BN_CTX_start(ctx);
+  BIGNUM* product = BN_CTX_get(ctx);
+  if (product != NULL && BN_mul(product, toBigNum(a), toBigNum(b), ctx)) {
+    BN_add(toBigNum(r), product, toBigNum(c));
+  }
+  BN_CTX_end(ctx);
+  throwExceptionIfNecessary(env);
+}
+
+/**
+ * Computes r as the sum of the BIGNUMs whose handles are in 'javaOperands'. Any of the operands
+ * may be r itself.
+ */
+static void NativeBN_sum(JNIEnv* env, jclass, jlong r, jlongArray javaOperands) {
+  if (!oneValidHandle(env, r)) return;
+  ScopedLongArrayRO operands(env, javaOperands);
+  if (operands.get() == NULL) return;
+  for (size_t i = 0; i < operands.size(); ++i) {
+    if (!isValidHandle(env, operands[i], "Operand handle passed as null")) return;
+  }
+  BN_CTX* ctx = threadBnCtx(env);
+  if (ctx == NULL) return;
+  BN_CTX_start(ctx);
+  BIGNUM* total = BN_CTX_get(ctx);
+  if (total != NULL) {
+    BN_zero(total);
+    bool ok = true;
+    for (size_t i = 0; ok && i < operands.size(); ++i) {
+      ok = BN_add(total, total, toBigNum(operands[i]));
+    }
+    if (ok) {
+      BN_copy(toBigNum(r), total);
+    }
+  }
+  BN_CTX_end(ctx);
+  throwExceptionIfNecessary(env);
+}
+
+/**
+ * Computes r as the sum of the pairwise products of the BIGNUMs whose handles are in
+ * 'javaLhs' and 'javaRhs', which must be the same length. Any of the operands may be r itself.
+ */
+static void NativeBN_sumOfProducts(JNIEnv* env, jclass, jlong r, jlongArray javaLhs,
+                                   jlongArray javaRhs) {
+  if (!oneValidHandle(env, r)) return;
+  ScopedLongArrayRO lhs(env, javaLhs);
+  if (lhs.get() == NULL) return;
+  ScopedLongArrayRO rhs(env, javaRhs);
+  if (rhs.get() == NULL) return;
+  if (lhs.size() != rhs.size()) {
+    jniThrowExceptionFmt(env, "java/lang/IllegalArgumentException",
+                         "operand count mismatch: %zu != %zu", lhs.size(), rhs.size());
+    return;
+  }
+  for (size_t i = 0; i < lhs.size(); ++i) {
+    if (!twoValidHandles(env, lhs[i], rhs[i])) return;
+  }
+  BN_CTX* ctx = threadBnCtx(env);
+  if (ctx == NULL) return;
+  BN_CTX_start(ctx);
+  BIGNUM* total = BN_CTX_get(ctx);
+  BIGNUM* product = BN_CTX_get(ctx);
+  if (product != NULL) {
+    BN_zero(total);
+    bool ok = true;
+    for (size_t i = 0; ok && i < lhs.size(); ++i) {
+      ok = BN_mul(product, toBigNum(lhs[i]), toBigNum(rhs[i]), ctx) &&
+          BN_add(total, total, product);
+    }
+    if (ok) {
+      BN_copy(toBigNum(r), total);
+    }
+  }
+  BN_CTX_end(ctx);
   throwExceptionIfNecessary(env);
 }
 
@@ -553,14 +776,15 @@ static void NativeBN_BN_generate_prime_ex(JNIEnv* env, jclass, jlong ret, int bi
 
 static jboolean NativeBN_BN_is_prime_ex(JNIEnv* env, jclass, jlong p, int nchecks, jlong cb) {
   if (!oneValidHandle(env, p)) return JNI_FALSE;
-  Unique_BN_CTX ctx(BN_CTX_new());
-  return BN_is_prime_ex(toBigNum(p), nchecks, ctx.get(), reinterpret_cast<BN_GENCB*>(cb));
+  BN_CTX* ctx = threadBnCtx(env);
+  if (ctx == NULL) return JNI_FALSE;
+  return BN_is_prime_ex(toBigNum(p), nchecks, ctx, reinterpret_cast<BN_GENCB*>(cb));
 }
 
 static JNINativeMethod gMethods[] = {
    NATIVE_METHOD(NativeBN, BN_add, "(JJJ)V"),
    NATIVE_METHOD(NativeBN, BN_add_word, "(JI)V"),
-   NATIVE_METHOD(NativeBN, BN_bin2bn, "([BIZJ)V"),
+   NATIVE_METHOD(NativeBN, BN_bin2bn, "([BIIZJ)V"),
    NATIVE_METHOD(NativeBN, BN_bn2bin, "(J)[B"),
    NATIVE_METHOD(NativeBN, BN_bn2dec, "(J)Ljava/lang/String;"),
    NATIVE_METHOD(NativeBN, BN_bn2hex, "(J)Ljava/lang/String;"),
@@ -577,6 +801,7 @@ static JNINativeMethod gMethods[] = {
    NATIVE_METHOD(NativeBN, BN_is_prime_ex, "(JIJ)Z"),
    NATIVE_METHOD(NativeBN, BN_mod_exp, "(JJJJ)V"),
    NATIVE_METHOD(NativeBN, BN_mod_inverse, "(JJJ)V"),
+   NATIVE_METHOD(NativeBN, BN_mod_mul, "(JJJJ)V"),
    NATIVE_METHOD(NativeBN, BN_mod_word, "(JI)I"),
    NATIVE_METHOD(NativeBN, BN_mul, "(JJJ)V"),
    NATIVE_METHOD(NativeBN, BN_mul_word, "(JI)V"),
@@ -586,13 +811,18 @@ static JNINativeMethod gMethods[] = {
    NATIVE_METHOD(NativeBN, BN_shift, "(JJI)V"),
    NATIVE_METHOD(NativeBN, BN_sub, "(JJJ)V"),
    NATIVE_METHOD(NativeBN, bitLength, "(J)I"),
+   NATIVE_METHOD(NativeBN, bn2binInto, "(J[BI)I"),
    NATIVE_METHOD(NativeBN, bn2litEndInts, "(J)[I"),
    NATIVE_METHOD(NativeBN, litEndInts2bn, "([IIZJ)V"),
    NATIVE_METHOD(NativeBN, longInt, "(J)J"),
+   NATIVE_METHOD(NativeBN, modPow, "(JJJJ)V"),
+   NATIVE_METHOD(NativeBN, mulAdd, "(JJJJ)V"),
    NATIVE_METHOD(NativeBN, putLongInt, "(JJ)V"),
    NATIVE_METHOD(NativeBN, putULongInt, "(JJZ)V"),
    NATIVE_METHOD(NativeBN, sign, "(J)I"),
-   NATIVE_METHOD(NativeBN, twosComp2bn, "([BIJ)V"),
+   NATIVE_METHOD(NativeBN, sum, "(J[J)V"),
+   NATIVE_METHOD(NativeBN, sumOfProducts, "(J[J[J)V"),
+   NATIVE_METHOD(NativeBN, twosComp2bn, "([BIIJ)V"),
 };
 void register_java_math_NativeBN(JNIEnv* env) {
     jniRegisterNativeMethods(env, "java/math/NativeBN", gMethods, NELEM(gMethods));
@@ -16,95 +16,14 @@
 
 #define LOG_TAG "String"
 
+#include "CharsetUtilities.h"
 #include "JNIHelp.h"
 #include "JniConstants.h"
+#include "JniException.h"
 #include "ScopedPrimitiveArray.h"
 #include "jni.h"
-#include "unicode/utf16.h"
 
-#include <string.h>
-
-/**
- * Approximates java.lang.UnsafeByteSequence so we don't have to pay the cost of calling back into
- * Java when converting a char[] to a UTF-8 byte[]. This lets us have UTF-8 conversions slightly
- * faster than ICU for large char[]s without paying for the NIO overhead with small char[]s.
- *
- * We could avoid this by keeping the UTF-8 bytes on the native heap until we're done and only
- * creating a byte[] on the Java heap when we know how big it needs to be, but one shouldn't lie
- * to the garbage collector (nor hide potentially large allocations from it).
- *
- * Because a call to append might require an allocation, it might fail. Callers should always
- * check the return value of append.
- */
-class NativeUnsafeByteSequence {
-public:
-    NativeUnsafeByteSequence(JNIEnv* env)
-        : mEnv(env), mJavaArray(NULL), mRawArray(NULL), mSize(-1), mOffset(0)
-    {
-    }
-
-    ~NativeUnsafeByteSequence() {
-        // Release our pointer to the raw array, copying changes back to the Java heap.
-        if (mRawArray != NULL) {
-            mEnv->ReleaseByteArrayElements(mJavaArray, mRawArray, 0);
-        }
-    }
-
-    bool append(jbyte b) {
-        if (mOffset == mSize && !resize(mSize * 2)) {
-            return false;
-        }
-        mRawArray[mOffset++] = b;
-        return true;
-    }
-
-    bool resize(int newSize) {
-        if (newSize == mSize) {
-            return true;
-        }
-
-        // Allocate a new array.
-        jbyteArray newJavaArray = mEnv->NewByteArray(newSize);
-        if (newJavaArray == NULL) {
-            return false;
-        }
-        jbyte* newRawArray = mEnv->GetByteArrayElements(newJavaArray, NULL);
-        if (newRawArray == NULL) {
-            return false;
-        }
-
-        // Copy data out of the old array and then let go of it.
-        // Note that we may be trimming the array.
-        if (mRawArray != NULL) {
-            memcpy(newRawArray, mRawArray, mOffset);
-            mEnv->ReleaseByteArrayElements(mJavaArray, mRawArray, JNI_ABORT);
-            mEnv->DeleteLocalRef(mJavaArray);
-        }
-
-        // Point ourselves at the new array.
-        mJavaArray = newJavaArray;
-        mRawArray = newRawArray;
-        mSize = newSize;
-        return true;
-    }
-
-    jbyteArray toByteArray() {
-        // Trim any unused space, if necessary.
-        bool okay = resize(mOffset);
-        return okay ? mJavaArray : NULL;
-    }
-
-private:
-    JNIEnv* mEnv;
-    jbyteArray mJavaArray;
-    jbyte* mRawArray;
-    jint mSize;
-    jint mOffset;
-
-    // Disallow copy and assignment.
-    NativeUnsafeByteSequence(const NativeUnsafeByteSequence&);
-    void operator=(const NativeUnsafeByteSequence&);
-};
+#include <stdint.h>
 
 static void Charsets_asciiBytesToChars(JNIEnv* env, jclass, jbyteArray javaBytes, jint offset, jint length, jcharArray javaChars) {
     ScopedByteArrayRO bytes(env, javaBytes);
@@ -116,13 +35,7 @@ static void Charsets_asciiBytesToChars(JNIEnv* env, jclass, jbyteArray javaBytes
         return;
     }
 
-    const jbyte* src = &bytes[offset];
-    jchar* dst = &chars[0];
-    static const jchar REPLACEMENT_CHAR = 0xfffd;
-    for (int i = length - 1; i >= 0; --i) {
-        jchar ch = static_cast<jchar>(*src++ & 0xff);
-        *dst++ = (ch <= 0x7f) ? ch : REPLACEMENT_CHAR;
-    }
+    asciiBytesToChars(&bytes[offset], &chars[0], length);
 }
 
 static void Charsets_isoLatin1BytesToChars(JNIEnv* env, jclass, jbyteArray javaBytes, jint offset, jint length, jcharArray javaChars) {
@@ -135,11 +48,7 @@ static void Charsets_isoLatin1BytesToChars(JNIEnv* env, jclass, jbyteArray javaB
         return;
     }
 
-    const jbyte* src = &bytes[offset];
-    jchar* dst = &chars[0];
-    for (int i = length - 1; i >= 0; --i) {
-        *dst++ = static_cast<jchar>(*src++ & 0xff);
-    }
+    isoLatin1BytesToChars(&bytes[offset], &chars[0], length);
 }
 
 /**
@@ -147,7 +56,7 @@ static void Charsets_isoLatin1BytesToChars(JNIEnv* env, jclass, jbyteArray javaB
  * Unicode code points between U+0000 and U+007f inclusive are identical to US-ASCII, while
  * U+0000 to U+00ff inclusive are identical to ISO-8859-1.
  */
-static jbyteArray charsToBytes(JNIEnv* env, jcharArray javaChars, jint offset, jint length, jchar maxValidChar) {
+static jbyteArray charsToByteArray(JNIEnv* env, jcharArray javaChars, jint offset, jint length, jchar maxValidChar) {
     ScopedCharArrayRO chars(env, javaChars);
     if (chars.get() == NULL) {
         return NULL;
@@ -159,25 +68,16 @@ static jbyteArray charsToBytes(JNIEnv* env, jcharArray javaChars, jint offset, j
         return NULL;
     }
 
-    const jchar* src = &chars[offset];
-    jbyte* dst = &bytes[0];
-    for (int i = length - 1; i >= 0; --i) {
-        jchar ch = *src++;
-        if (ch > maxValidChar) {
-            ch = '?';
-        }
-        *dst++ = static_cast<jbyte>(ch);
-    }
-
+    charsToBytes(&chars[offset], &bytes[0], length, maxValidChar);
     return javaBytes;
 }
 
 static jbyteArray Charsets_toAsciiBytes(JNIEnv* env, jclass, jcharArray javaChars, jint offset, jint length) {
-    return charsToBytes(env, javaChars, offset, length, 0x7f);
+    return charsToByteArray(env, javaChars, offset, length, 0x7f);
 }
 
 static jbyteArray Charsets_toIsoLatin1Bytes(JNIEnv* env, jclass, jcharArray javaChars, jint offset, jint length) {
-    return charsToBytes(env, javaChars, offset, length, 0xff);
+    return charsToByteArray(env, javaChars, offset, length, 0xff);
 }
 
 static jbyteArray Charsets_toUtf8Bytes(JNIEnv* env, jclass, jcharArray javaChars, jint offset, jint length) {
@@ -186,56 +86,57 @@ static jbyteArray Charsets_toUtf8Bytes(JNIEnv* env, jclass, jcharArray javaChars
         return NULL;
     }
 
-    NativeUnsafeByteSequence out(env);
-    if (!out.resize(length)) {
+    // Measure first so that we allocate exactly one array of exactly the right size.
+    size_t byteCount = utf8Length(&chars[offset], length);
+    if (byteCount > INT32_MAX) {
+        jniThrowOutOfMemoryError(env, NULL);
+        return NULL;
+    }
+    jbyteArray javaBytes = env->NewByteArray(byteCount);
+    ScopedByteArrayRW bytes(env, javaBytes);
+    if (bytes.get() == NULL) {
         return NULL;
     }
 
-    const int end = offset + length;
-    for (int i = offset; i < end; ++i) {
-        jint ch = chars[i];
-        if (ch < 0x80) {
-            // One byte.
-            if (!out.append(ch)) {
-                return NULL;
-            }
-        } else if (ch < 0x800) {
-            // Two bytes.
-            if (!out.append((ch >> 6) | 0xc0) || !out.append((ch & 0x3f) | 0x80)) {
-                return NULL;
-            }
-        } else if (U16_IS_SURROGATE(ch)) {
-            // A supplementary character.
-            jchar high = (jchar) ch;
-            jchar low = (i + 1 != end) ? chars[i + 1] : 0;
-            if (!U16_IS_SURROGATE_LEAD(high) || !U16_IS_SURROGATE_TRAIL(low)) {
-                if (!out.append('?')) {
-                    return NULL;
-                }
-                continue;
-            }
-            // Now we know we have a *valid* surrogate pair, we can consume the low surrogate.
-            ++i;
-            ch = U16_GET_SUPPLEMENTARY(high, low);
-            // Four bytes.
-            jbyte b1 = (ch >> 18) | 0xf0;
-            jbyte b2 = ((ch >> 12) & 0x3f) | 0x80;
-            jbyte b3 = ((ch >> 6) & 0x3f) | 0x80;
-            jbyte b4 = (ch & 0x3f) | 0x80;
-            if (!out.append(b1) || !out.append(b2) || !out.append(b3) || !out.append(b4)) {
-                return NULL;
-            }
-        } else {
-            // Three bytes.
-            jbyte b1 = (ch >> 12) | 0xe0;
-            jbyte b2 = ((ch >> 6) & 0x3f) | 0x80;
-            jbyte b3 = (ch & 0x3f) | 0x80;
-            if (!out.append(b1) || !out.append(b2) || !out.append(b3)) {
-                return NULL;
-            }
-        }
+    charsToUtf8Bytes(&chars[offset], length, &bytes[0]);
+    return javaBytes;
+}
+
+//
+// Variants of the encoders above that write to native memory, typically the contents of a
+// direct ByteBuffer, rather than a new Java byte[]. The caller is responsible for bounds checking.
+//
+
+template <typename T> static T cast(jlong address) {
+    return reinterpret_cast<T>(static_cast<uintptr_t>(address));
+}
+
+static void Charsets_toAsciiBytesDirect(JNIEnv* env, jclass, jcharArray javaChars, jint offset, jint length, jlong address) {
+    ScopedCharArrayRO chars(env, javaChars);
+    if (chars.get() == NULL) {
+        return;
+    }
+    charsToBytes(&chars[offset], cast<jbyte*>(address), length, 0x7f);
+}
+
+static void Charsets_toIsoLatin1BytesDirect(JNIEnv* env, jclass, jcharArray javaChars, jint offset, jint length, jlong address) {
+    ScopedCharArrayRO chars(env, javaChars);
+    if (chars.get() == NULL) {
+        return;
+    }
+    charsToBytes(&chars[offset], cast<jbyte*>(address), length, 0xff);
+}
+
+static jint Charsets_toUtf8BytesDirect(JNIEnv* env, jclass, jcharArray javaChars, jint offset, jint length, jlong address, jint capacity) {
+    ScopedCharArrayRO chars(env, javaChars);
+    if (chars.get() == NULL) {
+        return -1;
+    }
+    const jchar* src = &chars[offset];
+    if (utf8Length(src, length) > static_cast<size_t>(capacity)) {
+        return -1;
     }
-    return out.toByteArray();
+    return charsToUtf8Bytes(src, length, cast<jbyte*>(address));
 }
 
 static JNINativeMethod gMethods[] = {
@@ -244,6 +145,9 @@ static JNINativeMethod gMethods[] = {
     NATIVE_METHOD(Charsets, toAsciiBytes, "([CII)[B"),
     NATIVE_METHOD(Charsets, toIsoLatin1Bytes, "([CII)[B"),
     NATIVE_METHOD(Charsets, toUtf8Bytes, "([CII)[B"),
+    NATIVE_METHOD(Charsets, toAsciiBytesDirect, "([CIIJ)V"),
+    NATIVE_METHOD(Charsets, toIsoLatin1BytesDirect, "([CIIJ)V"),
+    NATIVE_METHOD(Charsets, toUtf8BytesDirect, "([CIIJI)I"),
 };
 void register_java_nio_charset_Charsets(JNIEnv* env) {
     jniRegisterNativeMethods(env, "java/nio/charset/Charsets", gMethods, NELEM(gMethods));
@@ -19,12 +19,12 @@
 
 #include "IcuUtilities.h"
 #include "JNIHelp.h"
-#include "JniConstants.h"
 #include "JniException.h"
 #include "ScopedPrimitiveArray.h"
 #include "UniquePtr.h"
 #include "unicode/ubidi.h"
 
+#include <stdint.h>
 #include <stdlib.h>
 #include <string.h>
 
@@ -65,6 +65,64 @@ static UBiDi* uBiDi(jlong ptr) {
     return reinterpret_cast<BiDiData*>(static_cast<uintptr_t>(ptr))->uBiDi();
 }
 
+// SWAR helpers treating a uint64_t as four UTF-16 code units.
+static const uint64_t kLaneOnes = 0x0001000100010001ULL;
+static const uint64_t kLaneHighBits = 0x8000800080008000ULL;
+
+// Returns true if every lane of 'w' is below 'limit', which must be at most 0x8000.
+static inline bool allLanesBelow(uint64_t w, jchar limit) {
+    return ((w | (w + (0x8000 - limit) * kLaneOnes)) & kLaneHighBits) == 0;
+}
+
+// The first char that can be right-to-left, an Arabic number, or an explicit embedding,
+// override, or isolate. Everything below it is Latin, Greek, Cyrillic, Armenian, and so on.
+static const jchar kFirstBidiChar = 0x0590;
+
+// Returns true if 'ch' might make a paragraph laid out left-to-right need more than one level.
+// Surrogates are treated as such without decoding, as are the handful of left-to-right
+// characters within these ranges, so false positives are possible but false negatives aren't.
+static bool isBidiChar(jchar ch) {
+    return (ch >= kFirstBidiChar && ch <= 0x08ff) ||  // Hebrew, Arabic, Syriac, Thaana, NKo...
+            ch == 0x200f ||  // RIGHT-TO-LEFT MARK
+            (ch >= 0x202a && ch <= 0x202e) ||  // Embeddings, overrides, and PDF.
+            (ch >= 0x2066 && ch <= 0x2069) ||  // Isolates and PDI.
+            (ch >= 0xd800 && ch <= 0xdfff) ||  // Supplementary scripts such as Phoenician.
+            (ch >= 0xfb1d && ch <= 0xfdff) ||  // Hebrew and Arabic presentation forms.
+            (ch >= 0xfe70 && ch <= 0xfeff);  // Arabic presentation forms B.
+}
+
+// Returns true if Bidi must run the full algorithm on text[start, start + length). If this
+// returns false, the text is a single run at the paragraph level for left-to-right and
+// default-left-to-right paragraphs, which is by far the common case. The caller is responsible
+// for checking the bounds.
+static jboolean Bidi_containsBidiChars(JNIEnv* env, jclass, jcharArray text, jint start,
+                                       jint length) {
+    ScopedCharArrayRO chars(env, text);
+    if (chars.get() == NULL) {
+        return JNI_FALSE;
+    }
+    const jchar* src = chars.get() + start;
+    jint i = 0;
+    for (; i + 4 <= length; i += 4) {
+        uint64_t w;
+        memcpy(&w, src + i, sizeof(w));
+        if (allLanesBelow(w, kFirstBidiChar)) {
+            continue;
+        }
+        for (jint j = i; j < i + 4; ++j) {
+            if (isBidiChar(src[j])) {
+                return JNI_TRUE;
+            }
+        }
+    }
+    for (; i < length; ++i) {
+        if (isBidiChar(src[i])) {
+            return JNI_TRUE;
+        }
+    }
+    return JNI_FALSE;
+}
+
 static jlong Bidi_ubidi_open(JNIEnv*, jclass) {
     return reinterpret_cast<uintptr_t>(new BiDiData(ubidi_open()));
 }
@@ -136,28 +194,32 @@ static jint Bidi_ubidi_countRuns(JNIEnv* env, jclass, jlong ptr) {
 }
 
 /**
- * TODO: if we care about performance, we might just want to use an int[] instead of a Run[].
+ * Returns all the logical runs as consecutive (start, limit, level) triples, which saves
+ * allocating an object per run.
  */
-static jobjectArray Bidi_ubidi_getRuns(JNIEnv* env, jclass, jlong ptr) {
+static jintArray Bidi_ubidi_getRuns(JNIEnv* env, jclass, jlong ptr) {
     UBiDi* ubidi = uBiDi(ptr);
     UErrorCode status = U_ZERO_ERROR;
     int runCount = ubidi_countRuns(ubidi, &status);
     if (maybeThrowIcuException(env, "ubidi_countRuns", status)) {
         return NULL;
     }
-    static jmethodID bidiRunConstructor =
-            env->GetMethodID(JniConstants::bidiRunClass, "<init>", "(III)V");
-    jobjectArray runs = env->NewObjectArray(runCount, JniConstants::bidiRunClass, NULL);
+    UniquePtr<jint[]> runs(new jint[3 * runCount]);
     UBiDiLevel level = 0;
     int start = 0;
     int limit = 0;
     for (int i = 0; i < runCount; ++i) {
         ubidi_getLogicalRun(ubidi, start, &limit, &level);
-        jobject run = env->NewObject(JniConstants::bidiRunClass, bidiRunConstructor, start, limit, level);
-        env->SetObjectArrayElement(runs, i, run);
+        runs[3 * i] = start;
+        runs[3 * i + 1] = limit;
+        runs[3 * i + 2] = level;
         start = limit;
     }
-    return runs;
+    jintArray result = env->NewIntArray(3 * runCount);
+    if (result != NULL) {
+        env->SetIntArrayRegion(result, 0, 3 * runCount, &runs[0]);
+    }
+    return result;
 }
 
 static jintArray Bidi_ubidi_reorderVisual(JNIEnv* env, jclass, jbyteArray javaLevels, jint length) {
@@ -177,13 +239,14 @@ static jintArray Bidi_ubidi_reorderVisual(JNIEnv* env, jclass, jbyteArray javaLe
 }
 
 static JNINativeMethod gMethods[] = {
+    NATIVE_METHOD(Bidi, containsBidiChars, "([CII)Z"),
     NATIVE_METHOD(Bidi, ubidi_close, "(J)V"),
     NATIVE_METHOD(Bidi, ubidi_countRuns, "(J)I"),
     NATIVE_METHOD(Bidi, ubidi_getDirection, "(J)I"),
     NATIVE_METHOD(Bidi, ubidi_getLength, "(J)I"),
     NATIVE_METHOD(Bidi, ubidi_getLevels, "(J)[B"),
     NATIVE_METHOD(Bidi, ubidi_getParaLevel, "(J)B"),
-    NATIVE_METHOD(Bidi, ubidi_getRuns, "(J)[Ljava/text/Bidi$Run;"),
+    NATIVE_METHOD(Bidi, ubidi_getRuns, "(J)[I"),
     NATIVE_METHOD(Bidi, ubidi_open, "()J"),
     NATIVE_METHOD(Bidi, ubidi_reorderVisual, "([BI)[I"),
     NATIVE_METHOD(Bidi, ubidi_setLine, "(JII)J"),
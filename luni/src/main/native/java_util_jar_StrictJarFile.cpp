@@ -18,6 +18,7 @@
 #define LOG_TAG "StrictJarFile"
 
 #include <string>
+#include <vector>
 
 #include "JNIHelp.h"
 #include "JniConstants.h"
@@ -132,6 +133,61 @@ static jobject StrictJarFile_nativeNextEntry(JNIEnv* env, jobject, jlong iterati
   return newZipEntry(env, data, entryNameString.get());
 }
 
+// nativeReadEntries reports these values per entry, in this order: CRC-32, compressed length,
+// uncompressed length, compression method, and data offset.
+static const size_t ENTRY_FIELD_COUNT = 5;
+
+static jobjectArray StrictJarFile_nativeReadEntries(JNIEnv* env, jobject, jlong nativeHandle,
+                                                    jobjectArray javaFields) {
+  IterationHandle handle;
+  int32_t error = StartIteration(reinterpret_cast<ZipArchiveHandle>(nativeHandle),
+                                 handle.CookieAddress(), NULL);
+  if (error) {
+    throwIoException(env, error);
+    return NULL;
+  }
+
+  // Gather everything first so we can size the Java arrays exactly.
+  std::vector<std::string> names;
+  std::vector<jlong> fields;
+  ZipEntry data;
+  ZipEntryName entryName;
+  while (Next(*handle.CookieAddress(), &data, &entryName) == 0) {
+    names.push_back(std::string(reinterpret_cast<const char*>(entryName.name),
+                                entryName.name_length));
+    fields.push_back(static_cast<jlong>(data.crc32));
+    fields.push_back(static_cast<jlong>(data.compressed_length));
+    fields.push_back(static_cast<jlong>(data.uncompressed_length));
+    fields.push_back(static_cast<jlong>(data.method));
+    fields.push_back(static_cast<jlong>(data.offset));
+  }
+
+  ScopedLocalRef<jlongArray> javaFieldValues(env, env->NewLongArray(fields.size()));
+  if (javaFieldValues.get() == NULL) {
+    return NULL;
+  }
+  if (!fields.empty()) {
+    env->SetLongArrayRegion(javaFieldValues.get(), 0, fields.size(), &fields[0]);
+  }
+  env->SetObjectArrayElement(javaFields, 0, javaFieldValues.get());
+  if (env->ExceptionCheck()) {
+    return NULL;
+  }
+
+  jobjectArray javaNames = env->NewObjectArray(names.size(), JniConstants::stringClass, NULL);
+  if (javaNames == NULL) {
+    return NULL;
+  }
+  for (size_t i = 0; i < names.size(); ++i) {
+    ScopedLocalRef<jstring> name(env, env->NewStringUTF(names[i].c_str()));
+    if (name.get() == NULL) {
+      return NULL;
+    }
+    env->SetObjectArrayElement(javaNames, i, name.get());
+  }
+  return javaNames;
+}
+
 static jobject StrictJarFile_nativeFindEntry(JNIEnv* env, jobject, jlong nativeHandle,
                                              jstring entryName) {
   ScopedUtfChars entryNameChars(env, entryName);
@@ -158,6 +214,7 @@ static JNINativeMethod gMethods[] = {
   NATIVE_METHOD(StrictJarFile, nativeStartIteration, "(JLjava/lang/String;)J"),
   NATIVE_METHOD(StrictJarFile, nativeNextEntry, "(J)Ljava/util/zip/ZipEntry;"),
   NATIVE_METHOD(StrictJarFile, nativeFindEntry, "(JLjava/lang/String;)Ljava/util/zip/ZipEntry;"),
+  NATIVE_METHOD(StrictJarFile, nativeReadEntries, "(J[[J)[Ljava/lang/String;"),
   NATIVE_METHOD(StrictJarFile, nativeClose, "(J)V"),
 };
 
@@ -30,8 +30,33 @@
 
 // ICU documentation: http://icu-project.org/apiref/icu4c/classRegexMatcher.html
 
-static RegexMatcher* toRegexMatcher(jlong address) {
-    return reinterpret_cast<RegexMatcher*>(static_cast<uintptr_t>(address));
+/**
+ * The native peer of a Java Matcher: the ICU matcher, plus the UText we use
+ * to point it at the Java input. The UText lives here rather than being
+ * opened per call, so binding the input never allocates. We also remember
+ * where it pointed, so that a call that finds the input's characters at the
+ * same address (as successive find() calls in a loop usually do) can skip
+ * rebinding altogether.
+ */
+struct NativeMatcher {
+    NativeMatcher(RegexMatcher* matcher) : matcher(matcher), boundChars(NULL), boundLength(-1) {
+        UText initialText = UTEXT_INITIALIZER;
+        text = initialText;
+    }
+
+    ~NativeMatcher() {
+        utext_close(&text);
+        delete matcher;
+    }
+
+    RegexMatcher* matcher;
+    UText text;
+    const jchar* boundChars;
+    jsize boundLength;
+};
+
+static NativeMatcher* toNativeMatcher(jlong address) {
+    return reinterpret_cast<NativeMatcher*>(static_cast<uintptr_t>(address));
 }
 
 /**
@@ -51,16 +76,26 @@ public:
             return;
         }
 
-        mUText = utext_openUChars(NULL, mChars, env->GetStringLength(mJavaInput), &mStatus);
-        if (mUText == NULL) {
+        // Strings are immutable, so if our input's characters are where they
+        // were last time, the matcher is already looking at them.
+        jsize length = env->GetStringLength(mJavaInput);
+        if (!reset && mChars == mNative->boundChars && length == mNative->boundLength) {
+            return;
+        }
+
+        UText* text = utext_openUChars(&mNative->text, mChars, length, &mStatus);
+        if (text == NULL || U_FAILURE(mStatus)) {
+            mNative->boundChars = NULL;
             return;
         }
 
         if (reset) {
-            mMatcher->reset(mUText);
+            mMatcher->reset(text);
         } else {
-            mMatcher->refreshInputText(mUText, mStatus);
+            mMatcher->refreshInputText(text, mStatus);
         }
+        mNative->boundChars = mChars;
+        mNative->boundLength = length;
     }
 
     MatcherAccessor(JNIEnv* env, jlong address) {
@@ -68,11 +103,10 @@ public:
     }
 
     ~MatcherAccessor() {
-        utext_close(mUText);
-        if (mJavaInput) {
+        if (mJavaInput && mChars) {
             mEnv->ReleaseStringChars(mJavaInput, mChars);
         }
-        maybeThrowIcuException(mEnv, "utext_close", mStatus);
+        maybeThrowIcuException(mEnv, "utext_openUChars", mStatus);
     }
 
     RegexMatcher* operator->() {
@@ -99,18 +133,18 @@ private:
     void init(JNIEnv* env, jlong address) {
         mEnv = env;
         mJavaInput = NULL;
-        mMatcher = toRegexMatcher(address);
+        mNative = toNativeMatcher(address);
+        mMatcher = mNative->matcher;
         mChars = NULL;
         mStatus = U_ZERO_ERROR;
-        mUText = NULL;
     }
 
     JNIEnv* mEnv;
     jstring mJavaInput;
+    NativeMatcher* mNative;
     RegexMatcher* mMatcher;
     const jchar* mChars;
     UErrorCode mStatus;
-    UText* mUText;
 
     // Disallow copy and assignment.
     MatcherAccessor(const MatcherAccessor&);
@@ -118,7 +152,37 @@ private:
 };
 
 static void Matcher_closeImpl(JNIEnv*, jclass, jlong address) {
-    delete toRegexMatcher(address);
+    delete toNativeMatcher(address);
+}
+
+/**
+ * Runs the find() loop here rather than in Java, writing the offsets of group 0 and each
+ * capturing group for every match into consecutive rows of 'javaOffsets'. Returns the
+ * number of matches found, which is less than 'maxMatches' only if the input ran out.
+ */
+static jint Matcher_findAllImpl(JNIEnv* env, jclass, jlong addr, jstring javaText, jintArray javaOffsets, jint maxMatches) {
+    MatcherAccessor matcher(env, addr, javaText, false);
+    if (matcher.status() != U_ZERO_ERROR) {
+        return -1;
+    }
+    ScopedIntArrayRW offsets(env, javaOffsets);
+    if (offsets.get() == NULL) {
+        return -1;
+    }
+
+    size_t groupCount = matcher->groupCount();
+    size_t stride = 2 * (groupCount + 1);
+    size_t maxRows = offsets.size() / stride;
+    jint count = 0;
+    while (count < maxMatches && static_cast<size_t>(count) < maxRows && matcher->find()) {
+        jint* row = &offsets[count * stride];
+        for (size_t i = 0; i <= groupCount; ++i) {
+            row[2*i + 0] = matcher->start(i, matcher.status());
+            row[2*i + 1] = matcher->end(i, matcher.status());
+        }
+        ++count;
+    }
+    return count;
 }
 
 static jint Matcher_findImpl(JNIEnv* env, jclass, jlong addr, jstring javaText, jint startIndex, jintArray offsets) {
@@ -174,8 +238,11 @@ static jlong Matcher_openImpl(JNIEnv* env, jclass, jlong patternAddr) {
     RegexPattern* pattern = reinterpret_cast<RegexPattern*>(static_cast<uintptr_t>(patternAddr));
     UErrorCode status = U_ZERO_ERROR;
     RegexMatcher* result = pattern->matcher(status);
-    maybeThrowIcuException(env, "RegexPattern::matcher", status);
-    return reinterpret_cast<uintptr_t>(result);
+    if (maybeThrowIcuException(env, "RegexPattern::matcher", status)) {
+        delete result;
+        return 0;
+    }
+    return reinterpret_cast<uintptr_t>(new NativeMatcher(result));
 }
 
 static jint Matcher_requireEndImpl(JNIEnv* env, jclass, jlong addr) {
@@ -200,6 +267,7 @@ static void Matcher_useTransparentBoundsImpl(JNIEnv* env, jclass, jlong addr, jb
 
 static JNINativeMethod gMethods[] = {
     NATIVE_METHOD(Matcher, closeImpl, "(J)V"),
+    NATIVE_METHOD(Matcher, findAllImpl, "(JLjava/lang/String;[II)I"),
     NATIVE_METHOD(Matcher, findImpl, "(JLjava/lang/String;I[I)Z"),
     NATIVE_METHOD(Matcher, findNextImpl, "(JLjava/lang/String;[I)Z"),
     NATIVE_METHOD(Matcher, groupCountImpl, "(J)I"),
@@ -16,11 +16,16 @@
 
 #define LOG_TAG "Pattern"
 
+#include <pthread.h>
 #include <stdlib.h>
 
+#include <list>
+#include <map>
+
 #include "JNIHelp.h"
 #include "JniConstants.h"
 #include "ScopedJavaUnicodeString.h"
+#include "ScopedPthreadMutexLock.h"
 #include "jni.h"
 #include "unicode/parseerr.h"
 #include "unicode/regex.h"
@@ -71,8 +76,86 @@ static void throwPatternSyntaxException(JNIEnv* env, UErrorCode status, jstring
     env->Throw(reinterpret_cast<jthrowable>(exception));
 }
 
+/**
+ * A compiled pattern, shared by every Pattern compiled from the same regular
+ * expression and flags. A RegexPattern is immutable once compiled, and ICU
+ * allows matchers on different threads to use it concurrently.
+ */
+struct CachedPattern {
+    CachedPattern(const UnicodeString& regex, jint flags, RegexPattern* pattern)
+            : regex(regex), flags(flags), pattern(pattern), refCount(1) {
+    }
+
+    ~CachedPattern() {
+        delete pattern;
+    }
+
+    const UnicodeString regex;
+    const jint flags;
+    RegexPattern* const pattern;
+
+    /** One per Java Pattern using this entry, plus one while it's in gPatternCache. */
+    int refCount;
+};
+
+/**
+ * Recently compiled patterns, most recently used first. Code that calls
+ * String.split or String.replaceAll in a loop compiles the same few patterns
+ * over and over; this lets all but the first compile skip ICU's parser.
+ */
+static const size_t PATTERN_CACHE_CAPACITY = 32;
+static std::list<CachedPattern*> gPatternCache;
+
+/** Every live entry, cached or not, keyed by the address we gave to Java. */
+static std::map<RegexPattern*, CachedPattern*> gLivePatterns;
+
+static pthread_mutex_t gPatternCacheMutex = PTHREAD_MUTEX_INITIALIZER;
+
+// Must be called with gPatternCacheMutex held.
+static void unrefPattern(CachedPattern* entry) {
+    if (--entry->refCount == 0) {
+        gLivePatterns.erase(entry->pattern);
+        delete entry;
+    }
+}
+
+static RegexPattern* findCachedPattern(const UnicodeString& regex, jint flags) {
+    ScopedPthreadMutexLock lock(&gPatternCacheMutex);
+    typedef std::list<CachedPattern*>::iterator Iterator;
+    for (Iterator it = gPatternCache.begin(); it != gPatternCache.end(); ++it) {
+        CachedPattern* entry = *it;
+        if (entry->flags == flags && entry->regex == regex) {
+            gPatternCache.splice(gPatternCache.begin(), gPatternCache, it);
+            ++entry->refCount;
+            return entry->pattern;
+        }
+    }
+    return NULL;
+}
+
+static void addCachedPattern(const UnicodeString& regex, jint flags, RegexPattern* pattern) {
+    CachedPattern* entry = new CachedPattern(regex, flags, pattern);
+    ScopedPthreadMutexLock lock(&gPatternCacheMutex);
+    gLivePatterns[pattern] = entry;
+    ++entry->refCount;
+    gPatternCache.push_front(entry);
+    if (gPatternCache.size() > PATTERN_CACHE_CAPACITY) {
+        CachedPattern* evicted = gPatternCache.back();
+        gPatternCache.pop_back();
+        unrefPattern(evicted);
+    }
+}
+
 static void Pattern_closeImpl(JNIEnv*, jclass, jlong addr) {
-    delete toRegexPattern(addr);
+    RegexPattern* pattern = toRegexPattern(addr);
+    if (pattern == NULL) {
+        return;
+    }
+    ScopedPthreadMutexLock lock(&gPatternCacheMutex);
+    std::map<RegexPattern*, CachedPattern*>::iterator it = gLivePatterns.find(pattern);
+    if (it != gLivePatterns.end()) {
+        unrefPattern(it->second);
+    }
 }
 
 static jlong Pattern_compileImpl(JNIEnv* env, jclass, jstring javaRegex, jint flags) {
@@ -87,10 +170,20 @@ static jlong Pattern_compileImpl(JNIEnv* env, jclass, jstring javaRegex, jint fl
         return 0;
     }
     UnicodeString& regexString(regex.unicodeString());
-    RegexPattern* result = RegexPattern::compile(regexString, flags, error, status);
+    RegexPattern* result = findCachedPattern(regexString, flags);
+    if (result != NULL) {
+        return static_cast<jlong>(reinterpret_cast<uintptr_t>(result));
+    }
+
+    // We compile without holding the lock. If another thread races us to
+    // compile the same pattern, both copies work; the loser just ages out.
+    result = RegexPattern::compile(regexString, flags, error, status);
     if (!U_SUCCESS(status)) {
+        delete result;
         throwPatternSyntaxException(env, status, javaRegex, error);
+        return 0;
     }
+    addCachedPattern(regexString, flags, result);
     return static_cast<jlong>(reinterpret_cast<uintptr_t>(result));
 }
 
@@ -20,6 +20,7 @@
 #include "JNIHelp.h"
 #include "JniConstants.h"
 #include "ScopedPrimitiveArray.h"
+#include "ZipChecksums.h"
 #include "jni.h"
 #include "zlib.h"
 
@@ -28,17 +29,21 @@ static jlong Adler32_updateImpl(JNIEnv* env, jobject, jbyteArray byteArray, int
     if (bytes.get() == NULL) {
         return 0;
     }
-    return adler32(crc, reinterpret_cast<const Bytef*>(bytes.get() + off), len);
+    return fastAdler32(crc, reinterpret_cast<const Bytef*>(bytes.get() + off), len);
 }
 
-static jlong Adler32_updateByteImpl(JNIEnv*, jobject, jint val, jlong crc) {
-    Bytef bytefVal = val;
-    return adler32(crc, reinterpret_cast<const Bytef*>(&bytefVal), 1);
+static jlong Adler32_updateAddressImpl(JNIEnv*, jclass, jlong address, jint len, jlong crc) {
+    return fastAdler32(crc, reinterpret_cast<const Bytef*>(static_cast<uintptr_t>(address)), len);
+}
+
+static jlong Adler32_combineImpl(JNIEnv*, jclass, jlong adler1, jlong adler2, jlong len2) {
+    return adler32_combine(adler1, adler2, len2);
 }
 
 static JNINativeMethod gMethods[] = {
+    NATIVE_METHOD(Adler32, combineImpl, "(JJJ)J"),
+    NATIVE_METHOD(Adler32, updateAddressImpl, "(JIJ)J"),
     NATIVE_METHOD(Adler32, updateImpl, "([BIIJ)J"),
-    NATIVE_METHOD(Adler32, updateByteImpl, "(IJ)J"),
 };
 void register_java_util_zip_Adler32(JNIEnv* env) {
     jniRegisterNativeMethods(env, "java/util/zip/Adler32", gMethods, NELEM(gMethods));
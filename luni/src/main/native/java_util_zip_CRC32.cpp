@@ -20,6 +20,7 @@
 #include "JNIHelp.h"
 #include "JniConstants.h"
 #include "ScopedPrimitiveArray.h"
+#include "ZipChecksums.h"
 #include "jni.h"
 #include "zlib.h"
 
@@ -28,17 +29,22 @@ static jlong CRC32_updateImpl(JNIEnv* env, jobject, jbyteArray byteArray, int of
     if (bytes.get() == NULL) {
         return 0;
     }
-    jlong result = crc32(crc, reinterpret_cast<const Bytef*>(bytes.get() + off), len);
+    jlong result = fastCrc32(crc, reinterpret_cast<const Bytef*>(bytes.get() + off), len);
     return result;
 }
 
-static jlong CRC32_updateByteImpl(JNIEnv*, jobject, jbyte val, jlong crc) {
-    return crc32(crc, reinterpret_cast<const Bytef*>(&val), 1);
+static jlong CRC32_updateAddressImpl(JNIEnv*, jclass, jlong address, jint len, jlong crc) {
+    return fastCrc32(crc, reinterpret_cast<const Bytef*>(static_cast<uintptr_t>(address)), len);
+}
+
+static jlong CRC32_combineImpl(JNIEnv*, jclass, jlong crc1, jlong crc2, jlong len2) {
+    return crc32_combine(crc1, crc2, len2);
 }
 
 static JNINativeMethod gMethods[] = {
+    NATIVE_METHOD(CRC32, combineImpl, "(JJJ)J"),
+    NATIVE_METHOD(CRC32, updateAddressImpl, "(JIJ)J"),
     NATIVE_METHOD(CRC32, updateImpl, "([BIIJ)J"),
-    NATIVE_METHOD(CRC32, updateByteImpl, "(BJ)J"),
 };
 void register_java_util_zip_CRC32(JNIEnv* env) {
     jniRegisterNativeMethods(env, "java/util/zip/CRC32", gMethods, NELEM(gMethods));
@@ -19,6 +19,7 @@
 
 #include "JniConstants.h"
 #include "JniException.h"
+#include "NativeCounters.h"
 #include "ScopedPrimitiveArray.h"
 #include "ZipUtilities.h"
 #include "zutil.h" // For DEF_WBITS and DEF_MEM_LEVEL.
@@ -40,6 +41,20 @@ static jint Deflater_getAdlerImpl(JNIEnv*, jobject, jlong handle) {
 }
 
 static jlong Deflater_createStream(JNIEnv * env, jobject, jint level, jint strategy, jboolean noHeader) {
+    int poolKind = noHeader ? POOL_DEFLATE_RAW : POOL_DEFLATE_ZLIB;
+    NativeZipStream* pooled = takePooledZipStream(poolKind);
+    if (pooled != NULL) {
+        // The level and strategy aren't part of the pool kind: deflateParams on a stream with
+        // no pending input just records them. (Deflater applies them again on first input.)
+        int err = deflateParams(&pooled->stream, level, strategy);
+        if (err != Z_OK) {
+            throwExceptionForZlibError(env, "java/lang/IllegalArgumentException", err, pooled);
+            releaseZipStream(pooled);
+            return -1;
+        }
+        return reinterpret_cast<uintptr_t>(pooled);
+    }
+
     UniquePtr<NativeZipStream> jstream(new NativeZipStream);
     if (jstream.get() == NULL) {
         jniThrowOutOfMemoryError(env, NULL);
@@ -61,6 +76,7 @@ static jlong Deflater_createStream(JNIEnv * env, jobject, jint level, jint strat
         throwExceptionForZlibError(env, "java/lang/IllegalArgumentException", err, jstream.get());
         return -1;
     }
+    jstream->poolKind = poolKind;
     return reinterpret_cast<uintptr_t>(jstream.release());
 }
 
@@ -68,13 +84,12 @@ static void Deflater_setInputImpl(JNIEnv* env, jobject, jbyteArray buf, jint off
     toNativeZipStream(handle)->setInput(env, buf, off, len);
 }
 
-static jint Deflater_deflateImpl(JNIEnv* env, jobject recv, jbyteArray buf, int off, int len, jlong handle, int flushStyle) {
-    NativeZipStream* stream = toNativeZipStream(handle);
-    ScopedByteArrayRW out(env, buf);
-    if (out.get() == NULL) {
-        return -1;
-    }
-    stream->stream.next_out = reinterpret_cast<Bytef*>(out.get() + off);
+static void Deflater_setInputAddressImpl(JNIEnv*, jobject, jlong address, jint len, jlong handle) {
+    toNativeZipStream(handle)->setInput(address, len);
+}
+
+static jint deflateInto(JNIEnv* env, jobject recv, NativeZipStream* stream, Bytef* out, jint len, int flushStyle) {
+    stream->stream.next_out = out;
     stream->stream.avail_out = len;
 
     Bytef* initialNextIn = stream->stream.next_in;
@@ -105,13 +120,24 @@ static jint Deflater_deflateImpl(JNIEnv* env, jobject recv, jbyteArray buf, int
     jint inReadValue = env->GetIntField(recv, inReadField);
     inReadValue += bytesRead;
     env->SetIntField(recv, inReadField, inReadValue);
+    countNativeBytes(bytesRead + bytesWritten);
     return bytesWritten;
 }
 
+static jint Deflater_deflateImpl(JNIEnv* env, jobject recv, jbyteArray buf, int off, int len, jlong handle, int flushStyle) {
+    ScopedByteArrayRW out(env, buf);
+    if (out.get() == NULL) {
+        return -1;
+    }
+    return deflateInto(env, recv, toNativeZipStream(handle), reinterpret_cast<Bytef*>(out.get() + off), len, flushStyle);
+}
+
+static jint Deflater_deflateAddressImpl(JNIEnv* env, jobject recv, jlong address, int len, jlong handle, int flushStyle) {
+    return deflateInto(env, recv, toNativeZipStream(handle), reinterpret_cast<Bytef*>(static_cast<uintptr_t>(address)), len, flushStyle);
+}
+
 static void Deflater_endImpl(JNIEnv*, jobject, jlong handle) {
-    NativeZipStream* stream = toNativeZipStream(handle);
-    deflateEnd(&stream->stream);
-    delete stream;
+    releaseZipStream(toNativeZipStream(handle));
 }
 
 static void Deflater_resetImpl(JNIEnv* env, jobject, jlong handle) {
@@ -138,6 +164,7 @@ static void Deflater_setLevelsImpl(JNIEnv* env, jobject, int level, int strategy
 
 static JNINativeMethod gMethods[] = {
     NATIVE_METHOD(Deflater, createStream, "(IIZ)J"),
+    NATIVE_METHOD(Deflater, deflateAddressImpl, "(JIJI)I"),
     NATIVE_METHOD(Deflater, deflateImpl, "([BIIJI)I"),
     NATIVE_METHOD(Deflater, endImpl, "(J)V"),
     NATIVE_METHOD(Deflater, getAdlerImpl, "(J)I"),
@@ -145,6 +172,7 @@ static JNINativeMethod gMethods[] = {
     NATIVE_METHOD(Deflater, getTotalOutImpl, "(J)J"),
     NATIVE_METHOD(Deflater, resetImpl, "(J)V"),
     NATIVE_METHOD(Deflater, setDictionaryImpl, "([BIIJ)V"),
+    NATIVE_METHOD(Deflater, setInputAddressImpl, "(JIJ)V"),
     NATIVE_METHOD(Deflater, setInputImpl, "([BIIJ)V"),
     NATIVE_METHOD(Deflater, setLevelsImpl, "(IIJ)V"),
 };
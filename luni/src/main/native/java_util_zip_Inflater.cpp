@@ -19,12 +19,25 @@
 
 #include "JniConstants.h"
 #include "JniException.h"
+#include "NativeCounters.h"
+#include "Portability.h"
 #include "ScopedPrimitiveArray.h"
 #include "ZipUtilities.h"
 #include "zutil.h" // For DEF_WBITS and DEF_MEM_LEVEL.
 #include <errno.h>
+#include <unistd.h>
+
+#if defined(__MINGW32__) || defined(__MINGW64__)
+#include "mingw-extensions.h" // For pread64.
+#endif
 
 static jlong Inflater_createStream(JNIEnv* env, jobject, jboolean noHeader) {
+    int poolKind = noHeader ? POOL_INFLATE_RAW : POOL_INFLATE_ZLIB;
+    NativeZipStream* pooled = takePooledZipStream(poolKind);
+    if (pooled != NULL) {
+        return reinterpret_cast<uintptr_t>(pooled);
+    }
+
     UniquePtr<NativeZipStream> jstream(new NativeZipStream);
     if (jstream.get() == NULL) {
         jniThrowOutOfMemoryError(env, NULL);
@@ -45,6 +58,7 @@ static jlong Inflater_createStream(JNIEnv* env, jobject, jboolean noHeader) {
         throwExceptionForZlibError(env, "java/lang/IllegalArgumentException", err, jstream.get());
         return -1;
     }
+    jstream->poolKind = poolKind;
     return reinterpret_cast<uintptr_t>(jstream.release());
 }
 
@@ -56,9 +70,11 @@ static jint Inflater_setFileInputImpl(JNIEnv* env, jobject, jobject javaFileDesc
     NativeZipStream* stream = toNativeZipStream(handle);
 
     // We reuse the existing native buffer if it's large enough.
-    // TODO: benchmark.
     if (stream->inCap < len) {
         stream->setInput(env, NULL, 0, len);
+        if (stream->input.get() == NULL) {
+            return 0;
+        }
     } else {
         stream->stream.next_in = reinterpret_cast<Bytef*>(&stream->input[0]);
         stream->stream.avail_in = len;
@@ -66,35 +82,33 @@ static jint Inflater_setFileInputImpl(JNIEnv* env, jobject, jobject javaFileDesc
 
     // As an Android-specific optimization, we read directly onto the native heap.
     // The original code used Java to read onto the Java heap and then called setInput(byte[]).
-    // TODO: benchmark.
+    // We use pread(2) rather than lseek(2) and read(2) so that the shared file offset is left
+    // alone: callers needn't serialize on the file, and several entries of one zip file can be
+    // inflated concurrently.
     int fd = jniGetFDFromFileDescriptor(env, javaFileDescriptor);
-    int rc = TEMP_FAILURE_RETRY(lseek(fd, off, SEEK_SET));
-    if (rc == -1) {
-        jniThrowIOException(env, errno);
-        return 0;
-    }
     jint totalByteCount = 0;
     Bytef* dst = reinterpret_cast<Bytef*>(&stream->input[0]);
-    ssize_t byteCount;
-    while ((byteCount = TEMP_FAILURE_RETRY(read(fd, dst, len))) > 0) {
+    ssize_t byteCount = 0;
+    while (len > 0 && (byteCount = TEMP_FAILURE_RETRY(pread64(fd, dst, len, off))) > 0) {
         dst += byteCount;
+        off += byteCount;
         len -= byteCount;
         totalByteCount += byteCount;
     }
-    if (byteCount == -1) {
+    if (len > 0 && byteCount == -1) {
         jniThrowIOException(env, errno);
         return 0;
     }
+    stream->stream.avail_in = totalByteCount;
     return totalByteCount;
 }
 
-static jint Inflater_inflateImpl(JNIEnv* env, jobject recv, jbyteArray buf, int off, int len, jlong handle) {
-    NativeZipStream* stream = toNativeZipStream(handle);
-    ScopedByteArrayRW out(env, buf);
-    if (out.get() == NULL) {
-        return -1;
-    }
-    stream->stream.next_out = reinterpret_cast<Bytef*>(out.get() + off);
+static void Inflater_setInputAddressImpl(JNIEnv*, jobject, jlong address, jint len, jlong handle) {
+    toNativeZipStream(handle)->setInput(address, len);
+}
+
+static jint inflateInto(JNIEnv* env, jobject recv, NativeZipStream* stream, Bytef* out, jint len) {
+    stream->stream.next_out = out;
     stream->stream.avail_out = len;
 
     Bytef* initialNextIn = stream->stream.next_in;
@@ -126,17 +140,28 @@ static jint Inflater_inflateImpl(JNIEnv* env, jobject recv, jbyteArray buf, int
     jint inReadValue = env->GetIntField(recv, inReadField);
     inReadValue += bytesRead;
     env->SetIntField(recv, inReadField, inReadValue);
+    countNativeBytes(bytesRead + bytesWritten);
     return bytesWritten;
 }
 
+static jint Inflater_inflateImpl(JNIEnv* env, jobject recv, jbyteArray buf, int off, int len, jlong handle) {
+    ScopedByteArrayRW out(env, buf);
+    if (out.get() == NULL) {
+        return -1;
+    }
+    return inflateInto(env, recv, toNativeZipStream(handle), reinterpret_cast<Bytef*>(out.get() + off), len);
+}
+
+static jint Inflater_inflateAddressImpl(JNIEnv* env, jobject recv, jlong address, int len, jlong handle) {
+    return inflateInto(env, recv, toNativeZipStream(handle), reinterpret_cast<Bytef*>(static_cast<uintptr_t>(address)), len);
+}
+
 static jint Inflater_getAdlerImpl(JNIEnv*, jobject, jlong handle) {
     return toNativeZipStream(handle)->stream.adler;
 }
 
 static void Inflater_endImpl(JNIEnv*, jobject, jlong handle) {
-    NativeZipStream* stream = toNativeZipStream(handle);
-    inflateEnd(&stream->stream);
-    delete stream;
+    releaseZipStream(toNativeZipStream(handle));
 }
 
 static void Inflater_setDictionaryImpl(JNIEnv* env, jobject, jbyteArray dict, int off, int len, jlong handle) {
@@ -165,9 +190,11 @@ static JNINativeMethod gMethods[] = {
     NATIVE_METHOD(Inflater, getAdlerImpl, "(J)I"),
     NATIVE_METHOD(Inflater, getTotalInImpl, "(J)J"),
     NATIVE_METHOD(Inflater, getTotalOutImpl, "(J)J"),
+    NATIVE_METHOD(Inflater, inflateAddressImpl, "(JIJ)I"),
     NATIVE_METHOD(Inflater, inflateImpl, "([BIIJ)I"),
     NATIVE_METHOD(Inflater, resetImpl, "(J)V"),
     NATIVE_METHOD(Inflater, setDictionaryImpl, "([BIIJ)V"),
+    NATIVE_METHOD(Inflater, setInputAddressImpl, "(JIJ)V"),
     NATIVE_METHOD(Inflater, setFileInputImpl, "(Ljava/io/FileDescriptor;JIJ)I"),
     NATIVE_METHOD(Inflater, setInputImpl, "([BIIJ)V"),
 };
@@ -0,0 +1,125 @@
+/*
+ * Copyright (C) 2014 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#define LOG_TAG "Lz4Compressor"
+
+#include "JNIHelp.h"
+#include "JniException.h"
+#include "Lz4Frame.h"
+#include "NativeCounters.h"
+#include "ScopedLocalRef.h"
+#include "ScopedPrimitiveArray.h"
+#include "UniquePtr.h"
+
+// Lz4Compressor's fields, which the natives update like Deflater's.
+static jfieldID gInReadField;
+static jfieldID gFinishedField;
+static jfieldID gPendingOutputField;
+
+static Lz4FrameEncoder* toEncoder(jlong handle) {
+    return reinterpret_cast<Lz4FrameEncoder*>(static_cast<uintptr_t>(handle));
+}
+
+static jlong Lz4Compressor_createStream(JNIEnv* env, jobject) {
+    UniquePtr<Lz4FrameEncoder> encoder(new Lz4FrameEncoder);
+    if (encoder.get() == NULL || !encoder->init()) {
+        jniThrowOutOfMemoryError(env, NULL);
+        return -1;
+    }
+    return reinterpret_cast<uintptr_t>(encoder.release());
+}
+
+static void Lz4Compressor_setDictionaryImpl(JNIEnv* env, jobject, jbyteArray dict, jint off, jint len, jlong handle) {
+    ScopedByteArrayRO dictionary(env, dict);
+    if (dictionary.get() == NULL) {
+        return;
+    }
+    toEncoder(handle)->setDictionary(reinterpret_cast<const uint8_t*>(dictionary.get() + off), len);
+}
+
+static void Lz4Compressor_setInputImpl(JNIEnv* env, jobject, jbyteArray buf, jint off, jint len, jlong handle) {
+    ScopedByteArrayRO bytes(env, buf);
+    if (bytes.get() == NULL) {
+        return;
+    }
+    if (!toEncoder(handle)->copyInput(reinterpret_cast<const uint8_t*>(bytes.get() + off), len)) {
+        jniThrowOutOfMemoryError(env, NULL);
+    }
+}
+
+static void Lz4Compressor_setInputAddressImpl(JNIEnv*, jobject, jlong address, jint len, jlong handle) {
+    toEncoder(handle)->borrowInput(reinterpret_cast<const uint8_t*>(static_cast<uintptr_t>(address)), len);
+}
+
+static jint compressInto(JNIEnv* env, jobject recv, Lz4FrameEncoder* encoder, uint8_t* out, jint len, jboolean flush, jboolean finish) {
+    size_t initialAvailIn = encoder->availIn;
+    size_t bytesWritten = encoder->encode(out, len, flush, finish);
+    jint bytesRead = initialAvailIn - encoder->availIn;
+
+    env->SetIntField(recv, gInReadField, env->GetIntField(recv, gInReadField) + bytesRead);
+    env->SetBooleanField(recv, gFinishedField, encoder->finished());
+    env->SetBooleanField(recv, gPendingOutputField, encoder->hasPendingOutput());
+    countNativeBytes(bytesRead + bytesWritten);
+    return bytesWritten;
+}
+
+static jint Lz4Compressor_compressImpl(JNIEnv* env, jobject recv, jbyteArray buf, jint off, jint len, jlong handle, jboolean flush, jboolean finish) {
+    ScopedByteArrayRW out(env, buf);
+    if (out.get() == NULL) {
+        return -1;
+    }
+    return compressInto(env, recv, toEncoder(handle), reinterpret_cast<uint8_t*>(out.get() + off), len, flush, finish);
+}
+
+static jint Lz4Compressor_compressAddressImpl(JNIEnv* env, jobject recv, jlong address, jint len, jlong handle, jboolean flush, jboolean finish) {
+    return compressInto(env, recv, toEncoder(handle), reinterpret_cast<uint8_t*>(static_cast<uintptr_t>(address)), len, flush, finish);
+}
+
+static void Lz4Compressor_endImpl(JNIEnv*, jobject, jlong handle) {
+    delete toEncoder(handle);
+}
+
+static jlong Lz4Compressor_getTotalInImpl(JNIEnv*, jobject, jlong handle) {
+    return toEncoder(handle)->totalIn;
+}
+
+static jlong Lz4Compressor_getTotalOutImpl(JNIEnv*, jobject, jlong handle) {
+    return toEncoder(handle)->totalOut;
+}
+
+static void Lz4Compressor_resetImpl(JNIEnv*, jobject, jlong handle) {
+    toEncoder(handle)->reset();
+}
+
+static JNINativeMethod gMethods[] = {
+    NATIVE_METHOD(Lz4Compressor, compressAddressImpl, "(JIJZZ)I"),
+    NATIVE_METHOD(Lz4Compressor, compressImpl, "([BIIJZZ)I"),
+    NATIVE_METHOD(Lz4Compressor, createStream, "()J"),
+    NATIVE_METHOD(Lz4Compressor, endImpl, "(J)V"),
+    NATIVE_METHOD(Lz4Compressor, getTotalInImpl, "(J)J"),
+    NATIVE_METHOD(Lz4Compressor, getTotalOutImpl, "(J)J"),
+    NATIVE_METHOD(Lz4Compressor, resetImpl, "(J)V"),
+    NATIVE_METHOD(Lz4Compressor, setDictionaryImpl, "([BIIJ)V"),
+    NATIVE_METHOD(Lz4Compressor, setInputAddressImpl, "(JIJ)V"),
+    NATIVE_METHOD(Lz4Compressor, setInputImpl, "([BIIJ)V"),
+};
+void register_java_util_zip_Lz4Compressor(JNIEnv* env) {
+    ScopedLocalRef<jclass> c(env, env->FindClass("java/util/zip/Lz4Compressor"));
+    gInReadField = env->GetFieldID(c.get(), "inRead", "I");
+    gFinishedField = env->GetFieldID(c.get(), "finished", "Z");
+    gPendingOutputField = env->GetFieldID(c.get(), "pendingOutput", "Z");
+    jniRegisterNativeMethods(env, "java/util/zip/Lz4Compressor", gMethods, NELEM(gMethods));
+}
@@ -0,0 +1,131 @@
+/*
+ * Copyright (C) 2014 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#define LOG_TAG "Lz4Decompressor"
+
+#include "JNIHelp.h"
+#include "JniException.h"
+#include "Lz4Frame.h"
+#include "NativeCounters.h"
+#include "ScopedLocalRef.h"
+#include "ScopedPrimitiveArray.h"
+#include "UniquePtr.h"
+
+// Lz4Decompressor's fields, which the natives update like Inflater's.
+static jfieldID gInReadField;
+static jfieldID gFinishedField;
+static jfieldID gPendingOutputField;
+
+static Lz4FrameDecoder* toDecoder(jlong handle) {
+    return reinterpret_cast<Lz4FrameDecoder*>(static_cast<uintptr_t>(handle));
+}
+
+static jlong Lz4Decompressor_createStream(JNIEnv* env, jobject) {
+    UniquePtr<Lz4FrameDecoder> decoder(new Lz4FrameDecoder);
+    if (decoder.get() == NULL) {
+        jniThrowOutOfMemoryError(env, NULL);
+        return -1;
+    }
+    return reinterpret_cast<uintptr_t>(decoder.release());
+}
+
+static void Lz4Decompressor_setDictionaryImpl(JNIEnv* env, jobject, jbyteArray dict, jint off, jint len, jlong handle) {
+    ScopedByteArrayRO dictionary(env, dict);
+    if (dictionary.get() == NULL) {
+        return;
+    }
+    if (!toDecoder(handle)->setDictionary(reinterpret_cast<const uint8_t*>(dictionary.get() + off), len)) {
+        jniThrowOutOfMemoryError(env, NULL);
+    }
+}
+
+static void Lz4Decompressor_setInputImpl(JNIEnv* env, jobject, jbyteArray buf, jint off, jint len, jlong handle) {
+    ScopedByteArrayRO bytes(env, buf);
+    if (bytes.get() == NULL) {
+        return;
+    }
+    if (!toDecoder(handle)->copyInput(reinterpret_cast<const uint8_t*>(bytes.get() + off), len)) {
+        jniThrowOutOfMemoryError(env, NULL);
+    }
+}
+
+static void Lz4Decompressor_setInputAddressImpl(JNIEnv*, jobject, jlong address, jint len, jlong handle) {
+    toDecoder(handle)->borrowInput(reinterpret_cast<const uint8_t*>(static_cast<uintptr_t>(address)), len);
+}
+
+static jint decompressInto(JNIEnv* env, jobject recv, Lz4FrameDecoder* decoder, uint8_t* out, jint len) {
+    size_t initialAvailIn = decoder->availIn;
+    ssize_t bytesWritten = decoder->decode(out, len);
+    if (bytesWritten < 0) {
+        jniThrowException(env, "java/util/zip/DataFormatException", decoder->error());
+        return -1;
+    }
+    jint bytesRead = initialAvailIn - decoder->availIn;
+
+    env->SetIntField(recv, gInReadField, env->GetIntField(recv, gInReadField) + bytesRead);
+    env->SetBooleanField(recv, gFinishedField, decoder->finished());
+    env->SetBooleanField(recv, gPendingOutputField, decoder->hasPendingOutput());
+    countNativeBytes(bytesRead + bytesWritten);
+    return bytesWritten;
+}
+
+static jint Lz4Decompressor_decompressImpl(JNIEnv* env, jobject recv, jbyteArray buf, jint off, jint len, jlong handle) {
+    ScopedByteArrayRW out(env, buf);
+    if (out.get() == NULL) {
+        return -1;
+    }
+    return decompressInto(env, recv, toDecoder(handle), reinterpret_cast<uint8_t*>(out.get() + off), len);
+}
+
+static jint Lz4Decompressor_decompressAddressImpl(JNIEnv* env, jobject recv, jlong address, jint len, jlong handle) {
+    return decompressInto(env, recv, toDecoder(handle), reinterpret_cast<uint8_t*>(static_cast<uintptr_t>(address)), len);
+}
+
+static void Lz4Decompressor_endImpl(JNIEnv*, jobject, jlong handle) {
+    delete toDecoder(handle);
+}
+
+static jlong Lz4Decompressor_getTotalInImpl(JNIEnv*, jobject, jlong handle) {
+    return toDecoder(handle)->totalIn;
+}
+
+static jlong Lz4Decompressor_getTotalOutImpl(JNIEnv*, jobject, jlong handle) {
+    return toDecoder(handle)->totalOut;
+}
+
+static void Lz4Decompressor_resetImpl(JNIEnv*, jobject, jlong handle) {
+    toDecoder(handle)->reset();
+}
+
+static JNINativeMethod gMethods[] = {
+    NATIVE_METHOD(Lz4Decompressor, createStream, "()J"),
+    NATIVE_METHOD(Lz4Decompressor, decompressAddressImpl, "(JIJ)I"),
+    NATIVE_METHOD(Lz4Decompressor, decompressImpl, "([BIIJ)I"),
+    NATIVE_METHOD(Lz4Decompressor, endImpl, "(J)V"),
+    NATIVE_METHOD(Lz4Decompressor, getTotalInImpl, "(J)J"),
+    NATIVE_METHOD(Lz4Decompressor, getTotalOutImpl, "(J)J"),
+    NATIVE_METHOD(Lz4Decompressor, resetImpl, "(J)V"),
+    NATIVE_METHOD(Lz4Decompressor, setDictionaryImpl, "([BIIJ)V"),
+    NATIVE_METHOD(Lz4Decompressor, setInputAddressImpl, "(JIJ)V"),
+    NATIVE_METHOD(Lz4Decompressor, setInputImpl, "([BIIJ)V"),
+};
+void register_java_util_zip_Lz4Decompressor(JNIEnv* env) {
+    ScopedLocalRef<jclass> c(env, env->FindClass("java/util/zip/Lz4Decompressor"));
+    gInReadField = env->GetFieldID(c.get(), "inRead", "I");
+    gFinishedField = env->GetFieldID(c.get(), "finished", "Z");
+    gPendingOutputField = env->GetFieldID(c.get(), "pendingOutput", "Z");
+    jniRegisterNativeMethods(env, "java/util/zip/Lz4Decompressor", gMethods, NELEM(gMethods));
+}
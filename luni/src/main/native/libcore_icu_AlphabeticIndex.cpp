@@ -22,9 +22,84 @@
 #include "JniException.h"
 #include "ScopedIcuLocale.h"
 #include "ScopedJavaUnicodeString.h"
+#include "ScopedLocalRef.h"
+#include "ScopedPrimitiveArray.h"
+#include "UniquePtr.h"
 #include "unicode/alphaindex.h"
 #include "unicode/uniset.h"
 
+#include <pthread.h>
+
+#include <vector>
+
+// Below this many names per thread, starting a thread costs more than it saves.
+static const jint MIN_NAMES_PER_THREAD = 1024;
+
+// Copies 'javaString' into 'chars' and returns a read-only UnicodeString aliasing them, so that a
+// loop over many names reuses one buffer rather than allocating a UnicodeString for each.
+// Throws and returns false if 'javaString' is null.
+static bool aliasName(JNIEnv* env, jobjectArray javaNames, jint i, std::vector<UChar>& chars,
+                      UnicodeString& name) {
+  ScopedLocalRef<jstring> javaString(env,
+      reinterpret_cast<jstring>(env->GetObjectArrayElement(javaNames, i)));
+  if (javaString.get() == NULL) {
+    jniThrowExceptionFmt(env, "java/lang/NullPointerException", "names[%d] == null", i);
+    return false;
+  }
+  jsize length = env->GetStringLength(javaString.get());
+  chars.resize(length + 1);
+  env->GetStringRegion(javaString.get(), 0, length, &chars[0]);
+  name.setTo(false, &chars[0], length);
+  return true;
+}
+
+// Assigns buckets to names one at a time on the calling thread. 'Index' is either an
+// AlphabeticIndex or an AlphabeticIndex::ImmutableIndex.
+template <typename Index>
+static void getBucketIndicesSerially(JNIEnv* env, Index* index, const char* provider,
+                                     jobjectArray javaNames, jintArray javaOut) {
+  ScopedIntArrayRW out(env, javaOut);
+  if (out.get() == NULL) {
+    return;
+  }
+  jint count = env->GetArrayLength(javaNames);
+  std::vector<UChar> chars;
+  UnicodeString name;
+  for (jint i = 0; i < count; ++i) {
+    if (!aliasName(env, javaNames, i, chars, name)) {
+      return;
+    }
+    UErrorCode status = U_ZERO_ERROR;
+    out[i] = index->getBucketIndex(name, status);
+    if (maybeThrowIcuException(env, provider, status)) {
+      return;
+    }
+  }
+}
+
+// One thread's share of a parallel getBucketIndices: the names in [begin, end), each of which
+// is chars[offsets[i], offsets[i + 1]).
+struct BucketIndexTask {
+  UniquePtr<AlphabeticIndex::ImmutableIndex> index;
+  const UChar* chars;
+  const size_t* offsets;
+  jint* out;
+  jint begin;
+  jint end;
+  UErrorCode status;
+};
+
+static void* runBucketIndexTask(void* arg) {
+  BucketIndexTask* task = reinterpret_cast<BucketIndexTask*>(arg);
+  UnicodeString name;
+  for (jint i = task->begin; i < task->end && U_SUCCESS(task->status); ++i) {
+    const size_t* offsets = task->offsets;
+    name.setTo(false, task->chars + offsets[i], offsets[i + 1] - offsets[i]);
+    task->out[i] = task->index->getBucketIndex(name, task->status);
+  }
+  return NULL;
+}
+
 static AlphabeticIndex* fromPeer(jlong peer) {
   return reinterpret_cast<AlphabeticIndex*>(static_cast<uintptr_t>(peer));
 }
@@ -101,6 +176,86 @@ static jint AlphabeticIndex_getBucketIndex(JNIEnv* env, jclass, jlong peer, jstr
   return result;
 }
 
+static void AlphabeticIndex_getBucketIndices(JNIEnv* env, jclass, jlong peer,
+                                             jobjectArray javaNames, jintArray javaOut,
+                                             jint threadCount) {
+  AlphabeticIndex* ai = fromPeer(peer);
+  jint count = env->GetArrayLength(javaNames);
+  if (threadCount > count / MIN_NAMES_PER_THREAD) {
+    threadCount = count / MIN_NAMES_PER_THREAD;
+  }
+  if (threadCount <= 1) {
+    getBucketIndicesSerially(env, ai, "AlphabeticIndex::getBucketIndex", javaNames, javaOut);
+    return;
+  }
+
+  // The JNI calls all have to happen on this thread, so copy every name out first.
+  std::vector<UChar> chars;
+  std::vector<size_t> offsets(count + 1);
+  for (jint i = 0; i < count; ++i) {
+    ScopedLocalRef<jstring> javaString(env,
+        reinterpret_cast<jstring>(env->GetObjectArrayElement(javaNames, i)));
+    if (javaString.get() == NULL) {
+      jniThrowExceptionFmt(env, "java/lang/NullPointerException", "names[%d] == null", i);
+      return;
+    }
+    jsize length = env->GetStringLength(javaString.get());
+    offsets[i] = chars.size();
+    chars.resize(chars.size() + length);
+    if (length > 0) {
+      env->GetStringRegion(javaString.get(), 0, length, &chars[offsets[i]]);
+    }
+  }
+  offsets[count] = chars.size();
+  if (chars.empty()) {
+    chars.push_back(0);
+  }
+
+  ScopedIntArrayRW out(env, javaOut);
+  if (out.get() == NULL) {
+    return;
+  }
+  // An AlphabeticIndex isn't thread-safe, so each thread gets its own ImmutableIndex snapshot,
+  // with its own clone of the collator.
+  std::vector<BucketIndexTask> tasks(threadCount);
+  for (jint t = 0; t < threadCount; ++t) {
+    BucketIndexTask& task = tasks[t];
+    task.status = U_ZERO_ERROR;
+    task.index.reset(ai->buildImmutableIndex(task.status));
+    if (maybeThrowIcuException(env, "AlphabeticIndex::buildImmutableIndex", task.status)) {
+      return;
+    }
+    task.chars = &chars[0];
+    task.offsets = &offsets[0];
+    task.out = out.get();
+    task.begin = static_cast<jint>(static_cast<int64_t>(count) * t / threadCount);
+    task.end = static_cast<jint>(static_cast<int64_t>(count) * (t + 1) / threadCount);
+  }
+  // The calling thread takes the first share. If a thread can't be started, its share is done
+  // here too.
+  std::vector<pthread_t> threads(threadCount);
+  std::vector<bool> started(threadCount, false);
+  for (jint t = 1; t < threadCount; ++t) {
+    started[t] = (pthread_create(&threads[t], NULL, runBucketIndexTask, &tasks[t]) == 0);
+  }
+  for (jint t = 0; t < threadCount; ++t) {
+    if (!started[t]) {
+      runBucketIndexTask(&tasks[t]);
+    }
+  }
+  for (jint t = 1; t < threadCount; ++t) {
+    if (started[t]) {
+      pthread_join(threads[t], NULL);
+    }
+  }
+  for (jint t = 0; t < threadCount; ++t) {
+    if (maybeThrowIcuException(env, "AlphabeticIndex::ImmutableIndex::getBucketIndex",
+                               tasks[t].status)) {
+      return;
+    }
+  }
+}
+
 static jstring AlphabeticIndex_getBucketLabel(JNIEnv* env, jclass, jlong peer, jint index) {
   if (index < 0) {
     jniThrowExceptionFmt(env, "java/lang/IllegalArgumentException", "Invalid index: %d", index);
@@ -166,6 +321,12 @@ static jint ImmutableIndex_getBucketIndex(JNIEnv* env, jclass, jlong peer, jstri
   return result;
 }
 
+static void ImmutableIndex_getBucketIndices(JNIEnv* env, jclass, jlong peer,
+                                            jobjectArray javaNames, jintArray javaOut) {
+  getBucketIndicesSerially(env, immutableIndexFromPeer(peer),
+                           "AlphabeticIndex::ImmutableIndex::getBucketIndex", javaNames, javaOut);
+}
+
 static jstring ImmutableIndex_getBucketLabel(JNIEnv* env, jclass, jlong peer, jint index) {
   AlphabeticIndex::ImmutableIndex* ii = immutableIndexFromPeer(peer);
   const AlphabeticIndex::Bucket* bucket = ii->getBucket(index);
@@ -192,12 +353,14 @@ static JNINativeMethod gMethods[] = {
   NATIVE_METHOD(AlphabeticIndex, addLabelRange, "(JII)V"),
   NATIVE_METHOD(AlphabeticIndex, getBucketCount, "(J)I"),
   NATIVE_METHOD(AlphabeticIndex, getBucketIndex, "(JLjava/lang/String;)I"),
+  NATIVE_METHOD(AlphabeticIndex, getBucketIndices, "(J[Ljava/lang/String;[II)V"),
   NATIVE_METHOD(AlphabeticIndex, getBucketLabel, "(JI)Ljava/lang/String;"),
   NATIVE_METHOD(AlphabeticIndex, buildImmutableIndex, "(J)J"),
 };
 static JNINativeMethod gImmutableIndexMethods[] = {
   NATIVE_METHOD(ImmutableIndex, getBucketCount, "(J)I"),
   NATIVE_METHOD(ImmutableIndex, getBucketIndex, "(JLjava/lang/String;)I"),
+  NATIVE_METHOD(ImmutableIndex, getBucketIndices, "(J[Ljava/lang/String;[I)V"),
   NATIVE_METHOD(ImmutableIndex, getBucketLabel, "(JI)Ljava/lang/String;"),
 };
 void register_libcore_icu_AlphabeticIndex(JNIEnv* env) {
@@ -20,6 +20,8 @@
 #include "JniConstants.h"
 #include "ScopedIcuLocale.h"
 #include "ScopedJavaUnicodeString.h"
+#include "ScopedLocalRef.h"
+#include "ScopedPrimitiveArray.h"
 #include "UniquePtr.h"
 #include "cutils/log.h"
 #include "unicode/dtitvfmt.h"
@@ -69,10 +71,43 @@ static jstring DateIntervalFormat_formatDateInterval(JNIEnv* env, jclass, jlong
   return env->NewString(s.getBuffer(), s.length());
 }
 
+// Formats the interval [fromDates[i], toDates[i]] with the formatter at addresses[i], for each i.
+static jobjectArray DateIntervalFormat_formatDateIntervals(JNIEnv* env, jclass, jlongArray javaAddresses, jlongArray javaFromDates, jlongArray javaToDates) {
+  ScopedLongArrayRO addresses(env, javaAddresses);
+  ScopedLongArrayRO fromDates(env, javaFromDates);
+  ScopedLongArrayRO toDates(env, javaToDates);
+  if (addresses.get() == NULL || fromDates.get() == NULL || toDates.get() == NULL) {
+    return NULL;
+  }
+  jobjectArray result = env->NewObjectArray(addresses.size(), JniConstants::stringClass, NULL);
+  if (result == NULL) {
+    return NULL;
+  }
+  UnicodeString s;
+  for (size_t i = 0; i < addresses.size(); ++i) {
+    DateIntervalFormat* formatter(reinterpret_cast<DateIntervalFormat*>(addresses[i]));
+    DateInterval date_interval(fromDates[i], toDates[i]);
+    s.remove();
+    FieldPosition pos = 0;
+    UErrorCode status = U_ZERO_ERROR;
+    formatter->format(&date_interval, s, pos, status);
+    if (maybeThrowIcuException(env, "DateIntervalFormat::format", status)) {
+      return NULL;
+    }
+    ScopedLocalRef<jstring> formatted(env, env->NewString(s.getBuffer(), s.length()));
+    if (formatted.get() == NULL) {
+      return NULL;
+    }
+    env->SetObjectArrayElement(result, i, formatted.get());
+  }
+  return result;
+}
+
 static JNINativeMethod gMethods[] = {
   NATIVE_METHOD(DateIntervalFormat, createDateIntervalFormat, "(Ljava/lang/String;Ljava/lang/String;Ljava/lang/String;)J"),
   NATIVE_METHOD(DateIntervalFormat, destroyDateIntervalFormat, "(J)V"),
   NATIVE_METHOD(DateIntervalFormat, formatDateInterval, "(JJJ)Ljava/lang/String;"),
+  NATIVE_METHOD(DateIntervalFormat, formatDateIntervals, "([J[J[J)[Ljava/lang/String;"),
 };
 void register_libcore_icu_DateIntervalFormat(JNIEnv* env) {
   jniRegisterNativeMethods(env, "libcore/icu/DateIntervalFormat", gMethods, NELEM(gMethods));
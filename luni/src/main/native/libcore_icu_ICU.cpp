@@ -24,6 +24,8 @@
 #include "ScopedIcuLocale.h"
 #include "ScopedJavaUnicodeString.h"
 #include "ScopedLocalRef.h"
+#include "ScopedPthreadMutexLock.h"
+#include "ScopedStringChars.h"
 #include "ScopedUtfChars.h"
 #include "UniquePtr.h"
 #include "cutils/log.h"
@@ -39,6 +41,7 @@
 #include "unicode/locid.h"
 #include "unicode/numfmt.h"
 #include "unicode/strenum.h"
+#include "unicode/timezone.h"
 #include "unicode/ubrk.h"
 #include "unicode/ucal.h"
 #include "unicode/uclean.h"
@@ -53,8 +56,10 @@
 
 #include <errno.h>
 #include <fcntl.h>
+#include <pthread.h>
 #include <stdlib.h>
 #include <string.h>
+#include <list>
 #include <string>
 
 #ifdef HAVE_SYS_MMAN
@@ -558,8 +563,11 @@ static jboolean ICU_initLocaleDataNative(JNIEnv* env, jclass, jstring javaLangua
       return JNI_FALSE;
     }
 
+    // We only want the locale's week data, so give the calendar a fixed zone rather than
+    // have ICU find and load the default one.
     status = U_ZERO_ERROR;
-    UniquePtr<Calendar> cal(Calendar::createInstance(icuLocale.locale(), status));
+    UniquePtr<Calendar> cal(Calendar::createInstance(TimeZone::getGMT()->clone(),
+            icuLocale.locale(), status));
     if (U_FAILURE(status)) {
         return JNI_FALSE;
     }
@@ -646,7 +654,99 @@ static jboolean ICU_initLocaleDataNative(JNIEnv* env, jclass, jstring javaLangua
     return JNI_TRUE;
 }
 
+// Returns true if 'languageTag' is for 'language', such as "tr" for "tr-TR".
+static bool isLanguage(const char* languageTag, const char* language) {
+  size_t length = strlen(language);
+  return strncmp(languageTag, language, length) == 0 &&
+      (languageTag[length] == '\0' || languageTag[length] == '-');
+}
+
+// SWAR helpers treating a uint64_t as four UTF-16 code units, which must all be below 0x80.
+static const uint64_t kLaneOnes = 0x0001000100010001ULL;
+static const uint64_t kLaneHighBits = 0x0080008000800080ULL;
+
+// Sets bit 7 of each lane of 'w' that's in ['first', 'last'].
+static inline uint64_t lanesInRange(uint64_t w, jchar first, jchar last) {
+  return ((w + (0x80 - first) * kLaneOnes) & ~(w + (0x7f - last) * kLaneOnes)) & kLaneHighBits;
+}
+
+// Case maps 'javaString' without ICU if it's all ASCII, as HTTP headers and most
+// case-insensitive map keys are. Returns the original string if nothing changes. Sets
+// '*handled' to false if the string needs ICU: it isn't all ASCII, or it contains 'special',
+// which the locale maps unusually (such as 'I' in Turkish). 'special' may be 0 for none.
+static jstring asciiCaseMap(JNIEnv* env, jstring javaString, bool toUpper, jchar special,
+                            bool* handled) {
+  *handled = true;
+  ScopedStringChars chars(env, javaString);
+  if (chars.get() == NULL) {
+    return NULL;
+  }
+  const jchar* src = chars.get();
+  const size_t length = chars.size();
+  const jchar first = toUpper ? 'a' : 'A';
+  const jchar last = toUpper ? 'z' : 'Z';
+
+  // Find the first char that changes, checking four at a time.
+  size_t firstChange = length;
+  size_t i = 0;
+  for (; i + 4 <= length; i += 4) {
+    uint64_t w;
+    memcpy(&w, src + i, sizeof(w));
+    if ((w & ~(0x7f * kLaneOnes)) != 0) {
+      *handled = false;
+      return NULL;
+    }
+    if (special != 0 && lanesInRange(w, special, special) != 0) {
+      *handled = false;
+      return NULL;
+    }
+    if (firstChange == length && lanesInRange(w, first, last) != 0) {
+      for (size_t j = i; j < i + 4; ++j) {
+        if (src[j] >= first && src[j] <= last) {
+          firstChange = j;
+          break;
+        }
+      }
+    }
+  }
+  for (; i < length; ++i) {
+    jchar ch = src[i];
+    if (ch >= 0x80 || (special != 0 && ch == special)) {
+      *handled = false;
+      return NULL;
+    }
+    if (firstChange == length && ch >= first && ch <= last) {
+      firstChange = i;
+    }
+  }
+  if (firstChange == length) {
+    return javaString;
+  }
+
+  std::vector<jchar> result(src, src + length);
+  for (size_t j = firstChange; j < length; ++j) {
+    if (result[j] >= first && result[j] <= last) {
+      result[j] ^= 0x20;
+    }
+  }
+  return env->NewString(&result[0], length);
+}
+
 static jstring ICU_toLowerCase(JNIEnv* env, jclass, jstring javaString, jstring javaLanguageTag) {
+  {
+    ScopedUtfChars languageTag(env, javaLanguageTag);
+    if (languageTag.c_str() == NULL) {
+      return NULL;
+    }
+    // Turkish and Azeri lowercase 'I' to dotless 'i'. Lithuanian only differs for non-ASCII.
+    bool dotlessI = isLanguage(languageTag.c_str(), "tr") || isLanguage(languageTag.c_str(), "az");
+    bool handled;
+    jstring result = asciiCaseMap(env, javaString, false, dotlessI ? 'I' : 0, &handled);
+    if (handled) {
+      return result;
+    }
+  }
+
   ScopedJavaUnicodeString scopedString(env, javaString);
   if (!scopedString.valid()) {
     return NULL;
@@ -662,6 +762,20 @@ static jstring ICU_toLowerCase(JNIEnv* env, jclass, jstring javaString, jstring
 }
 
 static jstring ICU_toUpperCase(JNIEnv* env, jclass, jstring javaString, jstring javaLanguageTag) {
+  {
+    ScopedUtfChars languageTag(env, javaLanguageTag);
+    if (languageTag.c_str() == NULL) {
+      return NULL;
+    }
+    // Turkish and Azeri uppercase 'i' to dotted 'I'.
+    bool dottedI = isLanguage(languageTag.c_str(), "tr") || isLanguage(languageTag.c_str(), "az");
+    bool handled;
+    jstring result = asciiCaseMap(env, javaString, true, dottedI ? 'i' : 0, &handled);
+    if (handled) {
+      return result;
+    }
+  }
+
   ScopedJavaUnicodeString scopedString(env, javaString);
   if (!scopedString.valid()) {
     return NULL;
@@ -707,22 +821,64 @@ static jobject ICU_getAvailableCurrencyCodes(JNIEnv* env, jclass) {
   return fromStringEnumeration(env, status, "ucurr_openISOCurrencies", &e);
 }
 
-static jstring ICU_getBestDateTimePatternNative(JNIEnv* env, jclass, jstring javaSkeleton, jstring javaLanguageTag) {
-  ScopedIcuLocale icuLocale(env, javaLanguageTag);
-  if (!icuLocale.valid()) {
-    return NULL;
+// Creating a DateTimePatternGenerator means loading and analyzing all of a locale's calendar
+// patterns, and initializing a LocaleData asks for two best patterns straight away. So we
+// keep the generators for the most recently used few locales, most recent first.
+// getBestPattern isn't thread-safe, so we hold gPatternGeneratorsMutex while using one.
+struct CachedPatternGenerator {
+  std::string languageTag;
+  DateTimePatternGenerator* generator;
+};
+
+static const size_t PATTERN_GENERATOR_CACHE_CAPACITY = 8;
+static std::list<CachedPatternGenerator> gPatternGenerators;
+static pthread_mutex_t gPatternGeneratorsMutex = PTHREAD_MUTEX_INITIALIZER;
+
+// Must be called with gPatternGeneratorsMutex held.
+static DateTimePatternGenerator* findPatternGenerator(const char* languageTag) {
+  typedef std::list<CachedPatternGenerator>::iterator Iterator;
+  for (Iterator it = gPatternGenerators.begin(); it != gPatternGenerators.end(); ++it) {
+    if (it->languageTag == languageTag) {
+      gPatternGenerators.splice(gPatternGenerators.begin(), gPatternGenerators, it);
+      return it->generator;
+    }
   }
+  return NULL;
+}
 
-  UErrorCode status = U_ZERO_ERROR;
-  UniquePtr<DateTimePatternGenerator> generator(DateTimePatternGenerator::createInstance(icuLocale.locale(), status));
-  if (maybeThrowIcuException(env, "DateTimePatternGenerator::createInstance", status)) {
+static jstring ICU_getBestDateTimePatternNative(JNIEnv* env, jclass, jstring javaSkeleton, jstring javaLanguageTag) {
+  ScopedUtfChars languageTag(env, javaLanguageTag);
+  if (languageTag.c_str() == NULL) {
     return NULL;
   }
-
   ScopedJavaUnicodeString skeletonHolder(env, javaSkeleton);
   if (!skeletonHolder.valid()) {
     return NULL;
   }
+
+  UErrorCode status = U_ZERO_ERROR;
+  ScopedPthreadMutexLock lock(&gPatternGeneratorsMutex);
+  DateTimePatternGenerator* generator = findPatternGenerator(languageTag.c_str());
+  if (generator == NULL) {
+    ScopedIcuLocale icuLocale(env, javaLanguageTag);
+    if (!icuLocale.valid()) {
+      return NULL;
+    }
+    generator = DateTimePatternGenerator::createInstance(icuLocale.locale(), status);
+    if (maybeThrowIcuException(env, "DateTimePatternGenerator::createInstance", status)) {
+      delete generator;
+      return NULL;
+    }
+    CachedPatternGenerator entry;
+    entry.languageTag = languageTag.c_str();
+    entry.generator = generator;
+    gPatternGenerators.push_front(entry);
+    if (gPatternGenerators.size() > PATTERN_GENERATOR_CACHE_CAPACITY) {
+      delete gPatternGenerators.back().generator;
+      gPatternGenerators.pop_back();
+    }
+  }
+
   UnicodeString result(generator->getBestPattern(skeletonHolder.unicodeString(), status));
   if (maybeThrowIcuException(env, "DateTimePatternGenerator::getBestPattern", status)) {
     return NULL;
@@ -781,7 +937,7 @@ static JNINativeMethod gMethods[] = {
 };
 
 #ifdef HAVE_SYS_MMAN
-void register_libcore_icu_ICU(JNIEnv* env) {
+static void mapIcuData() {
     std::string path;
     path = u_getDataDirectory();
     path += "/";
@@ -831,12 +987,9 @@ void register_libcore_icu_ICU(JNIEnv* env) {
     // and bail.
     u_init(&status);
     MAYBE_FAIL_WITH_ICU_ERROR("u_init");
-    jniRegisterNativeMethods(env, "libcore/icu/ICU", gMethods, NELEM(gMethods));
 }
 #else // HAVE_SYS_MMAN
-void
-register_libcore_icu_ICU(JNIEnv* e)
-{
+static void mapIcuData() {
   UErrorCode status = U_ZERO_ERROR;
   udata_setFileAccess(UDATA_NO_FILES, &status);
   if (status != U_ZERO_ERROR) abort();
@@ -845,7 +998,16 @@ register_libcore_icu_ICU(JNIEnv* e)
   // needed for other platforms?  If so, we'll have to ifdef it.
 //   u_init(&status);
 //   if (status != U_ZERO_ERROR) abort();
-
-  jniRegisterNativeMethods(e, "libcore/icu/ICU", gMethods, NELEM(gMethods));
 }
 #endif // HAVE_SYS_MMAN
+
+static pthread_once_t gIcuDataOnce = PTHREAD_ONCE_INIT;
+
+void initIcuData() {
+    pthread_once(&gIcuDataOnce, mapIcuData);
+}
+
+void register_libcore_icu_ICU(JNIEnv* env) {
+    initIcuData();
+    jniRegisterNativeMethods(env, "libcore/icu/ICU", gMethods, NELEM(gMethods));
+}
@@ -21,11 +21,16 @@
 #include "JniConstants.h"
 #include "JniException.h"
 #include "ScopedIcuLocale.h"
+#include "ScopedPrimitiveArray.h"
+#include "ScopedPthreadMutexLock.h"
 #include "ScopedUtfChars.h"
 #include "unicode/brkiter.h"
 #include "unicode/putil.h"
 #include <stdlib.h>
 
+#include <map>
+#include <string>
+
 // ICU documentation: http://icu-project.org/apiref/icu4c/classBreakIterator.html
 
 static BreakIterator* toBreakIterator(jlong address) {
@@ -107,17 +112,61 @@ class BreakIteratorAccessor {
   void operator=(const BreakIteratorAccessor&);
 };
 
+typedef BreakIterator* (*BreakIteratorFactory)(const Locale&, UErrorCode&);
+
+/*
+ * Creating a break iterator means finding the locale's rules and building a
+ * rule-based iterator from them. Cloning an existing iterator just shares
+ * the rules, so we keep an untouched prototype of each kind of iterator for
+ * each locale and hand out clones. The prototypes never have text set, and
+ * live for the life of the process. They're keyed by ICU's canonical locale
+ * name, so every spelling of a locale shares one entry. Callers can still
+ * make up as many distinct locales as they like, so the cache is capped too;
+ * iterators for locales seen once it's full are built afresh each time.
+ */
+typedef std::pair<BreakIteratorFactory, std::string> PrototypeKey;
+static std::map<PrototypeKey, BreakIterator*> gPrototypes;
+static pthread_mutex_t gPrototypesMutex = PTHREAD_MUTEX_INITIALIZER;
+// Four kinds of iterator for far more locales than any one process uses.
+static const size_t MAX_CACHED_PROTOTYPES = 256;
+
+static jlong makeBreakIterator(JNIEnv* env, jstring javaLocaleName, BreakIteratorFactory factory) {
+  ScopedIcuLocale icuLocale(env, javaLocaleName);
+  if (!icuLocale.valid()) {
+    return 0;
+  }
+  PrototypeKey key(factory, icuLocale.locale().getName());
+  {
+    ScopedPthreadMutexLock lock(&gPrototypesMutex);
+    std::map<PrototypeKey, BreakIterator*>::iterator it = gPrototypes.find(key);
+    if (it != gPrototypes.end()) {
+      return reinterpret_cast<uintptr_t>(it->second->clone());
+    }
+  }
+
+  UErrorCode status = U_ZERO_ERROR;
+  BreakIterator* prototype = factory(icuLocale.locale(), status);
+  if (maybeThrowIcuException(env, "ubrk_open", status)) {
+    delete prototype;
+    return 0;
+  }
+  ScopedPthreadMutexLock lock(&gPrototypesMutex);
+  std::map<PrototypeKey, BreakIterator*>::iterator it = gPrototypes.find(key);
+  if (it != gPrototypes.end()) {
+    // Another thread got here first.
+    delete prototype;
+    return reinterpret_cast<uintptr_t>(it->second->clone());
+  }
+  if (gPrototypes.size() >= MAX_CACHED_PROTOTYPES) {
+    // The caller can have this one; nobody else has seen it.
+    return reinterpret_cast<uintptr_t>(prototype);
+  }
+  gPrototypes[key] = prototype;
+  return reinterpret_cast<uintptr_t>(prototype->clone());
+}
+
 #define MAKE_BREAK_ITERATOR_INSTANCE(F) \
-  ScopedIcuLocale icuLocale(env, javaLocaleName); \
-  if (!icuLocale.valid()) { \
-    return 0; \
-  } \
-  UErrorCode status = U_ZERO_ERROR; \
-  BreakIterator* it = F(icuLocale.locale(), status); \
-  if (maybeThrowIcuException(env, "ubrk_open", status)) { \
-    return 0; \
-  } \
-  return reinterpret_cast<uintptr_t>(it)
+  return makeBreakIterator(env, javaLocaleName, F)
 
 static jlong NativeBreakIterator_cloneImpl(JNIEnv* env, jclass, jlong address) {
   BreakIteratorAccessor it(env, address);
@@ -128,6 +177,27 @@ static void NativeBreakIterator_closeImpl(JNIEnv*, jclass, jlong address) {
   delete toBreakIterator(address);
 }
 
+// Writes the boundaries at or after 'from' to 'javaBoundaries', in order, until it's full or
+// there are no more. Returns how many were written. Running the iterator here rather than
+// making a call per boundary means the text is only located and pinned once.
+static jint NativeBreakIterator_boundariesImpl(JNIEnv* env, jclass, jlong address, jstring javaInput, jint from, jintArray javaBoundaries) {
+  ScopedIntArrayRW boundaries(env, javaBoundaries);
+  if (boundaries.get() == NULL || boundaries.size() == 0) {
+    return 0;
+  }
+  BreakIteratorAccessor it(env, address, javaInput, false);
+  size_t count = 0;
+  int32_t boundary = (from <= 0) ? it->first() : it->following(from - 1);
+  while (boundary != BreakIterator::DONE) {
+    boundaries[count++] = boundary;
+    if (count == boundaries.size()) {
+      break;
+    }
+    boundary = it->next();
+  }
+  return count;
+}
+
 static jint NativeBreakIterator_currentImpl(JNIEnv* env, jclass, jlong address, jstring javaInput) {
   BreakIteratorAccessor it(env, address, javaInput, false);
   return it->current();
@@ -202,6 +272,7 @@ static void NativeBreakIterator_setTextImpl(JNIEnv* env, jclass, jlong address,
 }
 
 static JNINativeMethod gMethods[] = {
+  NATIVE_METHOD(NativeBreakIterator, boundariesImpl, "(JLjava/lang/String;I[I)I"),
   NATIVE_METHOD(NativeBreakIterator, cloneImpl, "(J)J"),
   NATIVE_METHOD(NativeBreakIterator, closeImpl, "(J)V"),
   NATIVE_METHOD(NativeBreakIterator, currentImpl, "(JLjava/lang/String;)I"),
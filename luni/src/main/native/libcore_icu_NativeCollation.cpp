@@ -13,13 +13,25 @@
 #include "JNIHelp.h"
 #include "JniConstants.h"
 #include "JniException.h"
+#include "ScopedLocalRef.h"
+#include "ScopedPrimitiveArray.h"
+#include "ScopedPthreadMutexLock.h"
 #include "ScopedStringChars.h"
 #include "ScopedUtfChars.h"
 #include "UniquePtr.h"
 #include "unicode/ucol.h"
 #include "unicode/ucoleitr.h"
+#include "unicode/unistr.h"
 #include <cutils/log.h>
 
+#include <algorithm>
+#include <list>
+#include <map>
+#include <string>
+#include <vector>
+
+#include <string.h>
+
 // Manages a UCollationElements instance along with the jchar
 // array it is iterating over. The associated array can be unpinned
 // only after a call to ucol_closeElements. This means we have to
@@ -173,6 +185,106 @@ static jbyteArray NativeCollation_getSortKey(JNIEnv* env, jclass, jlong address,
     return result;
 }
 
+// Appends the sort key of each string in 'strings' to 'keys', and where each key starts to
+// 'offsets', followed by the end of the last key. Like getSortKey, each key includes ICU's
+// terminating zero byte. Returns false with a pending exception if any string is null.
+static bool collectSortKeys(JNIEnv* env, const UCollator* collator, jobjectArray strings,
+        std::vector<uint8_t>& keys, std::vector<size_t>& offsets) {
+    jsize count = env->GetArrayLength(strings);
+    offsets.reserve(count + 1);
+    for (jsize i = 0; i < count; ++i) {
+        ScopedLocalRef<jstring> string(env,
+                reinterpret_cast<jstring>(env->GetObjectArrayElement(strings, i)));
+        ScopedStringChars chars(env, string.get());
+        if (chars.get() == NULL) {
+            return false;
+        }
+        // Most keys fit in the same guess getSortKey uses; ICU tells us the size of any that don't.
+        size_t start = keys.size();
+        size_t capacity = 128;
+        keys.resize(start + capacity);
+        size_t keyLength = ucol_getSortKey(collator, chars.get(), chars.size(),
+                &keys[start], capacity);
+        if (keyLength > capacity) {
+            keys.resize(start + keyLength);
+            keyLength = ucol_getSortKey(collator, chars.get(), chars.size(),
+                    &keys[start], keyLength);
+        }
+        if (keyLength == 0) {
+            // ICU failed; an empty key keeps the buffer well-formed and sorts first.
+            keys[start] = 0;
+            keyLength = 1;
+        }
+        keys.resize(start + keyLength);
+        offsets.push_back(start);
+    }
+    offsets.push_back(keys.size());
+    return true;
+}
+
+static jbyteArray NativeCollation_getSortKeys(JNIEnv* env, jclass, jlong address,
+        jobjectArray javaSources, jintArray javaOffsets) {
+    if (env->GetArrayLength(javaOffsets) != env->GetArrayLength(javaSources) + 1) {
+        jniThrowException(env, "java/lang/IllegalArgumentException",
+                "offsets.length != sources.length + 1");
+        return NULL;
+    }
+    std::vector<uint8_t> keys;
+    std::vector<size_t> offsets;
+    if (!collectSortKeys(env, toCollator(address), javaSources, keys, offsets)) {
+        return NULL;
+    }
+    ScopedIntArrayRW offsetsArray(env, javaOffsets);
+    if (offsetsArray.get() == NULL) {
+        return NULL;
+    }
+    for (size_t i = 0; i < offsets.size(); ++i) {
+        offsetsArray[i] = offsets[i];
+    }
+    jbyteArray result = env->NewByteArray(keys.size());
+    if (result != NULL && !keys.empty()) {
+        env->SetByteArrayRegion(result, 0, keys.size(), reinterpret_cast<const jbyte*>(&keys[0]));
+    }
+    return result;
+}
+
+// Orders string indices by their sort keys. Keys contain no zero bytes before their
+// terminator, so strcmp compares them exactly as ucol_strcoll would compare the strings.
+struct SortKeyLess {
+    SortKeyLess(const std::vector<uint8_t>& keys, const std::vector<size_t>& offsets)
+            : keys(keys), offsets(offsets) {
+    }
+
+    bool operator()(jint lhs, jint rhs) const {
+        return strcmp(reinterpret_cast<const char*>(&keys[offsets[lhs]]),
+                      reinterpret_cast<const char*>(&keys[offsets[rhs]])) < 0;
+    }
+
+    const std::vector<uint8_t>& keys;
+    const std::vector<size_t>& offsets;
+};
+
+static jintArray NativeCollation_sortIndices(JNIEnv* env, jclass, jlong address,
+        jobjectArray javaStrings) {
+    std::vector<uint8_t> keys;
+    std::vector<size_t> offsets;
+    if (!collectSortKeys(env, toCollator(address), javaStrings, keys, offsets)) {
+        return NULL;
+    }
+    jsize count = offsets.size() - 1;
+    std::vector<jint> order(count);
+    for (jsize i = 0; i < count; ++i) {
+        order[i] = i;
+    }
+    // Stable, like Arrays.sort and Collections.sort, so equal strings keep their order.
+    std::stable_sort(order.begin(), order.end(), SortKeyLess(keys, offsets));
+    jintArray result = env->NewIntArray(count);
+    if (result != NULL && count > 0) {
+        env->SetIntArrayRegion(result, 0, count, &order[0]);
+    }
+    return result;
+}
+
 static jint NativeCollation_next(JNIEnv* env, jclass, jlong address) {
     UErrorCode status = U_ZERO_ERROR;
     jint result = ucol_next(toCollationElements(address)->get(), &status);
@@ -180,16 +292,76 @@ static jint NativeCollation_next(JNIEnv* env, jclass, jlong address) {
     return result;
 }
 
+/*
+ * Opening a collator means loading (or, for rules, building) its tailoring,
+ * which takes milliseconds, and every Collator.getInstance used to pay that.
+ * Instead we keep the first collator opened for each locale or set of rules
+ * as a prototype and hand out ucol_safeClone copies, which share its
+ * tailoring. Callers change attributes on their own clone, so the prototypes
+ * are never modified. They are also never closed, since the clones share
+ * their data; to bound that we stop adding prototypes once the caches are
+ * full, and open any further collators directly.
+ */
+static const size_t MAX_CACHED_LOCALE_COLLATORS = 64;
+static const size_t MAX_CACHED_RULES_COLLATORS = 16;
+
+struct RulesCollator {
+    UnicodeString rules;
+    jint mode;
+    jint strength;
+    UCollator* prototype;
+};
+
+static std::map<std::string, UCollator*> gLocaleCollators;
+static std::list<RulesCollator> gRulesCollators;
+static pthread_mutex_t gCollatorCacheMutex = PTHREAD_MUTEX_INITIALIZER;
+
+// Must be called with gCollatorCacheMutex held.
+static UCollator* findRulesCollator(const UnicodeString& rules, jint mode, jint strength) {
+    for (std::list<RulesCollator>::iterator it = gRulesCollators.begin();
+            it != gRulesCollators.end(); ++it) {
+        if (it->mode == mode && it->strength == strength && it->rules == rules) {
+            return it->prototype;
+        }
+    }
+    return NULL;
+}
+
+static jlong cloneCollator(JNIEnv* env, const UCollator* prototype) {
+    UErrorCode status = U_ZERO_ERROR;
+    UCollator* c = ucol_safeClone(prototype, NULL, NULL, &status);
+    maybeThrowIcuException(env, "ucol_safeClone", status);
+    return static_cast<jlong>(reinterpret_cast<uintptr_t>(c));
+}
+
 static jlong NativeCollation_openCollator(JNIEnv* env, jclass, jstring javaLocaleName) {
     ScopedUtfChars localeChars(env, javaLocaleName);
     if (localeChars.c_str() == NULL) {
         return 0;
     }
 
+    {
+        ScopedPthreadMutexLock lock(&gCollatorCacheMutex);
+        std::map<std::string, UCollator*>::iterator it = gLocaleCollators.find(localeChars.c_str());
+        if (it != gLocaleCollators.end()) {
+            return cloneCollator(env, it->second);
+        }
+    }
+
     UErrorCode status = U_ZERO_ERROR;
     UCollator* c = ucol_open(localeChars.c_str(), &status);
-    maybeThrowIcuException(env, "ucol_open", status);
-    return static_cast<jlong>(reinterpret_cast<uintptr_t>(c));
+    if (maybeThrowIcuException(env, "ucol_open", status)) {
+        return static_cast<jlong>(reinterpret_cast<uintptr_t>(c));
+    }
+
+    // If another thread raced us here, its prototype wins and ours is handed out directly.
+    ScopedPthreadMutexLock lock(&gCollatorCacheMutex);
+    if (gLocaleCollators.size() >= MAX_CACHED_LOCALE_COLLATORS ||
+            gLocaleCollators.count(localeChars.c_str()) != 0) {
+        return static_cast<jlong>(reinterpret_cast<uintptr_t>(c));
+    }
+    gLocaleCollators[localeChars.c_str()] = c;
+    return cloneCollator(env, c);
 }
 
 static jlong NativeCollation_openCollatorFromRules(JNIEnv* env, jclass, jstring javaRules, jint mode, jint strength) {
@@ -197,11 +369,35 @@ static jlong NativeCollation_openCollatorFromRules(JNIEnv* env, jclass, jstring
     if (rules.get() == NULL) {
         return -1;
     }
+    // A read-only alias of the pinned chars, copied only if we cache it.
+    UnicodeString rulesString(false, rules.get(), rules.size());
+    {
+        ScopedPthreadMutexLock lock(&gCollatorCacheMutex);
+        UCollator* prototype = findRulesCollator(rulesString, mode, strength);
+        if (prototype != NULL) {
+            return cloneCollator(env, prototype);
+        }
+    }
+
     UErrorCode status = U_ZERO_ERROR;
     UCollator* c = ucol_openRules(rules.get(), rules.size(),
             UColAttributeValue(mode), UCollationStrength(strength), NULL, &status);
-    maybeThrowIcuException(env, "ucol_openRules", status);
-    return static_cast<jlong>(reinterpret_cast<uintptr_t>(c));
+    if (maybeThrowIcuException(env, "ucol_openRules", status)) {
+        return static_cast<jlong>(reinterpret_cast<uintptr_t>(c));
+    }
+
+    ScopedPthreadMutexLock lock(&gCollatorCacheMutex);
+    if (gRulesCollators.size() >= MAX_CACHED_RULES_COLLATORS ||
+            findRulesCollator(rulesString, mode, strength) != NULL) {
+        return static_cast<jlong>(reinterpret_cast<uintptr_t>(c));
+    }
+    RulesCollator entry;
+    entry.rules.setTo(rules.get(), rules.size());
+    entry.mode = mode;
+    entry.strength = strength;
+    entry.prototype = c;
+    gRulesCollators.push_back(entry);
+    return cloneCollator(env, c);
 }
 
 static jint NativeCollation_previous(JNIEnv* env, jclass, jlong address) {
@@ -253,6 +449,7 @@ static JNINativeMethod gMethods[] = {
     NATIVE_METHOD(NativeCollation, getOffset, "(J)I"),
     NATIVE_METHOD(NativeCollation, getRules, "(J)Ljava/lang/String;"),
     NATIVE_METHOD(NativeCollation, getSortKey, "(JLjava/lang/String;)[B"),
+    NATIVE_METHOD(NativeCollation, getSortKeys, "(J[Ljava/lang/String;[I)[B"),
     NATIVE_METHOD(NativeCollation, next, "(J)I"),
     NATIVE_METHOD(NativeCollation, openCollator, "(Ljava/lang/String;)J"),
     NATIVE_METHOD(NativeCollation, openCollatorFromRules, "(Ljava/lang/String;II)J"),
@@ -262,6 +459,7 @@ static JNINativeMethod gMethods[] = {
     NATIVE_METHOD(NativeCollation, setAttribute, "(JII)V"),
     NATIVE_METHOD(NativeCollation, setOffset, "(JI)V"),
     NATIVE_METHOD(NativeCollation, setText, "(JLjava/lang/String;)V"),
+    NATIVE_METHOD(NativeCollation, sortIndices, "(J[Ljava/lang/String;)[I"),
 };
 void register_libcore_icu_NativeCollation(JNIEnv* env) {
     jniRegisterNativeMethods(env, "libcore/icu/NativeCollation", gMethods, NELEM(gMethods));
@@ -15,12 +15,14 @@
 
 #define LOG_TAG "NativeConverter"
 
+#include "CharsetUtilities.h"
 #include "IcuUtilities.h"
 #include "JNIHelp.h"
 #include "JniConstants.h"
 #include "JniException.h"
 #include "ScopedLocalRef.h"
 #include "ScopedPrimitiveArray.h"
+#include "ScopedPthreadMutexLock.h"
 #include "ScopedStringChars.h"
 #include "ScopedUtfChars.h"
 #include "UniquePtr.h"
@@ -32,6 +34,9 @@
 #include "unicode/ustring.h"
 #include "unicode/utypes.h"
 
+#include <algorithm>
+#include <map>
+#include <string>
 #include <vector>
 
 #include <stdlib.h>
@@ -119,15 +124,15 @@ static const char* getICUCanonicalName(const char* name) {
 // name then its canonical name must be the MIME-preferred name and the other names in
 // the registry must be valid aliases. If a supported charset is not listed in the IANA
 // registry then its canonical name must begin with one of the strings "X-" or "x-".
-static jstring getJavaCanonicalName(JNIEnv* env, const char* icuCanonicalName) {
+static std::string getJavaCanonicalName(const char* icuCanonicalName) {
   UErrorCode status = U_ZERO_ERROR;
 
   // Check to see if this is a well-known MIME or IANA name.
   const char* cName = NULL;
   if ((cName = ucnv_getStandardName(icuCanonicalName, "MIME", &status)) != NULL) {
-    return env->NewStringUTF(cName);
+    return cName;
   } else if ((cName = ucnv_getStandardName(icuCanonicalName, "IANA", &status)) != NULL) {
-    return env->NewStringUTF(cName);
+    return cName;
   }
 
   // Check to see if an alias already exists with "x-" prefix, if yes then
@@ -136,7 +141,7 @@ static jstring getJavaCanonicalName(JNIEnv* env, const char* icuCanonicalName) {
   for (int i = 0; i < aliasCount; ++i) {
     const char* name = ucnv_getAlias(icuCanonicalName, i, &status);
     if (name != NULL && name[0] == 'x' && name[1] == '-') {
-      return env->NewStringUTF(name);
+      return name;
     }
   }
 
@@ -150,25 +155,114 @@ static jstring getJavaCanonicalName(JNIEnv* env, const char* icuCanonicalName) {
   if (name == NULL) {
     name = icuCanonicalName;
   }
-  UniquePtr<char[]> result(new char[2 + strlen(name) + 1]);
-  strcpy(&result[0], "x-");
-  strcat(&result[0], name);
-  return env->NewStringUTF(&result[0]);
+  return std::string("x-") + name;
 }
 
+/*
+ * Every CharsetEncoder and CharsetDecoder opens its own converter, and code
+ * that wraps each stream in a new InputStreamReader opens and closes them
+ * constantly. ucnv_open has to resolve the name and find the conversion
+ * tables each time, so instead we keep one opened prototype per charset and
+ * hand out clones of it, recycling a few closed converters per charset.
+ */
+struct ConverterPool {
+    explicit ConverterPool(UConverter* prototype) : prototype(prototype) {
+    }
+
+    UConverter* const prototype;
+
+    /** Closed converters, reset and with ICU's default callbacks. */
+    std::vector<UConverter*> idle;
+};
+
+static const size_t MAX_IDLE_CONVERTERS_PER_CHARSET = 4;
+
+/** Pools keyed by the name Java asked for, and by ICU's internal name, which may differ. */
+static std::map<std::string, ConverterPool*> gConverterPoolsByName;
+static std::map<std::string, ConverterPool*> gConverterPoolsByInternalName;
+
+static pthread_mutex_t gConverterPoolMutex = PTHREAD_MUTEX_INITIALIZER;
+
+static ConverterPool* findConverterPool(const char* name, UErrorCode* status) {
+    {
+        ScopedPthreadMutexLock lock(&gConverterPoolMutex);
+        std::map<std::string, ConverterPool*>::iterator it = gConverterPoolsByName.find(name);
+        if (it != gConverterPoolsByName.end()) {
+            return it->second;
+        }
+    }
+
+    // We open the prototype without holding the lock. Two aliases of the same charset share
+    // a pool, so if another thread got there first we keep its prototype and close ours.
+    UConverter* prototype = ucnv_open(name, status);
+    if (U_FAILURE(*status)) {
+        return NULL;
+    }
+    const char* internalName = ucnv_getName(prototype, status);
+    if (U_FAILURE(*status)) {
+        ucnv_close(prototype);
+        return NULL;
+    }
+    ScopedPthreadMutexLock lock(&gConverterPoolMutex);
+    ConverterPool*& pool = gConverterPoolsByInternalName[internalName];
+    if (pool == NULL) {
+        pool = new ConverterPool(prototype);
+    } else {
+        ucnv_close(prototype);
+    }
+    gConverterPoolsByName[name] = pool;
+    return pool;
+}
+
+// Restores ICU's default callbacks, freeing any contexts set by setCallbackEncode and
+// setCallbackDecode, so that a recycled converter behaves like a freshly opened one.
+static void resetCallbacks(UConverter* cnv);
+
 static jlong NativeConverter_openConverter(JNIEnv* env, jclass, jstring converterName) {
     ScopedUtfChars converterNameChars(env, converterName);
     if (converterNameChars.c_str() == NULL) {
         return 0;
     }
     UErrorCode status = U_ZERO_ERROR;
-    UConverter* cnv = ucnv_open(converterNameChars.c_str(), &status);
-    maybeThrowIcuException(env, "ucnv_open", status);
+    ConverterPool* pool = findConverterPool(converterNameChars.c_str(), &status);
+    if (pool == NULL) {
+        maybeThrowIcuException(env, "ucnv_open", status);
+        return 0;
+    }
+    {
+        ScopedPthreadMutexLock lock(&gConverterPoolMutex);
+        if (!pool->idle.empty()) {
+            UConverter* cnv = pool->idle.back();
+            pool->idle.pop_back();
+            return reinterpret_cast<uintptr_t>(cnv);
+        }
+    }
+    // Cloning an idle prototype is safe without the lock; nothing else ever converts with it.
+    UConverter* cnv = ucnv_safeClone(pool->prototype, NULL, NULL, &status);
+    maybeThrowIcuException(env, "ucnv_safeClone", status);
     return reinterpret_cast<uintptr_t>(cnv);
 }
 
 static void NativeConverter_closeConverter(JNIEnv*, jclass, jlong address) {
-    ucnv_close(toUConverter(address));
+    UConverter* cnv = toUConverter(address);
+    if (cnv == NULL) {
+        return;
+    }
+    UErrorCode status = U_ZERO_ERROR;
+    const char* internalName = ucnv_getName(cnv, &status);
+    if (U_SUCCESS(status)) {
+        ScopedPthreadMutexLock lock(&gConverterPoolMutex);
+        std::map<std::string, ConverterPool*>::iterator it =
+                gConverterPoolsByInternalName.find(internalName);
+        if (it != gConverterPoolsByInternalName.end() &&
+                it->second->idle.size() < MAX_IDLE_CONVERTERS_PER_CHARSET) {
+            ucnv_reset(cnv);
+            resetCallbacks(cnv);
+            it->second->idle.push_back(cnv);
+            return;
+        }
+    }
+    ucnv_close(cnv);
 }
 
 static bool shouldCodecThrow(jboolean flush, UErrorCode error) {
@@ -179,6 +273,69 @@ static bool shouldCodecThrow(jboolean flush, UErrorCode error) {
     }
 }
 
+// For the common Unicode and single-byte charsets we convert the leading run of input that can't
+// involve a callback (ASCII for UTF-8, non-surrogates for UTF-16, and so on) ourselves, and hand
+// only the remainder to ICU. ICU still sees every character that could be malformed, unmappable,
+// or part of a sequence split across calls, so error reporting and callbacks are unchanged. We
+// only do this when the converter holds no partial input of its own from a previous call.
+// Returns the number of chars consumed, and sets '*byteCount' to the number of bytes produced.
+static size_t fastEncodePrefix(UConverter* cnv, const jchar* src, size_t srcLength,
+        jbyte* dst, size_t dstLength, size_t* byteCount) {
+    *byteCount = 0;
+    UErrorCode status = U_ZERO_ERROR;
+    if (ucnv_fromUCountPending(cnv, &status) != 0 || U_FAILURE(status)) {
+        return 0;
+    }
+    size_t charCount;
+    switch (ucnv_getType(cnv)) {
+    case UCNV_US_ASCII:
+    case UCNV_UTF8:
+        *byteCount = asciiCharsToBytesPrefix(src, dst, std::min(srcLength, dstLength));
+        return *byteCount;
+    case UCNV_LATIN_1:
+        *byteCount = isoLatin1CharsToBytesPrefix(src, dst, std::min(srcLength, dstLength));
+        return *byteCount;
+    case UCNV_UTF16_BigEndian:
+        charCount = charsToUtf16BytesPrefix(src, dst, std::min(srcLength, dstLength / 2), true);
+        *byteCount = 2 * charCount;
+        return charCount;
+    case UCNV_UTF16_LittleEndian:
+        charCount = charsToUtf16BytesPrefix(src, dst, std::min(srcLength, dstLength / 2), false);
+        *byteCount = 2 * charCount;
+        return charCount;
+    default:
+        return 0;
+    }
+}
+
+// Returns the number of bytes consumed, and sets '*charCount' to the number of chars produced.
+static size_t fastDecodePrefix(UConverter* cnv, const jbyte* src, size_t srcLength,
+        jchar* dst, size_t dstLength, size_t* charCount) {
+    *charCount = 0;
+    UErrorCode status = U_ZERO_ERROR;
+    if (ucnv_toUCountPending(cnv, &status) != 0 || U_FAILURE(status)) {
+        return 0;
+    }
+    switch (ucnv_getType(cnv)) {
+    case UCNV_US_ASCII:
+    case UCNV_UTF8:
+        *charCount = asciiBytesToCharsPrefix(src, dst, std::min(srcLength, dstLength));
+        return *charCount;
+    case UCNV_LATIN_1:
+        *charCount = std::min(srcLength, dstLength);
+        isoLatin1BytesToChars(src, dst, *charCount);
+        return *charCount;
+    case UCNV_UTF16_BigEndian:
+        *charCount = utf16BytesToCharsPrefix(src, dst, std::min(srcLength / 2, dstLength), true);
+        return 2 * *charCount;
+    case UCNV_UTF16_LittleEndian:
+        *charCount = utf16BytesToCharsPrefix(src, dst, std::min(srcLength / 2, dstLength), false);
+        return 2 * *charCount;
+    default:
+        return 0;
+    }
+}
+
 static jint NativeConverter_encode(JNIEnv* env, jclass, jlong address,
         jcharArray source, jint sourceEnd, jbyteArray target, jint targetEnd,
         jintArray data, jboolean flush) {
@@ -211,6 +368,10 @@ static jint NativeConverter_encode(JNIEnv* env, jclass, jlong address,
     const UChar* mySourceLimit= uSource.get() + sourceEnd;
     char* cTarget = reinterpret_cast<char*>(uTarget.get() + *targetOffset);
     const char* cTargetLimit = reinterpret_cast<const char*>(uTarget.get() + targetEnd);
+    size_t fastBytes;
+    mySource += fastEncodePrefix(cnv, mySource, mySourceLimit - mySource,
+            reinterpret_cast<jbyte*>(cTarget), cTargetLimit - cTarget, &fastBytes);
+    cTarget += fastBytes;
     UErrorCode errorCode = U_ZERO_ERROR;
     ucnv_fromUnicode(cnv , &cTarget, cTargetLimit, &mySource, mySourceLimit, NULL, (UBool) flush, &errorCode);
     *sourceOffset = (mySource - uSource.get()) - *sourceOffset;
@@ -267,6 +428,10 @@ static jint NativeConverter_decode(JNIEnv* env, jclass, jlong address,
     const char* mySourceLimit = reinterpret_cast<const char*>(uSource.get() + sourceEnd);
     UChar* cTarget = uTarget.get() + *targetOffset;
     const UChar* cTargetLimit = uTarget.get() + targetEnd;
+    size_t fastChars;
+    mySource += fastDecodePrefix(cnv, reinterpret_cast<const jbyte*>(mySource),
+            mySourceLimit - mySource, cTarget, cTargetLimit - cTarget, &fastChars);
+    cTarget += fastChars;
     UErrorCode errorCode = U_ZERO_ERROR;
     ucnv_toUnicode(cnv, &cTarget, cTargetLimit, &mySource, mySourceLimit, NULL, flush, &errorCode);
     *sourceOffset = mySource - reinterpret_cast<const char*>(uSource.get()) - *sourceOffset;
@@ -328,7 +493,8 @@ static jobjectArray NativeConverter_getAvailableCharsetNames(JNIEnv* env, jclass
     }
     for (int i = 0; i < num; ++i) {
         const char* name = ucnv_getAvailableName(i);
-        ScopedLocalRef<jstring> javaCanonicalName(env, getJavaCanonicalName(env, name));
+        ScopedLocalRef<jstring> javaCanonicalName(env,
+                env->NewStringUTF(getJavaCanonicalName(name).c_str()));
         if (javaCanonicalName.get() == NULL) {
             return NULL;
         }
@@ -468,6 +634,24 @@ static void CHARSET_DECODER_CALLBACK(const void* rawContext, UConverterToUnicode
     }
 }
 
+static void resetCallbacks(UConverter* cnv) {
+    UErrorCode status = U_ZERO_ERROR;
+    UConverterFromUCallback oldFromUCallback;
+    const void* oldFromUContext;
+    ucnv_setFromUCallBack(cnv, UCNV_FROM_U_CALLBACK_SUBSTITUTE, NULL,
+            &oldFromUCallback, &oldFromUContext, &status);
+    if (oldFromUCallback == CHARSET_ENCODER_CALLBACK) {
+        delete reinterpret_cast<const EncoderCallbackContext*>(oldFromUContext);
+    }
+    UConverterToUCallback oldToUCallback;
+    const void* oldToUContext;
+    ucnv_setToUCallBack(cnv, UCNV_TO_U_CALLBACK_SUBSTITUTE, NULL,
+            &oldToUCallback, &oldToUContext, &status);
+    if (oldToUCallback == CHARSET_DECODER_CALLBACK) {
+        delete reinterpret_cast<const DecoderCallbackContext*>(oldToUContext);
+    }
+}
+
 static void NativeConverter_setCallbackDecode(JNIEnv* env, jclass, jlong address,
         jint onMalformedInput, jint onUnmappableInput, jstring javaReplacement) {
     UConverter* cnv = toUConverter(address);
@@ -548,49 +732,99 @@ static jboolean NativeConverter_contains(JNIEnv* env, jclass, jstring name1, jst
     return U_SUCCESS(errorCode) && set1.containsAll(set2);
 }
 
-static jobject NativeConverter_charsetForName(JNIEnv* env, jclass, jstring charsetName) {
-    ScopedUtfChars charsetNameChars(env, charsetName);
-    if (charsetNameChars.c_str() == NULL) {
-        return NULL;
-    }
+/*
+ * What charsetForName found out about a supported charset. java.nio.charset.Charset only caches
+ * the few most recently used charsets, and each miss here costs several alias table walks, so
+ * we remember the answer for every charset we've been asked about. These are keyed by ICU's
+ * canonical name, so every alias (and every spelling ICU accepts) shares one entry. Names ICU
+ * doesn't know aren't cached at all: callers can make up as many of those as they like. An
+ * "x-" name can carry ICU converter options ("x-UTF-8,locale=tr") that make a distinct canonical
+ * name, so the cache is capped too; names looked up once it's full are answered but not kept.
+ */
+struct CharsetNames {
+    std::string javaCanonicalName;
+    std::string icuCanonicalName;
+    std::vector<std::string> aliases;
+};
 
+static std::map<std::string, CharsetNames*> gCharsetNames;
+static pthread_mutex_t gCharsetNamesMutex = PTHREAD_MUTEX_INITIALIZER;
+// Plenty for all of ICU's converters.
+static const size_t MAX_CACHED_CHARSET_NAMES = 512;
+
+// Returns NULL if the charset isn't supported, or with a pending exception if ICU fails. If the
+// answer isn't cached, 'uncached' owns it.
+static const CharsetNames* lookUpCharsetNames(JNIEnv* env, const char* charsetName,
+        UniquePtr<CharsetNames>& uncached) {
     // Get ICU's canonical name for this charset.
-    const char* icuCanonicalName = getICUCanonicalName(charsetNameChars.c_str());
+    const char* icuCanonicalName = getICUCanonicalName(charsetName);
     if (icuCanonicalName == NULL) {
         return NULL;
     }
 
-    // Get Java's canonical name for this charset.
-    jstring javaCanonicalName = getJavaCanonicalName(env, icuCanonicalName);
-    if (env->ExceptionCheck()) {
-        return NULL;
+    {
+        ScopedPthreadMutexLock lock(&gCharsetNamesMutex);
+        std::map<std::string, CharsetNames*>::iterator it = gCharsetNames.find(icuCanonicalName);
+        if (it != gCharsetNames.end()) {
+            return it->second;
+        }
     }
 
     // Check that this charset is supported.
-    {
-        // ICU doesn't offer any "isSupported", so we just open and immediately close.
-        UErrorCode error = U_ZERO_ERROR;
-        LocalUConverterPointer cnv(ucnv_open(icuCanonicalName, &error));
-        if (!U_SUCCESS(error)) {
-            return NULL;
-        }
+    // ICU doesn't offer any "isSupported", so we just open and immediately close.
+    UErrorCode error = U_ZERO_ERROR;
+    LocalUConverterPointer cnv(ucnv_open(icuCanonicalName, &error));
+    if (U_FAILURE(error)) {
+        return NULL;
     }
 
+    UniquePtr<CharsetNames> names(new CharsetNames);
+    // Get Java's canonical name for this charset.
+    names->javaCanonicalName = getJavaCanonicalName(icuCanonicalName);
+    names->icuCanonicalName = icuCanonicalName;
+
     // Get the aliases for this charset.
-    std::vector<std::string> aliases;
-    if (!collectStandardNames(env, icuCanonicalName, "IANA", aliases)) {
+    if (!collectStandardNames(env, icuCanonicalName, "IANA", names->aliases)) {
+        return NULL;
+    }
+    if (!collectStandardNames(env, icuCanonicalName, "MIME", names->aliases)) {
+        return NULL;
+    }
+    if (!collectStandardNames(env, icuCanonicalName, "JAVA", names->aliases)) {
         return NULL;
     }
-    if (!collectStandardNames(env, icuCanonicalName, "MIME", aliases)) {
+    if (!collectStandardNames(env, icuCanonicalName, "WINDOWS", names->aliases)) {
         return NULL;
     }
-    if (!collectStandardNames(env, icuCanonicalName, "JAVA", aliases)) {
+
+    ScopedPthreadMutexLock lock(&gCharsetNamesMutex);
+    std::map<std::string, CharsetNames*>::iterator it = gCharsetNames.find(icuCanonicalName);
+    if (it != gCharsetNames.end()) {
+        // Another thread raced us here, and computed the same answer; keep the first.
+        return it->second;
+    }
+    if (gCharsetNames.size() >= MAX_CACHED_CHARSET_NAMES) {
+        uncached.reset(names.release());
+        return uncached.get();
+    }
+    CharsetNames* entry = names.release();
+    gCharsetNames[icuCanonicalName] = entry;
+    return entry;
+}
+
+static jobject NativeConverter_charsetForName(JNIEnv* env, jclass, jstring charsetName) {
+    ScopedUtfChars charsetNameChars(env, charsetName);
+    if (charsetNameChars.c_str() == NULL) {
         return NULL;
     }
-    if (!collectStandardNames(env, icuCanonicalName, "WINDOWS", aliases)) {
+
+    UniquePtr<CharsetNames> uncachedNames;
+    const CharsetNames* names = lookUpCharsetNames(env, charsetNameChars.c_str(), uncachedNames);
+    if (names == NULL) {
         return NULL;
     }
-    jobjectArray javaAliases = toStringArray(env, aliases);
+
+    jobjectArray javaAliases = toStringArray(env, names->aliases);
     if (env->ExceptionCheck()) {
         return NULL;
     }
@@ -602,7 +836,8 @@ static jobject NativeConverter_charsetForName(JNIEnv* env, jclass, jstring chars
         return NULL;
     }
     return env->NewObject(JniConstants::charsetICUClass, charsetConstructor,
-            javaCanonicalName, env->NewStringUTF(icuCanonicalName), javaAliases);
+            env->NewStringUTF(names->javaCanonicalName.c_str()),
+            env->NewStringUTF(names->icuCanonicalName.c_str()), javaAliases);
 }
 
 static JNINativeMethod gMethods[] = {
@@ -285,6 +285,50 @@ static jcharArray NativeDecimalFormat_formatDigitList(JNIEnv* env, jclass, jlong
     return format(env, addr, javaFieldPositionIterator, sp);
 }
 
+// Formats every element of 'values' into one buffer with one formatter, rather than making a
+// JNI call and a char[] per number. Formatted number i ends up in [offsets[i], offsets[i + 1]).
+template <typename T, typename ScopedValues>
+static jcharArray formatMany(JNIEnv* env, jlong addr, const ScopedValues& values, jintArray javaOffsets) {
+    if (values.get() == NULL) {
+        return NULL;
+    }
+    ScopedIntArrayRW offsets(env, javaOffsets);
+    if (offsets.get() == NULL) {
+        return NULL;
+    }
+    if (offsets.size() != values.size() + 1) {
+        jniThrowException(env, "java/lang/IllegalArgumentException",
+                "offsets.length != values.length + 1");
+        return NULL;
+    }
+    DecimalFormat* fmt = toDecimalFormat(addr);
+    UnicodeString s;
+    offsets[0] = 0;
+    for (size_t i = 0; i < values.size(); ++i) {
+        UErrorCode status = U_ZERO_ERROR;
+        fmt->format(static_cast<T>(values[i]), s, NULL, status);
+        if (maybeThrowIcuException(env, "DecimalFormat::format", status)) {
+            return NULL;
+        }
+        offsets[i + 1] = s.length();
+    }
+    jcharArray result = env->NewCharArray(s.length());
+    if (result != NULL) {
+        env->SetCharArrayRegion(result, 0, s.length(), s.getBuffer());
+    }
+    return result;
+}
+
+static jcharArray NativeDecimalFormat_formatDoubles(JNIEnv* env, jclass, jlong addr, jdoubleArray values, jintArray offsets) {
+    ScopedDoubleArrayRO scopedValues(env, values);
+    return formatMany<double>(env, addr, scopedValues, offsets);
+}
+
+static jcharArray NativeDecimalFormat_formatLongs(JNIEnv* env, jclass, jlong addr, jlongArray values, jintArray offsets) {
+    ScopedLongArrayRO scopedValues(env, values);
+    return formatMany<int64_t>(env, addr, scopedValues, offsets);
+}
+
 static jobject newBigDecimal(JNIEnv* env, const char* value, jsize len) {
     static jmethodID gBigDecimal_init = env->GetMethodID(JniConstants::bigDecimalClass, "<init>", "(Ljava/lang/String;)V");
 
@@ -354,6 +398,55 @@ static jobject NativeDecimalFormat_parse(JNIEnv* env, jclass, jlong addr, jstrin
     }
 }
 
+// Parses number i from [offsets[i], offsets[i + 1]) of 'text' into values[i], stopping at the
+// first number that doesn't parse or doesn't use all its chars. Returns how many were parsed.
+static jint NativeDecimalFormat_parseDoubles(JNIEnv* env, jclass, jlong addr, jcharArray javaText,
+        jintArray javaOffsets, jdoubleArray javaValues) {
+    ScopedCharArrayRO text(env, javaText);
+    if (text.get() == NULL) {
+        return 0;
+    }
+    ScopedIntArrayRO offsets(env, javaOffsets);
+    if (offsets.get() == NULL) {
+        return 0;
+    }
+    ScopedDoubleArrayRW values(env, javaValues);
+    if (values.get() == NULL) {
+        return 0;
+    }
+    if (offsets.size() == 0 || values.size() < offsets.size() - 1) {
+        jniThrowException(env, "java/lang/IllegalArgumentException",
+                "values.length < offsets.length - 1");
+        return 0;
+    }
+    DecimalFormat* fmt = toDecimalFormat(addr);
+    size_t count = offsets.size() - 1;
+    for (size_t i = 0; i < count; ++i) {
+        jint start = offsets[i];
+        jint end = offsets[i + 1];
+        if (start < 0 || end < start || static_cast<size_t>(end) > text.size()) {
+            jniThrowExceptionFmt(env, "java/lang/ArrayIndexOutOfBoundsException",
+                    "offsets[%zu]=%d, offsets[%zu]=%d, text.length=%zu", i, start, i + 1, end,
+                    text.size());
+            return i;
+        }
+        // A read-only alias, so parsing the batch copies no text.
+        UnicodeString number(false, text.get() + start, end - start);
+        Formattable res;
+        ParsePosition pp(0);
+        fmt->parse(number, res, pp);
+        if (pp.getErrorIndex() != -1 || pp.getIndex() != end - start) {
+            return i;
+        }
+        UErrorCode status = U_ZERO_ERROR;
+        values[i] = res.getDouble(status);
+        if (U_FAILURE(status)) {
+            return i;
+        }
+    }
+    return count;
+}
+
 static jlong NativeDecimalFormat_cloneImpl(JNIEnv*, jclass, jlong addr) {
     DecimalFormat* fmt = toDecimalFormat(addr);
     return reinterpret_cast<uintptr_t>(fmt->clone());
@@ -366,10 +459,13 @@ static JNINativeMethod gMethods[] = {
     NATIVE_METHOD(NativeDecimalFormat, formatDouble, "(JDLlibcore/icu/NativeDecimalFormat$FieldPositionIterator;)[C"),
     NATIVE_METHOD(NativeDecimalFormat, formatLong, "(JJLlibcore/icu/NativeDecimalFormat$FieldPositionIterator;)[C"),
     NATIVE_METHOD(NativeDecimalFormat, formatDigitList, "(JLjava/lang/String;Llibcore/icu/NativeDecimalFormat$FieldPositionIterator;)[C"),
+    NATIVE_METHOD(NativeDecimalFormat, formatDoubles, "(J[D[I)[C"),
+    NATIVE_METHOD(NativeDecimalFormat, formatLongs, "(J[J[I)[C"),
     NATIVE_METHOD(NativeDecimalFormat, getAttribute, "(JI)I"),
     NATIVE_METHOD(NativeDecimalFormat, getTextAttribute, "(JI)Ljava/lang/String;"),
     NATIVE_METHOD(NativeDecimalFormat, open, "(Ljava/lang/String;Ljava/lang/String;CCLjava/lang/String;CLjava/lang/String;Ljava/lang/String;Ljava/lang/String;CLjava/lang/String;CCCC)J"),
     NATIVE_METHOD(NativeDecimalFormat, parse, "(JLjava/lang/String;Ljava/text/ParsePosition;Z)Ljava/lang/Number;"),
+    NATIVE_METHOD(NativeDecimalFormat, parseDoubles, "(J[C[I[D)I"),
     NATIVE_METHOD(NativeDecimalFormat, setAttribute, "(JII)V"),
     NATIVE_METHOD(NativeDecimalFormat, setDecimalFormatSymbols, "(JLjava/lang/String;CCLjava/lang/String;CLjava/lang/String;Ljava/lang/String;Ljava/lang/String;CLjava/lang/String;CCCC)V"),
     NATIVE_METHOD(NativeDecimalFormat, setRoundingMode, "(JID)V"),
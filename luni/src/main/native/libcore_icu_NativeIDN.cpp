@@ -18,6 +18,7 @@
 
 #include "JNIHelp.h"
 #include "JniConstants.h"
+#include "ScopedLocalRef.h"
 #include "ScopedStringChars.h"
 #include "unicode/uidna.h"
 
@@ -32,18 +33,18 @@ static bool isLabelSeparator(const UChar ch) {
     }
 }
 
-static jstring NativeIDN_convertImpl(JNIEnv* env, jclass, jstring javaSrc, jint flags, jboolean toAscii) {
+// Converts 'javaSrc' and returns the result, or returns NULL with 'status' set.
+static jstring convert(JNIEnv* env, jstring javaSrc, jint flags, jboolean toAscii,
+                       UErrorCode& status) {
     ScopedStringChars src(env, javaSrc);
     if (src.get() == NULL) {
         return NULL;
     }
     UChar dst[256];
-    UErrorCode status = U_ZERO_ERROR;
     size_t resultLength = toAscii
-        ? uidna_IDNToASCII(src.get(), src.size(), &dst[0], sizeof(dst), flags, NULL, &status)
-        : uidna_IDNToUnicode(src.get(), src.size(), &dst[0], sizeof(dst), flags, NULL, &status);
+        ? uidna_IDNToASCII(src.get(), src.size(), &dst[0], NELEM(dst), flags, NULL, &status)
+        : uidna_IDNToUnicode(src.get(), src.size(), &dst[0], NELEM(dst), flags, NULL, &status);
     if (U_FAILURE(status)) {
-        jniThrowException(env, "java/lang/IllegalArgumentException", u_errorName(status));
         return NULL;
     }
     if (!toAscii) {
@@ -59,7 +60,52 @@ static jstring NativeIDN_convertImpl(JNIEnv* env, jclass, jstring javaSrc, jint
     return env->NewString(&dst[0], resultLength);
 }
 
+static jstring NativeIDN_convertImpl(JNIEnv* env, jclass, jstring javaSrc, jint flags, jboolean toAscii) {
+    UErrorCode status = U_ZERO_ERROR;
+    jstring result = convert(env, javaSrc, flags, toAscii, status);
+    if (U_FAILURE(status)) {
+        jniThrowException(env, "java/lang/IllegalArgumentException", u_errorName(status));
+        return NULL;
+    }
+    return result;
+}
+
+// Converts each string of 'javaSrcs'. A string toUnicode can't convert is returned as is,
+// but toASCII throws for the first string it can't convert.
+static jobjectArray NativeIDN_convertAllImpl(JNIEnv* env, jclass, jobjectArray javaSrcs,
+                                             jint flags, jboolean toAscii) {
+    jsize count = env->GetArrayLength(javaSrcs);
+    jobjectArray result = env->NewObjectArray(count, JniConstants::stringClass, NULL);
+    if (result == NULL) {
+        return NULL;
+    }
+    for (jsize i = 0; i < count; ++i) {
+        ScopedLocalRef<jstring> javaSrc(env,
+            reinterpret_cast<jstring>(env->GetObjectArrayElement(javaSrcs, i)));
+        if (javaSrc.get() == NULL) {
+            jniThrowNullPointerException(env, NULL);
+            return NULL;
+        }
+        UErrorCode status = U_ZERO_ERROR;
+        ScopedLocalRef<jstring> converted(env, convert(env, javaSrc.get(), flags, toAscii, status));
+        if (U_FAILURE(status)) {
+            if (toAscii) {
+                jniThrowException(env, "java/lang/IllegalArgumentException", u_errorName(status));
+                return NULL;
+            }
+            env->SetObjectArrayElement(result, i, javaSrc.get());
+            continue;
+        }
+        if (converted.get() == NULL) {
+            return NULL;
+        }
+        env->SetObjectArrayElement(result, i, converted.get());
+    }
+    return result;
+}
+
 static JNINativeMethod gMethods[] = {
+    NATIVE_METHOD(NativeIDN, convertAllImpl, "([Ljava/lang/String;IZ)[Ljava/lang/String;"),
     NATIVE_METHOD(NativeIDN, convertImpl, "(Ljava/lang/String;IZ)Ljava/lang/String;"),
 };
 void register_libcore_icu_NativeIDN(JNIEnv* env) {
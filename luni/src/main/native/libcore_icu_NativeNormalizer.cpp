@@ -21,18 +21,85 @@
 #include "JniConstants.h"
 #include "JniException.h"
 #include "ScopedJavaUnicodeString.h"
-#include "unicode/normlzr.h"
+#include "unicode/normalizer2.h"
+#include "unicode/unorm.h"
 
+#include <stdint.h>
+#include <string.h>
+
+// SWAR helpers treating a uint64_t as four UTF-16 code units.
+static const uint64_t kLaneOnes = 0x0001000100010001ULL;
+static const uint64_t kLaneHighBits = 0x8000800080008000ULL;
+
+// Returns true if every char of 's' is below 'limit', which must be at most 0x8000.
+static bool allCharsBelow(const UChar* s, int32_t length, UChar limit) {
+  int32_t i = 0;
+  for (; i + 4 <= length; i += 4) {
+    uint64_t w;
+    memcpy(&w, s + i, sizeof(w));
+    if (((w | (w + (0x8000 - limit) * kLaneOnes)) & kLaneHighBits) != 0) {
+      return false;
+    }
+  }
+  for (; i < length; ++i) {
+    if (s[i] >= limit) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Returns the ICU normalizer for the UNormalizationMode 'mode', and sets '*minNoMaybe' to the
+// lowest char that isn't already in that form on its own. Text entirely below that is already
+// normalized: ASCII is in every form, and Latin-1 is in NFC.
+static const Normalizer2* getNormalizer2(jint mode, UChar* minNoMaybe, UErrorCode& status) {
+  switch (mode) {
+  case UNORM_NFC:
+    *minNoMaybe = 0x300;
+    return Normalizer2::getNFCInstance(status);
+  case UNORM_NFD:
+    *minNoMaybe = 0xc0;
+    return Normalizer2::getNFDInstance(status);
+  case UNORM_NFKC:
+    *minNoMaybe = 0xa0;
+    return Normalizer2::getNFKCInstance(status);
+  case UNORM_NFKD:
+    *minNoMaybe = 0xa0;
+    return Normalizer2::getNFKDInstance(status);
+  }
+  status = U_ILLEGAL_ARGUMENT_ERROR;
+  return NULL;
+}
+
+// Returns 's' itself if it's already normalized, which is the common case. Otherwise only the
+// part after the longest normalized prefix is normalized.
 static jstring NativeNormalizer_normalizeImpl(JNIEnv* env, jclass, jstring s, jint intMode) {
   ScopedJavaUnicodeString src(env, s);
   if (!src.valid()) {
     return NULL;
   }
-  UNormalizationMode mode = static_cast<UNormalizationMode>(intMode);
+  const UnicodeString& text(src.unicodeString());
   UErrorCode status = U_ZERO_ERROR;
-  UnicodeString dst;
-  Normalizer::normalize(src.unicodeString(), mode, 0, dst, status);
-  maybeThrowIcuException(env, "Normalizer::normalize", status);
+  UChar minNoMaybe;
+  const Normalizer2* normalizer = getNormalizer2(intMode, &minNoMaybe, status);
+  if (maybeThrowIcuException(env, "Normalizer2::getInstance", status)) {
+    return NULL;
+  }
+  if (allCharsBelow(text.getBuffer(), text.length(), minNoMaybe)) {
+    return s;
+  }
+  int32_t spanEnd = normalizer->spanQuickCheckYes(text, status);
+  if (maybeThrowIcuException(env, "Normalizer2::spanQuickCheckYes", status)) {
+    return NULL;
+  }
+  if (spanEnd == text.length()) {
+    return s;
+  }
+  UnicodeString dst(text, 0, spanEnd);
+  normalizer->normalizeSecondAndAppend(dst, text.tempSubString(spanEnd), status);
+  if (maybeThrowIcuException(env, "Normalizer2::normalizeSecondAndAppend", status)) {
+    return NULL;
+  }
   return dst.isBogus() ? NULL : env->NewString(dst.getBuffer(), dst.length());
 }
 
@@ -41,10 +108,19 @@ static jboolean NativeNormalizer_isNormalizedImpl(JNIEnv* env, jclass, jstring s
   if (!src.valid()) {
     return JNI_FALSE;
   }
-  UNormalizationMode mode = static_cast<UNormalizationMode>(intMode);
+  const UnicodeString& text(src.unicodeString());
   UErrorCode status = U_ZERO_ERROR;
-  UBool result = Normalizer::isNormalized(src.unicodeString(), mode, status);
-  maybeThrowIcuException(env, "Normalizer::isNormalized", status);
+  UChar minNoMaybe;
+  const Normalizer2* normalizer = getNormalizer2(intMode, &minNoMaybe, status);
+  if (maybeThrowIcuException(env, "Normalizer2::getInstance", status)) {
+    return JNI_FALSE;
+  }
+  if (allCharsBelow(text.getBuffer(), text.length(), minNoMaybe)) {
+    return JNI_TRUE;
+  }
+  // This starts with the same quick check, and only examines "maybe" spans more closely.
+  UBool result = normalizer->isNormalized(text, status);
+  maybeThrowIcuException(env, "Normalizer2::isNormalized", status);
   return result;
 }
 
@@ -20,9 +20,13 @@
 #include "JNIHelp.h"
 #include "JniConstants.h"
 #include "JniException.h"
+#include "ScopedPthreadMutexLock.h"
 #include "ScopedUtfChars.h"
+#include "UniquePtr.h"
 #include "unicode/plurrule.h"
 
+#include <map>
+#include <pthread.h>
 #include <string>
 
 static PluralRules* toPluralRules(jlong address) {
@@ -33,10 +37,42 @@ static void NativePluralRules_finalizeImpl(JNIEnv*, jclass, jlong address) {
     delete toPluralRules(address);
 }
 
+/**
+ * Loading a locale's plural rules means reading them from ICU's resource bundles and parsing
+ * them, so we keep a prototype for each locale we've been asked for, and hand out clones. The
+ * prototypes are never freed. They're keyed by ICU's canonical locale name, so every spelling
+ * of a locale shares one entry. Callers can make up as many distinct locales as they like, so
+ * the cache is capped too; rules for locales seen once it's full are loaded afresh each time.
+ */
+static std::map<std::string, PluralRules*> gPluralRules;
+static pthread_mutex_t gPluralRulesLock = PTHREAD_MUTEX_INITIALIZER;
+// ICU only has a couple of hundred locales.
+static const size_t MAX_CACHED_PLURAL_RULES = 256;
+
+static PluralRules* cloneCachedPluralRules(const std::string& localeName) {
+    ScopedPthreadMutexLock lock(&gPluralRulesLock);
+    std::map<std::string, PluralRules*>::const_iterator it = gPluralRules.find(localeName);
+    return (it != gPluralRules.end()) ? it->second->clone() : NULL;
+}
+
+// Takes ownership of 'prototype' and returns true, unless another thread got there first
+// or the cache is full.
+static bool cachePluralRules(const std::string& localeName, PluralRules* prototype) {
+    ScopedPthreadMutexLock lock(&gPluralRulesLock);
+    if (gPluralRules.size() >= MAX_CACHED_PLURAL_RULES) {
+        return false;
+    }
+    return gPluralRules.insert(std::make_pair(localeName, prototype)).second;
+}
+
 static jlong NativePluralRules_forLocaleImpl(JNIEnv* env, jclass, jstring javaLocaleName) {
     // The icu4c PluralRules returns a "other: n" default rule for the deprecated locales Java uses.
     // Work around this by translating back to the current language codes.
-    std::string localeName(ScopedUtfChars(env, javaLocaleName).c_str());
+    ScopedUtfChars javaLocaleNameChars(env, javaLocaleName);
+    if (javaLocaleNameChars.c_str() == NULL) {
+        return 0;
+    }
+    std::string localeName(javaLocaleNameChars.c_str());
     if (localeName[0] == 'i' && localeName[1] == 'w') {
         localeName[0] = 'h';
         localeName[1] = 'e';
@@ -49,9 +85,30 @@ static jlong NativePluralRules_forLocaleImpl(JNIEnv* env, jclass, jstring javaLo
     }
 
     Locale locale = Locale::createFromName(localeName.c_str());
+    if (locale.isBogus()) {
+        jniThrowExceptionFmt(env, "java/lang/IllegalArgumentException", "invalid locale: %s",
+                             localeName.c_str());
+        return 0;
+    }
+    const std::string canonicalName(locale.getName());
+    PluralRules* result = cloneCachedPluralRules(canonicalName);
+    if (result != NULL) {
+        return reinterpret_cast<uintptr_t>(result);
+    }
+
     UErrorCode status = U_ZERO_ERROR;
-    PluralRules* result = PluralRules::forLocale(locale, status);
-    maybeThrowIcuException(env, "PluralRules::forLocale", status);
+    UniquePtr<PluralRules> prototype(PluralRules::forLocale(locale, status));
+    if (maybeThrowIcuException(env, "PluralRules::forLocale", status)) {
+        return 0;
+    }
+    result = prototype->clone();
+    if (result == NULL) {
+        jniThrowOutOfMemoryError(env, NULL);
+        return 0;
+    }
+    if (cachePluralRules(canonicalName, prototype.get())) {
+        prototype.release();
+    }
     return reinterpret_cast<uintptr_t>(result);
 }
 
@@ -60,7 +60,8 @@ static bool setStringArrayElement(JNIEnv* env, jobjectArray array, int i, const
   return true;
 }
 
-static void TimeZoneNames_fillZoneStrings(JNIEnv* env, jclass, jstring javaLocaleName, jobjectArray result) {
+// Fills in rows [start, end) of 'result'. Disjoint ranges can be filled on different threads.
+static void TimeZoneNames_fillZoneStrings(JNIEnv* env, jclass, jstring javaLocaleName, jobjectArray result, jint start, jint end) {
   ScopedIcuLocale icuLocale(env, javaLocaleName);
   if (!icuLocale.valid()) {
     return;
@@ -76,8 +77,7 @@ static void TimeZoneNames_fillZoneStrings(JNIEnv* env, jclass, jstring javaLocal
 
   static const UnicodeString kUtc("UTC", 3, US_INV);
 
-  size_t id_count = env->GetArrayLength(result);
-  for (size_t i = 0; i < id_count; ++i) {
+  for (jint i = start; i < end; ++i) {
     ScopedLocalRef<jobjectArray> java_row(env,
                                           reinterpret_cast<jobjectArray>(env->GetObjectArrayElement(result, i)));
     ScopedLocalRef<jstring> java_zone_id(env,
@@ -140,7 +140,7 @@ static jstring TimeZoneNames_getExemplarLocation(JNIEnv* env, jclass, jstring ja
 }
 
 static JNINativeMethod gMethods[] = {
-  NATIVE_METHOD(TimeZoneNames, fillZoneStrings, "(Ljava/lang/String;[[Ljava/lang/String;)V"),
+  NATIVE_METHOD(TimeZoneNames, fillZoneStrings, "(Ljava/lang/String;[[Ljava/lang/String;II)V"),
   NATIVE_METHOD(TimeZoneNames, getExemplarLocation, "(Ljava/lang/String;Ljava/lang/String;)Ljava/lang/String;"),
 };
 void register_libcore_icu_TimeZoneNames(JNIEnv* env) {
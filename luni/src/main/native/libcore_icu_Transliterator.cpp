@@ -21,22 +21,87 @@
 #include "JniConstants.h"
 #include "JniException.h"
 #include "ScopedJavaUnicodeString.h"
+#include "ScopedLocalRef.h"
+#include "ScopedPthreadMutexLock.h"
+#include "UniquePtr.h"
 #include "unicode/translit.h"
 
+#include <list>
+#include <pthread.h>
+
 static Transliterator* fromPeer(jlong peer) {
   return reinterpret_cast<Transliterator*>(static_cast<uintptr_t>(peer));
 }
 
+/**
+ * Creating a transliterator means parsing its id and looking up each of its parts in ICU's
+ * registry (under a global lock), and compiling rules for anything built from them. We keep
+ * a small LRU cache of prototypes, keyed by id, and hand out clones. The prototypes are only
+ * ever cloned, never used to transliterate, so clones never share mutable state.
+ */
+struct CachedTransliterator {
+  UnicodeString id;
+  Transliterator* prototype;
+};
+static const size_t MAX_CACHED_TRANSLITERATORS = 16;
+static std::list<CachedTransliterator> gTransliterators;
+static pthread_mutex_t gTransliteratorsLock = PTHREAD_MUTEX_INITIALIZER;
+
+// Returns a clone of the cached prototype for 'id', or NULL if there isn't one.
+static Transliterator* cloneCachedTransliterator(const UnicodeString& id) {
+  ScopedPthreadMutexLock lock(&gTransliteratorsLock);
+  for (std::list<CachedTransliterator>::iterator it = gTransliterators.begin();
+       it != gTransliterators.end(); ++it) {
+    if (it->id == id) {
+      gTransliterators.splice(gTransliterators.begin(), gTransliterators, it);
+      return it->prototype->clone();
+    }
+  }
+  return NULL;
+}
+
+// Takes ownership of 'prototype' unless another thread got there first.
+static void cacheTransliterator(const UnicodeString& id, Transliterator* prototype) {
+  ScopedPthreadMutexLock lock(&gTransliteratorsLock);
+  for (std::list<CachedTransliterator>::iterator it = gTransliterators.begin();
+       it != gTransliterators.end(); ++it) {
+    if (it->id == id) {
+      delete prototype;
+      return;
+    }
+  }
+  CachedTransliterator entry;
+  entry.id = id;
+  entry.prototype = prototype;
+  gTransliterators.push_front(entry);
+  if (gTransliterators.size() > MAX_CACHED_TRANSLITERATORS) {
+    delete gTransliterators.back().prototype;
+    gTransliterators.pop_back();
+  }
+}
+
 static jlong Transliterator_create(JNIEnv* env, jclass, jstring javaId) {
   ScopedJavaUnicodeString id(env, javaId);
   if (!id.valid()) {
     return 0;
   }
+  Transliterator* t = cloneCachedTransliterator(id.unicodeString());
+  if (t != NULL) {
+    return reinterpret_cast<uintptr_t>(t);
+  }
   UErrorCode status = U_ZERO_ERROR;
-  Transliterator* t = Transliterator::createInstance(id.unicodeString(), UTRANS_FORWARD, status);
+  UniquePtr<Transliterator> prototype(
+      Transliterator::createInstance(id.unicodeString(), UTRANS_FORWARD, status));
   if (maybeThrowIcuException(env, "Transliterator::createInstance", status)) {
     return 0;
   }
+  t = prototype->clone();
+  if (t == NULL) {
+    jniThrowOutOfMemoryError(env, NULL);
+    return 0;
+  }
+  // Copy the (aliased) id, since the cache outlives the Java string.
+  cacheTransliterator(UnicodeString(id.unicodeString()), prototype.release());
   return reinterpret_cast<uintptr_t>(t);
 }
 
@@ -62,11 +127,40 @@ static jstring Transliterator_transliterate(JNIEnv* env, jclass, jlong peer, jst
   return env->NewString(s.getBuffer(), s.length());
 }
 
+static jobjectArray Transliterator_transliterateAll(JNIEnv* env, jclass, jlong peer,
+                                                    jobjectArray javaStrings) {
+  Transliterator* t = fromPeer(peer);
+  jsize count = env->GetArrayLength(javaStrings);
+  jobjectArray result = env->NewObjectArray(count, JniConstants::stringClass, NULL);
+  if (result == NULL) {
+    return NULL;
+  }
+  UnicodeString s;
+  for (jsize i = 0; i < count; ++i) {
+    ScopedLocalRef<jstring> javaString(env,
+        reinterpret_cast<jstring>(env->GetObjectArrayElement(javaStrings, i)));
+    ScopedJavaUnicodeString string(env, javaString.get());
+    if (!string.valid()) {
+      return NULL;
+    }
+    // Reuse one buffer rather than having each aliased string copy on write.
+    s = string.unicodeString();
+    t->transliterate(s);
+    ScopedLocalRef<jstring> transliterated(env, env->NewString(s.getBuffer(), s.length()));
+    if (transliterated.get() == NULL) {
+      return NULL;
+    }
+    env->SetObjectArrayElement(result, i, transliterated.get());
+  }
+  return result;
+}
+
 static JNINativeMethod gMethods[] = {
   NATIVE_METHOD(Transliterator, create, "(Ljava/lang/String;)J"),
   NATIVE_METHOD(Transliterator, destroy, "(J)V"),
   NATIVE_METHOD(Transliterator, getAvailableIDs, "()[Ljava/lang/String;"),
   NATIVE_METHOD(Transliterator, transliterate, "(JLjava/lang/String;)Ljava/lang/String;"),
+  NATIVE_METHOD(Transliterator, transliterateAll, "(J[Ljava/lang/String;)[Ljava/lang/String;"),
 };
 void register_libcore_icu_Transliterator(JNIEnv* env) {
   jniRegisterNativeMethods(env, "libcore/icu/Transliterator", gMethods, NELEM(gMethods));
@@ -0,0 +1,73 @@
+/*
+ * Copyright (C) 2014 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#define LOG_TAG "Base64"
+
+#include "Base64Utilities.h"
+#include "JNIHelp.h"
+#include "JniConstants.h"
+#include "ScopedPrimitiveArray.h"
+#include "jni.h"
+
+#include <stdint.h>
+
+// The Java side checks all offsets and lengths, and that there's room for the output.
+
+static jint Base64_encode(JNIEnv* env, jclass, jbyteArray javaSrc, jint offset, jint length, jbyteArray javaDst, jint dstOffset) {
+    ScopedByteArrayRO src(env, javaSrc);
+    if (src.get() == NULL) {
+        return -1;
+    }
+    ScopedByteArrayRW dst(env, javaDst);
+    if (dst.get() == NULL) {
+        return -1;
+    }
+    return base64Encode(src.get() + offset, length, dst.get() + dstOffset);
+}
+
+static jint Base64_decode(JNIEnv* env, jclass, jbyteArray javaSrc, jint offset, jint length, jbyteArray javaDst, jint dstOffset, jint capacity, jboolean strict) {
+    ScopedByteArrayRO src(env, javaSrc);
+    if (src.get() == NULL) {
+        return -1;
+    }
+    ScopedByteArrayRW dst(env, javaDst);
+    if (dst.get() == NULL) {
+        return -1;
+    }
+    return base64Decode(src.get() + offset, length, dst.get() + dstOffset, capacity, strict);
+}
+
+template <typename T> static T cast(jlong address) {
+    return reinterpret_cast<T>(static_cast<uintptr_t>(address));
+}
+
+static jint Base64_encodeDirect(JNIEnv*, jclass, jlong srcAddress, jint length, jlong dstAddress) {
+    return base64Encode(cast<const jbyte*>(srcAddress), length, cast<jbyte*>(dstAddress));
+}
+
+static jint Base64_decodeDirect(JNIEnv*, jclass, jlong srcAddress, jint length, jlong dstAddress, jint capacity, jboolean strict) {
+    return base64Decode(cast<const jbyte*>(srcAddress), length, cast<jbyte*>(dstAddress), capacity, strict);
+}
+
+static JNINativeMethod gMethods[] = {
+    NATIVE_METHOD(Base64, decode, "([BII[BIIZ)I"),
+    NATIVE_METHOD(Base64, decodeDirect, "(JIJIZ)I"),
+    NATIVE_METHOD(Base64, encode, "([BII[BI)I"),
+    NATIVE_METHOD(Base64, encodeDirect, "(JIJ)I"),
+};
+void register_libcore_io_Base64(JNIEnv* env) {
+    jniRegisterNativeMethods(env, "libcore/io/Base64", gMethods, NELEM(gMethods));
+}
@@ -0,0 +1,370 @@
+/*
+ * Copyright (C) 2014 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#define LOG_TAG "EventPoller"
+
+#include "AsynchronousCloseMonitor.h"
+#include "JNIHelp.h"
+#include "JniException.h"
+#include "ScopedPrimitiveArray.h"
+#include "ScopedPthreadMutexLock.h"
+#include "jni.h"
+
+#include <errno.h>
+#include <string.h>
+
+#include <algorithm>
+
+#if defined(__linux__)
+#define HAVE_EPOLL 1
+#include <poll.h>
+#include <sys/epoll.h>
+#include <unistd.h>
+#elif defined(__APPLE__)
+#define HAVE_KQUEUE 1
+#include <poll.h>
+#include <sys/event.h>
+#include <sys/time.h>
+#include <sys/types.h>
+#include <unistd.h>
+#elif defined(__MINGW32__) || defined(__MINGW64__)
+#define HAVE_WSAPOLL 1
+#include "mingw-extensions.h"
+#include <map>
+#include <vector>
+#endif
+
+#ifndef __unused
+#define __unused __attribute__((__unused__))
+#endif
+
+// The most events we collect from the kernel per poll. A caller with more ready fds than this
+// simply sees the rest next time.
+static const int MAX_EVENTS_PER_POLL = 512;
+
+#if defined(HAVE_EPOLL)
+
+static uint32_t pollToEpoll(int events) {
+    uint32_t result = 0;
+    if (events & POLLIN) result |= EPOLLIN;
+    if (events & POLLPRI) result |= EPOLLPRI;
+    if (events & POLLOUT) result |= EPOLLOUT;
+    return result;
+}
+
+static int epollToPoll(uint32_t events) {
+    int result = 0;
+    if (events & EPOLLIN) result |= POLLIN;
+    if (events & EPOLLPRI) result |= POLLPRI;
+    if (events & EPOLLOUT) result |= POLLOUT;
+    if (events & EPOLLERR) result |= POLLERR;
+    if (events & EPOLLHUP) result |= POLLHUP;
+    return result;
+}
+
+static void control(JNIEnv* env, jobject javaPollerFd, int op, jobject javaFd, jint events) {
+    int pollerFd = jniGetFDFromFileDescriptor(env, javaPollerFd);
+    int fd = jniGetFDFromFileDescriptor(env, javaFd);
+    epoll_event event;
+    memset(&event, 0, sizeof(event));
+    event.events = pollToEpoll(events);
+    event.data.fd = fd;
+    if (epoll_ctl(pollerFd, op, fd, &event) == -1) {
+        jniThrowErrnoException(env, "epoll_ctl", errno);
+    }
+}
+
+#elif defined(HAVE_KQUEUE)
+
+// kqueue tracks reading and writing as separate filters, so we always register both and just
+// enable or disable each one according to the requested poll(2) events.
+static void control(JNIEnv* env, jobject javaPollerFd, int flags, jobject javaFd, jint events) {
+    int pollerFd = jniGetFDFromFileDescriptor(env, javaPollerFd);
+    int fd = jniGetFDFromFileDescriptor(env, javaFd);
+    struct kevent changes[2];
+    if (flags == EV_DELETE) {
+        EV_SET(&changes[0], fd, EVFILT_READ, EV_DELETE, 0, 0, NULL);
+        EV_SET(&changes[1], fd, EVFILT_WRITE, EV_DELETE, 0, 0, NULL);
+    } else {
+        EV_SET(&changes[0], fd, EVFILT_READ,
+                flags | ((events & (POLLIN | POLLPRI)) ? EV_ENABLE : EV_DISABLE), 0, 0, NULL);
+        EV_SET(&changes[1], fd, EVFILT_WRITE,
+                flags | ((events & POLLOUT) ? EV_ENABLE : EV_DISABLE), 0, 0, NULL);
+    }
+    if (kevent(pollerFd, changes, 2, NULL, 0, NULL) == -1) {
+        jniThrowErrnoException(env, "kevent", errno);
+    }
+}
+
+#elif defined(HAVE_WSAPOLL)
+
+// Windows has no kernel-side interest set, so each poller's lives here instead, keyed by the
+// socket that serves as the poller's file descriptor. poll() still hands the whole set to
+// WSAPoll, but as one prebuilt array rather than JNI field reads and a monitor per descriptor.
+// Windows doesn't tell us when a registered socket is closed, so it stays registered (and is
+// reported with POLLNVAL) until removed.
+struct InterestSet {
+    std::vector<pollfd> fds;
+    std::map<SOCKET, size_t> indexes;
+};
+
+static std::map<int, InterestSet> gPollers;
+static pthread_mutex_t gPollersMutex = PTHREAD_MUTEX_INITIALIZER;
+
+enum ControlOp {
+    CONTROL_ADD,
+    CONTROL_MODIFY,
+    CONTROL_REMOVE,
+};
+
+static void control(JNIEnv* env, jobject javaPollerFd, ControlOp op, jobject javaFd, jint events) {
+    int pollerFd = jniGetFDFromFileDescriptor(env, javaPollerFd);
+    SOCKET fd = jniGetFDFromFileDescriptor(env, javaFd);
+    int error = 0;
+    {
+        ScopedPthreadMutexLock lock(&gPollersMutex);
+        std::map<int, InterestSet>::iterator poller = gPollers.find(pollerFd);
+        if (poller == gPollers.end()) {
+            error = EBADF;
+        } else {
+            InterestSet& set = poller->second;
+            std::map<SOCKET, size_t>::iterator it = set.indexes.find(fd);
+            if (op == CONTROL_ADD) {
+                if (it != set.indexes.end()) {
+                    error = EEXIST;
+                } else {
+                    pollfd entry = { fd, static_cast<short>(events), 0 };
+                    set.indexes[fd] = set.fds.size();
+                    set.fds.push_back(entry);
+                }
+            } else if (it == set.indexes.end()) {
+                error = ENOENT;
+            } else if (op == CONTROL_MODIFY) {
+                set.fds[it->second].events = events;
+            } else {
+                // Move the last entry into the hole, so removal doesn't shift the array.
+                size_t index = it->second;
+                set.indexes.erase(it);
+                pollfd last = set.fds.back();
+                set.fds.pop_back();
+                if (index < set.fds.size()) {
+                    set.fds[index] = last;
+                    set.indexes[last.fd] = index;
+                }
+            }
+        }
+    }
+    if (error != 0) {
+        jniThrowErrnoException(env, "EventPoller", error);
+    }
+}
+
+#endif
+
+static jobject EventPoller_create(JNIEnv* env, jclass) {
+#if defined(HAVE_EPOLL)
+    int fd = epoll_create1(EPOLL_CLOEXEC);
+    if (fd == -1) {
+        jniThrowErrnoException(env, "epoll_create1", errno);
+        return NULL;
+    }
+    return jniCreateFileDescriptor(env, fd);
+#elif defined(HAVE_KQUEUE)
+    int fd = kqueue();
+    if (fd == -1) {
+        jniThrowErrnoException(env, "kqueue", errno);
+        return NULL;
+    }
+    return jniCreateFileDescriptor(env, fd);
+#elif defined(HAVE_WSAPOLL)
+    // The socket is never used for I/O; it just gives the poller a descriptor to close, and
+    // that a thread blocked in poll can be signaled through.
+    SOCKET fd = mingw_socket(AF_INET, SOCK_DGRAM, 0);
+    if (fd == INVALID_SOCKET) {
+        jniThrowErrnoException(env, "socket", windowsErrorToErrno(WSAGetLastError()));
+        return NULL;
+    }
+    {
+        ScopedPthreadMutexLock lock(&gPollersMutex);
+        gPollers[fd] = InterestSet();
+    }
+    return jniCreateFileDescriptor(env, fd);
+#else
+    jniThrowErrnoException(env, "EventPoller", ENOSYS);
+    return NULL;
+#endif
+}
+
+static void EventPoller_destroy(JNIEnv* env __unused, jclass, jobject javaPollerFd __unused) {
+#if defined(HAVE_WSAPOLL)
+    int pollerFd = jniGetFDFromFileDescriptor(env, javaPollerFd);
+    ScopedPthreadMutexLock lock(&gPollersMutex);
+    gPollers.erase(pollerFd);
+#else
+    // The interest set lives in the kernel, and goes away with the descriptor.
+#endif
+}
+
+static void EventPoller_add(JNIEnv* env, jclass, jobject javaPollerFd, jobject javaFd, jint events) {
+#if defined(HAVE_EPOLL)
+    control(env, javaPollerFd, EPOLL_CTL_ADD, javaFd, events);
+#elif defined(HAVE_KQUEUE)
+    control(env, javaPollerFd, EV_ADD, javaFd, events);
+#elif defined(HAVE_WSAPOLL)
+    control(env, javaPollerFd, CONTROL_ADD, javaFd, events);
+#else
+    jniThrowErrnoException(env, "EventPoller", ENOSYS);
+#endif
+}
+
+static void EventPoller_modify(JNIEnv* env, jclass, jobject javaPollerFd, jobject javaFd, jint events) {
+#if defined(HAVE_EPOLL)
+    control(env, javaPollerFd, EPOLL_CTL_MOD, javaFd, events);
+#elif defined(HAVE_KQUEUE)
+    control(env, javaPollerFd, EV_ADD, javaFd, events);
+#elif defined(HAVE_WSAPOLL)
+    control(env, javaPollerFd, CONTROL_MODIFY, javaFd, events);
+#else
+    jniThrowErrnoException(env, "EventPoller", ENOSYS);
+#endif
+}
+
+static void EventPoller_remove(JNIEnv* env, jclass, jobject javaPollerFd, jobject javaFd) {
+#if defined(HAVE_EPOLL)
+    control(env, javaPollerFd, EPOLL_CTL_DEL, javaFd, 0);
+#elif defined(HAVE_KQUEUE)
+    control(env, javaPollerFd, EV_DELETE, javaFd, 0);
+#elif defined(HAVE_WSAPOLL)
+    control(env, javaPollerFd, CONTROL_REMOVE, javaFd, 0);
+#else
+    jniThrowErrnoException(env, "EventPoller", ENOSYS);
+#endif
+}
+
+static jint EventPoller_poll(JNIEnv* env, jclass, jobject javaPollerFd, jintArray javaReady, jint timeoutMs) {
+#if defined(HAVE_EPOLL) || defined(HAVE_KQUEUE) || defined(HAVE_WSAPOLL)
+    ScopedIntArrayRW ready(env, javaReady);
+    if (ready.get() == NULL) {
+        return -1;
+    }
+    int maxEvents = std::min(static_cast<int>(ready.size() / 2), MAX_EVENTS_PER_POLL);
+    if (maxEvents == 0) {
+        jniThrowException(env, "java/lang/IllegalArgumentException", "ready.length < 2");
+        return -1;
+    }
+
+    int pollerFd = jniGetFDFromFileDescriptor(env, javaPollerFd);
+    int rc;
+    int error;
+#if defined(HAVE_EPOLL)
+    epoll_event events[MAX_EVENTS_PER_POLL];
+    {
+        AsynchronousCloseMonitor monitor(pollerFd);
+        rc = epoll_wait(pollerFd, events, maxEvents, timeoutMs);
+        error = monitor.wasSignaled() ? EINTR : errno;
+    }
+#elif defined(HAVE_KQUEUE)
+    struct kevent events[MAX_EVENTS_PER_POLL];
+    timespec timeout;
+    timeout.tv_sec = timeoutMs / 1000;
+    timeout.tv_nsec = (timeoutMs % 1000) * 1000000L;
+    {
+        AsynchronousCloseMonitor monitor(pollerFd);
+        rc = kevent(pollerFd, NULL, 0, events, maxEvents, timeoutMs < 0 ? NULL : &timeout);
+        error = monitor.wasSignaled() ? EINTR : errno;
+    }
+#else
+    std::vector<pollfd> fds;
+    {
+        ScopedPthreadMutexLock lock(&gPollersMutex);
+        std::map<int, InterestSet>::const_iterator poller = gPollers.find(pollerFd);
+        if (poller == gPollers.end()) {
+            jniThrowErrnoException(env, "EventPoller.poll", EBADF);
+            return -1;
+        }
+        fds = poller->second.fds;
+    }
+    size_t count = fds.size();
+    // As in Os.poll, a poll that can block also waits on this thread's unlock pair, which is
+    // how signalBlockedThreads wakes it when the poller is closed.
+    UnlockPair* unlockPair = (timeoutMs != 0) ? UnlockPair::forCurrentThread() : NULL;
+    if (unlockPair != NULL) {
+        // Discard a wakeup meant for some earlier blocking call.
+        unlockPair->pop();
+        pollfd wakeup = { unlockPair->end2, POLLIN, 0 };
+        fds.push_back(wakeup);
+    }
+    {
+        AsynchronousCloseMonitor monitor(pollerFd);
+        pollfd none;
+        rc = poll(fds.empty() ? &none : &fds[0], fds.size(), timeoutMs);
+        error = monitor.wasSignaled() ? EINTR : errno;
+    }
+    if (unlockPair != NULL && rc > 0 && fds[count].revents != 0) {
+        unlockPair->pop();
+        if (--rc == 0) {
+            rc = -1;
+            error = EINTR;
+        }
+    }
+#endif
+    if (rc == -1) {
+        jniThrowErrnoException(env, "EventPoller.poll", error);
+        return -1;
+    }
+
+#if defined(HAVE_WSAPOLL)
+    // WSAPoll reports readiness in place, so pick out the ready entries.
+    rc = 0;
+    for (size_t i = 0; i < count && rc < maxEvents; ++i) {
+        if (fds[i].revents != 0) {
+            ready[2*rc] = fds[i].fd;
+            ready[2*rc + 1] = fds[i].revents;
+            ++rc;
+        }
+    }
+#else
+    for (int i = 0; i < rc; ++i) {
+#if defined(HAVE_EPOLL)
+        ready[2*i] = events[i].data.fd;
+        ready[2*i + 1] = epollToPoll(events[i].events);
+#else
+        int revents = (events[i].filter == EVFILT_WRITE) ? POLLOUT : POLLIN;
+        if (events[i].flags & EV_EOF) revents |= POLLHUP;
+        if (events[i].flags & EV_ERROR) revents |= POLLERR;
+        ready[2*i] = events[i].ident;
+        ready[2*i + 1] = revents;
+#endif
+    }
+#endif
+    return rc;
+#else
+    jniThrowErrnoException(env, "EventPoller", ENOSYS);
+    return -1;
+#endif
+}
+
+static JNINativeMethod gMethods[] = {
+    NATIVE_METHOD(EventPoller, add, "(Ljava/io/FileDescriptor;Ljava/io/FileDescriptor;I)V"),
+    NATIVE_METHOD(EventPoller, create, "()Ljava/io/FileDescriptor;"),
+    NATIVE_METHOD(EventPoller, destroy, "(Ljava/io/FileDescriptor;)V"),
+    NATIVE_METHOD(EventPoller, modify, "(Ljava/io/FileDescriptor;Ljava/io/FileDescriptor;I)V"),
+    NATIVE_METHOD(EventPoller, poll, "(Ljava/io/FileDescriptor;[II)I"),
+    NATIVE_METHOD(EventPoller, remove, "(Ljava/io/FileDescriptor;Ljava/io/FileDescriptor;)V"),
+};
+void register_libcore_io_EventPoller(JNIEnv* env) {
+    jniRegisterNativeMethods(env, "libcore/io/EventPoller", gMethods, NELEM(gMethods));
+}
@@ -0,0 +1,214 @@
+/*
+ * Copyright (C) 2014 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#define LOG_TAG "GroupCommit"
+
+#include "JNIHelp.h"
+#include "JniException.h"
+#include "ScopedPrimitiveArray.h"
+#include "ScopedPthreadMutexLock.h"
+#include "jni.h"
+
+#include <errno.h>
+#include <pthread.h>
+#include <stdint.h>
+#include <time.h>
+#include <unistd.h>
+
+#if defined(__MINGW32__) || defined(__MINGW64__)
+#include "mingw-extensions.h"
+#endif
+
+// Group commit: when several threads want the same fd synced at once, one of them (the
+// leader) makes a single fdatasync(2) or fsync(2) on behalf of all those that were already
+// waiting when it started, and wakes them all with its result. Anyone arriving during a sync
+// can't know whether their writes were included, so they queue for the next one, which the
+// first of them to wake leads. This costs each caller at most two flushes' latency, but turns
+// N concurrent flushes into roughly two.
+
+namespace {
+
+struct Waiter {
+    uint64_t generation;
+    bool metadata;
+    bool done;
+    int error;
+    Waiter* next;
+};
+
+struct SyncGroup {
+    int fd;
+    int users;
+    // The generation of the most recently started sync.
+    uint64_t started;
+    bool syncing;
+    Waiter* waiters;
+    pthread_cond_t cond;
+    SyncGroup* next;
+};
+
+}  // namespace
+
+// One lock covers every group: it's only held for list manipulation, never across a sync.
+static pthread_mutex_t gGroupsMutex = PTHREAD_MUTEX_INITIALIZER;
+static SyncGroup* gGroups;
+
+static uint64_t gRequests;
+static uint64_t gSyncs;
+static uint64_t gMaxBatchSize;
+static uint64_t gSyncNanos;
+static uint64_t gWaitNanos;
+
+static uint64_t monotonicNanos() {
+    timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return static_cast<uint64_t>(now.tv_sec) * 1000000000ULL + now.tv_nsec;
+}
+
+static SyncGroup* acquireGroup(int fd) {
+    for (SyncGroup* group = gGroups; group != NULL; group = group->next) {
+        if (group->fd == fd) {
+            ++group->users;
+            return group;
+        }
+    }
+    SyncGroup* group = new SyncGroup;
+    group->fd = fd;
+    group->users = 1;
+    group->started = 0;
+    group->syncing = false;
+    group->waiters = NULL;
+    pthread_cond_init(&group->cond, NULL);
+    group->next = gGroups;
+    gGroups = group;
+    return group;
+}
+
+static void releaseGroup(SyncGroup* group) {
+    if (--group->users > 0) {
+        return;
+    }
+    for (SyncGroup** p = &gGroups; *p != NULL; p = &(*p)->next) {
+        if (*p == group) {
+            *p = group->next;
+            break;
+        }
+    }
+    pthread_cond_destroy(&group->cond);
+    delete group;
+}
+
+// Called by a leader with the lock held to sync on behalf of every waiter of 'generation'.
+static void leadSync(SyncGroup* group, uint64_t generation) {
+    bool metadata = false;
+    uint64_t batchSize = 0;
+    for (Waiter* w = group->waiters; w != NULL; w = w->next) {
+        if (w->generation == generation) {
+            metadata |= w->metadata;
+            ++batchSize;
+        }
+    }
+
+    group->syncing = true;
+    pthread_mutex_unlock(&gGroupsMutex);
+    uint64_t startNs = monotonicNanos();
+    int rc = metadata ? TEMP_FAILURE_RETRY(fsync(group->fd))
+                      : TEMP_FAILURE_RETRY(fdatasync(group->fd));
+    int error = (rc == -1) ? errno : 0;
+    uint64_t syncNs = monotonicNanos() - startNs;
+    pthread_mutex_lock(&gGroupsMutex);
+    group->syncing = false;
+
+    for (Waiter** p = &group->waiters; *p != NULL; ) {
+        Waiter* w = *p;
+        if (w->generation == generation) {
+            w->error = error;
+            w->done = true;
+            *p = w->next;
+        } else {
+            p = &w->next;
+        }
+    }
+    ++gSyncs;
+    gSyncNanos += syncNs;
+    if (batchSize > gMaxBatchSize) {
+        gMaxBatchSize = batchSize;
+    }
+    pthread_cond_broadcast(&group->cond);
+}
+
+static void GroupCommit_sync(JNIEnv* env, jclass, jobject javaFd, jboolean metadata) {
+    int fd = jniGetFDFromFileDescriptor(env, javaFd);
+    if (fd == -1) {
+        jniThrowErrnoException(env, metadata ? "fsync" : "fdatasync", EBADF);
+        return;
+    }
+
+    uint64_t startNs = monotonicNanos();
+    Waiter self;
+    {
+        ScopedPthreadMutexLock lock(&gGroupsMutex);
+        SyncGroup* group = acquireGroup(fd);
+        self.generation = group->started + 1;
+        self.metadata = metadata;
+        self.done = false;
+        self.error = 0;
+        self.next = group->waiters;
+        group->waiters = &self;
+        ++gRequests;
+
+        while (!self.done) {
+            if (!group->syncing) {
+                // The previous sync has finished, so ours is next, and we start it.
+                leadSync(group, ++group->started);
+            } else {
+                pthread_cond_wait(&group->cond, &gGroupsMutex);
+            }
+        }
+        releaseGroup(group);
+        gWaitNanos += monotonicNanos() - startNs;
+    }
+
+    if (self.error != 0) {
+        jniThrowErrnoException(env, metadata ? "fsync" : "fdatasync", self.error);
+    }
+}
+
+static jlongArray GroupCommit_nativeStats(JNIEnv* env, jclass) {
+    jlong values[5];
+    {
+        ScopedPthreadMutexLock lock(&gGroupsMutex);
+        values[0] = gRequests;
+        values[1] = gSyncs;
+        values[2] = gMaxBatchSize;
+        values[3] = gSyncNanos;
+        values[4] = gWaitNanos;
+    }
+    jlongArray result = env->NewLongArray(NELEM(values));
+    if (result != NULL) {
+        env->SetLongArrayRegion(result, 0, NELEM(values), values);
+    }
+    return result;
+}
+
+static JNINativeMethod gMethods[] = {
+    NATIVE_METHOD(GroupCommit, nativeStats, "()[J"),
+    NATIVE_METHOD(GroupCommit, sync, "(Ljava/io/FileDescriptor;Z)V"),
+};
+void register_libcore_io_GroupCommit(JNIEnv* env) {
+    jniRegisterNativeMethods(env, "libcore/io/GroupCommit", gMethods, NELEM(gMethods));
+}
@@ -0,0 +1,577 @@
+/*
+ * Copyright (C) 2014 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#define LOG_TAG "IoUring"
+
+#include "AsynchronousCloseMonitor.h"
+#include "JNIHelp.h"
+#include "JniException.h"
+#include "ScopedPrimitiveArray.h"
+#include "UniquePtr.h"
+#include "cutils/log.h"
+#include "jni.h"
+
+#include <errno.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <algorithm>
+#include <vector>
+
+#if defined(__linux__)
+#include <sys/syscall.h>
+#endif
+
+#if defined(__linux__) && defined(__NR_io_uring_setup) && defined(__NR_io_uring_enter)
+#define HAVE_IO_URING 1
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#endif
+
+template <typename T>
+static inline T cast(jlong address) {
+    return reinterpret_cast<T>(static_cast<uintptr_t>(address));
+}
+
+#if defined(HAVE_IO_URING)
+
+// Slots kept back for cancellations; enough to cancel every op on a closed fd at once in the
+// common case.
+static const unsigned MAX_RESERVED_SLOTS = 4;
+
+/**
+ * One operation that has been queued but whose completion hasn't been reaped yet. The kernel
+ * reads 'iov' when the operation is issued rather than when it's queued, so it has to live here
+ * rather than on the stack. An operation's index in the ring's table is its sqe's user_data.
+ * Internal operations (our own cancellations) are marked here rather than by a reserved user
+ * data value, so that every jlong remains available to callers.
+ */
+struct IoUringOp {
+    int fd;
+    jlong userData;
+    bool internal;
+    // True if 'fd' was closed and this op still needs an IORING_OP_ASYNC_CANCEL issued for it.
+    bool cancelWanted;
+    iovec iov;
+};
+
+/**
+ * A submission/completion queue pair shared with the kernel, plus the bookkeeping needed to map
+ * completions back to the caller's user data and to cancel operations whose file descriptor is
+ * asynchronously closed.
+ *
+ * A ring has at most cq_entries operations outstanding at once (queued, in flight, or completed
+ * but not yet reaped), so the completion queue can never overflow. A few of those slots are kept
+ * back for the cancellations we issue when an fd is closed, so that a ring the caller has filled
+ * can still cancel. If more ops need cancelling than there are reserved slots, the rest are
+ * issued by later calls to reap or submit, as earlier ones complete and give their slots back.
+ */
+class IoUring {
+public:
+    IoUring() : mRingFd(-1), mSqRing(MAP_FAILED), mCqRing(MAP_FAILED), mSqes(MAP_FAILED),
+            mFreeCount(0), mReservedCount(0), mQueued(0), mCancelsWanted(0) {
+    }
+
+    ~IoUring() {
+        if (mSqes != MAP_FAILED) {
+            munmap(mSqes, mSqesSize);
+        }
+        if (mCqRing != MAP_FAILED) {
+            munmap(mCqRing, mCqRingSize);
+        }
+        if (mSqRing != MAP_FAILED) {
+            munmap(mSqRing, mSqRingSize);
+        }
+        if (mRingFd != -1) {
+            close(mRingFd);
+        }
+    }
+
+    // Returns 0 on success, or an errno value on failure.
+    int init(unsigned entries) {
+        io_uring_params params;
+        memset(&params, 0, sizeof(params));
+        mRingFd = syscall(__NR_io_uring_setup, entries, &params);
+        if (mRingFd == -1) {
+            return errno;
+        }
+
+        mSqRingSize = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+        mSqRing = mmap(NULL, mSqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                mRingFd, IORING_OFF_SQ_RING);
+        if (mSqRing == MAP_FAILED) {
+            return errno;
+        }
+        mCqRingSize = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+        mCqRing = mmap(NULL, mCqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                mRingFd, IORING_OFF_CQ_RING);
+        if (mCqRing == MAP_FAILED) {
+            return errno;
+        }
+        mSqesSize = params.sq_entries * sizeof(io_uring_sqe);
+        mSqes = mmap(NULL, mSqesSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                mRingFd, IORING_OFF_SQES);
+        if (mSqes == MAP_FAILED) {
+            return errno;
+        }
+
+        char* sq = reinterpret_cast<char*>(mSqRing);
+        mSqHead = reinterpret_cast<unsigned*>(sq + params.sq_off.head);
+        mSqTail = reinterpret_cast<unsigned*>(sq + params.sq_off.tail);
+        mSqMask = *reinterpret_cast<unsigned*>(sq + params.sq_off.ring_mask);
+        mSqArray = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+        char* cq = reinterpret_cast<char*>(mCqRing);
+        mCqHead = reinterpret_cast<unsigned*>(cq + params.cq_off.head);
+        mCqTail = reinterpret_cast<unsigned*>(cq + params.cq_off.tail);
+        mCqMask = *reinterpret_cast<unsigned*>(cq + params.cq_off.ring_mask);
+        mCqes = reinterpret_cast<io_uring_cqe*>(cq + params.cq_off.cqes);
+        mSqEntries = params.sq_entries;
+        mCqEntries = params.cq_entries;
+
+        mOps.reset(new IoUringOp[params.cq_entries]);
+        mFreeSlots.reset(new unsigned[params.cq_entries]);
+        for (unsigned i = 0; i < params.cq_entries; ++i) {
+            mFreeSlots[i] = params.cq_entries - 1 - i;
+        }
+        mFreeCount = params.cq_entries;
+        mReservedCount = std::min(MAX_RESERVED_SLOTS, params.cq_entries / 2);
+        return 0;
+    }
+
+    // Returns a zeroed sqe whose user_data identifies a fresh op for 'fd', or NULL if either
+    // queue is full (not counting the slots reserved for cancellations).
+    io_uring_sqe* prepare(int fd, jlong userData, IoUringOp** op) {
+        return prepare(fd, userData, false, op);
+    }
+
+    // Publishes the queued sqes and asks the kernel to consume them, optionally waiting until
+    // at least 'minComplete' completions are available. Returns the number of sqes consumed, or
+    // -1 with errno set. Fails with EINTR if a file descriptor with an operation outstanding on
+    // this ring was closed via AsynchronousCloseMonitor::signalBlockedThreads while we waited;
+    // those operations are cancelled and will complete with -ECANCELED.
+    int submit(unsigned minComplete) {
+        unsigned toSubmit = mQueued;
+        __atomic_store_n(mSqTail, *mSqTail + mQueued, __ATOMIC_RELEASE);
+        mQueued = 0;
+
+        if (minComplete == 0) {
+            int rc = enter(toSubmit, 0, 0);
+            int error = errno;
+            issueWantedCancels();
+            errno = error;
+            return rc;
+        }
+
+        // Register interest in every fd we might be waiting on, so that closing one of them
+        // interrupts us the same way it would interrupt a blocking read(2).
+        std::vector<int> fds(outstandingFds());
+        std::vector<AsynchronousCloseMonitor*> monitors;
+        for (size_t i = 0; i < fds.size(); ++i) {
+            monitors.push_back(new AsynchronousCloseMonitor(fds[i]));
+        }
+        int submitted = 0;
+        int rc;
+        int error;
+        do {
+            rc = enter(toSubmit - submitted, minComplete, IORING_ENTER_GETEVENTS);
+            error = errno;
+            if (rc > 0) {
+                submitted += rc;
+            }
+        } while (rc == -1 && error == EINTR && !anySignaled(monitors));
+
+        std::vector<int> closedFds;
+        for (size_t i = 0; i < monitors.size(); ++i) {
+            if (monitors[i]->wasSignaled()) {
+                closedFds.push_back(fds[i]);
+            }
+            delete monitors[i];
+        }
+        if (!closedFds.empty()) {
+            cancelOpsFor(closedFds);
+            errno = EINTR;
+            return -1;
+        }
+        issueWantedCancels();
+        if (rc == -1) {
+            errno = error;
+            return -1;
+        }
+        return submitted;
+    }
+
+    // Copies up to 'capacity' completions of caller-visible operations out of the completion
+    // queue. Completions of internal operations are consumed and dropped. Doesn't block.
+    size_t reap(jlong* userData, jint* results, size_t capacity) {
+        unsigned head = *mCqHead;
+        unsigned tail = __atomic_load_n(mCqTail, __ATOMIC_ACQUIRE);
+        size_t count = 0;
+        while (head != tail && count < capacity) {
+            const io_uring_cqe& cqe = mCqes[head & mCqMask];
+            unsigned slot = static_cast<unsigned>(cqe.user_data);
+            if (!mOps[slot].internal) {
+                userData[count] = mOps[slot].userData;
+                results[count] = cqe.res;
+                ++count;
+            }
+            freeSlot(slot);
+            ++head;
+        }
+        __atomic_store_n(mCqHead, head, __ATOMIC_RELEASE);
+        // Anything the caller has queued goes to the kernel with their next submit, not now.
+        if (mQueued == 0) {
+            issueWantedCancels();
+        }
+        return count;
+    }
+
+private:
+    io_uring_sqe* prepare(int fd, jlong userData, bool internal, IoUringOp** op) {
+        unsigned head = __atomic_load_n(mSqHead, __ATOMIC_ACQUIRE);
+        unsigned tail = *mSqTail + mQueued;
+        unsigned reserve = internal ? 0 : mReservedCount;
+        if (tail - head >= mSqEntries || mFreeCount <= reserve) {
+            return NULL;
+        }
+        unsigned slot = mFreeSlots[--mFreeCount];
+        IoUringOp& newOp = mOps[slot];
+        newOp.fd = fd;
+        newOp.userData = userData;
+        newOp.internal = internal;
+        newOp.cancelWanted = false;
+        if (op != NULL) {
+            *op = &newOp;
+        }
+
+        unsigned index = tail & mSqMask;
+        io_uring_sqe* sqe = &reinterpret_cast<io_uring_sqe*>(mSqes)[index];
+        memset(sqe, 0, sizeof(*sqe));
+        sqe->fd = fd;
+        sqe->user_data = slot;
+        mSqArray[index] = index;
+        ++mQueued;
+        return sqe;
+    }
+
+    void freeSlot(unsigned slot) {
+        if (mOps[slot].cancelWanted) {
+            // It completed before we got around to cancelling it.
+            mOps[slot].cancelWanted = false;
+            --mCancelsWanted;
+        }
+        mFreeSlots[mFreeCount++] = slot;
+    }
+
+    // Publishes the queued sqes and hands them all to the kernel without waiting.
+    void flush() {
+        __atomic_store_n(mSqTail, *mSqTail + mQueued, __ATOMIC_RELEASE);
+        enter(mQueued, 0, 0);
+        mQueued = 0;
+    }
+
+    int enter(unsigned toSubmit, unsigned minComplete, unsigned flags) {
+        return syscall(__NR_io_uring_enter, mRingFd, toSubmit, minComplete, flags, NULL, 0);
+    }
+
+    // Returns the distinct fds with an operation that hasn't completed yet.
+    std::vector<int> outstandingFds() const {
+        std::vector<bool> isFree(capacity(), false);
+        for (unsigned i = 0; i < mFreeCount; ++i) {
+            isFree[mFreeSlots[i]] = true;
+        }
+        std::vector<int> fds;
+        for (size_t slot = 0; slot < isFree.size(); ++slot) {
+            if (!isFree[slot] && mOps[slot].fd != -1) {
+                fds.push_back(mOps[slot].fd);
+            }
+        }
+        std::sort(fds.begin(), fds.end());
+        fds.erase(std::unique(fds.begin(), fds.end()), fds.end());
+        return fds;
+    }
+
+    size_t capacity() const {
+        return mCqEntries;
+    }
+
+    static bool anySignaled(const std::vector<AsynchronousCloseMonitor*>& monitors) {
+        for (size_t i = 0; i < monitors.size(); ++i) {
+            if (monitors[i]->wasSignaled()) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // Cancels every outstanding op on one of 'fds', as far as the free slots allow; the rest
+    // are remembered and issued by issueWantedCancels as slots come back.
+    void cancelOpsFor(const std::vector<int>& fds) {
+        std::vector<bool> isFree(capacity(), false);
+        for (unsigned i = 0; i < mFreeCount; ++i) {
+            isFree[mFreeSlots[i]] = true;
+        }
+        for (size_t slot = 0; slot < isFree.size(); ++slot) {
+            IoUringOp& op = mOps[slot];
+            if (!isFree[slot] && !op.internal && !op.cancelWanted &&
+                    std::binary_search(fds.begin(), fds.end(), op.fd)) {
+                op.cancelWanted = true;
+                ++mCancelsWanted;
+            }
+        }
+        issueWantedCancels();
+    }
+
+    // Queues and submits an IORING_OP_ASYNC_CANCEL for each op that wants one, until we run out
+    // of slots. Cancellations use fd -1 so they're never themselves cancelled, and are marked
+    // internal so that reap drops their completions. Must only be called with nothing queued.
+    void issueWantedCancels() {
+        for (size_t slot = 0; slot < capacity() && mCancelsWanted > 0; ++slot) {
+            if (!mOps[slot].cancelWanted) {
+                continue;
+            }
+            io_uring_sqe* sqe = prepare(-1, 0, true, NULL);
+            if (sqe == NULL && mQueued > 0) {
+                // The submission queue is full; hand it to the kernel and try again.
+                flush();
+                sqe = prepare(-1, 0, true, NULL);
+            }
+            if (sqe == NULL) {
+                // Every slot is in use. Reaping will free some.
+                break;
+            }
+            sqe->opcode = IORING_OP_ASYNC_CANCEL;
+            sqe->addr = slot;
+            mOps[slot].cancelWanted = false;
+            --mCancelsWanted;
+        }
+        if (mQueued > 0) {
+            flush();
+        }
+    }
+
+    int mRingFd;
+    void* mSqRing;
+    size_t mSqRingSize;
+    void* mCqRing;
+    size_t mCqRingSize;
+    void* mSqes;
+    size_t mSqesSize;
+
+    unsigned* mSqHead;
+    unsigned* mSqTail;
+    unsigned mSqMask;
+    unsigned* mSqArray;
+    unsigned mSqEntries;
+    unsigned* mCqHead;
+    unsigned* mCqTail;
+    unsigned mCqMask;
+    unsigned mCqEntries;
+    io_uring_cqe* mCqes;
+
+    UniquePtr<IoUringOp[]> mOps;
+    UniquePtr<unsigned[]> mFreeSlots;
+    unsigned mFreeCount;
+    // How many free slots only internal ops may use.
+    unsigned mReservedCount;
+    // The number of sqes written since the tail was last published to the kernel.
+    unsigned mQueued;
+    // The number of ops with cancelWanted set.
+    unsigned mCancelsWanted;
+
+    // Disallow copy and assignment.
+    IoUring(const IoUring&);
+    void operator=(const IoUring&);
+};
+
+static IoUring* toIoUring(JNIEnv* env, jlong ringAddress) {
+    IoUring* ring = cast<IoUring*>(ringAddress);
+    if (ring == NULL) {
+        jniThrowNullPointerException(env, NULL);
+    }
+    return ring;
+}
+
+static bool prepareRw(JNIEnv* env, jlong ringAddress, int opcode, jobject javaFd,
+        jlong address, jint byteCount, jlong offset, jlong userData) {
+    IoUring* ring = toIoUring(env, ringAddress);
+    if (ring == NULL) {
+        return false;
+    }
+    int fd = jniGetFDFromFileDescriptor(env, javaFd);
+    IoUringOp* op;
+    io_uring_sqe* sqe = ring->prepare(fd, userData, &op);
+    if (sqe == NULL) {
+        return false;
+    }
+    op->iov.iov_base = cast<void*>(address);
+    op->iov.iov_len = byteCount;
+    sqe->opcode = opcode;
+    sqe->addr = reinterpret_cast<uintptr_t>(&op->iov);
+    sqe->len = 1;
+    sqe->off = offset;
+    return true;
+}
+
+#endif  // HAVE_IO_URING
+
+static jboolean IoUring_isSupported(JNIEnv*, jclass) {
+#if defined(HAVE_IO_URING)
+    // A kernel without io_uring (or a seccomp policy that forbids it) fails with ENOSYS or EPERM.
+    static bool supported = (IoUring().init(1) == 0);
+    return supported;
+#else
+    return JNI_FALSE;
+#endif
+}
+
+static jlong IoUring_setup(JNIEnv* env, jclass, jint entries) {
+#if defined(HAVE_IO_URING)
+    UniquePtr<IoUring> ring(new IoUring);
+    int error = ring->init(entries);
+    if (error != 0) {
+        jniThrowErrnoException(env, "io_uring_setup", error);
+        return 0;
+    }
+    return static_cast<jlong>(reinterpret_cast<uintptr_t>(ring.release()));
+#else
+    jniThrowErrnoException(env, "io_uring_setup", ENOSYS);
+    return 0;
+#endif
+}
+
+static void IoUring_destroy(JNIEnv*, jclass, jlong ringAddress) {
+#if defined(HAVE_IO_URING)
+    delete cast<IoUring*>(ringAddress);
+#endif
+}
+
+static jboolean IoUring_prepareRead(JNIEnv* env, jclass, jlong ringAddress, jobject javaFd,
+        jlong address, jint byteCount, jlong offset, jlong userData) {
+#if defined(HAVE_IO_URING)
+    return prepareRw(env, ringAddress, IORING_OP_READV, javaFd, address, byteCount, offset, userData);
+#else
+    return JNI_FALSE;
+#endif
+}
+
+static jboolean IoUring_prepareWrite(JNIEnv* env, jclass, jlong ringAddress, jobject javaFd,
+        jlong address, jint byteCount, jlong offset, jlong userData) {
+#if defined(HAVE_IO_URING)
+    return prepareRw(env, ringAddress, IORING_OP_WRITEV, javaFd, address, byteCount, offset, userData);
+#else
+    return JNI_FALSE;
+#endif
+}
+
+static jboolean IoUring_prepareAccept(JNIEnv* env, jclass, jlong ringAddress, jobject javaFd,
+        jint flags, jlong userData) {
+#if defined(HAVE_IO_URING)
+    IoUring* ring = toIoUring(env, ringAddress);
+    if (ring == NULL) {
+        return JNI_FALSE;
+    }
+    int fd = jniGetFDFromFileDescriptor(env, javaFd);
+    io_uring_sqe* sqe = ring->prepare(fd, userData, NULL);
+    if (sqe == NULL) {
+        return JNI_FALSE;
+    }
+    sqe->opcode = IORING_OP_ACCEPT;
+    sqe->accept_flags = flags;
+    return JNI_TRUE;
+#else
+    return JNI_FALSE;
+#endif
+}
+
+static jboolean IoUring_prepareFsync(JNIEnv* env, jclass, jlong ringAddress, jobject javaFd,
+        jboolean dataOnly, jlong userData) {
+#if defined(HAVE_IO_URING)
+    IoUring* ring = toIoUring(env, ringAddress);
+    if (ring == NULL) {
+        return JNI_FALSE;
+    }
+    int fd = jniGetFDFromFileDescriptor(env, javaFd);
+    io_uring_sqe* sqe = ring->prepare(fd, userData, NULL);
+    if (sqe == NULL) {
+        return JNI_FALSE;
+    }
+    sqe->opcode = IORING_OP_FSYNC;
+    sqe->fsync_flags = dataOnly ? IORING_FSYNC_DATASYNC : 0;
+    return JNI_TRUE;
+#else
+    return JNI_FALSE;
+#endif
+}
+
+static jint IoUring_submit(JNIEnv* env, jclass, jlong ringAddress, jint minComplete) {
+#if defined(HAVE_IO_URING)
+    IoUring* ring = toIoUring(env, ringAddress);
+    if (ring == NULL) {
+        return -1;
+    }
+    int rc = ring->submit(minComplete);
+    if (rc == -1) {
+        if (errno == EINTR) {
+            jniThrowException(env, "java/io/InterruptedIOException", "io_uring_enter interrupted");
+        } else {
+            jniThrowErrnoException(env, "io_uring_enter", errno);
+        }
+    }
+    return rc;
+#else
+    jniThrowErrnoException(env, "io_uring_enter", ENOSYS);
+    return -1;
+#endif
+}
+
+static jint IoUring_reap(JNIEnv* env, jclass, jlong ringAddress, jlongArray javaUserData,
+        jintArray javaResults) {
+#if defined(HAVE_IO_URING)
+    IoUring* ring = toIoUring(env, ringAddress);
+    if (ring == NULL) {
+        return -1;
+    }
+    ScopedLongArrayRW userData(env, javaUserData);
+    if (userData.get() == NULL) {
+        return -1;
+    }
+    ScopedIntArrayRW results(env, javaResults);
+    if (results.get() == NULL) {
+        return -1;
+    }
+    size_t capacity = std::min(userData.size(), results.size());
+    return ring->reap(userData.get(), results.get(), capacity);
+#else
+    return 0;
+#endif
+}
+
+static JNINativeMethod gMethods[] = {
+    NATIVE_METHOD(IoUring, destroy, "(J)V"),
+    NATIVE_METHOD(IoUring, isSupported, "()Z"),
+    NATIVE_METHOD(IoUring, prepareAccept, "(JLjava/io/FileDescriptor;IJ)Z"),
+    NATIVE_METHOD(IoUring, prepareFsync, "(JLjava/io/FileDescriptor;ZJ)Z"),
+    NATIVE_METHOD(IoUring, prepareRead, "(JLjava/io/FileDescriptor;JIJJ)Z"),
+    NATIVE_METHOD(IoUring, prepareWrite, "(JLjava/io/FileDescriptor;JIJJ)Z"),
+    NATIVE_METHOD(IoUring, reap, "(J[J[I)I"),
+    NATIVE_METHOD(IoUring, setup, "(I)J"),
+    NATIVE_METHOD(IoUring, submit, "(JI)I"),
+};
+void register_libcore_io_IoUring(JNIEnv* env) {
+    jniRegisterNativeMethods(env, "libcore/io/IoUring", gMethods, NELEM(gMethods));
+}
@@ -18,19 +18,32 @@
 
 #include "JNIHelp.h"
 #include "JniConstants.h"
+#include "MemoryIntrinsics.h"
 #include "Portability.h"
 #include "ScopedBytes.h"
 #include "ScopedPrimitiveArray.h"
 #include "UniquePtr.h"
 
 #include <errno.h>
+#include <pthread.h>
 #include <stdlib.h>
 #include <string.h>
 
+#include <algorithm>
+#include <vector>
+
 #ifdef HAVE_SYS_MMAN
 #include <sys/mman.h>
 #endif
 
+#if defined(__aarch64__) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define SIMD_SWAP_NEON
+#elif defined(__i386__) || defined(__x86_64__)
+#include <tmmintrin.h>
+#define SIMD_SWAP_SSSE3
+#endif
+
 #if defined(__arm__)
 // 32-bit ARM has load/store alignment restrictions for longs.
 #define LONG_ALIGNMENT_MASK 0x3
@@ -69,6 +82,60 @@ template <typename T> static T cast(jlong address) {
     return reinterpret_cast<T>(static_cast<uintptr_t>(address));
 }
 
+// Byte-swaps as many whole 16-byte blocks of 'elementSize'-byte elements as possible with one
+// shuffle per block, returning the number of elements swapped. The scalar loops below finish
+// off the rest. Loads and stores are unaligned, and a whole number of blocks leaves the
+// remaining elements with the same alignment they started with.
+#if defined(SIMD_SWAP_NEON)
+static size_t swapBlocks(void* dst, const void* src, size_t count, size_t elementSize) {
+    const size_t blockCount = (count * elementSize) / 16;
+    uint8_t* d = reinterpret_cast<uint8_t*>(dst);
+    const uint8_t* s = reinterpret_cast<const uint8_t*>(src);
+    for (size_t i = 0; i < blockCount; ++i, d += 16, s += 16) {
+        uint8x16_t v = vld1q_u8(s);
+        if (elementSize == 2) {
+            v = vrev16q_u8(v);
+        } else if (elementSize == 4) {
+            v = vrev32q_u8(v);
+        } else {
+            v = vrev64q_u8(v);
+        }
+        vst1q_u8(d, v);
+    }
+    return blockCount * 16 / elementSize;
+}
+#elif defined(SIMD_SWAP_SSSE3)
+// pshufb is SSSE3, which not every x86 CPU we run on has, so we check at registration time.
+static bool gHaveSsse3 = false;
+
+__attribute__((target("ssse3")))
+static size_t swapBlocksSsse3(void* dst, const void* src, size_t count, size_t elementSize) {
+    __m128i mask;
+    if (elementSize == 2) {
+        mask = _mm_setr_epi8(1, 0, 3, 2, 5, 4, 7, 6, 9, 8, 11, 10, 13, 12, 15, 14);
+    } else if (elementSize == 4) {
+        mask = _mm_setr_epi8(3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12);
+    } else {
+        mask = _mm_setr_epi8(7, 6, 5, 4, 3, 2, 1, 0, 15, 14, 13, 12, 11, 10, 9, 8);
+    }
+    const size_t blockCount = (count * elementSize) / 16;
+    __m128i* d = reinterpret_cast<__m128i*>(dst);
+    const __m128i* s = reinterpret_cast<const __m128i*>(src);
+    for (size_t i = 0; i < blockCount; ++i) {
+        _mm_storeu_si128(d++, _mm_shuffle_epi8(_mm_loadu_si128(s++), mask));
+    }
+    return blockCount * 16 / elementSize;
+}
+
+static inline size_t swapBlocks(void* dst, const void* src, size_t count, size_t elementSize) {
+    return gHaveSsse3 ? swapBlocksSsse3(dst, src, count, elementSize) : 0;
+}
+#else
+static inline size_t swapBlocks(void*, const void*, size_t, size_t) {
+    return 0;
+}
+#endif
+
 // Byte-swap 2 jshort values packed in a jint.
 static inline jint bswap_2x16(jint v) {
     // v is initially ABCD
@@ -82,6 +149,11 @@ static inline jint bswap_2x16(jint v) {
 }
 
 static inline void swapShorts(jshort* dstShorts, const jshort* srcShorts, size_t count) {
+    size_t swapped = swapBlocks(dstShorts, srcShorts, count, sizeof(jshort));
+    dstShorts += swapped;
+    srcShorts += swapped;
+    count -= swapped;
+
     // Do 32-bit swaps as long as possible...
     jint* dst = reinterpret_cast<jint*>(dstShorts);
     const jint* src = reinterpret_cast<const jint*>(srcShorts);
@@ -110,6 +182,11 @@ static inline void swapShorts(jshort* dstShorts, const jshort* srcShorts, size_t
 }
 
 static inline void swapInts(jint* dstInts, const jint* srcInts, size_t count) {
+    size_t swapped = swapBlocks(dstInts, srcInts, count, sizeof(jint));
+    dstInts += swapped;
+    srcInts += swapped;
+    count -= swapped;
+
     if ((reinterpret_cast<uintptr_t>(dstInts) & INT_ALIGNMENT_MASK) == 0 &&
         (reinterpret_cast<uintptr_t>(srcInts) & INT_ALIGNMENT_MASK) == 0) {
         for (size_t i = 0; i < count; ++i) {
@@ -125,6 +202,11 @@ static inline void swapInts(jint* dstInts, const jint* srcInts, size_t count) {
 }
 
 static inline void swapLongs(jlong* dstLongs, const jlong* srcLongs, size_t count) {
+    size_t swapped = swapBlocks(dstLongs, srcLongs, count, sizeof(jlong));
+    dstLongs += swapped;
+    srcLongs += swapped;
+    count -= swapped;
+
     jint* dst = reinterpret_cast<jint*>(dstLongs);
     const jint* src = reinterpret_cast<const jint*>(srcLongs);
     if ((reinterpret_cast<uintptr_t>(dstLongs) & INT_ALIGNMENT_MASK) == 0 &&
@@ -145,6 +227,155 @@ static inline void swapLongs(jlong* dstLongs, const jlong* srcLongs, size_t coun
     }
 }
 
+// Copies of at most this many bytes are done inline: they're most of the copies ByteBuffer makes,
+// and at this size the call to memmove is a large part of the cost.
+static const size_t INLINE_COPY_MAX = 32;
+// Copies of at least this many bytes, which is about the size of a last-level cache, bypass the
+// cache with non-temporal stores where we have them. (Bionic's memmove doesn't.) Otherwise a
+// single huge copy would evict everything else, only to be evicted itself before it's read.
+static const size_t NON_TEMPORAL_COPY_MIN = 4 * 1024 * 1024;
+// A parallel copy gives each thread at least this many bytes.
+static const size_t PARALLEL_COPY_CHUNK_MIN = 16 * 1024 * 1024;
+// The most threads that a huge copy between direct buffers may use. Set by
+// Memory.setMaxCopyThreads; 1 (the default) keeps every copy on the calling thread.
+static int gMaxCopyThreads = 1;
+
+// Loads every byte before storing any, so overlapping copies need no special care.
+static inline void inlineMemmove(jbyte* dst, const jbyte* src, size_t length) {
+    if (length >= 16) {
+        uint64_t a, b, c, d;
+        memcpy(&a, src, 8);
+        memcpy(&b, src + 8, 8);
+        memcpy(&c, src + length - 16, 8);
+        memcpy(&d, src + length - 8, 8);
+        memcpy(dst, &a, 8);
+        memcpy(dst + 8, &b, 8);
+        memcpy(dst + length - 16, &c, 8);
+        memcpy(dst + length - 8, &d, 8);
+    } else if (length >= 8) {
+        uint64_t a, b;
+        memcpy(&a, src, 8);
+        memcpy(&b, src + length - 8, 8);
+        memcpy(dst, &a, 8);
+        memcpy(dst + length - 8, &b, 8);
+    } else if (length >= 4) {
+        uint32_t a, b;
+        memcpy(&a, src, 4);
+        memcpy(&b, src + length - 4, 4);
+        memcpy(dst, &a, 4);
+        memcpy(dst + length - 4, &b, 4);
+    } else if (length > 0) {
+        jbyte a = src[0];
+        jbyte b = src[length / 2];
+        jbyte c = src[length - 1];
+        dst[0] = a;
+        dst[length / 2] = b;
+        dst[length - 1] = c;
+    }
+}
+
+#if defined(__i386__) || defined(__x86_64__)
+// Copies non-overlapping memory with streaming stores, a whole cache line at a time.
+__attribute__((target("sse2")))
+static void nonTemporalCopy(jbyte* dst, const jbyte* src, size_t length) {
+    size_t head = (64 - (reinterpret_cast<uintptr_t>(dst) & 63)) & 63;
+    if (head > length) {
+        head = length;
+    }
+    memcpy(dst, src, head);
+    dst += head;
+    src += head;
+    length -= head;
+    __m128i* d = reinterpret_cast<__m128i*>(dst);
+    const __m128i* s = reinterpret_cast<const __m128i*>(src);
+    for (; length >= 64; length -= 64, d += 4, s += 4) {
+        __m128i v0 = _mm_loadu_si128(s);
+        __m128i v1 = _mm_loadu_si128(s + 1);
+        __m128i v2 = _mm_loadu_si128(s + 2);
+        __m128i v3 = _mm_loadu_si128(s + 3);
+        _mm_stream_si128(d, v0);
+        _mm_stream_si128(d + 1, v1);
+        _mm_stream_si128(d + 2, v2);
+        _mm_stream_si128(d + 3, v3);
+    }
+    // Streaming stores are weakly ordered, so make them visible before anything that follows.
+    _mm_sfence();
+    memcpy(d, s, length);
+}
+#else
+static inline void nonTemporalCopy(jbyte* dst, const jbyte* src, size_t length) {
+    memcpy(dst, src, length);
+}
+#endif
+
+struct CopyChunk {
+    jbyte* dst;
+    const jbyte* src;
+    size_t length;
+};
+
+static void* copyChunk(void* arg) {
+    CopyChunk* chunk = reinterpret_cast<CopyChunk*>(arg);
+    nonTemporalCopy(chunk->dst, chunk->src, chunk->length);
+    return NULL;
+}
+
+// Splits a huge non-overlapping copy between up to gMaxCopyThreads threads, including the
+// calling one, which also takes over any chunk whose thread couldn't be started.
+static void parallelCopy(jbyte* dst, const jbyte* src, size_t length) {
+    size_t threadCount = std::min(static_cast<size_t>(__atomic_load_n(&gMaxCopyThreads,
+            __ATOMIC_RELAXED)), length / PARALLEL_COPY_CHUNK_MIN);
+    if (threadCount <= 1) {
+        nonTemporalCopy(dst, src, length);
+        return;
+    }
+    std::vector<CopyChunk> chunks(threadCount);
+    size_t begin = 0;
+    for (size_t i = 0; i < threadCount; ++i) {
+        // Chunks start on cache line boundaries, so no two threads write the same line.
+        size_t end = (i + 1 == threadCount) ? length : (length / threadCount * (i + 1)) & ~63;
+        chunks[i].dst = dst + begin;
+        chunks[i].src = src + begin;
+        chunks[i].length = end - begin;
+        begin = end;
+    }
+    std::vector<pthread_t> threads(threadCount);
+    std::vector<bool> started(threadCount, false);
+    for (size_t i = 1; i < threadCount; ++i) {
+        started[i] = (pthread_create(&threads[i], NULL, copyChunk, &chunks[i]) == 0);
+    }
+    for (size_t i = 0; i < threadCount; ++i) {
+        if (!started[i]) {
+            copyChunk(&chunks[i]);
+        }
+    }
+    for (size_t i = 1; i < threadCount; ++i) {
+        if (started[i]) {
+            pthread_join(threads[i], NULL);
+        }
+    }
+}
+
+// Copies like memmove, choosing how by size: inline for small copies, memmove for everything
+// up to about the size of the cache, and non-temporal stores beyond that, split across threads
+// if 'allowThreads' (which callers only set for direct memory) and setMaxCopyThreads allow.
+static void tieredMemmove(jbyte* dst, const jbyte* src, size_t length, bool allowThreads) {
+    if (length <= INLINE_COPY_MAX) {
+        inlineMemmove(dst, src, length);
+        return;
+    }
+    uintptr_t d = reinterpret_cast<uintptr_t>(dst);
+    uintptr_t s = reinterpret_cast<uintptr_t>(src);
+    bool overlapping = (d < s + length) && (s < d + length);
+    if (length < NON_TEMPORAL_COPY_MIN || overlapping) {
+        memmove(dst, src, length);
+    } else if (allowThreads) {
+        parallelCopy(dst, src, length);
+    } else {
+        nonTemporalCopy(dst, src, length);
+    }
+}
+
 static void Memory_memmove(JNIEnv* env, jclass, jobject dstObject, jint dstOffset, jobject srcObject, jint srcOffset, jlong length) {
     ScopedBytesRW dstBytes(env, dstObject);
     if (dstBytes.get() == NULL) {
@@ -154,7 +385,13 @@ static void Memory_memmove(JNIEnv* env, jclass, jobject dstObject, jint dstOffse
     if (srcBytes.get() == NULL) {
         return;
     }
-    memmove(dstBytes.get() + dstOffset, srcBytes.get() + srcOffset, length);
+    // Only direct buffers may be copied by other threads: a pinned array may really be a copy
+    // that the VM expects only this thread to touch. Don't spend JNI calls finding out unless
+    // the copy is big enough to matter.
+    bool allowThreads = static_cast<size_t>(length) >= 2 * PARALLEL_COPY_CHUNK_MIN &&
+            !env->IsInstanceOf(dstObject, JniConstants::byteArrayClass) &&
+            !env->IsInstanceOf(srcObject, JniConstants::byteArrayClass);
+    tieredMemmove(dstBytes.get() + dstOffset, srcBytes.get() + srcOffset, length, allowThreads);
 }
 
 static jbyte Memory_peekByte(JNIEnv*, jclass, jlong srcAddress) {
@@ -262,20 +499,40 @@ static void Memory_pokeShortArray(JNIEnv* env, jclass, jlong dstAddress, jshortA
     POKER(jshort, Short, jshort, swapShorts);
 }
 
+// The single-access natives below are the LIBCORE_IO_MEMORY_INTRINSICS. They must not use
+// their JNIEnv, since they're registered as fast natives and a VM may inline them.
 static jshort Memory_peekShortNative(JNIEnv*, jclass, jlong srcAddress) {
-    return *cast<const jshort*>(srcAddress);
+    const jshort* src = cast<const jshort*>(srcAddress);
+    if ((srcAddress & SHORT_ALIGNMENT_MASK) == 0) {
+        return *src;
+    }
+    return get_unaligned<jshort>(src);
 }
 
 static void Memory_pokeShortNative(JNIEnv*, jclass, jlong dstAddress, jshort value) {
-    *cast<jshort*>(dstAddress) = value;
+    jshort* dst = cast<jshort*>(dstAddress);
+    if ((dstAddress & SHORT_ALIGNMENT_MASK) == 0) {
+        *dst = value;
+    } else {
+        put_unaligned<jshort>(dst, value);
+    }
 }
 
 static jint Memory_peekIntNative(JNIEnv*, jclass, jlong srcAddress) {
-    return *cast<const jint*>(srcAddress);
+    const jint* src = cast<const jint*>(srcAddress);
+    if ((srcAddress & INT_ALIGNMENT_MASK) == 0) {
+        return *src;
+    }
+    return get_unaligned<jint>(src);
 }
 
 static void Memory_pokeIntNative(JNIEnv*, jclass, jlong dstAddress, jint value) {
-    *cast<jint*>(dstAddress) = value;
+    jint* dst = cast<jint*>(dstAddress);
+    if ((dstAddress & INT_ALIGNMENT_MASK) == 0) {
+        *dst = value;
+    } else {
+        put_unaligned<jint>(dst, value);
+    }
 }
 
 static jlong Memory_peekLongNative(JNIEnv*, jclass, jlong srcAddress) {
@@ -320,6 +577,10 @@ static void unsafeBulkCopy(jbyte* dst, const jbyte* src, jint byteCount,
     }
 }
 
+static void Memory_setMaxCopyThreadsImpl(JNIEnv*, jclass, jint count) {
+    __atomic_store_n(&gMaxCopyThreads, count, __ATOMIC_RELAXED);
+}
+
 static void Memory_unsafeBulkGet(JNIEnv* env, jclass, jobject dstObject, jint dstOffset,
         jint byteCount, jbyteArray srcArray, jint srcOffset, jint sizeofElement, jboolean swap) {
     ScopedByteArrayRO srcBytes(env, srcArray);
@@ -354,33 +615,142 @@ static void Memory_unsafeBulkPut(JNIEnv* env, jclass, jbyteArray dstArray, jint
     env->ReleasePrimitiveArrayCritical(srcArray, srcBytes, 0);
 }
 
+// Copies 'count' elements of 'sizeofElement' bytes from 'srcStride'-byte intervals in 'src'
+// to 'dstStride'-byte intervals in 'dst', optionally swapping each. Runs of adjacent elements
+// on both sides go through unsafeBulkCopy; anything else goes an element at a time.
+static void stridedCopy(jbyte* dst, jint dstStride, const jbyte* src, jint srcStride,
+        jint count, jint sizeofElement, jboolean swap) {
+    if (dstStride == sizeofElement && srcStride == sizeofElement) {
+        unsafeBulkCopy(dst, src, count * sizeofElement, sizeofElement, swap);
+        return;
+    }
+    if (!swap || sizeofElement == 1) {
+        for (jint i = 0; i < count; ++i, dst += dstStride, src += srcStride) {
+            memcpy(dst, src, sizeofElement);
+        }
+    } else if (sizeofElement == 2) {
+        for (jint i = 0; i < count; ++i, dst += dstStride, src += srcStride) {
+            jshort v = get_unaligned<jshort>(reinterpret_cast<const jshort*>(src));
+            put_unaligned<jshort>(reinterpret_cast<jshort*>(dst), bswap_16(v));
+        }
+    } else if (sizeofElement == 4) {
+        for (jint i = 0; i < count; ++i, dst += dstStride, src += srcStride) {
+            jint v = get_unaligned<jint>(reinterpret_cast<const jint*>(src));
+            put_unaligned<jint>(reinterpret_cast<jint*>(dst), bswap_32(v));
+        }
+    } else if (sizeofElement == 8) {
+        for (jint i = 0; i < count; ++i, dst += dstStride, src += srcStride) {
+            jlong v = get_unaligned<jlong>(reinterpret_cast<const jlong*>(src));
+            put_unaligned<jlong>(reinterpret_cast<jlong*>(dst), bswap_64(v));
+        }
+    }
+}
+
+static void Memory_unsafeStridedGet(JNIEnv* env, jclass, jobject dstObject, jint dstOffset,
+        jint count, jbyteArray srcArray, jint srcOffset, jint srcStride, jint sizeofElement,
+        jboolean swap) {
+    ScopedByteArrayRO srcBytes(env, srcArray);
+    if (srcBytes.get() == NULL) {
+        return;
+    }
+    jarray dstArray = reinterpret_cast<jarray>(dstObject);
+    jbyte* dstBytes = reinterpret_cast<jbyte*>(env->GetPrimitiveArrayCritical(dstArray, NULL));
+    if (dstBytes == NULL) {
+        return;
+    }
+    jbyte* dst = dstBytes + dstOffset*sizeofElement;
+    const jbyte* src = srcBytes.get() + srcOffset;
+    stridedCopy(dst, sizeofElement, src, srcStride, count, sizeofElement, swap);
+    env->ReleasePrimitiveArrayCritical(dstArray, dstBytes, 0);
+}
+
+static void Memory_unsafeStridedPut(JNIEnv* env, jclass, jbyteArray dstArray, jint dstOffset,
+        jint dstStride, jint count, jobject srcObject, jint srcOffset, jint sizeofElement,
+        jboolean swap) {
+    ScopedByteArrayRW dstBytes(env, dstArray);
+    if (dstBytes.get() == NULL) {
+        return;
+    }
+    jarray srcArray = reinterpret_cast<jarray>(srcObject);
+    jbyte* srcBytes = reinterpret_cast<jbyte*>(env->GetPrimitiveArrayCritical(srcArray, NULL));
+    if (srcBytes == NULL) {
+        return;
+    }
+    jbyte* dst = dstBytes.get() + dstOffset;
+    const jbyte* src = srcBytes + srcOffset*sizeofElement;
+    stridedCopy(dst, dstStride, src, sizeofElement, count, sizeofElement, swap);
+    env->ReleasePrimitiveArrayCritical(srcArray, srcBytes, JNI_ABORT);
+}
+
+static void Memory_peekStrided(JNIEnv* env, jclass, jlong srcAddress, jint srcStride,
+        jobject dstObject, jint dstOffset, jint count, jint sizeofElement, jboolean swap) {
+    jarray dstArray = reinterpret_cast<jarray>(dstObject);
+    jbyte* dstBytes = reinterpret_cast<jbyte*>(env->GetPrimitiveArrayCritical(dstArray, NULL));
+    if (dstBytes == NULL) {
+        return;
+    }
+    stridedCopy(dstBytes + dstOffset*sizeofElement, sizeofElement, cast<const jbyte*>(srcAddress),
+            srcStride, count, sizeofElement, swap);
+    env->ReleasePrimitiveArrayCritical(dstArray, dstBytes, 0);
+}
+
+static void Memory_pokeStrided(JNIEnv* env, jclass, jlong dstAddress, jint dstStride,
+        jobject srcObject, jint srcOffset, jint count, jint sizeofElement, jboolean swap) {
+    jarray srcArray = reinterpret_cast<jarray>(srcObject);
+    jbyte* srcBytes = reinterpret_cast<jbyte*>(env->GetPrimitiveArrayCritical(srcArray, NULL));
+    if (srcBytes == NULL) {
+        return;
+    }
+    stridedCopy(cast<jbyte*>(dstAddress), dstStride, srcBytes + srcOffset*sizeofElement,
+            sizeofElement, count, sizeofElement, swap);
+    env->ReleasePrimitiveArrayCritical(srcArray, srcBytes, JNI_ABORT);
+}
+
+static void Memory_copyNative(JNIEnv*, jclass, jlong dstAddress, jint dstStride,
+        jlong srcAddress, jint srcStride, jint count, jint sizeofElement, jboolean swap) {
+    jbyte* dst = cast<jbyte*>(dstAddress);
+    const jbyte* src = cast<const jbyte*>(srcAddress);
+    if (!swap && dstStride == sizeofElement && srcStride == sizeofElement) {
+        // The one case where we can cope with overlap.
+        tieredMemmove(dst, src, static_cast<size_t>(count) * sizeofElement, true);
+        return;
+    }
+    stridedCopy(dst, dstStride, src, srcStride, count, sizeofElement, swap);
+}
+
+#define MEMORY_INTRINSIC_METHOD(name, signature, accessType, isStore) \
+    NATIVE_METHOD(Memory, name, "!" signature),
+
 static JNINativeMethod gMethods[] = {
+    LIBCORE_IO_MEMORY_INTRINSICS(MEMORY_INTRINSIC_METHOD)
+    NATIVE_METHOD(Memory, copyNative, "(JIJIIIZ)V"),
     NATIVE_METHOD(Memory, memmove, "(Ljava/lang/Object;ILjava/lang/Object;IJ)V"),
-    NATIVE_METHOD(Memory, peekByte, "!(J)B"),
     NATIVE_METHOD(Memory, peekByteArray, "(J[BII)V"),
     NATIVE_METHOD(Memory, peekCharArray, "(J[CIIZ)V"),
     NATIVE_METHOD(Memory, peekDoubleArray, "(J[DIIZ)V"),
     NATIVE_METHOD(Memory, peekFloatArray, "(J[FIIZ)V"),
-    NATIVE_METHOD(Memory, peekIntNative, "!(J)I"),
     NATIVE_METHOD(Memory, peekIntArray, "(J[IIIZ)V"),
-    NATIVE_METHOD(Memory, peekLongNative, "!(J)J"),
     NATIVE_METHOD(Memory, peekLongArray, "(J[JIIZ)V"),
-    NATIVE_METHOD(Memory, peekShortNative, "!(J)S"),
     NATIVE_METHOD(Memory, peekShortArray, "(J[SIIZ)V"),
-    NATIVE_METHOD(Memory, pokeByte, "!(JB)V"),
+    NATIVE_METHOD(Memory, peekStrided, "(JILjava/lang/Object;IIIZ)V"),
     NATIVE_METHOD(Memory, pokeByteArray, "(J[BII)V"),
     NATIVE_METHOD(Memory, pokeCharArray, "(J[CIIZ)V"),
     NATIVE_METHOD(Memory, pokeDoubleArray, "(J[DIIZ)V"),
     NATIVE_METHOD(Memory, pokeFloatArray, "(J[FIIZ)V"),
-    NATIVE_METHOD(Memory, pokeIntNative, "!(JI)V"),
     NATIVE_METHOD(Memory, pokeIntArray, "(J[IIIZ)V"),
-    NATIVE_METHOD(Memory, pokeLongNative, "!(JJ)V"),
     NATIVE_METHOD(Memory, pokeLongArray, "(J[JIIZ)V"),
-    NATIVE_METHOD(Memory, pokeShortNative, "!(JS)V"),
     NATIVE_METHOD(Memory, pokeShortArray, "(J[SIIZ)V"),
+    NATIVE_METHOD(Memory, pokeStrided, "(JILjava/lang/Object;IIIZ)V"),
+    NATIVE_METHOD(Memory, setMaxCopyThreadsImpl, "(I)V"),
     NATIVE_METHOD(Memory, unsafeBulkGet, "(Ljava/lang/Object;II[BIIZ)V"),
     NATIVE_METHOD(Memory, unsafeBulkPut, "([BIILjava/lang/Object;IIZ)V"),
+    NATIVE_METHOD(Memory, unsafeStridedGet, "(Ljava/lang/Object;II[BIIIZ)V"),
+    NATIVE_METHOD(Memory, unsafeStridedPut, "([BIIILjava/lang/Object;IIZ)V"),
 };
 void register_libcore_io_Memory(JNIEnv* env) {
+#if defined(SIMD_SWAP_SSSE3)
+    __builtin_cpu_init();
+    gHaveSsse3 = __builtin_cpu_supports("ssse3");
+#endif
     jniRegisterNativeMethods(env, "libcore/io/Memory", gMethods, NELEM(gMethods));
 }
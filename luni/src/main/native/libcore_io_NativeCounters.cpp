@@ -0,0 +1,94 @@
+/*
+ * Copyright (C) 2014 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#define LOG_TAG "NativeCounters"
+
+#include "JNIHelp.h"
+#include "JniConstants.h"
+#include "NativeCounters.h"
+#include "ScopedLocalRef.h"
+#include "jni.h"
+
+#include <algorithm>
+#include <vector>
+
+static jboolean NativeCounters_isEnabled(JNIEnv*, jclass) {
+#if defined(LIBCORE_NATIVE_COUNTERS)
+    return JNI_TRUE;
+#else
+    return JNI_FALSE;
+#endif
+}
+
+static jobjectArray NativeCounters_names(JNIEnv* env, jclass) {
+#if defined(LIBCORE_NATIVE_COUNTERS)
+    int count = nativeCounterCount();
+#else
+    int count = 0;
+#endif
+    jobjectArray result = env->NewObjectArray(count, JniConstants::stringClass, NULL);
+    if (result == NULL) {
+        return NULL;
+    }
+#if defined(LIBCORE_NATIVE_COUNTERS)
+    for (int i = 0; i < count; ++i) {
+        ScopedLocalRef<jstring> name(env, env->NewStringUTF(nativeCounterName(i)));
+        if (name.get() == NULL) {
+            return NULL;
+        }
+        env->SetObjectArrayElement(result, i, name.get());
+    }
+#endif
+    return result;
+}
+
+// Returns the counters for the first 'count' names, each as its calls, bytes and nanoseconds
+// followed by its histogram.
+static jlongArray NativeCounters_snapshot(JNIEnv* env, jclass, jint count) {
+    const int stride = 3 + NATIVE_COUNTER_HISTOGRAM_BUCKETS;
+    jlongArray result = env->NewLongArray(count * stride);
+    if (result == NULL) {
+        return NULL;
+    }
+#if defined(LIBCORE_NATIVE_COUNTERS)
+    count = std::min(count, nativeCounterCount());
+    if (count <= 0) {
+        return result;
+    }
+    std::vector<NativeCounterTotals> totals(count);
+    sumNativeCounters(&totals[0], count);
+    std::vector<jlong> values;
+    values.reserve(count * stride);
+    for (int i = 0; i < count; ++i) {
+        values.push_back(totals[i].calls);
+        values.push_back(totals[i].bytes);
+        values.push_back(totals[i].nanos);
+        values.insert(values.end(), totals[i].histogram,
+                      totals[i].histogram + NATIVE_COUNTER_HISTOGRAM_BUCKETS);
+    }
+    env->SetLongArrayRegion(result, 0, values.size(), &values[0]);
+#endif
+    return result;
+}
+
+static JNINativeMethod gMethods[] = {
+    NATIVE_METHOD(NativeCounters, isEnabled, "()Z"),
+    NATIVE_METHOD(NativeCounters, names, "()[Ljava/lang/String;"),
+    NATIVE_METHOD(NativeCounters, snapshot, "(I)[J"),
+};
+void register_libcore_io_NativeCounters(JNIEnv* env) {
+    jniRegisterNativeMethods(env, "libcore/io/NativeCounters", gMethods, NELEM(gMethods));
+}
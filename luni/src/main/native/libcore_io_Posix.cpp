@@ -22,13 +22,16 @@
 #include "JNIHelp.h"
 #include "JniConstants.h"
 #include "JniException.h"
+#include "NativeCounters.h"
 #include "NetworkUtilities.h"
 #include "Portability.h"
 #include "readlink.h"
 #include "ScopedBytes.h"
 #include "ScopedLocalRef.h"
+#include "ScopedPthreadMutexLock.h"
 #include "ScopedPrimitiveArray.h"
 #include "ScopedUtfChars.h"
+#include "ScratchArena.h"
 #include "toStringArray.h"
 #include "UniquePtr.h"
 
@@ -68,19 +71,35 @@
 
 #include <errno.h>
 #include <fcntl.h>
+#include <limits.h>
 #include <signal.h>
 #include <stdlib.h>
+#include <string.h>
 #include <sys/stat.h>
 #include <sys/time.h>
 #include <sys/types.h>
 #include <unistd.h>
 
+#include <algorithm>
+#include <new>
+#include <type_traits>
+#include <vector>
+
 #include "unicode-defines.h"
 
 #ifndef __unused
 #define __unused __attribute__((__unused__))
 #endif
 
+#if defined(__MINGW32__) || defined(__MINGW64__)
+// Stream I/O on a file must not interleave with pread64/pwrite64, which borrow its file pointer,
+// so go through the wrappers that take the same lock. (IO_FAILURE_RETRY still reports errors
+// under the plain names.)
+#define read mingw_read
+#define write mingw_write
+#define lseek64 mingw_lseek64
+#endif
+
 #define TO_JAVA_STRING(NAME, EXP) \
         jstring NAME = env->NewStringUTF(EXP); \
         if (NAME == NULL) return NULL;
@@ -198,6 +217,121 @@ struct addrinfo_deleter {
     _rc; })
 #endif
 
+/**
+ * Like IO_FAILURE_RETRY, but for the "errno-returning" natives: a failing system call returns
+ * -errno rather than throwing an ErrnoException, so that callers expecting EAGAIN or EINPROGRESS
+ * don't allocate an exception each time. A closed file descriptor is reported as -EBADF. Being
+ * signaled via AsynchronousCloseMonitor still throws, returning -1 with the exception pending.
+ */
+#if !defined(__MINGW32__) && !defined(__MINGW64__)
+#define IO_ERRNO_RETRY(jni_env, return_type, syscall_name, java_fd, ...) ({ \
+    return_type _rc = -EBADF; \
+    int _fd = jniGetFDFromFileDescriptor(jni_env, java_fd); \
+    while (_fd != -1) { \
+        bool _wasSignaled; \
+        int _syscallErrno; \
+        { \
+            AsynchronousCloseMonitor _monitor(_fd); \
+            _rc = syscall_name(_fd, __VA_ARGS__); \
+            _syscallErrno = errno; \
+            _wasSignaled = _monitor.wasSignaled(); \
+        } \
+        if (_wasSignaled) { \
+            jniThrowException(jni_env, "java/io/InterruptedIOException", # syscall_name " interrupted"); \
+            _rc = -1; \
+            break; \
+        } \
+        if (_rc != -1) { \
+            break; \
+        } \
+        if (_syscallErrno != EINTR) { \
+            _rc = -_syscallErrno; \
+            break; \
+        } \
+    } \
+    _rc; })
+#else
+#define IO_ERRNO_RETRY(jni_env, return_type, syscall_name, java_fd, ...) ({ \
+    return_type _rc; \
+    { \
+        SOCKET _fd = jniGetFDFromFileDescriptor(jni_env, java_fd); \
+        AsynchronousCloseMonitor _monitor(_fd); \
+        _rc = syscall_name(_fd, __VA_ARGS__); \
+    } \
+    if (_rc == SOCKET_ERROR || _rc == INVALID_SOCKET) { \
+        _rc = -windowsErrorToErrno(WSAGetLastError()); \
+    } \
+    _rc; })
+#endif
+
+/**
+ * JNI IDs used on Posix's hot paths, looked up once by register_libcore_io_Posix rather than
+ * behind a function-local static's initialization guard on every call.
+ */
+static struct {
+    jmethodID errnoExceptionCtor2;
+    jmethodID errnoExceptionCtor3;
+    jmethodID errnoExceptionSharedCtor;
+    jmethodID gaiExceptionCtor2;
+    jmethodID gaiExceptionCtor3;
+    jmethodID inetSocketAddressCtor;
+    jfieldID inetSocketAddressAddrFid;
+    jfieldID inetSocketAddressPortFid;
+    jfieldID mutableIntValueFid;
+    jfieldID mutableLongValueFid;
+    jmethodID structLingerCtor;
+    jmethodID structPasswdCtor;
+    jfieldID structPollfdEventsFid;
+    jfieldID structPollfdFdFid;
+    jfieldID structPollfdReventsFid;
+    jmethodID structStatCtor;
+    jmethodID structStatVfsCtor;
+    jmethodID structTimevalCtor;
+    jmethodID structUcredCtor;
+    jmethodID structUtsnameCtor;
+} gPosixIds;
+
+static void initPosixIds(JNIEnv* env) {
+    gPosixIds.errnoExceptionCtor2 = env->GetMethodID(JniConstants::errnoExceptionClass,
+            "<init>", "(Ljava/lang/String;I)V");
+    gPosixIds.errnoExceptionCtor3 = env->GetMethodID(JniConstants::errnoExceptionClass,
+            "<init>", "(Ljava/lang/String;ILjava/lang/Throwable;)V");
+    gPosixIds.errnoExceptionSharedCtor = env->GetMethodID(JniConstants::errnoExceptionClass,
+            "<init>", "(Ljava/lang/String;IZ)V");
+    gPosixIds.gaiExceptionCtor2 = env->GetMethodID(JniConstants::gaiExceptionClass,
+            "<init>", "(Ljava/lang/String;I)V");
+    gPosixIds.gaiExceptionCtor3 = env->GetMethodID(JniConstants::gaiExceptionClass,
+            "<init>", "(Ljava/lang/String;ILjava/lang/Throwable;)V");
+    gPosixIds.inetSocketAddressCtor = env->GetMethodID(JniConstants::inetSocketAddressClass,
+            "<init>", "(Ljava/net/InetAddress;I)V");
+    gPosixIds.inetSocketAddressAddrFid = env->GetFieldID(JniConstants::inetSocketAddressClass,
+            "addr", "Ljava/net/InetAddress;");
+    gPosixIds.inetSocketAddressPortFid = env->GetFieldID(JniConstants::inetSocketAddressClass,
+            "port", "I");
+    gPosixIds.mutableIntValueFid = env->GetFieldID(JniConstants::mutableIntClass, "value", "I");
+    gPosixIds.mutableLongValueFid = env->GetFieldID(JniConstants::mutableLongClass, "value", "J");
+    gPosixIds.structLingerCtor = env->GetMethodID(JniConstants::structLingerClass,
+            "<init>", "(II)V");
+    gPosixIds.structPasswdCtor = env->GetMethodID(JniConstants::structPasswdClass,
+            "<init>", "(Ljava/lang/String;IILjava/lang/String;Ljava/lang/String;)V");
+    gPosixIds.structPollfdEventsFid = env->GetFieldID(JniConstants::structPollfdClass,
+            "events", "S");
+    gPosixIds.structPollfdFdFid = env->GetFieldID(JniConstants::structPollfdClass,
+            "fd", "Ljava/io/FileDescriptor;");
+    gPosixIds.structPollfdReventsFid = env->GetFieldID(JniConstants::structPollfdClass,
+            "revents", "S");
+    gPosixIds.structStatCtor = env->GetMethodID(JniConstants::structStatClass,
+            "<init>", "(JJIJIIJJJJJJJ)V");
+    gPosixIds.structStatVfsCtor = env->GetMethodID(JniConstants::structStatVfsClass,
+            "<init>", "(JJJJJJJJJJJ)V");
+    gPosixIds.structTimevalCtor = env->GetMethodID(JniConstants::structTimevalClass,
+            "<init>", "(JJ)V");
+    gPosixIds.structUcredCtor = env->GetMethodID(JniConstants::structUcredClass,
+            "<init>", "(III)V");
+    gPosixIds.structUtsnameCtor = env->GetMethodID(JniConstants::structUtsnameClass,
+            "<init>", "(Ljava/lang/String;Ljava/lang/String;Ljava/lang/String;Ljava/lang/String;Ljava/lang/String;)V");
+}
+
 static void throwException(JNIEnv* env, jclass exceptionClass, jmethodID ctor3, jmethodID ctor2,
         const char* functionName, int error) {
     jthrowable cause = NULL;
@@ -222,31 +356,94 @@ static void throwException(JNIEnv* env, jclass exceptionClass, jmethodID ctor3,
     env->Throw(reinterpret_cast<jthrowable>(exception));
 }
 
+/**
+ * Shared, stackless ErrnoExceptions for EAGAIN, one per function name. Non-blocking I/O hits
+ * EAGAIN constantly and callers only look at the errno, so there's no need to allocate a new
+ * exception (and detail string) every time.
+ */
+static const size_t MAX_SHARED_EAGAIN_EXCEPTIONS = 32;
+static struct {
+    char* functionName;
+    jthrowable exception;
+} gSharedEagainExceptions[MAX_SHARED_EAGAIN_EXCEPTIONS];
+static size_t gSharedEagainExceptionCount = 0;
+static pthread_mutex_t gSharedEagainExceptionsMutex = PTHREAD_MUTEX_INITIALIZER;
+
+static jthrowable findSharedEagainException(const char* functionName) {
+    for (size_t i = 0; i < gSharedEagainExceptionCount; ++i) {
+        if (strcmp(gSharedEagainExceptions[i].functionName, functionName) == 0) {
+            return gSharedEagainExceptions[i].exception;
+        }
+    }
+    return NULL;
+}
+
+/**
+ * Returns the shared EAGAIN exception for 'functionName', creating it if necessary, or NULL if
+ * there are already too many (or we're out of memory), in which case the caller should throw a
+ * new exception as usual.
+ */
+static jthrowable sharedEagainException(JNIEnv* env, const char* functionName) {
+    {
+        ScopedPthreadMutexLock lock(&gSharedEagainExceptionsMutex);
+        jthrowable exception = findSharedEagainException(functionName);
+        if (exception != NULL || gSharedEagainExceptionCount == MAX_SHARED_EAGAIN_EXCEPTIONS) {
+            return exception;
+        }
+    }
+
+    // Create the exception without holding the lock, since that runs Java code.
+    ScopedLocalRef<jstring> javaFunctionName(env, env->NewStringUTF(functionName));
+    if (javaFunctionName.get() == NULL) {
+        env->ExceptionClear();
+        return NULL;
+    }
+    ScopedLocalRef<jobject> localException(env, env->NewObject(JniConstants::errnoExceptionClass,
+            gPosixIds.errnoExceptionSharedCtor, javaFunctionName.get(), EAGAIN, JNI_TRUE));
+    if (localException.get() == NULL) {
+        env->ExceptionClear();
+        return NULL;
+    }
+
+    ScopedPthreadMutexLock lock(&gSharedEagainExceptionsMutex);
+    // Another thread may have beaten us to it, in which case we use its exception.
+    jthrowable exception = findSharedEagainException(functionName);
+    if (exception == NULL && gSharedEagainExceptionCount < MAX_SHARED_EAGAIN_EXCEPTIONS) {
+        char* copy = strdup(functionName);
+        exception = reinterpret_cast<jthrowable>(env->NewGlobalRef(localException.get()));
+        if (copy == NULL || exception == NULL) {
+            free(copy);
+            env->ExceptionClear();
+            return NULL;
+        }
+        gSharedEagainExceptions[gSharedEagainExceptionCount].functionName = copy;
+        gSharedEagainExceptions[gSharedEagainExceptionCount].exception = exception;
+        ++gSharedEagainExceptionCount;
+    }
+    return exception;
+}
+
 static void throwErrnoException(JNIEnv* env, const char* functionName) {
     int error = errno;
-    static jmethodID ctor3 = env->GetMethodID(JniConstants::errnoExceptionClass,
-            "<init>", "(Ljava/lang/String;ILjava/lang/Throwable;)V");
-    static jmethodID ctor2 = env->GetMethodID(JniConstants::errnoExceptionClass,
-            "<init>", "(Ljava/lang/String;I)V");
-    throwException(env, JniConstants::errnoExceptionClass, ctor3, ctor2, functionName, error);
+    if (error == EAGAIN && !env->ExceptionCheck()) {
+        jthrowable exception = sharedEagainException(env, functionName);
+        if (exception != NULL) {
+            env->Throw(exception);
+            return;
+        }
+    }
+    throwException(env, JniConstants::errnoExceptionClass, gPosixIds.errnoExceptionCtor3,
+            gPosixIds.errnoExceptionCtor2, functionName, error);
 }
 
 #if defined(__MINGW32__) || defined(__MINGW64__)
 static void throwErrnoExceptionWithCode(JNIEnv* env, int error, const char* functionName) {
-    static jmethodID ctor3 = env->GetMethodID(JniConstants::errnoExceptionClass,
-            "<init>", "(Ljava/lang/String;ILjava/lang/Throwable;)V");
-    static jmethodID ctor2 = env->GetMethodID(JniConstants::errnoExceptionClass,
-            "<init>", "(Ljava/lang/String;I)V");
-    throwException(env, JniConstants::errnoExceptionClass, ctor3, ctor2, functionName, error);
+    throwException(env, JniConstants::errnoExceptionClass, gPosixIds.errnoExceptionCtor3,
+            gPosixIds.errnoExceptionCtor2, functionName, error);
 }
 #endif
 
 static void throwGaiException(JNIEnv* env, const char* functionName, int error) {
-  // Cache the methods ids before we throw, so we don't call GetMethodID with a pending exception.
-  static jmethodID ctor3 = env->GetMethodID(JniConstants::gaiExceptionClass, "<init>",
-                                            "(Ljava/lang/String;ILjava/lang/Throwable;)V");
-  static jmethodID ctor2 = env->GetMethodID(JniConstants::gaiExceptionClass, "<init>",
-                                            "(Ljava/lang/String;I)V");
   if (errno != 0) {
         // EAI_SYSTEM should mean "look at errno instead", but both glibc and bionic seem to
         // mess this up. In particular, if you don't have INTERNET permission, errno will be EACCES
@@ -256,7 +453,8 @@ static void throwGaiException(JNIEnv* env, const char* functionName, int error)
         throwErrnoException(env, functionName);
         // Deliberately fall through to throw another exception...
     }
-    throwException(env, JniConstants::gaiExceptionClass, ctor3, ctor2, functionName, error);
+    throwException(env, JniConstants::gaiExceptionClass, gPosixIds.gaiExceptionCtor3,
+            gPosixIds.gaiExceptionCtor2, functionName, error);
 }
 
 template <typename rc_t>
@@ -267,10 +465,51 @@ static rc_t throwIfMinusOne(JNIEnv* env, const char* name, rc_t rc) {
     return rc;
 }
 
+/**
+ * Charges the bytes transferred by a successful read or write to the calling native, in builds
+ * that count natives (see NativeCounters.h). Returns 'byteCount'.
+ */
+static jint countTransfer(jint byteCount) {
+    if (byteCount > 0) {
+        countNativeBytes(byteCount);
+    }
+    return byteCount;
+}
+
+/**
+ * Returns the most buffers a single readv(2) or writev(2) accepts.
+ */
+static size_t maxIoVecCount() {
+    static size_t maxCount = 0;
+    if (maxCount == 0) {
+        long limit = sysconf(_SC_IOV_MAX);
+        // Linux's limit is 1024, and MinGW's emulation doesn't have one.
+        maxCount = (limit > 0) ? limit : 1024;
+    }
+    return maxCount;
+}
+
+/**
+ * Pins the buffers of a Java gather list and builds the corresponding iovec array. Up to
+ * STACK_BUFFER_COUNT buffers are handled on the stack, and longer lists use the thread's
+ * ScratchArena, so neither touches the heap. Callers must be prepared for more than
+ * maxIoVecCount() buffers: see IO_VEC_FAILURE_RETRY.
+ */
 template <typename ScopedT>
 class IoVec {
 public:
-    IoVec(JNIEnv* env, size_t bufferCount) : mEnv(env), mBufferCount(bufferCount) {
+    IoVec(JNIEnv* env, size_t bufferCount) : mEnv(env), mBufferCount(bufferCount),
+            mScopedBufferCount(0), mIoVec(mStackIoVec), mScopedBuffers(mStackScopedBuffers) {
+        if (bufferCount > STACK_BUFFER_COUNT) {
+            mIoVec = mArena.allocateArray<iovec>(bufferCount);
+            mScopedBuffers = mArena.allocateArray<ScopedStorage>(bufferCount);
+            if (mIoVec == NULL || mScopedBuffers == NULL) {
+                mHeapIoVec.reset(new iovec[bufferCount]);
+                mIoVec = mHeapIoVec.get();
+                mHeapScopedBuffers.reset(new ScopedStorage[bufferCount]);
+                mScopedBuffers = mHeapScopedBuffers.get();
+            }
+        }
     }
 
     bool init(jobjectArray javaBuffers, jintArray javaOffsets, jintArray javaByteCounts) {
@@ -286,32 +525,29 @@ public:
         if (byteCounts.get() == NULL) {
             return false;
         }
-        // TODO: Linux actually has a 1024 buffer limit. glibc works around this, and we should too.
-        // TODO: you can query the limit at runtime with sysconf(_SC_IOV_MAX).
         for (size_t i = 0; i < mBufferCount; ++i) {
             jobject buffer = mEnv->GetObjectArrayElement(javaBuffers, i); // We keep this local ref.
-            mScopedBuffers.push_back(new ScopedT(mEnv, buffer));
-            jbyte* ptr = const_cast<jbyte*>(mScopedBuffers.back()->get());
+            ScopedT* scopedBuffer = new (&mScopedBuffers[i]) ScopedT(mEnv, buffer);
+            ++mScopedBufferCount;
+            jbyte* ptr = const_cast<jbyte*>(scopedBuffer->get());
             if (ptr == NULL) {
                 return false;
             }
-            struct iovec iov;
-            iov.iov_base = reinterpret_cast<void*>(ptr + offsets[i]);
-            iov.iov_len = byteCounts[i];
-            mIoVec.push_back(iov);
+            mIoVec[i].iov_base = reinterpret_cast<void*>(ptr + offsets[i]);
+            mIoVec[i].iov_len = byteCounts[i];
         }
         return true;
     }
 
     ~IoVec() {
-        for (size_t i = 0; i < mScopedBuffers.size(); ++i) {
-            delete mScopedBuffers[i];
+        for (size_t i = 0; i < mScopedBufferCount; ++i) {
+            reinterpret_cast<ScopedT*>(&mScopedBuffers[i])->~ScopedT();
         }
         mEnv->PopLocalFrame(NULL);
     }
 
     iovec* get() {
-        return &mIoVec[0];
+        return mIoVec;
     }
 
     size_t size() {
@@ -319,51 +555,109 @@ public:
     }
 
 private:
+    // Most gather lists (an HTTP/2 frame header and payload, say) are short.
+    static const size_t STACK_BUFFER_COUNT = 16;
+
+    typedef typename std::aligned_storage<sizeof(ScopedT), alignof(ScopedT)>::type ScopedStorage;
+
     JNIEnv* mEnv;
     size_t mBufferCount;
-    std::vector<iovec> mIoVec;
-    std::vector<ScopedT*> mScopedBuffers;
+    size_t mScopedBufferCount;
+    ScopedScratchArena mArena;
+
+    iovec* mIoVec;
+    iovec mStackIoVec[STACK_BUFFER_COUNT];
+    UniquePtr<iovec[]> mHeapIoVec;
+
+    ScopedStorage* mScopedBuffers;
+    ScopedStorage mStackScopedBuffers[STACK_BUFFER_COUNT];
+    UniquePtr<ScopedStorage[]> mHeapScopedBuffers;
+
+    // Disallow copy and assignment.
+    IoVec(const IoVec&);
+    void operator=(const IoVec&);
 };
 
+/**
+ * Performs readv(2) or writev(2) on an IoVec of any length, issuing one IO_FAILURE_RETRY call
+ * per maxIoVecCount() buffers. Like glibc's emulation for over-long lists, we stop at the first
+ * short transfer. A failure after some bytes have been transferred reports those bytes instead;
+ * the next call will see the error again.
+ */
+#define IO_VEC_FAILURE_RETRY(jni_env, syscall_name, java_fd, io_vec) ({ \
+    ssize_t _total = 0; \
+    size_t _maxCount = maxIoVecCount(); \
+    for (size_t _i = 0; _i < (io_vec).size(); _i += _maxCount) { \
+        size_t _count = std::min((io_vec).size() - _i, _maxCount); \
+        ssize_t _chunkRc = IO_FAILURE_RETRY(jni_env, ssize_t, syscall_name, java_fd, (io_vec).get() + _i, _count); \
+        if (_chunkRc == -1) { \
+            if (_total > 0) { \
+                (jni_env)->ExceptionClear(); \
+            } else { \
+                _total = -1; \
+            } \
+            break; \
+        } \
+        _total += _chunkRc; \
+        size_t _chunkByteCount = 0; \
+        for (size_t _j = _i; _j < _i + _count; ++_j) { \
+            _chunkByteCount += (io_vec).get()[_j].iov_len; \
+        } \
+        if (static_cast<size_t>(_chunkRc) < _chunkByteCount) { \
+            break; \
+        } \
+    } \
+    _total; })
+
 static jobject makeSocketAddress(JNIEnv* env, const sockaddr_storage& ss) {
     jint port;
     jobject inetAddress = sockaddrToInetAddress(env, ss, &port);
     if (inetAddress == NULL) {
         return NULL;
     }
-    static jmethodID ctor = env->GetMethodID(JniConstants::inetSocketAddressClass, "<init>",
-            "(Ljava/net/InetAddress;I)V");
-    return env->NewObject(JniConstants::inetSocketAddressClass, ctor, inetAddress, port);
+    return env->NewObject(JniConstants::inetSocketAddressClass, gPosixIds.inetSocketAddressCtor,
+            inetAddress, port);
 }
 
 static jobject makeStructPasswd(JNIEnv* env, const struct passwd& pw) {
     TO_JAVA_STRING(pw_name, pw.pw_name);
     TO_JAVA_STRING(pw_dir, pw.pw_dir);
     TO_JAVA_STRING(pw_shell, pw.pw_shell);
-    static jmethodID ctor = env->GetMethodID(JniConstants::structPasswdClass, "<init>",
-            "(Ljava/lang/String;IILjava/lang/String;Ljava/lang/String;)V");
-    return env->NewObject(JniConstants::structPasswdClass, ctor,
+    return env->NewObject(JniConstants::structPasswdClass, gPosixIds.structPasswdCtor,
             pw_name, static_cast<jint>(pw.pw_uid), static_cast<jint>(pw.pw_gid), pw_dir, pw_shell);
 }
 
-static jobject makeStructStat(JNIEnv* env, const struct _stat& sb) {
+// The number of fields in a StructStat, and so of values written by statInto.
+static const jsize STAT_FIELD_COUNT = 13;
+
+// Flattens 'sb' in StructStat constructor order.
+static void statToFields(const struct _stat& sb, jlong* fields) {
+    fields[0] = static_cast<jlong>(sb.st_dev);
+    fields[1] = static_cast<jlong>(sb.st_ino);
+    fields[2] = static_cast<jlong>(sb.st_mode);
+    fields[3] = static_cast<jlong>(sb.st_nlink);
+    fields[4] = static_cast<jlong>(sb.st_uid);
+    fields[5] = static_cast<jlong>(sb.st_gid);
+    fields[6] = static_cast<jlong>(sb.st_rdev);
+    fields[7] = static_cast<jlong>(sb.st_size);
+    fields[8] = static_cast<jlong>(sb.st_atime);
+    fields[9] = static_cast<jlong>(sb.st_mtime);
+    fields[10] = static_cast<jlong>(sb.st_ctime);
 #if !defined(__MINGW32__) && !defined(__MINGW64__)
-	jlong blksize = static_cast<jlong>(sb.st_blksize);
-	jlong blocks = static_cast<jlong>(sb.st_blocks);
+    fields[11] = static_cast<jlong>(sb.st_blksize);
+    fields[12] = static_cast<jlong>(sb.st_blocks);
 #else
-	jlong blksize = -1;
-	jlong blocks = -1;
+    fields[11] = -1;
+    fields[12] = -1;
 #endif
+}
 
-    static jmethodID ctor = env->GetMethodID(JniConstants::structStatClass, "<init>",
-            "(JJIJIIJJJJJJJ)V");
-    return env->NewObject(JniConstants::structStatClass, ctor,
-            static_cast<jlong>(sb.st_dev), static_cast<jlong>(sb.st_ino),
-            static_cast<jint>(sb.st_mode), static_cast<jlong>(sb.st_nlink),
-            static_cast<jint>(sb.st_uid), static_cast<jint>(sb.st_gid),
-            static_cast<jlong>(sb.st_rdev), static_cast<jlong>(sb.st_size),
-            static_cast<jlong>(sb.st_atime), static_cast<jlong>(sb.st_mtime),
-            static_cast<jlong>(sb.st_ctime), blksize, blocks);
+static jobject makeStructStat(JNIEnv* env, const struct _stat& sb) {
+    jlong f[STAT_FIELD_COUNT];
+    statToFields(sb, f);
+    return env->NewObject(JniConstants::structStatClass, gPosixIds.structStatCtor,
+            f[0], f[1], static_cast<jint>(f[2]), f[3], static_cast<jint>(f[4]),
+            static_cast<jint>(f[5]), f[6], f[7], f[8], f[9], f[10], f[11], f[12]);
 }
 
 static jobject makeStructStatVfs(JNIEnv* env, const struct statvfs& sb) {
@@ -374,9 +668,7 @@ static jobject makeStructStatVfs(JNIEnv* env, const struct statvfs& sb) {
     jlong max_name_length = static_cast<jlong>(sb.f_namemax);
 #endif
 
-    static jmethodID ctor = env->GetMethodID(JniConstants::structStatVfsClass, "<init>",
-            "(JJJJJJJJJJJ)V");
-    return env->NewObject(JniConstants::structStatVfsClass, ctor,
+    return env->NewObject(JniConstants::structStatVfsClass, gPosixIds.structStatVfsCtor,
                           static_cast<jlong>(sb.f_bsize),
                           static_cast<jlong>(sb.f_frsize),
                           static_cast<jlong>(sb.f_blocks),
@@ -391,13 +683,12 @@ static jobject makeStructStatVfs(JNIEnv* env, const struct statvfs& sb) {
 }
 
 static jobject makeStructLinger(JNIEnv* env, const struct linger& l) {
-    static jmethodID ctor = env->GetMethodID(JniConstants::structLingerClass, "<init>", "(II)V");
-    return env->NewObject(JniConstants::structLingerClass, ctor, l.l_onoff, l.l_linger);
+    return env->NewObject(JniConstants::structLingerClass, gPosixIds.structLingerCtor,
+            l.l_onoff, l.l_linger);
 }
 
 static jobject makeStructTimeval(JNIEnv* env, const struct timeval& tv) {
-    static jmethodID ctor = env->GetMethodID(JniConstants::structTimevalClass, "<init>", "(JJ)V");
-    return env->NewObject(JniConstants::structTimevalClass, ctor,
+    return env->NewObject(JniConstants::structTimevalClass, gPosixIds.structTimevalCtor,
             static_cast<jlong>(tv.tv_sec), static_cast<jlong>(tv.tv_usec));
 }
 
@@ -406,8 +697,8 @@ static jobject makeStructUcred(JNIEnv* env, const struct ucred& u __unused) {
   jniThrowException(env, "java/lang/UnsupportedOperationException", "unimplemented support for ucred on a Mac");
   return NULL;
 #else
-  static jmethodID ctor = env->GetMethodID(JniConstants::structUcredClass, "<init>", "(III)V");
-  return env->NewObject(JniConstants::structUcredClass, ctor, u.pid, u.uid, u.gid);
+  return env->NewObject(JniConstants::structUcredClass, gPosixIds.structUcredCtor,
+          u.pid, u.uid, u.gid);
 #endif
 }
 
@@ -417,9 +708,7 @@ static jobject makeStructUtsname(JNIEnv* env, const struct utsname& buf) {
     TO_JAVA_STRING(release, buf.release);
     TO_JAVA_STRING(version, buf.version);
     TO_JAVA_STRING(machine, buf.machine);
-    static jmethodID ctor = env->GetMethodID(JniConstants::structUtsnameClass, "<init>",
-            "(Ljava/lang/String;Ljava/lang/String;Ljava/lang/String;Ljava/lang/String;Ljava/lang/String;)V");
-    return env->NewObject(JniConstants::structUtsnameClass, ctor,
+    return env->NewObject(JniConstants::structUtsnameClass, gPosixIds.structUtsnameCtor,
             sysname, nodename, release, version, machine);
 };
 
@@ -444,10 +733,23 @@ static bool fillInetSocketAddress(JNIEnv* env, jint rc, jobject javaInetSocketAd
     if (sender == NULL) {
         return false;
     }
-    static jfieldID addressFid = env->GetFieldID(JniConstants::inetSocketAddressClass, "addr", "Ljava/net/InetAddress;");
-    static jfieldID portFid = env->GetFieldID(JniConstants::inetSocketAddressClass, "port", "I");
-    env->SetObjectField(javaInetSocketAddress, addressFid, sender);
-    env->SetIntField(javaInetSocketAddress, portFid, port);
+    env->SetObjectField(javaInetSocketAddress, gPosixIds.inetSocketAddressAddrFid, sender);
+    env->SetIntField(javaInetSocketAddress, gPosixIds.inetSocketAddressPortFid, port);
+    return true;
+}
+
+// Writes the peer in 'ss' into the PACKED_SOCKADDR_LENGTH bytes at the start of 'javaPacked'.
+static bool fillPackedSockaddr(JNIEnv* env, jint rc, jbyteArray javaPacked, const sockaddr_storage& ss) {
+    if (rc == -1 || javaPacked == NULL) {
+        return true;
+    }
+    if (env->GetArrayLength(javaPacked) < static_cast<jsize>(PACKED_SOCKADDR_LENGTH)) {
+        jniThrowException(env, "java/lang/IllegalArgumentException", "packed address array too short");
+        return false;
+    }
+    jbyte packed[PACKED_SOCKADDR_LENGTH];
+    sockaddrToPackedSockaddr(ss, packed);
+    env->SetByteArrayRegion(javaPacked, 0, PACKED_SOCKADDR_LENGTH, packed);
     return true;
 }
 
@@ -559,6 +861,137 @@ static jobject Posix_accept(JNIEnv* env, jobject, jobject javaFd, jobject javaIn
     return (clientFd != -1) ? jniCreateFileDescriptor(env, clientFd) : NULL;
 }
 
+static jobject Posix_acceptPacked(JNIEnv* env, jobject, jobject javaFd, jbyteArray javaPeerAddress) {
+    sockaddr_storage ss;
+    socklen_t sl = sizeof(ss);
+    memset(&ss, 0, sizeof(ss));
+    sockaddr* peer = (javaPeerAddress != NULL) ? reinterpret_cast<sockaddr*>(&ss) : NULL;
+    socklen_t* peerLength = (javaPeerAddress != NULL) ? &sl : 0;
+
+    jint clientFd;
+#if !defined(__MINGW32__) && !defined(__MINGW64__)
+    clientFd = IO_FAILURE_RETRY(env, int, accept, javaFd, peer, peerLength);
+#else
+    SOCKET acceptSock = IO_FAILURE_RETRY(env, SOCKET, accept, javaFd, peer, peerLength);
+    clientFd = (acceptSock != INVALID_SOCKET) ? acceptSock : -1;
+#endif
+
+    if (clientFd == -1 || !fillPackedSockaddr(env, clientFd, javaPeerAddress, ss)) {
+#if !defined(__MINGW32__) && !defined(__MINGW64__)
+        close(clientFd);
+#else
+        mingw_close(clientFd);
+#endif
+        return NULL;
+    }
+    return jniCreateFileDescriptor(env, clientFd);
+}
+
+static jint Posix_acceptMany(JNIEnv* env, jobject, jobject javaFd, jintArray javaFds, jbyteArray javaPeerAddresses, jint flags) {
+#if defined(__linux__)
+    ScopedIntArrayRW fds(env, javaFds);
+    if (fds.get() == NULL) {
+        return -1;
+    }
+    UniquePtr<ScopedByteArrayRW> peerAddresses;
+    size_t maxCount = fds.size();
+    if (javaPeerAddresses != NULL) {
+        peerAddresses.reset(new ScopedByteArrayRW(env, javaPeerAddresses));
+        if (peerAddresses->get() == NULL) {
+            return -1;
+        }
+        maxCount = std::min(maxCount, peerAddresses->size() / PACKED_SOCKADDR_LENGTH);
+    }
+
+    size_t count = 0;
+    while (count < maxCount) {
+        sockaddr_storage ss;
+        socklen_t sl = sizeof(ss);
+        memset(&ss, 0, sizeof(ss));
+        sockaddr* peer = (javaPeerAddresses != NULL) ? reinterpret_cast<sockaddr*>(&ss) : NULL;
+        socklen_t* peerLength = (javaPeerAddresses != NULL) ? &sl : 0;
+
+        int clientFd;
+        if (count == 0) {
+            // The first accept behaves just like Posix_accept, blocking or throwing as usual.
+            clientFd = IO_FAILURE_RETRY(env, int, accept4, javaFd, peer, peerLength, flags);
+            if (clientFd == -1) {
+                return -1;
+            }
+        } else {
+            // After that we only take connections that are already waiting. A non-blocking
+            // listener tells us with EAGAIN; for a blocking one, we ask poll(2) first.
+            int fd = jniGetFDFromFileDescriptor(env, javaFd);
+            pollfd pfd;
+            pfd.fd = fd;
+            pfd.events = POLLIN;
+            pfd.revents = 0;
+            if (TEMP_FAILURE_RETRY(poll(&pfd, 1, 0)) != 1 || (pfd.revents & POLLIN) == 0) {
+                break;
+            }
+            // Like the first accept, this one can be interrupted by a concurrent close.
+            clientFd = IO_ERRNO_RETRY(env, int, accept4, javaFd, peer, peerLength, flags);
+            if (clientFd == -EBADF && !env->ExceptionCheck()) {
+                jniThrowException(env, "java/io/IOException", "File descriptor closed");
+            }
+            if (env->ExceptionCheck()) {
+                // The listener was closed under us. Nobody will see the connections we've
+                // already taken, so close them rather than leak them.
+                for (size_t i = 0; i < count; ++i) {
+                    close(fds[i]);
+                }
+                return -1;
+            }
+            if (clientFd < 0) {
+                // Including EAGAIN. Any real error will be reported by the caller's next call.
+                break;
+            }
+        }
+        fds[count] = clientFd;
+        if (javaPeerAddresses != NULL) {
+            sockaddrToPackedSockaddr(ss, peerAddresses->get() + count * PACKED_SOCKADDR_LENGTH);
+        }
+        ++count;
+    }
+    return count;
+#else
+    errno = ENOSYS;
+    throwErrnoException(env, "accept4");
+    return -1;
+#endif
+}
+
+static jint Posix_acceptErrno(JNIEnv* env, jobject, jobject javaFd, jbyteArray javaPeerAddress, jint flags) {
+    sockaddr_storage ss;
+    socklen_t sl = sizeof(ss);
+    memset(&ss, 0, sizeof(ss));
+    sockaddr* peer = (javaPeerAddress != NULL) ? reinterpret_cast<sockaddr*>(&ss) : NULL;
+    socklen_t* peerLength = (javaPeerAddress != NULL) ? &sl : 0;
+
+#if defined(__linux__)
+    jint clientFd = IO_ERRNO_RETRY(env, int, accept4, javaFd, peer, peerLength, flags);
+#else
+    if (flags != 0) {
+        return -ENOSYS;
+    }
+#if !defined(__MINGW32__) && !defined(__MINGW64__)
+    jint clientFd = IO_ERRNO_RETRY(env, int, accept, javaFd, peer, peerLength);
+#else
+    jint clientFd = IO_ERRNO_RETRY(env, SOCKET, accept, javaFd, peer, peerLength);
+#endif
+#endif
+
+    if (clientFd >= 0 && !fillPackedSockaddr(env, clientFd, javaPeerAddress, ss)) {
+#if !defined(__MINGW32__) && !defined(__MINGW64__)
+        close(clientFd);
+#else
+        mingw_close(clientFd);
+#endif
+        return -1;
+    }
+    return clientFd;
+}
+
 static jboolean Posix_access(JNIEnv* env, jobject, jstring javaPath, jint mode) {
     ScopedPathChars path(env, javaPath);
     if (path.c_str() == NULL) {
@@ -634,6 +1067,20 @@ static void Posix_connect(JNIEnv* env, jobject, jobject javaFd, jobject javaAddr
 #endif
 }
 
+static jint Posix_connectErrno(JNIEnv* env, jobject, jobject javaFd, jobject javaAddress, jint port) {
+    sockaddr_storage ss;
+    socklen_t sa_len;
+    if (!inetAddressToSockaddr(env, javaAddress, port, ss, sa_len)) {
+        return -1;
+    }
+    const sockaddr* sa = reinterpret_cast<const sockaddr*>(&ss);
+#if !defined(__MINGW32__) && !defined(__MINGW64__)
+    return IO_ERRNO_RETRY(env, int, connect, javaFd, sa, sa_len);
+#else
+    return IO_ERRNO_RETRY(env, int, mingw_connect, javaFd, sa, sa_len);
+#endif
+}
+
 static jobject Posix_dup(JNIEnv* env, jobject, jobject javaOldFd) {
     int oldFd = jniGetFDFromFileDescriptor(env, javaOldFd);
     int newFd = throwIfMinusOne(env, "dup", TEMP_FAILURE_RETRY(dup(oldFd)));
@@ -764,8 +1211,10 @@ static jstring Posix_gai_strerror(JNIEnv* env, jobject, jint error) {
 }
 
 static jobjectArray Posix_getaddrinfo(JNIEnv* env, jobject, jstring javaNode, jobject javaHints) {
-    ScopedUtfChars node(env, javaNode);
-    if (node.c_str() == NULL) {
+    // Host names are short, so copy into the scratch arena rather than pinning the string.
+    ScopedScratchArena arena;
+    const char* node = arena.utfChars(env, javaNode);
+    if (node == NULL) {
         return NULL;
     }
 
@@ -783,7 +1232,7 @@ static jobjectArray Posix_getaddrinfo(JNIEnv* env, jobject, jstring javaNode, jo
 
     addrinfo* addressList = NULL;
     errno = 0;
-    int rc = getaddrinfo(node.c_str(), NULL, &hints, &addressList);
+    int rc = getaddrinfo(node, NULL, &hints, &addressList);
     UniquePtr<addrinfo, addrinfo_deleter> addressListDeleter(addressList);
     if (rc != 0) {
         throwGaiException(env, "getaddrinfo", rc);
@@ -872,6 +1321,19 @@ static jstring Posix_getnameinfo(JNIEnv* env, jobject, jobject javaAddress, jint
     return env->NewStringUTF(buf);
 }
 
+static void Posix_getpeernamePacked(JNIEnv* env, jobject, jobject javaFd, jbyteArray javaPeerAddress) {
+    int fd = jniGetFDFromFileDescriptor(env, javaFd);
+    sockaddr_storage ss;
+    socklen_t byteCount = sizeof(ss);
+    memset(&ss, 0, byteCount);
+    int rc = TEMP_FAILURE_RETRY(getpeername(fd, reinterpret_cast<sockaddr*>(&ss), &byteCount));
+    if (rc == -1) {
+        throwErrnoException(env, "getpeername");
+        return;
+    }
+    fillPackedSockaddr(env, rc, javaPeerAddress, ss);
+}
+
 static jobject Posix_getpeername(JNIEnv* env, jobject, jobject javaFd) {
   return doGetSockName(env, javaFd, false);
 }
@@ -1061,7 +1523,7 @@ static jint Posix_ioctlInt(JNIEnv* env, jobject, jobject javaFd, jint cmd, jobje
     // This is complicated because ioctls may return their result by updating their argument
     // or via their return value, so we need to support both.
     int fd = jniGetFDFromFileDescriptor(env, javaFd);
-    static jfieldID valueFid = env->GetFieldID(JniConstants::mutableIntClass, "value", "I");
+    jfieldID valueFid = gPosixIds.mutableIntValueFid;
     jint arg = env->GetIntField(javaArg, valueFid);
     int rc = throwIfMinusOne(env, "ioctl", TEMP_FAILURE_RETRY(ioctl(fd, cmd, &arg)));
     if (!env->ExceptionCheck()) {
@@ -1113,6 +1575,11 @@ static jobject Posix_lstat(JNIEnv* env, jobject, jstring javaPath) {
     return doStat(env, javaPath, true);
 }
 
+static void Posix_madvise(JNIEnv* env, jobject, jlong address, jlong byteCount, jint advice) {
+    void* ptr = reinterpret_cast<void*>(static_cast<uintptr_t>(address));
+    throwIfMinusOne(env, "madvise", TEMP_FAILURE_RETRY(madvise(ptr, byteCount, advice)));
+}
+
 static void Posix_mincore(JNIEnv* env, jobject, jlong address, jlong byteCount, jbyteArray javaVector) {
     ScopedByteArrayRW vector(env, javaVector);
     if (vector.get() == NULL) {
@@ -1175,6 +1642,10 @@ static jobject Posix_open(JNIEnv* env, jobject, jstring javaPath, jint flags, ji
         return NULL;
     }
     #if defined(__MINGW32__) || defined(__MINGW64__)
+    if ((flags & O_OVERLAPPED) != 0) {
+        int fd = throwIfMinusOne(env, "open", mingw_open_overlapped(path.c_str(), flags & ~O_OVERLAPPED, mode));
+        return fd != -1 ? jniCreateFileDescriptor(env, fd) : NULL;
+    }
     flags |= O_BINARY;
     #endif
     int fd = throwIfMinusOne(env, "open", TEMP_FAILURE_RETRY(u_open(path.c_str(), flags, mode)));
@@ -1202,20 +1673,20 @@ static jobjectArray Posix_pipe(JNIEnv* env, jobject) {
 }
 
 static jint Posix_poll(JNIEnv* env, jobject, jobjectArray javaStructs, jint timeoutMs) {
-    static jfieldID fdFid = env->GetFieldID(JniConstants::structPollfdClass, "fd", "Ljava/io/FileDescriptor;");
-    static jfieldID eventsFid = env->GetFieldID(JniConstants::structPollfdClass, "events", "S");
-    static jfieldID reventsFid = env->GetFieldID(JniConstants::structPollfdClass, "revents", "S");
+    jfieldID fdFid = gPosixIds.structPollfdFdFid;
+    jfieldID eventsFid = gPosixIds.structPollfdEventsFid;
+    jfieldID reventsFid = gPosixIds.structPollfdReventsFid;
 
     // Turn the Java android.system.StructPollfd[] into a C++ struct pollfd[].
     size_t arrayLength = env->GetArrayLength(javaStructs);
 
 #if defined(__MINGW32__) || defined(__MINGW64__)
-	bool createUnlockPair = timeoutMs > 0;
+    // Only a poll that can block needs to be woken by signalBlockedThreads.
+    UnlockPair* unlockPair = (timeoutMs != 0) ? UnlockPair::forCurrentThread() : NULL;
+    size_t tmpLength = arrayLength + (unlockPair != NULL ? 1 : 0);
 #else
-	bool createUnlockPair = false;
+    size_t tmpLength = arrayLength;
 #endif
-
-	int tmpLength = arrayLength + (createUnlockPair ? 2 : 0);
     UniquePtr<struct pollfd[]> fds(new struct pollfd[tmpLength]);
     memset(fds.get(), 0, sizeof(struct pollfd) * tmpLength);
     size_t count = 0; // Some trailing array elements may be irrelevant. (See below.)
@@ -1233,31 +1704,35 @@ static jint Posix_poll(JNIEnv* env, jobject, jobjectArray javaStructs, jint time
         ++count;
     }
 
+    size_t pollCount = count;
 #if defined(__MINGW32__) || defined(__MINGW64__)
-	UnlockPair* unlockPair = NULL;
-	if (createUnlockPair) {
-		unlockPair = new UnlockPair();
-		fds[count].fd = unlockPair->end1;
-        fds[count].events = POLLIN | POLLPRI | POLLOUT;
-		fds[count + 1].fd = unlockPair->end2;
-        fds[count + 1].events = POLLIN | POLLPRI | POLLOUT;
-	}
+    if (unlockPair != NULL) {
+        // Discard a wakeup meant for some earlier blocking call.
+        unlockPair->pop();
+        fds[pollCount].fd = unlockPair->end2;
+        fds[pollCount].events = POLLIN;
+        ++pollCount;
+    }
 #endif
 
     std::vector<AsynchronousCloseMonitor*> monitors;
     for (size_t i = 0; i < count; ++i) {
         monitors.push_back(new AsynchronousCloseMonitor(fds[i].fd));
     }
-    int rc = poll(fds.get(), createUnlockPair ? count + 2 : count, timeoutMs);
+    int rc = poll(fds.get(), pollCount, timeoutMs);
     for (size_t i = 0; i < monitors.size(); ++i) {
         delete monitors[i];
     }
 
 #if defined(__MINGW32__) || defined(__MINGW64__)
-	if (createUnlockPair) {
-		unlockPair->pop();
-		delete unlockPair;
-	}
+    if (unlockPair != NULL && rc > 0 && fds[count].revents != 0) {
+        unlockPair->pop();
+        // Report the wakeup the way a signal interrupts poll(2) elsewhere.
+        if (--rc == 0) {
+            rc = -1;
+            errno = EINTR;
+        }
+    }
 #endif
 
     if (rc == -1) {
@@ -1277,6 +1752,21 @@ static jint Posix_poll(JNIEnv* env, jobject, jobjectArray javaStructs, jint time
     return rc;
 }
 
+static void Posix_posix_fadvise(JNIEnv* env, jobject, jobject javaFd __unused,
+                                jlong offset __unused, jlong length __unused, jint advice __unused) {
+#ifdef __APPLE__
+    jniThrowException(env, "java/lang/UnsupportedOperationException",
+                      "fadvise doesn't exist on a Mac");
+#else
+    int fd = jniGetFDFromFileDescriptor(env, javaFd);
+    // Like posix_fallocate, this returns the error rather than setting errno.
+    errno = TEMP_FAILURE_RETRY(posix_fadvise64(fd, offset, length, advice));
+    if (errno != 0) {
+        throwErrnoException(env, "posix_fadvise");
+    }
+#endif
+}
+
 static void Posix_posix_fallocate(JNIEnv* env, jobject, jobject javaFd __unused,
                                   jlong offset __unused, jlong length __unused) {
 #ifdef __APPLE__
@@ -1309,7 +1799,7 @@ static jint Posix_preadBytes(JNIEnv* env, jobject, jobject javaFd, jobject javaB
     if (bytes.get() == NULL) {
         return -1;
     }
-    return IO_FAILURE_RETRY(env, ssize_t, pread64, javaFd, bytes.get() + byteOffset, byteCount, offset);
+    return countTransfer(IO_FAILURE_RETRY(env, ssize_t, pread64, javaFd, bytes.get() + byteOffset, byteCount, offset));
 }
 
 static jint Posix_pwriteBytes(JNIEnv* env, jobject, jobject javaFd, jbyteArray javaBytes, jint byteOffset, jint byteCount, jlong offset) {
@@ -1317,7 +1807,7 @@ static jint Posix_pwriteBytes(JNIEnv* env, jobject, jobject javaFd, jbyteArray j
     if (bytes.get() == NULL) {
         return -1;
     }
-    return IO_FAILURE_RETRY(env, ssize_t, pwrite64, javaFd, bytes.get() + byteOffset, byteCount, offset);
+    return countTransfer(IO_FAILURE_RETRY(env, ssize_t, pwrite64, javaFd, bytes.get() + byteOffset, byteCount, offset));
 }
 
 static jint Posix_readBytes(JNIEnv* env, jobject, jobject javaFd, jobject javaBytes, jint byteOffset, jint byteCount) {
@@ -1325,7 +1815,33 @@ static jint Posix_readBytes(JNIEnv* env, jobject, jobject javaFd, jobject javaBy
     if (bytes.get() == NULL) {
         return -1;
     }
-    return IO_FAILURE_RETRY(env, ssize_t, read, javaFd, bytes.get() + byteOffset, byteCount);
+    return countTransfer(IO_FAILURE_RETRY(env, ssize_t, read, javaFd, bytes.get() + byteOffset, byteCount));
+}
+
+static jint Posix_readBytesErrno(JNIEnv* env, jobject, jobject javaFd, jobject javaBytes, jint byteOffset, jint byteCount) {
+    ScopedBytesRW bytes(env, javaBytes);
+    if (bytes.get() == NULL) {
+        return -1;
+    }
+    return countTransfer(IO_ERRNO_RETRY(env, ssize_t, read, javaFd, bytes.get() + byteOffset, byteCount));
+}
+
+static void Posix_readahead(JNIEnv* env, jobject, jobject javaFd __unused,
+                            jlong offset __unused, jlong byteCount __unused) {
+#if defined(__linux__)
+    int fd = jniGetFDFromFileDescriptor(env, javaFd);
+    throwIfMinusOne(env, "readahead", TEMP_FAILURE_RETRY(readahead(fd, offset, byteCount)));
+#elif defined(__APPLE__)
+    // F_RDADVISE is the nearest equivalent, though it only takes an int count.
+    int fd = jniGetFDFromFileDescriptor(env, javaFd);
+    radvisory advisory;
+    advisory.ra_offset = offset;
+    advisory.ra_count = (byteCount > INT_MAX) ? INT_MAX : static_cast<int>(byteCount);
+    throwIfMinusOne(env, "readahead", TEMP_FAILURE_RETRY(fcntl(fd, F_RDADVISE, &advisory)));
+#else
+    jniThrowException(env, "java/lang/UnsupportedOperationException",
+                      "readahead isn't supported on this platform");
+#endif
 }
 
 static jstring Posix_readlink(JNIEnv* env, jobject, jstring javaPath) {
@@ -1347,7 +1863,7 @@ static jint Posix_readv(JNIEnv* env, jobject, jobject javaFd, jobjectArray buffe
     if (!ioVec.init(buffers, offsets, byteCounts)) {
         return -1;
     }
-    return IO_FAILURE_RETRY(env, ssize_t, readv, javaFd, ioVec.get(), ioVec.size());
+    return countTransfer(IO_VEC_FAILURE_RETRY(env, readv, javaFd, ioVec));
 }
 
 static jint Posix_recvfromBytes(JNIEnv* env, jobject, jobject javaFd, jobject javaBytes, jint byteOffset, jint byteCount, jint flags, jobject javaInetSocketAddress) {
@@ -1367,9 +1883,156 @@ static jint Posix_recvfromBytes(JNIEnv* env, jobject, jobject javaFd, jobject ja
     jint recvCount = IO_FAILURE_RETRY(env, ssize_t, recvfrom, javaFd, reinterpret_cast<char*>(bytes.get() + byteOffset), byteCount, flags, from, fromLength);
 #endif
     fillInetSocketAddress(env, recvCount, javaInetSocketAddress, ss);
+    return countTransfer(recvCount);
+}
+
+static jint Posix_recvfromBytesPacked(JNIEnv* env, jobject, jobject javaFd, jobject javaBytes, jint byteOffset, jint byteCount, jint flags, jbyteArray javaSrcAddress) {
+    ScopedBytesRW bytes(env, javaBytes);
+    if (bytes.get() == NULL) {
+        return -1;
+    }
+    sockaddr_storage ss;
+    socklen_t sl = sizeof(ss);
+    memset(&ss, 0, sizeof(ss));
+    sockaddr* from = (javaSrcAddress != NULL) ? reinterpret_cast<sockaddr*>(&ss) : NULL;
+    socklen_t* fromLength = (javaSrcAddress != NULL) ? &sl : 0;
+#if !defined(__MINGW32__) && !defined(__MINGW64__)
+    jint recvCount = IO_FAILURE_RETRY(env, ssize_t, recvfrom, javaFd, bytes.get() + byteOffset, byteCount, flags, from, fromLength);
+#else
+    jint recvCount = IO_FAILURE_RETRY(env, ssize_t, recvfrom, javaFd, reinterpret_cast<char*>(bytes.get() + byteOffset), byteCount, flags, from, fromLength);
+#endif
+    fillPackedSockaddr(env, recvCount, javaSrcAddress, ss);
     return recvCount;
 }
 
+static jint Posix_recvfromBytesErrno(JNIEnv* env, jobject, jobject javaFd, jobject javaBytes, jint byteOffset, jint byteCount, jint flags, jbyteArray javaSrcAddress) {
+    ScopedBytesRW bytes(env, javaBytes);
+    if (bytes.get() == NULL) {
+        return -1;
+    }
+    sockaddr_storage ss;
+    socklen_t sl = sizeof(ss);
+    memset(&ss, 0, sizeof(ss));
+    sockaddr* from = (javaSrcAddress != NULL) ? reinterpret_cast<sockaddr*>(&ss) : NULL;
+    socklen_t* fromLength = (javaSrcAddress != NULL) ? &sl : 0;
+#if !defined(__MINGW32__) && !defined(__MINGW64__)
+    jint recvCount = IO_ERRNO_RETRY(env, ssize_t, recvfrom, javaFd, bytes.get() + byteOffset, byteCount, flags, from, fromLength);
+#else
+    jint recvCount = IO_ERRNO_RETRY(env, ssize_t, recvfrom, javaFd, reinterpret_cast<char*>(bytes.get() + byteOffset), byteCount, flags, from, fromLength);
+#endif
+    if (recvCount >= 0 && !fillPackedSockaddr(env, recvCount, javaSrcAddress, ss)) {
+        return -1;
+    }
+    return countTransfer(recvCount);
+}
+
+// recvmmsg and sendmmsg describe each peer as a packed socket address.
+static const size_t MMSG_ADDRESS_LENGTH = PACKED_SOCKADDR_LENGTH;
+
+// The most datagrams we handle per call, so our message headers can live on the stack.
+static const size_t MAX_MMSG_COUNT = 64;
+
+// Returns how many of the caller's datagrams we can handle in one call.
+static size_t mmsgCount(size_t count, size_t byteCountsLength, jbyteArray javaAddresses,
+        size_t addressesLength) {
+    count = std::min(std::min(count, byteCountsLength), MAX_MMSG_COUNT);
+    if (javaAddresses != NULL) {
+        count = std::min(count, addressesLength / MMSG_ADDRESS_LENGTH);
+    }
+    return count;
+}
+
+// Checks that each of the first 'count' offset/count pairs lies within a 'length'-byte array,
+// throwing ArrayIndexOutOfBoundsException if not.
+static bool checkMmsgBuffers(JNIEnv* env, size_t length, const ScopedIntArrayRO& byteOffsets,
+        const ScopedIntArrayRO& byteCounts, size_t count) {
+    for (size_t i = 0; i < count; ++i) {
+        jint offset = byteOffsets[i];
+        jint byteCount = byteCounts[i];
+        if (offset < 0 || byteCount < 0 || static_cast<size_t>(offset) > length
+                || static_cast<size_t>(byteCount) > length - offset) {
+            jniThrowExceptionFmt(env, "java/lang/ArrayIndexOutOfBoundsException",
+                    "length=%zu; datagram %zu has offset=%d, count=%d", length, i, offset, byteCount);
+            return false;
+        }
+    }
+    return true;
+}
+
+static jint Posix_recvmmsg(JNIEnv* env, jobject, jobject javaFd, jbyteArray javaBytes, jintArray javaByteOffsets, jintArray javaByteCounts, jintArray javaReceivedByteCounts, jbyteArray javaAddresses, jint flags) {
+    ScopedByteArrayRW bytes(env, javaBytes);
+    if (bytes.get() == NULL) {
+        return -1;
+    }
+    ScopedIntArrayRO byteOffsets(env, javaByteOffsets);
+    if (byteOffsets.get() == NULL) {
+        return -1;
+    }
+    ScopedIntArrayRO byteCounts(env, javaByteCounts);
+    if (byteCounts.get() == NULL) {
+        return -1;
+    }
+    ScopedIntArrayRW receivedByteCounts(env, javaReceivedByteCounts);
+    if (receivedByteCounts.get() == NULL) {
+        return -1;
+    }
+    UniquePtr<ScopedByteArrayRW> addresses;
+    if (javaAddresses != NULL) {
+        addresses.reset(new ScopedByteArrayRW(env, javaAddresses));
+        if (addresses->get() == NULL) {
+            return -1;
+        }
+    }
+    size_t count = mmsgCount(std::min(byteOffsets.size(), receivedByteCounts.size()),
+            byteCounts.size(), javaAddresses, addresses.get() ? addresses->size() : 0);
+    if (count == 0) {
+        return 0;
+    }
+    if (!checkMmsgBuffers(env, bytes.size(), byteOffsets, byteCounts, count)) {
+        return -1;
+    }
+
+    sockaddr_storage ss[MAX_MMSG_COUNT];
+#if defined(__linux__)
+    mmsghdr msgs[MAX_MMSG_COUNT];
+    iovec iovs[MAX_MMSG_COUNT];
+    memset(msgs, 0, sizeof(mmsghdr) * count);
+    for (size_t i = 0; i < count; ++i) {
+        iovs[i].iov_base = bytes.get() + byteOffsets[i];
+        iovs[i].iov_len = byteCounts[i];
+        msgs[i].msg_hdr.msg_iov = &iovs[i];
+        msgs[i].msg_hdr.msg_iovlen = 1;
+        if (javaAddresses != NULL) {
+            msgs[i].msg_hdr.msg_name = &ss[i];
+            msgs[i].msg_hdr.msg_namelen = sizeof(ss[i]);
+        }
+    }
+    // Without MSG_WAITFORONE, a blocking recvmmsg(2) waits until all 'count' datagrams have
+    // arrived; we only promise to wait for the first.
+    int rc = IO_FAILURE_RETRY(env, int, recvmmsg, javaFd, msgs, count, flags | MSG_WAITFORONE, NULL);
+    for (int i = 0; i < rc; ++i) {
+        receivedByteCounts[i] = msgs[i].msg_len;
+    }
+#else
+    // Without recvmmsg(2) we just receive the first datagram; callers can't count on more anyway.
+    socklen_t sl = sizeof(ss[0]);
+    memset(&ss[0], 0, sizeof(ss[0]));
+    sockaddr* from = (javaAddresses != NULL) ? reinterpret_cast<sockaddr*>(&ss[0]) : NULL;
+    socklen_t* fromLength = (javaAddresses != NULL) ? &sl : 0;
+    ssize_t recvCount = IO_FAILURE_RETRY(env, ssize_t, recvfrom, javaFd, reinterpret_cast<char*>(bytes.get() + byteOffsets[0]), byteCounts[0], flags, from, fromLength);
+    int rc = (recvCount == -1) ? -1 : 1;
+    if (rc == 1) {
+        receivedByteCounts[0] = recvCount;
+    }
+#endif
+    if (javaAddresses != NULL) {
+        for (int i = 0; i < rc; ++i) {
+            sockaddrToPackedSockaddr(ss[i], addresses->get() + i * MMSG_ADDRESS_LENGTH);
+        }
+    }
+    return rc;
+}
+
 static void Posix_remove(JNIEnv* env, jobject, jstring javaPath) {
     ScopedPathChars path(env, javaPath);
     if (path.c_str() == NULL) {
@@ -1393,7 +2056,7 @@ static void Posix_rename(JNIEnv* env, jobject, jstring javaOldPath, jstring java
 static jlong Posix_sendfile(JNIEnv* env, jobject, jobject javaOutFd, jobject javaInFd, jobject javaOffset, jlong byteCount) {
     int outFd = jniGetFDFromFileDescriptor(env, javaOutFd);
     int inFd = jniGetFDFromFileDescriptor(env, javaInFd);
-    static jfieldID valueFid = env->GetFieldID(JniConstants::mutableLongClass, "value", "J");
+    jfieldID valueFid = gPosixIds.mutableLongValueFid;
     off_t offset = 0;
     off_t* offsetPtr = NULL;
     if (javaOffset != NULL) {
@@ -1408,6 +2071,78 @@ static jlong Posix_sendfile(JNIEnv* env, jobject, jobject javaOutFd, jobject jav
     return result;
 }
 
+static jint Posix_sendmmsg(JNIEnv* env, jobject, jobject javaFd, jbyteArray javaBytes, jintArray javaByteOffsets, jintArray javaByteCounts, jbyteArray javaAddresses, jint flags) {
+    ScopedByteArrayRO bytes(env, javaBytes);
+    if (bytes.get() == NULL) {
+        return -1;
+    }
+    ScopedIntArrayRO byteOffsets(env, javaByteOffsets);
+    if (byteOffsets.get() == NULL) {
+        return -1;
+    }
+    ScopedIntArrayRO byteCounts(env, javaByteCounts);
+    if (byteCounts.get() == NULL) {
+        return -1;
+    }
+    UniquePtr<ScopedByteArrayRO> addresses;
+    if (javaAddresses != NULL) {
+        addresses.reset(new ScopedByteArrayRO(env, javaAddresses));
+        if (addresses->get() == NULL) {
+            return -1;
+        }
+    }
+    size_t count = mmsgCount(byteOffsets.size(), byteCounts.size(), javaAddresses,
+            addresses.get() ? addresses->size() : 0);
+    if (count == 0) {
+        return 0;
+    }
+    if (!checkMmsgBuffers(env, bytes.size(), byteOffsets, byteCounts, count)) {
+        return -1;
+    }
+
+    sockaddr_storage ss[MAX_MMSG_COUNT];
+    socklen_t sa_len[MAX_MMSG_COUNT];
+    if (javaAddresses != NULL) {
+        for (size_t i = 0; i < count; ++i) {
+            sa_len[i] = packedSockaddrToSockaddr(addresses->get() + i * MMSG_ADDRESS_LENGTH, ss[i]);
+        }
+    }
+#if defined(__linux__)
+    mmsghdr msgs[MAX_MMSG_COUNT];
+    iovec iovs[MAX_MMSG_COUNT];
+    memset(msgs, 0, sizeof(mmsghdr) * count);
+    for (size_t i = 0; i < count; ++i) {
+        iovs[i].iov_base = const_cast<jbyte*>(bytes.get() + byteOffsets[i]);
+        iovs[i].iov_len = byteCounts[i];
+        msgs[i].msg_hdr.msg_iov = &iovs[i];
+        msgs[i].msg_hdr.msg_iovlen = 1;
+        if (javaAddresses != NULL) {
+            msgs[i].msg_hdr.msg_name = &ss[i];
+            msgs[i].msg_hdr.msg_namelen = sa_len[i];
+        }
+    }
+    return IO_FAILURE_RETRY(env, int, sendmmsg, javaFd, msgs, count, flags);
+#else
+    // Without sendmmsg(2) we send one datagram at a time, stopping at the first failure. As with
+    // sendmmsg(2), that failure is only reported if it happens to the first datagram.
+    jint sentCount = 0;
+    for (size_t i = 0; i < count; ++i) {
+        const sockaddr* to = (javaAddresses != NULL) ? reinterpret_cast<const sockaddr*>(&ss[i]) : NULL;
+        socklen_t toLength = (javaAddresses != NULL) ? sa_len[i] : 0;
+        ssize_t rc = IO_FAILURE_RETRY(env, ssize_t, sendto, javaFd, reinterpret_cast<const char*>(bytes.get() + byteOffsets[i]), byteCounts[i], flags, to, toLength);
+        if (rc == -1) {
+            if (sentCount > 0) {
+                env->ExceptionClear();
+                return sentCount;
+            }
+            return -1;
+        }
+        ++sentCount;
+    }
+    return sentCount;
+#endif
+}
+
 static jint Posix_sendtoBytes(JNIEnv* env, jobject, jobject javaFd, jobject javaBytes, jint byteOffset, jint byteCount, jint flags, jobject javaInetAddress, jint port) {
     ScopedBytesRO bytes(env, javaBytes);
     if (bytes.get() == NULL) {
@@ -1420,9 +2155,27 @@ static jint Posix_sendtoBytes(JNIEnv* env, jobject, jobject javaFd, jobject java
     }
     const sockaddr* to = (javaInetAddress != NULL) ? reinterpret_cast<const sockaddr*>(&ss) : NULL;
 #if !defined(__MINGW32__) && !defined(__MINGW64__)
-    return IO_FAILURE_RETRY(env, ssize_t, sendto, javaFd, bytes.get() + byteOffset, byteCount, flags, to, sa_len);
+    return countTransfer(IO_FAILURE_RETRY(env, ssize_t, sendto, javaFd, bytes.get() + byteOffset, byteCount, flags, to, sa_len));
 #else
-    return IO_FAILURE_RETRY(env, ssize_t, sendto, javaFd, reinterpret_cast<const char*>(bytes.get() + byteOffset), byteCount, flags, to, sa_len);
+    return countTransfer(IO_FAILURE_RETRY(env, ssize_t, sendto, javaFd, reinterpret_cast<const char*>(bytes.get() + byteOffset), byteCount, flags, to, sa_len));
+#endif
+}
+
+static jint Posix_sendtoBytesErrno(JNIEnv* env, jobject, jobject javaFd, jobject javaBytes, jint byteOffset, jint byteCount, jint flags, jobject javaInetAddress, jint port) {
+    ScopedBytesRO bytes(env, javaBytes);
+    if (bytes.get() == NULL) {
+        return -1;
+    }
+    sockaddr_storage ss;
+    socklen_t sa_len = 0;
+    if (javaInetAddress != NULL && !inetAddressToSockaddr(env, javaInetAddress, port, ss, sa_len)) {
+        return -1;
+    }
+    const sockaddr* to = (javaInetAddress != NULL) ? reinterpret_cast<const sockaddr*>(&ss) : NULL;
+#if !defined(__MINGW32__) && !defined(__MINGW64__)
+    return countTransfer(IO_ERRNO_RETRY(env, ssize_t, sendto, javaFd, bytes.get() + byteOffset, byteCount, flags, to, sa_len));
+#else
+    return countTransfer(IO_ERRNO_RETRY(env, ssize_t, sendto, javaFd, reinterpret_cast<const char*>(bytes.get() + byteOffset), byteCount, flags, to, sa_len));
 #endif
 }
 
@@ -1611,6 +2364,33 @@ static void Posix_setsockoptLinger(JNIEnv* env, jobject, jobject javaFd, jint le
 #endif
 }
 
+// Applies each (level, option, value) triple in 'javaLevelOptionValues' in turn, stopping at the
+// first failure, so configuring a new socket costs one native call rather than one per option.
+static void Posix_setsockoptMany(JNIEnv* env, jobject, jobject javaFd, jintArray javaLevelOptionValues) {
+    ScopedIntArrayRO levelOptionValues(env, javaLevelOptionValues);
+    if (levelOptionValues.get() == NULL) {
+        return;
+    }
+    if (levelOptionValues.size() % 3 != 0) {
+        jniThrowExceptionFmt(env, "java/lang/IllegalArgumentException",
+                "levelOptionValues.length %zd is not a multiple of 3", levelOptionValues.size());
+        return;
+    }
+    int fd = jniGetFDFromFileDescriptor(env, javaFd);
+    for (size_t i = 0; i < levelOptionValues.size(); i += 3) {
+        int value = levelOptionValues[i + 2];
+#if !defined(__MINGW32__) && !defined(__MINGW64__)
+        int rc = TEMP_FAILURE_RETRY(setsockopt(fd, levelOptionValues[i], levelOptionValues[i + 1], &value, sizeof(value)));
+#else
+        int rc = TEMP_FAILURE_RETRY(setsockopt(fd, levelOptionValues[i], levelOptionValues[i + 1], (char*)&value, sizeof(value)));
+#endif
+        if (rc == -1) {
+            throwErrnoException(env, "setsockopt");
+            return;
+        }
+    }
+}
+
 static void Posix_setsockoptTimeval(JNIEnv* env, jobject, jobject javaFd, jint level, jint option, jobject javaTimeval) {
     static jfieldID tvSecFid = env->GetFieldID(JniConstants::structTimevalClass, "tv_sec", "J");
     static jfieldID tvUsecFid = env->GetFieldID(JniConstants::structTimevalClass, "tv_usec", "J");
@@ -1663,6 +2443,25 @@ static jobject Posix_stat(JNIEnv* env, jobject, jstring javaPath) {
     return doStat(env, javaPath, false);
 }
 
+static void Posix_statInto(JNIEnv* env, jobject, jstring javaPath, jlongArray javaOut) {
+    if (env->GetArrayLength(javaOut) < STAT_FIELD_COUNT) {
+        jniThrowException(env, "java/lang/IllegalArgumentException", "out.length < 13");
+        return;
+    }
+    ScopedPathChars path(env, javaPath);
+    if (path.c_str() == NULL) {
+        return;
+    }
+    struct _stat sb;
+    if (TEMP_FAILURE_RETRY(u_stat(path.c_str(), &sb)) == -1) {
+        throwErrnoException(env, "stat");
+        return;
+    }
+    jlong fields[STAT_FIELD_COUNT];
+    statToFields(sb, fields);
+    env->SetLongArrayRegion(javaOut, 0, STAT_FIELD_COUNT, fields);
+}
+
 static jobject Posix_statvfs(JNIEnv* env, jobject, jstring javaPath) {
     ScopedPathChars path(env, javaPath);
     if (path.c_str() == NULL) {
@@ -1719,6 +2518,163 @@ static void Posix_tcsendbreak(JNIEnv* env, jobject, jobject javaFd, jint duratio
   throwIfMinusOne(env, "tcsendbreak", TEMP_FAILURE_RETRY(tcsendbreak(fd, duration)));
 }
 
+#if defined(__linux__)
+static pthread_key_t splicePipeKey;
+static pthread_once_t splicePipeKeyOnce = PTHREAD_ONCE_INIT;
+
+static void closeSplicePipe(void* value) {
+    int* fds = reinterpret_cast<int*>(value);
+    close(fds[0]);
+    close(fds[1]);
+    delete[] fds;
+}
+
+static void createSplicePipeKey() {
+    pthread_key_create(&splicePipeKey, closeSplicePipe);
+}
+
+/**
+ * Returns this thread's pipe for splicing between two non-pipe fds, creating it if necessary,
+ * or NULL with errno set. The pipe is always empty between calls to Posix_transfer.
+ */
+static int* getSplicePipe() {
+    pthread_once(&splicePipeKeyOnce, createSplicePipeKey);
+    int* fds = reinterpret_cast<int*>(pthread_getspecific(splicePipeKey));
+    if (fds == NULL) {
+        UniquePtr<int[]> newFds(new int[2]);
+        if (pipe2(newFds.get(), O_CLOEXEC) == -1) {
+            return NULL;
+        }
+        fds = newFds.release();
+        pthread_setspecific(splicePipeKey, fds);
+    }
+    return fds;
+}
+
+/**
+ * Discards this thread's pipe, because a failed transfer left data in it.
+ */
+static void discardSplicePipe() {
+    int* fds = reinterpret_cast<int*>(pthread_getspecific(splicePipeKey));
+    if (fds != NULL) {
+        pthread_setspecific(splicePipeKey, NULL);
+        closeSplicePipe(fds);
+    }
+}
+
+/**
+ * splice(2) between fds that may be sockets, retrying on EINTR unless either fd was closed via
+ * AsynchronousCloseMonitor::signalBlockedThreads, in which case this fails with EBADF.
+ */
+static ssize_t spliceFailureRetry(int inFd, loff_t* inOffset, int outFd, size_t byteCount) {
+    ssize_t rc;
+    do {
+        bool wasSignaled;
+        {
+            AsynchronousCloseMonitor inMonitor(inFd);
+            AsynchronousCloseMonitor outMonitor(outFd);
+            rc = splice(inFd, inOffset, outFd, NULL, byteCount, SPLICE_F_MOVE | SPLICE_F_MORE);
+            wasSignaled = inMonitor.wasSignaled() || outMonitor.wasSignaled();
+        }
+        if (wasSignaled) {
+            errno = EBADF;
+            return -1;
+        }
+    } while (rc == -1 && errno == EINTR);
+    return rc;
+}
+
+static ssize_t transferBySplice(int inFd, loff_t* inOffset, int outFd, size_t byteCount,
+        bool inIsPipe, bool outIsPipe) {
+    if (inIsPipe || outIsPipe) {
+        return spliceFailureRetry(inFd, inOffset, outFd, byteCount);
+    }
+    // Neither end is a pipe, so go through one of our own.
+    int* pipeFds = getSplicePipe();
+    if (pipeFds == NULL) {
+        return -1;
+    }
+    ssize_t filled = spliceFailureRetry(inFd, inOffset, pipeFds[1], byteCount);
+    if (filled <= 0) {
+        return filled;
+    }
+    ssize_t drained = 0;
+    while (drained < filled) {
+        ssize_t rc = spliceFailureRetry(pipeFds[0], NULL, outFd, filled - drained);
+        if (rc <= 0) {
+            // We've consumed input we can't deliver. Make sure it doesn't go to the next caller.
+            discardSplicePipe();
+            if (drained > 0) {
+                return drained;
+            }
+            return -1;
+        }
+        drained += rc;
+    }
+    return drained;
+}
+#endif
+
+static jlong Posix_transfer(JNIEnv* env, jobject, jobject javaInFd, jobject javaInOffset, jobject javaOutFd, jlong byteCount) {
+#if defined(__linux__)
+    int inFd = jniGetFDFromFileDescriptor(env, javaInFd);
+    int outFd = jniGetFDFromFileDescriptor(env, javaOutFd);
+    struct stat64 inSb;
+    struct stat64 outSb;
+    if (TEMP_FAILURE_RETRY(fstat64(inFd, &inSb)) == -1 || TEMP_FAILURE_RETRY(fstat64(outFd, &outSb)) == -1) {
+        throwErrnoException(env, "fstat");
+        return -1;
+    }
+
+    jfieldID valueFid = gPosixIds.mutableLongValueFid;
+    loff_t offset = 0;
+    loff_t* offsetPtr = NULL;
+    if (javaInOffset != NULL) {
+        offset = env->GetLongField(javaInOffset, valueFid);
+        offsetPtr = &offset;
+    }
+
+    const char* syscallName;
+    ssize_t rc = -1;
+    errno = ENOSYS;
+    if (S_ISREG(inSb.st_mode) && S_ISREG(outSb.st_mode)) {
+        // File to file stays inside the kernel, and maybe inside the file system.
+#if defined(__NR_copy_file_range)
+        syscallName = "copy_file_range";
+        rc = TEMP_FAILURE_RETRY(syscall(__NR_copy_file_range, inFd, offsetPtr, outFd, NULL, byteCount, 0));
+#endif
+        // Kernels before 5.3 can't copy between file systems, older ones can't copy at all, and
+        // none will copy to an O_APPEND file (EBADF). sendfile(2) has been able to write to files
+        // since 2.6.33, and reports its own errors.
+        if (rc == -1 && (errno == ENOSYS || errno == EXDEV || errno == EINVAL || errno == EBADF)) {
+            syscallName = "sendfile";
+            rc = TEMP_FAILURE_RETRY(sendfile64(outFd, inFd, offsetPtr, byteCount));
+        }
+    } else if (S_ISREG(inSb.st_mode)) {
+        // File to socket (or pipe), with a 64-bit offset unlike Posix_sendfile.
+        syscallName = "sendfile";
+        rc = TEMP_FAILURE_RETRY(sendfile64(outFd, inFd, offsetPtr, byteCount));
+    } else {
+        // Socket to socket (or to file), via a pipe.
+        syscallName = "splice";
+        rc = transferBySplice(inFd, offsetPtr, outFd, byteCount,
+                S_ISFIFO(inSb.st_mode), S_ISFIFO(outSb.st_mode));
+    }
+    if (rc == -1) {
+        throwErrnoException(env, syscallName);
+        return -1;
+    }
+    if (javaInOffset != NULL) {
+        env->SetLongField(javaInOffset, valueFid, offset);
+    }
+    return rc;
+#else
+    errno = ENOSYS;
+    throwErrnoException(env, "transfer");
+    return -1;
+#endif
+}
+
 static jint Posix_umaskImpl(JNIEnv*, jobject, jint mask) {
     return umask(mask);
 }
@@ -1743,7 +2699,7 @@ static jint Posix_waitpid(JNIEnv* env, jobject, jint pid, jobject javaStatus, ji
     int status;
     int rc = throwIfMinusOne(env, "waitpid", TEMP_FAILURE_RETRY(waitpid(pid, &status, options)));
     if (rc != -1) {
-        static jfieldID valueFid = env->GetFieldID(JniConstants::mutableIntClass, "value", "I");
+        jfieldID valueFid = gPosixIds.mutableIntValueFid;
         env->SetIntField(javaStatus, valueFid, status);
     }
     return rc;
@@ -1754,7 +2710,15 @@ static jint Posix_writeBytes(JNIEnv* env, jobject, jobject javaFd, jbyteArray ja
     if (bytes.get() == NULL) {
         return -1;
     }
-    return IO_FAILURE_RETRY(env, ssize_t, write, javaFd, bytes.get() + byteOffset, byteCount);
+    return countTransfer(IO_FAILURE_RETRY(env, ssize_t, write, javaFd, bytes.get() + byteOffset, byteCount));
+}
+
+static jint Posix_writeBytesErrno(JNIEnv* env, jobject, jobject javaFd, jobject javaBytes, jint byteOffset, jint byteCount) {
+    ScopedBytesRO bytes(env, javaBytes);
+    if (bytes.get() == NULL) {
+        return -1;
+    }
+    return countTransfer(IO_ERRNO_RETRY(env, ssize_t, write, javaFd, bytes.get() + byteOffset, byteCount));
 }
 
 static jint Posix_writev(JNIEnv* env, jobject, jobject javaFd, jobjectArray buffers, jintArray offsets, jintArray byteCounts) {
@@ -1762,18 +2726,22 @@ static jint Posix_writev(JNIEnv* env, jobject, jobject javaFd, jobjectArray buff
     if (!ioVec.init(buffers, offsets, byteCounts)) {
         return -1;
     }
-    return IO_FAILURE_RETRY(env, ssize_t, writev, javaFd, ioVec.get(), ioVec.size());
+    return countTransfer(IO_VEC_FAILURE_RETRY(env, writev, javaFd, ioVec));
 }
 
 static JNINativeMethod gMethods[] = {
     NATIVE_METHOD(Posix, init, "()V"),
     NATIVE_METHOD(Posix, accept, "(Ljava/io/FileDescriptor;Ljava/net/InetSocketAddress;)Ljava/io/FileDescriptor;"),
+    NATIVE_METHOD(Posix, acceptErrno, "(Ljava/io/FileDescriptor;[BI)I"),
+    NATIVE_METHOD(Posix, acceptMany, "(Ljava/io/FileDescriptor;[I[BI)I"),
+    NATIVE_METHOD(Posix, acceptPacked, "(Ljava/io/FileDescriptor;[B)Ljava/io/FileDescriptor;"),
     NATIVE_METHOD(Posix, access, "(Ljava/lang/String;I)Z"),
     NATIVE_METHOD(Posix, bind, "(Ljava/io/FileDescriptor;Ljava/net/InetAddress;I)V"),
     NATIVE_METHOD(Posix, chmod, "(Ljava/lang/String;I)V"),
     NATIVE_METHOD(Posix, chown, "(Ljava/lang/String;II)V"),
     NATIVE_METHOD(Posix, close, "(Ljava/io/FileDescriptor;)V"),
     NATIVE_METHOD(Posix, connect, "(Ljava/io/FileDescriptor;Ljava/net/InetAddress;I)V"),
+    NATIVE_METHOD(Posix, connectErrno, "(Ljava/io/FileDescriptor;Ljava/net/InetAddress;I)I"),
     NATIVE_METHOD(Posix, dup, "(Ljava/io/FileDescriptor;)Ljava/io/FileDescriptor;"),
     NATIVE_METHOD(Posix, dup2, "(Ljava/io/FileDescriptor;I)Ljava/io/FileDescriptor;"),
     NATIVE_METHOD(Posix, environ, "()[Ljava/lang/String;"),
@@ -1797,6 +2765,7 @@ static JNINativeMethod gMethods[] = {
     NATIVE_METHOD(Posix, getenv, "(Ljava/lang/String;)Ljava/lang/String;"),
     NATIVE_METHOD(Posix, getnameinfo, "(Ljava/net/InetAddress;I)Ljava/lang/String;"),
     NATIVE_METHOD(Posix, getpeername, "(Ljava/io/FileDescriptor;)Ljava/net/SocketAddress;"),
+    NATIVE_METHOD(Posix, getpeernamePacked, "(Ljava/io/FileDescriptor;[B)V"),
     NATIVE_METHOD(Posix, getpid, "()I"),
     NATIVE_METHOD(Posix, getppid, "()I"),
     NATIVE_METHOD(Posix, getpwnam, "(Ljava/lang/String;)Landroid/system/StructPasswd;"),
@@ -1821,6 +2790,7 @@ static JNINativeMethod gMethods[] = {
     NATIVE_METHOD(Posix, listen, "(Ljava/io/FileDescriptor;I)V"),
     NATIVE_METHOD(Posix, lseek, "(Ljava/io/FileDescriptor;JI)J"),
     NATIVE_METHOD(Posix, lstat, "(Ljava/lang/String;)Landroid/system/StructStat;"),
+    NATIVE_METHOD(Posix, madvise, "(JJI)V"),
     NATIVE_METHOD(Posix, mincore, "(JJ[B)V"),
     NATIVE_METHOD(Posix, mkdir, "(Ljava/lang/String;I)V"),
     NATIVE_METHOD(Posix, mkfifo, "(Ljava/lang/String;I)V"),
@@ -1832,18 +2802,26 @@ static JNINativeMethod gMethods[] = {
     NATIVE_METHOD(Posix, open, "(Ljava/lang/String;II)Ljava/io/FileDescriptor;"),
     NATIVE_METHOD(Posix, pipe, "()[Ljava/io/FileDescriptor;"),
     NATIVE_METHOD(Posix, poll, "([Landroid/system/StructPollfd;I)I"),
+    NATIVE_METHOD(Posix, posix_fadvise, "(Ljava/io/FileDescriptor;JJI)V"),
     NATIVE_METHOD(Posix, posix_fallocate, "(Ljava/io/FileDescriptor;JJ)V"),
     NATIVE_METHOD(Posix, prctl, "(IJJJJ)I"),
     NATIVE_METHOD(Posix, preadBytes, "(Ljava/io/FileDescriptor;Ljava/lang/Object;IIJ)I"),
     NATIVE_METHOD(Posix, pwriteBytes, "(Ljava/io/FileDescriptor;Ljava/lang/Object;IIJ)I"),
     NATIVE_METHOD(Posix, readBytes, "(Ljava/io/FileDescriptor;Ljava/lang/Object;II)I"),
+    NATIVE_METHOD(Posix, readBytesErrno, "(Ljava/io/FileDescriptor;Ljava/lang/Object;II)I"),
+    NATIVE_METHOD(Posix, readahead, "(Ljava/io/FileDescriptor;JJ)V"),
     NATIVE_METHOD(Posix, readlink, "(Ljava/lang/String;)Ljava/lang/String;"),
     NATIVE_METHOD(Posix, readv, "(Ljava/io/FileDescriptor;[Ljava/lang/Object;[I[I)I"),
     NATIVE_METHOD(Posix, recvfromBytes, "(Ljava/io/FileDescriptor;Ljava/lang/Object;IIILjava/net/InetSocketAddress;)I"),
+    NATIVE_METHOD(Posix, recvfromBytesErrno, "(Ljava/io/FileDescriptor;Ljava/lang/Object;III[B)I"),
+    NATIVE_METHOD(Posix, recvfromBytesPacked, "(Ljava/io/FileDescriptor;Ljava/lang/Object;III[B)I"),
+    NATIVE_METHOD(Posix, recvmmsg, "(Ljava/io/FileDescriptor;[B[I[I[I[BI)I"),
     NATIVE_METHOD(Posix, remove, "(Ljava/lang/String;)V"),
     NATIVE_METHOD(Posix, rename, "(Ljava/lang/String;Ljava/lang/String;)V"),
     NATIVE_METHOD(Posix, sendfile, "(Ljava/io/FileDescriptor;Ljava/io/FileDescriptor;Landroid/util/MutableLong;J)J"),
+    NATIVE_METHOD(Posix, sendmmsg, "(Ljava/io/FileDescriptor;[B[I[I[BI)I"),
     NATIVE_METHOD(Posix, sendtoBytes, "(Ljava/io/FileDescriptor;Ljava/lang/Object;IIILjava/net/InetAddress;I)I"),
+    NATIVE_METHOD(Posix, sendtoBytesErrno, "(Ljava/io/FileDescriptor;Ljava/lang/Object;IIILjava/net/InetAddress;I)I"),
     NATIVE_METHOD(Posix, setegid, "(I)V"),
     NATIVE_METHOD(Posix, setenv, "(Ljava/lang/String;Ljava/lang/String;Z)V"),
     NATIVE_METHOD(Posix, seteuid, "(I)V"),
@@ -1856,12 +2834,14 @@ static JNINativeMethod gMethods[] = {
     NATIVE_METHOD(Posix, setsockoptGroupReq, "(Ljava/io/FileDescriptor;IILandroid/system/StructGroupReq;)V"),
     NATIVE_METHOD(Posix, setsockoptGroupSourceReq, "(Ljava/io/FileDescriptor;IILandroid/system/StructGroupSourceReq;)V"),
     NATIVE_METHOD(Posix, setsockoptLinger, "(Ljava/io/FileDescriptor;IILandroid/system/StructLinger;)V"),
+    NATIVE_METHOD(Posix, setsockoptMany, "(Ljava/io/FileDescriptor;[I)V"),
     NATIVE_METHOD(Posix, setsockoptTimeval, "(Ljava/io/FileDescriptor;IILandroid/system/StructTimeval;)V"),
     NATIVE_METHOD(Posix, setuid, "(I)V"),
     NATIVE_METHOD(Posix, shutdown, "(Ljava/io/FileDescriptor;I)V"),
     NATIVE_METHOD(Posix, socket, "(III)Ljava/io/FileDescriptor;"),
     NATIVE_METHOD(Posix, socketpair, "(IIILjava/io/FileDescriptor;Ljava/io/FileDescriptor;)V"),
     NATIVE_METHOD(Posix, stat, "(Ljava/lang/String;)Landroid/system/StructStat;"),
+    NATIVE_METHOD(Posix, statInto, "(Ljava/lang/String;[J)V"),
     NATIVE_METHOD(Posix, statvfs, "(Ljava/lang/String;)Landroid/system/StructStatVfs;"),
     NATIVE_METHOD(Posix, strerror, "(I)Ljava/lang/String;"),
     NATIVE_METHOD(Posix, strsignal, "(I)Ljava/lang/String;"),
@@ -1869,13 +2849,16 @@ static JNINativeMethod gMethods[] = {
     NATIVE_METHOD(Posix, sysconf, "(I)J"),
     NATIVE_METHOD(Posix, tcdrain, "(Ljava/io/FileDescriptor;)V"),
     NATIVE_METHOD(Posix, tcsendbreak, "(Ljava/io/FileDescriptor;I)V"),
+    NATIVE_METHOD(Posix, transfer, "(Ljava/io/FileDescriptor;Landroid/util/MutableLong;Ljava/io/FileDescriptor;J)J"),
     NATIVE_METHOD(Posix, umaskImpl, "(I)I"),
     NATIVE_METHOD(Posix, uname, "()Landroid/system/StructUtsname;"),
     NATIVE_METHOD(Posix, unsetenv, "(Ljava/lang/String;)V"),
     NATIVE_METHOD(Posix, waitpid, "(ILandroid/util/MutableInt;I)I"),
     NATIVE_METHOD(Posix, writeBytes, "(Ljava/io/FileDescriptor;Ljava/lang/Object;II)I"),
+    NATIVE_METHOD(Posix, writeBytesErrno, "(Ljava/io/FileDescriptor;Ljava/lang/Object;II)I"),
     NATIVE_METHOD(Posix, writev, "(Ljava/io/FileDescriptor;[Ljava/lang/Object;[I[I)I"),
 };
 void register_libcore_io_Posix(JNIEnv* env) {
+    initPosixIds(env);
     jniRegisterNativeMethods(env, "libcore/io/Posix", gMethods, NELEM(gMethods));
 }
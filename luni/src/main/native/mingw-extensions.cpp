@@ -18,6 +18,8 @@
 #if defined(__MINGW32__) || defined(__MINGW64__)
 
 #include <map>
+#include <set>
+#include <vector>
 
 #include <io.h>
 #include <fcntl.h>
@@ -30,6 +32,7 @@
 
 #include "mingw-extensions.h"
 #include "ScopedLocalRef.h"
+#include "ScopedPthreadMutexLock.h"
 
 // If __PROVIDE_FIXMES is defined, every unimplemented function prints a FIXME message
 // Some functions are not implemented due to their uselessness in Java API, but they
@@ -220,17 +223,63 @@ DWORD mmap_file(const int prot)
     return desiredAccess;
 }
 
+#ifndef SEC_LARGE_PAGES
+#define SEC_LARGE_PAGES 0x80000000
+#endif
+#ifndef FILE_MAP_LARGE_PAGES
+#define FILE_MAP_LARGE_PAGES 0x20000000
+#endif
+
+// PrefetchVirtualMemory only exists from Windows 8, so we look it up at runtime. Our own copy
+// of WIN32_MEMORY_RANGE_ENTRY avoids depending on the headers' _WIN32_WINNT.
+struct PrefetchRange {
+    PVOID VirtualAddress;
+    SIZE_T NumberOfBytes;
+};
+typedef BOOL (WINAPI *PrefetchVirtualMemoryFunction)(HANDLE, ULONG_PTR, PrefetchRange*, ULONG);
+
+static void prefetch(void *addr, size_t len)
+{
+    static PrefetchVirtualMemoryFunction prefetchVirtualMemory =
+            (PrefetchVirtualMemoryFunction) GetProcAddress(GetModuleHandleA("kernel32.dll"),
+                                                           "PrefetchVirtualMemory");
+    if (prefetchVirtualMemory != NULL)
+    {
+        PrefetchRange range = { addr, len };
+        // This is only a hint, so failure isn't worth reporting.
+        prefetchVirtualMemory(GetCurrentProcess(), 1, &range, 0);
+    }
+}
+
 void* mmap(void *addr, size_t len, int prot, int flags, int fildes, off_t off)
 {
     HANDLE fm, h;
    
     void* map = MAP_FAILED;
 
+    if ((flags & MAP_HUGETLB) != 0)
+    {
+        // Large pages need SeLockMemoryPrivilege, and are only available for pagefile-backed
+        // sections. As on Linux, the length is rounded up to a whole number of large pages.
+        const SIZE_T largePage = GetLargePageMinimum();
+        if (largePage == 0 || (flags & MAP_ANONYMOUS) == 0)
+        {
+            errno = EINVAL;
+            return MAP_FAILED;
+        }
+        len = (len + largePage - 1) & ~(largePage - 1);
+    }
+
     const DWORD dwFileOffsetLow = (sizeof(off_t) <= sizeof(DWORD)) ? (DWORD)off : (DWORD)(off & 0xFFFFFFFFL);
     const DWORD dwFileOffsetHigh = (sizeof(off_t) <= sizeof(DWORD)) ? (DWORD)0 : (DWORD)((off >> 32) & 0xFFFFFFFFL);
     
-	const DWORD protect = mmap_page(prot);
-    const DWORD desiredAccess = mmap_file(prot);
+	DWORD protect = mmap_page(prot);
+    DWORD desiredAccess = mmap_file(prot);
+    if ((flags & MAP_HUGETLB) != 0)
+    {
+        protect |= SEC_COMMIT | SEC_LARGE_PAGES;
+        desiredAccess |= FILE_MAP_LARGE_PAGES;
+    }
 
     const off_t maxSize = off + (off_t)len;
 
@@ -271,6 +320,9 @@ void* mmap(void *addr, size_t len, int prot, int flags, int fildes, off_t off)
         return MAP_FAILED;
     }
 
+    if ((flags & MAP_POPULATE) != 0)
+        prefetch(map, len);
+
     return map;
 }
 
@@ -321,6 +373,21 @@ int mlock(const void *addr, size_t len)
 	}
 }
 
+int madvise(void *addr, size_t len, int advice)
+{
+    // Windows has no way to change the access pattern hint of an existing view, so we can
+    // only act on MADV_WILLNEED. Everything else is accepted and ignored, which is allowed
+    // since the advice is only a hint.
+    if (advice < MADV_NORMAL || advice > MADV_DONTNEED)
+    {
+        errno = EINVAL;
+        return -1;
+    }
+    if (advice == MADV_WILLNEED)
+        prefetch(addr, len);
+    return 0;
+}
+
 int munlock(const void *addr, size_t len)
 {
     if (VirtualUnlock((LPVOID)addr, len)) 
@@ -409,6 +476,17 @@ int posix_fallocate64(int fd, off64_t offset, off64_t len)
 	return -1;
 }
 
+int posix_fadvise64(int fd, off64_t offset, off64_t len, int advice)
+{
+    // FILE_FLAG_SEQUENTIAL_SCAN and FILE_FLAG_RANDOM_ACCESS can only be given when a file is
+    // opened, so as with madvise the advice is checked and then ignored.
+    if ((HANDLE)_get_osfhandle(fd) == INVALID_HANDLE_VALUE)
+        return EBADF;
+    if (offset < 0 || len < 0 || advice < POSIX_FADV_NORMAL || advice > POSIX_FADV_NOREUSE)
+        return EINVAL;
+    return 0;
+}
+
 // fdatasync
 
 int fdatasync(int fd)
@@ -1063,12 +1141,9 @@ static void map_select_results(struct pollfd *pArray, unsigned long n_fds,
     }
 }
 
-int poll(struct pollfd *fds, nfds_t nfds, int timeout)
+// Fallback for Windows versions without WSAPoll (before Vista). Limited to FD_SETSIZE sockets.
+static int select_poll(struct pollfd *fds, nfds_t nfds, int timeout)
 {
-	if (fds == NULL) {
-		errno = EFAULT;
-		return -1;
-	}
 	for (nfds_t i = 0; i < nfds; i++) {
 		if (fds[i].fd >= 0 && !is_socket(fds[i].fd)) {
 			errno = EBADF;
@@ -1111,6 +1186,123 @@ int poll(struct pollfd *fds, nfds_t nfds, int timeout)
     return ready_descriptors;
 }
 
+/* WSAPoll's WSAPOLLFD has the same layout as our struct pollfd, but Winsock uses its own values
+ * for the event bits. */
+#define WINSOCK_POLLERR			0x0001
+#define WINSOCK_POLLHUP			0x0002
+#define WINSOCK_POLLNVAL		0x0004
+#define WINSOCK_POLLWRNORM		0x0010
+#define WINSOCK_POLLWRBAND		0x0020
+#define WINSOCK_POLLRDNORM		0x0100
+#define WINSOCK_POLLRDBAND		0x0200
+
+typedef int (WSAAPI *WSAPollFunction)(struct pollfd *fds, ULONG nfds, INT timeout);
+
+static WSAPollFunction wsa_poll = NULL;
+static pthread_once_t wsa_poll_once = PTHREAD_ONCE_INIT;
+
+static void find_wsa_poll()
+{
+    // WSAPoll only exists on Vista and later, so look it up rather than link against it.
+    HMODULE ws2_32 = GetModuleHandleW(L"ws2_32.dll");
+    if (ws2_32 != NULL) {
+        wsa_poll = reinterpret_cast<WSAPollFunction>(GetProcAddress(ws2_32, "WSAPoll"));
+    }
+}
+
+static short poll_events_to_winsock(short events)
+{
+    short result = 0;
+    if (events & (POLLIN | POLLRDNORM)) result |= WINSOCK_POLLRDNORM;
+    // The Microsoft provider rejects POLLPRI; out-of-band data is reported as POLLRDBAND.
+    if (events & (POLLPRI | POLLRDBAND)) result |= WINSOCK_POLLRDBAND;
+    if (events & (POLLOUT | POLLWRNORM)) result |= WINSOCK_POLLWRNORM;
+    if (events & POLLWRBAND) result |= WINSOCK_POLLWRBAND;
+    return result;
+}
+
+static short winsock_events_to_poll(short events, short requested)
+{
+    short result = 0;
+    if (events & WINSOCK_POLLRDNORM) result |= POLLIN;
+    if (events & WINSOCK_POLLRDBAND) result |= (requested & POLLPRI) ? POLLPRI : POLLRDBAND;
+    if (events & WINSOCK_POLLWRNORM) result |= POLLOUT;
+    if (events & WINSOCK_POLLWRBAND) result |= POLLWRBAND;
+    if (events & WINSOCK_POLLERR) result |= POLLERR;
+    if (events & WINSOCK_POLLHUP) result |= POLLHUP;
+    if (events & WINSOCK_POLLNVAL) result |= POLLNVAL;
+    return result;
+}
+
+/* Uses WSAPoll where available, which has no limit on the number of sockets, and falls back to
+ * select() otherwise. As on POSIX, descriptors that aren't sockets (files, the console) are
+ * always ready for reading and writing. Negative descriptors are ignored. */
+int poll(struct pollfd *fds, nfds_t nfds, int timeout)
+{
+	if (fds == NULL) {
+		errno = EFAULT;
+		return -1;
+	}
+
+    pthread_once(&wsa_poll_once, find_wsa_poll);
+    if (wsa_poll == NULL) {
+        return select_poll(fds, nfds, timeout);
+    }
+
+    const nfds_t STACK_POLLFD_COUNT = 64;
+    struct pollfd stack_fds[STACK_POLLFD_COUNT];
+    std::vector<struct pollfd> heap_fds;
+    struct pollfd *winsock_fds = stack_fds;
+    if (nfds > STACK_POLLFD_COUNT) {
+        heap_fds.resize(nfds);
+        winsock_fds = &heap_fds[0];
+    }
+
+    int ready_files = 0;
+    nfds_t socket_count = 0;
+    for (nfds_t i = 0; i < nfds; i++) {
+        fds[i].revents = 0;
+        winsock_fds[i].fd = INVALID_SOCKET;
+        winsock_fds[i].events = 0;
+        winsock_fds[i].revents = 0;
+        if (static_cast<int>(fds[i].fd) < 0) {
+            continue;
+        }
+        if (!is_socket(fds[i].fd)) {
+            fds[i].revents = fds[i].events & (POLLIN | POLLRDNORM | POLLOUT | POLLWRNORM);
+            if (fds[i].revents != 0) {
+                ++ready_files;
+            }
+            continue;
+        }
+        winsock_fds[i].fd = fds[i].fd;
+        winsock_fds[i].events = poll_events_to_winsock(fds[i].events);
+        ++socket_count;
+    }
+
+    if (socket_count == 0) {
+        // WSAPoll fails with WSAEINVAL given nothing to do.
+        if (ready_files == 0 && timeout != 0) {
+            Sleep(timeout < 0 ? INFINITE : static_cast<DWORD>(timeout));
+        }
+        return ready_files;
+    }
+
+    int rc = wsa_poll(winsock_fds, nfds, ready_files > 0 ? 0 : timeout);
+    if (rc == SOCKET_ERROR) {
+        errno = windowsErrorToErrno(WSAGetLastError());
+        return -1;
+    }
+    if (rc > 0) {
+        for (nfds_t i = 0; i < nfds; i++) {
+            if (winsock_fds[i].revents != 0) {
+                fds[i].revents = winsock_events_to_poll(winsock_fds[i].revents, fds[i].events);
+            }
+        }
+    }
+    return rc + ready_files;
+}
+
 int socketpair(int domain, int type, int protocol, int sv[2])
 {
 	struct sockaddr_storage serverfd_addr, outsock_addr;
@@ -1233,28 +1425,208 @@ error_exit:
 
 // pread/pwrite/sendfile
 
-ssize_t pread64(int fd, void *buf, size_t count, off_t offset)
+// Descriptors opened by mingw_open_overlapped(). Only pread64/pwrite64 and mingw_close care.
+static std::set<int> overlapped_fds;
+static pthread_mutex_t overlapped_fds_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+static bool is_overlapped(int fd)
 {
-    ssize_t retval;
-    off_t saved_pos = lseek (fd, 0, SEEK_CUR);
+    pthread_mutex_lock(&overlapped_fds_mutex);
+    bool result = overlapped_fds.find(fd) != overlapped_fds.end();
+    pthread_mutex_unlock(&overlapped_fds_mutex);
+    return result;
+}
 
-    lseek (fd, offset, SEEK_SET);
-    retval = read(fd, buf, count);
-    lseek (fd, saved_pos, SEEK_SET);
+// Each thread waits for its overlapped operations on its own manual-reset event, created on
+// first use and closed when the thread exits.
+static pthread_key_t overlapped_event_key;
+static pthread_once_t overlapped_event_key_once = PTHREAD_ONCE_INIT;
 
-    return retval;    
+static void close_overlapped_event(void* event)
+{
+    CloseHandle(reinterpret_cast<HANDLE>(event));
 }
 
-ssize_t pwrite64(int fd, const void *buf, size_t count, off_t offset)
+static void create_overlapped_event_key()
+{
+    pthread_key_create(&overlapped_event_key, close_overlapped_event);
+}
+
+static HANDLE get_overlapped_event()
 {
-    ssize_t retval;
-    off_t saved_pos = lseek (fd, 0, SEEK_CUR);
+    pthread_once(&overlapped_event_key_once, create_overlapped_event_key);
+    HANDLE event = reinterpret_cast<HANDLE>(pthread_getspecific(overlapped_event_key));
+    if (event == NULL) {
+        event = CreateEvent(NULL, TRUE, FALSE, NULL);
+        if (event != NULL) {
+            pthread_setspecific(overlapped_event_key, event);
+        }
+    }
+    return event;
+}
 
-    lseek (fd, offset, SEEK_SET);
-    retval = write(fd, buf, count);
-    lseek (fd, saved_pos, SEEK_SET);
+int mingw_open_overlapped(const wchar_t *path, int flags, mode_t mode)
+{
+    DWORD access;
+    switch (flags & (O_RDONLY | O_WRONLY | O_RDWR)) {
+    case O_WRONLY:
+        access = GENERIC_WRITE;
+        break;
+    case O_RDWR:
+        access = GENERIC_READ | GENERIC_WRITE;
+        break;
+    default:
+        access = GENERIC_READ;
+        break;
+    }
 
-    return retval;
+    DWORD disposition;
+    if ((flags & O_CREAT) != 0) {
+        if ((flags & O_EXCL) != 0) {
+            disposition = CREATE_NEW;
+        } else if ((flags & O_TRUNC) != 0) {
+            disposition = CREATE_ALWAYS;
+        } else {
+            disposition = OPEN_ALWAYS;
+        }
+    } else {
+        disposition = ((flags & O_TRUNC) != 0) ? TRUNCATE_EXISTING : OPEN_EXISTING;
+    }
+
+    DWORD attributes = FILE_FLAG_OVERLAPPED;
+    attributes |= ((flags & O_CREAT) != 0 && (mode & S_IWRITE) == 0) ? FILE_ATTRIBUTE_READONLY
+                                                                     : FILE_ATTRIBUTE_NORMAL;
+
+    HANDLE h = CreateFileW(path, access, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+                           NULL, disposition, attributes, NULL);
+    if (h == INVALID_HANDLE_VALUE) {
+        errno = windowsErrorToErrno(GetLastError());
+        return -1;
+    }
+    int fd = _open_osfhandle(reinterpret_cast<intptr_t>(h), (flags & (O_WRONLY | O_RDWR)) | O_BINARY);
+    if (fd == -1) {
+        CloseHandle(h);
+        errno = EMFILE;
+        return -1;
+    }
+
+    pthread_mutex_lock(&overlapped_fds_mutex);
+    overlapped_fds.insert(fd);
+    pthread_mutex_unlock(&overlapped_fds_mutex);
+    return fd;
+}
+
+// pread/pwrite/sendfile
+
+/* A plain file handle has a single file pointer, which pread64/pwrite64 have to borrow (see
+ * positional_io). Everything that uses or moves it holds the descriptor's lock: positional I/O,
+ * and stream reads, writes and seeks via mingw_read, mingw_write and mingw_lseek64. Otherwise a
+ * pread racing a read() could leave the pointer somewhere else. The locks are striped by
+ * descriptor, so unrelated files rarely contend. */
+static const unsigned FILE_POINTER_LOCK_COUNT = 64;
+static pthread_mutex_t file_pointer_locks[FILE_POINTER_LOCK_COUNT];
+static pthread_once_t file_pointer_locks_once = PTHREAD_ONCE_INIT;
+
+static void init_file_pointer_locks()
+{
+    for (unsigned i = 0; i < FILE_POINTER_LOCK_COUNT; ++i) {
+        pthread_mutex_init(&file_pointer_locks[i], NULL);
+    }
+}
+
+static pthread_mutex_t* file_pointer_lock(int fd)
+{
+    pthread_once(&file_pointer_locks_once, init_file_pointer_locks);
+    return &file_pointer_locks[static_cast<unsigned>(fd) % FILE_POINTER_LOCK_COUNT];
+}
+
+// Only disk files have a file pointer worth protecting. Pipes and the console can block
+// indefinitely, and must not hold up positional I/O on other descriptors sharing the lock.
+static bool has_file_pointer(int fd)
+{
+    HANDLE h = reinterpret_cast<HANDLE>(_get_osfhandle(fd));
+    return h != INVALID_HANDLE_VALUE && GetFileType(h) == FILE_TYPE_DISK;
+}
+
+// Issues one ReadFile/WriteFile at 'offset', waiting for it to complete. 'event' must be
+// non-NULL for an overlapped handle. Returns a Windows error code.
+static DWORD transfer_at(HANDLE h, void *buf, DWORD length, off_t offset, HANDLE event,
+                         bool is_write, DWORD *transferred)
+{
+    OVERLAPPED ov;
+    memset(&ov, 0, sizeof(ov));
+    ov.Offset = static_cast<DWORD>(static_cast<uint64_t>(offset) & 0xffffffff);
+    ov.OffsetHigh = static_cast<DWORD>(static_cast<uint64_t>(offset) >> 32);
+    ov.hEvent = event;
+
+    *transferred = 0;
+    BOOL ok = is_write ? WriteFile(h, buf, length, transferred, &ov)
+                       : ReadFile(h, buf, length, transferred, &ov);
+    if (!ok && GetLastError() == ERROR_IO_PENDING) {
+        ok = GetOverlappedResult(h, &ov, transferred, TRUE);
+    }
+    return ok ? ERROR_SUCCESS : GetLastError();
+}
+
+/* POSIX pread/pwrite via ReadFile/WriteFile with the offset in an OVERLAPPED, so the transfer
+ * itself always happens at the requested offset. For a normal (synchronous) handle Windows still
+ * moves the file pointer past the transferred bytes, so we put it back afterwards, holding the
+ * descriptor's file pointer lock throughout. Descriptors from mingw_open_overlapped() have no
+ * file pointer, need no lock, and let several operations run concurrently. */
+static ssize_t positional_io(int fd, void *buf, size_t count, off_t offset, bool is_write)
+{
+    HANDLE h = reinterpret_cast<HANDLE>(_get_osfhandle(fd));
+    if (h == INVALID_HANDLE_VALUE) {
+        errno = EBADF;
+        return -1;
+    }
+    if (offset < 0) {
+        errno = EINVAL;
+        return -1;
+    }
+    // ReadFile/WriteFile take a DWORD count; a short transfer is always allowed.
+    DWORD length = (count > 0x7fffffff) ? 0x7fffffff : static_cast<DWORD>(count);
+
+    DWORD transferred;
+    DWORD error;
+    if (is_overlapped(fd)) {
+        HANDLE event = get_overlapped_event();
+        if (event == NULL) {
+            errno = windowsErrorToErrno(GetLastError());
+            return -1;
+        }
+        ResetEvent(event);
+        error = transfer_at(h, buf, length, offset, event, is_write, &transferred);
+    } else {
+        ScopedPthreadMutexLock lock(file_pointer_lock(fd));
+        LARGE_INTEGER zero;
+        zero.QuadPart = 0;
+        LARGE_INTEGER saved_pos;
+        if (!SetFilePointerEx(h, zero, &saved_pos, FILE_CURRENT)) {
+            errno = windowsErrorToErrno(GetLastError());
+            return -1;
+        }
+        error = transfer_at(h, buf, length, offset, NULL, is_write, &transferred);
+        SetFilePointerEx(h, saved_pos, NULL, FILE_BEGIN);
+    }
+
+    if (error == ERROR_HANDLE_EOF) {
+        return 0;
+    } else if (error != ERROR_SUCCESS) {
+        errno = windowsErrorToErrno(error);
+        return -1;
+    }
+    return transferred;
+}
+
+ssize_t pread64(int fd, void *buf, size_t count, off_t offset)
+{
+    return positional_io(fd, buf, count, offset, false);
+}
+
+ssize_t pwrite64(int fd, const void *buf, size_t count, off_t offset)
+{
+    return positional_io(fd, const_cast<void*>(buf), count, offset, true);
 }
 
 int _wlink(const wchar_t *path1, const wchar_t *path2)
@@ -1325,6 +1697,10 @@ int mingw_close(int fd)
 		socket_ext_data.erase(fd);
 	}
 
+    pthread_mutex_lock(&overlapped_fds_mutex);
+    overlapped_fds.erase(fd);
+    pthread_mutex_unlock(&overlapped_fds_mutex);
+
 	if (is_socket(fd)) {
         return closesocket(fd);
     } else {
@@ -1337,6 +1713,10 @@ ssize_t mingw_read(int fd, void *buf, size_t count)
 {
     if (!is_socket(fd))
     {
+        if (has_file_pointer(fd)) {
+            ScopedPthreadMutexLock lock(file_pointer_lock(fd));
+            return read(fd, buf, count);
+        }
         return read(fd, buf, count);
     } else {
         ssize_t result = recv(fd, (char*)buf, count, 0);
@@ -1349,6 +1729,10 @@ ssize_t mingw_write(int fd, const void *buf, size_t count)
 {
     if (!is_socket(fd))
     {
+        if (has_file_pointer(fd)) {
+            ScopedPthreadMutexLock lock(file_pointer_lock(fd));
+            return write(fd, buf, count);
+        }
         return write(fd, buf, count);
     } else {
         ssize_t result = send(fd, (char*)buf, count, 0);
@@ -1357,6 +1741,12 @@ ssize_t mingw_write(int fd, const void *buf, size_t count)
     }
 }
 
+off64_t mingw_lseek64(int fd, off64_t offset, int whence)
+{
+    ScopedPthreadMutexLock lock(file_pointer_lock(fd));
+    return lseek64(fd, offset, whence);
+}
+
 SOCKET mingw_socket(int af, int type, int protocol) {
 	static int is_old_windows = 0;
 	if (af != AF_INET6) {
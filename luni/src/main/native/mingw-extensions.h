@@ -142,6 +142,9 @@
 #define O_NONBLOCK				0x00004000
 #define O_SYNC					0x04100000
 
+// Not POSIX: opens a file for overlapped I/O (see mingw_open_overlapped)
+#define O_OVERLAPPED			0x20000000
+
 #define POLLIN					0x0001
 #define POLLPRI					0x0002
 #define POLLOUT					0x0004
@@ -358,9 +361,17 @@ int getpwuid_r(uid_t uid, struct passwd *pwd, char *buf, size_t buflen, struct p
 #define MAP_FIXED				0x10
 #define MAP_ANONYMOUS			0x20
 #define MAP_ANON				MAP_ANONYMOUS
+#define MAP_POPULATE			0x8000
+#define MAP_HUGETLB				0x40000
 
 #define MAP_FAILED				((void *)-1)
 
+#define MADV_NORMAL				0
+#define MADV_RANDOM				1
+#define MADV_SEQUENTIAL			2
+#define MADV_WILLNEED			3
+#define MADV_DONTNEED			4
+
 int mincore(void *addr, size_t length, unsigned char *vec);
 void* mmap(void *addr, size_t len, int prot, int flags, int fildes, off_t off);
 int munmap(void *addr, size_t len);
@@ -368,6 +379,7 @@ int mprotect(void *addr, size_t len, int prot);
 int msync(void *addr, size_t len, int flags);
 int mlock(const void *addr, size_t len);
 int munlock(const void *addr, size_t len);
+int madvise(void *addr, size_t len, int advice);
 
 // unistd.h
 
@@ -408,6 +420,15 @@ int fcntl(int fd, int cmd, ... /* arg */ );
 
 int posix_fallocate64(int fd, off64_t offset, off64_t len);
 
+#define POSIX_FADV_NORMAL		0
+#define POSIX_FADV_RANDOM		1
+#define POSIX_FADV_SEQUENTIAL	2
+#define POSIX_FADV_WILLNEED		3
+#define POSIX_FADV_DONTNEED		4
+#define POSIX_FADV_NOREUSE		5
+
+int posix_fadvise64(int fd, off64_t offset, off64_t len, int advice);
+
 // sys/ioctl.h
 
 int ioctl(int fd, int request, void *argp);
@@ -591,8 +612,17 @@ char *strsignal(int sig);
 // This is the emulation for POSIX close() (unfortunately, the 
 // default close() function in Windows doesn't close everything)
 int mingw_close(int fd);
+// read(), write() and lseek64() that also work on sockets where that makes sense, and that on
+// files hold the same lock as pread64() and pwrite64(), which temporarily move the file pointer.
 ssize_t mingw_read(int fd, void *buf, size_t count);
 ssize_t mingw_write(int fd, const void *buf, size_t count);
+off64_t mingw_lseek64(int fd, off64_t offset, int whence);
+
+/* Opens a file with FILE_FLAG_OVERLAPPED. pread64() and pwrite64() on the returned descriptor
+ * wait for completion on a per-thread event instead of the file pointer, so any number of
+ * threads can have positional I/O in flight on it at once. Windows keeps no file position for
+ * such handles, so read(), write() and lseek() don't work on it. */
+int mingw_open_overlapped(const wchar_t *path, int flags, mode_t mode);
 
 /* This emulates POSIX socket(); Windows has native implementation that works,
  * but we want more tricky implementation than that (differs on Windows version):
@@ -22,6 +22,7 @@
 #include "LocalArray.h"
 #include "Portability.h"
 #include "ScopedLocalRef.h"
+#include "ScopedPthreadMutexLock.h"
 #include "ScopedPrimitiveArray.h"
 #include "ScopedStringChars.h"
 #include "ScopedUtfChars.h"
@@ -29,31 +30,171 @@
 #include "jni.h"
 #include "cutils/log.h"
 #include "unicode/unistr.h"
+#include "unicode/ustring.h"
 
+#include <pthread.h>
+#include <stdlib.h>
 #include <string.h>
+#include <vector>
 #include <libexpat/expat.h>
 
-#define BUCKET_COUNT 128
-
 /**
- * Wrapper around an interned string.
+ * An open-addressing cache of interned strings, keyed by their UTF-8 bytes.
+ * The keys are copied into an arena owned by the table, so that no entry has
+ * to be allocated or freed individually.
  */
-struct InternedString {
-    InternedString() : interned(NULL), bytes(NULL) {
+class InternedStringTable {
+public:
+    InternedStringTable()
+            : entries(NULL), capacity(0), size(0), arenaNext(NULL), arenaRemaining(0) {
     }
 
-    ~InternedString() {
-        delete[] bytes;
+    ~InternedStringTable() {
+        delete[] entries;
+        for (size_t i = 0; i < arenaChunks.size(); ++i) {
+            delete[] arenaChunks[i];
+        }
     }
 
-    /** The interned string itself. */
-    jstring interned;
+    /**
+     * Calculates a hash code for a UTF-8 string using FNV-1a. This is *not*
+     * equivalent to Java's String.hashCode(). This hashes the bytes while
+     * String.hashCode() hashes UTF-16 chars.
+     */
+    static uint32_t hash(const char* s, size_t length) {
+        uint32_t hash = 2166136261U;
+        for (size_t i = 0; i < length; ++i) {
+            hash = (hash ^ static_cast<uint8_t>(s[i])) * 16777619U;
+        }
+        return hash;
+    }
+
+    /**
+     * Returns the interned string for the given bytes, or NULL if there isn't one.
+     */
+    jstring find(const char* s, size_t length, uint32_t hash) const {
+        if (capacity == 0) {
+            return NULL;
+        }
+        size_t mask = capacity - 1;
+        for (size_t i = hash & mask; entries[i].interned != NULL; i = (i + 1) & mask) {
+            const Entry& entry = entries[i];
+            if (entry.hash == hash && entry.length == length
+                    && memcmp(entry.bytes, s, length) == 0) {
+                return entry.interned;
+            }
+        }
+        return NULL;
+    }
+
+    /**
+     * Copies the given bytes into the arena, returning the null-terminated
+     * copy, or NULL if we ran out of memory.
+     */
+    const char* copyBytes(const char* s, size_t length) {
+        if (arenaRemaining < length + 1) {
+            size_t chunkSize = (length + 1 > ARENA_CHUNK_SIZE) ? length + 1 : ARENA_CHUNK_SIZE;
+            char* chunk = new char[chunkSize];
+            if (chunk == NULL) {
+                return NULL;
+            }
+            arenaChunks.push_back(chunk);
+            arenaNext = chunk;
+            arenaRemaining = chunkSize;
+        }
+        char* copy = arenaNext;
+        memcpy(copy, s, length);
+        copy[length] = '\0';
+        arenaNext += length + 1;
+        arenaRemaining -= length + 1;
+        return copy;
+    }
+
+    /**
+     * Adds an entry for 'bytes', which must have come from copyBytes. The
+     * table takes ownership of the global reference 'interned'. Returns false
+     * if we ran out of memory.
+     */
+    bool add(const char* bytes, size_t length, uint32_t hash, jstring interned) {
+        // Keep the load factor at or below 1/2, so probe sequences stay short.
+        if ((size + 1) * 2 > capacity && !resize(capacity == 0 ? INITIAL_CAPACITY : capacity * 2)) {
+            return false;
+        }
+        Entry entry = { bytes, length, hash, interned };
+        insert(entries, capacity, entry);
+        ++size;
+        return true;
+    }
+
+    /**
+     * Deletes the global references to all the interned strings.
+     */
+    void deleteGlobalRefs(JNIEnv* env) {
+        for (size_t i = 0; i < capacity; ++i) {
+            if (entries[i].interned != NULL) {
+                env->DeleteGlobalRef(entries[i].interned);
+                entries[i].interned = NULL;
+            }
+        }
+        size = 0;
+    }
 
-    /** UTF-8 equivalent of the interned string. */
-    const char* bytes;
+private:
+    static const size_t INITIAL_CAPACITY = 64;
+    static const size_t ARENA_CHUNK_SIZE = 4096;
+
+    struct Entry {
+        /** UTF-8 equivalent of the interned string, in the arena. */
+        const char* bytes;
+
+        /** Length of 'bytes', not including the null terminator. */
+        size_t length;
+
+        /** Hash code of 'bytes'. */
+        uint32_t hash;
+
+        /** The interned string itself, or NULL if this slot is empty. */
+        jstring interned;
+    };
 
-    /** Hash code of the interned string. */
-    int hash;
+    static void insert(Entry* table, size_t tableCapacity, const Entry& entry) {
+        size_t i = entry.hash & (tableCapacity - 1);
+        while (table[i].interned != NULL) {
+            i = (i + 1) & (tableCapacity - 1);
+        }
+        table[i] = entry;
+    }
+
+    bool resize(size_t newCapacity) {
+        Entry* newEntries = new Entry[newCapacity];
+        if (newEntries == NULL) {
+            return false;
+        }
+        memset(newEntries, 0, newCapacity * sizeof(Entry));
+        for (size_t i = 0; i < capacity; ++i) {
+            if (entries[i].interned != NULL) {
+                insert(newEntries, newCapacity, entries[i]);
+            }
+        }
+        delete[] entries;
+        entries = newEntries;
+        capacity = newCapacity;
+        return true;
+    }
+
+    /** Hash table slots. 'capacity' is always zero or a power of two. */
+    Entry* entries;
+    size_t capacity;
+    size_t size;
+
+    /** Arena holding the key bytes. */
+    std::vector<char*> arenaChunks;
+    char* arenaNext;
+    size_t arenaRemaining;
+
+    // Disallow copy and assignment.
+    InternedStringTable(const InternedStringTable&);
+    void operator=(const InternedStringTable&);
 };
 
 /**
@@ -98,14 +239,285 @@ private:
     int size;
 };
 
+/**
+ * Events recorded by a parser in batched mode. These values must match the
+ * EVENT_ constants in ExpatParser.java.
+ */
+enum BatchedEventType {
+    EVENT_START_ELEMENT = 1,    // uri, localName, qName, attributeCount, attributes...
+    EVENT_END_ELEMENT = 2,      // uri, localName, qName
+    EVENT_TEXT = 3,             // textOffset, textLength
+    EVENT_START_NAMESPACE = 4,  // prefix, uri
+    EVENT_END_NAMESPACE = 5     // prefix
+};
+
+/** Ints per attribute: uri, localName, qName, valueOffset, valueLength. */
+static const size_t BATCHED_ATTRIBUTE_SIZE = 5;
+
+static jmethodID handleEventsMethod;
+
+/**
+ * Records SAX events so that they can be delivered to Java in bulk, rather
+ * than making one upcall per event. Names are sent as indices into a String[]
+ * that we fill in as we first see each interned name; text is decoded into a
+ * shared char[].
+ */
+class EventBatch {
+public:
+    EventBatch()
+            : events(NULL), eventCount(0), text(NULL), textLength(0),
+              javaEvents(NULL), javaText(NULL), javaNames(NULL), javaNamesCapacity(0),
+              nameSlots(NULL), nameSlotCapacity(0) {
+    }
+
+    ~EventBatch() {
+        delete[] events;
+        delete[] text;
+        delete[] nameSlots;
+    }
+
+    /**
+     * Allocates the buffers. Returns false with an exception pending on
+     * failure.
+     */
+    bool init(JNIEnv* env) {
+        events = new jint[EVENT_CAPACITY];
+        text = new jchar[TEXT_CAPACITY];
+        if (events == NULL || text == NULL) {
+            jniThrowOutOfMemoryError(env, NULL);
+            return false;
+        }
+        javaEvents = newGlobalRef(env, env->NewIntArray(EVENT_CAPACITY));
+        if (javaEvents == NULL) return false;
+        javaText = newGlobalRef(env, env->NewCharArray(TEXT_CAPACITY));
+        if (javaText == NULL) return false;
+        return growJavaNames(env, INITIAL_NAME_CAPACITY);
+    }
+
+    bool isEnabled() const {
+        return events != NULL;
+    }
+
+    void deleteGlobalRefs(JNIEnv* env) {
+        env->DeleteGlobalRef(javaEvents);
+        env->DeleteGlobalRef(javaText);
+        env->DeleteGlobalRef(javaNames);
+        javaEvents = NULL;
+        javaText = NULL;
+        javaNames = NULL;
+    }
+
+    /**
+     * Makes room for an event of 'ints' ints and up to 'chars' chars,
+     * flushing to 'javaParser' if necessary. Returns false if the event is
+     * too big to batch, or if an exception is pending. In the former case the
+     * batch has been flushed, so the caller can deliver the event directly.
+     */
+    bool reserve(JNIEnv* env, jobject javaParser, size_t ints, size_t chars) {
+        if (ints > EVENT_CAPACITY || chars > TEXT_CAPACITY) {
+            flush(env, javaParser);
+            return false;
+        }
+        if (eventCount + ints > EVENT_CAPACITY || textLength + chars > TEXT_CAPACITY) {
+            flush(env, javaParser);
+        }
+        return !env->ExceptionCheck();
+    }
+
+    void add(jint value) {
+        events[eventCount++] = value;
+    }
+
+    /**
+     * Records the index of the given interned name. Returns false with an
+     * exception pending on failure.
+     */
+    bool addName(JNIEnv* env, jstring name) {
+        if (name == NULL) {
+            return false;
+        }
+        jint index = nameIndex(env, name);
+        if (index == -1) {
+            return false;
+        }
+        add(index);
+        return true;
+    }
+
+    /**
+     * Decodes UTF-8 text into the shared char[], and records its offset and
+     * length. The caller must have reserved 'byteCount' chars: the length in
+     * bytes is always >= the length in chars.
+     */
+    void addText(const char* utf8, size_t byteCount) {
+        UErrorCode status = U_ZERO_ERROR;
+        int32_t utf16Length = 0;
+        u_strFromUTF8(reinterpret_cast<UChar*>(text + textLength), TEXT_CAPACITY - textLength,
+                &utf16Length, utf8, byteCount, &status);
+        if (U_FAILURE(status)) {
+            utf16Length = 0;
+        }
+        add(textLength);
+        add(utf16Length);
+        textLength += utf16Length;
+    }
+
+    /**
+     * Delivers the recorded events to 'javaParser' and empties the batch.
+     */
+    void flush(JNIEnv* env, jobject javaParser) {
+        if (eventCount == 0 || env->ExceptionCheck()) {
+            discard();
+            return;
+        }
+        jint count = eventCount;
+        env->SetIntArrayRegion(javaEvents, 0, count, events);
+        env->SetCharArrayRegion(javaText, 0, textLength, text);
+        discard();
+        env->CallVoidMethod(javaParser, handleEventsMethod, javaEvents, count, javaText,
+                javaNames);
+    }
+
+    /** Drops any recorded events. */
+    void discard() {
+        eventCount = 0;
+        textLength = 0;
+    }
+
+private:
+    static const size_t EVENT_CAPACITY = 4096;
+    static const size_t TEXT_CAPACITY = 8192;
+    static const size_t INITIAL_NAME_CAPACITY = 64;
+
+    template <typename T>
+    static T newGlobalRef(JNIEnv* env, T localRef) {
+        if (localRef == NULL) {
+            return NULL;
+        }
+        T result = reinterpret_cast<T>(env->NewGlobalRef(localRef));
+        env->DeleteLocalRef(localRef);
+        return result;
+    }
+
+    /**
+     * Replaces javaNames with a String[] of the given capacity holding the
+     * names we've seen so far.
+     */
+    bool growJavaNames(JNIEnv* env, size_t newCapacity) {
+        jobjectArray newNames = newGlobalRef(env,
+                env->NewObjectArray(newCapacity, JniConstants::stringClass, NULL));
+        if (newNames == NULL) {
+            return false;
+        }
+        for (size_t i = 0; i < names.size(); ++i) {
+            env->SetObjectArrayElement(newNames, i, names[i]);
+        }
+        env->DeleteGlobalRef(javaNames);
+        javaNames = newNames;
+        javaNamesCapacity = newCapacity;
+        return true;
+    }
+
+    struct NameSlot {
+        jstring name;
+        jint index;
+    };
+
+    /** Hashes the reference, not the string: see nameIndex. */
+    static size_t hashName(jstring name) {
+        return static_cast<size_t>((reinterpret_cast<uintptr_t>(name) >> 3) * 2654435761U);
+    }
+
+    void insertNameSlot(jstring name, jint index) {
+        size_t mask = nameSlotCapacity - 1;
+        size_t i = hashName(name) & mask;
+        while (nameSlots[i].name != NULL) {
+            i = (i + 1) & mask;
+        }
+        nameSlots[i].name = name;
+        nameSlots[i].index = index;
+    }
+
+    bool rehashNames(JNIEnv* env, size_t newCapacity) {
+        NameSlot* newSlots = new NameSlot[newCapacity];
+        if (newSlots == NULL) {
+            jniThrowOutOfMemoryError(env, NULL);
+            return false;
+        }
+        memset(newSlots, 0, newCapacity * sizeof(NameSlot));
+        delete[] nameSlots;
+        nameSlots = newSlots;
+        nameSlotCapacity = newCapacity;
+        for (size_t i = 0; i < names.size(); ++i) {
+            insertNameSlot(names[i], i);
+        }
+        return true;
+    }
+
+    /**
+     * Returns the index of 'name' in javaNames, adding it if necessary, or
+     * -1 with an exception pending. Interned names are global references
+     * that stay unique for the life of the parsing context, so we can key on
+     * the reference itself.
+     */
+    jint nameIndex(JNIEnv* env, jstring name) {
+        if (nameSlotCapacity != 0) {
+            size_t mask = nameSlotCapacity - 1;
+            for (size_t i = hashName(name) & mask; nameSlots[i].name != NULL; i = (i + 1) & mask) {
+                if (nameSlots[i].name == name) {
+                    return nameSlots[i].index;
+                }
+            }
+        }
+
+        // A new name: publish it to Java, then remember its index.
+        jint index = names.size();
+        if (names.size() == javaNamesCapacity && !growJavaNames(env, javaNamesCapacity * 2)) {
+            return -1;
+        }
+        env->SetObjectArrayElement(javaNames, index, name);
+        if (env->ExceptionCheck()) {
+            return -1;
+        }
+        names.push_back(name);
+        if (names.size() * 2 > nameSlotCapacity) {
+            size_t newCapacity = (nameSlotCapacity == 0) ? INITIAL_NAME_CAPACITY * 2
+                                                         : nameSlotCapacity * 2;
+            if (!rehashNames(env, newCapacity)) {
+                return -1;
+            }
+        } else {
+            insertNameSlot(name, index);
+        }
+        return index;
+    }
+
+    jint* events;
+    size_t eventCount;
+    jchar* text;
+    size_t textLength;
+
+    jintArray javaEvents;
+    jcharArray javaText;
+    jobjectArray javaNames;
+    size_t javaNamesCapacity;
+
+    /** The names in javaNames, and a table from each name to its index. */
+    std::vector<jstring> names;
+    NameSlot* nameSlots;
+    size_t nameSlotCapacity;
+
+    // Disallow copy and assignment.
+    EventBatch(const EventBatch&);
+    void operator=(const EventBatch&);
+};
+
 /**
  * Data passed to parser handler method by the parser.
  */
 struct ParsingContext {
-    ParsingContext(jobject object) : env(NULL), object(object), buffer(NULL), bufferSize(-1) {
-        for (int i = 0; i < BUCKET_COUNT; i++) {
-            internedStrings[i] = NULL;
-        }
+    ParsingContext(jobject object)
+            : env(NULL), object(object), buffer(NULL), bufferSize(-1), useSharedNames(false) {
     }
 
     // Warning: 'env' must be valid on entry.
@@ -113,22 +525,9 @@ struct ParsingContext {
         freeBuffer();
 
         // Free interned string cache.
-        for (int i = 0; i < BUCKET_COUNT; i++) {
-            if (internedStrings[i]) {
-                InternedString** bucket = internedStrings[i];
-                InternedString* current;
-                while ((current = *(bucket++)) != NULL) {
-                    // Free the interned string reference.
-                    env->DeleteGlobalRef(current->interned);
-
-                    // Free the bucket.
-                    delete current;
-                }
+        internedStrings.deleteGlobalRefs(env);
 
-                // Free the buckets.
-                delete[] internedStrings[i];
-            }
-        }
+        eventBatch.deleteGlobalRefs(env);
     }
 
     jcharArray ensureCapacity(int length) {
@@ -190,9 +589,25 @@ public:
     StringStack stringStack;
 
     /** Cache of interned strings. */
-    InternedString** internedStrings[BUCKET_COUNT];
+    InternedStringTable internedStrings;
+
+    /** True if names should be looked up in (and added to) the shared cache. */
+    bool useSharedNames;
+
+    /** Events waiting to be delivered to Java, if batching is enabled. */
+    EventBatch eventBatch;
 };
 
+/**
+ * Delivers any batched events, so that an unbatched event that follows them
+ * isn't seen out of order. Returns false if an exception is pending.
+ */
+static bool flushBatchedEvents(ParsingContext* parsingContext) {
+    JNIEnv* env = parsingContext->env;
+    parsingContext->eventBatch.flush(env, parsingContext->object);
+    return !env->ExceptionCheck();
+}
+
 static ParsingContext* toParsingContext(void* data) {
     return reinterpret_cast<ParsingContext*>(data);
 }
@@ -227,52 +642,11 @@ static jmethodID unparsedEntityDeclMethod;
 static jstring emptyString;
 
 /**
- * Calculates a hash code for a null-terminated string. This is *not* equivalent
- * to Java's String.hashCode(). This hashes the bytes while String.hashCode()
- * hashes UTF-16 chars.
- *
- * @param s null-terminated string to hash
- * @returns hash code
- */
-static int hashString(const char* s) {
-    int hash = 0;
-    if (s) {
-        while (*s) {
-            hash = hash * 31 + *s++;
-        }
-    }
-    return hash;
-}
-
-/**
- * Creates a new interned string wrapper. Looks up the interned string
- * representing the given UTF-8 bytes.
- *
- * @param bytes null-terminated string to intern
- * @param hash of bytes
- * @returns wrapper of interned Java string
+ * Creates a global reference to the interned Java string equivalent of the
+ * given null-terminated UTF-8 string. Returns NULL with an exception pending
+ * on failure.
  */
-static InternedString* newInternedString(JNIEnv* env, const char* bytes, int hash) {
-    // Allocate a new wrapper.
-    UniquePtr<InternedString> wrapper(new InternedString);
-    if (wrapper.get() == NULL) {
-        jniThrowOutOfMemoryError(env, NULL);
-        return NULL;
-    }
-
-    // Create a copy of the UTF-8 bytes.
-    // TODO: sometimes we already know the length. Reuse it if so.
-    char* copy = new char[strlen(bytes) + 1];
-    if (copy == NULL) {
-        jniThrowOutOfMemoryError(env, NULL);
-        return NULL;
-    }
-    strcpy(copy, bytes);
-    wrapper->bytes = copy;
-
-    // Save the hash.
-    wrapper->hash = hash;
-
+static jstring newGlobalInternedString(JNIEnv* env, const char* bytes) {
     // To intern a string, we must first create a new string and then call
     // intern() on it. We then keep a global reference to the interned string.
     ScopedLocalRef<jstring> newString(env, env->NewStringUTF(bytes));
@@ -288,130 +662,162 @@ static InternedString* newInternedString(JNIEnv* env, const char* bytes, int has
     }
 
     // Create a global reference to the interned string.
-    wrapper->interned = reinterpret_cast<jstring>(env->NewGlobalRef(interned.get()));
+    jstring globalRef = reinterpret_cast<jstring>(env->NewGlobalRef(interned.get()));
     if (env->ExceptionCheck()) {
         return NULL;
     }
-
-    return wrapper.release();
+    return globalRef;
 }
 
 /**
- * Allocates a new bucket with one entry.
- *
- * @param entry to store in the bucket
- * @returns a reference to the bucket
+ * An entry in the shared name cache. Entries are immutable once published
+ * and are never freed.
  */
-static InternedString** newInternedStringBucket(InternedString* entry) {
-    InternedString** bucket = new InternedString*[2];
-    if (bucket != NULL) {
-        bucket[0] = entry;
-        bucket[1] = NULL;
-    }
-    return bucket;
-}
+struct SharedName {
+    uint32_t hash;
+    size_t length;
+    jstring interned;
+    char bytes[1];
+};
 
 /**
- * Expands an interned string bucket and adds the given entry. Frees the
- * provided bucket and returns a new one.
+ * A process-wide cache of interned names, shared by every parser that opted
+ * in when it was created. Services that parse many small documents with the
+ * same vocabulary then make no intern() calls once the cache is warm.
  *
- * @param existingBucket the bucket to replace
- * @param entry to add to the bucket
- * @returns a reference to the newly-allocated bucket containing the given entry
+ * Lookups are lock-free: slots only ever go from NULL to a published entry.
+ * Writers serialize on gSharedNamesMutex. The cache is bounded, since each
+ * entry holds a JNI global reference for the life of the process; once it is
+ * full, new names fall back to the per-parser table.
  */
-static InternedString** expandInternedStringBucket(
-        InternedString** existingBucket, InternedString* entry) {
-    // Determine the size of the existing bucket.
-    int size = 0;
-    while (existingBucket[size]) size++;
-
-    // Allocate the new bucket with enough space for one more entry and
-    // a null terminator.
-    InternedString** newBucket = new InternedString*[size + 2];
-    if (newBucket == NULL) return NULL;
-
-    memcpy(newBucket, existingBucket, size * sizeof(InternedString*));
-    newBucket[size] = entry;
-    newBucket[size + 1] = NULL;
-    delete[] existingBucket;
-
-    return newBucket;
+static const size_t SHARED_NAME_SLOTS = 2048;
+static const size_t SHARED_NAME_LIMIT = SHARED_NAME_SLOTS / 2;
+static SharedName* gSharedNames[SHARED_NAME_SLOTS];
+static size_t gSharedNameCount;
+static pthread_mutex_t gSharedNamesMutex = PTHREAD_MUTEX_INITIALIZER;
+static bool gSharedNamesEnabled;
+
+static bool sharedNameMatches(const SharedName* name, const char* s, size_t length,
+        uint32_t hash) {
+    return name->hash == hash && name->length == length && memcmp(name->bytes, s, length) == 0;
+}
+
+static jstring findSharedName(const char* s, size_t length, uint32_t hash) {
+    for (size_t i = hash & (SHARED_NAME_SLOTS - 1); ; i = (i + 1) & (SHARED_NAME_SLOTS - 1)) {
+        SharedName* name = __atomic_load_n(&gSharedNames[i], __ATOMIC_ACQUIRE);
+        if (name == NULL) {
+            return NULL;
+        }
+        if (sharedNameMatches(name, s, length, hash)) {
+            return name->interned;
+        }
+    }
 }
 
 /**
- * Returns an interned string for the given UTF-8 string.
- *
- * @param bucket to search for s
- * @param s null-terminated string to find
- * @param hash of s
- * @returns interned Java string equivalent of s or null if not found
+ * Adds a name to the shared cache. Returns NULL if the cache is full, or
+ * with an exception pending if we failed to create the Java string.
  */
-static jstring findInternedString(InternedString** bucket, const char* s, int hash) {
-    InternedString* current;
-    while ((current = *(bucket++)) != NULL) {
-        if (current->hash != hash) continue;
-        if (!strcmp(s, current->bytes)) return current->interned;
+static jstring addSharedName(JNIEnv* env, const char* s, size_t length, uint32_t hash) {
+    if (__atomic_load_n(&gSharedNameCount, __ATOMIC_RELAXED) >= SHARED_NAME_LIMIT) {
+        return NULL;
     }
-    return NULL;
+
+    // Do the JNI work before taking the lock; if we lose a race, we throw it away.
+    SharedName* newName = static_cast<SharedName*>(malloc(sizeof(SharedName) + length));
+    if (newName == NULL) {
+        jniThrowOutOfMemoryError(env, NULL);
+        return NULL;
+    }
+    memcpy(newName->bytes, s, length);
+    newName->bytes[length] = '\0';
+    newName->hash = hash;
+    newName->length = length;
+    newName->interned = newGlobalInternedString(env, newName->bytes);
+    if (newName->interned == NULL) {
+        free(newName);
+        return NULL;
+    }
+
+    ScopedPthreadMutexLock lock(&gSharedNamesMutex);
+    size_t i = hash & (SHARED_NAME_SLOTS - 1);
+    for (; gSharedNames[i] != NULL; i = (i + 1) & (SHARED_NAME_SLOTS - 1)) {
+        if (sharedNameMatches(gSharedNames[i], s, length, hash)) {
+            env->DeleteGlobalRef(newName->interned);
+            free(newName);
+            return gSharedNames[i]->interned;
+        }
+    }
+    if (gSharedNameCount >= SHARED_NAME_LIMIT) {
+        env->DeleteGlobalRef(newName->interned);
+        free(newName);
+        return NULL;
+    }
+    __atomic_store_n(&gSharedNames[i], newName, __ATOMIC_RELEASE);
+    __atomic_store_n(&gSharedNameCount, gSharedNameCount + 1, __ATOMIC_RELAXED);
+    return newName->interned;
 }
 
 /**
  * Returns an interned string for the given UTF-8 string.
  *
- * @param s null-terminated string to intern
- * @returns interned Java string equivelent of s or NULL if s is null
+ * @param s string to intern, null-terminated at 'length'
+ * @param length of s in bytes
+ * @returns interned Java string equivalent of s or NULL if s is null
  */
-static jstring internString(JNIEnv* env, ParsingContext* parsingContext, const char* s) {
+static jstring internString(JNIEnv* env, ParsingContext* parsingContext, const char* s,
+        size_t length) {
     if (s == NULL) return NULL;
 
-    int hash = hashString(s);
-    int bucketIndex = hash & (BUCKET_COUNT - 1);
-
-    InternedString*** buckets = parsingContext->internedStrings;
-    InternedString** bucket = buckets[bucketIndex];
-    InternedString* internedString;
-
-    if (bucket) {
-        // We have a bucket already. Look for the given string.
-        jstring found = findInternedString(bucket, s, hash);
-        if (found) {
-            // We found it!
-            return found;
+    uint32_t hash = InternedStringTable::hash(s, length);
+    if (parsingContext->useSharedNames) {
+        jstring shared = findSharedName(s, length, hash);
+        if (shared) {
+            return shared;
         }
+    }
 
-        // We didn't find it. :(
-        // Create a new entry.
-        internedString = newInternedString(env, s, hash);
-        if (internedString == NULL) return NULL;
+    InternedStringTable& table = parsingContext->internedStrings;
+    jstring found = table.find(s, length, hash);
+    if (found) {
+        return found;
+    }
 
-        // Expand the bucket.
-        bucket = expandInternedStringBucket(bucket, internedString);
-        if (bucket == NULL) {
-            delete internedString;
-            jniThrowOutOfMemoryError(env, NULL);
-            return NULL;
+    if (parsingContext->useSharedNames) {
+        jstring shared = addSharedName(env, s, length, hash);
+        if (shared || env->ExceptionCheck()) {
+            return shared;
         }
+    }
 
-        buckets[bucketIndex] = bucket;
-
-        return internedString->interned;
-    } else {
-        // We don't even have a bucket yet. Create an entry.
-        internedString = newInternedString(env, s, hash);
-        if (internedString == NULL) return NULL;
-
-        // Create a new bucket with one entry.
-        bucket = newInternedStringBucket(internedString);
-        if (bucket == NULL) {
-            delete internedString;
-            jniThrowOutOfMemoryError(env, NULL);
-            return NULL;
-        }
+    const char* bytes = table.copyBytes(s, length);
+    if (bytes == NULL) {
+        jniThrowOutOfMemoryError(env, NULL);
+        return NULL;
+    }
 
-        buckets[bucketIndex] = bucket;
+    jstring globalRef = newGlobalInternedString(env, bytes);
+    if (globalRef == NULL) {
+        return NULL;
+    }
 
-        return internedString->interned;
+    if (!table.add(bytes, length, hash, globalRef)) {
+        env->DeleteGlobalRef(globalRef);
+        jniThrowOutOfMemoryError(env, NULL);
+        return NULL;
     }
+    return globalRef;
+}
+
+/**
+ * Returns an interned string for the given UTF-8 string.
+ *
+ * @param s null-terminated string to intern
+ * @returns interned Java string equivalent of s or NULL if s is null
+ */
+static jstring internString(JNIEnv* env, ParsingContext* parsingContext, const char* s) {
+    if (s == NULL) return NULL;
+    return internString(env, parsingContext, s, strlen(s));
 }
 
 static void jniThrowExpatException(JNIEnv* env, XML_Error error) {
@@ -459,6 +865,7 @@ static void bufferAndInvoke(jmethodID method, void* data, const char* text, size
 
     // Bail out if a previously called handler threw an exception.
     if (env->ExceptionCheck()) return;
+    if (!flushBatchedEvents(parsingContext)) return;
 
     // Buffer the element name.
     size_t utf16length = fillBuffer(parsingContext, text, length);
@@ -518,9 +925,10 @@ public:
         }
 
         // return prefix + ":" + localName
-        ::LocalArray<1024> qName(strlen(mPrefix) + 1 + strlen(mLocalName) + 1);
+        size_t qNameLength = strlen(mPrefix) + 1 + strlen(mLocalName);
+        ::LocalArray<1024> qName(qNameLength + 1);
         snprintf(&qName[0], qName.size(), "%s:%s", mPrefix, mLocalName);
-        return internString(mEnv, mParsingContext, &qName[0]);
+        return internString(mEnv, mParsingContext, &qName[0], qNameLength);
     }
 
     /**
@@ -598,6 +1006,43 @@ private:
     void operator=(const ExpatElementName&);
 };
 
+/**
+ * Records a start element event in the parser's batch. Returns true if the
+ * event was batched or an exception is pending, and false if the caller
+ * should deliver the event directly.
+ */
+static bool batchStartElement(ParsingContext* parsingContext, jstring uri, jstring localName,
+        jstring qName, const char** attributes, int count) {
+    JNIEnv* env = parsingContext->env;
+    EventBatch& batch = parsingContext->eventBatch;
+
+    size_t valueBytes = 0;
+    for (int i = 0; i < count; ++i) {
+        valueBytes += strlen(attributes[i * 2 + 1]);
+    }
+    if (!batch.reserve(env, parsingContext->object, 5 + count * BATCHED_ATTRIBUTE_SIZE,
+            valueBytes)) {
+        return env->ExceptionCheck();
+    }
+
+    batch.add(EVENT_START_ELEMENT);
+    if (!batch.addName(env, uri) || !batch.addName(env, localName)
+            || !batch.addName(env, qName)) {
+        return true;
+    }
+    batch.add(count);
+    for (int i = 0; i < count; ++i) {
+        ExpatElementName name(env, parsingContext, attributes[i * 2]);
+        if (!batch.addName(env, name.uri()) || !batch.addName(env, name.localName())
+                || !batch.addName(env, name.qName())) {
+            return true;
+        }
+        const char* value = attributes[i * 2 + 1];
+        batch.addText(value, strlen(value));
+    }
+    return true;
+}
+
 /**
  * Called by Expat at the start of an element. Delegates to the same method
  * on the Java parser.
@@ -633,8 +1078,11 @@ static void startElement(void* data, const char* elementName, const char** attri
     parsingContext->stringStack.push(env, uri);
     parsingContext->stringStack.push(env, localName);
 
-    jlong attributesAddress = reinterpret_cast<jlong>(attributes);
-    env->CallVoidMethod(javaParser, startElementMethod, uri, localName, qName, attributesAddress, count);
+    if (!parsingContext->eventBatch.isEnabled()
+            || !batchStartElement(parsingContext, uri, localName, qName, attributes, count)) {
+        jlong attributesAddress = reinterpret_cast<jlong>(attributes);
+        env->CallVoidMethod(javaParser, startElementMethod, uri, localName, qName, attributesAddress, count);
+    }
 
     parsingContext->attributes = NULL;
     parsingContext->attributeCount = -1;
@@ -661,6 +1109,14 @@ static void endElement(void* data, const char* /*elementName*/) {
     jstring uri = parsingContext->stringStack.pop();
     jstring qName = parsingContext->stringStack.pop();
 
+    EventBatch& batch = parsingContext->eventBatch;
+    if (batch.isEnabled() && batch.reserve(env, javaParser, 4, 0)) {
+        batch.add(EVENT_END_ELEMENT);
+        batch.addName(env, uri) && batch.addName(env, localName) && batch.addName(env, qName);
+        return;
+    }
+    if (env->ExceptionCheck()) return;
+
     env->CallVoidMethod(javaParser, endElementMethod, uri, localName, qName);
 }
 
@@ -674,6 +1130,17 @@ static void endElement(void* data, const char* /*elementName*/) {
  * @param length number of characters in the buffer
  */
 static void text(void* data, const char* characters, int length) {
+    ParsingContext* parsingContext = toParsingContext(data);
+    JNIEnv* env = parsingContext->env;
+
+    EventBatch& batch = parsingContext->eventBatch;
+    if (batch.isEnabled() && !env->ExceptionCheck()
+            && batch.reserve(env, parsingContext->object, 3, length)) {
+        batch.add(EVENT_TEXT);
+        batch.addText(characters, length);
+        return;
+    }
+
     bufferAndInvoke(textMethod, data, characters, length);
 }
 
@@ -717,6 +1184,14 @@ static void startNamespace(void* data, const char* prefix, const char* uri) {
     parsingContext->stringStack.push(env, internedPrefix);
 
     jobject javaParser = parsingContext->object;
+    EventBatch& batch = parsingContext->eventBatch;
+    if (batch.isEnabled() && batch.reserve(env, javaParser, 3, 0)) {
+        batch.add(EVENT_START_NAMESPACE);
+        batch.addName(env, internedPrefix) && batch.addName(env, internedUri);
+        return;
+    }
+    if (env->ExceptionCheck()) return;
+
     env->CallVoidMethod(javaParser, startNamespaceMethod, internedPrefix, internedUri);
 }
 
@@ -737,6 +1212,14 @@ static void endNamespace(void* data, const char* /*prefix*/) {
     jstring internedPrefix = parsingContext->stringStack.pop();
 
     jobject javaParser = parsingContext->object;
+    EventBatch& batch = parsingContext->eventBatch;
+    if (batch.isEnabled() && batch.reserve(env, javaParser, 2, 0)) {
+        batch.add(EVENT_END_NAMESPACE);
+        batch.addName(env, internedPrefix);
+        return;
+    }
+    if (env->ExceptionCheck()) return;
+
     env->CallVoidMethod(javaParser, endNamespaceMethod, internedPrefix);
 }
 
@@ -751,6 +1234,7 @@ static void startCdata(void* data) {
 
     // Bail out if a previously called handler threw an exception.
     if (env->ExceptionCheck()) return;
+    if (!flushBatchedEvents(parsingContext)) return;
 
     jobject javaParser = parsingContext->object;
     env->CallVoidMethod(javaParser, startCdataMethod);
@@ -767,6 +1251,7 @@ static void endCdata(void* data) {
 
     // Bail out if a previously called handler threw an exception.
     if (env->ExceptionCheck()) return;
+    if (!flushBatchedEvents(parsingContext)) return;
 
     jobject javaParser = parsingContext->object;
     env->CallVoidMethod(javaParser, endCdataMethod);
@@ -783,6 +1268,7 @@ static void startDtd(void* data, const char* name,
 
     // Bail out if a previously called handler threw an exception.
     if (env->ExceptionCheck()) return;
+    if (!flushBatchedEvents(parsingContext)) return;
 
     jstring javaName = internString(env, parsingContext, name);
     if (env->ExceptionCheck()) return;
@@ -809,6 +1295,7 @@ static void endDtd(void* data) {
 
     // Bail out if a previously called handler threw an exception.
     if (env->ExceptionCheck()) return;
+    if (!flushBatchedEvents(parsingContext)) return;
 
     jobject javaParser = parsingContext->object;
     env->CallVoidMethod(javaParser, endDtdMethod);
@@ -827,6 +1314,7 @@ static void processingInstruction(void* data, const char* target, const char* in
 
     // Bail out if a previously called handler threw an exception.
     if (env->ExceptionCheck()) return;
+    if (!flushBatchedEvents(parsingContext)) return;
 
     jstring javaTarget = internString(env, parsingContext, target);
     if (env->ExceptionCheck()) return;
@@ -877,6 +1365,9 @@ static int handleExternalEntity(XML_Parser parser, const char* context,
     if (env->ExceptionCheck()) {
         return XML_STATUS_ERROR;
     }
+    if (!flushBatchedEvents(parsingContext)) {
+        return XML_STATUS_ERROR;
+    }
 
     ScopedLocalRef<jstring> javaSystemId(env, env->NewStringUTF(systemId));
     if (env->ExceptionCheck()) {
@@ -918,6 +1409,7 @@ static void unparsedEntityDecl(void* data, const char* name, const char* /*base*
 
     // Bail out if a previously called handler threw an exception.
     if (env->ExceptionCheck()) return;
+    if (!flushBatchedEvents(parsingContext)) return;
 
     ScopedLocalRef<jstring> javaName(env, env->NewStringUTF(name));
     if (env->ExceptionCheck()) return;
@@ -941,6 +1433,7 @@ static void notationDecl(void* data, const char* name, const char* /*base*/, con
 
     // Bail out if a previously called handler threw an exception.
     if (env->ExceptionCheck()) return;
+    if (!flushBatchedEvents(parsingContext)) return;
 
     ScopedLocalRef<jstring> javaName(env, env->NewStringUTF(name));
     if (env->ExceptionCheck()) return;
@@ -958,10 +1451,11 @@ static void notationDecl(void* data, const char* name, const char* /*base*/, con
  * @param object the Java ExpatParser instance
  * @param javaEncoding the character encoding name
  * @param processNamespaces true if the parser should handle namespaces
+ * @param batchEvents true if the parser should deliver events in bulk
  * @returns the pointer to the C Expat parser
  */
 static jlong ExpatParser_initialize(JNIEnv* env, jobject object, jstring javaEncoding,
-        jboolean processNamespaces) {
+        jboolean processNamespaces, jboolean batchEvents) {
     // Allocate parsing context.
     UniquePtr<ParsingContext> context(new ParsingContext(object));
     if (context.get() == NULL) {
@@ -970,6 +1464,15 @@ static jlong ExpatParser_initialize(JNIEnv* env, jobject object, jstring javaEnc
     }
 
     context->processNamespaces = processNamespaces;
+    context->useSharedNames = __atomic_load_n(&gSharedNamesEnabled, __ATOMIC_RELAXED);
+    if (batchEvents) {
+        // On failure, the context's destructor needs an env to clean up.
+        context->env = env;
+        if (!context->eventBatch.init(env)) {
+            return 0;
+        }
+        context->env = NULL;
+    }
 
     // Create a parser.
     XML_Parser parser;
@@ -1021,7 +1524,10 @@ static void append(JNIEnv* env, jobject object, jlong pointer,
     ParsingContext* context = toParsingContext(parser);
     context->env = env;
     context->object = object;
-    if (!XML_Parse(parser, bytes + byteOffset, byteCount, isFinal) && !env->ExceptionCheck()) {
+    XML_Status status = XML_Parse(parser, bytes + byteOffset, byteCount, isFinal);
+    // Deliver what we've batched from this chunk before reporting any error.
+    context->eventBatch.flush(env, object);
+    if (!status && !env->ExceptionCheck()) {
         jniThrowExpatException(env, XML_GetErrorCode(parser));
     }
     context->object = NULL;
@@ -1052,6 +1558,17 @@ static void ExpatParser_appendChars(JNIEnv* env, jobject object, jlong pointer,
     append(env, object, pointer, bytes, byteOffset, byteCount, XML_FALSE);
 }
 
+/**
+ * Parses bytes at a native address, such as those of a direct or mapped
+ * ByteBuffer. Expat parses straight from the caller's memory, copying only a
+ * trailing partial token into its own buffer.
+ */
+static void ExpatParser_appendAddress(JNIEnv* env, jobject object, jlong pointer,
+        jlong address, jint byteCount, jboolean isFinal) {
+    const char* bytes = reinterpret_cast<const char*>(static_cast<uintptr_t>(address));
+    append(env, object, pointer, bytes, 0, byteCount, isFinal);
+}
+
 static void ExpatParser_appendString(JNIEnv* env, jobject object, jlong pointer, jstring javaXml, jboolean isFinal) {
     ScopedStringChars xml(env, javaXml);
     if (xml.get() == NULL) {
@@ -1285,6 +1802,14 @@ static void ExpatAttributes_freeAttributes(JNIEnv*, jobject, jlong pointer) {
     delete[] reinterpret_cast<char*>(static_cast<uintptr_t>(pointer));
 }
 
+/**
+ * Controls whether parsers created from now on use the shared name cache.
+ * Names already in the cache stay there.
+ */
+static void ExpatParser_setSharedNameCacheEnabled(JNIEnv*, jobject, jboolean enabled) {
+    __atomic_store_n(&gSharedNamesEnabled, enabled == JNI_TRUE, __ATOMIC_RELAXED);
+}
+
 /**
  * Called when we initialize our Java parser class.
  *
@@ -1336,6 +1861,10 @@ static void ExpatParser_staticInitialize(JNIEnv* env, jobject classObject, jstri
         "(Ljava/lang/String;Ljava/lang/String;Ljava/lang/String;)V");
     if (handleExternalEntityMethod == NULL) return;
 
+    handleEventsMethod = env->GetMethodID(clazz, "handleEvents",
+        "([II[C[Ljava/lang/String;)V");
+    if (handleEventsMethod == NULL) return;
+
     notationDeclMethod = env->GetMethodID(clazz, "notationDecl",
             "(Ljava/lang/String;Ljava/lang/String;Ljava/lang/String;)V");
     if (notationDeclMethod == NULL) return;
@@ -1355,13 +1884,15 @@ static JNINativeMethod parserMethods[] = {
     NATIVE_METHOD(ExpatParser, appendString, "(JLjava/lang/String;Z)V"),
     NATIVE_METHOD(ExpatParser, appendBytes, "(J[BII)V"),
     NATIVE_METHOD(ExpatParser, appendChars, "(J[CII)V"),
+    NATIVE_METHOD(ExpatParser, appendAddress, "(JJIZ)V"),
     NATIVE_METHOD(ExpatParser, cloneAttributes, "(JI)J"),
     NATIVE_METHOD(ExpatParser, column, "(J)I"),
     NATIVE_METHOD(ExpatParser, createEntityParser, "(JLjava/lang/String;)J"),
-    NATIVE_METHOD(ExpatParser, initialize, "(Ljava/lang/String;Z)J"),
+    NATIVE_METHOD(ExpatParser, initialize, "(Ljava/lang/String;ZZ)J"),
     NATIVE_METHOD(ExpatParser, line, "(J)I"),
     NATIVE_METHOD(ExpatParser, release, "(J)V"),
     NATIVE_METHOD(ExpatParser, releaseParser, "(J)V"),
+    NATIVE_METHOD(ExpatParser, setSharedNameCacheEnabled, "(Z)V"),
     NATIVE_METHOD(ExpatParser, staticInitialize, "(Ljava/lang/String;)V"),
 };
 
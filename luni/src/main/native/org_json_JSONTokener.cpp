@@ -0,0 +1,304 @@
+/*
+ * Copyright (C) 2014 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#define LOG_TAG "JSONTokener"
+
+#include "JNIHelp.h"
+#include "JniConstants.h"
+#include "ScopedPrimitiveArray.h"
+#include "ScopedStringChars.h"
+#include "jni.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define JSON_SCAN_X86 1
+#elif defined(__aarch64__) && defined(__ARM_NEON)
+#include <arm_neon.h>
+#define JSON_SCAN_NEON 1
+#endif
+
+/*
+ * A structural index for JSONTokener, in the style of simdjson's first stage. For each block of
+ * 64 chars we produce three bitmaps, stored consecutively:
+ *
+ *   STRING_SPECIALS: the chars that can end or escape a string: '"', '\'' and '\\'.
+ *   LITERAL_ENDS: the chars that end an unquoted literal: "{}[]/\\:,=;# \t\f\r\n".
+ *   NON_WHITESPACE: everything but the whitespace nextClean skips: " \t\r\n".
+ *
+ * The tokener's grammar is lenient (single quotes, comments, unquoted strings), so which chars
+ * are inside strings can't be known without parsing. Rather than resolve that here, the tokener
+ * uses the bitmaps to jump straight to the next char that could matter in its current state.
+ */
+static const size_t STRING_SPECIALS = 0;
+static const size_t LITERAL_ENDS = 1;
+static const size_t NON_WHITESPACE = 2;
+static const size_t WORDS_PER_BLOCK = 3;
+
+static const uint8_t IS_STRING_SPECIAL = 1;
+static const uint8_t IS_LITERAL_END = 2;
+static const uint8_t IS_WHITESPACE = 4;
+
+static uint8_t classifyChar(jchar ch) {
+    switch (ch) {
+    case '"': case '\'':
+        return IS_STRING_SPECIAL;
+    case '\\':
+        return IS_STRING_SPECIAL | IS_LITERAL_END;
+    case ' ': case '\t': case '\r': case '\n':
+        return IS_LITERAL_END | IS_WHITESPACE;
+    case '{': case '}': case '[': case ']': case '/': case ':': case ',': case '=': case ';':
+    case '#': case '\f':
+        return IS_LITERAL_END;
+    default:
+        return 0;
+    }
+}
+
+// Indexes the 'length' (at most 64) chars of a block one at a time.
+static void scanBlockScalar(const jchar* chars, size_t length, uint64_t* words) {
+    uint64_t specials = 0;
+    uint64_t literalEnds = 0;
+    uint64_t nonWhitespace = 0;
+    for (size_t i = 0; i < length; ++i) {
+        uint8_t kind = classifyChar(chars[i]);
+        uint64_t bit = UINT64_C(1) << i;
+        if (kind & IS_STRING_SPECIAL) {
+            specials |= bit;
+        }
+        if (kind & IS_LITERAL_END) {
+            literalEnds |= bit;
+        }
+        if (!(kind & IS_WHITESPACE)) {
+            nonWhitespace |= bit;
+        }
+    }
+    words[STRING_SPECIALS] = specials;
+    words[LITERAL_ENDS] = literalEnds;
+    words[NON_WHITESPACE] = nonWhitespace;
+}
+
+/*
+ * The vector kernels narrow chars to bytes with saturation, so that every char above U+00FF
+ * becomes a byte (0x00 or 0xff) that isn't in any class, and then classify 16 or 32 bytes at a
+ * time by looking up their high and low nibbles: a byte is in a class if the entries for its
+ * two nibbles share a bit. Bits 0-4 stand for the LITERAL_ENDS chars with high nibbles 0, 2, 3,
+ * 5 and 7; bits 5 and 6 for the STRING_SPECIALS chars with high nibbles 2 and 5; and bit 7 for
+ * the whitespace with high nibble 0. The only remaining whitespace, ' ', is compared directly.
+ */
+static const uint8_t HIGH_NIBBLE_CLASSES[16] = {
+    0x81, 0, 0x22, 0x04, 0, 0x48, 0, 0x10, 0, 0, 0, 0, 0, 0, 0, 0,
+};
+static const uint8_t LOW_NIBBLE_CLASSES[16] = {
+    0x02,                // ' '
+    0,
+    0x20,                // '"'
+    0x02,                // '#'
+    0,
+    0,
+    0,
+    0x20,                // '\''
+    0,
+    0x81,                // '\t'
+    0x85,                // '\n' ':'
+    0x1c,                // ';' '[' '{'
+    0x4b,                // '\f' ',' '\\'
+    0x9d,                // '\r' '=' ']' '}'
+    0,
+    0x02,                // '/'
+};
+
+#if defined(JSON_SCAN_X86)
+
+static bool cpuHasSsse3() {
+    static const bool hasSsse3 = __builtin_cpu_supports("ssse3");
+    return hasSsse3;
+}
+
+static bool cpuHasAvx2() {
+    static const bool hasAvx2 = __builtin_cpu_supports("avx2");
+    return hasAvx2;
+}
+
+// Classifies 16 bytes, returning a 16-bit mask for each class.
+__attribute__((target("ssse3")))
+static inline void classifySsse3(__m128i bytes, uint32_t& specials, uint32_t& literalEnds,
+        uint32_t& whitespace) {
+    const __m128i highTable = _mm_loadu_si128(reinterpret_cast<const __m128i*>(HIGH_NIBBLE_CLASSES));
+    const __m128i lowTable = _mm_loadu_si128(reinterpret_cast<const __m128i*>(LOW_NIBBLE_CLASSES));
+    const __m128i nibbleMask = _mm_set1_epi8(0x0f);
+    __m128i high = _mm_and_si128(_mm_srli_epi16(bytes, 4), nibbleMask);
+    __m128i low = _mm_and_si128(bytes, nibbleMask);
+    __m128i classes = _mm_and_si128(_mm_shuffle_epi8(highTable, high), _mm_shuffle_epi8(lowTable, low));
+    __m128i zero = _mm_setzero_si128();
+    specials = ~_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_and_si128(classes, _mm_set1_epi8(0x60)), zero)) & 0xffff;
+    literalEnds = ~_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_and_si128(classes, _mm_set1_epi8(0x1f)), zero)) & 0xffff;
+    whitespace = _mm_movemask_epi8(_mm_or_si128(classes, _mm_cmpeq_epi8(bytes, _mm_set1_epi8(' '))));
+}
+
+// Indexes whole 64-char blocks. Returns the number of blocks indexed.
+__attribute__((target("ssse3")))
+static size_t scanBlocksSsse3(const jchar* chars, size_t blockCount, uint64_t* words) {
+    for (size_t block = 0; block < blockCount; ++block, chars += 64, words += WORDS_PER_BLOCK) {
+        uint64_t specials = 0;
+        uint64_t literalEnds = 0;
+        uint64_t whitespace = 0;
+        for (size_t i = 0; i < 64; i += 16) {
+            __m128i lo = _mm_loadu_si128(reinterpret_cast<const __m128i*>(chars + i));
+            __m128i hi = _mm_loadu_si128(reinterpret_cast<const __m128i*>(chars + i + 8));
+            uint32_t s, l, w;
+            classifySsse3(_mm_packus_epi16(lo, hi), s, l, w);
+            specials |= static_cast<uint64_t>(s) << i;
+            literalEnds |= static_cast<uint64_t>(l) << i;
+            whitespace |= static_cast<uint64_t>(w) << i;
+        }
+        words[STRING_SPECIALS] = specials;
+        words[LITERAL_ENDS] = literalEnds;
+        words[NON_WHITESPACE] = ~whitespace;
+    }
+    return blockCount;
+}
+
+__attribute__((target("avx2")))
+static size_t scanBlocksAvx2(const jchar* chars, size_t blockCount, uint64_t* words) {
+    const __m256i highTable = _mm256_broadcastsi128_si256(
+            _mm_loadu_si128(reinterpret_cast<const __m128i*>(HIGH_NIBBLE_CLASSES)));
+    const __m256i lowTable = _mm256_broadcastsi128_si256(
+            _mm_loadu_si128(reinterpret_cast<const __m128i*>(LOW_NIBBLE_CLASSES)));
+    const __m256i nibbleMask = _mm256_set1_epi8(0x0f);
+    const __m256i zero = _mm256_setzero_si256();
+    for (size_t block = 0; block < blockCount; ++block, chars += 64, words += WORDS_PER_BLOCK) {
+        uint64_t specials = 0;
+        uint64_t literalEnds = 0;
+        uint64_t whitespace = 0;
+        for (size_t i = 0; i < 64; i += 32) {
+            __m256i lo = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(chars + i));
+            __m256i hi = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(chars + i + 16));
+            // packus works within 128-bit lanes, so put the quadwords back in order afterwards.
+            __m256i bytes = _mm256_permute4x64_epi64(_mm256_packus_epi16(lo, hi), 0xd8);
+            __m256i high = _mm256_and_si256(_mm256_srli_epi16(bytes, 4), nibbleMask);
+            __m256i low = _mm256_and_si256(bytes, nibbleMask);
+            __m256i classes = _mm256_and_si256(_mm256_shuffle_epi8(highTable, high),
+                    _mm256_shuffle_epi8(lowTable, low));
+            uint32_t s = ~_mm256_movemask_epi8(
+                    _mm256_cmpeq_epi8(_mm256_and_si256(classes, _mm256_set1_epi8(0x60)), zero));
+            uint32_t l = ~_mm256_movemask_epi8(
+                    _mm256_cmpeq_epi8(_mm256_and_si256(classes, _mm256_set1_epi8(0x1f)), zero));
+            uint32_t w = _mm256_movemask_epi8(
+                    _mm256_or_si256(classes, _mm256_cmpeq_epi8(bytes, _mm256_set1_epi8(' '))));
+            specials |= static_cast<uint64_t>(s) << i;
+            literalEnds |= static_cast<uint64_t>(l) << i;
+            whitespace |= static_cast<uint64_t>(w) << i;
+        }
+        words[STRING_SPECIALS] = specials;
+        words[LITERAL_ENDS] = literalEnds;
+        words[NON_WHITESPACE] = ~whitespace;
+    }
+    return blockCount;
+}
+
+static size_t scanBlocksVector(const jchar* chars, size_t blockCount, uint64_t* words) {
+    if (cpuHasAvx2()) {
+        return scanBlocksAvx2(chars, blockCount, words);
+    }
+    if (cpuHasSsse3()) {
+        return scanBlocksSsse3(chars, blockCount, words);
+    }
+    return 0;
+}
+
+#elif defined(JSON_SCAN_NEON)
+
+// Packs the top bits of 64 bytes, each 0x00 or 0xff, into a 64-bit mask.
+static inline uint64_t neonMovemask64(uint8x16_t v0, uint8x16_t v1, uint8x16_t v2, uint8x16_t v3) {
+    const uint8x16_t bits = { 1, 2, 4, 8, 16, 32, 64, 128, 1, 2, 4, 8, 16, 32, 64, 128 };
+    uint8x16_t sum0 = vpaddq_u8(vandq_u8(v0, bits), vandq_u8(v1, bits));
+    uint8x16_t sum1 = vpaddq_u8(vandq_u8(v2, bits), vandq_u8(v3, bits));
+    sum0 = vpaddq_u8(sum0, sum1);
+    sum0 = vpaddq_u8(sum0, sum0);
+    return vgetq_lane_u64(vreinterpretq_u64_u8(sum0), 0);
+}
+
+static size_t scanBlocksVector(const jchar* chars, size_t blockCount, uint64_t* words) {
+    const uint8x16_t highTable = vld1q_u8(HIGH_NIBBLE_CLASSES);
+    const uint8x16_t lowTable = vld1q_u8(LOW_NIBBLE_CLASSES);
+    const uint8x16_t nibbleMask = vdupq_n_u8(0x0f);
+    for (size_t block = 0; block < blockCount; ++block, chars += 64, words += WORDS_PER_BLOCK) {
+        uint8x16_t specials[4];
+        uint8x16_t literalEnds[4];
+        uint8x16_t whitespace[4];
+        for (size_t i = 0; i < 4; ++i) {
+            const uint16_t* src = reinterpret_cast<const uint16_t*>(chars + 16 * i);
+            uint8x16_t bytes = vcombine_u8(vqmovn_u16(vld1q_u16(src)), vqmovn_u16(vld1q_u16(src + 8)));
+            uint8x16_t classes = vandq_u8(vqtbl1q_u8(highTable, vshrq_n_u8(bytes, 4)),
+                    vqtbl1q_u8(lowTable, vandq_u8(bytes, nibbleMask)));
+            specials[i] = vtstq_u8(classes, vdupq_n_u8(0x60));
+            literalEnds[i] = vtstq_u8(classes, vdupq_n_u8(0x1f));
+            whitespace[i] = vorrq_u8(vtstq_u8(classes, vdupq_n_u8(0x80)),
+                    vceqq_u8(bytes, vdupq_n_u8(' ')));
+        }
+        words[STRING_SPECIALS] = neonMovemask64(specials[0], specials[1], specials[2], specials[3]);
+        words[LITERAL_ENDS] = neonMovemask64(literalEnds[0], literalEnds[1], literalEnds[2], literalEnds[3]);
+        words[NON_WHITESPACE] = ~neonMovemask64(whitespace[0], whitespace[1], whitespace[2], whitespace[3]);
+    }
+    return blockCount;
+}
+
+#else
+
+static size_t scanBlocksVector(const jchar*, size_t, uint64_t*) {
+    return 0;
+}
+
+#endif
+
+// Fills in the WORDS_PER_BLOCK words for each of the (length + 63) / 64 blocks of 'chars'.
+// Bits past the end of the input are clear in all three bitmaps.
+static void scanJson(const jchar* chars, size_t length, uint64_t* words) {
+    size_t blockCount = length / 64;
+    size_t done = scanBlocksVector(chars, blockCount, words);
+    for (; done < blockCount; ++done) {
+        scanBlockScalar(chars + 64 * done, 64, words + WORDS_PER_BLOCK * done);
+    }
+    if (length % 64 != 0) {
+        scanBlockScalar(chars + 64 * blockCount, length % 64, words + WORDS_PER_BLOCK * blockCount);
+    }
+}
+
+static void JSONTokener_scan(JNIEnv* env, jclass, jstring javaIn, jlongArray javaIndex) {
+    ScopedStringChars in(env, javaIn);
+    if (in.get() == NULL) {
+        return;
+    }
+    ScopedLongArrayRW index(env, javaIndex);
+    if (index.get() == NULL) {
+        return;
+    }
+    if (index.size() < (in.size() + 63) / 64 * WORDS_PER_BLOCK) {
+        jniThrowException(env, "java/lang/ArrayIndexOutOfBoundsException", NULL);
+        return;
+    }
+    scanJson(in.get(), in.size(), reinterpret_cast<uint64_t*>(index.get()));
+}
+
+static JNINativeMethod gMethods[] = {
+    NATIVE_METHOD(JSONTokener, scan, "(Ljava/lang/String;[J)V"),
+};
+void register_org_json_JSONTokener(JNIEnv* env) {
+    jniRegisterNativeMethods(env, "org/json/JSONTokener", gMethods, NELEM(gMethods));
+}
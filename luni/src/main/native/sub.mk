@@ -4,12 +4,19 @@
 # or BUILD_*_LIBRARY.
 
 LOCAL_SRC_FILES := \
+    AsyncLogSink.cpp \
     AsynchronousCloseMonitor.cpp \
+    Base64Utilities.cpp \
+    CharsetUtilities.cpp \
     ExecStrings.cpp \
     IcuUtilities.cpp \
     JniException.cpp \
+    Lz4Frame.cpp \
+    NativeCounters.cpp \
     NetworkUtilities.cpp \
+    PowersOfFive.cpp \
     Register.cpp \
+    ZipChecksums.cpp \
     ZipUtilities.cpp \
     android_system_OsConstants.cpp \
     canonicalize_path.cpp \
@@ -36,6 +43,8 @@ LOCAL_SRC_FILES := \
     java_util_zip_CRC32.cpp \
     java_util_zip_Deflater.cpp \
     java_util_zip_Inflater.cpp \
+    java_util_zip_Lz4Compressor.cpp \
+    java_util_zip_Lz4Decompressor.cpp \
     libcore_icu_AlphabeticIndex.cpp \
     libcore_icu_DateIntervalFormat.cpp \
     libcore_icu_ICU.cpp \
@@ -49,9 +58,15 @@ LOCAL_SRC_FILES := \
     libcore_icu_TimeZoneNames.cpp \
     libcore_icu_Transliterator.cpp \
     libcore_io_AsynchronousCloseMonitor.cpp \
+    libcore_io_Base64.cpp \
+    libcore_io_EventPoller.cpp \
+    libcore_io_GroupCommit.cpp \
+    libcore_io_IoUring.cpp \
     libcore_io_Memory.cpp \
+    libcore_io_NativeCounters.cpp \
     libcore_io_Posix.cpp \
     org_apache_harmony_xml_ExpatParser.cpp \
+    org_json_JSONTokener.cpp \
     readlink.cpp \
     sun_misc_Unsafe.cpp \
     valueOf.cpp \
@@ -17,6 +17,7 @@
 package dalvik.system;
 
 import junit.framework.TestCase;
+import org.apache.harmony.dalvik.NativeTestTarget;
 
 /**
  * Test JNI behavior
@@ -365,4 +366,61 @@ public final class JniTest extends TestCase {
         // incorrect! the spec says this should be null. http://b/5652725
         assertEquals(Object.class, envGetSuperclass(Runnable.class));
     }
+
+    // The JniOverheadBenchmark targets should do what they claim, or the timings mean nothing.
+    public void testNativeTestTargetArrays() {
+        byte[] bytes = new byte[] { 7, 8 };
+        assertEquals(7, NativeTestTarget.pinByteArrayRO(bytes));
+        assertEquals(7, NativeTestTarget.pinByteArrayCritical(bytes));
+        assertEquals(7, NativeTestTarget.copyByteArrayRegion(bytes));
+        NativeTestTarget.pinByteArrayRW(bytes);
+        assertEquals(8, bytes[0]);
+        assertEquals(9, NativeTestTarget.pinIntArrayRO(new int[] { 9 }));
+
+        assertEquals(0, NativeTestTarget.pinByteArrayRO(new byte[0]));
+        assertEquals(0, NativeTestTarget.pinByteArrayCritical(new byte[0]));
+        assertEquals(0, NativeTestTarget.copyByteArrayRegion(new byte[0]));
+        NativeTestTarget.pinByteArrayRW(new byte[0]);
+        assertEquals(0, NativeTestTarget.pinIntArrayRO(new int[0]));
+    }
+
+    public void testNativeTestTargetStrings() {
+        assertEquals('h', NativeTestTarget.getStringChars("hello"));
+        assertEquals('h', NativeTestTarget.getStringUtfChars("hello"));
+        assertEquals('h', NativeTestTarget.copyStringRegion("hello"));
+        assertEquals(0, NativeTestTarget.getStringChars(""));
+        assertEquals(0, NativeTestTarget.getStringUtfChars(""));
+        assertEquals(0, NativeTestTarget.copyStringRegion(""));
+    }
+
+    public void testNativeTestTargetLocalRefs() {
+        Object[] objects = new Object[1000];
+        for (int i = 0; i < objects.length; i += 2) {
+            objects[i] = "x";
+        }
+        // More elements than the VM's local reference table holds, so each reference must be released.
+        assertEquals(500, NativeTestTarget.localRefFrame(objects));
+        assertEquals(500, NativeTestTarget.scopedLocalRefs(objects));
+    }
+
+    public void testNativeTestTargetNewResultObject() {
+        NativeTestTarget.Result result = NativeTestTarget.newResultObject(Long.MAX_VALUE, -1);
+        assertEquals(Long.MAX_VALUE, result.a);
+        assertEquals(-1, result.b);
+    }
+
+    public void testNativeTestTargetThrowException() {
+        try {
+            NativeTestTarget.throwException();
+            fail();
+        } catch (IllegalStateException expected) {
+            assertEquals("NativeTestTarget", expected.getMessage());
+        }
+        try {
+            NativeTestTarget.throwExceptionFmt(42);
+            fail();
+        } catch (IllegalStateException expected) {
+            assertEquals("NativeTestTarget 42", expected.getMessage());
+        }
+    }
 }
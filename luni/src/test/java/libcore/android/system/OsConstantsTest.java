@@ -28,4 +28,14 @@ public class OsConstantsTest extends TestCase {
 
         assertTrue(OsConstants.IFA_F_TENTATIVE > 0);
     }
+
+    public void testNativeValuesLineUpWithFields() throws Exception {
+        String[] names = OsConstants.names();
+        int[] values = OsConstants.values();
+        assertEquals(names.length, values.length);
+        for (int i = 0; i < names.length; ++i) {
+            assertEquals(names[i], values[i], OsConstants.class.getField(names[i]).getInt(null));
+        }
+        assertEquals("EAGAIN", OsConstants.errnoName(OsConstants.EAGAIN));
+    }
 }
@@ -16,6 +16,7 @@
 
 package libcore.icu;
 
+import java.util.Arrays;
 import java.util.Locale;
 
 public class AlphabeticIndexTest extends junit.framework.TestCase {
@@ -227,4 +228,58 @@ public class AlphabeticIndexTest extends junit.framework.TestCase {
     } catch (IllegalArgumentException expected) {
     }
   }
+
+  public void test_getBucketIndices() throws Exception {
+    AlphabeticIndex ai = new AlphabeticIndex(Locale.JAPANESE).addLabels(Locale.US);
+    AlphabeticIndex.ImmutableIndex ii = ai.getImmutableIndex();
+    String[] seeds = { "Allen", "smith", "\u3041", "\u30a1", "\u65e5", "\u1100", "", "Zed" };
+    // Enough names that the threaded version really uses threads.
+    String[] names = new String[20000];
+    for (int i = 0; i < names.length; ++i) {
+      names[i] = seeds[i % seeds.length] + i;
+    }
+    int[] expected = new int[names.length];
+    for (int i = 0; i < names.length; ++i) {
+      expected[i] = ii.getBucketIndex(names[i]);
+    }
+
+    int[] out = new int[names.length];
+    ii.getBucketIndices(names, out);
+    assertTrue(Arrays.equals(expected, out));
+    out = new int[names.length];
+    ai.getBucketIndices(names, out);
+    assertTrue(Arrays.equals(expected, out));
+    out = new int[names.length];
+    ai.getBucketIndices(names, out, 4);
+    assertTrue(Arrays.equals(expected, out));
+  }
+
+  public void test_getBucketIndices_invalid() throws Exception {
+    AlphabeticIndex ai = new AlphabeticIndex(Locale.US).addLabels(Locale.US);
+    try {
+      ai.getBucketIndices(new String[2], new int[1]);
+      fail();
+    } catch (IllegalArgumentException expected) {
+    }
+    try {
+      ai.getBucketIndices(new String[1], new int[1], 0);
+      fail();
+    } catch (IllegalArgumentException expected) {
+    }
+    String[] names = new String[5000];
+    Arrays.fill(names, "Allen");
+    names[4321] = null;
+    for (int threadCount = 1; threadCount <= 4; threadCount *= 4) {
+      try {
+        ai.getBucketIndices(names, new int[names.length], threadCount);
+        fail();
+      } catch (NullPointerException expected) {
+      }
+    }
+    try {
+      ai.getImmutableIndex().getBucketIndices(new String[] { null }, new int[1]);
+      fail();
+    } catch (NullPointerException expected) {
+    }
+  }
 }
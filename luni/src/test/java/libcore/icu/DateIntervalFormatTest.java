@@ -408,4 +408,34 @@ public class DateIntervalFormatTest extends junit.framework.TestCase {
     assertEquals("یکشنبه د ۱۹۸۰ د فبروري ۱۰", formatDateRange(new Locale("ps"), utc, thisYear, thisYear, flags));
     assertEquals("วันอาทิตย์ 10 กุมภาพันธ์ 1980", formatDateRange(new Locale("th"), utc, thisYear, thisYear, flags));
   }
+
+  public void test_formatDateRanges() throws Exception {
+    TimeZone tz = TimeZone.getTimeZone("UTC");
+    Locale en_US = new Locale("en", "US");
+    Calendar c = Calendar.getInstance(tz, en_US);
+    c.clear();
+    c.set(2009, Calendar.JANUARY, 19, 3, 30, 15);
+    long t = c.getTimeInMillis();
+    c.set(2009, Calendar.JANUARY, 20, 0, 0, 0);
+    long midnight = c.getTimeInMillis();
+
+    // Mix ranges needing different skeletons, including one whose end is moved back a day.
+    long[] starts = { t, t, t, t - YEAR, t };
+    long[] ends = { t + HOUR, t + 3 * DAY, midnight, t, t + HOUR };
+    int flags = FORMAT_SHOW_DATE | FORMAT_SHOW_TIME | FORMAT_SHOW_YEAR;
+    String[] formatted = formatDateRanges(en_US, tz, starts, ends, flags);
+    assertEquals(starts.length, formatted.length);
+    for (int i = 0; i < starts.length; ++i) {
+      assertEquals(formatDateRange(en_US, tz, starts[i], ends[i], flags), formatted[i]);
+    }
+    // The caller's array is left alone.
+    assertEquals(midnight, ends[2]);
+
+    assertEquals(0, formatDateRanges(en_US, tz, new long[0], new long[0], flags).length);
+    try {
+      formatDateRanges(en_US, tz, new long[1], new long[2], flags);
+      fail();
+    } catch (IllegalArgumentException expected) {
+    }
+  }
 }
@@ -16,6 +16,8 @@
 
 package libcore.icu;
 
+import java.util.Arrays;
+import java.util.Calendar;
 import java.util.Locale;
 
 public class LocaleDataTest extends junit.framework.TestCase {
@@ -129,4 +131,20 @@ public class LocaleDataTest extends junit.framework.TestCase {
     assertEquals("aK:mm", ja_JP.timeFormat12);
     assertEquals("H:mm", ja_JP.timeFormat24);
   }
+
+  public void testRegionalVariantsShareArrays() throws Exception {
+    LocaleData de_DE = LocaleData.get(new Locale("de", "DE"));
+    LocaleData de_CH = LocaleData.get(new Locale("de", "CH"));
+    assertTrue(Arrays.equals(de_DE.longWeekdayNames, de_CH.longWeekdayNames));
+    assertSame(de_DE.longWeekdayNames, de_CH.longWeekdayNames);
+    assertEquals(Integer.valueOf(Calendar.MONDAY), de_DE.firstDayOfWeek);
+  }
+
+  public void testBestDateTimePatternForManyLocales() throws Exception {
+    // Many more locales than the native generator cache holds.
+    for (Locale l : Locale.getAvailableLocales()) {
+      assertNotNull(l.toString(), ICU.getBestDateTimePattern("Hm", l));
+      assertNotNull(l.toString(), ICU.getBestDateTimePattern("hm", l));
+    }
+  }
 }
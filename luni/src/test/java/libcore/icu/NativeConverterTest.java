@@ -0,0 +1,63 @@
+/*
+ * Copyright (C) 2014 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+package libcore.icu;
+
+import java.nio.charset.Charset;
+import java.nio.charset.IllegalCharsetNameException;
+import java.util.Arrays;
+
+public class NativeConverterTest extends junit.framework.TestCase {
+  public void testCharsetForName() throws Exception {
+    Charset first = NativeConverter.charsetForName("UTF-8");
+    assertEquals("UTF-8", first.name());
+    // The second lookup is answered from the cache, and must give the same answer.
+    Charset second = NativeConverter.charsetForName("UTF-8");
+    assertEquals(first, second);
+    assertEquals(first.aliases(), second.aliases());
+  }
+
+  public void testCharsetForNameAliases() throws Exception {
+    Charset canonical = NativeConverter.charsetForName("ISO-8859-1");
+    for (String alias : Arrays.asList("latin1", "ISO8859_1", "iso-8859-1", "l1")) {
+      Charset charset = NativeConverter.charsetForName(alias);
+      assertEquals(alias, "ISO-8859-1", charset.name());
+      assertEquals(alias, canonical.aliases(), charset.aliases());
+    }
+    assertTrue(canonical.aliases().contains("latin1"));
+  }
+
+  public void testCharsetForNameUnsupported() throws Exception {
+    // Unknown names aren't cached, so no amount of them can fill the cache.
+    for (int i = 0; i < 1000; ++i) {
+      assertNull(NativeConverter.charsetForName("no-such-charset-" + i));
+    }
+    assertNull(NativeConverter.charsetForName("no-such-charset-0"));
+  }
+
+  public void testCharsetForNameBeyondCacheCapacity() throws Exception {
+    // Each ICU converter option makes a distinct canonical name. Java won't make charsets with
+    // names like these, but ICU has answered for them by then. Later lookups must still work.
+    for (int i = 0; i < 1000; ++i) {
+      try {
+        NativeConverter.charsetForName("x-UTF-8,locale=x" + i);
+      } catch (IllegalCharsetNameException expected) {
+      }
+    }
+    assertEquals("UTF-8", NativeConverter.charsetForName("UTF-8").name());
+    assertEquals("ISO-8859-1", NativeConverter.charsetForName("latin1").name());
+  }
+}
@@ -53,6 +53,18 @@ public class NativePluralRulesTest extends junit.framework.TestCase {
         assertEquals(NativePluralRules.MANY, npr.quantityForInt(111));
     }
 
+    public void testCachedInstances() throws Exception {
+        // Later instances for a locale are copies of a cached one, and must be independent.
+        NativePluralRules first = NativePluralRules.forLocale(new Locale("cs", "CZ"));
+        NativePluralRules second = NativePluralRules.forLocale(new Locale("cs", "CZ"));
+        assertNotSame(first, second);
+        first = null;
+        System.gc();
+        System.runFinalization();
+        assertEquals(NativePluralRules.FEW, second.quantityForInt(2));
+        assertEquals(NativePluralRules.OTHER, second.quantityForInt(5));
+    }
+
     public void testHebrew() throws Exception {
         // java.util.Locale will translate "he" to the deprecated "iw".
         NativePluralRules he = NativePluralRules.forLocale(new Locale("he"));
@@ -61,5 +73,14 @@ public class NativePluralRulesTest extends junit.framework.TestCase {
         assertEquals(NativePluralRules.OTHER, he.quantityForInt(3));
         assertEquals(NativePluralRules.OTHER, he.quantityForInt(10));
     }
-}
 
+    // More distinct locales than the native prototype cache keeps must still work.
+    public void testManyLocales() throws Exception {
+        for (int i = 0; i < 300; ++i) {
+            NativePluralRules npr = NativePluralRules.forLocale(new Locale("cs", "CZ", "V" + i));
+            assertEquals(NativePluralRules.ONE, npr.quantityForInt(1));
+            assertEquals(NativePluralRules.FEW, npr.quantityForInt(2));
+            assertEquals(NativePluralRules.OTHER, npr.quantityForInt(5));
+        }
+    }
+}
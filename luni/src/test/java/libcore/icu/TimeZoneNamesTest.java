@@ -60,6 +60,39 @@ public class TimeZoneNamesTest extends junit.framework.TestCase {
     }
   }
 
+  public void test_getDisplayNames() throws Exception {
+    // Look up single zones before (and after) the whole table for the locale is loaded.
+    Locale locale = new Locale("fr", "CA");
+    String[] ids = { "America/Montreal", "Europe/Paris", "Asia/Tokyo", "UTC" };
+    String[][] rows = new String[ids.length][];
+    for (int i = 0; i < ids.length; ++i) {
+      rows[i] = TimeZoneNames.getDisplayNames(locale, ids[i]);
+      assertEquals(ids[i], rows[i][TimeZoneNames.OLSON_NAME]);
+    }
+    assertNull(TimeZoneNames.getDisplayNames(locale, "Not/A_Zone"));
+    assertEquals("UTC", TimeZoneNames.getDisplayName(locale, "UTC", false, TimeZone.SHORT));
+
+    String[][] zoneStrings = TimeZoneNames.getZoneStrings(locale);
+    for (int i = 0; i < ids.length; ++i) {
+      String[] row = TimeZoneNames.getDisplayNames(locale, ids[i]);
+      assertTrue(Arrays.equals(rows[i], row));
+      for (int style : new int[] { TimeZone.SHORT, TimeZone.LONG }) {
+        for (boolean daylight : new boolean[] { false, true }) {
+          assertEquals(TimeZoneNames.getDisplayName(zoneStrings, ids[i], daylight, style),
+              TimeZoneNames.getDisplayName(locale, ids[i], daylight, style));
+        }
+      }
+    }
+
+    // Every row was filled in, however the work was split between threads.
+    String[] allIds = TimeZone.getAvailableIDs();
+    assertEquals(allIds.length, zoneStrings.length);
+    for (int i = 0; i < allIds.length; ++i) {
+      assertEquals(allIds[i], zoneStrings[i][TimeZoneNames.OLSON_NAME]);
+    }
+    assertNotNull(TimeZoneNames.getDisplayName(zoneStrings, allIds[allIds.length - 1], false, TimeZone.LONG));
+  }
+
   public void test_getExemplarLocation() throws Exception {
     assertEquals("Moscow", TimeZoneNames.getExemplarLocation("en_US", "Europe/Moscow"));
     assertEquals("Moskau", TimeZoneNames.getExemplarLocation("de_DE", "Europe/Moscow"));
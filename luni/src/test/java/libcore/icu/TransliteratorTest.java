@@ -56,6 +56,29 @@ public class TransliteratorTest extends junit.framework.TestCase {
     assertEquals("STRASSE", t.transliterate("Straße"));
   }
 
+  public void test_transliterate_array() throws Exception {
+    Transliterator t = new Transliterator("Any-Upper");
+    String[] result = t.transliterate(new String[] { "hello", "", "Straße" });
+    assertEquals(3, result.length);
+    assertEquals("HELLO", result[0]);
+    assertEquals("", result[1]);
+    assertEquals("STRASSE", result[2]);
+    assertEquals(0, t.transliterate(new String[0]).length);
+    try {
+      t.transliterate(new String[] { "a", null });
+      fail();
+    } catch (NullPointerException expected) {
+    }
+  }
+
+  public void test_cached_instances() throws Exception {
+    // Later instances with the same id come from a cache, but must behave the same.
+    Transliterator first = new Transliterator("Greek-Latin");
+    Transliterator second = new Transliterator("Greek-Latin");
+    assertEquals(first.transliterate("Καλημέρα"), second.transliterate("Καλημέρα"));
+    assertEquals("Kalēméra", second.transliterate("Καλημέρα"));
+  }
+
   public void test_Any_Lower() throws Exception {
     Transliterator t = new Transliterator("Any-Lower");
     assertEquals("hello world!", t.transliterate("HeLlO WoRlD!"));
@@ -17,7 +17,11 @@
 
 package libcore.io;
 
+import java.nio.BufferOverflowException;
+import java.nio.ByteBuffer;
+import java.nio.charset.StandardCharsets;
 import java.util.Arrays;
+import java.util.Random;
 import junit.framework.TestCase;
 
 public final class Base64Test extends TestCase {
@@ -44,6 +48,130 @@ public final class Base64Test extends TestCase {
         assertEncoded(expected, data);
     }
 
+    public void testDecodeLenient() throws Exception {
+        assertEquals("[18, 52, 86]", Arrays.toString(decode("EjRW")));
+        assertEquals("[18, 52]", Arrays.toString(decode("EjQ=")));
+        assertEquals("[18]", Arrays.toString(decode("Eg==")));
+        // Whitespace is ignored anywhere; padding (and whitespace after it) is optional.
+        assertEquals("[18, 52, 86, 120]", Arrays.toString(decode(" Ej\r\nRW\teA== \n")));
+        assertEquals("[18, 52, 86]", Arrays.toString(decode("EjRWeA")));
+        // Anything else is rejected.
+        assertNull(decode("EjR*"));
+        assertNull(decode("Ej=Q"));
+        assertNull(decode("===="));
+    }
+
+    public void testDecodeStrict() throws Exception {
+        assertEquals("[18, 52, 86, 120]", Arrays.toString(decodeStrict("EjRWeA==")));
+        assertEquals("[]", Arrays.toString(decodeStrict("")));
+        assertNull(decodeStrict("EjRWeA"));
+        assertNull(decodeStrict("EjRW\neA=="));
+        assertNull(decodeStrict("EjRWeA=A"));
+        assertNull(decodeStrict("EjRW===="));
+        // The unused bits of a partial final group must be zero.
+        assertNull(decodeStrict("EjRWeB=="));
+        assertNull(decodeStrict("EjR="));
+        assertEquals("[18, 52]", Arrays.toString(decodeStrict("EjQ=")));
+    }
+
+    public void testRoundTripLong() throws Exception {
+        // Long enough, at every alignment, to exercise the vector kernels and their tails.
+        Random random = new Random(1234);
+        for (int length = 0; length < 300; ++length) {
+            byte[] data = new byte[length];
+            random.nextBytes(data);
+            String encoded = Base64.encode(data);
+            assertEquals((length + 2) / 3 * 4, encoded.length());
+            assertTrue(Arrays.equals(data, decodeStrict(encoded)));
+            if (length > 0) {
+                assertTrue(Arrays.equals(data, decode(encoded)));
+            }
+        }
+    }
+
+    public void testDecodeRejectsBadCharInLongInput() throws Exception {
+        byte[] data = new byte[3000];
+        new Random(5678).nextBytes(data);
+        String encoded = Base64.encode(data);
+        for (int i = 0; i < encoded.length() - 2; i += 97) {
+            String bad = encoded.substring(0, i) + "\u00e9" + encoded.substring(i + 1);
+            assertNull(decode(bad));
+            assertNull(decodeStrict(bad));
+        }
+    }
+
+    public void testDecodeLongWrappedInput() throws Exception {
+        byte[] data = new byte[1000];
+        new Random(42).nextBytes(data);
+        String encoded = Base64.encode(data);
+        StringBuilder wrapped = new StringBuilder();
+        for (int i = 0; i < encoded.length(); i += 76) {
+            wrapped.append(encoded, i, Math.min(i + 76, encoded.length())).append("\r\n");
+        }
+        assertTrue(Arrays.equals(data, decode(wrapped.toString())));
+        assertNull(decodeStrict(wrapped.toString()));
+    }
+
+    public void testByteBuffers() throws Exception {
+        byte[] data = new byte[100];
+        new Random(99).nextBytes(data);
+        byte[] expected = Base64.encode(data).getBytes(StandardCharsets.US_ASCII);
+        for (int kind = 0; kind < 4; ++kind) {
+            ByteBuffer in = ((kind & 1) == 0) ? ByteBuffer.allocate(110) : ByteBuffer.allocateDirect(110);
+            ByteBuffer encoded = ((kind & 2) == 0) ? ByteBuffer.allocate(150) : ByteBuffer.allocateDirect(150);
+            in.position(5);
+            in.put(data);
+            in.position(5);
+            in.limit(105);
+            encoded.position(3);
+            assertEquals(expected.length, Base64.encode(in, encoded));
+            assertEquals(105, in.position());
+            assertEquals(3 + expected.length, encoded.position());
+            byte[] actual = new byte[expected.length];
+            encoded.position(3);
+            encoded.get(actual);
+            assertTrue(Arrays.equals(expected, actual));
+
+            encoded.position(3);
+            encoded.limit(3 + expected.length);
+            ByteBuffer decoded = ((kind & 1) == 0) ? ByteBuffer.allocateDirect(102) : ByteBuffer.allocate(102);
+            assertEquals(data.length, Base64.decode(encoded, decoded, true));
+            assertEquals(encoded.limit(), encoded.position());
+            assertEquals(data.length, decoded.position());
+            byte[] roundTrip = new byte[data.length];
+            decoded.flip();
+            decoded.get(roundTrip);
+            assertTrue(Arrays.equals(data, roundTrip));
+        }
+    }
+
+    public void testByteBufferErrors() throws Exception {
+        ByteBuffer in = ByteBuffer.wrap("EjR*".getBytes(StandardCharsets.US_ASCII));
+        ByteBuffer out = ByteBuffer.allocate(3);
+        assertEquals(-1, Base64.decode(in, out, false));
+        assertEquals(0, in.position());
+        assertEquals(0, out.position());
+        try {
+            Base64.decode(in, ByteBuffer.allocate(2), false);
+            fail();
+        } catch (BufferOverflowException expected) {
+        }
+        try {
+            Base64.encode(ByteBuffer.allocate(4), ByteBuffer.allocate(7));
+            fail();
+        } catch (BufferOverflowException expected) {
+        }
+    }
+
+    private static byte[] decode(String s) {
+        return Base64.decode(s.getBytes(StandardCharsets.ISO_8859_1));
+    }
+
+    private static byte[] decodeStrict(String s) {
+        byte[] bytes = s.getBytes(StandardCharsets.ISO_8859_1);
+        return Base64.decodeStrict(bytes, 0, bytes.length);
+    }
+
     public void assertEncoded(String expected , int... data) {
         byte[] dataBytes = new byte[data.length];
         for (int i = 0; i < data.length; i++) {
@@ -0,0 +1,72 @@
+/*
+ * Copyright (C) 2014 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+package libcore.io;
+
+import android.system.ErrnoException;
+import java.io.FileDescriptor;
+import junit.framework.TestCase;
+import static android.system.OsConstants.*;
+
+public class EventPollerTest extends TestCase {
+    public void testReadiness() throws Exception {
+        FileDescriptor[] pipe = Libcore.os.pipe();
+        EventPoller poller = new EventPoller();
+        try {
+            int[] ready = new int[8];
+            poller.add(pipe[0], POLLIN);
+            assertEquals(0, poller.poll(ready, 0));
+
+            Libcore.os.write(pipe[1], new byte[] { 1 }, 0, 1);
+            assertEquals(1, poller.poll(ready, 1000));
+            assertEquals(pipe[0].getInt$(), ready[0]);
+            assertTrue((ready[1] & POLLIN) != 0);
+
+            // Level-triggered: still readable until drained.
+            assertEquals(1, poller.poll(ready, 0));
+            poller.modify(pipe[0], 0);
+            assertEquals(0, poller.poll(ready, 0));
+
+            poller.modify(pipe[0], POLLIN);
+            assertEquals(1, poller.poll(ready, 0));
+            poller.remove(pipe[0]);
+            assertEquals(0, poller.poll(ready, 0));
+        } finally {
+            poller.close();
+            Libcore.os.close(pipe[0]);
+            Libcore.os.close(pipe[1]);
+        }
+    }
+
+    public void testCloseWakesPoller() throws Exception {
+        final EventPoller poller = new EventPoller();
+        new Thread(new Runnable() {
+            @Override public void run() {
+                try {
+                    Thread.sleep(500);
+                    poller.close();
+                } catch (Exception ignored) {
+                }
+            }
+        }).start();
+        try {
+            poller.poll(new int[2], -1);
+            fail();
+        } catch (ErrnoException expected) {
+            assertEquals(EINTR, expected.errno);
+        }
+    }
+}
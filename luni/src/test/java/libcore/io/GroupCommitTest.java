@@ -0,0 +1,80 @@
+/*
+ * Copyright (C) 2014 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+package libcore.io;
+
+import android.system.ErrnoException;
+import java.io.File;
+import java.io.FileDescriptor;
+import java.io.FileOutputStream;
+import java.util.concurrent.atomic.AtomicReference;
+import junit.framework.TestCase;
+import static android.system.OsConstants.*;
+
+public class GroupCommitTest extends TestCase {
+  public void testConcurrentSyncsAreCoalesced() throws Exception {
+    File f = File.createTempFile("GroupCommitTest", "tst");
+    final FileOutputStream fos = new FileOutputStream(f);
+    try {
+      final AtomicReference<Throwable> failure = new AtomicReference<Throwable>();
+      GroupCommit.Stats before = GroupCommit.stats();
+      Thread[] threads = new Thread[16];
+      for (int i = 0; i < threads.length; ++i) {
+        final boolean metadata = (i % 4 == 0);
+        threads[i] = new Thread() {
+          @Override public void run() {
+            try {
+              for (int j = 0; j < 20; ++j) {
+                fos.write(j);
+                if (metadata) {
+                  GroupCommit.fsync(fos.getFD());
+                } else {
+                  GroupCommit.fdatasync(fos.getFD());
+                }
+              }
+            } catch (Throwable t) {
+              failure.set(t);
+            }
+          }
+        };
+        threads[i].start();
+      }
+      for (Thread thread : threads) {
+        thread.join();
+      }
+      assertNull(failure.get());
+
+      GroupCommit.Stats after = GroupCommit.stats();
+      assertEquals(16 * 20, after.requests - before.requests);
+      long syncs = after.syncs - before.syncs;
+      assertTrue(syncs > 0 && syncs <= after.requests - before.requests);
+      assertTrue(after.waitNanos >= after.syncNanos);
+    } finally {
+      fos.close();
+      f.delete();
+    }
+  }
+
+  public void testClosedFd() throws Exception {
+    try {
+      GroupCommit.fdatasync(new FileDescriptor());
+      fail();
+    } catch (ErrnoException expected) {
+      assertEquals(EBADF, expected.errno);
+    }
+  }
+}
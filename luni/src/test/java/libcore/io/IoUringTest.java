@@ -0,0 +1,198 @@
+/*
+ * Copyright (C) 2014 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+package libcore.io;
+
+import java.io.File;
+import java.io.FileDescriptor;
+import java.io.InterruptedIOException;
+import java.nio.ByteBuffer;
+import junit.framework.TestCase;
+import static android.system.OsConstants.*;
+
+public class IoUringTest extends TestCase {
+    public void testWriteFsyncRead() throws Exception {
+        if (!IoUring.isSupported()) {
+            return;
+        }
+        File file = File.createTempFile("IoUringTest", null);
+        FileDescriptor fd = Libcore.os.open(file.getPath(), O_RDWR, 0);
+        IoUring ring = new IoUring(8);
+        try {
+            ByteBuffer out = ByteBuffer.allocateDirect(4);
+            out.put(new byte[] { 1, 2, 3, 4 }).flip();
+            assertTrue(ring.prepareWrite(fd, out, 0, 100));
+            assertEquals(1, ring.submit(1));
+            assertTrue(ring.prepareFsync(fd, true, 101));
+            assertEquals(1, ring.submit(1));
+
+            ByteBuffer in = ByteBuffer.allocateDirect(8);
+            assertTrue(ring.prepareRead(fd, in, 0, 102));
+            assertEquals(1, ring.submit(1));
+
+            long[] userData = new long[8];
+            int[] results = new int[8];
+            assertEquals(3, ring.reap(userData, results));
+            assertEquals(100, userData[0]);
+            assertEquals(4, results[0]);
+            assertEquals(101, userData[1]);
+            assertEquals(0, results[1]);
+            assertEquals(102, userData[2]);
+            assertEquals(4, results[2]);
+            assertEquals(3, in.get(2));
+            assertEquals(0, ring.reap(userData, results));
+        } finally {
+            ring.close();
+            Libcore.os.close(fd);
+            file.delete();
+        }
+    }
+
+    public void testRingFull() throws Exception {
+        if (!IoUring.isSupported()) {
+            return;
+        }
+        FileDescriptor fd = Libcore.os.open("/dev/null", O_RDONLY, 0);
+        IoUring ring = new IoUring(1);
+        try {
+            ByteBuffer buffer = ByteBuffer.allocateDirect(1);
+            assertTrue(ring.prepareRead(fd, buffer, -1, 1));
+            assertFalse(ring.prepareRead(fd, buffer, -1, 2));
+            assertEquals(1, ring.submit(1));
+            long[] userData = new long[1];
+            int[] results = new int[1];
+            assertEquals(1, ring.reap(userData, results));
+            assertEquals(1, userData[0]);
+            assertEquals(0, results[0]); // EOF.
+        } finally {
+            ring.close();
+            Libcore.os.close(fd);
+        }
+    }
+
+    public void testAnyUserData() throws Exception {
+        if (!IoUring.isSupported()) {
+            return;
+        }
+        FileDescriptor fd = Libcore.os.open("/dev/null", O_RDONLY, 0);
+        IoUring ring = new IoUring(4);
+        try {
+            ByteBuffer buffer = ByteBuffer.allocateDirect(1);
+            assertTrue(ring.prepareRead(fd, buffer, -1, Long.MIN_VALUE));
+            assertTrue(ring.prepareRead(fd, buffer, -1, Long.MAX_VALUE));
+            assertEquals(2, ring.submit(2));
+            long[] userData = new long[4];
+            int[] results = new int[4];
+            assertEquals(2, ring.reap(userData, results));
+            assertEquals(Long.MIN_VALUE, userData[0]);
+            assertEquals(Long.MAX_VALUE, userData[1]);
+        } finally {
+            ring.close();
+            Libcore.os.close(fd);
+        }
+    }
+
+    public void testAsynchronousCloseCancels() throws Exception {
+        if (!IoUring.isSupported()) {
+            return;
+        }
+        FileDescriptor[] pipe = Libcore.os.pipe();
+        final FileDescriptor readFd = pipe[0];
+        IoUring ring = new IoUring(4);
+        try {
+            assertTrue(ring.prepareRead(readFd, ByteBuffer.allocateDirect(1), -1, 7));
+            new Thread(new Runnable() {
+                @Override public void run() {
+                    try {
+                        Thread.sleep(500);
+                        IoBridge.closeAndSignalBlockedThreads(readFd);
+                    } catch (Exception ignored) {
+                    }
+                }
+            }).start();
+            try {
+                ring.submit(1);
+                fail();
+            } catch (InterruptedIOException expected) {
+            }
+            long[] userData = new long[4];
+            int[] results = new int[4];
+            int count = 0;
+            for (int i = 0; i < 100 && count == 0; ++i) {
+                count = ring.reap(userData, results);
+                Thread.sleep(10);
+            }
+            assertEquals(1, count);
+            assertEquals(7, userData[0]);
+            assertEquals(-ECANCELED, results[0]);
+        } finally {
+            ring.close();
+            Libcore.os.close(pipe[1]);
+        }
+    }
+
+    public void testAsynchronousCloseCancelsWhenFull() throws Exception {
+        if (!IoUring.isSupported()) {
+            return;
+        }
+        FileDescriptor[] pipe = Libcore.os.pipe();
+        final FileDescriptor readFd = pipe[0];
+        IoUring ring = new IoUring(8);
+        try {
+            // Fill every slot a caller can use with reads that won't complete by themselves.
+            ByteBuffer buffer = ByteBuffer.allocateDirect(1);
+            int count = 0;
+            while (true) {
+                if (!ring.prepareRead(readFd, buffer, -1, count)) {
+                    if (ring.submit(0) == 0 || !ring.prepareRead(readFd, buffer, -1, count)) {
+                        break;
+                    }
+                }
+                ++count;
+            }
+            assertTrue(count > 0);
+            new Thread(new Runnable() {
+                @Override public void run() {
+                    try {
+                        Thread.sleep(500);
+                        IoBridge.closeAndSignalBlockedThreads(readFd);
+                    } catch (Exception ignored) {
+                    }
+                }
+            }).start();
+            try {
+                ring.submit(1);
+                fail();
+            } catch (InterruptedIOException expected) {
+            }
+            long[] userData = new long[count];
+            int[] results = new int[count];
+            int reaped = 0;
+            for (int i = 0; i < 100 && reaped < count; ++i) {
+                int n = ring.reap(userData, results);
+                for (int j = 0; j < n; ++j) {
+                    assertEquals(-ECANCELED, results[j]);
+                }
+                reaped += n;
+                Thread.sleep(10);
+            }
+            assertEquals(count, reaped);
+        } finally {
+            ring.close();
+            Libcore.os.close(pipe[1]);
+        }
+    }
+}
@@ -18,6 +18,8 @@
 package libcore.io;
 
 import dalvik.system.VMRuntime;
+import java.nio.ByteBuffer;
+import java.nio.ByteOrder;
 import java.util.Arrays;
 import junit.framework.TestCase;
 
@@ -136,6 +138,143 @@ public class MemoryTest extends TestCase {
         }
     }
 
+    public void testSwappedArraysLongerThanVectorBlocks() {
+        // Enough elements for several 16-byte blocks plus a tail, at odd and even addresses.
+        VMRuntime runtime = VMRuntime.getRuntime();
+        byte[] array = (byte[]) runtime.newNonMovableArray(byte.class, 8 * 37 + 1);
+        long base_ptr = runtime.addressOf(array);
+        for (int ptr_offset = 0; ptr_offset < 2; ++ptr_offset) {
+            long ptr = base_ptr + ptr_offset;
+
+            long[] longs = new long[37];
+            for (int i = 0; i < longs.length; ++i) {
+                longs[i] = 0x0102030405060708L * (i + 1);
+            }
+            Memory.pokeLongArray(ptr, longs, 0, longs.length, true);
+            assertLongsEqual(longs, ptr, true);
+            long[] longsOut = new long[longs.length];
+            Memory.peekLongArray(ptr, longsOut, 0, longsOut.length, true);
+            assertTrue(Arrays.equals(longs, longsOut));
+
+            int[] ints = new int[2 * 37];
+            for (int i = 0; i < ints.length; ++i) {
+                ints[i] = 0x01020304 * (i + 1);
+            }
+            Memory.pokeIntArray(ptr, ints, 0, ints.length, true);
+            assertIntsEqual(ints, ptr, true);
+            int[] intsOut = new int[ints.length];
+            Memory.peekIntArray(ptr, intsOut, 0, intsOut.length, true);
+            assertTrue(Arrays.equals(ints, intsOut));
+
+            short[] shorts = new short[4 * 37];
+            for (int i = 0; i < shorts.length; ++i) {
+                shorts[i] = (short) (0x0102 * (i + 1));
+            }
+            Memory.pokeShortArray(ptr, shorts, 0, shorts.length, true);
+            assertShortsEqual(shorts, ptr, true);
+            short[] shortsOut = new short[shorts.length];
+            Memory.peekShortArray(ptr, shortsOut, 0, shortsOut.length, true);
+            assertTrue(Arrays.equals(shorts, shortsOut));
+        }
+    }
+
+    public void testStridedCopies() {
+        // Five records of { int id; short flags; long value; } packed into 14 bytes each.
+        final int stride = 14;
+        // Swapping makes the ids big-endian.
+        final boolean swap = ByteOrder.nativeOrder() != ByteOrder.BIG_ENDIAN;
+        byte[] records = new byte[5 * stride];
+        int[] ids = { 1, 2, 3, 0x01020304, -1 };
+        long[] values = { 10L, -20L, 0x0102030405060708L, Long.MIN_VALUE, 0 };
+        Memory.unsafeStridedPut(records, 0, stride, ids.length, ids, 0, SizeOf.INT, swap);
+        Memory.unsafeStridedPut(records, 6, stride, values.length, values, 0, SizeOf.LONG, false);
+        for (int i = 0; i < ids.length; ++i) {
+            assertEquals(ids[i], Memory.peekInt(records, i * stride, ByteOrder.BIG_ENDIAN));
+            assertEquals(values[i],
+                    Memory.peekLong(records, i * stride + 6, ByteOrder.nativeOrder()));
+        }
+
+        int[] idsOut = new int[ids.length + 1];
+        Memory.unsafeStridedGet(idsOut, 1, ids.length, records, 0, stride, SizeOf.INT, swap);
+        assertEquals(0, idsOut[0]);
+        assertTrue(Arrays.equals(ids, Arrays.copyOfRange(idsOut, 1, idsOut.length)));
+
+        // The same through native memory, at an odd address.
+        VMRuntime runtime = VMRuntime.getRuntime();
+        byte[] array = (byte[]) runtime.newNonMovableArray(byte.class, 2 * records.length + 1);
+        long ptr = runtime.addressOf(array) + 1;
+        Memory.pokeByteArray(ptr, records, 0, records.length);
+        long[] valuesOut = new long[values.length];
+        Memory.peekStrided(ptr + 6, stride, valuesOut, 0, values.length, SizeOf.LONG, false);
+        assertTrue(Arrays.equals(values, valuesOut));
+
+        // Gather the ids back into native order in a second copy.
+        long copy = ptr + records.length;
+        Memory.copyNative(copy, SizeOf.INT, ptr, stride, ids.length, SizeOf.INT, swap);
+        for (int i = 0; i < ids.length; ++i) {
+            assertEquals(ids[i], Memory.peekInt(copy + i * SizeOf.INT, false));
+        }
+        Memory.pokeStrided(ptr, stride, new short[] { 7, 8, 9, 10, 11 }, 0, 5, SizeOf.SHORT, false);
+        assertEquals(9, Memory.peekShort(ptr + 2 * stride, false));
+        Memory.copyNative(copy, SizeOf.INT, copy + SizeOf.INT, SizeOf.INT, 4, SizeOf.INT, false);
+        assertEquals(ids[4], Memory.peekInt(copy + 3 * SizeOf.INT, false));
+    }
+
+    public void testMemmoveSizes() {
+        // Inline, memmove, and (at 5MiB) non-temporal copies, overlapping or not.
+        int[] lengths = { 0, 1, 2, 3, 4, 7, 8, 15, 16, 17, 31, 32, 33, 4096, 5 * 1024 * 1024 };
+        for (int length : lengths) {
+            byte[] src = new byte[length];
+            for (int i = 0; i < length; ++i) {
+                src[i] = (byte) (i * 31 + 7);
+            }
+            ByteBuffer direct = ByteBuffer.allocateDirect(2 * length + 1);
+            direct.position(1);
+            direct.put(src);
+            ByteBuffer copy = ByteBuffer.allocateDirect(length);
+            direct.position(1);
+            direct.limit(1 + length);
+            copy.put(direct);
+            byte[] copied = new byte[length];
+            copy.flip();
+            copy.get(copied);
+            assertTrue(Arrays.equals(src, copied));
+
+            byte[] overlapping = new byte[length + 3];
+            System.arraycopy(src, 0, overlapping, 0, length);
+            Memory.memmove(overlapping, 3, overlapping, 0, length);
+            assertTrue(Arrays.equals(src, Arrays.copyOfRange(overlapping, 3, length + 3)));
+            Memory.memmove(overlapping, 0, overlapping, 3, length);
+            assertTrue(Arrays.equals(src, Arrays.copyOf(overlapping, length)));
+        }
+    }
+
+    public void testParallelMemmove() {
+        int length = 48 * 1024 * 1024 + 5;
+        ByteBuffer src = ByteBuffer.allocateDirect(length);
+        for (int i = 0; i < length; i += 4093) {
+            src.put(i, (byte) i);
+        }
+        ByteBuffer dst = ByteBuffer.allocateDirect(length);
+        Memory.setMaxCopyThreads(4);
+        try {
+            dst.put(src);
+        } finally {
+            Memory.setMaxCopyThreads(1);
+        }
+        src.flip();
+        dst.flip();
+        assertEquals(src, dst);
+    }
+
+    public void testSetMaxCopyThreads() {
+        try {
+            Memory.setMaxCopyThreads(0);
+            fail();
+        } catch (IllegalArgumentException expected) {
+        }
+    }
+
     private void assertShortsEqual(short[] expectedValues, long ptr, boolean swap) {
         for (int i = 0; i < expectedValues.length; ++i) {
             assertEquals(expectedValues[i], Memory.peekShort(ptr + SizeOf.SHORT * i, swap));
@@ -0,0 +1,60 @@
+/*
+ * Copyright (C) 2014 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+package libcore.io;
+
+import java.io.FileDescriptor;
+import junit.framework.TestCase;
+
+public class NativeCountersTest extends TestCase {
+    public void testSnapshot() throws Exception {
+        if (!NativeCounters.isEnabled()) {
+            assertTrue(NativeCounters.snapshot().isEmpty());
+            return;
+        }
+
+        FileDescriptor[] fds = Libcore.os.pipe();
+        try {
+            Libcore.os.write(fds[1], new byte[1], 0, 1);
+            Libcore.os.read(fds[0], new byte[1], 0, 1);
+            NativeCounters.Counter before = find("Posix.writeBytes");
+            for (int i = 0; i < 10; ++i) {
+                Libcore.os.write(fds[1], new byte[100], 0, 100);
+                Libcore.os.read(fds[0], new byte[100], 0, 100);
+            }
+            NativeCounters.Counter after = find("Posix.writeBytes");
+            assertEquals(before.calls + 10, after.calls);
+            assertEquals(before.bytes + 1000, after.bytes);
+            long histogramCalls = 0;
+            for (long count : after.histogram) {
+                histogramCalls += count;
+            }
+            assertEquals(after.calls, histogramCalls);
+        } finally {
+            Libcore.os.close(fds[0]);
+            Libcore.os.close(fds[1]);
+        }
+    }
+
+    private static NativeCounters.Counter find(String name) {
+        for (NativeCounters.Counter counter : NativeCounters.snapshot()) {
+            if (counter.name.equals(name)) {
+                return counter;
+            }
+        }
+        return null;
+    }
+}
@@ -16,16 +16,21 @@
 
 package libcore.io;
 
+import android.system.ErrnoException;
+import android.system.StructStat;
 import android.system.StructUcred;
 import java.io.File;
 import java.io.FileDescriptor;
 import java.io.FileInputStream;
+import java.io.FileOutputStream;
 import java.net.InetAddress;
 import java.net.InetSocketAddress;
 import java.net.InetUnixAddress;
 import java.net.ServerSocket;
 import java.net.SocketAddress;
+import java.util.Arrays;
 import java.util.Locale;
+import java.util.concurrent.atomic.AtomicBoolean;
 import junit.framework.TestCase;
 import static android.system.OsConstants.*;
 
@@ -135,4 +140,406 @@ public class OsTest extends TestCase {
     assertEquals("Killed", Libcore.os.strsignal(9));
     assertEquals("Unknown signal -1", Libcore.os.strsignal(-1));
   }
+
+  public void test_readv_writev_more_than_IOV_MAX_buffers() throws Exception {
+    // Linux rejects more than 1024 buffers per call, so these need splitting into several calls.
+    final int bufferCount = 2500;
+    byte[][] buffers = new byte[bufferCount][];
+    int[] offsets = new int[bufferCount];
+    int[] byteCounts = new int[bufferCount];
+    for (int i = 0; i < bufferCount; ++i) {
+      buffers[i] = new byte[] { 0, (byte) i, (byte) (i >> 8) };
+      offsets[i] = 1;
+      byteCounts[i] = 2;
+    }
+    File f = File.createTempFile("OsTest", null);
+    FileDescriptor fd = Libcore.os.open(f.getPath(), O_RDWR, 0);
+    try {
+      assertEquals(2 * bufferCount, Libcore.os.writev(fd, buffers, offsets, byteCounts));
+      Libcore.os.lseek(fd, 0, SEEK_SET);
+      byte[][] readBuffers = new byte[bufferCount][];
+      for (int i = 0; i < bufferCount; ++i) {
+        readBuffers[i] = new byte[3];
+      }
+      assertEquals(2 * bufferCount, Libcore.os.readv(fd, readBuffers, offsets, byteCounts));
+      for (int i = 0; i < bufferCount; ++i) {
+        assertEquals(buffers[i][1], readBuffers[i][1]);
+        assertEquals(buffers[i][2], readBuffers[i][2]);
+      }
+    } finally {
+      Libcore.os.close(fd);
+      f.delete();
+    }
+  }
+
+  public void test_sendmmsg_recvmmsg() throws Exception {
+    FileDescriptor fd = Libcore.os.socket(AF_INET6, SOCK_DGRAM, 0);
+    try {
+      Libcore.os.bind(fd, InetAddress.getByName("::1"), 0);
+      int port = ((InetSocketAddress) Libcore.os.getsockname(fd)).getPort();
+
+      byte[] address = new byte[18];
+      address[0] = (byte) (port >> 8);
+      address[1] = (byte) port;
+      address[17] = 1; // ::1
+      byte[] addresses = new byte[3 * 18];
+      for (int i = 0; i < 3; ++i) {
+        System.arraycopy(address, 0, addresses, 18 * i, 18);
+      }
+      byte[] out = "abbccc".getBytes("US-ASCII");
+      assertEquals(3, Libcore.os.sendmmsg(fd, out, new int[] { 0, 1, 3 }, new int[] { 1, 2, 3 }, addresses, 0));
+
+      byte[] in = new byte[50];
+      int[] receivedByteCounts = new int[3];
+      byte[] senders = new byte[3 * 18];
+      int received = 0;
+      while (received < 3) {
+        int n = Libcore.os.recvmmsg(fd, in, new int[] { 10 * received, 10 * received + 10, 10 * received + 20 }, new int[] { 10, 10, 10 }, receivedByteCounts, senders, 0);
+        for (int i = 0; i < n; ++i) {
+          assertEquals(received + i + 1, receivedByteCounts[i]);
+          assertTrue(Arrays.equals(address, Arrays.copyOfRange(senders, 18 * i, 18 * i + 18)));
+        }
+        // On platforms without recvmmsg(2), we only get one datagram per call.
+        received += n;
+      }
+      assertEquals("a", new String(in, 0, 1, "US-ASCII"));
+      assertEquals("bb", new String(in, 10, 2, "US-ASCII"));
+      assertEquals("ccc", new String(in, 20, 3, "US-ASCII"));
+    } finally {
+      Libcore.os.close(fd);
+    }
+  }
+
+  public void test_recvmmsg_returnsWhatHasArrived() throws Exception {
+    // Asking a blocking socket for 3 datagrams when only 1 has been sent must not wait for more.
+    FileDescriptor fd = Libcore.os.socket(AF_INET6, SOCK_DGRAM, 0);
+    try {
+      Libcore.os.bind(fd, InetAddress.getByName("::1"), 0);
+      int port = ((InetSocketAddress) Libcore.os.getsockname(fd)).getPort();
+      Libcore.os.sendto(fd, new byte[] { 42 }, 0, 1, 0, InetAddress.getByName("::1"), port);
+
+      byte[] in = new byte[30];
+      int[] receivedByteCounts = new int[3];
+      assertEquals(1, Libcore.os.recvmmsg(fd, in, new int[] { 0, 10, 20 }, new int[] { 10, 10, 10 }, receivedByteCounts, null, 0));
+      assertEquals(1, receivedByteCounts[0]);
+      assertEquals(42, in[0]);
+    } finally {
+      Libcore.os.close(fd);
+    }
+  }
+
+  public void test_sendmmsg_recvmmsg_badOffsets() throws Exception {
+    FileDescriptor fd = Libcore.os.socket(AF_INET6, SOCK_DGRAM, 0);
+    try {
+      Libcore.os.bind(fd, InetAddress.getByName("::1"), 0);
+      byte[] bytes = new byte[10];
+      int[][][] badPairs = new int[][][] {
+        { { -1 }, { 1 } },
+        { { 0 }, { -1 } },
+        { { 11 }, { 0 } },
+        { { 5 }, { 6 } },
+        { { 0, 1 }, { 1, Integer.MAX_VALUE } },
+      };
+      for (int[][] pair : badPairs) {
+        try {
+          Libcore.os.sendmmsg(fd, bytes, pair[0], pair[1], null, 0);
+          fail();
+        } catch (ArrayIndexOutOfBoundsException expected) {
+        }
+        try {
+          Libcore.os.recvmmsg(fd, bytes, pair[0], pair[1], new int[pair[0].length], null, MSG_DONTWAIT);
+          fail();
+        } catch (ArrayIndexOutOfBoundsException expected) {
+        }
+      }
+    } finally {
+      Libcore.os.close(fd);
+    }
+  }
+
+  public void test_acceptPacked_getpeernamePacked() throws Exception {
+    FileDescriptor server = Libcore.os.socket(AF_INET6, SOCK_STREAM, 0);
+    FileDescriptor client = Libcore.os.socket(AF_INET6, SOCK_STREAM, 0);
+    FileDescriptor accepted = null;
+    try {
+      Libcore.os.bind(server, InetAddress.getByName("127.0.0.1"), 0);
+      Libcore.os.listen(server, 1);
+      int serverPort = ((InetSocketAddress) Libcore.os.getsockname(server)).getPort();
+      Libcore.os.connect(client, InetAddress.getByName("127.0.0.1"), serverPort);
+      int clientPort = ((InetSocketAddress) Libcore.os.getsockname(client)).getPort();
+
+      byte[] peer = new byte[18];
+      accepted = Libcore.os.acceptPacked(server, peer);
+      // The client's port, then ::ffff:127.0.0.1.
+      byte[] expected = new byte[] { (byte) (clientPort >> 8), (byte) clientPort,
+          0, 0, 0, 0, 0, 0, 0, 0, 0, 0, (byte) 0xff, (byte) 0xff, 127, 0, 0, 1 };
+      assertEquals(Arrays.toString(expected), Arrays.toString(peer));
+
+      Libcore.os.getpeernamePacked(client, peer);
+      expected[0] = (byte) (serverPort >> 8);
+      expected[1] = (byte) serverPort;
+      assertEquals(Arrays.toString(expected), Arrays.toString(peer));
+
+      try {
+        Libcore.os.getpeernamePacked(client, new byte[17]);
+        fail();
+      } catch (IllegalArgumentException expectedException) {
+      }
+    } finally {
+      Libcore.os.close(server);
+      Libcore.os.close(client);
+      if (accepted != null) {
+        Libcore.os.close(accepted);
+      }
+    }
+  }
+
+  public void test_acceptMany() throws Exception {
+    FileDescriptor server = Libcore.os.socket(AF_INET6, SOCK_STREAM, 0);
+    FileDescriptor[] clients = new FileDescriptor[3];
+    int[] fds = new int[4];
+    int accepted = 0;
+    try {
+      Libcore.os.bind(server, InetAddress.getByName("::1"), 0);
+      Libcore.os.listen(server, clients.length);
+      int serverPort = ((InetSocketAddress) Libcore.os.getsockname(server)).getPort();
+      for (int i = 0; i < clients.length; ++i) {
+        clients[i] = Libcore.os.socket(AF_INET6, SOCK_STREAM, 0);
+        Libcore.os.connect(clients[i], InetAddress.getByName("::1"), serverPort);
+      }
+
+      // All three connections are already queued, so we don't block waiting for a fourth.
+      byte[] peers = new byte[4 * 18];
+      int[] batch = new int[4];
+      while (accepted < clients.length) {
+        int n = Libcore.os.acceptMany(server, batch, peers, SOCK_CLOEXEC | SOCK_NONBLOCK);
+        System.arraycopy(batch, 0, fds, accepted, n);
+        accepted += n;
+      }
+      assertEquals(clients.length, accepted);
+
+      FileDescriptor fd = new FileDescriptor();
+      for (int i = 0; i < accepted; ++i) {
+        fd.setInt$(fds[i]);
+        assertTrue((Libcore.os.fcntlVoid(fd, F_GETFL) & O_NONBLOCK) != 0);
+        assertTrue((Libcore.os.fcntlVoid(fd, F_GETFD) & FD_CLOEXEC) != 0);
+      }
+      assertEquals(1, peers[17]); // ::1
+    } finally {
+      Libcore.os.close(server);
+      for (FileDescriptor client : clients) {
+        if (client != null) {
+          Libcore.os.close(client);
+        }
+      }
+      FileDescriptor fd = new FileDescriptor();
+      for (int i = 0; i < accepted; ++i) {
+        fd.setInt$(fds[i]);
+        Libcore.os.close(fd);
+      }
+    }
+  }
+
+  public void test_open_O_OVERLAPPED() throws Exception {
+    // O_OVERLAPPED is 0 except on Windows, where it gives a descriptor that only supports
+    // positional I/O. Either way, pread and pwrite must work at any offset.
+    File f = File.createTempFile("OsTest", "tst");
+    try {
+      FileDescriptor fd = Libcore.os.open(f.getPath(), O_RDWR | O_OVERLAPPED, 0);
+      try {
+        assertEquals(3, Libcore.os.pwrite(fd, new byte[] { 1, 2, 3 }, 0, 3, 4));
+        assertEquals(2, Libcore.os.pwrite(fd, new byte[] { 9, 8 }, 0, 2, 0));
+        byte[] bytes = new byte[8];
+        assertEquals(7, Libcore.os.pread(fd, bytes, 0, bytes.length, 0));
+        assertTrue(Arrays.equals(new byte[] { 9, 8, 0, 0, 1, 2, 3, 0 }, bytes));
+        assertEquals(0, Libcore.os.pread(fd, bytes, 0, bytes.length, 7));
+      } finally {
+        Libcore.os.close(fd);
+      }
+      assertEquals(7, f.length());
+    } finally {
+      f.delete();
+    }
+  }
+
+  public void test_pread_concurrentWithRead() throws Exception {
+    // pread must leave the file position alone, even while another thread streams through the
+    // same descriptor. (On Windows, pread temporarily moves the file pointer.)
+    File f = File.createTempFile("OsTest", "tst");
+    final byte[] contents = new byte[64 * 1024];
+    for (int i = 0; i < contents.length; ++i) {
+      contents[i] = (byte) (i % 251);
+    }
+    FileOutputStream fos = new FileOutputStream(f);
+    fos.write(contents);
+    fos.close();
+    final FileDescriptor fd = Libcore.os.open(f.getPath(), O_RDONLY, 0);
+    final AtomicBoolean stop = new AtomicBoolean();
+    final Throwable[] failure = new Throwable[1];
+    Thread preader = new Thread(new Runnable() {
+      public void run() {
+        try {
+          byte[] bytes = new byte[97];
+          for (long offset = 0; !stop.get(); offset = (offset + 7919) % (contents.length - bytes.length)) {
+            assertEquals(bytes.length, Libcore.os.pread(fd, bytes, 0, bytes.length, offset));
+            for (int i = 0; i < bytes.length; ++i) {
+              assertEquals(contents[(int) offset + i], bytes[i]);
+            }
+          }
+        } catch (Throwable t) {
+          failure[0] = t;
+        }
+      }
+    });
+    try {
+      preader.start();
+      byte[] bytes = new byte[61];
+      for (int pass = 0; pass < 20; ++pass) {
+        Libcore.os.lseek(fd, 0, SEEK_SET);
+        int position = 0;
+        int n;
+        while ((n = Libcore.os.read(fd, bytes, 0, bytes.length)) > 0) {
+          for (int i = 0; i < n; ++i) {
+            assertEquals(contents[position + i], bytes[i]);
+          }
+          position += n;
+        }
+        assertEquals(contents.length, position);
+      }
+    } finally {
+      stop.set(true);
+      preader.join();
+      Libcore.os.close(fd);
+      f.delete();
+    }
+    assertNull(failure[0]);
+  }
+
+  public void test_statInto() throws Exception {
+    File f = File.createTempFile("OsTest", "tst");
+    try {
+      FileOutputStream fos = new FileOutputStream(f);
+      fos.write(new byte[7]);
+      fos.close();
+
+      StructStat sb = Libcore.os.stat(f.getPath());
+      long[] out = new long[13];
+      Libcore.os.statInto(f.getPath(), out);
+      assertEquals(sb.st_ino, out[1]);
+      assertEquals(sb.st_mode, out[2]);
+      assertEquals(7, out[7]);
+      assertEquals(sb.st_mtime, out[9]);
+
+      try {
+        Libcore.os.statInto(f.getPath(), new long[12]);
+        fail();
+      } catch (IllegalArgumentException expected) {
+      }
+
+      f.delete();
+      try {
+        Libcore.os.statInto(f.getPath(), out);
+        fail();
+      } catch (ErrnoException expected) {
+        assertEquals(ENOENT, expected.errno);
+      }
+    } finally {
+      f.delete();
+    }
+  }
+
+  public void testErrnoVariants() throws Exception {
+    FileDescriptor[] fds = Libcore.os.pipe();
+    try {
+      IoUtils.setBlocking(fds[0], false);
+      byte[] bytes = new byte[4];
+      assertEquals(-EAGAIN, Libcore.os.readErrno(fds[0], bytes, 0, bytes.length));
+      assertEquals(3, Libcore.os.writeErrno(fds[1], new byte[] { 1, 2, 3 }, 0, 3));
+      assertEquals(3, Libcore.os.readErrno(fds[0], bytes, 0, bytes.length));
+
+      // The throwing variant reuses a single stackless exception for EAGAIN.
+      ErrnoException first = null;
+      try {
+        Libcore.os.read(fds[0], bytes, 0, bytes.length);
+        fail();
+      } catch (ErrnoException expected) {
+        assertEquals(EAGAIN, expected.errno);
+        first = expected;
+      }
+      try {
+        Libcore.os.read(fds[0], bytes, 0, bytes.length);
+        fail();
+      } catch (ErrnoException expected) {
+        assertSame(first, expected);
+      }
+    } finally {
+      IoUtils.closeQuietly(fds[0]);
+      IoUtils.closeQuietly(fds[1]);
+    }
+    assertEquals(-EBADF, Libcore.os.readErrno(fds[0], new byte[1], 0, 1));
+  }
+
+  public void test_setsockoptMany() throws Exception {
+    FileDescriptor fd = Libcore.os.socket(AF_INET6, SOCK_STREAM, 0);
+    try {
+      Libcore.os.setsockoptMany(fd, new int[] {
+          SOL_SOCKET, SO_KEEPALIVE, 1,
+          IPPROTO_TCP, TCP_NODELAY, 1,
+      });
+      assertEquals(1, Libcore.os.getsockoptInt(fd, SOL_SOCKET, SO_KEEPALIVE));
+      assertEquals(1, Libcore.os.getsockoptInt(fd, IPPROTO_TCP, TCP_NODELAY));
+
+      // Options are applied in order until one fails.
+      try {
+        Libcore.os.setsockoptMany(fd, new int[] {
+            SOL_SOCKET, SO_KEEPALIVE, 0,
+            SOL_SOCKET, -1, 1,
+            IPPROTO_TCP, TCP_NODELAY, 0,
+        });
+        fail();
+      } catch (ErrnoException expected) {
+      }
+      assertEquals(0, Libcore.os.getsockoptInt(fd, SOL_SOCKET, SO_KEEPALIVE));
+      assertEquals(1, Libcore.os.getsockoptInt(fd, IPPROTO_TCP, TCP_NODELAY));
+
+      try {
+        Libcore.os.setsockoptMany(fd, new int[] { SOL_SOCKET, SO_KEEPALIVE });
+        fail();
+      } catch (IllegalArgumentException expected) {
+      }
+    } finally {
+      Libcore.os.close(fd);
+    }
+  }
+
+  public void testMemoryMappedFileAccessPatterns() throws Exception {
+    File f = File.createTempFile("OsTest", "tst");
+    try {
+      FileOutputStream fos = new FileOutputStream(f);
+      fos.write(new byte[64 * 1024]);
+      fos.close();
+
+      FileInputStream fis = new FileInputStream(f);
+      Libcore.os.posix_fadvise(fis.getFD(), 0, 0, POSIX_FADV_SEQUENTIAL);
+      Libcore.os.readahead(fis.getFD(), 0, 64 * 1024);
+      fis.close();
+
+      MemoryMappedFile mapped = MemoryMappedFile.mmapRO(f.getPath(), MemoryMappedFile.ACCESS_SEQUENTIAL, true);
+      try {
+        assertEquals(64 * 1024, mapped.size());
+        mapped.advise(MemoryMappedFile.ACCESS_WILLNEED, 1000, 10000);
+        mapped.advise(MemoryMappedFile.ACCESS_RANDOM);
+        assertEquals(0, mapped.bigEndianIterator().readInt());
+        try {
+          mapped.advise(MemoryMappedFile.ACCESS_NORMAL, 1, 64 * 1024);
+          fail();
+        } catch (IndexOutOfBoundsException expected) {
+        }
+      } finally {
+        mapped.close();
+      }
+    } finally {
+      f.delete();
+    }
+  }
 }
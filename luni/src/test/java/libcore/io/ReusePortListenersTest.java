@@ -0,0 +1,82 @@
+/*
+ * Copyright (C) 2014 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+package libcore.io;
+
+import android.system.ErrnoException;
+import java.io.FileDescriptor;
+import java.net.InetAddress;
+import java.net.InetSocketAddress;
+import junit.framework.TestCase;
+import static android.system.OsConstants.*;
+
+public class ReusePortListenersTest extends TestCase {
+  public void testConnectionsAreSpreadAcrossListeners() throws Exception {
+    if (SO_REUSEPORT == 0) {
+      return;
+    }
+    InetAddress loopback = InetAddress.getByName("::1");
+    FileDescriptor[] listeners = ReusePortListeners.open(loopback, 0, 4, 64, null);
+    FileDescriptor[] clients = new FileDescriptor[32];
+    try {
+      int port = ((InetSocketAddress) Libcore.os.getsockname(listeners[0])).getPort();
+      for (FileDescriptor listener : listeners) {
+        assertEquals(port, ((InetSocketAddress) Libcore.os.getsockname(listener)).getPort());
+        assertEquals(1, Libcore.os.getsockoptInt(listener, SOL_SOCKET, SO_REUSEPORT));
+        IoUtils.setBlocking(listener, false);
+      }
+      for (int i = 0; i < clients.length; ++i) {
+        clients[i] = Libcore.os.socket(AF_INET6, SOCK_STREAM, 0);
+        Libcore.os.connect(clients[i], loopback, port);
+      }
+
+      // Every connection is accepted by exactly one of the listeners.
+      int accepted = 0;
+      long deadline = System.currentTimeMillis() + 5000;
+      while (accepted < clients.length && System.currentTimeMillis() < deadline) {
+        for (FileDescriptor listener : listeners) {
+          int fd = Libcore.os.acceptErrno(listener, null, 0);
+          if (fd >= 0) {
+            FileDescriptor connection = new FileDescriptor();
+            connection.setInt$(fd);
+            Libcore.os.close(connection);
+            ++accepted;
+          }
+        }
+      }
+      assertEquals(clients.length, accepted);
+    } finally {
+      for (FileDescriptor fd : listeners) {
+        IoUtils.closeQuietly(fd);
+      }
+      for (FileDescriptor fd : clients) {
+        IoUtils.closeQuietly(fd);
+      }
+    }
+  }
+
+  public void testFailureClosesEverything() throws Exception {
+    if (SO_REUSEPORT == 0) {
+      return;
+    }
+    try {
+      ReusePortListeners.open(InetAddress.getByName("::1"), 0, 2, 64,
+          new int[] { SOL_SOCKET, -1, 1 });
+      fail();
+    } catch (ErrnoException expected) {
+    }
+  }
+}
@@ -19,10 +19,13 @@ package libcore.java.io;
 import java.io.File;
 import java.io.FileFilter;
 import java.io.FilenameFilter;
+import java.io.FileOutputStream;
 import java.io.IOException;
 import java.util.UUID;
 import libcore.io.Libcore;
 
+import static android.system.OsConstants.*;
+
 public class FileTest extends junit.framework.TestCase {
     private static File createTemporaryDirectory() throws Exception {
         String base = System.getProperty("java.io.tmpdir");
@@ -183,6 +186,36 @@ public class FileTest extends junit.framework.TestCase {
         assertEquals(target.getCanonicalPath(), linkName.getCanonicalPath());
     }
 
+    public void test_getCanonicalPath_cached() throws Exception {
+        File.setCanonicalPathCacheEnabled(true);
+        try {
+            File base = createTemporaryDirectory();
+            File a = new File(base, "a");
+            File b = new File(base, "b");
+            assertTrue(a.mkdir());
+            assertTrue(b.mkdir());
+            File link = new File(base, "link");
+            ln_s("a", link.toString());
+            File file = new File(link, "file");
+            for (int i = 0; i < 3; ++i) {
+                assertEquals(new File(a, "file").getCanonicalPath(), file.getCanonicalPath());
+            }
+
+            // Changing the link must be noticed.
+            assertTrue(link.delete());
+            ln_s("b", link.toString());
+            assertEquals(new File(b, "file").getCanonicalPath(), file.getCanonicalPath());
+
+            // As must replacing a directory with a link.
+            File c = new File(base, "c");
+            assertTrue(b.renameTo(c));
+            ln_s("c", b.toString());
+            assertEquals(new File(c, "file").getCanonicalPath(), file.getCanonicalPath());
+        } finally {
+            File.setCanonicalPathCacheEnabled(false);
+        }
+    }
+
     private static void ln_s(File target, File linkName) throws Exception {
         ln_s(target.toString(), linkName.toString());
     }
@@ -271,4 +304,37 @@ public class FileTest extends junit.framework.TestCase {
         assertFalse(badParent.exists());
         assertFalse(badParent.mkdirs());
     }
+
+    public void test_listWithAttributes() throws Exception {
+        File base = createTemporaryDirectory();
+        File subdirectory = new File(base, "subdirectory");
+        assertTrue(subdirectory.mkdir());
+        File file = new File(base, "file");
+        FileOutputStream fos = new FileOutputStream(file);
+        fos.write(new byte[3]);
+        fos.close();
+
+        long[][] attributes = new long[1][];
+        String[] names = base.listWithAttributes$(attributes, true);
+        assertEquals(2, names.length);
+        assertEquals(6, attributes[0].length);
+        for (int i = 0; i < names.length; ++i) {
+            File entry = new File(base, names[i]);
+            int mode = (int) attributes[0][3 * i];
+            assertEquals(entry.isDirectory(), S_ISDIR(mode));
+            assertEquals(entry.isFile(), S_ISREG(mode));
+            assertEquals(entry.lastModified(), attributes[0][3 * i + 2]);
+            if (entry.isFile()) {
+                assertEquals(3, attributes[0][3 * i + 1]);
+            }
+        }
+
+        names = base.listWithAttributes$(attributes, false);
+        assertEquals(2, names.length);
+        for (int i = 0; i < names.length; ++i) {
+            assertEquals(new File(base, names[i]).isDirectory(), S_ISDIR((int) attributes[0][3 * i]));
+        }
+
+        assertNull(file.listWithAttributes$(attributes, true));
+    }
 }
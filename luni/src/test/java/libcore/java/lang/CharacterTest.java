@@ -289,4 +289,33 @@ public class CharacterTest extends junit.framework.TestCase {
     assertEquals(Character.DIRECTIONALITY_UNDEFINED, Character.getDirectionality(0x2068));
     assertEquals(Character.DIRECTIONALITY_UNDEFINED, Character.getDirectionality(0x2069));
   }
+
+  public void test_getType() throws Exception {
+    Method m = Character.class.getDeclaredMethod("getType" + "Impl", int.class);
+    m.setAccessible(true);
+    for (int i = 0; i <= 0xffff; ++i) {
+      int type = (Integer) m.invoke(null, i);
+      // ICU's values skip 17, unlike the RI's.
+      assertEquals("Failed for character " + i, type <= Character.FORMAT ? type : type + 1,
+          Character.getType(i));
+    }
+  }
+
+  public void test_getTypes() throws Exception {
+    char[] chars = new char[] { 'a', '\u4e00', '\ud83d', '\ude00', '\ud800', ' ', 'A' };
+    byte[] types = new byte[chars.length + 1];
+    Character.getTypes(chars, 0, chars.length, types, 1);
+    assertEquals(0, types[0]);
+    assertEquals(Character.LOWERCASE_LETTER, types[1]);
+    assertEquals(Character.OTHER_LETTER, types[2]);
+    assertEquals(Character.getType(0x1f600), types[3]);
+    assertEquals(Character.getType(0x1f600), types[4]);
+    assertEquals(Character.SURROGATE, types[5]);
+    assertEquals(Character.SPACE_SEPARATOR, types[6]);
+    assertEquals(Character.UPPERCASE_LETTER, types[7]);
+
+    // A pair split by the end of the range is two unpaired surrogates.
+    Character.getTypes(chars, 2, 1, types, 0);
+    assertEquals(Character.SURROGATE, types[0]);
+  }
 }
@@ -16,6 +16,7 @@
 
 package libcore.java.lang;
 
+import java.util.Random;
 import junit.framework.TestCase;
 
 public class DoubleTest extends TestCase {
@@ -30,6 +31,20 @@ public class DoubleTest extends TestCase {
         assertEquals("0.010206713752229896", Double.toString(0.010206713752229896));
     }
 
+    public void testDoubleToStringShortest() throws Exception {
+        assertEquals("1.0E23", Double.toString(1e23));
+        assertEquals("2.0769187434139308E34", Double.toString(2.0769187434139308E34));
+        assertEquals("9.007199254740992E15", Double.toString(9007199254740992.0));
+        assertEquals("2.2250738585072014E-308", Double.toString(Double.MIN_NORMAL));
+        assertEquals("1.7976931348623157E308", Double.toString(Double.MAX_VALUE));
+        assertEquals("1.5E-323", Double.toString(3 * Double.MIN_VALUE));
+        assertEquals("4.9E-324", Double.toString(Double.MIN_VALUE));
+        assertEquals("0.001", Double.toString(0.001));
+        assertEquals("1.0E-5", Double.toString(1e-5));
+        assertEquals("-0.3", Double.toString(-0.3));
+        assertEquals("100.0", Double.toString(100.0));
+    }
+
     public void testNamedDoubles() throws Exception {
         assertEquals(Double.NaN, Double.parseDouble("NaN"));
         assertEquals(Double.NaN, Double.parseDouble("-NaN"));
@@ -142,4 +157,121 @@ public class DoubleTest extends TestCase {
         } catch (NumberFormatException expected) {
         }
     }
+
+    public void testParseDoubles() throws Exception {
+        byte[] bytes = "x 1.5,-2e3, NaN,0.1d,-Infinity,9007199254740993y".getBytes("US-ASCII");
+        double[] values = new double[8];
+        assertEquals(5, Double.parseDoubles(bytes, 2, bytes.length - 20, (byte) ',', values, 1));
+        assertEquals(0.0, values[0]);
+        assertEquals(1.5, values[1]);
+        assertEquals(-2000.0, values[2]);
+        assertTrue(Double.isNaN(values[3]));
+        assertEquals(0.1, values[4]);
+        assertEquals(Double.NEGATIVE_INFINITY, values[5]);
+
+        char[] chars = "9007199254740993;1e-400;-0".toCharArray();
+        assertEquals(3, Double.parseDoubles(chars, 0, chars.length, ';', values, 0));
+        assertEquals(9007199254740992.0, values[0]);
+        assertEquals(0.0, values[1]);
+        assertEquals(Double.doubleToRawLongBits(-0.0), Double.doubleToRawLongBits(values[2]));
+        assertEquals(0, Double.parseDoubles(chars, 0, 0, ';', values, 0));
+
+        try {
+            Double.parseDoubles("1,,2".getBytes("US-ASCII"), 0, 4, (byte) ',', values, 0);
+            fail();
+        } catch (NumberFormatException expected) {
+        }
+        try {
+            Double.parseDoubles("0x1p3".toCharArray(), 0, 5, ',', values, 0);
+            fail();
+        } catch (NumberFormatException expected) {
+        }
+        try {
+            Double.parseDoubles("1,2".toCharArray(), 0, 3, ',', values, 7);
+            fail();
+        } catch (ArrayIndexOutOfBoundsException expected) {
+        }
+    }
+
+    public void testFormatDoubles() throws Exception {
+        double[] values = { 100.0, -0.0, 1e-5, 0.1, Double.MIN_VALUE, Double.NaN, 1.2345678E7 };
+        byte[] bytes = new byte[200];
+        int length = Double.formatDoubles(values, 0, values.length, bytes, 3, (byte) ' ');
+        assertEquals("100.0 -0.0 1.0E-5 0.1 4.9E-324 NaN 1.2345678E7",
+                new String(bytes, 3, length, "US-ASCII"));
+
+        Random random = new Random(0);
+        double[] randomValues = new double[1000];
+        StringBuilder expected = new StringBuilder();
+        for (int i = 0; i < randomValues.length; ++i) {
+            randomValues[i] = Double.longBitsToDouble(random.nextLong());
+            expected.append(i == 0 ? "" : ",").append(randomValues[i]);
+        }
+        bytes = new byte[randomValues.length * 25];
+        length = Double.formatDoubles(randomValues, 0, randomValues.length, bytes, 0, (byte) ',');
+        assertEquals(expected.toString(), new String(bytes, 0, length, "US-ASCII"));
+
+        try {
+            Double.formatDoubles(values, 0, values.length, new byte[20], 0, (byte) ' ');
+            fail();
+        } catch (ArrayIndexOutOfBoundsException expected) {
+        }
+    }
+
+    public void testParseCorrectRounding() {
+        // Exactly halfway between two doubles: round to even.
+        assertEquals(9007199254740992.0, Double.parseDouble("9007199254740993"));
+        assertEquals(9007199254740996.0, Double.parseDouble("9007199254740995"));
+        // Just above halfway, but only in the 20th and later digits.
+        assertEquals(9007199254740994.0, Double.parseDouble("9007199254740993.0000000001"));
+        assertEquals(0.1, Double.parseDouble("0.1"));
+        assertEquals(1.7976931348623157E308, Double.parseDouble("1.7976931348623157e308"));
+        assertEquals(Double.POSITIVE_INFINITY, Double.parseDouble("1.7976931348623159e308"));
+        assertEquals(4.9E-324, Double.parseDouble("4.9e-324"));
+        assertEquals(123456.789e-50, Double.parseDouble("1234567.89e-51"));
+        assertEquals(Double.doubleToLongBits(3.0517578125E-5),
+                Double.doubleToLongBits(Double.parseDouble("0.000030517578125")));
+    }
+
+    // Mantissas whose 64-bit limbs are all ones, scaled by powers of ten big enough to multiply
+    // by 1e19 at a time, carry out of every partial product in the multiplication.
+    public void testParseCarryHeavyMantissas() {
+        String[] inputs = {
+            "18446744073709551615e19",
+            "18446744073709551615e38",
+            "18446744073709551615e57",
+            "18446744073709551615e-19",
+            "18446744073709551615e-38",
+            "340282366920938463463374607431768211455e19",
+            "340282366920938463463374607431768211455e38",
+            "340282366920938463463374607431768211455e57",
+            "340282366920938463463374607431768211455e-19",
+            "340282366920938463463374607431768211455e-38",
+            "6277101735386680763835789423207666416102355444464034512895e19",
+            "6277101735386680763835789423207666416102355444464034512895e38",
+            "6277101735386680763835789423207666416102355444464034512895e57",
+            "6277101735386680763835789423207666416102355444464034512895e-19",
+            "6277101735386680763835789423207666416102355444464034512895e-38",
+        };
+        double[] expected = {
+            1.844674407370955E38,
+            1.844674407370955E57,
+            1.8446744073709553E76,
+            1.8446744073709551,
+            1.844674407370955E-19,
+            3.4028236692093846E57,
+            3.4028236692093846E76,
+            3.402823669209385E95,
+            3.4028236692093846E19,
+            3.4028236692093845,
+            6.277101735386681E76,
+            6.277101735386681E95,
+            6.277101735386681E114,
+            6.2771017353866806E38,
+            6.2771017353866805E19,
+        };
+        for (int i = 0; i < inputs.length; ++i) {
+            assertEquals(inputs[i], expected[i], Double.parseDouble(inputs[i]));
+        }
+    }
 }
@@ -121,4 +121,25 @@ public class FloatTest extends junit.framework.TestCase {
       }
       assertEquals(f1, 0f);
     }
+
+    public void testFloatToStringShortest() throws Exception {
+        assertEquals("1.0E10", Float.toString(1e10f));
+        assertEquals("3.4028235E38", Float.toString(Float.MAX_VALUE));
+        assertEquals("1.4E-45", Float.toString(Float.MIN_VALUE));
+        assertEquals("2.8E-45", Float.toString(2 * Float.MIN_VALUE));
+        assertEquals("0.1", Float.toString(0.1f));
+        assertEquals("1.6777216E7", Float.toString(16777216f));
+        // Shorter than the 1.17549435E-38 of the reference implementation, but still unique.
+        assertEquals("1.1754944E-38", Float.toString(Float.MIN_NORMAL));
+    }
+
+    public void testParseCorrectRounding() {
+        // Exactly halfway between two floats: round to even.
+        assertEquals(16777216f, Float.parseFloat("16777217"));
+        assertEquals(16777220f, Float.parseFloat("16777219"));
+        assertEquals(16777218f, Float.parseFloat("16777217.000000000000000000001"));
+        assertEquals(0.1f, Float.parseFloat("0.1"));
+        assertEquals(3.4028235e38f, Float.parseFloat("3.4028235e38"));
+        assertEquals(1.4e-45f, Float.parseFloat("1.4e-45"));
+    }
 }
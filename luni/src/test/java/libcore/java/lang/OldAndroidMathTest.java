@@ -17,6 +17,7 @@
 
 package libcore.java.lang;
 
+import java.util.Arrays;
 import junit.framework.Assert;
 import junit.framework.TestCase;
 
@@ -47,6 +48,89 @@ public class OldAndroidMathTest extends TestCase {
         }
     }
 
+    public void testBulk() {
+        // The array versions must give exactly the scalar results, including for special values.
+        double[] in = { 0.0, -0.0, 0.5, -1.25, 3.0, 100.0, 1e-300, 1e300, Double.MIN_VALUE,
+                Double.MAX_VALUE, Double.NaN, Double.POSITIVE_INFINITY, Double.NEGATIVE_INFINITY };
+        double[] out = new double[in.length];
+        Arrays.fill(out, -1.0);
+        Math.sin(in, out, 1, in.length - 2);
+        assertEquals(-1.0, out[0]);
+        for (int i = 1; i < in.length - 1; ++i) {
+            assertEquals(Double.doubleToRawLongBits(Math.sin(in[i])), Double.doubleToRawLongBits(out[i]));
+        }
+        assertEquals(-1.0, out[in.length - 1]);
+        Arrays.fill(out, -1.0);
+        Math.cos(in, out, 1, in.length - 2);
+        assertEquals(-1.0, out[0]);
+        for (int i = 1; i < in.length - 1; ++i) {
+            assertEquals(Double.doubleToRawLongBits(Math.cos(in[i])), Double.doubleToRawLongBits(out[i]));
+        }
+        assertEquals(-1.0, out[in.length - 1]);
+        Arrays.fill(out, -1.0);
+        Math.tan(in, out, 1, in.length - 2);
+        assertEquals(-1.0, out[0]);
+        for (int i = 1; i < in.length - 1; ++i) {
+            assertEquals(Double.doubleToRawLongBits(Math.tan(in[i])), Double.doubleToRawLongBits(out[i]));
+        }
+        assertEquals(-1.0, out[in.length - 1]);
+        Arrays.fill(out, -1.0);
+        Math.exp(in, out, 1, in.length - 2);
+        assertEquals(-1.0, out[0]);
+        for (int i = 1; i < in.length - 1; ++i) {
+            assertEquals(Double.doubleToRawLongBits(Math.exp(in[i])), Double.doubleToRawLongBits(out[i]));
+        }
+        assertEquals(-1.0, out[in.length - 1]);
+        Arrays.fill(out, -1.0);
+        Math.log(in, out, 1, in.length - 2);
+        assertEquals(-1.0, out[0]);
+        for (int i = 1; i < in.length - 1; ++i) {
+            assertEquals(Double.doubleToRawLongBits(Math.log(in[i])), Double.doubleToRawLongBits(out[i]));
+        }
+        assertEquals(-1.0, out[in.length - 1]);
+        Arrays.fill(out, -1.0);
+        Math.log10(in, out, 1, in.length - 2);
+        assertEquals(-1.0, out[0]);
+        for (int i = 1; i < in.length - 1; ++i) {
+            assertEquals(Double.doubleToRawLongBits(Math.log10(in[i])), Double.doubleToRawLongBits(out[i]));
+        }
+        assertEquals(-1.0, out[in.length - 1]);
+        Arrays.fill(out, -1.0);
+        Math.sqrt(in, out, 1, in.length - 2);
+        assertEquals(-1.0, out[0]);
+        for (int i = 1; i < in.length - 1; ++i) {
+            assertEquals(Double.doubleToRawLongBits(Math.sqrt(in[i])), Double.doubleToRawLongBits(out[i]));
+        }
+        assertEquals(-1.0, out[in.length - 1]);
+
+        double[] y = new double[in.length];
+        for (int i = 0; i < y.length; ++i) {
+            y[i] = (i - 4) * 0.75;
+        }
+        Math.pow(in, y, out, 0, in.length);
+        for (int i = 0; i < in.length; ++i) {
+            assertEquals(Double.doubleToRawLongBits(Math.pow(in[i], y[i])), Double.doubleToRawLongBits(out[i]));
+        }
+
+        // In place.
+        double[] values = { 4.0, 9.0, 2.25 };
+        Math.sqrt(values, values, 0, values.length);
+        assertEquals(2.0, values[0]);
+        assertEquals(3.0, values[1]);
+        assertEquals(1.5, values[2]);
+
+        try {
+            Math.sin(in, new double[2], 0, 3);
+            fail();
+        } catch (ArrayIndexOutOfBoundsException expected) {
+        }
+        try {
+            Math.pow(in, new double[2], out, 0, 3);
+            fail();
+        } catch (ArrayIndexOutOfBoundsException expected) {
+        }
+    }
+
     public void testAbsD() {
         // Test for method double java.lang.Math.abs(double)
 
@@ -17,6 +17,7 @@
 
 package libcore.java.lang;
 
+import java.util.Arrays;
 import junit.framework.TestCase;
 
 public class OldAndroidStrictMathTest extends TestCase {
@@ -30,6 +31,68 @@ public class OldAndroidStrictMathTest extends TestCase {
     /* Required to make previous preprocessor flags work - do not remove */
     int unused = 0;
 
+    public void testBulk() {
+        // The array versions must give exactly the scalar results, including for special values.
+        double[] in = { 0.0, -0.0, 0.5, -1.25, 3.0, 100.0, 1e-300, 1e300, Double.MIN_VALUE,
+                Double.MAX_VALUE, Double.NaN, Double.POSITIVE_INFINITY, Double.NEGATIVE_INFINITY };
+        double[] out = new double[in.length];
+        Arrays.fill(out, -1.0);
+        StrictMath.sin(in, out, 1, in.length - 2);
+        assertEquals(-1.0, out[0]);
+        for (int i = 1; i < in.length - 1; ++i) {
+            assertEquals(Double.doubleToRawLongBits(StrictMath.sin(in[i])), Double.doubleToRawLongBits(out[i]));
+        }
+        assertEquals(-1.0, out[in.length - 1]);
+        Arrays.fill(out, -1.0);
+        StrictMath.cos(in, out, 1, in.length - 2);
+        assertEquals(-1.0, out[0]);
+        for (int i = 1; i < in.length - 1; ++i) {
+            assertEquals(Double.doubleToRawLongBits(StrictMath.cos(in[i])), Double.doubleToRawLongBits(out[i]));
+        }
+        assertEquals(-1.0, out[in.length - 1]);
+        Arrays.fill(out, -1.0);
+        StrictMath.tan(in, out, 1, in.length - 2);
+        assertEquals(-1.0, out[0]);
+        for (int i = 1; i < in.length - 1; ++i) {
+            assertEquals(Double.doubleToRawLongBits(StrictMath.tan(in[i])), Double.doubleToRawLongBits(out[i]));
+        }
+        assertEquals(-1.0, out[in.length - 1]);
+        Arrays.fill(out, -1.0);
+        StrictMath.sqrt(in, out, 1, in.length - 2);
+        assertEquals(-1.0, out[0]);
+        for (int i = 1; i < in.length - 1; ++i) {
+            assertEquals(Double.doubleToRawLongBits(StrictMath.sqrt(in[i])), Double.doubleToRawLongBits(out[i]));
+        }
+        assertEquals(-1.0, out[in.length - 1]);
+
+        double[] y = new double[in.length];
+        for (int i = 0; i < y.length; ++i) {
+            y[i] = (i - 4) * 0.75;
+        }
+        StrictMath.pow(in, y, out, 0, in.length);
+        for (int i = 0; i < in.length; ++i) {
+            assertEquals(Double.doubleToRawLongBits(StrictMath.pow(in[i], y[i])), Double.doubleToRawLongBits(out[i]));
+        }
+
+        // In place.
+        double[] values = { 4.0, 9.0, 2.25 };
+        StrictMath.sqrt(values, values, 0, values.length);
+        assertEquals(2.0, values[0]);
+        assertEquals(3.0, values[1]);
+        assertEquals(1.5, values[2]);
+
+        try {
+            StrictMath.sin(in, new double[2], 0, 3);
+            fail();
+        } catch (ArrayIndexOutOfBoundsException expected) {
+        }
+        try {
+            StrictMath.pow(in, new double[2], out, 0, 3);
+            fail();
+        } catch (ArrayIndexOutOfBoundsException expected) {
+        }
+    }
+
     public void testAbsD() {
         // Test for method double java.lang.StrictMath.abs(double)
 
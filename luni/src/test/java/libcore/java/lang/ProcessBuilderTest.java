@@ -20,6 +20,7 @@ import java.io.File;
 import java.io.IOException;
 import java.io.InputStream;
 import java.io.OutputStream;
+import java.lang.reflect.Method;
 import java.util.HashMap;
 import java.util.Map;
 import libcore.java.util.AbstractResourceLeakageDetectorTestCase;
@@ -54,6 +55,71 @@ public class ProcessBuilderTest extends AbstractResourceLeakageDetectorTestCase
         execAndCheckOutput(pb, "android\n", "");
     }
 
+    public void testDirectory() throws Exception {
+        File dir = new File(System.getProperty("java.io.tmpdir")).getCanonicalFile();
+        ProcessBuilder pb = new ProcessBuilder(shell(), "-c", "pwd -P");
+        pb.directory(dir);
+        execAndCheckOutput(pb, dir.getPath() + "\n", "");
+    }
+
+    public void testPathSearchUsesChildEnvironment() throws Exception {
+        // A bare command name is looked up using the PATH we hand the child, not our own.
+        File shell = new File(shell());
+        ProcessBuilder pb = new ProcessBuilder(shell.getName(), "-c", "echo found");
+        pb.environment().put("PATH", "/nonexistent:" + shell.getParent());
+        execAndCheckOutput(pb, "found\n", "");
+    }
+
+    public void testMissingCommand() throws Exception {
+        try {
+            new ProcessBuilder("/nonexistent/command").start();
+            fail();
+        } catch (IOException expected) {
+        }
+    }
+
+    public void testLauncher() throws Exception {
+        final Method startLauncher =
+                Class.forName("java.lang.ProcessManager").getDeclaredMethod("startLauncher");
+        startLauncher.setAccessible(true);
+        // Start the launcher from a thread that then exits. The launcher has to outlive it.
+        final int[] launcherPid = new int[1];
+        Thread thread = new Thread() {
+            @Override public void run() {
+                try {
+                    launcherPid[0] = (Integer) startLauncher.invoke(null);
+                } catch (Exception e) {
+                    throw new AssertionError(e);
+                }
+            }
+        };
+        thread.start();
+        thread.join();
+        if (launcherPid[0] == -1) {
+            return; // There's no launcher on this platform.
+        }
+        Thread.sleep(100);
+
+        assertRedirectErrorStream(true, "out\nerr\n", "");
+        assertRedirectErrorStream(false, "out\n", "err\n");
+        File shell = new File(shell());
+        ProcessBuilder pb = new ProcessBuilder(shell.getName(), "-c", "echo $A; pwd -P");
+        pb.environment().put("A", "android");
+        pb.environment().put("PATH", "/nonexistent:" + shell.getParent());
+        File dir = new File(System.getProperty("java.io.tmpdir")).getCanonicalFile();
+        pb.directory(dir);
+        execAndCheckOutput(pb, "android\n" + dir.getPath() + "\n", "");
+        try {
+            new ProcessBuilder("/nonexistent/command").start();
+            fail();
+        } catch (IOException expected) {
+        }
+
+        // Had the launcher died, exec would have fallen back to vfork, and this would have to
+        // start a new one.
+        assertEquals(launcherPid[0], startLauncher.invoke(null));
+    }
+
     public void testDestroyClosesEverything() throws IOException {
         Process process = new ProcessBuilder(shell(), "-c", "echo out; echo err 1>&2").start();
         InputStream in = process.getInputStream();
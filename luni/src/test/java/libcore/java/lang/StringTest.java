@@ -172,6 +172,43 @@ public class StringTest extends TestCase {
         assertEquals("a\ufffdb", new String(new byte[] { 97, -2, 98 }, Charset.forName("US-ASCII")));
     }
 
+    // The single-byte and UTF-8 fast paths work on blocks of up to 32 characters, so check
+    // that a character needing special treatment is handled at every position in and around
+    // a block, and in the scalar tail.
+    public void test_fastPathBlockBoundaries() throws Exception {
+        for (int length = 0; length < 80; ++length) {
+            for (int bad = -1; bad < length; ++bad) {
+                byte[] bytes = new byte[length];
+                char[] chars = new char[length];
+                for (int i = 0; i < length; ++i) {
+                    bytes[i] = (byte) ('a' + (i % 26));
+                    chars[i] = (char) bytes[i];
+                }
+                if (bad != -1) {
+                    bytes[bad] = (byte) 0xe9;
+                    chars[bad] = '\u0666';
+                }
+                String ascii = new String(bytes, "US-ASCII");
+                String latin1 = new String(bytes, "ISO-8859-1");
+                for (int i = 0; i < length; ++i) {
+                    char expected = (i == bad) ? '\ufffd' : (char) bytes[i];
+                    assertEquals(expected, ascii.charAt(i));
+                    assertEquals((char) (bytes[i] & 0xff), latin1.charAt(i));
+                }
+
+                String s = new String(chars);
+                byte[] asciiBytes = s.getBytes("US-ASCII");
+                byte[] utf8Bytes = s.getBytes("UTF-8");
+                assertEquals(length, asciiBytes.length);
+                assertEquals(length + ((bad != -1) ? 1 : 0), utf8Bytes.length);
+                for (int i = 0; i < length; ++i) {
+                    assertEquals((i == bad) ? (byte) '?' : bytes[i], asciiBytes[i]);
+                }
+                assertEquals(s, new String(utf8Bytes, "UTF-8"));
+            }
+        }
+    }
+
     /**
      * Tests a widely assumed performance characteristic of String.substring():
      * that it reuses the original's backing array. Although behavior should be
@@ -256,6 +293,27 @@ public class StringTest extends TestCase {
         assertEquals(LATIN_SMALL_DOTLESS_I, LATIN_CAPITAL_I.toLowerCase(tr_TR));
     }
 
+    public void testCaseMapping_tr_TR_ascii() {
+        Locale tr_TR = new Locale("tr", "TR");
+        assertEquals("t" + LATIN_SMALL_DOTLESS_I + "tle content-type",
+                "TITLE Content-Type".toLowerCase(tr_TR));
+        assertEquals("T" + LATIN_CAPITAL_I_WITH_DOT_ABOVE + "TLE CONTENT-TYPE",
+                "title Content-Type".toUpperCase(tr_TR));
+        assertEquals("content-length: 42", "CONTENT-LENGTH: 42".toLowerCase(tr_TR));
+        String unchanged = "already lower case, with no capital eye";
+        assertSame(unchanged, unchanged.toLowerCase(tr_TR));
+        unchanged = "ALREADY UPPER CASE";
+        assertSame(unchanged, unchanged.toUpperCase(tr_TR));
+    }
+
+    public void testCaseMapping_lt_ascii() {
+        Locale lt = new Locale("lt");
+        assertEquals("jis ir ji", "JIS IR JI".toLowerCase(lt));
+        assertEquals("JIS IR JI", "jis ir ji".toUpperCase(lt));
+        String unchanged = "abc xyz";
+        assertSame(unchanged, unchanged.toLowerCase(lt));
+    }
+
     public void testCaseMapping_en_US() {
         Locale en_US = new Locale("en", "US");
         assertEquals(LATIN_CAPITAL_I, LATIN_SMALL_I.toUpperCase(en_US));
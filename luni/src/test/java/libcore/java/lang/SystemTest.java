@@ -64,6 +64,45 @@ public class SystemTest extends TestCase {
         }
     }
 
+    public void testCoarseClocks() throws Exception {
+        // The coarse clocks may lag the precise ones by a tick, but no more.
+        long tolerance = 100;
+        assertTrue(Math.abs(System.coarseCurrentTimeMillis() - System.currentTimeMillis()) < tolerance);
+        long coarseNanos = System.coarseNanoTime();
+        assertTrue(Math.abs(coarseNanos - System.nanoTime()) < tolerance * 1000000L);
+        Thread.sleep(50);
+        assertTrue(System.coarseNanoTime() > coarseNanos);
+    }
+
+    public void testCycleCounter() throws Exception {
+        long frequency = System.cycleCounterFrequency();
+        assertTrue(frequency > 0);
+        assertEquals(frequency, System.cycleCounterFrequency());
+
+        long startCycles = System.cycleCounter();
+        long startNanos = System.nanoTime();
+        Thread.sleep(100);
+        long elapsedCycles = System.cycleCounter() - startCycles;
+        long elapsedNanos = System.nanoTime() - startNanos;
+        double seconds = (double) elapsedCycles / frequency;
+        assertEquals(elapsedNanos / 1e9, seconds, 0.05);
+    }
+
+    public void testAsynchronousLogging() throws Exception {
+        long droppedBefore = System.droppedLogMessageCount();
+        System.setAsynchronousLogging(true);
+        try {
+            for (int i = 0; i < 1000; ++i) {
+                System.logI("SystemTest.testAsynchronousLogging " + i + " \u00e9\u4e2d");
+            }
+            System.logI("SystemTest.testAsynchronousLogging", new Throwable());
+        } finally {
+            System.setAsynchronousLogging(false);
+        }
+        long dropped = System.droppedLogMessageCount() - droppedBefore;
+        assertTrue(dropped >= 0 && dropped <= 1000);
+    }
+
     public void testArrayCopyTargetNotArray() {
         try {
             System.arraycopy(new char[5], 0, "Hello", 0, 3);
@@ -184,4 +184,125 @@ public class BigIntegerTest extends junit.framework.TestCase {
 
         assertEquals(trimmed, extraZeroes);
     }
+
+    public void test_modPow_zeroAndNegativeExponents() throws Exception {
+        BigInteger m = BigInteger.valueOf(97);
+        BigInteger three = BigInteger.valueOf(3);
+        assertEquals(BigInteger.ONE, three.modPow(BigInteger.ZERO, m));
+        assertEquals(BigInteger.ZERO, three.modPow(BigInteger.ZERO, BigInteger.ONE));
+        BigInteger inverseCubed = three.modPow(BigInteger.valueOf(-3), m);
+        assertEquals(three.modInverse(m).pow(3).mod(m), inverseCubed);
+        try {
+            BigInteger.valueOf(6).modPow(BigInteger.valueOf(-1), BigInteger.valueOf(9));
+            fail();
+        } catch (ArithmeticException expected) {
+        }
+    }
+
+    public void test_fusedArithmetic() throws Exception {
+        Random r = new Random(0);
+        BigInteger[] lhs = new BigInteger[20];
+        BigInteger[] rhs = new BigInteger[20];
+        BigInteger expectedSum = BigInteger.ZERO;
+        BigInteger expectedDot = BigInteger.ZERO;
+        for (int i = 0; i < lhs.length; ++i) {
+            lhs[i] = new BigInteger(200, r).subtract(BigInteger.ONE.shiftLeft(199));
+            rhs[i] = new BigInteger(150, r);
+            expectedSum = expectedSum.add(lhs[i]);
+            expectedDot = expectedDot.add(lhs[i].multiply(rhs[i]));
+        }
+        assertEquals(expectedSum, BigInteger.sum(lhs));
+        assertEquals(BigInteger.ZERO, BigInteger.sum());
+        assertEquals(expectedDot, BigInteger.sumOfProducts(lhs, rhs));
+        assertEquals(lhs[0].multiply(rhs[0]).add(lhs[1]), lhs[0].multiplyAdd(rhs[0], lhs[1]));
+        BigInteger m = new BigInteger(100, r).setBit(99);
+        assertEquals(lhs[0].multiply(rhs[0]).mod(m), lhs[0].modMultiply(rhs[0], m));
+        try {
+            BigInteger.sumOfProducts(lhs, new BigInteger[1]);
+            fail();
+        } catch (IllegalArgumentException expected) {
+        }
+    }
+
+    public void test_recycledValuesStartClean() throws Exception {
+        // Freed native values are pooled and reused, and must not carry their old contents.
+        for (int round = 0; round < 4; ++round) {
+            for (int i = 1; i <= 100; ++i) {
+                assertEquals(-1, BigInteger.valueOf(-i).shiftLeft(100).signum());
+            }
+            System.gc();
+            System.runFinalization();
+            assertEquals(BigInteger.ZERO, BigInteger.sum());
+            assertEquals(BigInteger.valueOf(7),
+                    BigInteger.valueOf(2).multiplyAdd(BigInteger.valueOf(3), BigInteger.ONE));
+        }
+    }
+
+    public void test_smallArithmeticMatchesNative() throws Exception {
+        long[] values = {
+            0, 1, -1, 2, 0xffffffffL, -0xffffffffL, 0x100000000L, Long.MAX_VALUE, Long.MIN_VALUE,
+            Long.MIN_VALUE + 1, 123456789012345L, -987654321L,
+        };
+        for (long a : values) {
+            for (long b : values) {
+                // A value parsed from a string only has a native representation,
+                // so arithmetic on it takes the OpenSSL path.
+                BigInteger javaA = BigInteger.valueOf(a);
+                BigInteger javaB = BigInteger.valueOf(b);
+                BigInteger nativeA = new BigInteger(Long.toString(a));
+                BigInteger nativeB = new BigInteger(Long.toString(b));
+                String message = a + ", " + b;
+                assertEquals(message, nativeA.add(nativeB), javaA.add(javaB));
+                assertEquals(message, nativeA.subtract(nativeB), javaA.subtract(javaB));
+                assertEquals(message, nativeA.multiply(nativeB), javaA.multiply(javaB));
+                assertEquals(message, nativeA.compareTo(nativeB), javaA.compareTo(javaB));
+                assertEquals(message, nativeA.multiply(nativeB).toString(),
+                        javaA.multiply(javaB).toString());
+            }
+        }
+        // Results that outgrow two digits carry on correctly through the native path.
+        BigInteger big = BigInteger.valueOf(Long.MAX_VALUE).multiply(BigInteger.valueOf(Long.MAX_VALUE));
+        assertEquals(new BigInteger("85070591730234615847396907784232501249"), big);
+        assertEquals(new BigInteger("85070591730234615847396907784232501250"), big.add(BigInteger.ONE));
+    }
+
+    public void test_bufferConversions() throws Exception {
+        Random r = new Random(0);
+        byte[] buffer = new byte[1024];
+        for (int bits : new int[] { 1, 31, 32, 33, 63, 64, 65, 2048 }) {
+            BigInteger value = new BigInteger(bits, r).setBit(bits - 1);
+            byte[] magnitude = value.abs().toByteArray();
+            int offset = 7;
+            int length = value.writeMagnitude(buffer, offset);
+            // toByteArray adds a leading zero byte when the top bit is set.
+            int skip = (magnitude[0] == 0) ? 1 : 0;
+            assertEquals(magnitude.length - skip, length);
+            for (int i = 0; i < length; ++i) {
+                assertEquals(magnitude[i + skip], buffer[offset + i]);
+            }
+            assertEquals(value, new BigInteger(1, buffer, offset, length));
+            assertEquals(value.negate(), new BigInteger(-1, buffer, offset, length));
+
+            // hashCode needs the Java representation, built with bn2litEndInts, and
+            // shiftLeft's result is built from it with litEndInts2bn.
+            BigInteger shifted = value.shiftLeft(1);
+            assertEquals(value.hashCode(), new BigInteger(value.toString()).hashCode());
+            assertEquals(value.multiply(BigInteger.valueOf(2)), shifted);
+
+            byte[] twosComplement = value.negate().toByteArray();
+            System.arraycopy(twosComplement, 0, buffer, 3, twosComplement.length);
+            assertEquals(value.negate(), new BigInteger(buffer, 3, twosComplement.length));
+        }
+        assertEquals(0, BigInteger.ZERO.writeMagnitude(buffer, buffer.length));
+        try {
+            BigInteger.ONE.shiftLeft(64).writeMagnitude(buffer, buffer.length - 8);
+            fail();
+        } catch (IndexOutOfBoundsException expected) {
+        }
+        try {
+            new BigInteger(1, buffer, 1020, 5);
+            fail();
+        } catch (IndexOutOfBoundsException expected) {
+        }
+    }
 }
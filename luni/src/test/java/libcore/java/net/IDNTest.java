@@ -18,6 +18,7 @@ package libcore.java.net;
 
 import java.net.IDN;
 import junit.framework.TestCase;
+import libcore.icu.NativeIDN;
 
 public class IDNTest extends TestCase {
     private static String makePunyString(int xCount) {
@@ -37,4 +38,20 @@ public class IDNTest extends TestCase {
         String longInput = makePunyString(512);
         assertEquals(longInput, IDN.toUnicode(longInput));
     }
+
+    public void test_bulk() {
+        String longInput = makePunyString(512);
+        String[] unicode = NativeIDN.toUnicode(new String[] { makePunyString(0), longInput }, 0);
+        assertEquals("b\u00fccher", unicode[0]);
+        assertEquals(longInput, unicode[1]);
+
+        String[] ascii = NativeIDN.toASCII(new String[] { "b\u00fccher.de", "example.com" }, 0);
+        assertEquals("xn--bcher-kva.de", ascii[0]);
+        assertEquals("example.com", ascii[1]);
+        try {
+            NativeIDN.toASCII(new String[] { "example.com", longInput }, 0);
+            fail();
+        } catch (IllegalArgumentException expected) {
+        }
+    }
 }
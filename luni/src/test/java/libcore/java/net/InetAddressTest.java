@@ -16,12 +16,25 @@
 
 package libcore.java.net;
 
+import android.system.GaiException;
+import android.system.StructAddrinfo;
 import java.net.Inet4Address;
 import java.net.Inet6Address;
 import java.net.InetAddress;
 import java.net.NetworkInterface;
 import java.net.UnknownHostException;
+import java.util.Arrays;
 import java.util.Collections;
+import java.util.concurrent.Callable;
+import java.util.concurrent.CountDownLatch;
+import java.util.concurrent.ExecutorService;
+import java.util.concurrent.Executors;
+import java.util.concurrent.Future;
+import java.util.concurrent.TimeUnit;
+import java.util.concurrent.atomic.AtomicInteger;
+import libcore.io.ForwardingOs;
+import libcore.io.Libcore;
+import libcore.io.Os;
 import libcore.util.SerializationTester;
 
 public class InetAddressTest extends junit.framework.TestCase {
@@ -197,6 +210,189 @@ public class InetAddressTest extends junit.framework.TestCase {
         }
     }
 
+    public void test_getAllByName_concurrent() throws Exception {
+        // Concurrent lookups of the same host share one resolver query; all of them should see
+        // the same answer, and a failed lookup should fail for everyone.
+        InetAddress.clearDnsCache();
+        ExecutorService executor = Executors.newFixedThreadPool(8);
+        try {
+            Callable<InetAddress[]> lookup = new Callable<InetAddress[]>() {
+                public InetAddress[] call() throws Exception {
+                    return InetAddress.getAllByName("localhost");
+                }
+            };
+            Future<?>[] futures = new Future<?>[32];
+            for (int i = 0; i < futures.length; ++i) {
+                futures[i] = executor.submit(lookup);
+            }
+            InetAddress[] expected = (InetAddress[]) futures[0].get();
+            for (Future<?> future : futures) {
+                assertEquals(Arrays.asList(expected), Arrays.asList((InetAddress[]) future.get()));
+            }
+
+            Callable<Boolean> badLookup = new Callable<Boolean>() {
+                public Boolean call() throws Exception {
+                    try {
+                        InetAddress.getAllByName("does.not.exist.invalid");
+                        return false;
+                    } catch (UnknownHostException expected) {
+                        return true;
+                    }
+                }
+            };
+            for (int i = 0; i < futures.length; ++i) {
+                futures[i] = executor.submit(badLookup);
+            }
+            for (Future<?> future : futures) {
+                assertEquals(Boolean.TRUE, future.get());
+            }
+        } finally {
+            executor.shutdown();
+        }
+    }
+
+    public void test_getAllByName_coalescesLookups() throws Exception {
+        // While one thread is asking the resolver about a host, others asking about the same
+        // host wait for its answer instead of sending queries of their own.
+        final String host = "localhost";
+        final AtomicInteger queries = new AtomicInteger();
+        final CountDownLatch resolverEntered = new CountDownLatch(1);
+        final CountDownLatch releaseResolver = new CountDownLatch(1);
+        Os originalOs = Libcore.os;
+        Libcore.os = new ForwardingOs(originalOs) {
+            @Override public InetAddress[] getaddrinfo(String node, StructAddrinfo hints)
+                    throws GaiException {
+                if (host.equals(node)) {
+                    queries.incrementAndGet();
+                    resolverEntered.countDown();
+                    try {
+                        releaseResolver.await();
+                    } catch (InterruptedException e) {
+                        throw new AssertionError(e);
+                    }
+                }
+                return os.getaddrinfo(node, hints);
+            }
+        };
+        InetAddress.clearDnsCache();
+        try {
+            final InetAddress[][] results = new InetAddress[8][];
+            Thread[] threads = new Thread[results.length];
+            for (int i = 0; i < threads.length; ++i) {
+                final int index = i;
+                threads[i] = new Thread(new Runnable() {
+                    public void run() {
+                        try {
+                            results[index] = InetAddress.getAllByName(host);
+                        } catch (UnknownHostException e) {
+                            throw new AssertionError(e);
+                        }
+                    }
+                });
+            }
+            threads[0].start();
+            resolverEntered.await();
+            for (int i = 1; i < threads.length; ++i) {
+                threads[i].start();
+            }
+            // Wait for everyone to block: on the first lookup if lookups are coalesced, or in
+            // the resolver if they aren't.
+            for (int i = 1; i < threads.length; ++i) {
+                while (threads[i].getState() != Thread.State.WAITING) {
+                    Thread.sleep(10);
+                }
+            }
+            releaseResolver.countDown();
+            for (Thread thread : threads) {
+                thread.join();
+            }
+            assertEquals(1, queries.get());
+            for (InetAddress[] result : results) {
+                assertEquals(Arrays.asList(results[0]), Arrays.asList(result));
+            }
+        } finally {
+            releaseResolver.countDown();
+            Libcore.os = originalOs;
+            InetAddress.clearDnsCache();
+        }
+    }
+
+    public void test_getAllByNameAsync() throws Exception {
+        // A stalled resolver doesn't block the caller, or use more than a few threads however
+        // many lookups are waiting on it.
+        final AtomicInteger queries = new AtomicInteger();
+        final AtomicInteger inResolver = new AtomicInteger();
+        final AtomicInteger maxInResolver = new AtomicInteger();
+        final CountDownLatch releaseResolver = new CountDownLatch(1);
+        Os originalOs = Libcore.os;
+        Libcore.os = new ForwardingOs(originalOs) {
+            @Override public InetAddress[] getaddrinfo(String node, StructAddrinfo hints)
+                    throws GaiException {
+                queries.incrementAndGet();
+                int count = inResolver.incrementAndGet();
+                while (true) {
+                    int max = maxInResolver.get();
+                    if (count <= max || maxInResolver.compareAndSet(max, count)) {
+                        break;
+                    }
+                }
+                try {
+                    releaseResolver.await();
+                } catch (InterruptedException e) {
+                    throw new AssertionError(e);
+                } finally {
+                    inResolver.decrementAndGet();
+                }
+                return os.getaddrinfo("localhost", hints);
+            }
+        };
+        InetAddress.clearDnsCache();
+        try {
+            final int hostCount = 16;
+            final int lookupsPerHost = 8;
+            final CountDownLatch done = new CountDownLatch(hostCount * lookupsPerHost);
+            final AtomicInteger failures = new AtomicInteger();
+            InetAddress.LookupCallback callback = new InetAddress.LookupCallback() {
+                public void onLookupComplete(String host, InetAddress[] addresses,
+                        UnknownHostException failure) {
+                    if (addresses == null || addresses.length == 0) {
+                        failures.incrementAndGet();
+                    }
+                    done.countDown();
+                }
+            };
+            for (int i = 0; i < lookupsPerHost; ++i) {
+                for (int host = 0; host < hostCount; ++host) {
+                    InetAddress.getAllByNameAsync("host" + host + ".example.com", callback);
+                }
+            }
+            assertEquals(hostCount * lookupsPerHost, done.getCount());
+            Thread.sleep(500);
+            assertTrue(maxInResolver.get() > 0);
+            assertTrue(maxInResolver.get() <= 4);
+
+            releaseResolver.countDown();
+            assertTrue(done.await(30, TimeUnit.SECONDS));
+            assertEquals(0, failures.get());
+            assertEquals(hostCount, queries.get());
+
+            // Once cached, the answer comes back right away.
+            final InetAddress[][] cached = new InetAddress[1][];
+            InetAddress.getAllByNameAsync("host0.example.com", new InetAddress.LookupCallback() {
+                public void onLookupComplete(String host, InetAddress[] addresses,
+                        UnknownHostException failure) {
+                    cached[0] = addresses;
+                }
+            });
+            assertNotNull(cached[0]);
+            assertEquals(hostCount, queries.get());
+        } finally {
+            releaseResolver.countDown();
+            Libcore.os = originalOs;
+            InetAddress.clearDnsCache();
+        }
+    }
+
     public void test_getLoopbackAddress() throws Exception {
         assertTrue(InetAddress.getLoopbackAddress().isLoopbackAddress());
     }
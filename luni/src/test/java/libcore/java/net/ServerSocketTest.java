@@ -18,9 +18,13 @@ package libcore.java.net;
 
 import java.io.IOException;
 import java.net.Inet4Address;
+import java.net.Inet6Address;
+import java.net.InetAddress;
 import java.net.InetSocketAddress;
+import java.net.NetworkInterface;
 import java.net.ServerSocket;
 import java.net.Socket;
+import java.util.Collections;
 
 public class ServerSocketTest extends junit.framework.TestCase {
     public void testTimeoutAfterAccept() throws Exception {
@@ -46,6 +50,53 @@ public class ServerSocketTest extends junit.framework.TestCase {
         assertEquals(0, result[0].getSoTimeout());
     }
 
+    public void testAcceptReportsPeer() throws Exception {
+        ServerSocket ss = new ServerSocket(0, 10, InetAddress.getByName("127.0.0.1"));
+        try {
+            for (int i = 0; i < 3; ++i) {
+                Socket client = new Socket(ss.getInetAddress(), ss.getLocalPort());
+                Socket accepted = ss.accept();
+                // IPv4 peers are reported as Inet4Address, never IPv4-mapped.
+                assertTrue(accepted.getInetAddress() instanceof Inet4Address);
+                assertEquals(client.getLocalAddress(), accepted.getInetAddress());
+                assertEquals(client.getLocalPort(), accepted.getPort());
+                client.close();
+                accepted.close();
+            }
+        } finally {
+            ss.close();
+        }
+    }
+
+    public void testAcceptReportsScopedPeer() throws Exception {
+        Inet6Address linkLocal = null;
+        for (NetworkInterface ni : Collections.list(NetworkInterface.getNetworkInterfaces())) {
+            for (InetAddress address : Collections.list(ni.getInetAddresses())) {
+                if (address instanceof Inet6Address && address.isLinkLocalAddress() && ni.isUp()) {
+                    linkLocal = (Inet6Address) address;
+                }
+            }
+        }
+        if (linkLocal == null) {
+            return; // There's no interface with a link-local address to test with.
+        }
+        assertTrue(linkLocal.getScopeId() != 0);
+
+        ServerSocket ss = new ServerSocket(0, 10, linkLocal);
+        try {
+            Socket client = new Socket(linkLocal, ss.getLocalPort());
+            Socket accepted = ss.accept();
+            Inet6Address peer = (Inet6Address) accepted.getInetAddress();
+            assertEquals(linkLocal, peer);
+            assertEquals(linkLocal.getScopeId(), peer.getScopeId());
+            assertEquals(client.getLocalPort(), accepted.getPort());
+            client.close();
+            accepted.close();
+        } finally {
+            ss.close();
+        }
+    }
+
     public void testInitialState() throws Exception {
         ServerSocket ss = new ServerSocket();
         try {
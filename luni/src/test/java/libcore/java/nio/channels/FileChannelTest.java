@@ -23,6 +23,7 @@ import java.io.IOException;
 import java.io.RandomAccessFile;
 import java.nio.ByteBuffer;
 import java.nio.channels.FileChannel;
+import java.util.Arrays;
 import libcore.io.IoUtils;
 
 public class FileChannelTest extends junit.framework.TestCase {
@@ -215,6 +216,24 @@ public class FileChannelTest extends junit.framework.TestCase {
         fc.close();
     }
 
+    public void test_transferTo_fileChannel() throws Exception {
+        FileChannel src = createFileContainingBytes(new byte[] { 1, 2, 3, 4, 5, 6 });
+        FileChannel dst = createFileContainingBytes(new byte[] { 9 });
+        dst.position(1);
+
+        assertEquals(4, src.transferTo(1, 4, dst));
+        assertEquals(0, src.position());
+        assertEquals(5, dst.position());
+        assertEquals(5, dst.size());
+
+        ByteBuffer bb = ByteBuffer.allocate(5);
+        dst.read(bb, 0);
+        assertEquals(Arrays.toString(new byte[] { 9, 2, 3, 4, 5 }), Arrays.toString(bb.array()));
+
+        src.close();
+        dst.close();
+    }
+
     private static FileChannel createFileContainingBytes(byte[] bytes) throws IOException {
         File tmp = File.createTempFile("FileChannelTest", "tmp");
         FileOutputStream fos = new FileOutputStream(tmp, true);
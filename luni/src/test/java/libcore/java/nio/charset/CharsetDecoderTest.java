@@ -24,6 +24,7 @@ import java.nio.charset.CharsetDecoder;
 import java.nio.charset.CharsetEncoder;
 import java.nio.charset.CoderResult;
 import java.nio.charset.CodingErrorAction;
+import java.util.Arrays;
 
 public class CharsetDecoderTest extends junit.framework.TestCase {
     // None of the harmony or jtreg tests actually check that replaceWith does the right thing!
@@ -105,4 +106,50 @@ public class CharsetDecoderTest extends junit.framework.TestCase {
         assertEquals(1, cb.position());
         assertEquals('\u2603', cb.get(0));
     }
+
+    public void testMalformedInputAfterLongAsciiPrefix() throws Exception {
+        for (String charsetName : new String[] { "UTF-8", "US-ASCII" }) {
+            byte[] bytes = new byte[100];
+            Arrays.fill(bytes, (byte) 'a');
+            bytes[70] = (byte) 0xff;
+            CharsetDecoder decoder = Charset.forName(charsetName).newDecoder();
+            ByteBuffer bb = ByteBuffer.wrap(bytes);
+            CharBuffer cb = CharBuffer.allocate(128);
+            CoderResult cr = decoder.decode(bb, cb, true);
+            assertTrue(charsetName, cr.isMalformed());
+            assertEquals(charsetName, 1, cr.length());
+            assertEquals(charsetName, 70, bb.position());
+            assertEquals(charsetName, 70, cb.position());
+        }
+    }
+
+    public void testUtf8SequenceSplitBeforeAscii() throws Exception {
+        // The second write must finish the pending sequence before decoding the ASCII after it.
+        CharsetDecoder decoder = Charset.forName("UTF-8").newDecoder();
+        CharBuffer cb = CharBuffer.allocate(128);
+        byte[] rest = new byte[40];
+        Arrays.fill(rest, (byte) 'x');
+        rest[0] = (byte) 0x98;
+        rest[1] = (byte) 0x83;
+        assertEquals(CoderResult.UNDERFLOW,
+                decoder.decode(ByteBuffer.wrap(new byte[] { (byte) 0xe2 }), cb, false));
+        assertEquals(CoderResult.UNDERFLOW, decoder.decode(ByteBuffer.wrap(rest), cb, true));
+        cb.flip();
+        assertEquals('\u2603', cb.get(0));
+        assertEquals(39, cb.remaining());
+    }
+
+    public void testUtf16Decoding() throws Exception {
+        String s = "abcdefghijklmnop\u2603\ud83d\ude00qrstuvwxyz0123456789";
+        for (String charsetName : new String[] { "UTF-16BE", "UTF-16LE" }) {
+            byte[] bytes = s.getBytes(charsetName);
+            assertEquals(charsetName, s, new String(bytes, charsetName));
+            // An odd trailing byte is left for the next call.
+            CharsetDecoder decoder = Charset.forName(charsetName).newDecoder();
+            ByteBuffer bb = ByteBuffer.wrap(bytes, 0, 33);
+            CharBuffer cb = CharBuffer.allocate(64);
+            assertEquals(CoderResult.UNDERFLOW, decoder.decode(bb, cb, false));
+            assertEquals(16, cb.position());
+        }
+    }
 }
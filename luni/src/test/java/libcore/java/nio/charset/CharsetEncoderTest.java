@@ -161,4 +161,98 @@ public class CharsetEncoderTest extends junit.framework.TestCase {
         assertEquals(CoderResult.UNDERFLOW, cr);
         assertEquals(8, bb.position());
     }
+
+    public void testUnmappableCharAfterLongPrefix() throws Exception {
+        String[] charsetNames = new String[] { "US-ASCII", "ISO-8859-1" };
+        char[] unmappable = new char[] { '\u00e9', '\u2603' };
+        for (int i = 0; i < charsetNames.length; ++i) {
+            char[] chars = new char[100];
+            Arrays.fill(chars, 'a');
+            chars[70] = unmappable[i];
+            CharsetEncoder encoder = Charset.forName(charsetNames[i]).newEncoder();
+            CharBuffer cb = CharBuffer.wrap(chars);
+            ByteBuffer bb = ByteBuffer.allocate(128);
+            CoderResult cr = encoder.encode(cb, bb, true);
+            assertTrue(charsetNames[i], cr.isUnmappable());
+            assertEquals(charsetNames[i], 70, cb.position());
+            assertEquals(charsetNames[i], 70, bb.position());
+        }
+    }
+
+    public void testUtf16SurrogatePairAfterLongPrefix() throws Exception {
+        String s = "abcdefghijklmnopqrstuvwxyz\ud83d\ude00abcdefghijklmnopqrstuvwxyz";
+        for (String charsetName : new String[] { "UTF-16BE", "UTF-16LE" }) {
+            byte[] bytes = s.getBytes(charsetName);
+            assertEquals(charsetName, 2 * s.length(), bytes.length);
+            assertEquals(charsetName, s, new String(bytes, charsetName));
+            // A lone high surrogate at the end of one write must pair with the next write.
+            CharsetEncoder encoder = Charset.forName(charsetName).newEncoder();
+            ByteBuffer bb = ByteBuffer.allocate(bytes.length);
+            assertEquals(CoderResult.UNDERFLOW,
+                    encoder.encode(CharBuffer.wrap(s, 0, 27), bb, false));
+            assertEquals(CoderResult.UNDERFLOW,
+                    encoder.encode(CharBuffer.wrap(s, 27, s.length()), bb, true));
+            assertTrue(charsetName, Arrays.equals(bytes, bb.array()));
+        }
+    }
+
+    // UTF-8, ISO-8859-1 and US-ASCII write straight into direct buffers where they can; the
+    // bytes and the coder results must be the same as going through a heap buffer.
+    public void testDirectOutput() throws Exception {
+        String s = "h\u00e9llo \u0666 \ud83d\ude00 w\u00f6rld";
+        for (String charsetName : new String[] { "UTF-8", "ISO-8859-1", "US-ASCII" }) {
+            Charset cs = Charset.forName(charsetName);
+            CharsetEncoder encoder = cs.newEncoder();
+            encoder.onUnmappableCharacter(CodingErrorAction.REPLACE);
+            ByteBuffer heap = encoder.encode(CharBuffer.wrap(s));
+            byte[] expected = new byte[heap.remaining()];
+            heap.get(expected);
+
+            // Split the input (and so, sometimes, a surrogate pair) at every point, and use an
+            // output buffer small enough to overflow.
+            for (int split = 0; split <= s.length(); ++split) {
+                encoder.reset();
+                ByteBuffer out = ByteBuffer.allocateDirect(5);
+                ByteBuffer all = ByteBuffer.allocate(expected.length);
+                CharBuffer[] inputs = new CharBuffer[] {
+                    CharBuffer.wrap(s.toCharArray(), 0, split), CharBuffer.wrap(s.substring(split)),
+                };
+                CharBuffer pending = CharBuffer.allocate(s.length());
+                for (int i = 0; i < inputs.length; ++i) {
+                    pending.put(inputs[i]).flip();
+                    boolean endOfInput = (i == inputs.length - 1);
+                    while (true) {
+                        CoderResult result = encoder.encode(pending, out, endOfInput);
+                        assertFalse(charsetName, result.isError());
+                        out.flip();
+                        all.put(out);
+                        out.clear();
+                        if (result.isUnderflow()) {
+                            break;
+                        }
+                    }
+                    pending.compact();
+                }
+                while (encoder.flush(out).isOverflow()) {
+                    out.flip();
+                    all.put(out);
+                    out.clear();
+                }
+                out.flip();
+                all.put(out);
+                assertEquals(charsetName + " " + split, Arrays.toString(expected),
+                        Arrays.toString(all.array()));
+            }
+
+            // Errors are still reported at the right place.
+            encoder.reset();
+            encoder.onUnmappableCharacter(CodingErrorAction.REPORT);
+            encoder.onMalformedInput(CodingErrorAction.REPORT);
+            CharBuffer in = CharBuffer.wrap("abc\ud800def");
+            ByteBuffer out = ByteBuffer.allocateDirect(16);
+            assertTrue(charsetName, encoder.encode(in, out, true).isMalformed());
+            assertEquals(charsetName, 3, in.position());
+            assertEquals(charsetName, 3, out.position());
+        }
+    }
 }
@@ -0,0 +1,59 @@
+/*
+ * Copyright (C) 2014 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+package libcore.java.nio.charset;
+
+import java.nio.ByteBuffer;
+import java.nio.NioUtils;
+import java.nio.charset.Charsets;
+import java.util.Arrays;
+
+public class CharsetsTest extends junit.framework.TestCase {
+    private static final String MIXED = "h\u00e9llo \u0666 \ud800\udc00 w\u00f6rld \ud800!";
+
+    private static byte[] toArray(ByteBuffer buffer, int length) {
+        byte[] result = new byte[length];
+        for (int i = 0; i < length; ++i) {
+            result[i] = buffer.get(i);
+        }
+        return result;
+    }
+
+    public void test_toSingleByteBytesDirect() throws Exception {
+        char[] chars = "xa\u00e9\u0666bx".toCharArray();
+        ByteBuffer buffer = ByteBuffer.allocateDirect(4);
+        long address = NioUtils.getDirectBufferAddress(buffer);
+
+        Charsets.toAsciiBytesDirect(chars, 1, 4, address);
+        assertEquals("[97, 63, 63, 98]", Arrays.toString(toArray(buffer, 4)));
+        Charsets.toIsoLatin1BytesDirect(chars, 1, 4, address);
+        assertEquals("[97, -23, 63, 98]", Arrays.toString(toArray(buffer, 4)));
+    }
+
+    public void test_toUtf8BytesDirect() throws Exception {
+        char[] chars = MIXED.toCharArray();
+        byte[] expected = Charsets.toUtf8Bytes(chars, 0, chars.length);
+        ByteBuffer buffer = ByteBuffer.allocateDirect(chars.length * 3);
+        long address = NioUtils.getDirectBufferAddress(buffer);
+
+        assertEquals(expected.length, Charsets.toUtf8BytesDirect(chars, 0, chars.length, address, chars.length * 3));
+        assertEquals(Arrays.toString(expected), Arrays.toString(toArray(buffer, expected.length)));
+
+        // An exactly-sized destination is fine, but a byte less is not.
+        assertEquals(expected.length, Charsets.toUtf8BytesDirect(chars, 0, chars.length, address, expected.length));
+        assertEquals(-1, Charsets.toUtf8BytesDirect(chars, 0, chars.length, address, expected.length - 1));
+    }
+}
@@ -18,6 +18,7 @@ package libcore.java.text;
 
 import java.text.BreakIterator;
 import java.util.ArrayList;
+import java.util.Arrays;
 import java.util.Locale;
 
 public class BreakIteratorTest extends junit.framework.TestCase {
@@ -200,4 +201,49 @@ public class BreakIteratorTest extends junit.framework.TestCase {
             t.join();
         }
     }
+
+    public void testBoundaries() {
+        String text = "The quick brown fox. Jumps over the lazy dog! Again?";
+        for (Locale l : new Locale[] { Locale.US, Locale.FRANCE }) {
+            BreakIterator[] iterators = new BreakIterator[] {
+                BreakIterator.getCharacterInstance(l), BreakIterator.getWordInstance(l),
+                BreakIterator.getLineInstance(l), BreakIterator.getSentenceInstance(l),
+            };
+            for (BreakIterator it : iterators) {
+                it.setText(text);
+                ArrayList<Integer> expected = new ArrayList<Integer>();
+                for (int b = it.following(9); b != BreakIterator.DONE; b = it.next()) {
+                    expected.add(b);
+                }
+
+                // Fill in chunks of three, the way a tokenizer with a fixed buffer would.
+                ArrayList<Integer> actual = new ArrayList<Integer>();
+                int[] buffer = new int[3];
+                int from = 10;
+                int count;
+                while ((count = it.boundaries(from, buffer)) > 0) {
+                    for (int i = 0; i < count; ++i) {
+                        actual.add(buffer[i]);
+                    }
+                    from = buffer[count - 1] + 1;
+                }
+                assertEquals(expected, actual);
+
+                int[] all = new int[text.length() + 1];
+                count = it.boundaries(0, all);
+                assertEquals(0, all[0]);
+                assertEquals(text.length(), all[count - 1]);
+            }
+        }
+    }
+
+    // More distinct locales than the native prototype cache keeps must still work.
+    public void testManyLocales() {
+        for (int i = 0; i < 300; ++i) {
+            BreakIterator it = BreakIterator.getWordInstance(new Locale("en", "US", "V" + i));
+            it.setText("hello world");
+            assertEquals(5, it.following(0));
+            assertEquals(6, it.next());
+        }
+    }
 }
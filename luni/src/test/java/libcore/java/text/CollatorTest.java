@@ -18,10 +18,12 @@ package libcore.java.text;
 
 import java.text.CharacterIterator;
 import java.text.CollationElementIterator;
+import java.text.CollationKey;
 import java.text.Collator;
 import java.text.ParseException;
 import java.text.RuleBasedCollator;
 import java.text.StringCharacterIterator;
+import java.util.Arrays;
 import java.util.Locale;
 
 public class CollatorTest extends junit.framework.TestCase {
@@ -149,4 +151,57 @@ public class CollatorTest extends junit.framework.TestCase {
     public void testGetCollationElementIteratorCharacterIterator_de_DE() throws Exception {
         assertGetCollationElementIteratorCharacterIterator(new Locale("de", "DE", ""), "\u00e6b", 0, 1, 1, 2);
     }
+
+    public void testGetCollationKeys() throws Exception {
+        RuleBasedCollator c = (RuleBasedCollator) Collator.getInstance(Locale.US);
+        String[] sources = new String[] { "", "abc", "\u00e9t\u00e9", "ABC", "" };
+        CollationKey[] keys = c.getCollationKeys(sources);
+        assertEquals(sources.length, keys.length);
+        for (int i = 0; i < sources.length; ++i) {
+            CollationKey expected = c.getCollationKey(sources[i]);
+            assertEquals(sources[i], keys[i].getSourceString());
+            assertTrue(Arrays.equals(expected.toByteArray(), keys[i].toByteArray()));
+        }
+    }
+
+    public void testSort() throws Exception {
+        RuleBasedCollator c = (RuleBasedCollator) Collator.getInstance(Locale.US);
+        c.setStrength(Collator.PRIMARY);
+        String[] strings = new String[] { "peach", "P\u00e9ch\u00e9", "p\u00eache", "Peach",
+                "apple", "", "\u00e9clair", "zebra", "apple" };
+        String[] expected = strings.clone();
+        Arrays.sort(expected, c);
+        c.sort(strings);
+        // Both sorts are stable, so primary-equal strings keep their relative order.
+        assertEquals(Arrays.toString(expected), Arrays.toString(strings));
+    }
+
+    public void testSortRejectsNull() throws Exception {
+        RuleBasedCollator c = (RuleBasedCollator) Collator.getInstance(Locale.US);
+        try {
+            c.sort(new String[] { "a", null });
+            fail();
+        } catch (NullPointerException expected) {
+        }
+    }
+
+    public void testInstancesFromSameLocaleAreIndependent() throws Exception {
+        Collator c1 = Collator.getInstance(Locale.FRANCE);
+        Collator c2 = Collator.getInstance(Locale.FRANCE);
+        c1.setStrength(Collator.PRIMARY);
+        assertEquals(0, c1.compare("e", "\u00e9"));
+        assertEquals(Collator.TERTIARY, c2.getStrength());
+        assertTrue(c2.compare("e", "\u00e9") < 0);
+        assertEquals(Collator.TERTIARY, Collator.getInstance(Locale.FRANCE).getStrength());
+    }
+
+    public void testInstancesFromSameRulesAreIndependent() throws Exception {
+        String rules = "< a, A < b, B < c, C";
+        RuleBasedCollator c1 = new RuleBasedCollator(rules);
+        RuleBasedCollator c2 = new RuleBasedCollator(rules);
+        c1.setStrength(Collator.PRIMARY);
+        assertEquals(0, c1.compare("a", "A"));
+        assertTrue(c2.compare("a", "A") != 0);
+        assertEquals(c1.getRules(), c2.getRules());
+    }
 }
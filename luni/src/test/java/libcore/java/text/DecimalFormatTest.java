@@ -26,6 +26,7 @@ import java.text.NumberFormat;
 import java.text.ParsePosition;
 import java.util.Currency;
 import java.util.Locale;
+import libcore.icu.NativeDecimalFormat;
 
 public class DecimalFormatTest extends junit.framework.TestCase {
     public void test_exponentSeparator() throws Exception {
@@ -318,4 +319,46 @@ public class DecimalFormatTest extends junit.framework.TestCase {
         localeCurrencyFormat.setCurrency(currency);
         return localeCurrencyFormat.format(1000);
     }
+
+    public void testBulkFormat() throws Exception {
+        DecimalFormat df = new DecimalFormat("#,##0.###", DecimalFormatSymbols.getInstance(Locale.US));
+        double[] doubles = new double[] { 0, -1.5, 1234567.891, 0.0005, Double.NaN };
+        int[] offsets = new int[doubles.length + 1];
+        String all = new String(df.format(doubles, offsets));
+        assertEquals(all.length(), offsets[doubles.length]);
+        for (int i = 0; i < doubles.length; ++i) {
+            assertEquals(df.format(doubles[i]), all.substring(offsets[i], offsets[i + 1]));
+        }
+
+        long[] longs = new long[] { Long.MIN_VALUE, -1, 0, 1000, Long.MAX_VALUE };
+        offsets = new int[longs.length + 1];
+        all = new String(df.format(longs, offsets));
+        for (int i = 0; i < longs.length; ++i) {
+            assertEquals(df.format(longs[i]), all.substring(offsets[i], offsets[i + 1]));
+        }
+
+        try {
+            df.format(longs, new int[longs.length]);
+            fail();
+        } catch (IllegalArgumentException expected) {
+        }
+    }
+
+    public void testBulkParse() throws Exception {
+        NativeDecimalFormat ndf = new NativeDecimalFormat("#,##0.###",
+                DecimalFormatSymbols.getInstance(Locale.US));
+        double[] expected = new double[] { 0, -1.5, 1234567.891, 42 };
+        int[] offsets = new int[expected.length + 1];
+        char[] text = ndf.formatDoubles(expected, offsets);
+        double[] values = new double[expected.length];
+        assertEquals(expected.length, ndf.parseDoubles(text, offsets, values));
+        for (int i = 0; i < expected.length; ++i) {
+            assertEquals(expected[i], values[i]);
+        }
+
+        // Parsing stops at the first number with junk in it.
+        text = "12x34".toCharArray();
+        assertEquals(1, ndf.parseDoubles(text, new int[] { 0, 2, 5 }, values));
+        assertEquals(12.0, values[0]);
+    }
 }
@@ -50,6 +50,25 @@ public class NormalizerTest extends junit.framework.TestCase {
         }
     }
 
+    public void testNormalize_alreadyNormalized() {
+        // Input that's already normalized comes back as is.
+        String ascii = "user_name-42";
+        for (Normalizer.Form form : Normalizer.Form.values()) {
+            assertSame(ascii, Normalizer.normalize(ascii, form));
+            assertTrue(Normalizer.isNormalized(ascii, form));
+        }
+        String latin1 = "caf\u00e9";
+        assertSame(latin1, Normalizer.normalize(latin1, Normalizer.Form.NFC));
+        String cjk = "caf\u00e9 \u4e2d\u6587";
+        assertSame(cjk, Normalizer.normalize(cjk, Normalizer.Form.NFC));
+
+        // Only the part after the normalized prefix changes.
+        assertEquals("cafe\u0301", Normalizer.normalize(latin1, Normalizer.Form.NFD));
+        assertEquals("abc\u00e9xyz", Normalizer.normalize("abce\u0301xyz", Normalizer.Form.NFC));
+        assertEquals("a b2", Normalizer.normalize("a\u00a0b\u00b2", Normalizer.Form.NFKC));
+        assertFalse(Normalizer.isNormalized("a\u00a0b", Normalizer.Form.NFKD));
+    }
+
     public void testIsNormalized() {
         String target;
 
@@ -31,6 +31,49 @@ public class OldBidiTest extends TestCase {
         }
     }
 
+    public void testLeftToRightText() {
+        // Text with no right-to-left characters doesn't need ICU, but must look as if it did.
+        for (int flags : new int[] { Bidi.DIRECTION_LEFT_TO_RIGHT,
+                Bidi.DIRECTION_DEFAULT_LEFT_TO_RIGHT, 173 }) {
+            Bidi bd = new Bidi("hello, world \u00e9\u0436 123", flags);
+            assertTrue(bd.isLeftToRight());
+            assertFalse(bd.isMixed());
+            assertTrue(bd.baseIsLeftToRight());
+            assertEquals(0, bd.getBaseLevel());
+            assertEquals(1, bd.getRunCount());
+            assertEquals(0, bd.getRunStart(0));
+            assertEquals(19, bd.getRunLimit(0));
+            assertEquals(0, bd.getRunLevel(0));
+            assertEquals(0, bd.getLevelAt(18));
+            assertEquals(19, bd.getLength());
+        }
+        assertEquals(0, new Bidi("", Bidi.DIRECTION_LEFT_TO_RIGHT).getLength());
+
+        char[] text = "abc\u05d0def".toCharArray();
+        assertTrue(Bidi.requiresBidi(text, 0, text.length));
+        assertFalse(Bidi.requiresBidi(text, 0, 3));
+        assertFalse(Bidi.requiresBidi(text, 4, 7));
+        // A right-to-left mark, an Arabic digit, and an override each need the full algorithm.
+        assertTrue(Bidi.requiresBidi("ab\u200fcd".toCharArray(), 0, 5));
+        assertTrue(Bidi.requiresBidi("12\u06613".toCharArray(), 0, 4));
+        assertTrue(new Bidi("ab\u202ecd", Bidi.DIRECTION_LEFT_TO_RIGHT).isMixed());
+    }
+
+    public void testRuns() {
+        Bidi bd = new Bidi("abc \u05d0\u05d1\u05d2 def", Bidi.DIRECTION_LEFT_TO_RIGHT);
+        assertTrue(bd.isMixed());
+        assertEquals(3, bd.getRunCount());
+        assertEquals(0, bd.getRunStart(0));
+        assertEquals(4, bd.getRunLimit(0));
+        assertEquals(0, bd.getRunLevel(0));
+        assertEquals(4, bd.getRunStart(1));
+        assertEquals(7, bd.getRunLimit(1));
+        assertEquals(1, bd.getRunLevel(1));
+        assertEquals(7, bd.getRunStart(2));
+        assertEquals(11, bd.getRunLimit(2));
+        assertEquals(0, bd.getRunLevel(2));
+    }
+
     public void testCreateLineBidi_AndroidFailure() {
         // This is a difference between ICU4C and the RI. ICU4C insists that 'limit' is strictly
         // greater than 'start'. We have to paper over this in our Java code.
@@ -19,12 +19,16 @@ package libcore.java.util.jar;
 import junit.framework.TestCase;
 import tests.support.resource.Support_Resources;
 import java.io.File;
+import java.io.FileOutputStream;
 import java.io.IOException;
+import java.nio.ByteBuffer;
 import java.nio.charset.Charset;
 import java.util.HashMap;
 import java.util.Iterator;
 import java.util.jar.StrictJarFile;
+import java.util.zip.CRC32;
 import java.util.zip.ZipEntry;
+import java.util.zip.ZipOutputStream;
 import libcore.io.Streams;
 
 public class StrictJarFileTest extends TestCase {
@@ -105,6 +109,62 @@ public class StrictJarFileTest extends TestCase {
                 Charset.forName("UTF-8")));
     }
 
+    public void testFindEntry_matchesIteration() throws Exception {
+        Support_Resources.copyFile(resources, null, JAR_1);
+        StrictJarFile jarFile = new StrictJarFile(new File(resources, JAR_1).getAbsolutePath());
+
+        Iterator<ZipEntry> it = jarFile.iterator();
+        while (it.hasNext()) {
+            ZipEntry expected = it.next();
+            ZipEntry actual = jarFile.findEntry(expected.getName());
+            assertNotSame(expected, actual);
+            assertEquals(expected.getName(), actual.getName());
+            assertEquals(expected.getCrc(), actual.getCrc());
+            assertEquals(expected.getSize(), actual.getSize());
+            assertEquals(expected.getDataOffset(), actual.getDataOffset());
+        }
+        // Entries are fresh objects, so callers can't corrupt each other's view.
+        jarFile.findEntry("Blah.txt").setComment("changed");
+        assertNull(jarFile.findEntry("Blah.txt").getComment());
+    }
+
+    public void testGetStoredEntryBuffer() throws Exception {
+        byte[] data = "stored data".getBytes("UTF-8");
+        File file = new File(resources, "stored.jar");
+        ZipOutputStream out = new ZipOutputStream(new FileOutputStream(file));
+        ZipEntry stored = new ZipEntry("a/stored.bin");
+        stored.setMethod(ZipEntry.STORED);
+        stored.setSize(data.length);
+        CRC32 crc = new CRC32();
+        crc.update(data);
+        stored.setCrc(crc.getValue());
+        out.putNextEntry(stored);
+        out.write(data);
+        out.putNextEntry(new ZipEntry("b/deflated.txt"));
+        out.write(data);
+        out.close();
+
+        StrictJarFile jarFile = new StrictJarFile(file.getAbsolutePath());
+        ByteBuffer buffer = jarFile.getStoredEntryBuffer(jarFile.findEntry("a/stored.bin"));
+        assertTrue(buffer.isDirect());
+        assertTrue(buffer.isReadOnly());
+        assertEquals(0, buffer.position());
+        assertEquals(data.length, buffer.remaining());
+        byte[] actual = new byte[data.length];
+        buffer.get(actual);
+        assertEquals("stored data", new String(actual, "UTF-8"));
+
+        try {
+            jarFile.getStoredEntryBuffer(jarFile.findEntry("b/deflated.txt"));
+            fail();
+        } catch (IllegalArgumentException expected) {
+        }
+
+        // The buffer outlives the jar file.
+        jarFile.close();
+        assertEquals('s', buffer.get(0));
+    }
+
     public void testGetManifest() throws Exception {
         Support_Resources.copyFile(resources, null, JAR_1);
         StrictJarFile jarFile = new StrictJarFile(new File(resources, JAR_1).getAbsolutePath());
@@ -0,0 +1,117 @@
+/*
+ * Copyright (C) 2014 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+package libcore.java.util.regex;
+
+import java.util.regex.Matcher;
+import java.util.regex.Pattern;
+import junit.framework.TestCase;
+
+public final class PatternTest extends TestCase {
+    public void testSharedCompiledPatterns() throws Exception {
+        // Patterns with the same regex and flags share a native compiled
+        // pattern, but must still behave independently.
+        Pattern a = Pattern.compile("a(b+)c");
+        Pattern b = Pattern.compile("a(b+)c");
+        Pattern caseInsensitive = Pattern.compile("a(b+)c", Pattern.CASE_INSENSITIVE);
+        Matcher ma = a.matcher("xxabbbcxx");
+        Matcher mb = b.matcher("abc");
+        assertTrue(ma.find());
+        assertTrue(mb.find());
+        assertEquals("bbb", ma.group(1));
+        assertEquals("b", mb.group(1));
+        assertFalse(a.matcher("ABC").matches());
+        assertTrue(caseInsensitive.matcher("ABC").matches());
+    }
+
+    public void testEvictedPatternsStillWork() throws Exception {
+        Pattern first = Pattern.compile("first(\\d+)");
+        // Push 'first' out of the cache.
+        for (int i = 0; i < 100; ++i) {
+            assertTrue(Pattern.compile("p" + i).matcher("p" + i).matches());
+        }
+        Matcher m = first.matcher("first123");
+        assertTrue(m.matches());
+        assertEquals("123", m.group(1));
+        assertTrue(Pattern.compile("first(\\d+)").matcher("first4").matches());
+    }
+
+    public void testRepeatedFindOnSameInput() throws Exception {
+        StringBuilder input = new StringBuilder();
+        for (int i = 0; i < 1000; ++i) {
+            input.append("key").append(i).append("=value").append(i).append(';');
+        }
+        Matcher m = Pattern.compile("key(\\d+)=value(\\d+)").matcher(input);
+        int count = 0;
+        while (m.find()) {
+            assertEquals(m.group(1), m.group(2));
+            ++count;
+        }
+        assertEquals(1000, count);
+
+        // Resetting to new input must rebind the matcher to it.
+        m.reset("key7=value7");
+        assertTrue(m.find());
+        assertEquals("7", m.group(1));
+        assertFalse(m.find());
+    }
+
+    public void testFindAll() throws Exception {
+        Matcher m = Pattern.compile("(\\d+)([a-z])?").matcher("1a 22 333c");
+        int[] offsets = new int[2 * 6];
+        assertEquals(2, m.findAll(offsets, 2));
+        assertEquals(0, offsets[0]);
+        assertEquals(2, offsets[1]);
+        assertEquals(2, offsets[5]);
+        assertEquals(3, offsets[6]);
+        assertEquals(5, offsets[7]);
+        assertEquals(-1, offsets[10]);
+        // The last match found is the current match, and find() carries on after it.
+        assertEquals("22", m.group());
+        assertTrue(m.find());
+        assertEquals("c", m.group(2));
+        assertEquals(0, m.findAll(offsets, 2));
+        try {
+            m.group();
+            fail();
+        } catch (IllegalStateException expected) {
+        }
+        try {
+            m.reset().findAll(offsets, 3);
+            fail();
+        } catch (IllegalArgumentException expected) {
+        }
+    }
+
+    public void testSplitAndReplaceAllWithManyMatches() throws Exception {
+        StringBuilder input = new StringBuilder();
+        for (int i = 0; i < 500; ++i) {
+            input.append(i).append(", ");
+        }
+        String[] parts = input.toString().split(",\\s*");
+        assertEquals(500, parts.length);
+        assertEquals("499", parts[499]);
+        parts = input.toString().split(",\\s*", 100);
+        assertEquals(100, parts.length);
+        assertEquals("98", parts[98]);
+        assertTrue(parts[99].startsWith("99, "));
+
+        String replaced = input.toString().replaceAll(",\\s*", ";");
+        assertEquals(input.toString().replace(", ", ";"), replaced);
+        assertEquals("x-y-", "x1y22".replaceAll("\\d+", "-"));
+        assertEquals("x[1]y[22]", "x1y22".replaceAll("(\\d+)", "[$1]"));
+    }
+}
@@ -0,0 +1,76 @@
+/*
+ * Copyright (C) 2014 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+package libcore.java.util.zip;
+
+import java.nio.ByteBuffer;
+import java.util.Random;
+import java.util.zip.Adler32;
+import java.util.zip.CRC32;
+import java.util.zip.Checksum;
+import junit.framework.TestCase;
+
+public final class ChecksumTest extends TestCase {
+    public void testKnownValues() throws Exception {
+        byte[] bytes = "123456789".getBytes("US-ASCII");
+        CRC32 crc = new CRC32();
+        crc.update(bytes);
+        assertEquals(0xcbf43926L, crc.getValue());
+        Adler32 adler = new Adler32();
+        adler.update(bytes);
+        assertEquals(0x091e01deL, adler.getValue());
+    }
+
+    public void testCrc32() throws Exception {
+        assertConsistent(new CRC32(), new CRC32(), new CRC32());
+    }
+
+    public void testAdler32() throws Exception {
+        assertConsistent(new Adler32(), new Adler32(), new Adler32());
+    }
+
+    /**
+     * Checks that byte-at-a-time updates, array updates and direct buffer updates agree, on
+     * lengths either side of the sizes at which the vectorized code takes over.
+     */
+    private static void assertConsistent(Checksum bytewise, Checksum arrays, Checksum buffers) {
+        Random random = new Random(0);
+        for (int length : new int[] { 0, 1, 15, 16, 31, 63, 64, 65, 1000, 6000, 100000 }) {
+            byte[] data = new byte[length];
+            random.nextBytes(data);
+            bytewise.reset();
+            arrays.reset();
+            buffers.reset();
+            for (byte b : data) {
+                bytewise.update(b);
+            }
+            arrays.update(data, 0, length);
+            // An odd offset, so the direct buffer's data isn't aligned.
+            ByteBuffer direct = ByteBuffer.allocateDirect(length + 3);
+            direct.position(3);
+            direct.put(data);
+            direct.position(3);
+            if (buffers instanceof CRC32) {
+                ((CRC32) buffers).update(direct);
+            } else {
+                ((Adler32) buffers).update(direct);
+            }
+            assertEquals(0, direct.remaining());
+            assertEquals("length " + length, arrays.getValue(), bytewise.getValue());
+            assertEquals("length " + length, arrays.getValue(), buffers.getValue());
+        }
+    }
+}
@@ -16,6 +16,8 @@
 
 package libcore.java.util.zip;
 
+import java.nio.ByteBuffer;
+import java.util.Arrays;
 import java.util.zip.DataFormatException;
 import java.util.zip.Deflater;
 import java.util.zip.Inflater;
@@ -56,6 +58,40 @@ public class DeflaterTest extends TestCase {
         assertEquals(0, inflater.inflate(decompressed));
     }
 
+    public void testDirectByteBuffers() throws DataFormatException {
+        byte[] original = new byte[64 * 1024];
+        for (int i = 0; i < original.length; ++i) {
+            original[i] = (byte) (i % 251);
+        }
+        ByteBuffer input = ByteBuffer.allocateDirect(original.length);
+        input.put(original).flip();
+        ByteBuffer compressed = ByteBuffer.allocateDirect(original.length);
+
+        deflater.setInput(input);
+        deflater.finish();
+        while (!deflater.finished()) {
+            assertTrue(deflater.deflate(compressed) > 0);
+        }
+        assertEquals(0, input.remaining());
+        assertEquals(deflater.getBytesWritten(), compressed.position());
+        compressed.flip();
+
+        // Inflate a slice of the compressed data, so the buffer's address isn't its start.
+        ByteBuffer output = ByteBuffer.allocateDirect(original.length + 1);
+        output.position(1);
+        inflater.setInput(compressed);
+        while (!inflater.finished()) {
+            assertTrue(inflater.inflate(output) > 0);
+        }
+        assertEquals(0, compressed.remaining());
+        assertEquals(original.length + 1, output.position());
+
+        byte[] actual = new byte[original.length];
+        output.position(1);
+        output.get(actual);
+        assertTrue(Arrays.equals(original, actual));
+    }
+
     private void deflateInflate(int flush) throws DataFormatException {
         int lastDeflated = deflater.deflate(compressed, totalDeflated,
                 compressed.length - totalDeflated, flush);
@@ -20,6 +20,7 @@ import java.io.ByteArrayOutputStream;
 import java.util.zip.Adler32;
 import java.util.zip.Deflater;
 import java.util.zip.Inflater;
+import java.util.zip.ZipStreamPool;
 import junit.framework.TestCase;
 
 public class InflaterTest extends TestCase {
@@ -100,6 +101,36 @@ public class InflaterTest extends TestCase {
         assertTrue(inflater.finished());
     }
 
+    public void testPooledStreamsBehaveLikeNewOnes() throws Exception {
+        int oldCapacity = ZipStreamPool.getCapacity();
+        try {
+            ZipStreamPool.setCapacity(4);
+            // Leave a stream that stopped halfway through, with a dictionary, in the pool.
+            byte[] dictionary = "dictionary".getBytes("UTF-8");
+            Inflater inflater = new Inflater();
+            inflater.setInput(deflate(makeString().getBytes("UTF-8"), dictionary));
+            assertEquals(0, inflater.inflate(new byte[8]));
+            inflater.setDictionary(dictionary);
+            assertTrue(inflater.inflate(new byte[8]) > 0);
+            inflater.end();
+
+            long hits = ZipStreamPool.getHitCount();
+            assertRoundTrip(null);
+            assertRoundTrip(dictionary);
+            assertTrue(ZipStreamPool.getHitCount() > hits);
+
+            ZipStreamPool.setCapacity(0);
+            new Inflater().end();
+            hits = ZipStreamPool.getHitCount();
+            long misses = ZipStreamPool.getMissCount();
+            new Inflater().end();
+            assertEquals(hits, ZipStreamPool.getHitCount());
+            assertEquals(misses + 1, ZipStreamPool.getMissCount());
+        } finally {
+            ZipStreamPool.setCapacity(oldCapacity);
+        }
+    }
+
     private static byte[] deflate(byte[] input, byte[] dictionary) {
         Deflater deflater = new Deflater();
         if (dictionary != null) {
@@ -0,0 +1,274 @@
+/*
+ * Copyright (C) 2014 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+package libcore.java.util.zip;
+
+import java.io.ByteArrayOutputStream;
+import java.nio.ByteBuffer;
+import java.util.Arrays;
+import java.util.Random;
+import java.util.zip.DataFormatException;
+import java.util.zip.Lz4Compressor;
+import java.util.zip.Lz4Decompressor;
+import junit.framework.TestCase;
+
+public class Lz4Test extends TestCase {
+    // "hello, hello, hello, hello, world! hello, hello, world!\n", as written by
+    // "lz4 -BX --content-size", so with a block checksum and the content size as well as the
+    // content checksum.
+    private static final byte[] REFERENCE_FRAME = new byte[] {
+        4, 34, 77, 24, 124, 64, 56, 0, 0, 0, 0, 0, 0, 0, 44, 28, 0, 0, 0, 127, 104, 101, 108,
+        108, 111, 44, 32, 7, 0, 2, 107, 119, 111, 114, 108, 100, 33, 28, 0, 112, 119, 111, 114,
+        108, 100, 33, 10, 42, -92, 36, 20, 0, 0, 0, 0, 43, -49, -87, 105,
+    };
+
+    public void testRoundTrip() throws Exception {
+        Random random = new Random(0);
+        for (int length : new int[] { 0, 1, 12, 13, 1000, 65536, 65537, 300000 }) {
+            byte[] input = makeInput(random, length);
+            byte[] compressed = compress(input, null, 7, 11);
+            assertTrue(Arrays.equals(input, decompress(compressed, null, 13, 5)));
+            assertTrue(Arrays.equals(input, decompress(compressed, null, 100000, 100000)));
+        }
+    }
+
+    public void testCompresses() throws Exception {
+        byte[] input = makeInput(new Random(0), 100000);
+        assertTrue(compress(input, null, input.length, 1024).length < input.length / 2);
+    }
+
+    public void testIncompressibleInput() throws Exception {
+        byte[] input = new byte[100000];
+        new Random(0).nextBytes(input);
+        byte[] compressed = compress(input, null, 4096, 4096);
+        // Blocks that don't compress are stored as they are.
+        assertTrue(compressed.length < input.length + 64);
+        assertTrue(Arrays.equals(input, decompress(compressed, null, 4096, 4096)));
+    }
+
+    public void testReferenceFrame() throws Exception {
+        assertEquals("hello, hello, hello, hello, world! hello, hello, world!\n",
+                new String(decompress(REFERENCE_FRAME, null, 1, 1), "UTF-8"));
+    }
+
+    public void testDictionary() throws Exception {
+        byte[] dictionary = "{\"id\": , \"name\": \"\", \"tags\": [\"\", \"\"]}".getBytes("UTF-8");
+        byte[] input = "{\"id\": 7, \"name\": \"lz4\", \"tags\": [\"a\", \"b\"]}".getBytes("UTF-8");
+        byte[] withDictionary = compress(input, dictionary, input.length, 100);
+        assertTrue(withDictionary.length < compress(input, null, input.length, 100).length);
+        assertTrue(Arrays.equals(input, decompress(withDictionary, dictionary, 3, 3)));
+        // The frame doesn't record whether it needs the dictionary, but without it the matches
+        // reach back before the start of the content.
+        try {
+            decompress(withDictionary, null, 100, 100);
+            fail();
+        } catch (DataFormatException expected) {
+        }
+    }
+
+    public void testFlush() throws Exception {
+        byte[] input = "a message that needs to arrive now".getBytes("UTF-8");
+        Lz4Compressor compressor = new Lz4Compressor();
+        compressor.setInput(input);
+        byte[] buf = new byte[128];
+        // Without a flush, the input waits for the rest of its block.
+        int headerLength = compressor.compress(buf);
+        assertTrue(compressor.needsInput());
+        int length = headerLength + compressor.compress(buf, headerLength, buf.length - headerLength, true);
+        compressor.end();
+
+        Lz4Decompressor decompressor = new Lz4Decompressor();
+        decompressor.setInput(buf, 0, length);
+        byte[] out = new byte[input.length];
+        assertEquals(input.length, decompressor.decompress(out));
+        assertTrue(Arrays.equals(input, out));
+        assertFalse(decompressor.finished());
+        assertTrue(decompressor.needsInput());
+        decompressor.end();
+    }
+
+    public void testByteBuffers() throws Exception {
+        byte[] input = makeInput(new Random(0), 200000);
+        for (boolean direct : new boolean[] { false, true }) {
+            ByteBuffer in = direct ? ByteBuffer.allocateDirect(input.length) : ByteBuffer.allocate(input.length);
+            in.put(input).flip();
+            ByteBuffer compressed = direct ? ByteBuffer.allocateDirect(300000) : ByteBuffer.allocate(300000);
+            Lz4Compressor compressor = new Lz4Compressor();
+            compressor.setInput(in);
+            compressor.finish();
+            ByteBuffer chunk = ByteBuffer.allocate(1000);
+            while (!compressor.finished()) {
+                chunk.clear();
+                compressor.compress(chunk);
+                chunk.flip();
+                compressed.put(chunk);
+            }
+            assertFalse(in.hasRemaining());
+            compressor.end();
+            compressed.flip();
+
+            ByteBuffer out = direct ? ByteBuffer.allocateDirect(input.length) : ByteBuffer.allocate(input.length);
+            Lz4Decompressor decompressor = new Lz4Decompressor();
+            decompressor.setInput(compressed);
+            while (!decompressor.finished()) {
+                decompressor.decompress(out);
+            }
+            assertFalse(compressed.hasRemaining());
+            assertEquals(input.length, decompressor.getBytesWritten());
+            decompressor.end();
+            out.flip();
+            byte[] actual = new byte[input.length];
+            out.get(actual);
+            assertTrue(Arrays.equals(input, actual));
+        }
+    }
+
+    public void testTrailingInput() throws Exception {
+        byte[] input = new byte[REFERENCE_FRAME.length + 3];
+        System.arraycopy(REFERENCE_FRAME, 0, input, 0, REFERENCE_FRAME.length);
+        Lz4Decompressor decompressor = new Lz4Decompressor();
+        decompressor.setInput(input);
+        decompressor.decompress(new byte[100]);
+        assertTrue(decompressor.finished());
+        assertEquals(3, decompressor.getRemaining());
+        assertEquals(REFERENCE_FRAME.length, decompressor.getBytesRead());
+
+        // A reset decompressor reads the next frame.
+        decompressor.reset();
+        decompressor.setInput(REFERENCE_FRAME);
+        assertEquals(56, decompressor.decompress(new byte[100]));
+        assertTrue(decompressor.finished());
+        decompressor.end();
+    }
+
+    public void testCorruptInput() throws Exception {
+        byte[] badMagic = REFERENCE_FRAME.clone();
+        badMagic[0] = 5;
+        assertCorrupt(badMagic);
+        byte[] badHeaderChecksum = REFERENCE_FRAME.clone();
+        badHeaderChecksum[14] ^= 1;
+        assertCorrupt(badHeaderChecksum);
+        byte[] badBlock = REFERENCE_FRAME.clone();
+        badBlock[30] ^= 1;
+        assertCorrupt(badBlock);
+        byte[] badContentChecksum = REFERENCE_FRAME.clone();
+        badContentChecksum[REFERENCE_FRAME.length - 1] ^= 1;
+        assertCorrupt(badContentChecksum);
+    }
+
+    private static void assertCorrupt(byte[] frame) {
+        Lz4Decompressor decompressor = new Lz4Decompressor();
+        decompressor.setInput(frame);
+        try {
+            while (!decompressor.finished()) {
+                decompressor.decompress(new byte[100]);
+            }
+            fail();
+        } catch (DataFormatException expected) {
+        }
+        decompressor.end();
+    }
+
+    public void testSetDictionaryAfterCompress() throws Exception {
+        Lz4Compressor compressor = new Lz4Compressor();
+        compressor.compress(new byte[100]);
+        try {
+            compressor.setDictionary(new byte[10]);
+            fail();
+        } catch (IllegalStateException expected) {
+        }
+        compressor.reset();
+        compressor.setDictionary(new byte[10]);
+        compressor.end();
+    }
+
+    public void testEnd() throws Exception {
+        Lz4Compressor compressor = new Lz4Compressor();
+        compressor.end();
+        compressor.end();
+        try {
+            compressor.setInput(new byte[1]);
+            fail();
+        } catch (IllegalStateException expected) {
+        }
+        Lz4Decompressor decompressor = new Lz4Decompressor();
+        decompressor.end();
+        try {
+            decompressor.decompress(new byte[1]);
+            fail();
+        } catch (IllegalStateException expected) {
+        }
+    }
+
+    private static byte[] makeInput(Random random, int length) {
+        String[] words = { "alpha ", "beta ", "gamma ", "delta\n", "{\"key\": 12, ", "]}, " };
+        ByteArrayOutputStream out = new ByteArrayOutputStream();
+        while (out.size() < length) {
+            byte[] word = words[random.nextInt(words.length)].getBytes();
+            out.write(word, 0, Math.min(word.length, length - out.size()));
+        }
+        return out.toByteArray();
+    }
+
+    private static byte[] compress(byte[] input, byte[] dictionary, int inChunk, int outChunk) {
+        Lz4Compressor compressor = new Lz4Compressor();
+        if (dictionary != null) {
+            compressor.setDictionary(dictionary);
+        }
+        ByteArrayOutputStream out = new ByteArrayOutputStream();
+        byte[] buf = new byte[outChunk];
+        int offset = 0;
+        while (!compressor.finished()) {
+            if (compressor.needsInput() && offset < input.length) {
+                int byteCount = Math.min(inChunk, input.length - offset);
+                compressor.setInput(input, offset, byteCount);
+                offset += byteCount;
+            } else {
+                if (offset == input.length) {
+                    compressor.finish();
+                }
+                out.write(buf, 0, compressor.compress(buf));
+            }
+        }
+        assertEquals(input.length, compressor.getBytesRead());
+        assertEquals(out.size(), compressor.getBytesWritten());
+        compressor.end();
+        return out.toByteArray();
+    }
+
+    private static byte[] decompress(byte[] input, byte[] dictionary, int inChunk, int outChunk)
+            throws DataFormatException {
+        Lz4Decompressor decompressor = new Lz4Decompressor();
+        if (dictionary != null) {
+            decompressor.setDictionary(dictionary);
+        }
+        ByteArrayOutputStream out = new ByteArrayOutputStream();
+        byte[] buf = new byte[outChunk];
+        int offset = 0;
+        while (!decompressor.finished()) {
+            if (decompressor.needsInput()) {
+                assertTrue(offset < input.length);
+                int byteCount = Math.min(inChunk, input.length - offset);
+                decompressor.setInput(input, offset, byteCount);
+                offset += byteCount;
+            } else {
+                out.write(buf, 0, decompressor.decompress(buf));
+            }
+        }
+        decompressor.end();
+        return out.toByteArray();
+    }
+}
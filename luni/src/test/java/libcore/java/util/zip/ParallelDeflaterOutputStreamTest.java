@@ -0,0 +1,106 @@
+/*
+ * Copyright (C) 2014 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+package libcore.java.util.zip;
+
+import java.io.ByteArrayInputStream;
+import java.io.ByteArrayOutputStream;
+import java.util.Arrays;
+import java.util.Random;
+import java.util.zip.Adler32;
+import java.util.zip.CRC32;
+import java.util.zip.Deflater;
+import java.util.zip.InflaterInputStream;
+import java.util.zip.ParallelDeflaterOutputStream;
+import junit.framework.TestCase;
+import libcore.io.Streams;
+
+public final class ParallelDeflaterOutputStreamTest extends TestCase {
+    public void testGzipRoundTrip() throws Exception {
+        byte[] data = compressibleData(1024 * 1024 + 17);
+        byte[] compressed = compress(data, ParallelDeflaterOutputStream.FORMAT_GZIP, 4);
+        assertTrue(compressed.length < data.length / 2);
+        assertTrue(Arrays.equals(data, GZIPInputStreamTest.gunzip(compressed)));
+    }
+
+    public void testZlibRoundTrip() throws Exception {
+        byte[] data = compressibleData(300 * 1024);
+        byte[] compressed = compress(data, ParallelDeflaterOutputStream.FORMAT_ZLIB, 3);
+        InflaterInputStream in = new InflaterInputStream(new ByteArrayInputStream(compressed));
+        assertTrue(Arrays.equals(data, Streams.readFully(in)));
+    }
+
+    public void testEmptyInput() throws Exception {
+        byte[] compressed = compress(new byte[0], ParallelDeflaterOutputStream.FORMAT_GZIP, 2);
+        assertEquals(0, GZIPInputStreamTest.gunzip(compressed).length);
+    }
+
+    public void testFlushKeepsStreamUsable() throws Exception {
+        ByteArrayOutputStream bytes = new ByteArrayOutputStream();
+        ParallelDeflaterOutputStream out = new ParallelDeflaterOutputStream(bytes,
+                Deflater.DEFAULT_COMPRESSION, ParallelDeflaterOutputStream.FORMAT_GZIP, 2,
+                ParallelDeflaterOutputStream.DEFAULT_BLOCK_SIZE);
+        out.write("hello ".getBytes("US-ASCII"));
+        out.flush();
+        out.write("world".getBytes("US-ASCII"));
+        out.close();
+        assertEquals("hello world", new String(GZIPInputStreamTest.gunzip(bytes.toByteArray()),
+                "US-ASCII"));
+    }
+
+    public void testChecksumCombine() throws Exception {
+        byte[] data = new byte[1000];
+        new Random(1).nextBytes(data);
+        CRC32 whole = new CRC32();
+        whole.update(data);
+        CRC32 head = new CRC32();
+        head.update(data, 0, 300);
+        CRC32 tail = new CRC32();
+        tail.update(data, 300, 700);
+        assertEquals(whole.getValue(), CRC32.combine(head.getValue(), tail.getValue(), 700));
+
+        Adler32 wholeAdler = new Adler32();
+        wholeAdler.update(data);
+        Adler32 headAdler = new Adler32();
+        headAdler.update(data, 0, 300);
+        Adler32 tailAdler = new Adler32();
+        tailAdler.update(data, 300, 700);
+        assertEquals(wholeAdler.getValue(),
+                Adler32.combine(headAdler.getValue(), tailAdler.getValue(), 700));
+    }
+
+    private static byte[] compress(byte[] data, int format, int threadCount) throws Exception {
+        ByteArrayOutputStream bytes = new ByteArrayOutputStream();
+        // A small block size, so that even modest inputs are split across the workers.
+        ParallelDeflaterOutputStream out = new ParallelDeflaterOutputStream(bytes,
+                Deflater.DEFAULT_COMPRESSION, format, threadCount, 64 * 1024);
+        // Uneven writes, so blocks don't line up with the caller's buffers.
+        for (int i = 0; i < data.length; i += 10007) {
+            out.write(data, i, Math.min(10007, data.length - i));
+        }
+        out.close();
+        return bytes.toByteArray();
+    }
+
+    private static byte[] compressibleData(int length) {
+        Random random = new Random(0);
+        byte[] data = new byte[length];
+        for (int i = 0; i < length; ++i) {
+            data[i] = (byte) ('a' + random.nextInt(8));
+        }
+        return data;
+    }
+}
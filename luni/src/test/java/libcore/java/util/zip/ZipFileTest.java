@@ -64,6 +64,45 @@ public final class ZipFileTest extends TestCase {
         zipFile.close();
     }
 
+    /**
+     * Entries of one zip file share its file descriptor, but reads are positional, so streams
+     * over different entries can be consumed concurrently without corrupting each other.
+     */
+    public void testConcurrentEntryStreams() throws Exception {
+        final ZipFile zipFile = new ZipFile(createZipFile(4, 256 * 1024));
+        final List<Throwable> failures = new ArrayList<Throwable>();
+        List<Thread> threads = new ArrayList<Thread>();
+        for (Enumeration<? extends ZipEntry> e = zipFile.entries(); e.hasMoreElements(); ) {
+            final ZipEntry zipEntry = e.nextElement();
+            Thread thread = new Thread(new Runnable() {
+                @Override public void run() {
+                    try {
+                        CRC32 crc = new CRC32();
+                        byte[] readBuffer = new byte[1024];
+                        InputStream is = zipFile.getInputStream(zipEntry);
+                        int byteCount;
+                        while ((byteCount = is.read(readBuffer, 0, readBuffer.length)) != -1) {
+                            crc.update(readBuffer, 0, byteCount);
+                        }
+                        is.close();
+                        assertEquals(zipEntry.getCrc(), crc.getValue());
+                    } catch (Throwable t) {
+                        synchronized (failures) {
+                            failures.add(t);
+                        }
+                    }
+                }
+            });
+            thread.start();
+            threads.add(thread);
+        }
+        for (Thread thread : threads) {
+            thread.join();
+        }
+        zipFile.close();
+        assertEquals(failures.toString(), 0, failures.size());
+    }
+
     private static void replaceBytes(byte[] buffer, byte[] original, byte[] replacement) {
         // Gotcha here: original and replacement must be the same length
         assertEquals(original.length, replacement.length);
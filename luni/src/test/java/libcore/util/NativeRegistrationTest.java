@@ -0,0 +1,39 @@
+/*
+ * Copyright (C) 2014 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+package libcore.util;
+
+import java.util.regex.Pattern;
+import junit.framework.TestCase;
+
+public final class NativeRegistrationTest extends TestCase {
+    public void testRegisteredClassesWork() throws Exception {
+        // Whether or not registration is lazy, these must be usable, and asking again is harmless.
+        NativeRegistration.ensureRegistered("java/util/regex/Pattern");
+        assertTrue(Pattern.matches("a+b", "aaab"));
+        NativeRegistration.ensureRegistered("libcore/icu/ICU");
+        assertNotNull(libcore.icu.ICU.getIcuVersion());
+    }
+
+    public void testUnknownClass() throws Exception {
+        try {
+            NativeRegistration.ensureRegistered("java/lang/Object");
+            fail();
+        } catch (IllegalArgumentException expected) {
+        }
+    }
+}
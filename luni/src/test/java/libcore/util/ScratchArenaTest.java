@@ -0,0 +1,45 @@
+/*
+ * Copyright (C) 2014 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+package libcore.util;
+
+import junit.framework.TestCase;
+
+/**
+ * Tests the native ScratchArena allocator (include/ScratchArena.h). The checks themselves are
+ * in libjavacoretests; each returns null on success or a description of what went wrong.
+ */
+public final class ScratchArenaTest extends TestCase {
+    static {
+        System.loadLibrary("javacoretests");
+    }
+
+    public void testMarkAndRelease() {
+        assertNull(markAndRelease());
+    }
+
+    public void testBlockGrowth() {
+        assertNull(blockGrowth());
+    }
+
+    public void testUseAfterThreadDestroy() {
+        assertNull(useAfterThreadDestroy());
+    }
+
+    private static native String markAndRelease();
+    private static native String blockGrowth();
+    private static native String useAfterThreadDestroy();
+}
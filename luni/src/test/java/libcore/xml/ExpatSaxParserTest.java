@@ -19,10 +19,15 @@ package libcore.xml;
 import com.google.mockwebserver.MockResponse;
 import com.google.mockwebserver.MockWebServer;
 import java.io.ByteArrayInputStream;
+import java.io.File;
+import java.io.FileOutputStream;
 import java.io.IOException;
 import java.io.InputStream;
+import java.io.RandomAccessFile;
 import java.io.Reader;
 import java.io.StringReader;
+import java.nio.ByteBuffer;
+import java.nio.channels.FileChannel;
 import java.util.ArrayList;
 import java.util.Arrays;
 import java.util.HashMap;
@@ -57,6 +62,141 @@ public class ExpatSaxParserTest extends TestCase {
         parse(xml.toString(), new DefaultHandler());
     }
 
+    public void testInternedNames() throws Exception {
+        // Enough distinct names to make the intern table grow several times.
+        StringBuilder xml = new StringBuilder();
+        xml.append("<root xmlns:p=\"http://p/\">");
+        for (int i = 0; i < 1000; ++i) {
+            xml.append("<p:e" + i + " a" + i + "=\"v\"/>");
+            xml.append("<p:e" + i + "/>");
+        }
+        xml.append("</root>");
+        final List<String> qNames = new ArrayList<String>();
+        parse(xml.toString(), new DefaultHandler() {
+            @Override public void startElement(String uri, String localName, String qName,
+                    Attributes attributes) {
+                assertSame(qName.intern(), qName);
+                assertSame(localName.intern(), localName);
+                assertSame(uri.intern(), uri);
+                for (int i = 0; i < attributes.getLength(); ++i) {
+                    assertSame(attributes.getQName(i).intern(), attributes.getQName(i));
+                }
+                qNames.add(qName);
+            }
+        });
+        assertEquals(2001, qNames.size());
+        for (int i = 0; i < 1000; ++i) {
+            assertEquals("p:e" + i, qNames.get(2 * i + 1));
+            assertSame(qNames.get(2 * i + 1), qNames.get(2 * i + 2));
+        }
+    }
+
+    public void testSharedNameCache() throws Exception {
+        final List<String> names = new ArrayList<String>();
+        DefaultHandler handler = new DefaultHandler() {
+            @Override public void startElement(String uri, String localName, String qName,
+                    Attributes attributes) {
+                assertSame(qName.intern(), qName);
+                names.add(qName);
+            }
+        };
+        ExpatReader.setSharedNameCacheEnabled(true);
+        try {
+            parse("<shared><cached/></shared>", handler);
+            parse("<shared><cached/></shared>", handler);
+        } finally {
+            ExpatReader.setSharedNameCacheEnabled(false);
+        }
+        assertEquals(Arrays.asList("shared", "cached", "shared", "cached"), names);
+        assertSame(names.get(0), names.get(2));
+        assertSame(names.get(1), names.get(3));
+    }
+
+    public void testBatchedEventsMatchUnbatchedEvents() throws Exception {
+        StringBuilder xml = new StringBuilder();
+        xml.append("<root xmlns='http://a/' xmlns:b='http://b/'>");
+        for (int i = 0; i < 2000; ++i) {
+            // Enough events and text to need several batches.
+            xml.append("<b:item id='" + i + "' b:x='caf\u00e9'>text " + i + "<!--c-->"
+                    + "<empty/></b:item>");
+        }
+        xml.append("<?pi data?></root>");
+        assertEquals(recordEvents(xml.toString(), false), recordEvents(xml.toString(), true));
+    }
+
+    private static List<String> recordEvents(String xml, boolean batched) throws Exception {
+        final List<String> events = new ArrayList<String>();
+        DefaultHandler2 handler = new DefaultHandler2() {
+            @Override public void startElement(String uri, String localName, String qName,
+                    Attributes attributes) {
+                StringBuilder event = new StringBuilder("<" + uri + "|" + localName + "|" + qName);
+                for (int i = 0; i < attributes.getLength(); ++i) {
+                    event.append(" " + attributes.getURI(i) + "|" + attributes.getLocalName(i)
+                            + "|" + attributes.getQName(i) + "=" + attributes.getValue(i));
+                }
+                assertEquals(attributes.getValue(0), attributes.getValue("", "id"));
+                events.add(event.toString());
+            }
+            @Override public void endElement(String uri, String localName, String qName) {
+                events.add("</" + uri + "|" + localName + "|" + qName);
+            }
+            @Override public void characters(char[] ch, int start, int length) {
+                events.add("text:" + new String(ch, start, length));
+            }
+            @Override public void startPrefixMapping(String prefix, String uri) {
+                events.add("ns:" + prefix + "=" + uri);
+            }
+            @Override public void endPrefixMapping(String prefix) {
+                events.add("/ns:" + prefix);
+            }
+            @Override public void comment(char[] ch, int start, int length) {
+                events.add("comment:" + new String(ch, start, length));
+            }
+            @Override public void processingInstruction(String target, String data) {
+                events.add("pi:" + target + " " + data);
+            }
+        };
+        ExpatReader reader = new ExpatReader();
+        reader.setFeature("http://android.com/sax/features/batched-events", batched);
+        reader.setContentHandler(handler);
+        reader.setLexicalHandler(handler);
+        reader.parse(new InputSource(new StringReader(xml)));
+        return events;
+    }
+
+    public void testParseByteBuffers() throws Exception {
+        byte[] xml = "<a><b c='d'>text</b></a>".getBytes("UTF-8");
+        File file = File.createTempFile("ExpatSaxParserTest", "xml");
+        FileOutputStream out = new FileOutputStream(file);
+        out.write(xml);
+        out.close();
+        RandomAccessFile raf = new RandomAccessFile(file, "r");
+        ByteBuffer mapped = raf.getChannel().map(FileChannel.MapMode.READ_ONLY, 0, xml.length);
+        raf.close();
+
+        ByteBuffer direct = ByteBuffer.allocateDirect(xml.length + 2);
+        direct.put((byte) ' ').put(xml).flip();
+        direct.position(1);
+
+        for (ByteBuffer buffer : new ByteBuffer[] { mapped, direct, ByteBuffer.wrap(xml) }) {
+            final List<String> events = new ArrayList<String>();
+            ExpatReader reader = new ExpatReader();
+            reader.setContentHandler(new DefaultHandler() {
+                @Override public void startElement(String uri, String localName, String qName,
+                        Attributes attributes) {
+                    events.add(localName + attributes.getLength());
+                }
+                @Override public void characters(char[] ch, int start, int length) {
+                    events.add(new String(ch, start, length));
+                }
+            });
+            reader.parse(buffer, "UTF-8", null, null);
+            assertEquals(Arrays.asList("a0", "b1", "text"), events);
+            assertEquals(0, buffer.remaining());
+        }
+        file.delete();
+    }
+
     public void testExceptions() {
         // From startElement().
         ContentHandler contentHandler = new DefaultHandler() {
@@ -0,0 +1,144 @@
+/*
+ * Copyright (C) 2014 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "ScratchArena.h"
+
+#include <jni.h>
+#include <pthread.h>
+#include <stdint.h>
+#include <string.h>
+
+// Each test returns NULL on success, or a description of the first failed check.
+
+static jstring failure(JNIEnv* env, const char* message) {
+  return env->NewStringUTF(message);
+}
+
+static bool isAligned(void* p, size_t alignment) {
+  return (reinterpret_cast<uintptr_t>(p) & (alignment - 1)) == 0;
+}
+
+extern "C" jstring Java_libcore_util_ScratchArenaTest_markAndRelease(JNIEnv* env, jclass) {
+  void* first;
+  {
+    ScopedScratchArena outer;
+    first = outer.allocate(100);
+    if (first == NULL || !isAligned(first, ScratchArena::DEFAULT_ALIGNMENT)) {
+      return failure(env, "first allocation");
+    }
+    void* inner;
+    {
+      ScopedScratchArena scope;
+      inner = scope.allocate(100);
+      if (inner == NULL || inner <= first) {
+        return failure(env, "inner allocation should follow the outer one");
+      }
+      char* c = scope.allocateArray<char>(1);
+      if (c == NULL || c <= inner) {
+        return failure(env, "allocations within a scope should not overlap");
+      }
+    }
+    // Leaving the inner scope gives its memory back to the outer one.
+    if (outer.allocate(100) != inner) {
+      return failure(env, "released memory should be reused");
+    }
+    void* aligned = outer.allocate(1, 64);
+    if (aligned == NULL || !isAligned(aligned, 64)) {
+      return failure(env, "explicit alignment");
+    }
+  }
+  ScopedScratchArena again;
+  if (again.allocate(100) != first) {
+    return failure(env, "an empty arena should start over at the beginning");
+  }
+  return NULL;
+}
+
+extern "C" jstring Java_libcore_util_ScratchArenaTest_blockGrowth(JNIEnv* env, jclass) {
+  const size_t initial = ScratchArena::INITIAL_BYTE_COUNT;
+  void* first;
+  void* grown;
+  {
+    ScopedScratchArena scope;
+    first = scope.allocate(initial / 2);
+    // This doesn't fit in what's left of the first block, so it chains a new one.
+    grown = scope.allocate(initial);
+    if (first == NULL || grown == NULL) {
+      return failure(env, "couldn't grow past the first block");
+    }
+    memset(grown, 0xa5, initial);
+  }
+  {
+    // The chained block is kept, so the same requests land in the same places.
+    ScopedScratchArena scope;
+    if (scope.allocate(initial / 2) != first || scope.allocate(initial) != grown) {
+      return failure(env, "chained block should be reused");
+    }
+  }
+  {
+    // A request larger than anything we keep still succeeds...
+    ScopedScratchArena scope;
+    size_t huge = 2 * ScratchArena::MAX_RETAINED_BYTE_COUNT;
+    scope.allocate(initial / 2);
+    char* p = reinterpret_cast<char*>(scope.allocate(huge));
+    if (p == NULL) {
+      return failure(env, "huge allocation");
+    }
+    memset(p, 0x5a, huge);
+    if (scope.allocate(SIZE_MAX - 8) != NULL) {
+      return failure(env, "impossible allocation should fail");
+    }
+  }
+  // ...and its block is given back once the arena is empty, leaving the first block intact.
+  ScopedScratchArena scope;
+  if (scope.allocate(initial / 2) != first) {
+    return failure(env, "first block should survive releasing a huge one");
+  }
+  return NULL;
+}
+
+// Thread-specific destructors run in an unspecified order, so one that runs after the
+// arena's own destructor must still be able to use (a fresh) arena.
+static pthread_key_t gLateKey;
+
+static void useArenaLate(void* result) {
+  ScopedScratchArena scope;
+  char* p = reinterpret_cast<char*>(scope.allocate(ScratchArena::INITIAL_BYTE_COUNT));
+  if (p != NULL) {
+    memset(p, 0, ScratchArena::INITIAL_BYTE_COUNT);
+  }
+  *reinterpret_cast<bool*>(result) = (p != NULL);
+}
+
+static void* useArenaThenExit(void* result) {
+  ScopedScratchArena scope;
+  scope.allocate(16);
+  // Created after the arena's key, so (on glibc and bionic) its destructor runs later.
+  pthread_key_create(&gLateKey, useArenaLate);
+  pthread_setspecific(gLateKey, result);
+  return NULL;
+}
+
+extern "C" jstring Java_libcore_util_ScratchArenaTest_useAfterThreadDestroy(JNIEnv* env, jclass) {
+  bool ok = false;
+  pthread_t thread;
+  if (pthread_create(&thread, NULL, useArenaThenExit, &ok) != 0) {
+    return failure(env, "pthread_create");
+  }
+  pthread_join(thread, NULL);
+  pthread_key_delete(gLateKey);
+  return ok ? NULL : failure(env, "late destructor couldn't allocate");
+}